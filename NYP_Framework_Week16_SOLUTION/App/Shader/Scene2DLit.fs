@@ -0,0 +1,24 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+in vec2 LightCoord;
+
+// texture samplers
+uniform sampler2D texture1;
+// The light level of each tile, from 0 to the highest light level
+uniform sampler2D lightMap;
+// The scale from the light map's value to a brightness from 0 to 1
+uniform float lightScale;
+// The brightness of an unlit tile
+uniform float ambient;
+
+void main()
+{
+	float brightness = mix(ambient, 1.0, clamp(texture(lightMap, LightCoord).r * lightScale, 0.0, 1.0));
+
+	FragColor = texture(texture1, TexCoord);
+	FragColor *= Color;
+	FragColor.rgb *= brightness;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec4 aColor;
+layout (location = 2) in vec2 aTexCoord;
+
+out vec2 TexCoord;
+out vec4 Color;
+out vec2 LightCoord;
+
+uniform mat4 transform;
+// The position of the bottom left corner of the map, and the scale from a position in the map to the light map
+uniform vec2 lightMapOrigin;
+uniform vec2 lightMapScale;
+
+void main()
+{
+	gl_Position = transform * vec4(aPos, 1.0);
+	Color = aColor;
+	TexCoord = vec2(aTexCoord.x, aTexCoord.y);
+	// The light map has one texel per tile, with its first row at the bottom of the map.
+	// It is found from the position in the map, so it stays on the tiles wherever the transform draws them
+	LightCoord = (aPos.xy - lightMapOrigin) * lightMapScale;
+}
\ No newline at end of file
@@ -21,6 +21,12 @@
 #include "Inputs\KeyboardController.h"
 #include "Inputs\MouseController.h"
 
+// Include Entity2D for interpolating the rendering of the entities
+#include "Primitives\Entity2D.h"
+
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+
 #include <iostream>
 using namespace std;
 
@@ -39,6 +45,13 @@ using namespace std;
 // Include CPlayGameState
 #include "GameStateManagement/PlayGameState.h"
 
+// Include CWorkerPool
+#include "System\WorkerPool.h"
+// Include CRenderThread2D
+#include "RenderControl\RenderThread2D.h"
+// Include CTextureCache
+#include "RenderControl\TextureCache.h"
+
 
 
 /**
@@ -77,7 +90,7 @@ void repos_callback(GLFWwindow* window, int xpos, int ypos)
 	CSettings::GetInstance()->iWindowPosX = xpos;
 	CSettings::GetInstance()->iWindowPosY = ypos;
 	// Update the glViewPort
-	glViewport(0, 0, CSettings::GetInstance()->iWindowWidth, CSettings::GetInstance()->iWindowHeight);
+	CGLStateCache::GetInstance()->Viewport(0, 0, CSettings::GetInstance()->iWindowWidth, CSettings::GetInstance()->iWindowHeight);
 }
 
 /**
@@ -92,7 +105,7 @@ void resize_callback(GLFWwindow* window, int width, int height)
 	CSettings::GetInstance()->iWindowWidth = width;
 	CSettings::GetInstance()->iWindowHeight = height;
 	// Update the glViewPort
-	glViewport(0, 0, width, height);
+	CGLStateCache::GetInstance()->Viewport(0, 0, width, height);
 }
 
 /**
@@ -218,9 +231,26 @@ bool Application::Init(void)
 		return false;
 	}
 
+	// Initialise the CStreamBuffer instance, before the vertex arrays which read from it are created
+	cStreamBuffer = CStreamBuffer::GetInstance();
+	if (cStreamBuffer->Init() == false)
+	{
+		glfwTerminate();
+		return false;
+	}
+
+	// Initialise the CTextureCache instance, which shares the textures that are loaded from files
+	CTextureCache::GetInstance()->Init();
+
 	// Initialise the CSoundController singleton
 	CSoundController::GetInstance()->Init();
 
+	// Initialise the worker threads
+	CWorkerPool::GetInstance()->Init();
+
+	// Start the thread which prepares the render command lists of the sprite batch
+	CRenderThread2D::GetInstance()->Init();
+
 	//// Initialise the cScene2D instance
 	//cScene2D = CScene2D::GetInstance();
 	//if (cScene2D->Init() == false)
@@ -239,6 +269,14 @@ bool Application::Init(void)
 	cFPSCounter = CFPSCounter::GetInstance();
 	cFPSCounter->Init();
 
+	// Initialise the CQualityGovernor instance with the time budget of a frame. The scenes register their knobs
+	cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(cSettings->frameTime * 0.001);
+
+	// Initialise the CIdleTaskScheduler instance, which runs the deferred work in the time left in each frame
+	cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
 	// Create the Game States
 	CGameStateManager::GetInstance()->AddGameState("IntroState", new CIntroState());
 	CGameStateManager::GetInstance()->AddGameState("MenuState", new CMenuState());
@@ -258,37 +296,56 @@ void Application::Run(void)
 	// Start timer to calculate how long it takes to render this frame
 	cStopWatch.StartTimer();
 
-	double dElapsedTime = 0.0;
+	// The simulation runs in fixed steps, so that its results do not depend on the frame rate.
+	// The first frame simulates 1 step.
+	cFixedTimestep.Init(1.0 / cSettings->SIMULATION_STEPS_PER_SECOND, cSettings->MAX_SIMULATION_STEPS_PER_FRAME);
+	const double dStepTime = cSettings->SIMULATION_STEP_TIME;
+
+	double dElapsedTime = cFixedTimestep.GetStepTime();
 	double dDelayTime = 0.0;
 	double dTotalFrameTime = 0.0;
+	bool bQuit = false;
 
 	// Render loop
 	while (!glfwWindowShouldClose(cSettings->pWindow)
 		/*&& (!CKeyboardController::GetInstance()->IsKeyReleased(GLFW_KEY_ESCAPE))*/)
 	{
-		// This is to prevent the program from crashing due to long dElapsedTime
-		// Causing Physics to calculate a large jump/fall for the player
-		if (dElapsedTime > 0.0166666666666667)
-			dElapsedTime = 0.0166666666666667;
+		// Start timer to calculate how long this frame works for
+		cWorkStopWatch.StartTimer();
 
-
-		// Call the active Game State's Update method
-		if (CGameStateManager::GetInstance()->Update(dElapsedTime) == false)
+		// Split the elapsed time into fixed steps. A slow frame is caught up with a limited number of steps,
+		// and the rest of its time is dropped, so that Physics never calculates a large jump/fall for the player
+		const unsigned int uiNumSteps = cFixedTimestep.Advance(dElapsedTime);
+		for (unsigned int i = 0; i < uiNumSteps; i++)
 		{
-			break;
+			// Call the active Game State's Update method
+			if (CGameStateManager::GetInstance()->Update(dStepTime) == false)
+			{
+				bQuit = true;
+				break;
+			}
+			CSoundController::GetInstance()->FadeUpdater(dStepTime);
+
+			// Perform Post Update Input Devices, so that a key press is only handled by 1 step.
+			// If there is no step in this frame, then the key press is kept for the next frame.
+			PostUpdateInputDevices();
 		}
-		CSoundController::GetInstance()->FadeUpdater(dElapsedTime);
+		if (bQuit)
+			break;
+
+		// Render the entities between the last 2 steps, by the time which is left in the accumulator
+		CEntity2D::SetRenderAlpha((float)cFixedTimestep.GetAlpha());
 
 		// Call the active Game State's Render method
 		CGameStateManager::GetInstance()->Render();
 
+		// Fence the vertices which this frame streamed, and move the next frame to the next segment
+		cStreamBuffer->EndFrame();
+
 		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(cSettings->pWindow);
 
-		// Perform Post Update Input Devices
-		PostUpdateInputDevices();
-
 		// Poll events
 		glfwPollEvents();
 
@@ -298,8 +355,13 @@ void Application::Run(void)
 		// Calculate the elapsed time since the last frame
 		dElapsedTime = cStopWatch.GetElapsedTime();
 
+		// Let the quality governor adjust the knobs from the time which this frame worked, before the limiter sleeps
+		cQualityGovernor->AddFrameTime(cWorkStopWatch.GetElapsedTime());
+
 		// Frame rate limiter. Limits each frame to a specified time in ms by sleeping.  
+		// The deferred work is run first in the time until the deadline, and the rest of the time is slept
 		dDelayTime = cSettings->frameTime - dElapsedTime * 1000;
+		cIdleTaskScheduler->RunIdle(dDelayTime * 0.001);
 		cStopWatch.WaitUntil((const long long)dDelayTime);
 
 		// Update the FPS Counter
@@ -313,14 +375,35 @@ void Application::Run(void)
  */
 void Application::Destroy(void)
 {
+	// Finish the deferred work, such as a save, before the game exits
+	if (cIdleTaskScheduler)
+	{
+		cIdleTaskScheduler->Flush();
+	}
+
 	// Destroy the CGameStateManager
 	CGameStateManager::GetInstance()->Destroy();
 	// Destory the ShaderManager
 	CShaderManager::GetInstance()->Destroy();
+	// Destroy the CTextureCache, after the game states which release their textures into it
+	CTextureCache::GetInstance()->Destroy();
+
+	// Destroy the CStreamBuffer instance, after the vertex arrays which read from it
+	if (cStreamBuffer)
+	{
+		cStreamBuffer->Destroy();
+		cStreamBuffer = NULL;
+	}
 
 	// Destroy the keyboard instance
 	CKeyboardController::GetInstance()->Destroy();
 
+	// Stop the worker threads
+	CWorkerPool::GetInstance()->Destroy();
+
+	// Stop the render thread, after the game states which submit lists to it
+	CRenderThread2D::GetInstance()->Destroy();
+
 	// Destroy the CFPSCounter instance
 	if (cFPSCounter)
 	{
@@ -328,6 +411,20 @@ void Application::Destroy(void)
 		cFPSCounter = NULL;
 	}
 
+	// Destroy the CQualityGovernor instance
+	if (cQualityGovernor)
+	{
+		cQualityGovernor->Destroy();
+		cQualityGovernor = NULL;
+	}
+
+	// Destroy the CIdleTaskScheduler instance
+	if (cIdleTaskScheduler)
+	{
+		cIdleTaskScheduler->Destroy();
+		cIdleTaskScheduler = NULL;
+	}
+
 	//// Destroy the cScene2D instance
 	//if (cScene2D)
 	//{
@@ -362,6 +459,9 @@ int Application::GetWindowWidth(void) const
  */
 Application::Application(void)
 	: cFPSCounter(NULL)
+	, cQualityGovernor(NULL)
+	, cIdleTaskScheduler(NULL)
+	, cStreamBuffer(NULL)
 {
 }
 
@@ -9,10 +9,18 @@
 #include "DesignPatterns\SingletonTemplate.h"
 
 #include "TimeControl\StopWatch.h"
+// Fixed Timestep
+#include "TimeControl\FixedTimestep.h"
 //#include "Scene2D\Scene2D.h"
 
 // FPS Counter
 #include "TimeControl\FPSCounter.h"
+// Quality Governor
+#include "TimeControl\QualityGovernor.h"
+// Idle Task Scheduler
+#include "TimeControl\IdleTaskScheduler.h"
+// Stream Buffer
+#include "RenderControl\StreamBuffer.h"
 
 struct GLFWwindow;
 
@@ -37,6 +45,10 @@ public:
 protected:
 	// Declare timer for calculating time per frame
 	CStopWatch cStopWatch;
+	// Declare timer for calculating the time which each frame spends working, without the frame rate limiter
+	CStopWatch cWorkStopWatch;
+	// Splits the time per frame into fixed simulation steps
+	CFixedTimestep cFixedTimestep;
 
 	// The handler to the CSettings instance
 	CSettings* cSettings;
@@ -44,6 +56,12 @@ protected:
 	//CScene2D* cScene2D;
 	// The handler to the CFPSCounter instance
 	CFPSCounter* cFPSCounter;
+	// The handler to the CQualityGovernor instance
+	CQualityGovernor* cQualityGovernor;
+	// The handler to the CIdleTaskScheduler instance
+	CIdleTaskScheduler* cIdleTaskScheduler;
+	// The handler to the CStreamBuffer instance
+	CStreamBuffer* cStreamBuffer;
 
 	// Constructor
 	Application(void);
@@ -21,6 +21,8 @@
 #include "Primitives/MeshBuilder.h"
 // Include ImageLoader
 #include "System\ImageLoader.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
 
@@ -42,7 +44,8 @@ using namespace std;
 CMenuState::CMenuState(void)
 	: background(NULL)
 {
-
+	startButtonData.textureID = 0;
+	exitButtonData.textureID = 0;
 }
 
 /**
@@ -218,6 +221,18 @@ void CMenuState::Destroy(void)
 		background = NULL;
 	}
 
+	// Release the images of the buttons
+	if (startButtonData.textureID != 0)
+	{
+		CTextureCache::GetInstance()->Release(startButtonData.textureID);
+		startButtonData.textureID = 0;
+	}
+	if (exitButtonData.textureID != 0)
+	{
+		CTextureCache::GetInstance()->Release(exitButtonData.textureID);
+		exitButtonData.textureID = 0;
+	}
+
 	// Cleanup
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
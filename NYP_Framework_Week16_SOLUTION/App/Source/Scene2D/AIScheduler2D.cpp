@@ -0,0 +1,378 @@
+/**
+ CAIScheduler2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "AIScheduler2D.h"
+
+// Include the Map2D for path finding
+#include "Map2D.h"
+
+// Include KinematicSolver2D for the blocking tiles
+#include "KinematicSolver2D.h"
+
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+// The time, in seconds, between the thinking of an agent in each level of detail band
+static const double arrTickIntervals[CAIScheduler2D::NUM_LOD_BANDS] = { 0.0, 0.1, 0.5 };
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CAIScheduler2D::CAIScheduler2D(void)
+	: uiExpansionBudget(2000)
+	, uiBudgetDebt(0)
+	, dTickIntervalScale(1.0)
+	, uiNumDeferredAgents(0)
+	, uiNumStarvedAgents(0)
+	, uiNumExpansions(0)
+	, uiNumCacheHits(0)
+	, uiNumCacheHitsThisFrame(0)
+	, i32vec2PlayerIndex(glm::i32vec2(0))
+	, cMap2D(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CAIScheduler2D::~CAIScheduler2D(void)
+{
+	// We won't delete this since it was created elsewhere
+	cMap2D = NULL;
+}
+
+/**
+ @brief Init Initialise this instance
+ */
+bool CAIScheduler2D::Init(void)
+{
+	// Get the handler to the CMap2D instance
+	cMap2D = CMap2D::GetInstance();
+
+	dqPathRequests.clear();
+	uiBudgetDebt = 0;
+	uiNumDeferredAgents = 0;
+	uiNumStarvedAgents = 0;
+	uiNumExpansions = 0;
+	uiNumCacheHits = 0;
+	uiNumCacheHitsThisFrame = 0;
+	return true;
+}
+
+/**
+ @brief Register an agent and return its handle. The handle of an unregistered agent is reused if there is one.
+ */
+CAIScheduler2D::HANDLE CAIScheduler2D::RegisterAgent(void)
+{
+	HANDLE hAgent;
+	if (vFreeAgents.size() > 0)
+	{
+		hAgent = vFreeAgents.back();
+		vFreeAgents.pop_back();
+	}
+	else
+	{
+		hAgent = (HANDLE)vAgents.size();
+		vAgents.push_back(Agent());
+	}
+
+	Agent& sAgent = vAgents[hAgent];
+	sAgent.bAlive = true;
+	sAgent.eBand = LOD_FAR;
+	// Stagger the agents, so that the agents in the same band do not all think in the same frame
+	sAgent.dTimeSinceTick = arrTickIntervals[LOD_FAR] * (hAgent % 4) / 4.0;
+	sAgent.bQueued = false;
+	sAgent.uiFramesWaiting = 0;
+	sAgent.i32vec2RequestStart = glm::i32vec2(0);
+	sAgent.i32vec2RequestGoal = glm::i32vec2(0);
+	sAgent.bHasPath = false;
+	sAgent.i32vec2PathStart = glm::i32vec2(0);
+	sAgent.i32vec2PathGoal = glm::i32vec2(0);
+	sAgent.vPath.clear();
+	return hAgent;
+}
+
+/**
+ @brief Unregister an agent, and remove its queued path request
+ */
+void CAIScheduler2D::UnregisterAgent(const HANDLE hAgent)
+{
+	if ((hAgent >= vAgents.size()) || (!vAgents[hAgent].bAlive))
+	{
+		cout << "CAIScheduler2D::UnregisterAgent: Invalid handle " << hAgent << endl;
+		return;
+	}
+
+	if (vAgents[hAgent].bQueued)
+	{
+		dqPathRequests.erase(std::remove(dqPathRequests.begin(), dqPathRequests.end(), hAgent), dqPathRequests.end());
+	}
+	vAgents[hAgent].bAlive = false;
+	vAgents[hAgent].vPath.clear();
+	vFreeAgents.push_back(hAgent);
+}
+
+/**
+ @brief Update once per frame before the agents. The queued paths are found in the order they were requested,
+		until the budget of A* expansions for this frame is used up. The requests which are left are deferred
+		to the front of the next frame, so every agent is served in turn.
+ @param i32vec2PlayerIndex A const glm::i32vec2& variable containing the player's position
+ */
+void CAIScheduler2D::Update(const glm::i32vec2& i32vec2PlayerIndex)
+{
+	this->i32vec2PlayerIndex = i32vec2PlayerIndex;
+
+	// Store the cache hits of the last frame
+	uiNumCacheHits = uiNumCacheHitsThisFrame;
+	uiNumCacheHitsThisFrame = 0;
+
+	// The last path of the previous frame may have gone over the budget, so take it from this frame
+	int iBudget = (int)uiExpansionBudget - (int)uiBudgetDebt;
+	uiNumExpansions = 0;
+
+	while ((!dqPathRequests.empty()) && (iBudget > 0))
+	{
+		const HANDLE hAgent = dqPathRequests.front();
+		dqPathRequests.pop_front();
+
+		Agent& sAgent = vAgents[hAgent];
+		sAgent.bQueued = false;
+
+		sAgent.vPath = cMap2D->PathFind(sAgent.i32vec2RequestStart,
+										sAgent.i32vec2RequestGoal,
+										heuristic::euclidean,
+										10);
+		sAgent.i32vec2PathStart = sAgent.i32vec2RequestStart;
+		sAgent.i32vec2PathGoal = sAgent.i32vec2RequestGoal;
+		sAgent.bHasPath = true;
+
+		const unsigned int uiPathExpansions = cMap2D->GetNumPathFindExpansions();
+		iBudget -= (int)uiPathExpansions;
+		uiNumExpansions += uiPathExpansions;
+	}
+	uiBudgetDebt = (iBudget < 0) ? (unsigned int)(-iBudget) : 0;
+
+	// Count the agents whose requests were deferred, and those which have waited too long
+	uiNumDeferredAgents = (unsigned int)dqPathRequests.size();
+	uiNumStarvedAgents = 0;
+	std::deque<HANDLE>::iterator it;
+	for (it = dqPathRequests.begin(); it != dqPathRequests.end(); ++it)
+	{
+		Agent& sAgent = vAgents[*it];
+		sAgent.uiFramesWaiting++;
+		if (sAgent.uiFramesWaiting >= STARVATION_FRAMES)
+		{
+			if (sAgent.uiFramesWaiting == STARVATION_FRAMES)
+				cout << "CAIScheduler2D::Update: Agent " << *it << " is starved of path finding." << endl;
+			uiNumStarvedAgents++;
+		}
+	}
+}
+
+/**
+ @brief Check if an agent should think in this frame. The time since it last thought is accumulated,
+		so an agent in a slower band thinks less often, but with the same total time.
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @param i32vec2AgentIndex A const glm::i32vec2& variable containing the agent's position
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ @param dThinkTime A double& variable to store the time since the agent last thought
+ @return true if the agent should think in this frame
+ */
+bool CAIScheduler2D::Tick(const HANDLE hAgent, const glm::i32vec2& i32vec2AgentIndex, const double dElapsedTime, double& dThinkTime)
+{
+	Agent& sAgent = vAgents[hAgent];
+	sAgent.eBand = CalculateBand(i32vec2AgentIndex);
+	sAgent.dTimeSinceTick += dElapsedTime;
+
+	if (sAgent.dTimeSinceTick < arrTickIntervals[sAgent.eBand] * dTickIntervalScale)
+		return false;
+
+	dThinkTime = sAgent.dTimeSinceTick;
+	sAgent.dTimeSinceTick = 0.0;
+	return true;
+}
+
+/**
+ @brief Request a path for an agent. The cached path is used if the goal has not moved by REPATH_DISTANCE,
+		and the agent is still on it. Otherwise, the request is queued to be found in a later Update.
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @param i32vec2Start A const glm::i32vec2& variable containing the agent's position
+ @param i32vec2Goal A const glm::i32vec2& variable containing the goal
+ @param vPath A std::vector<glm::i32vec2>& variable to store the rest of the path in, if it is PATH_READY
+ */
+CAIScheduler2D::PATH_STATUS CAIScheduler2D::RequestPath(const HANDLE hAgent,
+														const glm::i32vec2& i32vec2Start,
+														const glm::i32vec2& i32vec2Goal,
+														std::vector<glm::i32vec2>& vPath)
+{
+	Agent& sAgent = vAgents[hAgent];
+
+	if ((sAgent.bHasPath) &&
+		(glm::length(glm::vec2(i32vec2Goal - sAgent.i32vec2PathGoal)) < REPATH_DISTANCE))
+	{
+		// Find the agent's position on the cached path, and return the rest of the path after it
+		if (i32vec2Start == sAgent.i32vec2PathStart)
+		{
+			vPath = sAgent.vPath;
+			uiNumCacheHitsThisFrame++;
+			return PATH_READY;
+		}
+		std::vector<glm::i32vec2>::const_iterator it = std::find(sAgent.vPath.begin(), sAgent.vPath.end(), i32vec2Start);
+		if (it != sAgent.vPath.end())
+		{
+			vPath.assign(it + 1, sAgent.vPath.cend());
+			uiNumCacheHitsThisFrame++;
+			return PATH_READY;
+		}
+	}
+
+	// Queue the request. If it is already queued, then only its start and goal are updated
+	sAgent.i32vec2RequestStart = i32vec2Start;
+	sAgent.i32vec2RequestGoal = i32vec2Goal;
+	if (sAgent.bQueued == false)
+	{
+		dqPathRequests.push_back(hAgent);
+		sAgent.bQueued = true;
+		sAgent.uiFramesWaiting = 0;
+	}
+	return PATH_PENDING;
+}
+
+/**
+ @brief Get the level of detail band of an agent
+ */
+CAIScheduler2D::LOD_BAND CAIScheduler2D::GetBand(const HANDLE hAgent) const
+{
+	return vAgents[hAgent].eBand;
+}
+
+/**
+ @brief Set the number of A* expansions which can be used in each frame
+ */
+void CAIScheduler2D::SetExpansionBudget(const unsigned int uiExpansionBudget)
+{
+	this->uiExpansionBudget = uiExpansionBudget;
+}
+
+/**
+ @brief Get the number of A* expansions which can be used in each frame
+ */
+unsigned int CAIScheduler2D::GetExpansionBudget(void) const
+{
+	return uiExpansionBudget;
+}
+
+/**
+ @brief Set the scale of the time between the thinking of the agents. The agents in LOD_NEAR still think in every frame
+ @param dTickIntervalScale A const double variable containing the scale, which is 1 for the normal tick rate
+ */
+void CAIScheduler2D::SetTickIntervalScale(const double dTickIntervalScale)
+{
+	if (dTickIntervalScale > 0.0)
+		this->dTickIntervalScale = dTickIntervalScale;
+}
+
+/**
+ @brief Get the scale of the time between the thinking of the agents
+ */
+double CAIScheduler2D::GetTickIntervalScale(void) const
+{
+	return dTickIntervalScale;
+}
+
+/**
+ @brief Get the number of agents whose path requests were deferred in the last frame
+ */
+unsigned int CAIScheduler2D::GetNumDeferredAgents(void) const
+{
+	return uiNumDeferredAgents;
+}
+
+/**
+ @brief Get the number of agents whose path requests have waited for STARVATION_FRAMES or more
+ */
+unsigned int CAIScheduler2D::GetNumStarvedAgents(void) const
+{
+	return uiNumStarvedAgents;
+}
+
+/**
+ @brief Get the number of A* expansions in the last frame
+ */
+unsigned int CAIScheduler2D::GetNumExpansions(void) const
+{
+	return uiNumExpansions;
+}
+
+/**
+ @brief Get the number of path requests which were answered from the cache in the last frame
+ */
+unsigned int CAIScheduler2D::GetNumCacheHits(void) const
+{
+	return uiNumCacheHits;
+}
+
+/**
+ @brief Print out the details about this class instance in the console
+ */
+void CAIScheduler2D::PrintSelf(void) const
+{
+	cout << endl << "CAIScheduler2D::PrintSelf()" << endl;
+	cout << "========================" << endl;
+	cout << "Agents\t=\t" << vAgents.size() - vFreeAgents.size() << endl;
+	cout << "Budget\t=\t" << uiExpansionBudget << " (debt " << uiBudgetDebt << ")" << endl;
+	cout << "Expansions\t=\t" << uiNumExpansions << endl;
+	cout << "Cache hits\t=\t" << uiNumCacheHits << endl;
+	cout << "Deferred\t=\t" << uiNumDeferredAgents << endl;
+	cout << "Starved\t=\t" << uiNumStarvedAgents << endl;
+}
+
+/**
+ @brief Calculate the level of detail band of an agent at a position.
+		An agent which can see the player is moved up by 1 band.
+ */
+CAIScheduler2D::LOD_BAND CAIScheduler2D::CalculateBand(const glm::i32vec2& i32vec2AgentIndex) const
+{
+	const float fDistance = glm::length(glm::vec2(i32vec2PlayerIndex - i32vec2AgentIndex));
+	if (fDistance < NEAR_DISTANCE)
+		return LOD_NEAR;
+	if (fDistance < MID_DISTANCE)
+		return HasLineOfSight(i32vec2AgentIndex, i32vec2PlayerIndex) ? LOD_NEAR : LOD_MID;
+	return HasLineOfSight(i32vec2AgentIndex, i32vec2PlayerIndex) ? LOD_MID : LOD_FAR;
+}
+
+/**
+ @brief Check if there are no blocking tiles on the line between 2 positions, using Bresenham's line algorithm
+ */
+bool CAIScheduler2D::HasLineOfSight(const glm::i32vec2& i32vec2From, const glm::i32vec2& i32vec2To) const
+{
+	const TileGridView2D sGrid = cMap2D->GetGridView();
+
+	const int iDeltaX = abs(i32vec2To.x - i32vec2From.x);
+	const int iDeltaY = -abs(i32vec2To.y - i32vec2From.y);
+	const int iStepX = (i32vec2From.x < i32vec2To.x) ? 1 : -1;
+	const int iStepY = (i32vec2From.y < i32vec2To.y) ? 1 : -1;
+	int iError = iDeltaX + iDeltaY;
+
+	glm::i32vec2 i32vec2Current = i32vec2From;
+	while (i32vec2Current != i32vec2To)
+	{
+		const int iError2 = 2 * iError;
+		if (iError2 >= iDeltaY)
+		{
+			iError += iDeltaY;
+			i32vec2Current.x += iStepX;
+		}
+		if (iError2 <= iDeltaX)
+		{
+			iError += iDeltaX;
+			i32vec2Current.y += iStepY;
+		}
+		if (sGrid.GetValue(i32vec2Current.x, i32vec2Current.y) >= CKinematicSolver2D::BLOCKING_TILE)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,172 @@
+/**
+ CAIScheduler2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector and deque
+#include <vector>
+#include <deque>
+
+// Include the Map2D for path finding
+class CMap2D;
+
+/**
+ CAIScheduler2D: Decides when each AI agent thinks, and when its paths are found.
+				 An agent thinks at a rate from its level of detail band, which depends on its
+				 distance to the player and if it can see the player, so that far agents cost less.
+				 Paths are cached until the goal moves by REPATH_DISTANCE, and new paths are found
+				 in the order they were requested, within a budget of A* expansions per frame.
+ */
+class CAIScheduler2D : public CSingletonTemplate<CAIScheduler2D>
+{
+	friend CSingletonTemplate<CAIScheduler2D>;
+public:
+	// A handle to an agent
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// The level of detail bands, from the most to the least frequent thinking
+	enum LOD_BAND
+	{
+		LOD_NEAR = 0,
+		LOD_MID,
+		LOD_FAR,
+		NUM_LOD_BANDS
+	};
+
+	// The status of a path request
+	enum PATH_STATUS
+	{
+		PATH_READY = 0,		// The path is up to date
+		PATH_PENDING,		// The path is queued, so keep following the previous one
+		NUM_PATH_STATUS
+	};
+
+	// Init
+	bool Init(void);
+
+	// Register an agent and return its handle
+	HANDLE RegisterAgent(void);
+	// Unregister an agent. Its handle may be reused by the next agent which is registered
+	void UnregisterAgent(const HANDLE hAgent);
+
+	// Update once per frame before the agents, to find the queued paths within the budget
+	void Update(const glm::i32vec2& i32vec2PlayerIndex);
+
+	// Check if an agent should think in this frame, and get the time since it last thought
+	bool Tick(const HANDLE hAgent, const glm::i32vec2& i32vec2AgentIndex, const double dElapsedTime, double& dThinkTime);
+
+	// Request a path for an agent. The path is returned if it is PATH_READY
+	PATH_STATUS RequestPath(const HANDLE hAgent,
+							const glm::i32vec2& i32vec2Start,
+							const glm::i32vec2& i32vec2Goal,
+							std::vector<glm::i32vec2>& vPath);
+
+	// Get the level of detail band of an agent
+	LOD_BAND GetBand(const HANDLE hAgent) const;
+
+	// Set the number of A* expansions which can be used in each frame
+	void SetExpansionBudget(const unsigned int uiExpansionBudget);
+	// Get the number of A* expansions which can be used in each frame
+	unsigned int GetExpansionBudget(void) const;
+
+	// Set the scale of the time between the thinking of the agents, which is 1 for the normal tick rate
+	void SetTickIntervalScale(const double dTickIntervalScale);
+	// Get the scale of the time between the thinking of the agents
+	double GetTickIntervalScale(void) const;
+
+	// Get the number of agents whose path requests were deferred in the last frame
+	unsigned int GetNumDeferredAgents(void) const;
+	// Get the number of agents whose path requests have waited for STARVATION_FRAMES or more
+	unsigned int GetNumStarvedAgents(void) const;
+	// Get the number of A* expansions in the last frame
+	unsigned int GetNumExpansions(void) const;
+	// Get the number of path requests which were answered from the cache in the last frame
+	unsigned int GetNumCacheHits(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The distances, in tiles, of the level of detail bands
+	const float NEAR_DISTANCE = 6.0f;
+	const float MID_DISTANCE = 16.0f;
+	// The distance, in tiles, which the goal must move before a cached path is found again
+	const float REPATH_DISTANCE = 2.0f;
+	// The number of frames which a path request can wait before its agent is starved
+	const unsigned int STARVATION_FRAMES = 30;
+
+	// The state of an agent
+	struct Agent
+	{
+		// Boolean flag to indicate if this agent is registered
+		bool bAlive;
+		// The level of detail band
+		LOD_BAND eBand;
+		// The time since this agent last thought
+		double dTimeSinceTick;
+		// Boolean flag to indicate if a path request is in the queue
+		bool bQueued;
+		// The number of frames which the queued path request has waited
+		unsigned int uiFramesWaiting;
+		// The start and goal of the queued path request
+		glm::i32vec2 i32vec2RequestStart;
+		glm::i32vec2 i32vec2RequestGoal;
+		// Boolean flag to indicate if a path has been found
+		bool bHasPath;
+		// The start and goal of the cached path
+		glm::i32vec2 i32vec2PathStart;
+		glm::i32vec2 i32vec2PathGoal;
+		// The cached path, which does not include its start
+		std::vector<glm::i32vec2> vPath;
+	};
+
+	// The agents, indexed by their handles
+	std::vector<Agent> vAgents;
+	// The handles of unregistered agents, which can be reused
+	std::vector<HANDLE> vFreeAgents;
+	// The queued path requests, in the order they were requested
+	std::deque<HANDLE> dqPathRequests;
+
+	// The number of A* expansions which can be used in each frame
+	unsigned int uiExpansionBudget;
+	// The number of A* expansions which the last path went over the budget, which is taken from the next frame
+	unsigned int uiBudgetDebt;
+
+	// The scale of the time between the thinking of the agents
+	double dTickIntervalScale;
+
+	// The statistics for the last frame
+	unsigned int uiNumDeferredAgents;
+	unsigned int uiNumStarvedAgents;
+	unsigned int uiNumExpansions;
+	unsigned int uiNumCacheHits;
+	unsigned int uiNumCacheHitsThisFrame;
+
+	// The player's position in this frame
+	glm::i32vec2 i32vec2PlayerIndex;
+
+	// Handler to the CMap2D instance
+	CMap2D* cMap2D;
+
+	// Constructor
+	CAIScheduler2D(void);
+
+	// Destructor
+	virtual ~CAIScheduler2D(void);
+
+	// Calculate the level of detail band of an agent at a position
+	LOD_BAND CalculateBand(const glm::i32vec2& i32vec2AgentIndex) const;
+
+	// Check if there are no blocking tiles between 2 positions
+	bool HasLineOfSight(const glm::i32vec2& i32vec2From, const glm::i32vec2& i32vec2To) const;
+};
@@ -0,0 +1,497 @@
+/**
+ CAcidSimulation2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "AcidSimulation2D.h"
+
+// Include the Map2D which the acid is loaded from and written back to
+#include "Map2D.h"
+
+// Include PhysicsWorld2D for the direction of the gravity
+#include "PhysicsWorld2D.h"
+
+// Include Physics2D for the gravity directions
+#include "Physics2D.h"
+
+// Include WorkerPool
+#include "System\WorkerPool.h"
+
+#include <iostream>
+using namespace std;
+
+// The width and height of a chunk, in tiles
+const int CAcidSimulation2D::CHUNK_SIZE;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CAcidSimulation2D::CAcidSimulation2D(void)
+	: iNumCols(0)
+	, iNumRows(0)
+	, iNumChunksX(0)
+	, iNumChunksY(0)
+	, i32vec2Down(0, -1)
+	, i32vec2Side(1, 0)
+	, ucGravityDirection(CPhysics2D::GRAVITY_DOWN)
+	, bRetileAcid(false)
+	, uiNumSteps(0)
+	, dStepTime(0.05)
+	, dTimeSinceStep(0.0)
+	, bParallelUpdate(true)
+	, uiNumActiveChunks(0)
+	, uiNumChangedCells(0)
+	, cMap2D(NULL)
+	, cWorkerPool(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CAcidSimulation2D::~CAcidSimulation2D(void)
+{
+	// We won't delete these since they were created elsewhere
+	cMap2D = NULL;
+	cWorkerPool = NULL;
+}
+
+/**
+ @brief Init Initialise this instance, and load the acid from the current level of the map
+ */
+bool CAcidSimulation2D::Init(void)
+{
+	// Get the handler to the CMap2D instance
+	cMap2D = CMap2D::GetInstance();
+	// Get the handler to the CWorkerPool instance
+	cWorkerPool = CWorkerPool::GetInstance();
+
+	SetGravityDirection(CPhysicsWorld2D::GetInstance()->GetGravityDirection());
+	LoadFromMap();
+
+	uiNumSteps = 0;
+	dTimeSinceStep = 0.0;
+	return true;
+}
+
+/**
+ @brief Resize the grid and clear it to empty cells
+ @param iNumCols A const int variable containing the number of columns
+ @param iNumRows A const int variable containing the number of rows
+ */
+void CAcidSimulation2D::Resize(const int iNumCols, const int iNumRows)
+{
+	this->iNumCols = iNumCols;
+	this->iNumRows = iNumRows;
+	vCurrent.assign(iNumCols * iNumRows, CELL_EMPTY);
+	vNext.assign(iNumCols * iNumRows, CELL_EMPTY);
+
+	iNumChunksX = (iNumCols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	iNumChunksY = (iNumRows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	vActiveChunks.assign(iNumChunksX * iNumChunksY, 0);
+	vChangedChunks.assign(iNumChunksX * iNumChunksY, 0);
+	vPassChunks.clear();
+	vPassChunks.reserve(iNumChunksX * iNumChunksY);
+}
+
+/**
+ @brief Update once per frame, before the entities.
+		The tiles which were changed in the map, such as by a bomb, are loaded and their chunks are activated.
+		If the gravity changed, the acid tiles are turned to face it, including the acid which has settled.
+		Then the acid is stepped once if the step time has passed.
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CAcidSimulation2D::Update(const double dElapsedTime)
+{
+	SetGravityDirection(CPhysicsWorld2D::GetInstance()->GetGravityDirection());
+
+	const TileGridView2D sGridView = cMap2D->GetGridView();
+	if ((cMap2D->IsLevelChanged()) || (sGridView.iNumCols != iNumCols) || (sGridView.iNumRows != iNumRows))
+		LoadFromMap();
+	else
+		LoadModifiedTiles();
+
+	if (bRetileAcid)
+		RetileAcid();
+
+	dTimeSinceStep += dElapsedTime;
+	if (dTimeSinceStep >= dStepTime)
+	{
+		dTimeSinceStep -= dStepTime;
+		// Do not try to catch up on a slow frame
+		if (dTimeSinceStep >= dStepTime)
+			dTimeSinceStep = 0.0;
+
+		Step();
+	}
+}
+
+/**
+ @brief Step the automaton once. The active chunks are stepped in 4 checkerboard passes,
+		and the chunks in each pass are stepped in parallel. Then the changes are committed.
+ */
+void CAcidSimulation2D::Step(void)
+{
+	uiNumActiveChunks = 0;
+	for (unsigned int i = 0; i < vActiveChunks.size(); i++)
+	{
+		vChangedChunks[i] = 0;
+		if (vActiveChunks[i])
+			uiNumActiveChunks++;
+	}
+
+	for (int iPass = 0; iPass < 4; iPass++)
+	{
+		// Find the active chunks in this corner of the checkerboard
+		vPassChunks.clear();
+		for (int iChunkY = (iPass >> 1); iChunkY < iNumChunksY; iChunkY += 2)
+		{
+			for (int iChunkX = (iPass & 1); iChunkX < iNumChunksX; iChunkX += 2)
+			{
+				const int iChunk = iChunkY * iNumChunksX + iChunkX;
+				if (vActiveChunks[iChunk])
+					vPassChunks.push_back(iChunk);
+			}
+		}
+		if (vPassChunks.empty())
+			continue;
+
+		if (cWorkerPool)
+		{
+			cWorkerPool->ParallelFor((unsigned int)vPassChunks.size(),
+				[this](const unsigned int uiBegin, const unsigned int uiEnd, const unsigned int)
+				{
+					for (unsigned int i = uiBegin; i < uiEnd; i++)
+						StepChunk(vPassChunks[i]);
+				},
+				bParallelUpdate ? 0 : 1);
+		}
+		else
+		{
+			for (auto& iChunk : vPassChunks)
+				StepChunk(iChunk);
+		}
+	}
+
+	// Only the chunks which changed, and their neighbours, are stepped in the next step
+	std::fill(vActiveChunks.begin(), vActiveChunks.end(), 0);
+	for (int iChunkY = 0; iChunkY < iNumChunksY; iChunkY++)
+	{
+		for (int iChunkX = 0; iChunkX < iNumChunksX; iChunkX++)
+		{
+			if (vChangedChunks[iChunkY * iNumChunksX + iChunkX])
+				ActivateChunkAndNeighbours(iChunkX, iChunkY);
+		}
+	}
+
+	Commit(cMap2D != NULL);
+	uiNumSteps++;
+}
+
+/**
+ @brief Set the contents of a cell in both grids, and activate its chunk and the chunks around it
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ @param eCell A const CELL variable containing the contents of the cell
+ */
+void CAcidSimulation2D::SetCell(const int iCol, const int iRow, const CELL eCell)
+{
+	if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+		return;
+
+	vCurrent[iRow * iNumCols + iCol] = (unsigned char)eCell;
+	vNext[iRow * iNumCols + iCol] = (unsigned char)eCell;
+	ActivateChunkAndNeighbours(iCol / CHUNK_SIZE, iRow / CHUNK_SIZE);
+}
+
+/**
+ @brief Get the contents of a cell. Cells outside the grid are solid
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ */
+CAcidSimulation2D::CELL CAcidSimulation2D::GetCell(const int iCol, const int iRow) const
+{
+	if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+		return CELL_SOLID;
+
+	return (CELL)vCurrent[iRow * iNumCols + iCol];
+}
+
+/**
+ @brief Set the direction of the gravity. All the chunks are activated when it changes, as the acid will flow again,
+		and the acid tiles are turned to face it on the next update
+ @param ucGravityDirection A const unsigned char variable containing a CPhysics2D::GRAVITY_DIRECTION
+ */
+void CAcidSimulation2D::SetGravityDirection(const unsigned char ucGravityDirection)
+{
+	// The direction of each CPhysics2D::GRAVITY_DIRECTION
+	static const glm::i32vec2 arrDownVectors[CPhysics2D::GRAVITY_COUNT] = {
+		glm::i32vec2(0, -1), glm::i32vec2(0, 1), glm::i32vec2(1, 0), glm::i32vec2(-1, 0)
+	};
+
+	if (ucGravityDirection >= CPhysics2D::GRAVITY_COUNT)
+		return;
+
+	if (this->ucGravityDirection != ucGravityDirection)
+	{
+		std::fill(vActiveChunks.begin(), vActiveChunks.end(), 1);
+		bRetileAcid = true;
+	}
+
+	this->ucGravityDirection = ucGravityDirection;
+	i32vec2Down = arrDownVectors[ucGravityDirection];
+	i32vec2Side = glm::i32vec2(i32vec2Down.y, i32vec2Down.x);
+}
+
+/**
+ @brief Set if the chunks are stepped on the worker threads, or serially on the main thread.
+		Both modes give the same results.
+ */
+void CAcidSimulation2D::SetParallelUpdate(const bool bParallelUpdate)
+{
+	this->bParallelUpdate = bParallelUpdate;
+}
+
+/**
+ @brief Get if the chunks are stepped on the worker threads
+ */
+bool CAcidSimulation2D::GetParallelUpdate(void) const
+{
+	return bParallelUpdate;
+}
+
+/**
+ @brief Set the time between steps, in seconds
+ */
+void CAcidSimulation2D::SetStepTime(const double dStepTime)
+{
+	if (dStepTime > 0.0)
+		this->dStepTime = dStepTime;
+}
+
+/**
+ @brief Get the number of chunks which were stepped in the last step
+ */
+unsigned int CAcidSimulation2D::GetNumActiveChunks(void) const
+{
+	return uiNumActiveChunks;
+}
+
+/**
+ @brief Get the number of cells which changed in the last step
+ */
+unsigned int CAcidSimulation2D::GetNumChangedCells(void) const
+{
+	return uiNumChangedCells;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CAcidSimulation2D::PrintSelf(void) const
+{
+	cout << "CAcidSimulation2D::PrintSelf()" << endl;
+	cout << "Grid: " << iNumCols << "x" << iNumRows
+		<< ", Chunks: " << iNumChunksX << "x" << iNumChunksY
+		<< ", Active chunks: " << uiNumActiveChunks
+		<< ", Changed cells: " << uiNumChangedCells << endl;
+}
+
+/**
+ @brief Load all the cells from the current level of the map, and activate all the chunks
+ */
+void CAcidSimulation2D::LoadFromMap(void)
+{
+	const TileGridView2D sGridView = cMap2D->GetGridView();
+	if ((sGridView.iNumCols != iNumCols) || (sGridView.iNumRows != iNumRows))
+		Resize(sGridView.iNumCols, sGridView.iNumRows);
+
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			const unsigned int uiValue = sGridView.GetValue(iCol, iRow);
+			unsigned char ucCell = CELL_SOLID;
+			if (uiValue == 0)
+				ucCell = CELL_EMPTY;
+			else if ((uiValue >= CMap2D::TILE_ID::ACID_DOWN) && (uiValue <= CMap2D::TILE_ID::ACID_LEFT))
+				ucCell = CELL_ACID;
+			vCurrent[iRow * iNumCols + iCol] = ucCell;
+		}
+	}
+	vNext = vCurrent;
+	std::fill(vActiveChunks.begin(), vActiveChunks.end(), 1);
+}
+
+/**
+ @brief Load the cells which were modified in the map since the last frame.
+		The cells which this simulation wrote to the map already match, so they do not activate their chunks
+ */
+void CAcidSimulation2D::LoadModifiedTiles(void)
+{
+	const TileGridView2D sGridView = cMap2D->GetGridView();
+	const std::vector<glm::i32vec2>& vModifiedTiles = cMap2D->GetModifiedTiles();
+	for (auto& tile : vModifiedTiles)
+	{
+		const unsigned int uiValue = sGridView.GetValue(tile.x, tile.y);
+		CELL eCell = CELL_SOLID;
+		if (uiValue == 0)
+			eCell = CELL_EMPTY;
+		else if ((uiValue >= CMap2D::TILE_ID::ACID_DOWN) && (uiValue <= CMap2D::TILE_ID::ACID_LEFT))
+			eCell = CELL_ACID;
+
+		if (GetCell(tile.x, tile.y) != eCell)
+			SetCell(tile.x, tile.y, eCell);
+	}
+}
+
+/**
+ @brief Compare the grids in the active chunks, which include every chunk that changed in this step,
+		write the changed cells back to the map, and make the next grid current
+ @param bWriteToMap A const bool variable which is true to write the changed cells to the map
+ */
+void CAcidSimulation2D::Commit(const bool bWriteToMap)
+{
+	const unsigned int uiAcidTile = CMap2D::TILE_ID::ACID_DOWN + ucGravityDirection;
+
+	uiNumChangedCells = 0;
+	for (int iChunkY = 0; iChunkY < iNumChunksY; iChunkY++)
+	{
+		for (int iChunkX = 0; iChunkX < iNumChunksX; iChunkX++)
+		{
+			if (!vActiveChunks[iChunkY * iNumChunksX + iChunkX])
+				continue;
+
+			const int iMaxRow = std::min((iChunkY + 1) * CHUNK_SIZE, iNumRows);
+			const int iMaxCol = std::min((iChunkX + 1) * CHUNK_SIZE, iNumCols);
+			for (int iRow = iChunkY * CHUNK_SIZE; iRow < iMaxRow; iRow++)
+			{
+				for (int iCol = iChunkX * CHUNK_SIZE; iCol < iMaxCol; iCol++)
+				{
+					const int iIndex = iRow * iNumCols + iCol;
+					if (vCurrent[iIndex] == vNext[iIndex])
+						continue;
+
+					vCurrent[iIndex] = vNext[iIndex];
+					uiNumChangedCells++;
+					if (bWriteToMap)
+						cMap2D->SetMapInfo(iRow, iCol, (vNext[iIndex] == CELL_ACID) ? uiAcidTile : 0);
+				}
+			}
+		}
+	}
+}
+
+/**
+ @brief Write every acid cell to the map with the tile for the current direction of the gravity.
+		The cells which move are written in Commit, but the acid which has settled would keep its old tile.
+ */
+void CAcidSimulation2D::RetileAcid(void)
+{
+	bRetileAcid = false;
+	if (cMap2D == NULL)
+		return;
+
+	const unsigned int uiAcidTile = CMap2D::TILE_ID::ACID_DOWN + ucGravityDirection;
+	const TileGridView2D sGridView = cMap2D->GetGridView();
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			if ((vCurrent[iRow * iNumCols + iCol] == CELL_ACID) && (sGridView.GetValue(iCol, iRow) != uiAcidTile))
+				cMap2D->SetMapInfo(iRow, iCol, uiAcidTile);
+		}
+	}
+}
+
+/**
+ @brief Step the cells of a chunk, from the side which the gravity pulls towards,
+		so that a column of acid can fall together in one step
+ @param iChunk A const int variable containing the index of the chunk
+ */
+void CAcidSimulation2D::StepChunk(const int iChunk)
+{
+	const int iMinCol = (iChunk % iNumChunksX) * CHUNK_SIZE;
+	const int iMinRow = (iChunk / iNumChunksX) * CHUNK_SIZE;
+	const int iMaxCol = std::min(iMinCol + CHUNK_SIZE, iNumCols);
+	const int iMaxRow = std::min(iMinRow + CHUNK_SIZE, iNumRows);
+
+	// Iterate along the gravity from its far side, and across it
+	const bool bVertical = (i32vec2Down.y != 0);
+	const int iNumLines = bVertical ? (iMaxRow - iMinRow) : (iMaxCol - iMinCol);
+	const int iLineLength = bVertical ? (iMaxCol - iMinCol) : (iMaxRow - iMinRow);
+	const bool bAscending = bVertical ? (i32vec2Down.y < 0) : (i32vec2Down.x < 0);
+
+	bool bChanged = false;
+	for (int iLine = 0; iLine < iNumLines; iLine++)
+	{
+		for (int i = 0; i < iLineLength; i++)
+		{
+			glm::i32vec2 i32vec2Cell;
+			if (bVertical)
+				i32vec2Cell = glm::i32vec2(iMinCol + i, bAscending ? iMinRow + iLine : iMaxRow - 1 - iLine);
+			else
+				i32vec2Cell = glm::i32vec2(bAscending ? iMinCol + iLine : iMaxCol - 1 - iLine, iMinRow + i);
+
+			if (vCurrent[i32vec2Cell.y * iNumCols + i32vec2Cell.x] != CELL_ACID)
+				continue;
+
+			// Alternate the side which is tried first
+			const glm::i32vec2 i32vec2FirstSide = (((i32vec2Cell.x + i32vec2Cell.y + uiNumSteps) & 1) == 0) ? i32vec2Side : -i32vec2Side;
+
+			if (MoveCell(i32vec2Cell, i32vec2Cell + i32vec2Down) ||
+				MoveCell(i32vec2Cell, i32vec2Cell + i32vec2Down + i32vec2FirstSide) ||
+				MoveCell(i32vec2Cell, i32vec2Cell + i32vec2Down - i32vec2FirstSide))
+			{
+				bChanged = true;
+			}
+			// Only spread sideways if there is acid above, so that a layer of acid settles instead of sloshing forever
+			else if ((GetCell(i32vec2Cell.x - i32vec2Down.x, i32vec2Cell.y - i32vec2Down.y) == CELL_ACID) &&
+					 (MoveCell(i32vec2Cell, i32vec2Cell + i32vec2FirstSide) ||
+					  MoveCell(i32vec2Cell, i32vec2Cell - i32vec2FirstSide)))
+			{
+				bChanged = true;
+			}
+		}
+	}
+
+	if (bChanged)
+		vChangedChunks[iChunk] = 1;
+}
+
+/**
+ @brief Try to move the acid at a cell into an empty cell of the next grid
+ @param i32vec2From A const glm::i32vec2& variable containing the cell with the acid
+ @param i32vec2To A const glm::i32vec2& variable containing the cell to move to
+ @return true if the acid was moved
+ */
+bool CAcidSimulation2D::MoveCell(const glm::i32vec2& i32vec2From, const glm::i32vec2& i32vec2To)
+{
+	if ((i32vec2To.x < 0) || (i32vec2To.x >= iNumCols) || (i32vec2To.y < 0) || (i32vec2To.y >= iNumRows))
+		return false;
+
+	const int iTo = i32vec2To.y * iNumCols + i32vec2To.x;
+	if (vNext[iTo] != CELL_EMPTY)
+		return false;
+
+	vNext[i32vec2From.y * iNumCols + i32vec2From.x] = CELL_EMPTY;
+	vNext[iTo] = CELL_ACID;
+	return true;
+}
+
+/**
+ @brief Activate a chunk and its neighbours for the next step
+ @param iChunkX A const int variable containing the column of the chunk
+ @param iChunkY A const int variable containing the row of the chunk
+ */
+void CAcidSimulation2D::ActivateChunkAndNeighbours(const int iChunkX, const int iChunkY)
+{
+	for (int iY = iChunkY - 1; iY <= iChunkY + 1; iY++)
+	{
+		for (int iX = iChunkX - 1; iX <= iChunkX + 1; iX++)
+		{
+			if ((iX >= 0) && (iX < iNumChunksX) && (iY >= 0) && (iY < iNumChunksY))
+				vActiveChunks[iY * iNumChunksX + iX] = 1;
+		}
+	}
+}
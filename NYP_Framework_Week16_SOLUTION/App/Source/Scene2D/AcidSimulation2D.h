@@ -0,0 +1,159 @@
+/**
+ CAcidSimulation2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector
+#include <vector>
+
+// Include the Map2D which the acid is loaded from and written back to
+class CMap2D;
+
+// Include WorkerPool
+class CWorkerPool;
+
+/**
+ CAcidSimulation2D: Simulates the acid tiles as a falling-sand cellular automaton, which flows towards the gravity.
+					An acid cell moves to the first empty cell of: below it, diagonally below it, then beside it.
+					The sides are tried in an order which alternates between cells and steps, so that the acid spreads evenly.
+
+					The grid is double-buffered. A step reads the current grid and writes the next grid,
+					and only the chunks which changed are compared and copied back when the step is committed.
+					Only the active chunks are stepped, which are the chunks that changed in the last step,
+					their neighbours, and the chunks where the map was modified.
+
+					The chunks are stepped in 4 passes, one for each corner of a 2x2 checkerboard of chunks.
+					The chunks in a pass are 1 chunk apart, and a cell moves by at most 1 tile, so they never touch
+					the same cells and can be stepped on worker threads in any order with the same result.
+
+					The grid does not depend on OpenGL or CMap2D, so it can be stepped without a map.
+ */
+class CAcidSimulation2D : public CSingletonTemplate<CAcidSimulation2D>
+{
+	friend CSingletonTemplate<CAcidSimulation2D>;
+public:
+	// The contents of a cell
+	enum CELL
+	{
+		CELL_EMPTY = 0,
+		CELL_ACID,
+		CELL_SOLID,
+		NUM_CELLS
+	};
+
+	// Init, and load the acid from the current level of the map
+	bool Init(void);
+
+	// Resize the grid and clear it to empty cells
+	void Resize(const int iNumCols, const int iNumRows);
+
+	// Update once per frame. The map's modifications are loaded, and the acid is stepped at a fixed rate
+	void Update(const double dElapsedTime);
+
+	// Step the automaton once
+	void Step(void);
+
+	// Set the contents of a cell, and activate its chunk. The row is from bottom to top
+	void SetCell(const int iCol, const int iRow, const CELL eCell);
+	// Get the contents of a cell. Cells outside the grid are solid
+	CELL GetCell(const int iCol, const int iRow) const;
+
+	// Set the direction of the gravity, as a CPhysics2D::GRAVITY_DIRECTION
+	void SetGravityDirection(const unsigned char ucGravityDirection);
+
+	// Set if the chunks are stepped on the worker threads, or serially on the main thread
+	void SetParallelUpdate(const bool bParallelUpdate);
+	// Get if the chunks are stepped on the worker threads
+	bool GetParallelUpdate(void) const;
+
+	// Set the time between steps, in seconds
+	void SetStepTime(const double dStepTime);
+
+	// Get the number of chunks which were stepped in the last step
+	unsigned int GetNumActiveChunks(void) const;
+	// Get the number of cells which changed in the last step
+	unsigned int GetNumChangedCells(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The width and height of a chunk, in tiles. This must be 2 or more
+	static const int CHUNK_SIZE = 8;
+
+	// The grids, indexed by row * iNumCols + col, with the rows from bottom to top
+	std::vector<unsigned char> vCurrent;
+	std::vector<unsigned char> vNext;
+	int iNumCols;
+	int iNumRows;
+
+	// The number of chunks in each axis
+	int iNumChunksX;
+	int iNumChunksY;
+	// Boolean flags to indicate if each chunk is stepped in the next step
+	std::vector<unsigned char> vActiveChunks;
+	// Boolean flags to indicate if a cell in each chunk moved in this step. Each flag is only written by its chunk's thread
+	std::vector<unsigned char> vChangedChunks;
+	// The active chunks of the pass which is being stepped
+	std::vector<int> vPassChunks;
+
+	// The direction of the gravity, and the 2 directions beside it
+	glm::i32vec2 i32vec2Down;
+	glm::i32vec2 i32vec2Side;
+	unsigned char ucGravityDirection;
+	// Boolean flag to indicate if the gravity changed since the acid tiles in the map were written
+	bool bRetileAcid;
+
+	// The number of steps, which alternates the order of the sides
+	unsigned int uiNumSteps;
+	// The time between steps, and the time since the last step
+	double dStepTime;
+	double dTimeSinceStep;
+
+	// Boolean flag to indicate if the chunks are stepped on the worker threads
+	bool bParallelUpdate;
+
+	// The statistics for the last step
+	unsigned int uiNumActiveChunks;
+	unsigned int uiNumChangedCells;
+
+	// Handler to the CMap2D instance
+	CMap2D* cMap2D;
+	// Handler to the CWorkerPool instance
+	CWorkerPool* cWorkerPool;
+
+	// Constructor
+	CAcidSimulation2D(void);
+
+	// Destructor
+	virtual ~CAcidSimulation2D(void);
+
+	// Load all the cells from the current level of the map
+	void LoadFromMap(void);
+
+	// Load the cells which were modified in the map since the last frame
+	void LoadModifiedTiles(void);
+
+	// Write the changed cells back to the map, and make the next grid current
+	void Commit(const bool bWriteToMap);
+
+	// Write every acid cell to the map with the tile for the current direction of the gravity
+	void RetileAcid(void);
+
+	// Step the cells of a chunk
+	void StepChunk(const int iChunk);
+
+	// Try to move the acid at a cell into an empty cell of the next grid
+	bool MoveCell(const glm::i32vec2& i32vec2From, const glm::i32vec2& i32vec2To);
+
+	// Activate a chunk and its neighbours for the next step
+	void ActivateChunkAndNeighbours(const int iChunkX, const int iChunkY);
+};
@@ -8,6 +8,9 @@
 //For allowing creating of Quad Mesh 
 #include "Primitives/MeshBuilder.h"
 
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+
 #include <iostream>
 #include <vector>
 
@@ -26,7 +29,7 @@ CBackgroundEntity::~CBackgroundEntity()
 bool CBackgroundEntity::Init()
 {
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 
 	if (LoadTexture(textureName.c_str()) == false)
 	{
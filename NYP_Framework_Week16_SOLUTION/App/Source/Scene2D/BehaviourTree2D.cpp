@@ -0,0 +1,462 @@
+/**
+ CBehaviourTree2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "BehaviourTree2D.h"
+
+#include <iostream>
+using namespace std;
+
+// Include rapidcsv to load the tree
+#include "System/rapidcsv.h"
+#include "System\filesystem.h"
+
+// An invalid node index
+const int CBehaviourTree2D::NO_NODE;
+
+// The names of the node types in the CSV file, in the order of NODE_TYPE
+static const char* const arrNodeTypeNames[CBehaviourTree2D::NUM_NODE_TYPES] = { "Selector", "Sequence", "Condition", "Action", "Hold" };
+
+/**
+ @brief Constructor
+ */
+CBehaviourTree2D::CBehaviourTree2D(void)
+	: uiNumHolds(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CBehaviourTree2D::~CBehaviourTree2D(void)
+{
+	Clear();
+	vBlackboards.clear();
+	vFreeBlackboards.clear();
+}
+
+/**
+ @brief Load a tree from a CSV file, and compile it into flat arrays of nodes
+ @param filename A const std::string& variable containing the name of the CSV file
+ @param arrConditionNames A const char* const* variable containing the names of the conditions, indexed by their IDs
+ @param uiNumConditions A const unsigned int variable containing the number of conditions
+ @param arrActionNames A const char* const* variable containing the names of the actions, indexed by their IDs
+ @param uiNumActions A const unsigned int variable containing the number of actions
+ @return true if the tree was loaded
+ */
+bool CBehaviourTree2D::Load(const std::string& filename,
+							const char* const* arrConditionNames, const unsigned int uiNumConditions,
+							const char* const* arrActionNames, const unsigned int uiNumActions)
+{
+	Clear();
+
+	try
+	{
+		rapidcsv::Document doc(FileSystem::getPath(filename).c_str());
+
+		// The last node at each depth, which is where the next node at that depth is linked to
+		std::vector<int> vLastNodeAtDepth;
+
+		const unsigned int uiNumRows = (unsigned int)doc.GetRowCount();
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			const int iDepth = doc.GetCell<int>("Depth", uiRow);
+			const std::string sType = doc.GetCell<std::string>("Type", uiRow);
+			const std::string sName = doc.GetCell<std::string>("Name", uiRow);
+			const float fParam = doc.GetCell<float>("Param", uiRow);
+			const int iInvert = doc.GetCell<int>("Invert", uiRow);
+
+			// Find the type of this node
+			unsigned int uiType = 0;
+			while ((uiType < NUM_NODE_TYPES) && (sType != arrNodeTypeNames[uiType]))
+				uiType++;
+			if (uiType == NUM_NODE_TYPES)
+			{
+				throw runtime_error("Unknown node type " + sType + " in row " + to_string(uiRow));
+			}
+
+			// Find the ID of a condition or action
+			unsigned int uiLeafID = 0;
+			if ((uiType == CONDITION) || (uiType == ACTION))
+			{
+				const char* const* arrNames = (uiType == CONDITION) ? arrConditionNames : arrActionNames;
+				const unsigned int uiNumNames = (uiType == CONDITION) ? uiNumConditions : uiNumActions;
+				while ((uiLeafID < uiNumNames) && (sName != arrNames[uiLeafID]))
+					uiLeafID++;
+				if (uiLeafID == uiNumNames)
+				{
+					throw runtime_error("Unknown " + sType + " " + sName + " in row " + to_string(uiRow));
+				}
+			}
+
+			// The first node must be the root, and each node must be a child of a composite node above it,
+			// or the only child of a hold
+			if ((uiRow == 0) != (iDepth == 0) || (iDepth > (int)vLastNodeAtDepth.size()))
+			{
+				throw runtime_error("Invalid depth in row " + to_string(uiRow));
+			}
+			if (iDepth > 0)
+			{
+				const int iParent = vLastNodeAtDepth[iDepth - 1];
+				if ((vNodeType[iParent] == HOLD) ? ((uiType != CONDITION) || (vFirstChild[iParent] != NO_NODE))
+												 : ((vNodeType[iParent] != SELECTOR) && (vNodeType[iParent] != SEQUENCE)))
+				{
+					throw runtime_error("Invalid parent of the node in row " + to_string(uiRow));
+				}
+			}
+
+			// A hold is identified by its index among the holds
+			if (uiType == HOLD)
+			{
+				uiLeafID = uiNumHolds;
+				uiNumHolds++;
+			}
+
+			// Add the node
+			const int iNode = (int)vNodeType.size();
+			vNodeType.push_back((unsigned char)uiType);
+			vLeafID.push_back(uiLeafID);
+			vParam.push_back(fParam);
+			vInvert.push_back(iInvert != 0 ? 1 : 0);
+			vParent.push_back((iDepth > 0) ? vLastNodeAtDepth[iDepth - 1] : NO_NODE);
+			vFirstChild.push_back(NO_NODE);
+			vNextSibling.push_back(NO_NODE);
+
+			// Link the node to its parent, or to its previous sibling
+			vLastNodeAtDepth.resize(iDepth);
+			if (iDepth > 0)
+			{
+				const int iParent = vParent[iNode];
+				if (vFirstChild[iParent] == NO_NODE)
+				{
+					vFirstChild[iParent] = iNode;
+				}
+				else
+				{
+					int iSibling = vFirstChild[iParent];
+					while (vNextSibling[iSibling] != NO_NODE)
+						iSibling = vNextSibling[iSibling];
+					vNextSibling[iSibling] = iNode;
+				}
+			}
+			vLastNodeAtDepth.push_back(iNode);
+		}
+
+		// Each hold must have its condition
+		for (unsigned int i = 0; i < vNodeType.size(); i++)
+		{
+			if ((vNodeType[i] == HOLD) && (vFirstChild[i] == NO_NODE))
+			{
+				throw runtime_error("Hold in row " + to_string(i) + " has no condition");
+			}
+		}
+	}
+	catch (exception& e)
+	{
+		cout << "CBehaviourTree2D::Load: Unable to load " << filename << ": " << e.what() << endl;
+		Clear();
+		return false;
+	}
+
+	if (vNodeType.size() == 0)
+	{
+		cout << "CBehaviourTree2D::Load: " << filename << " has no nodes" << endl;
+		return false;
+	}
+
+	// The running nodes and holds of the agents are no longer valid
+	for (unsigned int i = 0; i < vBlackboards.size(); i++)
+	{
+		vBlackboards[i].iRunningNode = NO_NODE;
+		vBlackboards[i].iLastRunningNode = NO_NODE;
+		vBlackboards[i].vHoldUntil.assign(uiNumHolds, 0.0);
+	}
+	return true;
+}
+
+/**
+ @brief Check if a tree has been loaded
+ */
+bool CBehaviourTree2D::IsLoaded(void) const
+{
+	return (vNodeType.size() > 0);
+}
+
+/**
+ @brief Get the number of nodes
+ */
+unsigned int CBehaviourTree2D::GetNumNodes(void) const
+{
+	return (unsigned int)vNodeType.size();
+}
+
+/**
+ @brief Register an agent and return the handle of its blackboard.
+		The handle of an unregistered agent is reused if there is one.
+ */
+CBehaviourTree2D::HANDLE CBehaviourTree2D::RegisterAgent(void)
+{
+	HANDLE hAgent;
+	if (vFreeBlackboards.size() > 0)
+	{
+		hAgent = vFreeBlackboards.back();
+		vFreeBlackboards.pop_back();
+	}
+	else
+	{
+		hAgent = (HANDLE)vBlackboards.size();
+		vBlackboards.push_back(Blackboard());
+	}
+
+	Blackboard& sBlackboard = vBlackboards[hAgent];
+	sBlackboard.bAlive = true;
+	sBlackboard.bEventPending = false;
+	sBlackboard.iRunningNode = NO_NODE;
+	sBlackboard.iLastRunningNode = NO_NODE;
+	sBlackboard.dRunningTime = 0.0;
+	sBlackboard.dTime = 0.0;
+	sBlackboard.vHoldUntil.assign(uiNumHolds, 0.0);
+	return hAgent;
+}
+
+/**
+ @brief Unregister an agent. Its handle may be reused by the next agent which is registered
+ */
+void CBehaviourTree2D::UnregisterAgent(const HANDLE hAgent)
+{
+	if ((hAgent >= vBlackboards.size()) || (!vBlackboards[hAgent].bAlive))
+	{
+		cout << "CBehaviourTree2D::UnregisterAgent: Invalid handle " << hAgent << endl;
+		return;
+	}
+
+	vBlackboards[hAgent].bAlive = false;
+	vFreeBlackboards.push_back(hAgent);
+}
+
+/**
+ @brief Tick an agent. If it is running an action, and the conditions which guard the action still let it run,
+		then only that action is run. Otherwise, the whole tree is evaluated from the root.
+ @param hAgent A const HANDLE variable containing the handle of the agent's blackboard
+ @param cAgent A CBehaviourAgent2D* variable which is the agent
+ @param dElapsedTime A const double variable containing the time since the agent's last tick
+ */
+CBehaviourTree2D::STATUS CBehaviourTree2D::Tick(const HANDLE hAgent, CBehaviourAgent2D* cAgent, const double dElapsedTime)
+{
+	if (vNodeType.size() == 0)
+		return FAILURE;
+
+	Blackboard& sBlackboard = vBlackboards[hAgent];
+	sBlackboard.iLastRunningNode = sBlackboard.iRunningNode;
+	sBlackboard.iRunningNode = NO_NODE;
+	sBlackboard.dRunningTime += dElapsedTime;
+	sBlackboard.dTime += dElapsedTime;
+
+	const int iLastRunningNode = sBlackboard.iLastRunningNode;
+	if ((iLastRunningNode != NO_NODE) && (!sBlackboard.bEventPending) && (CheckGuards(iLastRunningNode, sBlackboard, cAgent)))
+	{
+		// Only re-evaluate the running branch
+		STATUS sStatus = RunLeaf(iLastRunningNode, sBlackboard, cAgent);
+		if (sStatus == RUNNING)
+			return RUNNING;
+		return Resume(iLastRunningNode, sStatus, sBlackboard, cAgent);
+	}
+
+	// Evaluate the whole tree
+	sBlackboard.bEventPending = false;
+	return Execute(0, sBlackboard, cAgent);
+}
+
+/**
+ @brief Post an event to an agent, so that its whole tree is evaluated on its next tick
+ */
+void CBehaviourTree2D::PostEvent(const HANDLE hAgent)
+{
+	vBlackboards[hAgent].bEventPending = true;
+}
+
+/**
+ @brief Get the node which an agent is running, or NO_NODE
+ */
+int CBehaviourTree2D::GetRunningNode(const HANDLE hAgent) const
+{
+	return vBlackboards[hAgent].iRunningNode;
+}
+
+/**
+ @brief Print out the details about this class instance in the console
+ */
+void CBehaviourTree2D::PrintSelf(void) const
+{
+	cout << endl << "CBehaviourTree2D::PrintSelf()" << endl;
+	cout << "========================" << endl;
+	for (unsigned int i = 0; i < vNodeType.size(); i++)
+	{
+		cout << i << "\t" << arrNodeTypeNames[vNodeType[i]] << "\tID=" << vLeafID[i] << "\tParam=" << vParam[i]
+			<< "\tParent=" << vParent[i] << "\tFirstChild=" << vFirstChild[i] << "\tNextSibling=" << vNextSibling[i] << endl;
+	}
+	cout << "Agents\t=\t" << vBlackboards.size() - vFreeBlackboards.size() << endl;
+}
+
+/**
+ @brief Clear the nodes
+ */
+void CBehaviourTree2D::Clear(void)
+{
+	vNodeType.clear();
+	vLeafID.clear();
+	vParam.clear();
+	vInvert.clear();
+	vParent.clear();
+	vFirstChild.clear();
+	vNextSibling.clear();
+	uiNumHolds = 0;
+}
+
+/**
+ @brief Evaluate a node and its children
+ */
+CBehaviourTree2D::STATUS CBehaviourTree2D::Execute(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent)
+{
+	switch (vNodeType[iNode])
+	{
+	case SELECTOR:
+		for (int iChild = vFirstChild[iNode]; iChild != NO_NODE; iChild = vNextSibling[iChild])
+		{
+			const STATUS sStatus = Execute(iChild, sBlackboard, cAgent);
+			if (sStatus != FAILURE)
+				return sStatus;
+		}
+		return FAILURE;
+	case SEQUENCE:
+		for (int iChild = vFirstChild[iNode]; iChild != NO_NODE; iChild = vNextSibling[iChild])
+		{
+			const STATUS sStatus = Execute(iChild, sBlackboard, cAgent);
+			if (sStatus != SUCCESS)
+				return sStatus;
+		}
+		return SUCCESS;
+	default:
+		return RunLeaf(iNode, sBlackboard, cAgent);
+	}
+}
+
+/**
+ @brief Run a condition, hold or action node. An action which was not running before this tick is started,
+		so its running time starts from 0.
+ */
+CBehaviourTree2D::STATUS CBehaviourTree2D::RunLeaf(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent)
+{
+	if (IsGuard(iNode))
+	{
+		return CheckGuard(iNode, sBlackboard, cAgent) ? SUCCESS : FAILURE;
+	}
+
+	if (iNode != sBlackboard.iLastRunningNode)
+	{
+		sBlackboard.dRunningTime = 0.0;
+		sBlackboard.iLastRunningNode = iNode;
+	}
+
+	const STATUS sStatus = cAgent->RunAction(vLeafID[iNode], vParam[iNode], sBlackboard.dRunningTime);
+	if (sStatus == RUNNING)
+		sBlackboard.iRunningNode = iNode;
+	else
+		sBlackboard.iLastRunningNode = NO_NODE;
+	return sStatus;
+}
+
+/**
+ @brief Continue the parents of a leaf which has finished. Each parent runs the children after the finished one,
+		as it would have if the whole tree was evaluated, until a parent is still running or the root finishes.
+ */
+CBehaviourTree2D::STATUS CBehaviourTree2D::Resume(const int iNode, STATUS sStatus, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent)
+{
+	int iChild = iNode;
+	int iParent = vParent[iNode];
+	while (iParent != NO_NODE)
+	{
+		// The status which makes this parent go on to its next child
+		const STATUS sContinueStatus = (vNodeType[iParent] == SEQUENCE) ? SUCCESS : FAILURE;
+		for (int iSibling = vNextSibling[iChild]; (iSibling != NO_NODE) && (sStatus == sContinueStatus); iSibling = vNextSibling[iSibling])
+		{
+			sStatus = Execute(iSibling, sBlackboard, cAgent);
+		}
+
+		if (sStatus == RUNNING)
+			return RUNNING;
+
+		iChild = iParent;
+		iParent = vParent[iParent];
+	}
+	return sStatus;
+}
+
+/**
+ @brief Check if the conditions which guard a running node still let it run.
+		In a sequence, the conditions before the running branch must still pass.
+		In a selector, a branch before the running branch which is guarded by a condition
+		takes priority if its condition now passes.
+ */
+bool CBehaviourTree2D::CheckGuards(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent)
+{
+	int iChild = iNode;
+	int iParent = vParent[iNode];
+	while (iParent != NO_NODE)
+	{
+		for (int iSibling = vFirstChild[iParent]; iSibling != iChild; iSibling = vNextSibling[iSibling])
+		{
+			if (vNodeType[iParent] == SEQUENCE)
+			{
+				if ((IsGuard(iSibling)) && (CheckGuard(iSibling, sBlackboard, cAgent) == false))
+					return false;
+			}
+			else
+			{
+				if (CheckGuard(iSibling, sBlackboard, cAgent) == true)
+					return false;
+			}
+		}
+		iChild = iParent;
+		iParent = vParent[iParent];
+	}
+	return true;
+}
+
+/**
+ @brief Check if a condition or hold node, or a sequence which starts with one, passes.
+		A hold which passes because of its condition passes until Param seconds after this check.
+		Any other node is not a guard, so it does not pass.
+ */
+bool CBehaviourTree2D::CheckGuard(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent)
+{
+	int iGuard = iNode;
+	if ((vNodeType[iNode] == SEQUENCE) && (vFirstChild[iNode] != NO_NODE))
+		iGuard = vFirstChild[iNode];
+	if (IsGuard(iGuard) == false)
+		return false;
+
+	const int iCondition = (vNodeType[iGuard] == HOLD) ? vFirstChild[iGuard] : iGuard;
+	bool bResult = cAgent->CheckCondition(vLeafID[iCondition], vParam[iCondition]);
+	if (vInvert[iCondition] != 0)
+		bResult = !bResult;
+
+	if (vNodeType[iGuard] == HOLD)
+	{
+		double& dHoldUntil = sBlackboard.vHoldUntil[vLeafID[iGuard]];
+		if (bResult)
+			dHoldUntil = sBlackboard.dTime + vParam[iGuard];
+		else
+			bResult = (sBlackboard.dTime < dHoldUntil);
+	}
+	return bResult;
+}
+
+/**
+ @brief Check if a node is a condition or a hold
+ */
+bool CBehaviourTree2D::IsGuard(const int iNode) const
+{
+	return (vNodeType[iNode] == CONDITION) || (vNodeType[iNode] == HOLD);
+}
@@ -0,0 +1,170 @@
+/**
+ CBehaviourTree2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include vector and string
+#include <vector>
+#include <string>
+
+class CBehaviourAgent2D;
+
+/**
+ CBehaviourTree2D: A behaviour tree which is loaded from a CSV file, and compiled into flat arrays of nodes.
+				   The nodes are stored in depth-first order, so each node's subtree follows it.
+				   Each agent which runs this tree has a blackboard, and the blackboards are stored together.
+				   An agent which is running an action only runs that action on its next tick, after checking
+				   the conditions which guard it. The whole tree is only evaluated again when a guard changes,
+				   the action finishes, or an event is posted to the agent.
+
+				   Each row of the CSV file is a node, with the columns:
+				   Depth	The depth of the node. The root is 0, and it must be the first row
+				   Type		Selector, Sequence, Condition, Action or Hold
+				   Name		The name of the condition or action, which is looked up in the agent's names
+				   Param	A number which is passed to the condition or action, or the time of a Hold in seconds
+				   Invert	1 to invert the result of a condition
+
+				   A Hold is a decorator with a single Condition child. It passes while the condition passes,
+				   and for Param seconds after the condition last passed, so a branch which it guards is not
+				   dropped as soon as the condition fails.
+ */
+class CBehaviourTree2D
+{
+public:
+	// A handle to an agent's blackboard
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+	// An invalid node index
+	static const int NO_NODE = -1;
+
+	// The result of running a node
+	enum STATUS
+	{
+		SUCCESS = 0,
+		FAILURE,
+		RUNNING,
+		NUM_STATUS
+	};
+
+	// The types of nodes
+	enum NODE_TYPE
+	{
+		SELECTOR = 0,	// Runs its children until one does not fail
+		SEQUENCE,		// Runs its children until one does not succeed
+		CONDITION,		// Asks the agent to check a condition
+		ACTION,			// Asks the agent to run an action
+		HOLD,			// Passes while its condition passes, and for a time after it last passed
+		NUM_NODE_TYPES
+	};
+
+	// Constructor
+	CBehaviourTree2D(void);
+
+	// Destructor
+	~CBehaviourTree2D(void);
+
+	// Load a tree from a CSV file. The condition and action names are indexed by their IDs in the agent
+	bool Load(	const std::string& filename,
+				const char* const* arrConditionNames, const unsigned int uiNumConditions,
+				const char* const* arrActionNames, const unsigned int uiNumActions);
+
+	// Check if a tree has been loaded
+	bool IsLoaded(void) const;
+
+	// Get the number of nodes
+	unsigned int GetNumNodes(void) const;
+
+	// Register an agent and return the handle of its blackboard
+	HANDLE RegisterAgent(void);
+	// Unregister an agent. Its handle may be reused by the next agent which is registered
+	void UnregisterAgent(const HANDLE hAgent);
+
+	// Tick an agent with the time since its last tick
+	STATUS Tick(const HANDLE hAgent, CBehaviourAgent2D* cAgent, const double dElapsedTime);
+
+	// Post an event to an agent, so that its whole tree is evaluated on its next tick
+	void PostEvent(const HANDLE hAgent);
+
+	// Get the node which an agent is running, or NO_NODE
+	int GetRunningNode(const HANDLE hAgent) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The blackboard of an agent
+	struct Blackboard
+	{
+		// Boolean flag to indicate if this blackboard is used by an agent
+		bool bAlive;
+		// Boolean flag to indicate if an event was posted since the last tick
+		bool bEventPending;
+		// The action which is running, and the action which was running before this tick
+		int iRunningNode;
+		int iLastRunningNode;
+		// The time since the running action started
+		double dRunningTime;
+		// The time since this agent was registered
+		double dTime;
+		// The time until which each hold passes, indexed by the holds' IDs
+		std::vector<double> vHoldUntil;
+	};
+
+	// The nodes, in depth-first order. The leaf ID of a hold is its index among the holds
+	std::vector<unsigned char> vNodeType;
+	std::vector<unsigned int> vLeafID;
+	std::vector<float> vParam;
+	std::vector<unsigned char> vInvert;
+	std::vector<int> vParent;
+	std::vector<int> vFirstChild;
+	std::vector<int> vNextSibling;
+
+	// The blackboards, indexed by the agents' handles
+	std::vector<Blackboard> vBlackboards;
+	// The handles of unregistered agents, which can be reused
+	std::vector<HANDLE> vFreeBlackboards;
+
+	// The number of holds in the tree
+	unsigned int uiNumHolds;
+
+	// Clear the nodes
+	void Clear(void);
+
+	// Evaluate a node and its children
+	STATUS Execute(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent);
+
+	// Run a condition or action node
+	STATUS RunLeaf(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent);
+
+	// Continue the parents of a leaf which has finished, from the leaf's next sibling
+	STATUS Resume(const int iNode, STATUS sStatus, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent);
+
+	// Check if the conditions which guard a running node still let it run
+	bool CheckGuards(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent);
+
+	// Check if a condition or hold node, or a sequence which starts with one, passes
+	bool CheckGuard(const int iNode, Blackboard& sBlackboard, CBehaviourAgent2D* cAgent);
+
+	// Check if a node is a condition or a hold
+	bool IsGuard(const int iNode) const;
+};
+
+/**
+ CBehaviourAgent2D: An agent which runs a CBehaviourTree2D.
+					The conditions and actions are identified by the IDs which were given to Load.
+ */
+class CBehaviourAgent2D
+{
+public:
+	// Destructor
+	virtual ~CBehaviourAgent2D(void) {}
+
+	// Check a condition
+	virtual bool CheckCondition(const unsigned int uiConditionID, const float fParam) = 0;
+
+	// Run an action. dRunningTime is the time since this action started
+	virtual CBehaviourTree2D::STATUS RunAction(const unsigned int uiActionID, const float fParam, const double dRunningTime) = 0;
+};
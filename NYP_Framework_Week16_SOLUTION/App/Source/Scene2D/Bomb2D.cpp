@@ -10,9 +10,13 @@ using namespace std;
 
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include SpriteBatch2D
+#include "RenderControl\SpriteBatch2D.h"
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
@@ -21,15 +25,50 @@ using namespace std;
 // Include Game Manager
 #include "GameManager.h"
 
+// Include ComponentStore2D
+#include "ComponentStore2D.h"
+
+// Include CommandBuffer2D
+#include "CommandBuffer2D.h"
+
+// Include KinematicSolver2D
+#include "KinematicSolver2D.h"
+
+// Include GravityKernel2D
+#include "GravityKernel2D.h"
+
+// Include ParticleSystem2D
+#include "ParticleSystem2D.h"
+
+// Include TileLighting2D
+#include "TileLighting2D.h"
+
+// The VAO, texture and sprite animation which are shared by all bombs
+GLuint CBomb2D::uiSharedVAO = 0;
+GLuint CBomb2D::uiSharedTextureID = 0;
+CSpriteAnimation* CBomb2D::cSharedSprite = NULL;
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CBomb2D::CBomb2D(void)
 	: cMap2D(NULL)
 	, cSoundController(NULL)
+	, type(ENEMY_GOLEM)
+	, enemySpeed(3.f)
 {
 	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
 
+	// Get the handlers to the singletons here, so that spawning a pooled bomb does not need to
+	cSettings = CSettings::GetInstance();
+	cMap2D = CMap2D::GetInstance();
+	cSoundController = CSoundController::GetInstance();
+
+	sShaderName = "2DColorShader";
+
+	// The bomb's body is integrated by CPhysicsWorld2D::Step together with the other bombs
+	cPhysics2D.SetSteppedByWorld(true);
+
 	// Initialise vecIndex
 	i32vec2Index = glm::i32vec2(0);
 
@@ -53,51 +92,77 @@ CBomb2D::~CBomb2D(void)
 	// We won't delete this since it was created elsewhere
 	cMap2D = NULL;
 
-	// optional: de-allocate all resources once they've outlived their purpose:
-	glDeleteVertexArrays(1, &VAO);
+	// The VAO, texture and sprite animation are shared, so they are deleted in DestroySharedResources
+}
+
+/**
+ @brief Initialise the VAO, texture and sprite animation which are shared by all bombs.
+		This must be called once after the OpenGL context is created, before any bomb is spawned.
+ */
+bool CBomb2D::InitSharedResources(void)
+{
+	if (cSharedSprite)
+		return true;
+
+	CSettings* cSettings = CSettings::GetInstance();
+
+	glGenVertexArrays(1, &uiSharedVAO);
+	CGLStateCache::GetInstance()->BindVertexArray(uiSharedVAO);
+
+	if (LoadTexture("Image/scene2d_bomb.tga", uiSharedTextureID) == false)
+	{
+		std::cout << "Failed to load bomb texture" << std::endl;
+		return false;
+	}
+
+	//CS: Create the animated sprite and setup the animation 
+	cSharedSprite = CMeshBuilder::GenerateSpriteAnimation(1, 1, cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
+	cSharedSprite->AddAnimation("idle", 0, 1);
+	cSharedSprite->PlayAnimation("idle", -1, 3.f);
+
+	return true;
 }
 
 /**
-  @brief Initialise this instance
+ @brief Destroy the VAO, texture and sprite animation which are shared by all bombs
+ */
+void CBomb2D::DestroySharedResources(void)
+{
+	if (cSharedSprite)
+	{
+		delete cSharedSprite;
+		cSharedSprite = NULL;
+	}
+	if (uiSharedTextureID != 0)
+	{
+		// The texture cache deletes the texture when it is evicted, which is never in the middle of a frame
+		CTextureCache::GetInstance()->Release(uiSharedTextureID);
+		uiSharedTextureID = 0;
+	}
+	if (uiSharedVAO != 0)
+	{
+		CGLStateCache::GetInstance()->DeleteVertexArrays(1, &uiSharedVAO);
+		uiSharedVAO = 0;
+	}
+}
+
+/**
+  @brief Initialise this instance. This only resets the per-instance state, 
+		 so that a pooled bomb can be spawned without any heap or OpenGL allocations.
   */
 bool CBomb2D::Init(CPhysics2D::GRAVITY_DIRECTION dir, int x, int y)
 {
 	cPhysics2D.SetGravityDirection(dir);
 	cPhysics2D.setGravityMagnitude(7.5f);
 	cPhysics2D.SetInitialVelocity(glm::vec2(0.f, -10.f));
-	this->type = type;
-	this->enemySpeed = 3.f;
-	// Get the handler to the CSettings instance
-	cSettings = CSettings::GetInstance();
 
-	// Get the handler to the CMap2D instance
-	cMap2D = CMap2D::GetInstance();
-	// Find the indices for the player in arrMapInfo, and assign it to CBomb2D
-
-	// Set the start position of the Player to iRow and iCol
+	// Set the start position of the bomb to iRow and iCol
 	i32vec2Index.x = x;
 	i32vec2Index.y = y;
 	i32vec2OldIndex = i32vec2Index;
 	// By default, microsteps should be zero
 	i32vec2NumMicroSteps = glm::i32vec2(0, 0);
 
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	
-
-	if (LoadTexture("Image/scene2d_bomb.tga", iTextureID) == false)
-	{
-		std::cout << "Failed to bomb texture texture" << std::endl;
-	}
-	//CS: Create the animated sprite and setup the animation 
-	animatedSprites = CMeshBuilder::GenerateSpriteAnimation(1, 1, cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
-	animatedSprites->AddAnimation("idle", 0, 1);
-	animatedSprites->PlayAnimation("idle", -1, enemySpeed);
-
-
-	
-
-
 	//CS: Init the color to white
 	currentColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
 
@@ -105,411 +170,153 @@ bool CBomb2D::Init(CPhysics2D::GRAVITY_DIRECTION dir, int x, int y)
 	cPhysics2D.Init();
 	cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
 
-	// Get the handler to the CSoundController
-	cSoundController = CSoundController::GetInstance();
-
 	return true;
 }
 
 
 
 /**
- @brief Update this instance
+ @brief Update the fall for a gravity direction.
+		The axis and sign of the movement are constants in each instance of this template.
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
  */
-void CBomb2D::Update(const double dElapsedTime)
+template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+void CBomb2D::UpdateFallKernel(const double dElapsedTime)
 {
-	
-	if (cPhysics2D.GetStatus() == CPhysics2D::STATUS::FALL)
-	{
-		// Update the elapsed time to the physics engine
-		cPhysics2D.AddElapsedTime((float)dElapsedTime);
-		// Call the physics engine update method to calculate the final velocity and displacement
-		cPhysics2D.Update();
-		// Get the displacement from the physics engine
-		glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
+	typedef CGravityKernel2D<eGravityDirection> KERNEL;
 
+	// The physics world has already integrated this bomb's body for this frame.
+	// Get the displacement from the physics engine
+	glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
 
-		if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_DOWN)
-		{
-			// Store the current i32vec2Index.y
-			int iIndex_YAxis_OLD = i32vec2Index.y;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.y / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.y * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
-			if (iDisplacement_MicroSteps > 0)
-			{
-				iDisplacement++;
-			}
-
-			// Update the indices
-			i32vec2Index.y += iDisplacement;
-			i32vec2NumMicroSteps.y = 0;
-
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).y;
-
-			// Constraint the player's position within the screen boundary
-			Constraint(CPhysics2D::DIRECTION::DOWN);
-
-
-			// Iterate through all rows until the proposed row
-			// Check if the player will hit a tile; stop fall if so.
-			int iIndex_YAxis_Proposed = i32vec2Index.y;
-
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP)
-			{
-				//if I = 22, I < 24, i++ (WIll fall backwards, towards UP GRAVITY
-				for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					InteractWithMap();
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					InteractWithMap();
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-						break;
-					}
-				}
-			}
-		}
-		else if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_LEFT || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
-		{
-			// Store the current i32vec2Index.x
-			int iIndex_XAxis_OLD = i32vec2Index.x;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.x / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.x * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_XAXIS;
-			if (iDisplacement_MicroSteps > 0)
-			{
-				iDisplacement++;
-			}
-
-			// Update the indices
-			i32vec2Index.x += iDisplacement;
-			i32vec2NumMicroSteps.x = 0;
-
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).x;
-
-			// Constraint the plaxer's position within the screen boundarx
-			Constraint(CPhysics2D::DIRECTION::DOWN);
-
-
-			// Iterate through all rows until the proposed row
-			// Check if the plaxer will hit a tile; stop fall if so.
-			int iIndex_XAxis_Proposed = i32vec2Index.x;
-
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
-			{
-				//if I = 22, I < 24, i++ (WIll fall backwards, towards UP GRAVITX
-				for (int i = iIndex_XAxis_OLD; i <= iIndex_XAxis_Proposed; i++)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-					// If the new position is not feasible, then revert to old position
-					InteractWithMap();
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_XAxis_OLD; i >= iIndex_XAxis_Proposed; i--)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-					// If the new position is not feasible, then revert to old position
-					InteractWithMap();
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-						break;
-					}
-				}
-			}
-		}
-	}
+	// Store the current index
+	glm::i32vec2 i32vec2StartIndex = i32vec2Index;
 
+	// Translate the displacement from pixels to indices
+	int iDisplacement = KERNEL::DisplacementToTiles(v2Displacement,
+													cSettings->TILE_HEIGHT,
+													(float)cSettings->iWindowHeight,
+													KERNEL::GetNumStepsPerTile(cSettings->NUM_STEPS_PER_TILE_XAXIS, cSettings->NUM_STEPS_PER_TILE_YAXIS),
+													false);
 
-	// Update the Health and Lives
-	UpdateHealthLives();
+	// Update the indices
+	i32vec2Index[KERNEL::AXIS] += iDisplacement;
+	i32vec2NumMicroSteps[KERNEL::AXIS] = 0;
 
-	//CS: Update the animated sprite
-	animatedSprites->Update(dElapsedTime);
-
-	// Update the UV Coordinates
-	vec2UVCoordinate.x = cSettings->ConvertIndexToUVSpace(cSettings->x, i32vec2Index.x, false, i32vec2NumMicroSteps.x*cSettings->MICRO_STEP_XAXIS);
-	vec2UVCoordinate.y = cSettings->ConvertIndexToUVSpace(cSettings->y, i32vec2Index.y, false, i32vec2NumMicroSteps.y*cSettings->MICRO_STEP_YAXIS);
-}
-
-void CBomb2D::CollidedWith(CEntity2D* entity)
-{
-
-}
-
-void CBomb2D::Constraint(CPhysics2D::DIRECTION eDirection)
-{
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(eDirection);
-	if (relativeDir.x == -1)
-	{
-		if (i32vec2Index.x <= 0)
-		{
-			i32vec2Index.x = 0;
-			i32vec2NumMicroSteps.x = 0;
-			dead = true;
-		}
-	}
-	else if (relativeDir.x == 1)
+	// Constraint the bomb's position within the screen boundary. A bomb which falls out of the map is dead.
+	if (CKinematicSolver2D::Constraint(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, KERNEL::GetDownVector()))
 	{
-		if (i32vec2Index.x >= (int)cSettings->NUM_TILES_XAXIS - 1)
-		{
-			i32vec2Index.x = ((int)cSettings->NUM_TILES_XAXIS) - 1;
-			i32vec2NumMicroSteps.x = 0;
-			dead = true;
-		}
-	}
-	else if (relativeDir.y == 1)
-	{
-		if (i32vec2Index.y >= (int)cSettings->NUM_TILES_YAXIS - 1)
-		{
-			i32vec2Index.y = ((int)cSettings->NUM_TILES_YAXIS) - 1;
-			i32vec2NumMicroSteps.y = 0;
-			dead = true;
-		}
-	}
-	else if (relativeDir.y == -1)
-	{
-		if (i32vec2Index.y <= 0)
-		{
-			i32vec2Index.y = 0;
-			i32vec2NumMicroSteps.y = 0;
-			dead = true;
-		}
+		dead = true;
 	}
-	else
+
+	// Sweep the bomb from its current tile to the proposed tile in one traversal, 
+	// so that a fast falling bomb cannot pass through a block which is 1 tile thick
+	SweepResult sResult;
+	if (cMap2D->SweepAABB(	glm::vec2(i32vec2StartIndex),
+							glm::vec2(1.0f),
+							glm::vec2(i32vec2Index - i32vec2StartIndex),
+							sResult))
 	{
-		cout << "CPlayer2D::Constraint: Unknown direction." << endl;
+		// Stop inside the tile which blocked the bomb, and destroy the tile if the bomb can
+		i32vec2Index = sResult.i32vec2HitTile;
+		InteractWithMap();
+		cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
 	}
+
+	// A dead bomb stops falling, so that the physics world does not step it any more
+	if (dead)
+		cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
 }
 
 /**
- @brief Check if a position is possible to move into
- @param eDirection A DIRECTION enumerated data type which indicates the direction to check
+ @brief Update this instance
  */
-bool CBomb2D::CheckPosition(CPhysics2D::DIRECTION eDirection)
+void CBomb2D::Update(const double dElapsedTime)
 {
+	// The fall updates for each gravity direction, in the order of CPhysics2D::GRAVITY_DIRECTION
+	typedef void (CBomb2D::*FALL_KERNEL)(const double dElapsedTime);
+	static const FALL_KERNEL arrFallKernels[CPhysics2D::GRAVITY_COUNT] = {
+		&CBomb2D::UpdateFallKernel<CPhysics2D::GRAVITY_DOWN>,
+		&CBomb2D::UpdateFallKernel<CPhysics2D::GRAVITY_UP>,
+		&CBomb2D::UpdateFallKernel<CPhysics2D::GRAVITY_RIGHT>,
+		&CBomb2D::UpdateFallKernel<CPhysics2D::GRAVITY_LEFT>
+	};
 
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(eDirection);
-	if (relativeDir.x == -1)
+	if (cPhysics2D.GetStatus() == CPhysics2D::STATUS::FALL)
 	{
-
-		if (i32vec2Index.x < 0)
-		{
-			i32vec2NumMicroSteps.x = 0;
-			return false;
-		}
-
-		// If the new position is between 2 rows, then check both rows as well
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x) >= 100))
-		{
-			return false;
-		}
-
+		(this->*arrFallKernels[cPhysics2D.GetGravityDirection()])(dElapsedTime);
 	}
-	else if (relativeDir.x == 1)
-	{
-
-		if (i32vec2Index.x >= cSettings->NUM_TILES_XAXIS)
-		{
-			i32vec2NumMicroSteps.x = 0;
-			return false;
-		}
 
-		// If the new position is between 2 rows, then check both rows as well
-		//// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
-
-
-
-	}
-	else if (relativeDir.y == 1)
-	{
-
-		if (i32vec2Index.y >= cSettings->NUM_TILES_YAXIS)
-		{
-			i32vec2NumMicroSteps.y = 0;
-			return false;
-		}
-
-
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
+	// Update the Health and Lives
+	UpdateHealthLives();
 
-	}
-	else if (relativeDir.y == -1)
-	{
+	// The shared sprite animation has a single frame, so it does not need to be updated per bomb
 
-		if (i32vec2Index.y < 0)
-		{
-			i32vec2NumMicroSteps.y = 0;
-			return false;
-		}
+	// Update the components. The UV coordinates are updated by CComponentStore2D::UpdateTransforms
+	CComponentStore2D* cComponentStore2D = CComponentStore2D::GetInstance();
+	cComponentStore2D->SetPhysics(uiComponentHandle, cPhysics2D.GetFinalVelocity(), (unsigned char)cPhysics2D.GetStatus());
+	cComponentStore2D->SetSprite(uiComponentHandle, uiSharedTextureID, currentColor);
+}
 
-		//// If the new position is between 2 columns, then check both columns as well
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
+void CBomb2D::CollidedWith(CEntity2D* entity)
+{
 
-	}
-	else
-	{
-		cout << "CBomb2D::CheckPosition: Unknown direction." << endl;
-	}
+}
 
+/**
+ @brief Check if this bomb can be updated on a worker thread.
+		A bomb only reads the map, and records its changes to the map and sounds into the command buffer.
+ */
+bool CBomb2D::IsParallelSafe(void) const
+{
 	return true;
 }
 
-
-bool CBomb2D::PlayerIsOnBottomRow() {
-	switch (cPhysics2D.GetGravityDirection())
-	{
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN:
-		if (i32vec2Index.y == 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP:
-		if (i32vec2Index.y == cSettings->NUM_TILES_YAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT:
-		if (i32vec2Index.x == 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT:
-		if (i32vec2Index.x == cSettings->NUM_TILES_XAXIS - 1)
-			return true;
-		break;
-	}
-	return false;
+/**
+ @brief Check if this bomb is at rest and can be put to sleep
+ */
+bool CBomb2D::IsAtRest(void) const
+{
+	return (!dead && cPhysics2D.GetStatus() == CPhysics2D::STATUS::IDLE);
 }
 
-bool CBomb2D::PlayerIsOnTopRow() {
-	switch (cPhysics2D.GetGravityDirection())
-	{
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN:
-		if (i32vec2Index.y == cSettings->NUM_TILES_YAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP:
-		if (i32vec2Index.y == 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT:
-		if (i32vec2Index.x == cSettings->NUM_TILES_XAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT:
-		if (i32vec2Index.x == 0)
-			return true;
-		break;
-	}
-	return false;
+/**
+ @brief Get the tile index which this bomb is resting on.
+		The sweep in Update stops the bomb inside the tile which blocked it, so that is the tile it rests on.
+ */
+glm::i32vec2 CBomb2D::GetRestingTile(void) const
+{
+	return i32vec2Index;
 }
 
-// Check if the player is in mid-air
-bool CBomb2D::IsMidAir(void)
+/**
+ @brief Wake this bomb up and let it fall again. It will stop again if it is still supported.
+ */
+void CBomb2D::Wake(void)
 {
-	// if the player is at the bottom row, then he is not in mid-air for sure
-	if (PlayerIsOnBottomRow()) return false;
-
-
-	// Check if the tile below the player's current position is empty
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::DOWN);
-
-	if ((i32vec2NumMicroSteps.x == 0 || i32vec2NumMicroSteps.y == 0) &&
-		(cMap2D->GetMapInfo(i32vec2Index.y + relativeDir.y, i32vec2Index.x + relativeDir.x) == 0))
-	{
-		return true;
-	}
-
-	return false;
+	CEntity2D::Wake();
+	cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
 }
 
 /**
- @brief Set up the OpenGL display environment before rendering
+ @brief Set up the OpenGL display environment before rendering.
+		The sprite batch sets it up when it draws the bombs.
  */
 void CBomb2D::PreRender(void)
 {
-	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
-
-	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	// Activate the shader
-	CShaderManager::GetInstance()->Use(sShaderName);
 }
 
 /**
- @brief Render this instance
+ @brief Render this instance, by adding it to the sprite batch, which draws all the bombs with one draw call
  */
 void CBomb2D::Render(void)
 {
-	glBindVertexArray(VAO);
-	// get matrix's uniform location and set matrix
-	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
-	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "runtime_color");
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-
-	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	transform = glm::translate(transform, glm::vec3(vec2UVCoordinate.x,
-													vec2UVCoordinate.y,
-													0.0f));
-	// Update the shaders with the latest transform
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-	glUniform4fv(colorLoc, 1, glm::value_ptr(currentColor));
-
-	// Get the texture to be rendered
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
-
-	//CS: Render the animated sprite
-	animatedSprites->Render();
-
-	glBindVertexArray(0);
-
+	CSpriteBatch2D::GetInstance()->Draw(CShaderManager::GetInstance()->Get(sShaderName),
+										uiSharedTextureID,
+										GetRenderUVCoordinate(),
+										glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT),
+										cSharedSprite->GetFrameUVRect(),
+										currentColor);
 }
 
 /**
@@ -517,50 +324,21 @@ void CBomb2D::Render(void)
  */
 void CBomb2D::PostRender(void)
 {
-	// Disable blending
-	glDisable(GL_BLEND);
 }
 
 /**
-@brief Load a texture, assign it a code and store it in MapOfTextureIDs.
+@brief Load a texture from the texture cache, which only loads the file once for all the users of the texture.
 @param filename A const char* variable which contains the file name of the texture
+@param iTextureID A GLuint& variable which is set to the texture ID. The texture which it had before is released
 */
 bool CBomb2D::LoadTexture(const char* filename, GLuint& iTextureID)
 {
-	// Variables used in loading the texture
-	int width, height, nrChannels;
-	
-	// texture 1
-	// ---------
-	glGenTextures(1, &iTextureID);
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
-	// set the texture wrapping parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// set texture filtering parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-	unsigned char *data = cImageLoader->Load(filename, width, height, nrChannels, true);
-	if (data)
-	{
-		if (nrChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (nrChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	CTextureCache* cTextureCache = CTextureCache::GetInstance();
+	if (iTextureID != 0)
+		cTextureCache->Release(iTextureID);
 
-		// Generate mipmaps
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		return false;
-	}
-	// Free up the memory of the file data read in
-	free(data);
-
-	return true;
+	iTextureID = cTextureCache->Acquire(filename, true, GL_REPEAT, GL_LINEAR, true);
+	return iTextureID != 0;
 }
 
 /**
@@ -574,8 +352,25 @@ void CBomb2D::InteractWithMap(void)
 
 	if (id > CMap2D::TILE_ID::INTERACTABLES_END && id < CMap2D::TILE_ID::BLOCK_END)
 	{
-		cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
-		cSoundController->PlaySoundByID(SOUND_TYPE::BOMB_EXPLOSION);
+		// The explosion's particles
+		const int iExplosionEmitterID = CParticleSystem2D::GetInstance()->GetEmitterID("Explosion");
+
+		// Record the changes if this bomb is being updated on a worker thread
+		CCommandBuffer2D* cCommandBuffer2D = CCommandBuffer2D::GetCurrent();
+		if (cCommandBuffer2D)
+		{
+			cCommandBuffer2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+			cCommandBuffer2D->PlaySound(SOUND_TYPE::BOMB_EXPLOSION);
+			cCommandBuffer2D->EmitParticles(iExplosionEmitterID, i32vec2Index.x, i32vec2Index.y);
+			cCommandBuffer2D->AddLightFlash(i32vec2Index.x, i32vec2Index.y, CTileLighting2D::MAX_LIGHT);
+		}
+		else
+		{
+			cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+			cSoundController->PlaySoundByID(SOUND_TYPE::BOMB_EXPLOSION);
+			CParticleSystem2D::GetInstance()->Emit(iExplosionEmitterID, glm::vec2(i32vec2Index.x, i32vec2Index.y));
+			CTileLighting2D::GetInstance()->AddFlash(i32vec2Index.x, i32vec2Index.y, CTileLighting2D::MAX_LIGHT);
+		}
 		dead = true;
 		
 		// Explosion sound
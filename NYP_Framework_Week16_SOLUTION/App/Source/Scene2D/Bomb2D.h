@@ -50,7 +50,13 @@ public:
 		ENEMY_COUNT
 	};
 
-	// Init
+	// Initialise the resources which are shared by all bombs
+	static bool InitSharedResources(void);
+
+	// Destroy the resources which are shared by all bombs
+	static void DestroySharedResources(void);
+
+	// Init. Resets the per-instance state so that a pooled bomb can be spawned again. The pool resets the CEntity2D state
 	bool Init(CPhysics2D::GRAVITY_DIRECTION dir, int x, int y);
 
 	// Update
@@ -65,6 +71,18 @@ public:
 	// PostRender
 	void PostRender(void);
 
+	// Check if this bomb can be updated on a worker thread
+	bool IsParallelSafe(void) const;
+
+	// Check if this bomb is at rest and can be put to sleep
+	bool IsAtRest(void) const;
+
+	// Get the tile index which this bomb is resting on
+	glm::i32vec2 GetRestingTile(void) const;
+
+	// Wake this bomb up and let it fall again
+	void Wake(void);
+
 	// Constructor
 	CBomb2D(void);
 
@@ -72,6 +90,10 @@ public:
 	virtual ~CBomb2D(void);
 
 protected:
+	// The VAO, texture and sprite animation which are shared by all bombs
+	static GLuint uiSharedVAO;
+	static GLuint uiSharedTextureID;
+	static CSpriteAnimation* cSharedSprite;
 
 	glm::i32vec2 i32vec2OldIndex;
 	glm::i32vec2 i32vec2OldMicroIndex;
@@ -85,9 +107,6 @@ protected:
 	// Physics
 	CPhysics2D cPhysics2D;
 
-	//CS: Animated Sprite
-	CSpriteAnimation* animatedSprites;
-
 	// Current color
 	glm::vec4 currentColor;
 
@@ -98,26 +117,15 @@ protected:
 	void InteractWithMap(void);
 
 	// Load a texture
-	bool LoadTexture(const char* filename, GLuint& iTextureID);
+	static bool LoadTexture(const char* filename, GLuint& iTextureID);
 
 	// Update the health and lives
 	void UpdateHealthLives(void);
 
-	// Constraint the player's position within a boundary
-	void Constraint(CPhysics2D::DIRECTION eDirection = CPhysics2D::DIRECTION::LEFT);
-
-	// Check if a position is possible to move into
-	bool CheckPosition(CPhysics2D::DIRECTION eDirection);
+	// Update the fall for a gravity direction
+	template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+	void UpdateFallKernel(const double dElapsedTime);
 
 	void CollidedWith(CEntity2D* entity);
-
-	// Check if Player is at Top Row based on Gravity Dir
-	bool PlayerIsOnTopRow();
-
-	// Check if Player is on Bottom Row based on Gravity Dir
-	bool PlayerIsOnBottomRow();
-
-	// Check if the player is in mid-air
-	bool IsMidAir(void);
 };
 
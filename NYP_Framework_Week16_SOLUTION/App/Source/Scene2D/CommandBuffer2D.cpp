@@ -0,0 +1,137 @@
+/**
+ CCommandBuffer2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "CommandBuffer2D.h"
+
+// The command buffer bound to each thread
+thread_local CCommandBuffer2D* CCommandBuffer2D::cCurrent = NULL;
+
+/**
+ @brief Constructor
+ */
+CCommandBuffer2D::CCommandBuffer2D(void)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CCommandBuffer2D::~CCommandBuffer2D(void)
+{
+}
+
+/**
+ @brief Reserve space for a number of commands, so that recording will not allocate during the game
+ */
+void CCommandBuffer2D::Reserve(const unsigned int uiNumCommands)
+{
+	vCommands.reserve(uiNumCommands);
+}
+
+/**
+ @brief Record a CMap2D::SetMapInfo
+ */
+void CCommandBuffer2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const int iValue)
+{
+	Command sCommand = { SET_MAP_INFO, { (int)uiRow, (int)uiCol, iValue }, NULL };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record a CSoundController::PlaySoundByID
+ */
+void CCommandBuffer2D::PlaySound(const int iSoundID)
+{
+	Command sCommand = { PLAY_SOUND, { iSoundID, 0, 0 }, NULL };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record adding to an inventory item
+ */
+void CCommandBuffer2D::AddInventoryItem(const char* pcName, const int iNumItems)
+{
+	Command sCommand = { ADD_INVENTORY_ITEM, { iNumItems, 0, 0 }, pcName };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record removing from an inventory item
+ */
+void CCommandBuffer2D::RemoveInventoryItem(const char* pcName, const int iNumItems)
+{
+	Command sCommand = { REMOVE_INVENTORY_ITEM, { iNumItems, 0, 0 }, pcName };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record spawning a bomb through CEntityManager2D::SpawnBomb
+ */
+void CCommandBuffer2D::SpawnBomb(CPhysics2D::GRAVITY_DIRECTION eGravityDirection, const int iIndex_XAxis, const int iIndex_YAxis)
+{
+	Command sCommand = { SPAWN_BOMB, { (int)eGravityDirection, iIndex_XAxis, iIndex_YAxis }, NULL };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record emitting particles through CParticleSystem2D::Emit, at the centre of a tile
+ */
+void CCommandBuffer2D::EmitParticles(const int iEmitterID, const int iIndex_XAxis, const int iIndex_YAxis)
+{
+	Command sCommand = { EMIT_PARTICLES, { iEmitterID, iIndex_XAxis, iIndex_YAxis }, NULL };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Record adding a flash of light through CTileLighting2D::AddFlash, at a tile
+ */
+void CCommandBuffer2D::AddLightFlash(const int iIndex_XAxis, const int iIndex_YAxis, const int iLevel)
+{
+	Command sCommand = { ADD_LIGHT_FLASH, { iIndex_XAxis, iIndex_YAxis, iLevel }, NULL };
+	vCommands.push_back(sCommand);
+}
+
+/**
+ @brief Apply the recorded commands in the order that they were recorded, then clear them
+ @param fnApply A const APPLY_FUNCTION& variable containing the function which applies a command
+ */
+void CCommandBuffer2D::Commit(const APPLY_FUNCTION& fnApply)
+{
+	for (unsigned int i = 0; i < vCommands.size(); i++)
+		fnApply(vCommands[i]);
+	vCommands.clear();
+}
+
+/**
+ @brief Remove all the recorded commands
+ */
+void CCommandBuffer2D::Clear(void)
+{
+	vCommands.clear();
+}
+
+/**
+ @brief Get the number of recorded commands
+ */
+unsigned int CCommandBuffer2D::GetNumCommands(void) const
+{
+	return (unsigned int)vCommands.size();
+}
+
+/**
+ @brief Bind a command buffer to the calling thread. Set to NULL to apply changes immediately
+ */
+void CCommandBuffer2D::SetCurrent(CCommandBuffer2D* cCommandBuffer2D)
+{
+	cCurrent = cCommandBuffer2D;
+}
+
+/**
+ @brief Get the command buffer bound to the calling thread
+ */
+CCommandBuffer2D* CCommandBuffer2D::GetCurrent(void)
+{
+	return cCurrent;
+}
@@ -0,0 +1,107 @@
+/**
+ CCommandBuffer2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include Physics2D
+#include "Physics2D.h"
+
+// Include vector and function
+#include <vector>
+#include <functional>
+
+/**
+ CCommandBuffer2D: Records the changes which an entity makes to shared state while it is updated
+				   on a worker thread, so that they can be applied later on the main thread.
+				   Each worker thread has its own command buffer. The worker which is updating an entity
+				   binds its buffer with SetCurrent, and the entity records into GetCurrent.
+				   When no buffer is bound, the entity should apply its changes immediately.
+
+				   The commands are applied by the function which is given to Commit, so that the buffer
+				   does not depend on the systems which the commands change.
+ */
+class CCommandBuffer2D
+{
+public:
+	// The types of commands
+	enum COMMAND_TYPE
+	{
+		SET_MAP_INFO = 0,
+		PLAY_SOUND,
+		ADD_INVENTORY_ITEM,
+		REMOVE_INVENTORY_ITEM,
+		SPAWN_BOMB,
+		EMIT_PARTICLES,
+		ADD_LIGHT_FLASH,
+		NUM_COMMAND_TYPES
+	};
+
+	// A recorded command. The meaning of the arguments depends on the type of command
+	struct Command
+	{
+		COMMAND_TYPE eType;
+		int iArguments[3];
+		// The name of the inventory item. This must be a string literal
+		const char* pcName;
+	};
+
+	// The function which applies a command to the system which it changes
+	typedef std::function<void(const Command&)> APPLY_FUNCTION;
+
+	// Constructor
+	CCommandBuffer2D(void);
+
+	// Destructor
+	virtual ~CCommandBuffer2D(void);
+
+	// Reserve space for a number of commands
+	void Reserve(const unsigned int uiNumCommands);
+
+	// Record a CMap2D::SetMapInfo
+	void SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const int iValue);
+
+	// Record a CSoundController::PlaySoundByID
+	void PlaySound(const int iSoundID);
+
+	// Record adding to an inventory item
+	void AddInventoryItem(const char* pcName, const int iNumItems);
+
+	// Record removing from an inventory item
+	void RemoveInventoryItem(const char* pcName, const int iNumItems);
+
+	// Record spawning a bomb through CEntityManager2D::SpawnBomb
+	void SpawnBomb(CPhysics2D::GRAVITY_DIRECTION eGravityDirection, const int iIndex_XAxis, const int iIndex_YAxis);
+
+	// Record emitting particles through CParticleSystem2D::Emit, at the centre of a tile
+	void EmitParticles(const int iEmitterID, const int iIndex_XAxis, const int iIndex_YAxis);
+
+	// Record adding a flash of light through CTileLighting2D::AddFlash, at a tile
+	void AddLightFlash(const int iIndex_XAxis, const int iIndex_YAxis, const int iLevel);
+
+	// Apply the recorded commands in the order that they were recorded, then clear them
+	void Commit(const APPLY_FUNCTION& fnApply);
+
+	// Remove all the recorded commands
+	void Clear(void);
+
+	// Get the number of recorded commands
+	unsigned int GetNumCommands(void) const;
+
+	// Bind a command buffer to the calling thread. Set to NULL to apply changes immediately
+	static void SetCurrent(CCommandBuffer2D* cCommandBuffer2D);
+
+	// Get the command buffer bound to the calling thread
+	static CCommandBuffer2D* GetCurrent(void);
+
+protected:
+	// The recorded commands
+	std::vector<Command> vCommands;
+
+	// The command buffer bound to each thread
+	static thread_local CCommandBuffer2D* cCurrent;
+};
@@ -0,0 +1,341 @@
+/**
+ CComponentStore2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "ComponentStore2D.h"
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CComponentStore2D::CComponentStore2D(void)
+	: cSettings(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CComponentStore2D::~CComponentStore2D(void)
+{
+	// We won't delete this since it was created elsewhere
+	cSettings = NULL;
+}
+
+/**
+  @brief Initialise this instance
+  @param uiCapacity A const unsigned int variable containing the number of entities to reserve space for
+  */
+bool CComponentStore2D::Init(const unsigned int uiCapacity)
+{
+	cSettings = CSettings::GetInstance();
+
+	Clear();
+
+	// Reserve the pools so that creating components during the game will not allocate
+	sTransform.vec2UVCoordinate.reserve(uiCapacity);
+	sTilePosition.i32vec2Index.reserve(uiCapacity);
+	sTilePosition.i32vec2NumMicroSteps.reserve(uiCapacity);
+	sTilePosition.vec2Position.reserve(uiCapacity);
+	sPhysics.vec2Velocity.reserve(uiCapacity);
+	sPhysics.ucStatus.reserve(uiCapacity);
+	sSprite.uiTextureID.reserve(uiCapacity);
+	sSprite.vec4Colour.reserve(uiCapacity);
+	sCollider.vec2Size.reserve(uiCapacity);
+	sCollider.bDead.reserve(uiCapacity);
+	sCollider.bAsleep.reserve(uiCapacity);
+	vOwners.reserve(uiCapacity);
+	vHandles.reserve(uiCapacity);
+	vDenseIndices.reserve(uiCapacity);
+	vFreeHandles.reserve(uiCapacity);
+
+	return true;
+}
+
+/**
+ @brief Create the components for an entity
+ @param cEntity2D A CEntity2D* variable which is the entity to create the components for
+ */
+CComponentStore2D::HANDLE CComponentStore2D::Create(CEntity2D* cEntity2D)
+{
+	// Get a handle
+	HANDLE hHandle;
+	if (vFreeHandles.size() > 0)
+	{
+		hHandle = vFreeHandles.back();
+		vFreeHandles.pop_back();
+	}
+	else
+	{
+		hHandle = (HANDLE)vDenseIndices.size();
+		vDenseIndices.push_back(0);
+	}
+
+	// Add the components at the end of the pools
+	vDenseIndices[hHandle] = (unsigned int)vOwners.size();
+	vOwners.push_back(cEntity2D);
+	vHandles.push_back(hHandle);
+
+	sTransform.vec2UVCoordinate.push_back(cEntity2D->vec2UVCoordinate);
+	sTilePosition.i32vec2Index.push_back(cEntity2D->i32vec2Index);
+	sTilePosition.i32vec2NumMicroSteps.push_back(cEntity2D->i32vec2NumMicroSteps);
+	sTilePosition.vec2Position.push_back(glm::vec2(0.0f));
+	sPhysics.vec2Velocity.push_back(glm::vec2(0.0f));
+	sPhysics.ucStatus.push_back(0);
+	sSprite.uiTextureID.push_back(0);
+	sSprite.vec4Colour.push_back(glm::vec4(1.0f));
+	sCollider.vec2Size.push_back(glm::vec2(1.0f));
+	sCollider.bDead.push_back(cEntity2D->dead);
+	sCollider.bAsleep.push_back(cEntity2D->IsAsleep());
+
+	cEntity2D->uiComponentHandle = hHandle;
+
+	return hHandle;
+}
+
+/**
+ @brief Destroy the components of an entity.
+		The last components in the pools are moved into the gap, so that the pools stay packed.
+ @param hHandle A const HANDLE variable which is the handle of the components
+ */
+void CComponentStore2D::Destroy(const HANDLE hHandle)
+{
+	if (hHandle >= vDenseIndices.size())
+	{
+		cout << "CComponentStore2D::Destroy() : Invalid handle" << endl;
+		return;
+	}
+
+	unsigned int uiIndex = vDenseIndices[hHandle];
+	unsigned int uiLast = (unsigned int)vOwners.size() - 1;
+
+	vOwners[uiIndex]->uiComponentHandle = INVALID_HANDLE;
+
+	// Move the last components into the gap
+	if (uiIndex != uiLast)
+	{
+		vOwners[uiIndex] = vOwners[uiLast];
+		vHandles[uiIndex] = vHandles[uiLast];
+		vDenseIndices[vHandles[uiIndex]] = uiIndex;
+
+		sTransform.vec2UVCoordinate[uiIndex] = sTransform.vec2UVCoordinate[uiLast];
+		sTilePosition.i32vec2Index[uiIndex] = sTilePosition.i32vec2Index[uiLast];
+		sTilePosition.i32vec2NumMicroSteps[uiIndex] = sTilePosition.i32vec2NumMicroSteps[uiLast];
+		sTilePosition.vec2Position[uiIndex] = sTilePosition.vec2Position[uiLast];
+		sPhysics.vec2Velocity[uiIndex] = sPhysics.vec2Velocity[uiLast];
+		sPhysics.ucStatus[uiIndex] = sPhysics.ucStatus[uiLast];
+		sSprite.uiTextureID[uiIndex] = sSprite.uiTextureID[uiLast];
+		sSprite.vec4Colour[uiIndex] = sSprite.vec4Colour[uiLast];
+		sCollider.vec2Size[uiIndex] = sCollider.vec2Size[uiLast];
+		sCollider.bDead[uiIndex] = sCollider.bDead[uiLast];
+		sCollider.bAsleep[uiIndex] = sCollider.bAsleep[uiLast];
+	}
+
+	vOwners.pop_back();
+	vHandles.pop_back();
+	sTransform.vec2UVCoordinate.pop_back();
+	sTilePosition.i32vec2Index.pop_back();
+	sTilePosition.i32vec2NumMicroSteps.pop_back();
+	sTilePosition.vec2Position.pop_back();
+	sPhysics.vec2Velocity.pop_back();
+	sPhysics.ucStatus.pop_back();
+	sSprite.uiTextureID.pop_back();
+	sSprite.vec4Colour.pop_back();
+	sCollider.vec2Size.pop_back();
+	sCollider.bDead.pop_back();
+	sCollider.bAsleep.pop_back();
+
+	vFreeHandles.push_back(hHandle);
+}
+
+/**
+ @brief Destroy all the components
+ */
+void CComponentStore2D::Clear(void)
+{
+	for (unsigned int i = 0; i < vOwners.size(); i++)
+	{
+		vOwners[i]->uiComponentHandle = INVALID_HANDLE;
+	}
+
+	vOwners.clear();
+	vHandles.clear();
+	vDenseIndices.clear();
+	vFreeHandles.clear();
+	sTransform.vec2UVCoordinate.clear();
+	sTilePosition.i32vec2Index.clear();
+	sTilePosition.i32vec2NumMicroSteps.clear();
+	sTilePosition.vec2Position.clear();
+	sPhysics.vec2Velocity.clear();
+	sPhysics.ucStatus.clear();
+	sSprite.uiTextureID.clear();
+	sSprite.vec4Colour.clear();
+	sCollider.vec2Size.clear();
+	sCollider.bDead.clear();
+	sCollider.bAsleep.clear();
+}
+
+/**
+ @brief Get the number of entities with components
+ */
+unsigned int CComponentStore2D::GetNumComponents(void) const
+{
+	return (unsigned int)vOwners.size();
+}
+
+/**
+ @brief Get the dense index of a handle in the pools
+ */
+unsigned int CComponentStore2D::GetDenseIndex(const HANDLE hHandle) const
+{
+	return vDenseIndices[hHandle];
+}
+
+/**
+ @brief Get the entity at a dense index in the pools
+ */
+CEntity2D* CComponentStore2D::GetOwner(const unsigned int uiDenseIndex) const
+{
+	return vOwners[uiDenseIndex];
+}
+
+/**
+ @brief Adapter: Set the physics components of an entity
+ */
+void CComponentStore2D::SetPhysics(const HANDLE hHandle, const glm::vec2& vec2Velocity, const unsigned char ucStatus)
+{
+	if (hHandle == INVALID_HANDLE)
+		return;
+
+	unsigned int uiIndex = vDenseIndices[hHandle];
+	sPhysics.vec2Velocity[uiIndex] = vec2Velocity;
+	sPhysics.ucStatus[uiIndex] = ucStatus;
+}
+
+/**
+ @brief Adapter: Set the sprite components of an entity
+ */
+void CComponentStore2D::SetSprite(const HANDLE hHandle, const GLuint uiTextureID, const glm::vec4& vec4Colour)
+{
+	if (hHandle == INVALID_HANDLE)
+		return;
+
+	unsigned int uiIndex = vDenseIndices[hHandle];
+	sSprite.uiTextureID[uiIndex] = uiTextureID;
+	sSprite.vec4Colour[uiIndex] = vec4Colour;
+}
+
+/**
+ @brief Adapter: Set the size of the collider of an entity, in tiles
+ */
+void CComponentStore2D::SetColliderSize(const HANDLE hHandle, const glm::vec2& vec2Size)
+{
+	if (hHandle == INVALID_HANDLE)
+		return;
+
+	sCollider.vec2Size[vDenseIndices[hHandle]] = vec2Size;
+}
+
+/**
+ @brief Adapter: Copy the tile positions and flags from the entities into the pools
+ */
+void CComponentStore2D::Gather(void)
+{
+	const unsigned int uiNumComponents = (unsigned int)vOwners.size();
+	for (unsigned int i = 0; i < uiNumComponents; i++)
+	{
+		const CEntity2D* cEntity2D = vOwners[i];
+		sTilePosition.i32vec2Index[i] = cEntity2D->i32vec2Index;
+		sTilePosition.i32vec2NumMicroSteps[i] = cEntity2D->i32vec2NumMicroSteps;
+		sCollider.bDead[i] = cEntity2D->dead;
+		sCollider.bAsleep[i] = cEntity2D->IsAsleep();
+	}
+}
+
+/**
+ @brief System: Update the transforms from the tile positions
+ */
+void CComponentStore2D::UpdateTransforms(void)
+{
+	const unsigned int uiNumComponents = (unsigned int)vOwners.size();
+	const float fStepX = 1.0f / cSettings->NUM_STEPS_PER_TILE_XAXIS;
+	const float fStepY = 1.0f / cSettings->NUM_STEPS_PER_TILE_YAXIS;
+
+	for (unsigned int i = 0; i < uiNumComponents; i++)
+	{
+		const glm::i32vec2& i32vec2Index = sTilePosition.i32vec2Index[i];
+		const glm::i32vec2& i32vec2NumMicroSteps = sTilePosition.i32vec2NumMicroSteps[i];
+
+		sTilePosition.vec2Position[i] = glm::vec2(	i32vec2Index.x + i32vec2NumMicroSteps.x * fStepX,
+													i32vec2Index.y + i32vec2NumMicroSteps.y * fStepY);
+
+		sTransform.vec2UVCoordinate[i] = glm::vec2(
+			cSettings->ConvertIndexToUVSpace(cSettings->x, i32vec2Index.x, false, i32vec2NumMicroSteps.x * cSettings->MICRO_STEP_XAXIS),
+			cSettings->ConvertIndexToUVSpace(cSettings->y, i32vec2Index.y, false, i32vec2NumMicroSteps.y * cSettings->MICRO_STEP_YAXIS));
+	}
+}
+
+/**
+ @brief Adapter: Copy the transforms from the pools back into the entities
+ */
+void CComponentStore2D::Scatter(void)
+{
+	const unsigned int uiNumComponents = (unsigned int)vOwners.size();
+	for (unsigned int i = 0; i < uiNumComponents; i++)
+	{
+		vOwners[i]->vec2UVCoordinate = sTransform.vec2UVCoordinate[i];
+	}
+}
+
+/**
+ @brief System: Find the pairs of colliding entities.
+		Every colliding pair is reported once, with an awake entity first.
+		Sleeping entities do not look for collisions with each other, but an awake entity
+		can collide with a sleeping entity, which is then woken up by the entity manager.
+		Entities which are touching are colliding.
+ @param vCollisionPairs A std::vector<CollisionPair>& variable to store the colliding pairs in
+ */
+void CComponentStore2D::DetectCollisions(std::vector<CollisionPair>& vCollisionPairs) const
+{
+	vCollisionPairs.clear();
+
+	const unsigned int uiNumComponents = (unsigned int)vOwners.size();
+	const glm::vec2* vec2Position = sTilePosition.vec2Position.data();
+	const glm::vec2* vec2Size = sCollider.vec2Size.data();
+
+	for (unsigned int i = 0; i < uiNumComponents; i++)
+	{
+		if (sCollider.bDead[i])
+			continue;
+
+		// Each pair is only tested by the entity which comes first in the pools
+		for (unsigned int j = i + 1; j < uiNumComponents; j++)
+		{
+			if (sCollider.bDead[j] || (sCollider.bAsleep[i] && sCollider.bAsleep[j]))
+				continue;
+
+			if (vec2Position[i].x <= vec2Position[j].x + vec2Size[j].x &&
+				vec2Position[j].x <= vec2Position[i].x + vec2Size[i].x &&
+				vec2Position[i].y <= vec2Position[j].y + vec2Size[j].y &&
+				vec2Position[j].y <= vec2Position[i].y + vec2Size[i].y)
+			{
+				// Put the awake entity first
+				CollisionPair sPair;
+				if (sCollider.bAsleep[i])
+				{
+					sPair.uiFirst = j;
+					sPair.uiSecond = i;
+				}
+				else
+				{
+					sPair.uiFirst = i;
+					sPair.uiSecond = j;
+				}
+				vCollisionPairs.push_back(sPair);
+			}
+		}
+	}
+}
\ No newline at end of file
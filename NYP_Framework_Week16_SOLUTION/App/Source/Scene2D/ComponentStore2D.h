@@ -0,0 +1,157 @@
+/**
+ CComponentStore2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include Singleton template
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+#include <includes/gtc/matrix_transform.hpp>
+#include <includes/gtc/type_ptr.hpp>
+
+// Include Settings
+#include "GameControl\Settings.h"
+
+// Include CEntity2D
+#include "Primitives/Entity2D.h"
+
+// Include vector
+#include <vector>
+
+/**
+ CComponentStore2D: Stores the hot state of the 2D entities in structure-of-arrays pools.
+					The systems in this class iterate over the pools linearly.
+					Entities which still keep their state in CEntity2D are copied in and out
+					of the pools by Gather and Scatter, so that they can be migrated gradually.
+ */
+class CComponentStore2D : public CSingletonTemplate<CComponentStore2D>
+{
+	friend CSingletonTemplate<CComponentStore2D>;
+public:
+	// A handle to the components of an entity
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// Transform pool: The UV coordinates to render the entities at
+	struct TransformPool
+	{
+		std::vector<glm::vec2> vec2UVCoordinate;
+	};
+
+	// Tile position pool: The tile indices and microsteps of the entities
+	struct TilePositionPool
+	{
+		std::vector<glm::i32vec2> i32vec2Index;
+		std::vector<glm::i32vec2> i32vec2NumMicroSteps;
+		// The position in tiles, including the microsteps
+		std::vector<glm::vec2> vec2Position;
+	};
+
+	// Physics pool: The velocity and the CPhysics2D::STATUS of the entities
+	struct PhysicsPool
+	{
+		std::vector<glm::vec2> vec2Velocity;
+		std::vector<unsigned char> ucStatus;
+	};
+
+	// Sprite pool: The texture and colour of the entities
+	struct SpritePool
+	{
+		std::vector<GLuint> uiTextureID;
+		std::vector<glm::vec4> vec4Colour;
+	};
+
+	// Collider pool: The size of the entities in tiles, and if they can collide
+	struct ColliderPool
+	{
+		std::vector<glm::vec2> vec2Size;
+		std::vector<unsigned char> bDead;
+		std::vector<unsigned char> bAsleep;
+	};
+
+	// A pair of dense indices of entities which are colliding
+	struct CollisionPair
+	{
+		unsigned int uiFirst;
+		unsigned int uiSecond;
+	};
+
+	// Init
+	bool Init(const unsigned int uiCapacity = 128);
+
+	// Create the components for an entity
+	HANDLE Create(CEntity2D* cEntity2D);
+
+	// Destroy the components of an entity
+	void Destroy(const HANDLE hHandle);
+
+	// Destroy all the components
+	void Clear(void);
+
+	// Get the number of entities with components
+	unsigned int GetNumComponents(void) const;
+
+	// Get the dense index of a handle in the pools
+	unsigned int GetDenseIndex(const HANDLE hHandle) const;
+
+	// Get the entity at a dense index in the pools
+	CEntity2D* GetOwner(const unsigned int uiDenseIndex) const;
+
+	// Adapter: Set the physics components of an entity
+	void SetPhysics(const HANDLE hHandle, const glm::vec2& vec2Velocity, const unsigned char ucStatus);
+
+	// Adapter: Set the sprite components of an entity
+	void SetSprite(const HANDLE hHandle, const GLuint uiTextureID, const glm::vec4& vec4Colour);
+
+	// Adapter: Set the size of the collider of an entity, in tiles
+	void SetColliderSize(const HANDLE hHandle, const glm::vec2& vec2Size);
+
+	// Adapter: Copy the tile positions and flags from the entities into the pools
+	void Gather(void);
+
+	// System: Update the transforms from the tile positions
+	void UpdateTransforms(void);
+
+	// Adapter: Copy the transforms from the pools back into the entities
+	void Scatter(void);
+
+	// System: Find the pairs of colliding entities. Each pair is reported once, with an awake entity first
+	void DetectCollisions(std::vector<CollisionPair>& vCollisionPairs) const;
+
+	// The pools
+	TransformPool sTransform;
+	TilePositionPool sTilePosition;
+	PhysicsPool sPhysics;
+	SpritePool sSprite;
+	ColliderPool sCollider;
+
+protected:
+	// The entities which own the components, by dense index
+	std::vector<CEntity2D*> vOwners;
+	// The handle of each dense index
+	std::vector<HANDLE> vHandles;
+	// The dense index of each handle
+	std::vector<unsigned int> vDenseIndices;
+	// The handles which can be reused
+	std::vector<HANDLE> vFreeHandles;
+
+	// Settings
+	CSettings* cSettings;
+
+	// Constructor
+	CComponentStore2D(void);
+
+	// Destructor
+	virtual ~CComponentStore2D(void);
+};
@@ -0,0 +1,366 @@
+/**
+ CCrowd2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "Crowd2D.h"
+
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+// The number of buckets in the spatial hash
+const unsigned int CCrowd2D::NUM_BUCKETS;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CCrowd2D::CCrowd2D(void)
+	: uiAgentBudget(1024)
+	, hNextAgent(0)
+	, uiNumHeldAgents(0)
+	, cSettings(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CCrowd2D::~CCrowd2D(void)
+{
+	// We won't delete this since it was created elsewhere
+	cSettings = NULL;
+}
+
+/**
+ @brief Init Initialise this instance
+ */
+bool CCrowd2D::Init(void)
+{
+	// Get the handler to the CSettings instance
+	cSettings = CSettings::GetInstance();
+
+	// Create the reservation table for the tiles of the map
+	vReservations.assign(cSettings->NUM_TILES_XAXIS * cSettings->NUM_TILES_YAXIS, INVALID_HANDLE);
+	vReservedTiles.clear();
+
+	vBucketStart.assign(NUM_BUCKETS + 1, 0);
+	hNextAgent = 0;
+	uiNumHeldAgents = 0;
+	return true;
+}
+
+/**
+ @brief Register an agent and return its handle. The handle of an unregistered agent is reused if there is one.
+ */
+CCrowd2D::HANDLE CCrowd2D::RegisterAgent(void)
+{
+	HANDLE hAgent;
+	if (vFreeAgents.size() > 0)
+	{
+		hAgent = vFreeAgents.back();
+		vFreeAgents.pop_back();
+	}
+	else
+	{
+		hAgent = (HANDLE)vAgents.size();
+		vAgents.push_back(Agent());
+		vAgentBuckets.push_back(0);
+	}
+
+	Agent& sAgent = vAgents[hAgent];
+	sAgent.bAlive = true;
+	sAgent.i32vec2Index = glm::i32vec2(0);
+	sAgent.vec2Position = glm::vec2(0.0f);
+	sAgent.i32vec2Desired = glm::i32vec2(0);
+	sAgent.bHeld = false;
+	return hAgent;
+}
+
+/**
+ @brief Unregister an agent
+ */
+void CCrowd2D::UnregisterAgent(const HANDLE hAgent)
+{
+	if ((hAgent >= vAgents.size()) || (!vAgents[hAgent].bAlive))
+	{
+		cout << "CCrowd2D::UnregisterAgent: Invalid handle " << hAgent << endl;
+		return;
+	}
+
+	vAgents[hAgent].bAlive = false;
+	vFreeAgents.push_back(hAgent);
+}
+
+/**
+ @brief Set the position of an agent, and the direction it wants to move in. This is used in the next Update
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @param i32vec2Index A const glm::i32vec2& variable containing the tile which the agent is in
+ @param i32vec2NumMicroSteps A const glm::i32vec2& variable containing the microsteps of the agent
+ @param i32vec2Desired A const glm::i32vec2& variable containing the direction which the agent wants to move in
+ */
+void CCrowd2D::SetAgent(const HANDLE hAgent,
+						const glm::i32vec2& i32vec2Index,
+						const glm::i32vec2& i32vec2NumMicroSteps,
+						const glm::i32vec2& i32vec2Desired)
+{
+	if ((hAgent >= vAgents.size()) || (!vAgents[hAgent].bAlive))
+		return;
+
+	Agent& sAgent = vAgents[hAgent];
+	sAgent.i32vec2Index = i32vec2Index;
+	sAgent.vec2Position = glm::vec2(i32vec2Index.x + i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+									i32vec2Index.y + i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+	sAgent.i32vec2Desired = i32vec2Desired;
+}
+
+/**
+ @brief Update once per frame before the agents.
+		The agents reserve the tiles which they are in, and then they are steered in the order of their handles.
+		Only uiAgentBudget agents are steered, starting from hNextAgent. The others keep their results
+		from when they were last steered, and reserve the tiles which they are moving into if they can.
+ */
+void CCrowd2D::Update(void)
+{
+	const HANDLE hNumAgents = (HANDLE)vAgents.size();
+
+	BuildSpatialHash();
+
+	// Clear the reservations of the last frame
+	for (auto& uiTile : vReservedTiles)
+		vReservations[uiTile] = INVALID_HANDLE;
+	vReservedTiles.clear();
+
+	// Reserve the tiles which the agents are in
+	for (HANDLE hAgent = 0; hAgent < hNumAgents; hAgent++)
+	{
+		if (vAgents[hAgent].bAlive)
+			Reserve(vAgents[hAgent].i32vec2Index, hAgent);
+	}
+
+	// Find the handles which are steered in this frame. They may wrap around to the start
+	if (hNextAgent >= hNumAgents)
+		hNextAgent = 0;
+	const HANDLE hFirst = hNextAgent;
+	const HANDLE hLast = hFirst + std::min(uiAgentBudget, hNumAgents);
+	hNextAgent = hLast % std::max(hNumAgents, (HANDLE)1);
+
+	uiNumHeldAgents = 0;
+	for (HANDLE hAgent = 0; hAgent < hNumAgents; hAgent++)
+	{
+		Agent& sAgent = vAgents[hAgent];
+		if (!sAgent.bAlive)
+			continue;
+
+		const bool bSteered = ((hAgent >= hFirst) && (hAgent < hLast)) || (hAgent + hNumAgents < hLast);
+		if (bSteered)
+		{
+			sAgent.bHeld = ResolveAgent(hAgent);
+		}
+		else if ((!sAgent.bHeld) && (sAgent.i32vec2Desired.x != 0))
+		{
+			// Keep moving if the tile ahead can still be reserved
+			const glm::i32vec2 i32vec2Next(sAgent.i32vec2Index.x + (sAgent.i32vec2Desired.x > 0 ? 1 : -1), sAgent.i32vec2Index.y);
+			sAgent.bHeld = !Reserve(i32vec2Next, hAgent);
+		}
+
+		if (sAgent.bHeld)
+			uiNumHeldAgents++;
+	}
+}
+
+/**
+ @brief Get the direction which an agent should move in. If it is held back, then it does not move along the x-axis
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @param i32vec2Desired A const glm::i32vec2& variable containing the direction which the agent wants to move in
+ */
+glm::i32vec2 CCrowd2D::Steer(const HANDLE hAgent, const glm::i32vec2& i32vec2Desired) const
+{
+	if ((hAgent >= vAgents.size()) || (!vAgents[hAgent].bAlive) || (!vAgents[hAgent].bHeld))
+		return i32vec2Desired;
+
+	return glm::i32vec2(0, i32vec2Desired.y);
+}
+
+/**
+ @brief Get the handles of the agents within a distance of a position, in the order of their handles
+ @param vec2Position A const glm::vec2& variable containing the position in tiles
+ @param fDistance A const float variable containing the distance in tiles
+ @param vNeighbours A std::vector<HANDLE>& variable which the handles are returned in
+ */
+void CCrowd2D::GetNeighbours(const glm::vec2& vec2Position, const float fDistance, std::vector<HANDLE>& vNeighbours) const
+{
+	vNeighbours.clear();
+	if (vBucketAgents.empty())
+		return;
+
+	const int iMinCellX = (int)floor((vec2Position.x - fDistance) / CELL_SIZE);
+	const int iMaxCellX = (int)floor((vec2Position.x + fDistance) / CELL_SIZE);
+	const int iMinCellY = (int)floor((vec2Position.y - fDistance) / CELL_SIZE);
+	const int iMaxCellY = (int)floor((vec2Position.y + fDistance) / CELL_SIZE);
+	const float fDistanceSquared = fDistance * fDistance;
+
+	for (int iCellY = iMinCellY; iCellY <= iMaxCellY; iCellY++)
+	{
+		for (int iCellX = iMinCellX; iCellX <= iMaxCellX; iCellX++)
+		{
+			const unsigned int uiBucket = GetBucket(iCellX, iCellY);
+			for (unsigned int i = vBucketStart[uiBucket]; i < vBucketStart[uiBucket + 1]; i++)
+			{
+				const HANDLE hAgent = vBucketAgents[i];
+				const glm::vec2 vec2Offset = vAgents[hAgent].vec2Position - vec2Position;
+				if (glm::dot(vec2Offset, vec2Offset) <= fDistanceSquared)
+					vNeighbours.push_back(hAgent);
+			}
+		}
+	}
+
+	// Different cells may share a bucket, so remove the duplicates
+	std::sort(vNeighbours.begin(), vNeighbours.end());
+	vNeighbours.erase(std::unique(vNeighbours.begin(), vNeighbours.end()), vNeighbours.end());
+}
+
+/**
+ @brief Set the number of agents which are steered in each frame
+ */
+void CCrowd2D::SetAgentBudget(const unsigned int uiAgentBudget)
+{
+	this->uiAgentBudget = std::max(uiAgentBudget, 1u);
+}
+
+/**
+ @brief Get the number of agents which are steered in each frame
+ */
+unsigned int CCrowd2D::GetAgentBudget(void) const
+{
+	return uiAgentBudget;
+}
+
+/**
+ @brief Get the number of agents which were held back in the last frame
+ */
+unsigned int CCrowd2D::GetNumHeldAgents(void) const
+{
+	return uiNumHeldAgents;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CCrowd2D::PrintSelf(void) const
+{
+	cout << "CCrowd2D::PrintSelf()" << endl;
+	cout << "Agents: " << vAgents.size() - vFreeAgents.size()
+		<< ", Held: " << uiNumHeldAgents
+		<< ", Budget: " << uiAgentBudget << endl;
+}
+
+/**
+ @brief Get the bucket of a cell in the spatial hash
+ */
+unsigned int CCrowd2D::GetBucket(const int iCellX, const int iCellY) const
+{
+	return (((unsigned int)iCellX * 73856093u) ^ ((unsigned int)iCellY * 19349663u)) & (NUM_BUCKETS - 1);
+}
+
+/**
+ @brief Build the spatial hash from the positions of the agents with a counting sort,
+		so that the agents in each bucket are in the order of their handles
+ */
+void CCrowd2D::BuildSpatialHash(void)
+{
+	const HANDLE hNumAgents = (HANDLE)vAgents.size();
+
+	std::fill(vBucketStart.begin(), vBucketStart.end(), 0);
+	for (HANDLE hAgent = 0; hAgent < hNumAgents; hAgent++)
+	{
+		if (!vAgents[hAgent].bAlive)
+			continue;
+
+		const glm::vec2& vec2Position = vAgents[hAgent].vec2Position;
+		vAgentBuckets[hAgent] = GetBucket((int)floor(vec2Position.x / CELL_SIZE), (int)floor(vec2Position.y / CELL_SIZE));
+		vBucketStart[vAgentBuckets[hAgent] + 1]++;
+	}
+
+	for (unsigned int i = 0; i < NUM_BUCKETS; i++)
+		vBucketStart[i + 1] += vBucketStart[i];
+
+	vBucketAgents.resize(vBucketStart[NUM_BUCKETS]);
+	vBucketEnd.assign(vBucketStart.begin(), vBucketStart.end() - 1);
+	for (HANDLE hAgent = 0; hAgent < hNumAgents; hAgent++)
+	{
+		if (vAgents[hAgent].bAlive)
+			vBucketAgents[vBucketEnd[vAgentBuckets[hAgent]]++] = hAgent;
+	}
+}
+
+/**
+ @brief Get the tile index in the reservation table, or -1 if the tile is outside the map
+ */
+int CCrowd2D::GetTile(const glm::i32vec2& i32vec2Index) const
+{
+	if ((i32vec2Index.x < 0) || (i32vec2Index.x >= (int)cSettings->NUM_TILES_XAXIS) ||
+		(i32vec2Index.y < 0) || (i32vec2Index.y >= (int)cSettings->NUM_TILES_YAXIS))
+		return -1;
+
+	return i32vec2Index.y * (int)cSettings->NUM_TILES_XAXIS + i32vec2Index.x;
+}
+
+/**
+ @brief Reserve a tile for an agent. Tiles outside the map are not reserved, as the agents cannot move into them
+ @param i32vec2Index A const glm::i32vec2& variable containing the tile
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @return false if the tile is reserved by another agent
+ */
+bool CCrowd2D::Reserve(const glm::i32vec2& i32vec2Index, const HANDLE hAgent)
+{
+	const int iTile = GetTile(i32vec2Index);
+	if (iTile < 0)
+		return true;
+
+	if (vReservations[iTile] == INVALID_HANDLE)
+	{
+		vReservations[iTile] = hAgent;
+		vReservedTiles.push_back((unsigned int)iTile);
+		return true;
+	}
+	return (vReservations[iTile] == hAgent);
+}
+
+/**
+ @brief Decide if an agent is held back.
+		It is held back by a neighbour less than SEPARATION_DISTANCE ahead of it on the same row, unless that
+		neighbour has a lower priority and is coming towards it, or if the tile ahead is reserved by another agent.
+ @param hAgent A const HANDLE variable containing the handle of the agent
+ @return true if the agent is held back
+ */
+bool CCrowd2D::ResolveAgent(const HANDLE hAgent)
+{
+	const Agent& sAgent = vAgents[hAgent];
+	if (sAgent.i32vec2Desired.x == 0)
+		return false;
+
+	const int iDirection = (sAgent.i32vec2Desired.x > 0 ? 1 : -1);
+
+	// Separation
+	GetNeighbours(sAgent.vec2Position, SEPARATION_DISTANCE, vSteerNeighbours);
+	for (auto& hNeighbour : vSteerNeighbours)
+	{
+		if (hNeighbour == hAgent)
+			continue;
+
+		const Agent& sNeighbour = vAgents[hNeighbour];
+		const glm::vec2 vec2Offset = sNeighbour.vec2Position - sAgent.vec2Position;
+		if ((fabs(vec2Offset.y) >= 0.5f) || (vec2Offset.x * iDirection <= 0.0f))
+			continue;
+
+		const bool bHeadOn = (sNeighbour.i32vec2Desired.x * iDirection < 0);
+		if ((hNeighbour < hAgent) || (!bHeadOn))
+			return true;
+	}
+
+	// Reservation
+	const glm::i32vec2 i32vec2Next(sAgent.i32vec2Index.x + iDirection, sAgent.i32vec2Index.y);
+	return !Reserve(i32vec2Next, hAgent);
+}
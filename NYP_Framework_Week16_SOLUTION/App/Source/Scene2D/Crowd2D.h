@@ -0,0 +1,151 @@
+/**
+ CCrowd2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector
+#include <vector>
+
+// Include Settings
+#include "GameControl\Settings.h"
+
+/**
+ CCrowd2D: Steers the agents of a crowd around each other, on top of the directions from their paths.
+		   Each agent gives its position and the direction it wants to move in, and the crowd decides
+		   if it may move along the x-axis in the next frame, or if it is held back to let another agent pass.
+
+		   Separation:  An agent is held back if a neighbour with a higher priority is less than
+						SEPARATION_DISTANCE ahead of it on the same row. Neighbours are found in a spatial hash.
+		   Reservation: Each agent reserves the tile it is in, and then the tile it is moving into.
+						An agent is held back if the tile it is moving into is reserved by another agent.
+
+		   The agents are resolved in the order of their handles, so the lower handles have a higher priority,
+		   and the result does not depend on the frame rate or the number of agents. Only uiAgentBudget agents
+		   are steered in each frame, in turn, and the others keep their results from when they were last steered.
+ */
+class CCrowd2D : public CSingletonTemplate<CCrowd2D>
+{
+	friend CSingletonTemplate<CCrowd2D>;
+public:
+	// A handle to an agent
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// Init
+	bool Init(void);
+
+	// Register an agent and return its handle
+	HANDLE RegisterAgent(void);
+	// Unregister an agent. Its handle may be reused by the next agent which is registered
+	void UnregisterAgent(const HANDLE hAgent);
+
+	// Set the position of an agent, and the direction it wants to move in. This is used in the next Update
+	void SetAgent(const HANDLE hAgent,
+				  const glm::i32vec2& i32vec2Index,
+				  const glm::i32vec2& i32vec2NumMicroSteps,
+				  const glm::i32vec2& i32vec2Desired);
+
+	// Update once per frame before the agents, to steer the agents within the budget
+	void Update(void);
+
+	// Get the direction which an agent should move in, from the direction it wants to move in
+	glm::i32vec2 Steer(const HANDLE hAgent, const glm::i32vec2& i32vec2Desired) const;
+
+	// Get the handles of the agents within a distance, in tiles, of a position, in the order of their handles
+	void GetNeighbours(const glm::vec2& vec2Position, const float fDistance, std::vector<HANDLE>& vNeighbours) const;
+
+	// Set the number of agents which are steered in each frame
+	void SetAgentBudget(const unsigned int uiAgentBudget);
+	// Get the number of agents which are steered in each frame
+	unsigned int GetAgentBudget(void) const;
+
+	// Get the number of agents which were held back in the last frame
+	unsigned int GetNumHeldAgents(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The size, in tiles, of the cells in the spatial hash
+	const float CELL_SIZE = 2.0f;
+	// The number of buckets in the spatial hash. This must be a power of 2
+	static const unsigned int NUM_BUCKETS = 1024;
+	// The distance, in tiles, which an agent keeps from the neighbour ahead of it
+	const float SEPARATION_DISTANCE = 1.0f;
+
+	// The state of an agent
+	struct Agent
+	{
+		// Boolean flag to indicate if this agent is registered
+		bool bAlive;
+		// The tile which the agent is in
+		glm::i32vec2 i32vec2Index;
+		// The position in tiles, including the microsteps
+		glm::vec2 vec2Position;
+		// The direction which the agent wants to move in
+		glm::i32vec2 i32vec2Desired;
+		// Boolean flag to indicate if the agent is held back
+		bool bHeld;
+	};
+
+	// The agents, indexed by their handles
+	std::vector<Agent> vAgents;
+	// The handles of unregistered agents, which can be reused
+	std::vector<HANDLE> vFreeAgents;
+
+	// The spatial hash. The agents in bucket i are vBucketAgents[vBucketStart[i]] to vBucketAgents[vBucketStart[i + 1] - 1]
+	std::vector<unsigned int> vBucketStart;
+	std::vector<HANDLE> vBucketAgents;
+	// The bucket of each agent in this frame
+	std::vector<unsigned int> vAgentBuckets;
+	// The next free position in each bucket while the spatial hash is built
+	std::vector<unsigned int> vBucketEnd;
+	// The neighbours of the agent which is being steered
+	std::vector<HANDLE> vSteerNeighbours;
+
+	// The reservation table, with the handle of the agent which reserved each tile
+	std::vector<HANDLE> vReservations;
+	// The tiles which were reserved in this frame, so that only they are cleared
+	std::vector<unsigned int> vReservedTiles;
+
+	// The number of agents which are steered in each frame
+	unsigned int uiAgentBudget;
+	// The handle of the next agent to steer
+	HANDLE hNextAgent;
+
+	// The number of agents which were held back in the last frame
+	unsigned int uiNumHeldAgents;
+
+	// Settings
+	CSettings* cSettings;
+
+	// Constructor
+	CCrowd2D(void);
+
+	// Destructor
+	virtual ~CCrowd2D(void);
+
+	// Get the bucket of a cell in the spatial hash
+	unsigned int GetBucket(const int iCellX, const int iCellY) const;
+
+	// Build the spatial hash from the positions of the agents
+	void BuildSpatialHash(void);
+
+	// Get the tile index in the reservation table, or -1 if the tile is outside the map
+	int GetTile(const glm::i32vec2& i32vec2Index) const;
+
+	// Reserve a tile for an agent. Returns false if it is reserved by another agent
+	bool Reserve(const glm::i32vec2& i32vec2Index, const HANDLE hAgent);
+
+	// Decide if an agent is held back
+	bool ResolveAgent(const HANDLE hAgent);
+};
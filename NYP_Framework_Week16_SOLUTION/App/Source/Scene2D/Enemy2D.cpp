@@ -10,14 +10,16 @@ using namespace std;
 
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
 // Include Mesh Builder
 #include "Primitives/MeshBuilder.h"
 
 // Include GLEW
 #include <GL/glew.h>
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
 
 
 // Include the Map2D as we will use it to check the player's movements and actions
@@ -28,18 +30,35 @@ using namespace std;
 // Include Game Manager
 #include "GameManager.h"
 
+// Include ComponentStore2D
+#include "ComponentStore2D.h"
+
+// Include KinematicSolver2D
+#include "KinematicSolver2D.h"
+
+// The names of the conditions and actions in the behaviour tree's CSV file
+const char* const CEnemy2D::arrConditionNames[CEnemy2D::NUM_CONDITIONS] = { "PlayerInRange", "CaughtPlayer" };
+const char* const CEnemy2D::arrActionNames[CEnemy2D::NUM_ACTIONS] = { "Idle", "Patrol", "Chase" };
+
+// The behaviour tree, which is shared by all the enemies
+CBehaviourTree2D CEnemy2D::cBehaviourTree;
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CEnemy2D::CEnemy2D(void)
 	: bIsActive(false)
 	, cMap2D(NULL)
-	, cSettings(NULL)
 	, cPlayer2D(NULL)
-	, sCurrentFSM(FSM::IDLE)
-	, iFSMCounter(0)
 	, quadMesh(NULL)
 	, cSoundController(NULL)
+	, eCurrentAction(ACTION_IDLE)
+	, dTimeSinceCaughtPlayer(1000.0)
+	, hBehaviourAgent(CBehaviourTree2D::INVALID_HANDLE)
+	, cCrowd2D(NULL)
+	, hCrowdAgent(CCrowd2D::INVALID_HANDLE)
+	, cAIScheduler2D(NULL)
+	, hAIAgent(CAIScheduler2D::INVALID_HANDLE)
 {
 	transform = glm::mat4(1.0f);	// make sure to initialize matrix to identity matrix first
 
@@ -67,6 +86,9 @@ void CEnemy2D::CollidedWith(CEntity2D* entity)
 		cSoundController->PlaySoundByID(SOUND_TYPE::BOMB_EXPLOSION);
 		std::cout << "Ehealth:" << eHealth->GetCount() << std::endl;
 		entity->dead = true;
+		// Let the behaviour tree react to the hit on the next tick
+		if (hBehaviourAgent != CBehaviourTree2D::INVALID_HANDLE)
+			cBehaviourTree.PostEvent(hBehaviourAgent);
 		if (eHealth->GetCount() <= 0)
 		{
 			this->dead = true;
@@ -102,8 +124,29 @@ CEnemy2D::~CEnemy2D(void)
 	// We won't delete this since it was created elsewhere
 	cMap2D = NULL;
 
+	// Unregister from the AI scheduler
+	if (hAIAgent != CAIScheduler2D::INVALID_HANDLE)
+	{
+		cAIScheduler2D->UnregisterAgent(hAIAgent);
+		hAIAgent = CAIScheduler2D::INVALID_HANDLE;
+	}
+
+	// Unregister from the behaviour tree
+	if (hBehaviourAgent != CBehaviourTree2D::INVALID_HANDLE)
+	{
+		cBehaviourTree.UnregisterAgent(hBehaviourAgent);
+		hBehaviourAgent = CBehaviourTree2D::INVALID_HANDLE;
+	}
+
+	// Unregister from the crowd
+	if (hCrowdAgent != CCrowd2D::INVALID_HANDLE)
+	{
+		cCrowd2D->UnregisterAgent(hCrowdAgent);
+		hCrowdAgent = CCrowd2D::INVALID_HANDLE;
+	}
+
 	// optional: de-allocate all resources once they've outlived their purpose:
-	glDeleteVertexArrays(1, &VAO);
+	CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
 }
@@ -138,7 +181,7 @@ bool CEnemy2D::Init(ENEMY_TYPE type)
 	i32vec2NumMicroSteps = glm::i32vec2(0, 0);
 
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 
 	// Load the player texture
 	switch (type)
@@ -171,6 +214,30 @@ bool CEnemy2D::Init(ENEMY_TYPE type)
 	// Get the handler to the CSoundController
 	cSoundController = CSoundController::GetInstance();
 
+	// Register with the AI scheduler, which decides when this enemy thinks and finds its paths
+	cAIScheduler2D = CAIScheduler2D::GetInstance();
+	if (hAIAgent == CAIScheduler2D::INVALID_HANDLE)
+		hAIAgent = cAIScheduler2D->RegisterAgent();
+
+	// Load the behaviour tree when the first enemy is initialised, and register with it
+	if (cBehaviourTree.IsLoaded() == false)
+	{
+		if (cBehaviourTree.Load("Scripts/Enemy_Golem_BehaviourTree.csv",
+								arrConditionNames, NUM_CONDITIONS,
+								arrActionNames, NUM_ACTIONS) == false)
+		{
+			std::cout << "Failed to load the enemy behaviour tree" << std::endl;
+			return false;
+		}
+	}
+	if (hBehaviourAgent == CBehaviourTree2D::INVALID_HANDLE)
+		hBehaviourAgent = cBehaviourTree.RegisterAgent();
+
+	// Register with the crowd, which keeps the enemies from piling onto the same tiles
+	cCrowd2D = CCrowd2D::GetInstance();
+	if (hCrowdAgent == CCrowd2D::INVALID_HANDLE)
+		hCrowdAgent = cCrowd2D->RegisterAgent();
+
 	// If this class is initialised properly, then set the bIsActive to true
 	bIsActive = true;
 
@@ -185,99 +252,26 @@ void CEnemy2D::Update(const double dElapsedTime)
 	if (!bIsActive)
 		return;
 
-	switch (sCurrentFSM)
+	// Think only when the AI scheduler lets this enemy, which is less often when it is far from the player
+	double dThinkTime = 0.0;
+	if (cAIScheduler2D->Tick(hAIAgent, i32vec2Index, dElapsedTime, dThinkTime))
 	{
-	case IDLE:
-		if (iFSMCounter > iMaxFSMCounter)
-		{
-			sCurrentFSM = PATROL;
-			iFSMCounter = 0;
-			cout << "Switching to Patrol State" << endl;
-		}
-		iFSMCounter++;
-		break;
-	case PATROL:
-		if (iFSMCounter > iMaxFSMCounter)
-		{
-			sCurrentFSM = IDLE;
-			iFSMCounter = 0;
-			cout << "Switching to Idle State" << endl;
-		}
-		else if (cPhysics2D.CalculateDistance(i32vec2Index, cPlayer2D->i32vec2Index) < 5.0f)
-		{
-			sCurrentFSM = ATTACK;
-			iFSMCounter = 0;
-		}
-		else
-		{
-			// Patrol around
-			// Update the Enemy2D's position for patrol
-			UpdatePosition();
-		}
-		iFSMCounter++;
-		break;
-	case ATTACK:
-		if (cPhysics2D.CalculateDistance(i32vec2Index, cPlayer2D->i32vec2Index) < 5.0f)
-		{
-			// Calculate a path to the player
-			//cMap2D->PrintSelf();
-			//cout << "StartPos: " << i32vec2Index.x << ", " << i32vec2Index.y << endl;
-			//cout << "TargetPos: " << cPlayer2D->i32vec2Index.x << ", " 
-			//		<< cPlayer2D->i32vec2Index.y << endl;
-			auto path = cMap2D->PathFind(	i32vec2Index, 
-											cPlayer2D->i32vec2Index, 
-											heuristic::euclidean, 
-											10);
-			//cout << "=== Printing out the path ===" << endl;
-
-			// Calculate new destination
-			bool bFirstPosition = true;
-			for (const auto& coord : path)
-			{
-				//std::cout << coord.x << "," << coord.y << "\n";
-				if (bFirstPosition == true)
-				{
-					// Set a destination
-					i32vec2Destination = coord;
-					// Calculate the direction between enemy2D and this destination
-					i32vec2Direction = i32vec2Destination - i32vec2Index;
-					bFirstPosition = false;
-				}
-				else
-				{
-					if ((coord - i32vec2Destination) == i32vec2Direction)
-					{
-						// Set a destination
-						i32vec2Destination = coord;
-					}
-					else
-						break;
-				}
-			}
-
-			//cout << "i32vec2Destination : " << i32vec2Destination.x 
-			//		<< ", " << i32vec2Destination.y << endl;
-			//cout << "i32vec2Direction : " << i32vec2Direction.x 
-			//		<< ", " << i32vec2Direction.y << endl;
-			//system("pause");
-
-			// Attack
-			// Update direction to move towards for attack
-			//UpdateDirection();
+		dTimeSinceCaughtPlayer += dThinkTime;
+		cBehaviourTree.Tick(hBehaviourAgent, this, dThinkTime);
+	}
 
-			// Update the Enemy2D's position for attack
-			UpdatePosition();
-		}
-		else
-		{
-			if (iFSMCounter > iMaxFSMCounter)
-			{
-				sCurrentFSM = PATROL;
-				iFSMCounter = 0;
-				cout << "ATTACK : Reset counter: " << iFSMCounter << endl;
-			}
-			iFSMCounter++;
-		}
+	// Move in every frame, towards the destination from the last time this enemy thought
+	switch (eCurrentAction)
+	{
+	case ACTION_PATROL:
+		// Patrol around
+		// Update the Enemy2D's position for patrol
+		UpdateSteeredPosition();
+		break;
+	case ACTION_CHASE:
+		// Chase the player
+		// Update the Enemy2D's position for attack
+		UpdateSteeredPosition();
 		break;
 	default:
 		break;
@@ -306,6 +300,10 @@ void CEnemy2D::Update(const double dElapsedTime)
 
 	// Update Jump or Fall
 	UpdateJumpFall(dElapsedTime);
+
+	// Tell the crowd where this enemy is and where it wants to go, for steering it in the next frame
+	const bool bMoving = (eCurrentAction == ACTION_PATROL) || (eCurrentAction == ACTION_CHASE);
+	cCrowd2D->SetAgent(hCrowdAgent, i32vec2Index, i32vec2NumMicroSteps, bMoving ? i32vec2Direction : glm::i32vec2(0));
 	
 	// Update the Health and Lives
 	UpdateHealthLives();
@@ -313,9 +311,100 @@ void CEnemy2D::Update(const double dElapsedTime)
 	//CS: Update the animated sprite
 	animatedSprites->Update(dElapsedTime);
 
-	// Update the UV Coordinates
-	vec2UVCoordinate.x = cSettings->ConvertIndexToUVSpace(cSettings->x, i32vec2Index.x, false, i32vec2NumMicroSteps.x*cSettings->MICRO_STEP_XAXIS);
-	vec2UVCoordinate.y = cSettings->ConvertIndexToUVSpace(cSettings->y, i32vec2Index.y, false, i32vec2NumMicroSteps.y*cSettings->MICRO_STEP_YAXIS);
+	// Update the components. The UV coordinates are updated by CComponentStore2D::UpdateTransforms
+	CComponentStore2D* cComponentStore2D = CComponentStore2D::GetInstance();
+	cComponentStore2D->SetPhysics(uiComponentHandle, cPhysics2D.GetFinalVelocity(), (unsigned char)cPhysics2D.GetStatus());
+	cComponentStore2D->SetSprite(uiComponentHandle, iTextureID, currentColor);
+}
+
+/**
+ @brief Check a condition of the behaviour tree
+ @param uiConditionID A const unsigned int variable containing the CONDITION to check
+ @param fParam A const float variable containing the parameter from the behaviour tree's CSV file
+ */
+bool CEnemy2D::CheckCondition(const unsigned int uiConditionID, const float fParam)
+{
+	switch (uiConditionID)
+	{
+	case CONDITION_PLAYER_IN_RANGE:
+		// fParam is the range in tiles
+		return (cPhysics2D.CalculateDistance(i32vec2Index, cPlayer2D->i32vec2Index) < fParam);
+	case CONDITION_CAUGHT_PLAYER:
+		// fParam is how long, in seconds, this enemy remembers catching the player
+		return (dTimeSinceCaughtPlayer < fParam);
+	default:
+		cout << "CEnemy2D::CheckCondition: Unknown condition " << uiConditionID << endl;
+		break;
+	}
+	return false;
+}
+
+/**
+ @brief Run an action of the behaviour tree
+ @param uiActionID A const unsigned int variable containing the ACTION to run
+ @param fParam A const float variable containing the parameter from the behaviour tree's CSV file
+ @param dRunningTime A const double variable containing the time since this action started
+ */
+CBehaviourTree2D::STATUS CEnemy2D::RunAction(const unsigned int uiActionID, const float fParam, const double dRunningTime)
+{
+	switch (uiActionID)
+	{
+	case ACTION_IDLE:
+		// Stand still for fParam seconds
+		eCurrentAction = ACTION_IDLE;
+		return (dRunningTime >= fParam) ? CBehaviourTree2D::SUCCESS : CBehaviourTree2D::RUNNING;
+	case ACTION_PATROL:
+		// Patrol for fParam seconds
+		if (eCurrentAction != ACTION_PATROL)
+			cout << "Switching to Patrol State" << endl;
+		eCurrentAction = ACTION_PATROL;
+		return (dRunningTime >= fParam) ? CBehaviourTree2D::SUCCESS : CBehaviourTree2D::RUNNING;
+	case ACTION_CHASE:
+		// Chase the player until the conditions which guard this action fail
+		eCurrentAction = ACTION_CHASE;
+		UpdateChase();
+		return CBehaviourTree2D::RUNNING;
+	default:
+		cout << "CEnemy2D::RunAction: Unknown action " << uiActionID << endl;
+		break;
+	}
+	return CBehaviourTree2D::FAILURE;
+}
+
+/**
+ @brief Update the destination towards the player, using a path from the AI scheduler.
+		The path is cached until the player moves away from its goal, and a new path may
+		take a few frames, so keep the old destination until it is ready
+ */
+void CEnemy2D::UpdateChase(void)
+{
+	std::vector<glm::i32vec2> path;
+	if (cAIScheduler2D->RequestPath(hAIAgent, i32vec2Index, cPlayer2D->i32vec2Index, path) != CAIScheduler2D::PATH_READY)
+		return;
+
+	// Calculate new destination
+	bool bFirstPosition = true;
+	for (const auto& coord : path)
+	{
+		if (bFirstPosition == true)
+		{
+			// Set a destination
+			i32vec2Destination = coord;
+			// Calculate the direction between enemy2D and this destination
+			i32vec2Direction = i32vec2Destination - i32vec2Index;
+			bFirstPosition = false;
+		}
+		else
+		{
+			if ((coord - i32vec2Destination) == i32vec2Direction)
+			{
+				// Set a destination
+				i32vec2Destination = coord;
+			}
+			else
+				break;
+		}
+	}
 }
 
 /**
@@ -327,11 +416,11 @@ void CEnemy2D::PreRender(void)
 		return;
 
 	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
 
 	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use(sShaderName);
@@ -345,29 +434,28 @@ void CEnemy2D::Render(void)
 	if (!bIsActive)
 		return;
 
-	glBindVertexArray(VAO);
-	// get matrix's uniform location and set matrix
-	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
-	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "runtime_color");
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+	// Get the active shader, which keeps the locations of its uniforms
+	CShader* cShader = CShaderManager::GetInstance()->activeShader;
 
 	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	transform = glm::translate(transform, glm::vec3(vec2UVCoordinate.x,
-		vec2UVCoordinate.y,
+	const glm::vec2 vec2RenderUVCoordinate = GetRenderUVCoordinate();
+	transform = glm::translate(transform, glm::vec3(vec2RenderUVCoordinate.x,
+		vec2RenderUVCoordinate.y,
 		0.0f));
 	// Update the shaders with the latest transform
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-	glUniform4fv(colorLoc, 1, glm::value_ptr(currentColor));
+	cShader->setMat4(UNIFORM_TRANSFORM, transform);
+	cShader->setVec4(UNIFORM_RUNTIME_COLOR, currentColor);
 
 	// Get the texture to be rendered
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, iTextureID);
 
 	// Render the tile
 	//glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 	//CS: Render the animated sprite
 	animatedSprites->Render();
 
-	glBindVertexArray(0);
+	CGLStateCache::GetInstance()->BindVertexArray(0);
 
 }
 
@@ -376,11 +464,6 @@ void CEnemy2D::Render(void)
  */
 void CEnemy2D::PostRender(void)
 {
-	if (!bIsActive)
-		return;
-
-	// Disable blending
-	glDisable(GL_BLEND);
 }
 
 /**
@@ -440,45 +523,41 @@ void CEnemy2D::UpdateHealthLives(void)
 }
 
 /**
-@brief Load a texture, assign it a code and store it in MapOfTextureIDs.
+@brief Load a texture from the texture cache, which only loads the file once for all the users of the texture.
 @param filename A const char* variable which contains the file name of the texture
+@param iTextureID A GLuint& variable which is set to the texture ID. The texture which it had before is released
 */
 bool CEnemy2D::LoadTexture(const char* filename, GLuint& iTextureID)
 {
-	// Variables used in loading the texture
-	int width, height, nrChannels;
-
-	// texture 1
-	// ---------
-	glGenTextures(1, &iTextureID);
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
-	// set the texture wrapping parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// set texture filtering parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-	unsigned char* data = cImageLoader->Load(filename, width, height, nrChannels, true);
-	if (data)
-	{
-		if (nrChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (nrChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	CTextureCache* cTextureCache = CTextureCache::GetInstance();
+	if (iTextureID != 0)
+		cTextureCache->Release(iTextureID);
 
-		// Generate mipmaps
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
+	iTextureID = cTextureCache->Acquire(filename, true, GL_REPEAT, GL_LINEAR, true);
+	return iTextureID != 0;
+}
+
+/**
+ @brief Get the world direction vector of a direction
+ @param eDirection A DIRECTION enumerated data type which indicates the direction
+ */
+glm::i32vec2 CEnemy2D::GetDirVector(DIRECTION eDirection) const
+{
+	switch (eDirection)
 	{
-		return false;
+	case LEFT:
+		return glm::i32vec2(-1, 0);
+	case RIGHT:
+		return glm::i32vec2(1, 0);
+	case UP:
+		return glm::i32vec2(0, 1);
+	case DOWN:
+		return glm::i32vec2(0, -1);
+	default:
+		cout << "CEnemy2D::GetDirVector: Unknown direction." << endl;
+		break;
 	}
-	// Free up the memory of the file data read in
-	free(data);
-
-	return true;
+	return glm::i32vec2(0);
 }
 
 /**
@@ -487,42 +566,7 @@ bool CEnemy2D::LoadTexture(const char* filename, GLuint& iTextureID)
  */
 void CEnemy2D::Constraint(DIRECTION eDirection)
 {
-	if (eDirection == LEFT)
-	{
-		if (i32vec2Index.x < 0)
-		{
-			i32vec2Index.x = 0;
-			i32vec2NumMicroSteps.x = 0;
-		}
-	}
-	else if (eDirection == RIGHT)
-	{
-		if (i32vec2Index.x >= (int)cSettings->NUM_TILES_XAXIS - 1)
-		{
-			i32vec2Index.x = ((int)cSettings->NUM_TILES_XAXIS) - 1;
-			i32vec2NumMicroSteps.x = 0;
-		}
-	}
-	else if (eDirection == UP)
-	{
-		if (i32vec2Index.y >= (int)cSettings->NUM_TILES_YAXIS - 1)
-		{
-			i32vec2Index.y = ((int)cSettings->NUM_TILES_YAXIS) - 1;
-			i32vec2NumMicroSteps.y = 0;
-		}
-	}
-	else if (eDirection == DOWN)
-	{
-		if (i32vec2Index.y < 0)
-		{
-			i32vec2Index.y = 0;
-			i32vec2NumMicroSteps.y = 0;
-		}
-	}
-	else
-	{
-		cout << "CEnemy2D::Constraint: Unknown direction." << endl;
-	}
+	CKinematicSolver2D::Constraint(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, GetDirVector(eDirection));
 }
 
 /**
@@ -531,132 +575,13 @@ void CEnemy2D::Constraint(DIRECTION eDirection)
  */
 bool CEnemy2D::CheckPosition(DIRECTION eDirection)
 {
-	if (eDirection == LEFT)
-	{
-		// If the new position is fully within a row, then check this row only
-		if (i32vec2NumMicroSteps.y == 0)
-		{
-			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
-			{
-				return false;
-			}
-		}
-		// If the new position is between 2 rows, then check both rows as well
-		else if (i32vec2NumMicroSteps.y != 0)
-		{
-			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100))
-			{
-				return false;
-			}
-		}
-	}
-	else if (eDirection == RIGHT)
-	{
-		// If the new position is at the top row, then return true
-		if (i32vec2Index.x >= cSettings->NUM_TILES_XAXIS - 1)
-		{
-			i32vec2NumMicroSteps.x = 0;
-			return true;
-		}
-
-		// If the new position is fully within a row, then check this row only
-		if (i32vec2NumMicroSteps.y == 0)
-		{
-			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100)
-			{
-				return false;
-			}
-		}
-		// If the new position is between 2 rows, then check both rows as well
-		else if (i32vec2NumMicroSteps.y != 0)
-		{
-			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
-			{
-				return false;
-			}
-		}
-
-	}
-	else if (eDirection == UP)
-	{
-		// If the new position is at the top row, then return true
-		if (i32vec2Index.y >= cSettings->NUM_TILES_YAXIS - 1)
-		{
-			i32vec2NumMicroSteps.y = 0;
-			return true;
-		}
-
-		// If the new position is fully within a column, then check this column only
-		if (i32vec2NumMicroSteps.x == 0)
-		{
-			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100)
-			{
-				return false;
-			}
-		}
-		// If the new position is between 2 columns, then check both columns as well
-		else if (i32vec2NumMicroSteps.x != 0)
-		{
-			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y + 1, i32vec2Index.x + 1) >= 100))
-			{
-				return false;
-			}
-		}
-	}
-	else if (eDirection == DOWN)
-	{
-		// If the new position is fully within a column, then check this column only
-		if (i32vec2NumMicroSteps.x == 0)
-		{
-			// If the grid is not accessible, then return false
-			if (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100)
-			{
-				return false;
-			}
-		}
-		// If the new position is between 2 columns, then check both columns as well
-		else if (i32vec2NumMicroSteps.x != 0)
-		{
-			// If the 2 grids are not accessible, then return false
-			if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-				(cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + 1) >= 100))
-			{
-				return false;
-			}
-		}
-	}
-	else
-	{
-		cout << "CEnemy2D::CheckPosition: Unknown direction." << endl;
-	}
-
-	return true;
+	return CKinematicSolver2D::CheckPosition(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, GetDirVector(eDirection));
 }
 
 // Check if the enemy2D is in mid-air
 bool CEnemy2D::IsMidAir(void)
 {
-	// if the player is at the bottom row, then he is not in mid-air for sure
-	if (i32vec2Index.y == 0)
-		return false;
-
-	// Check if the tile below the player's current position is empty
-	if ((i32vec2NumMicroSteps.x == 0) &&
-		(cMap2D->GetMapInfo(i32vec2Index.y - 1, i32vec2Index.x) == 0))
-	{
-		return true;
-	}
-
-	return false;
+	return CKinematicSolver2D::IsMidAir(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, cPhysics2D.GetGravityDirection());
 }
 
 // Update Jump or Fall
@@ -781,9 +706,9 @@ bool CEnemy2D::InteractWithPlayer(void)
 		(i32vec2Index.y <= i32vec2PlayerPos.y + 0.5)))
 	{
 		cout << "Gotcha!" << endl;
-		// Since the player has been caught, then reset the FSM
-		sCurrentFSM = IDLE;
-		iFSMCounter = 0;
+		// Since the player has been caught, let the behaviour tree react on the next tick
+		dTimeSinceCaughtPlayer = 0.0;
+		cBehaviourTree.PostEvent(hBehaviourAgent);
 		return true;
 	}
 	return false;
@@ -913,3 +838,19 @@ void CEnemy2D::UpdatePosition(void)
 		}
 	}
 }
+
+/**
+@brief Update position, unless the crowd holds this enemy back to keep it from piling onto another enemy.
+	   A held enemy keeps its direction, so that it moves on when the way is clear.
+*/
+void CEnemy2D::UpdateSteeredPosition(void)
+{
+	const glm::i32vec2 i32vec2Desired = i32vec2Direction;
+	i32vec2Direction = cCrowd2D->Steer(hCrowdAgent, i32vec2Desired);
+
+	UpdatePosition();
+
+	// UpdatePosition may have flipped the direction, so only restore it if this enemy was held back
+	if (i32vec2Direction.x == 0)
+		i32vec2Direction = i32vec2Desired;
+}
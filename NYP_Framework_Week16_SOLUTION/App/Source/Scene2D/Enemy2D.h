@@ -40,7 +40,16 @@ class CMap2D;
 // Include SoundController
 #include "..\SoundController\SoundController.h"
 
-class CEnemy2D : public CEntity2D
+// Include AIScheduler2D
+#include "AIScheduler2D.h"
+
+// Include BehaviourTree2D
+#include "BehaviourTree2D.h"
+
+// Include Crowd2D
+#include "Crowd2D.h"
+
+class CEnemy2D : public CEntity2D, public CBehaviourAgent2D
 {
 public:
 
@@ -93,6 +102,12 @@ public:
 	// Set the handle to cPlayer to this class instance
 	void SetPlayer2D(CPlayer2D* cPlayer2D);
 
+	// Check a condition of the behaviour tree
+	virtual bool CheckCondition(const unsigned int uiConditionID, const float fParam);
+
+	// Run an action of the behaviour tree
+	virtual CBehaviourTree2D::STATUS RunAction(const unsigned int uiActionID, const float fParam, const double dRunningTime);
+
 	// boolean flag to indicate if this enemy is active
 	bool bIsActive;
 
@@ -106,14 +121,30 @@ protected:
 		NUM_DIRECTIONS
 	};
 
-	enum FSM
+	// The conditions of the behaviour tree. The names in arrConditionNames are in the same order
+	enum CONDITION
 	{
-		IDLE = 0,
-		PATROL = 1,
-		ATTACK = 2,
-		NUM_FSM
+		CONDITION_PLAYER_IN_RANGE = 0,
+		CONDITION_CAUGHT_PLAYER,
+		NUM_CONDITIONS
 	};
 
+	// The actions of the behaviour tree. The names in arrActionNames are in the same order
+	enum ACTION
+	{
+		ACTION_IDLE = 0,
+		ACTION_PATROL,
+		ACTION_CHASE,
+		NUM_ACTIONS
+	};
+
+	// The names of the conditions and actions in the behaviour tree's CSV file
+	static const char* const arrConditionNames[NUM_CONDITIONS];
+	static const char* const arrActionNames[NUM_ACTIONS];
+
+	// The behaviour tree, which is shared by all the enemies
+	static CBehaviourTree2D cBehaviourTree;
+
 	ENEMY_TYPE type;
 	float enemySpeed;
 	// Handle to the CPlayer2D
@@ -132,27 +163,11 @@ protected:
 	// Handler to the CMap2D instance
 	CMap2D* cMap2D;
 
-	// A transformation matrix for controlling where to render the entities
-	glm::mat4 transform;
-
-	// The i32vec2 which stores the indices of the enemy2D in the Map2D
-	glm::i32vec2 i32vec2Index;
-
-	// The i32vec2 variable which stores The number of microsteps from the tile indices for the enemy2D. 
-	// A tile's width or height is in multiples of these microsteps
-	glm::i32vec2 i32vec2NumMicroSteps;
-
-	// The vec2 variable which stores the UV coordinates to render the enemy2D
-	glm::vec2 vec2UVCoordinate;
-
 	// The i32vec2 which stores the indices of the destination for enemy2D in the Map2D
 	glm::i32vec2 i32vec2Destination;
 	// The i32vec2 which stores the direction for enemy2D movement in the Map2D
 	glm::i32vec2 i32vec2Direction;
 
-	// Settings
-	CSettings* cSettings;
-
 	// Physics
 	CPhysics2D cPhysics2D;
 
@@ -168,18 +183,36 @@ protected:
 	// Handler to the CSoundController
 	CSoundController* cSoundController;
 
-	// Current FSM
-	FSM sCurrentFSM;
+	// The action which the behaviour tree is running
+	ACTION eCurrentAction;
+
+	// The time since this enemy last caught the player, in seconds
+	double dTimeSinceCaughtPlayer;
+
+	// The handle of this enemy's blackboard in the behaviour tree
+	CBehaviourTree2D::HANDLE hBehaviourAgent;
 
-	// FSM counter - count how many frames it has been in this FSM
-	int iFSMCounter;
+	// Handler to the CCrowd2D instance
+	CCrowd2D* cCrowd2D;
 
-	// Max count in a state
-	const int iMaxFSMCounter = 60;
+	// The handle of this enemy in the crowd
+	CCrowd2D::HANDLE hCrowdAgent;
+
+	// Handler to the CAIScheduler2D instance
+	CAIScheduler2D* cAIScheduler2D;
+
+	// The handle of this enemy in the AI scheduler
+	CAIScheduler2D::HANDLE hAIAgent;
+
+	// Update the destination towards the player, using a path from the AI scheduler
+	void UpdateChase(void);
 
 	// Load a texture
 	bool LoadTexture(const char* filename, GLuint& iTextureID);
 
+	// Get the world direction vector of a direction
+	glm::i32vec2 GetDirVector(DIRECTION eDirection) const;
+
 	// Constraint the enemy2D's position within a boundary
 	void Constraint(DIRECTION eDirection = LEFT);
 
@@ -209,5 +242,8 @@ protected:
 
 	// Update position
 	void UpdatePosition(void);
+
+	// Update position, unless the crowd holds this enemy back
+	void UpdateSteeredPosition(void);
 };
 
@@ -19,16 +19,26 @@ using namespace std;
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
+#include "PhysicsWorld2D.h"
 #include "Primitives/MeshBuilder.h"
 
 // Include Game Manager
 #include "GameManager.h"
 
+// Include the systems which the command buffers are applied to
+#include "ParticleSystem2D.h"
+#include "TileLighting2D.h"
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CEntityManager2D::CEntityManager2D(void)
-	: cMap2D(NULL)
+	: uiNumAwakeEntities(0)
+	, uiNumAsleepEntities(0)
+	, cComponentStore2D(NULL)
+	, bParallelUpdate(true)
+	, cWorkerPool(NULL)
+	, cMap2D(NULL)
 	, cKeyboardController(NULL)
 	, cInventoryManager(NULL)
 	, cInventoryItem(NULL)
@@ -75,15 +85,46 @@ bool CEntityManager2D::Init(void)
 		entities.push_back(nullptr);
 	}
 
+	// Reserve the component pools for all the entity slots
+	cComponentStore2D = CComponentStore2D::GetInstance();
+	cComponentStore2D->Init((unsigned int)entities.size());
+	vCollisionPairs.reserve(entities.size());
+
+	// Create a command buffer for each worker thread
+	cWorkerPool = CWorkerPool::GetInstance();
+	vParallelEntities.reserve(entities.size());
+	vCommandBuffers.resize(cWorkerPool->GetNumThreads());
+	for (auto& buffer : vCommandBuffers)
+		buffer.Reserve(64);
+
+	// Create the bombs and their shared resources up front, so that spawning a bomb does not allocate
+	if (CBomb2D::InitSharedResources() == false)
+	{
+		cout << "Failed to initialise the bomb resources" << endl;
+		return false;
+	}
+	cBombPool.Init(uiMaxNumBombs);
 
 	return true;
 }
 
 /**
- @brief Update this instance
+ @brief Update this instance. All the entities are moved first, and then the collisions are resolved
+		against their final positions in this frame. This differs from the old order, where each entity
+		tested for collisions right after its own update, against entities which may not have moved yet.
+		Every pair is now reported once per frame, and the result does not depend on the order of the entities.
  */
 void CEntityManager2D::Update(const double dElapsedTime)
 {
+	// Wake up entities whose resting tiles were changed since the last frame
+	WakeEntitiesOnModifiedTiles();
+
+	// Integrate the bodies which are stepped by the physics world, such as the bombs, in one batch
+	CPhysicsWorld2D::GetInstance()->Step((float)dElapsedTime);
+
+	uiNumAwakeEntities = 0;
+	uiNumAsleepEntities = 0;
+	vParallelEntities.clear();
 
 	std::vector<CEntity2D*>::iterator it;
 	for (it = entities.begin(); it != entities.end(); ++it)
@@ -91,47 +132,267 @@ void CEntityManager2D::Update(const double dElapsedTime)
 		if ((*it) == nullptr) continue;
 		if ((*it)->dead)
 		{
-			delete (*it);
+			DestroyEntity(*it);
 			(*it) = nullptr;
 			continue;
 		}
 
+		// Sleeping entities are not updated and do not test for collisions.
+		// They are woken up when an awake entity collides with them.
+		if ((*it)->IsAsleep())
+		{
+			uiNumAsleepEntities++;
+			continue;
+		}
+		uiNumAwakeEntities++;
+
+		// Parallel safe entities are updated after the others, on the worker threads
+		if ((*it)->IsParallelSafe())
+		{
+			vParallelEntities.push_back(*it);
+			continue;
+		}
+
 		(*it)->Update(dElapsedTime);
+	}
+
+	// Update the parallel safe entities and commit their changes
+	UpdateParallelEntities(dElapsedTime);
+
+	// Run the systems over the component pools
+	cComponentStore2D->Gather();
+	cComponentStore2D->UpdateTransforms();
+	cComponentStore2D->Scatter();
+
+	//Collision: Resolved in one batch after all the entities have moved
+	cComponentStore2D->DetectCollisions(vCollisionPairs);
+	for (auto& pair : vCollisionPairs)
+	{
+		CEntity2D* entity = cComponentStore2D->GetOwner(pair.uiFirst);
+		CEntity2D* coll = cComponentStore2D->GetOwner(pair.uiSecond);
+
+		// Skip the pairs where an entity was killed by an earlier collision in this frame
+		if (entity->dead || coll->dead)
+			continue;
+
+		//Collision Detected
+		if (coll->IsAsleep())
+			coll->Wake();
+		coll->CollidedWith(entity);
+		entity->CollidedWith(coll);
+	}
+
+	// Put the entities to sleep if they have been at rest for long enough
+	for (auto& entity : entities)
+	{
+		if (entity != nullptr && !entity->dead && !entity->IsAsleep())
+			entity->UpdateSleepState(uiFramesBeforeSleep);
+	}
+}
 
-		//Collision
-		for (auto& coll : entities)
+/**
+ @brief Update the parallel safe entities in two phases.
+		Simulate: The entities are split into contiguous ranges, one for each worker thread. 
+				  They only change their own state, and record other changes into their thread's command buffer.
+		Commit: The command buffers are applied on this thread in the order of the threads. 
+				The ranges are in ascending order of the threads, so the changes are applied in the order of
+				the entities' slots, and the result is the same for any number of threads.
+ */
+void CEntityManager2D::UpdateParallelEntities(const double dElapsedTime)
+{
+	if (vParallelEntities.empty())
+		return;
+
+	// The worker pool may have been re-initialised with more threads
+	if (vCommandBuffers.size() < cWorkerPool->GetNumThreads())
+		vCommandBuffers.resize(cWorkerPool->GetNumThreads());
+
+	// Simulate
+	cWorkerPool->ParallelFor((unsigned int)vParallelEntities.size(),
+		[this, dElapsedTime](const unsigned int uiBegin, const unsigned int uiEnd, const unsigned int uiThread)
 		{
-			if (coll != nullptr && coll != (*it))
+			CCommandBuffer2D::SetCurrent(&vCommandBuffers[uiThread]);
+			for (unsigned int i = uiBegin; i < uiEnd; i++)
 			{
-				float entity_x = (*it)->i32vec2Index.x + (*it)->i32vec2NumMicroSteps.x * 0.25f;
-				float entity_y = (*it)->i32vec2Index.y + (*it)->i32vec2NumMicroSteps.y * 0.25f;
-				float coll_x = coll->i32vec2Index.x + coll->i32vec2NumMicroSteps.x * 0.25f;
-				float coll_y = coll->i32vec2Index.y + coll->i32vec2NumMicroSteps.y * 0.25f;
-				float width = 1.0f;
-				if (entity_x <= coll_x + width &&
-					entity_x + width > coll_x &&
-					entity_y <= coll_y + width &&
-					entity_y + width > coll_y)
+				vParallelEntities[i]->Update(dElapsedTime);
+			}
+			CCommandBuffer2D::SetCurrent(NULL);
+		},
+		bParallelUpdate ? 0 : 1);
+
+	// Commit
+	for (auto& buffer : vCommandBuffers)
+	{
+		buffer.Commit(ApplyCommand);
+	}
+}
+
+/**
+ @brief Apply a command from a command buffer to the system which it changes
+ @param sCommand A const CCommandBuffer2D::Command& variable containing the command
+ */
+void CEntityManager2D::ApplyCommand(const CCommandBuffer2D::Command& sCommand)
+{
+	switch (sCommand.eType)
+	{
+	case CCommandBuffer2D::SET_MAP_INFO:
+		CMap2D::GetInstance()->SetMapInfo(sCommand.iArguments[0], sCommand.iArguments[1], sCommand.iArguments[2]);
+		break;
+	case CCommandBuffer2D::PLAY_SOUND:
+		CSoundController::GetInstance()->PlaySoundByID(sCommand.iArguments[0]);
+		break;
+	case CCommandBuffer2D::ADD_INVENTORY_ITEM:
+		CInventoryManager::GetInstance()->GetItem(sCommand.pcName)->Add(sCommand.iArguments[0]);
+		break;
+	case CCommandBuffer2D::REMOVE_INVENTORY_ITEM:
+		CInventoryManager::GetInstance()->GetItem(sCommand.pcName)->Remove(sCommand.iArguments[0]);
+		break;
+	case CCommandBuffer2D::SPAWN_BOMB:
+		CEntityManager2D::GetInstance()->SpawnBomb((CPhysics2D::GRAVITY_DIRECTION)sCommand.iArguments[0],
+													sCommand.iArguments[1],
+													sCommand.iArguments[2]);
+		break;
+	case CCommandBuffer2D::EMIT_PARTICLES:
+		CParticleSystem2D::GetInstance()->Emit(sCommand.iArguments[0],
+												glm::vec2(sCommand.iArguments[1], sCommand.iArguments[2]));
+		break;
+	case CCommandBuffer2D::ADD_LIGHT_FLASH:
+		CTileLighting2D::GetInstance()->AddFlash(sCommand.iArguments[0], sCommand.iArguments[1], sCommand.iArguments[2]);
+		break;
+	default:
+		cout << "CEntityManager2D::ApplyCommand: Unknown command." << endl;
+		break;
+	}
+}
+
+/**
+ @brief Set if the parallel safe entities are updated on the worker threads, or serially on the main thread.
+		Both modes give the same results.
+ */
+void CEntityManager2D::SetParallelUpdate(const bool bParallelUpdate)
+{
+	this->bParallelUpdate = bParallelUpdate;
+}
+
+/**
+ @brief Get if the parallel safe entities are updated on the worker threads
+ */
+bool CEntityManager2D::GetParallelUpdate(void) const
+{
+	return bParallelUpdate;
+}
+
+/**
+ @brief Wake up the sleeping entities which are resting on tiles modified in the map
+ */
+void CEntityManager2D::WakeEntitiesOnModifiedTiles(void)
+{
+	if (cMap2D->IsLevelChanged())
+	{
+		WakeAllEntities();
+	}
+	else if (cMap2D->GetModifiedTiles().size() > 0)
+	{
+		const std::vector<glm::i32vec2>& vModifiedTiles = cMap2D->GetModifiedTiles();
+		for (auto& entity : entities)
+		{
+			if (entity == nullptr || !entity->IsAsleep())
+				continue;
+
+			glm::i32vec2 i32vec2RestingTile = entity->GetRestingTile();
+			for (auto& tile : vModifiedTiles)
+			{
+				if (tile == i32vec2RestingTile)
 				{
-					//Collision Detected
-					coll->CollidedWith((*it));
-					(*it)->CollidedWith(coll);
+					entity->Wake();
+					break;
 				}
 			}
 		}
 	}
+
+	cMap2D->ClearModifiedTiles();
+}
+
+/**
+ @brief Wake up all sleeping entities, e.g. when the gravity has changed
+ */
+void CEntityManager2D::WakeAllEntities(void)
+{
+	for (auto& entity : entities)
+	{
+		if (entity != nullptr && entity->IsAsleep())
+			entity->Wake();
+	}
+}
+
+/**
+ @brief Get the number of awake entities in the last frame
+ */
+unsigned int CEntityManager2D::GetNumAwakeEntities(void) const
+{
+	return uiNumAwakeEntities;
+}
+
+/**
+ @brief Get the number of sleeping entities in the last frame
+ */
+unsigned int CEntityManager2D::GetNumAsleepEntities(void) const
+{
+	return uiNumAsleepEntities;
 }
 
-void CEntityManager2D::AddEntity(CEntity2D* entity)
+bool CEntityManager2D::AddEntity(CEntity2D* entity)
 {
 	for (auto& tE : entities) {
 		if (tE == nullptr) {
 			tE = entity;
-			break;
+			cComponentStore2D->Create(entity);
+			return true;
 		}
 	}
+	return false;
 }
 
+/**
+ @brief Spawn a bomb from the bomb pool
+ @param eGravityDirection The gravity direction which the bomb will fall towards
+ @param iIndex_XAxis A const int variable containing the column to spawn the bomb at
+ @param iIndex_YAxis A const int variable containing the row to spawn the bomb at
+ */
+CBomb2D* CEntityManager2D::SpawnBomb(CPhysics2D::GRAVITY_DIRECTION eGravityDirection, const int iIndex_XAxis, const int iIndex_YAxis)
+{
+	CBomb2D* cBomb2D = cBombPool.Acquire();
+	if (cBomb2D == NULL)
+		return NULL;
+
+	cBomb2D->Init(eGravityDirection, iIndex_XAxis, iIndex_YAxis);
+	if (AddEntity(cBomb2D) == false)
+	{
+		cBombPool.Release(cBomb2D);
+		return NULL;
+	}
+	return cBomb2D;
+}
+
+/**
+ @brief Delete an entity, or return it to its pool if it is pooled
+ */
+void CEntityManager2D::DestroyEntity(CEntity2D* cEntity2D)
+{
+	if (cEntity2D->uiComponentHandle != CComponentStore2D::INVALID_HANDLE)
+		cComponentStore2D->Destroy(cEntity2D->uiComponentHandle);
+
+	if (cEntity2D->GetOwnerPool())
+		cEntity2D->GetOwnerPool()->Release(cEntity2D);
+	else
+		delete cEntity2D;
+}
+
+/**
+ @brief Render the entities. The entities which add themselves to the sprite batch, such as the bombs,
+		are drawn when the caller submits and executes the batch
+ */
 void CEntityManager2D::RenderEntities()
 {
 	for (auto& entity : entities)
@@ -145,16 +406,34 @@ void CEntityManager2D::RenderEntities()
 	}
 }
 
+/**
+ @brief Store the transforms of the entities at the end of a simulation step, for interpolating the rendering
+ */
+void CEntityManager2D::StoreRenderTransforms(void)
+{
+	for (auto& entity : entities)
+	{
+		if (entity != nullptr && !entity->dead)
+		{
+			entity->StoreRenderTransform();
+		}
+	}
+}
+
 void CEntityManager2D::Exit()
 {
 	for (auto& entity : entities)
 	{
 		if (entity)
 		{
-			delete entity;
+			DestroyEntity(entity);
 			entity = nullptr;
 		}
 	}
+
+	// Delete the pooled bombs and their shared resources
+	cBombPool.Destroy();
+	CBomb2D::DestroySharedResources();
 }
 
 
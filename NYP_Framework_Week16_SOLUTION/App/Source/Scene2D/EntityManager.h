@@ -43,6 +43,21 @@ class CMap2D;
 // Include SoundController
 #include "..\SoundController\SoundController.h"
 
+// Include EntityPool2D
+#include "Primitives/EntityPool2D.h"
+
+// Include Bomb2D
+#include "Bomb2D.h"
+
+// Include ComponentStore2D
+#include "ComponentStore2D.h"
+
+// Include CommandBuffer2D
+#include "CommandBuffer2D.h"
+
+// Include WorkerPool
+#include "System\WorkerPool.h"
+
 
 class CEntityManager2D : public CSingletonTemplate<CEntityManager2D>
 {
@@ -57,10 +72,74 @@ public:
 
 	void RenderEntities();
 
-	void AddEntity(CEntity2D*);
+	// Store the transforms of the entities at the end of a simulation step, for interpolating the rendering
+	void StoreRenderTransforms(void);
+
+	// Add an entity. Returns false if there is no free slot for it
+	bool AddEntity(CEntity2D*);
+
+	// Spawn a bomb from the bomb pool. Returns NULL if there is no free bomb
+	CBomb2D* SpawnBomb(CPhysics2D::GRAVITY_DIRECTION eGravityDirection, const int iIndex_XAxis, const int iIndex_YAxis);
+
+	// Wake up all sleeping entities, e.g. when the gravity has changed
+	void WakeAllEntities(void);
+
+	// Set if the parallel safe entities are updated on the worker threads, or serially on the main thread
+	void SetParallelUpdate(const bool bParallelUpdate);
+
+	// Get if the parallel safe entities are updated on the worker threads
+	bool GetParallelUpdate(void) const;
+
+	// Get the number of awake entities in the last frame
+	unsigned int GetNumAwakeEntities(void) const;
+
+	// Get the number of sleeping entities in the last frame
+	unsigned int GetNumAsleepEntities(void) const;
 
 	void Exit(void);
 protected:
+	// The number of frames an entity must be at rest before it is put to sleep
+	const unsigned int uiFramesBeforeSleep = 30;
+
+	// The number of awake and sleeping entities in the last frame
+	unsigned int uiNumAwakeEntities;
+	unsigned int uiNumAsleepEntities;
+
+	// Wake up the sleeping entities which are resting on tiles modified in the map
+	void WakeEntitiesOnModifiedTiles(void);
+
+	// The maximum number of bombs which can be alive at the same time
+	const unsigned int uiMaxNumBombs = 32;
+
+	// The pool of bombs
+	CEntityPool2D<CBomb2D> cBombPool;
+
+	// Delete an entity, or return it to its pool if it is pooled
+	void DestroyEntity(CEntity2D* cEntity2D);
+
+	// The component store which holds the hot state of the entities
+	CComponentStore2D* cComponentStore2D;
+
+	// The colliding pairs found in this frame
+	std::vector<CComponentStore2D::CollisionPair> vCollisionPairs;
+
+	// Boolean flag to indicate if the parallel safe entities are updated on the worker threads
+	bool bParallelUpdate;
+
+	// The awake entities which are parallel safe, in the order of their slots
+	std::vector<CEntity2D*> vParallelEntities;
+
+	// One command buffer for each worker thread
+	std::vector<CCommandBuffer2D> vCommandBuffers;
+
+	// The worker threads
+	CWorkerPool* cWorkerPool;
+
+	// Simulate the parallel safe entities and commit their command buffers
+	void UpdateParallelEntities(const double dElapsedTime);
+
+	// Apply a command from a command buffer to the system which it changes
+	static void ApplyCommand(const CCommandBuffer2D::Command& sCommand);
 
 	//Collider Codes - To be moved into Collider singleton class when have time
 	std::vector<CEntity2D*> entities;
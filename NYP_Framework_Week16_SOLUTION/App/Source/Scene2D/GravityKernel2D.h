@@ -0,0 +1,118 @@
+/**
+ CGravityKernel2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include Physics2D for the gravity directions
+#include "Physics2D.h"
+
+// Include TileGrid2D
+#include "TileGrid2D.h"
+
+/**
+ GravityTraits2D: The axis which gravity acts along, and the sign of UP along that axis,
+				  for each gravity direction. These are resolved at compile time.
+ */
+template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+struct GravityTraits2D;
+
+template<>
+struct GravityTraits2D<CPhysics2D::GRAVITY_DOWN>
+{
+	// The axis which gravity acts along. 0 is the x-axis and 1 is the y-axis
+	static const int AXIS = 1;
+	// The sign of UP along the axis
+	static const int UP_SIGN = 1;
+};
+
+template<>
+struct GravityTraits2D<CPhysics2D::GRAVITY_UP>
+{
+	// The axis which gravity acts along. 0 is the x-axis and 1 is the y-axis
+	static const int AXIS = 1;
+	// The sign of UP along the axis
+	static const int UP_SIGN = -1;
+};
+
+template<>
+struct GravityTraits2D<CPhysics2D::GRAVITY_RIGHT>
+{
+	// The axis which gravity acts along. 0 is the x-axis and 1 is the y-axis
+	static const int AXIS = 0;
+	// The sign of UP along the axis
+	static const int UP_SIGN = -1;
+};
+
+template<>
+struct GravityTraits2D<CPhysics2D::GRAVITY_LEFT>
+{
+	// The axis which gravity acts along. 0 is the x-axis and 1 is the y-axis
+	static const int AXIS = 0;
+	// The sign of UP along the axis
+	static const int UP_SIGN = 1;
+};
+
+/**
+ CGravityKernel2D: The parts of jumping and falling which depend on the gravity direction.
+				   An entity instantiates its jump and fall update once per gravity direction,
+				   and picks the instance from a table once per frame,
+				   so the axis, sign and comparisons below are constants in each instance.
+ */
+template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+class CGravityKernel2D
+{
+public:
+	// The axis which gravity acts along. 0 is the x-axis and 1 is the y-axis
+	static const int AXIS = GravityTraits2D<eGravityDirection>::AXIS;
+	// The sign of UP along the axis
+	static const int UP_SIGN = GravityTraits2D<eGravityDirection>::UP_SIGN;
+
+	// Get the world vector for UP
+	static glm::i32vec2 GetUpVector(void)
+	{
+		return glm::i32vec2(AXIS == 0 ? UP_SIGN : 0, AXIS == 1 ? UP_SIGN : 0);
+	}
+
+	// Get the world vector for DOWN
+	static glm::i32vec2 GetDownVector(void)
+	{
+		return -GetUpVector();
+	}
+
+	// Get the number of microsteps per tile along the axis
+	static float GetNumStepsPerTile(const float fNumStepsPerTile_XAxis, const float fNumStepsPerTile_YAxis)
+	{
+		return (AXIS == 0) ? fNumStepsPerTile_XAxis : fNumStepsPerTile_YAxis;
+	}
+
+	// Translate the displacement along the axis from screen space into a number of tiles.
+	// A partial tile is rounded up if its microsteps are positive, or if they are not zero when bRoundAnyPartialTile is true.
+	static int DisplacementToTiles(	const glm::vec2& v2Displacement,
+									const float fTileHeight,
+									const float fWindowHeight,
+									const float fNumStepsPerTile,
+									const bool bRoundAnyPartialTile)
+	{
+		const float fDisplacement = v2Displacement[AXIS];
+		int iDisplacement = (int)(fDisplacement / fTileHeight);
+		int iDisplacement_MicroSteps = (int)((fDisplacement * fWindowHeight) - iDisplacement) / (int)fNumStepsPerTile;
+		if ((iDisplacement_MicroSteps > 0) || (bRoundAnyPartialTile && (iDisplacement_MicroSteps != 0)))
+		{
+			iDisplacement++;
+		}
+		return iDisplacement;
+	}
+
+	// Check if a position is on the bottom row
+	static bool IsOnBottomRow(const TileGridView2D& sGrid, const glm::i32vec2& i32vec2Index)
+	{
+		if (UP_SIGN > 0)
+			return (i32vec2Index[AXIS] <= 0);
+		return (i32vec2Index[AXIS] >= ((AXIS == 0) ? sGrid.iNumCols : sGrid.iNumRows) - 1);
+	}
+};
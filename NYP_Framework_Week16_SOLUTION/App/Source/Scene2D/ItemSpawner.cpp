@@ -17,6 +17,9 @@ using namespace std;
 // Include Math
 #include "System/MyMath.h"
 
+// Include Random
+#include "System\Random.h"
+
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
 #include "Primitives/MeshBuilder.h"
@@ -72,7 +75,7 @@ bool CItemSpawner2D::Init(void)
 
 	SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::BOMB_SMALL, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
 
-	if (Math::RandIntMinMax(0, 1) == 0)
+	if (CRandomStreams::GetInstance()->GetStream(CRandomStreams::STREAM_SPAWNING).RandIntMinMax(0, 1) == 0)
 	{
 		SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::POWERUP_DOUBLEJUMP, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
 
@@ -111,7 +114,7 @@ void CItemSpawner2D::SpawnObjectOnRandomPlatform(CMap2D::TILE_ID type, glm::vec2
 			}
 		}
 	}
-	CCoord2D* selected = spaceToSpawn.at(Math::RandIntMinMax(0, spaceToSpawn.size() - 1));
+	CCoord2D* selected = spaceToSpawn.at(CRandomStreams::GetInstance()->GetStream(CRandomStreams::STREAM_SPAWNING).RandIntMinMax(0, spaceToSpawn.size() - 1));
 	cMap2D->SetMapInfo(selected->y, selected->x, type);
 
 	for (int i = 0; i < spaceToSpawn.size(); ++i)
@@ -0,0 +1,387 @@
+/**
+ CKinematicSolver2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "KinematicSolver2D.h"
+
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+/**
+ @brief Get the world direction vector of a direction which is relative to a gravity direction.
+		UP is against gravity, DOWN is along gravity, and RIGHT is UP rotated clockwise.
+ @param eGravityDirection A const CPhysics2D::GRAVITY_DIRECTION variable containing the gravity direction
+ @param eDirection A const CPhysics2D::DIRECTION variable containing the relative direction
+ */
+glm::i32vec2 CKinematicSolver2D::GetDirVector(	const CPhysics2D::GRAVITY_DIRECTION eGravityDirection,
+												const CPhysics2D::DIRECTION eDirection)
+{
+	// The world vectors for UP, DOWN, LEFT and RIGHT, for each gravity direction
+	static const glm::i32vec2 arrDirVectors[CPhysics2D::GRAVITY_COUNT][CPhysics2D::NUM_DIRECTIONS] = {
+		// GRAVITY_DOWN
+		{ glm::i32vec2(0, 1), glm::i32vec2(0, -1), glm::i32vec2(-1, 0), glm::i32vec2(1, 0) },
+		// GRAVITY_UP
+		{ glm::i32vec2(0, -1), glm::i32vec2(0, 1), glm::i32vec2(1, 0), glm::i32vec2(-1, 0) },
+		// GRAVITY_RIGHT
+		{ glm::i32vec2(-1, 0), glm::i32vec2(1, 0), glm::i32vec2(0, -1), glm::i32vec2(0, 1) },
+		// GRAVITY_LEFT
+		{ glm::i32vec2(1, 0), glm::i32vec2(-1, 0), glm::i32vec2(0, 1), glm::i32vec2(0, -1) }
+	};
+
+	if ((eGravityDirection >= CPhysics2D::GRAVITY_COUNT) || (eDirection >= CPhysics2D::NUM_DIRECTIONS))
+		return glm::i32vec2(0);
+
+	return arrDirVectors[eGravityDirection][eDirection];
+}
+
+/**
+ @brief Constraint a position within the grid when moving in a direction
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param i32vec2Index A glm::i32vec2& variable containing the position to constraint
+ @param i32vec2NumMicroSteps A glm::i32vec2& variable containing the microsteps, which are cleared when constrained
+ @param i32vec2Dir A const glm::i32vec2& variable containing the world direction of the movement
+ @return true if the position was constrained
+ */
+bool CKinematicSolver2D::Constraint(const TileGridView2D& sGrid,
+									glm::i32vec2& i32vec2Index,
+									glm::i32vec2& i32vec2NumMicroSteps,
+									const glm::i32vec2& i32vec2Dir)
+{
+	if (i32vec2Dir.x == -1)
+	{
+		if (i32vec2Index.x <= 0)
+		{
+			i32vec2Index.x = 0;
+			i32vec2NumMicroSteps.x = 0;
+			return true;
+		}
+	}
+	else if (i32vec2Dir.x == 1)
+	{
+		if (i32vec2Index.x >= sGrid.iNumCols - 1)
+		{
+			i32vec2Index.x = sGrid.iNumCols - 1;
+			i32vec2NumMicroSteps.x = 0;
+			return true;
+		}
+	}
+	else if (i32vec2Dir.y == 1)
+	{
+		if (i32vec2Index.y >= sGrid.iNumRows - 1)
+		{
+			i32vec2Index.y = sGrid.iNumRows - 1;
+			i32vec2NumMicroSteps.y = 0;
+			return true;
+		}
+	}
+	else if (i32vec2Dir.y == -1)
+	{
+		if (i32vec2Index.y <= 0)
+		{
+			i32vec2Index.y = 0;
+			i32vec2NumMicroSteps.y = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ @brief Check if a position is possible to move into when moving in a direction.
+		Only the tiles on the leading side of the AABB are checked.
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param i32vec2Index A const glm::i32vec2& variable containing the position to check
+ @param i32vec2NumMicroSteps A glm::i32vec2& variable containing the microsteps, which are cleared if outside the grid
+ @param i32vec2Dir A const glm::i32vec2& variable containing the world direction of the movement
+ */
+bool CKinematicSolver2D::CheckPosition(	const TileGridView2D& sGrid,
+										const glm::i32vec2& i32vec2Index,
+										glm::i32vec2& i32vec2NumMicroSteps,
+										const glm::i32vec2& i32vec2Dir)
+{
+	// The next column and row which the AABB overlaps, if it has microsteps on that axis
+	const int iNextCol = i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0);
+	const int iNextRow = i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0);
+
+	if (i32vec2Dir.x == -1)
+	{
+		if (i32vec2Index.x < 0)
+		{
+			i32vec2NumMicroSteps.x = 0;
+			return false;
+		}
+		// Check the left column, in both rows if the position is between 2 rows
+		if ((sGrid.GetValue(i32vec2Index.x, i32vec2Index.y) >= BLOCKING_TILE) ||
+			(sGrid.GetValue(i32vec2Index.x, iNextRow) >= BLOCKING_TILE))
+			return false;
+	}
+	else if (i32vec2Dir.x == 1)
+	{
+		if (i32vec2Index.x >= sGrid.iNumCols)
+		{
+			i32vec2NumMicroSteps.x = 0;
+			return false;
+		}
+		// Check the right column, in both rows if the position is between 2 rows
+		if ((sGrid.GetValue(iNextCol, i32vec2Index.y) >= BLOCKING_TILE) ||
+			(sGrid.GetValue(iNextCol, iNextRow) >= BLOCKING_TILE))
+			return false;
+	}
+	else if (i32vec2Dir.y == 1)
+	{
+		if (i32vec2Index.y >= sGrid.iNumRows)
+		{
+			i32vec2NumMicroSteps.y = 0;
+			return false;
+		}
+		// Check the upper row, in both columns if the position is between 2 columns
+		if ((sGrid.GetValue(i32vec2Index.x, iNextRow) >= BLOCKING_TILE) ||
+			(sGrid.GetValue(iNextCol, iNextRow) >= BLOCKING_TILE))
+			return false;
+	}
+	else if (i32vec2Dir.y == -1)
+	{
+		if (i32vec2Index.y < 0)
+		{
+			i32vec2NumMicroSteps.y = 0;
+			return false;
+		}
+		// Check the lower row, in both columns if the position is between 2 columns
+		if ((sGrid.GetValue(i32vec2Index.x, i32vec2Index.y) >= BLOCKING_TILE) ||
+			(sGrid.GetValue(iNextCol, i32vec2Index.y) >= BLOCKING_TILE))
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ @brief Check if a position is on the bottom row for a gravity direction
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param i32vec2Index A const glm::i32vec2& variable containing the position to check
+ @param eGravityDirection A const CPhysics2D::GRAVITY_DIRECTION variable containing the gravity direction
+ */
+bool CKinematicSolver2D::IsOnBottomRow(	const TileGridView2D& sGrid,
+										const glm::i32vec2& i32vec2Index,
+										const CPhysics2D::GRAVITY_DIRECTION eGravityDirection)
+{
+	switch (eGravityDirection)
+	{
+	case CPhysics2D::GRAVITY_DOWN:
+		return (i32vec2Index.y <= 0);
+	case CPhysics2D::GRAVITY_UP:
+		return (i32vec2Index.y >= sGrid.iNumRows - 1);
+	case CPhysics2D::GRAVITY_LEFT:
+		return (i32vec2Index.x <= 0);
+	case CPhysics2D::GRAVITY_RIGHT:
+		return (i32vec2Index.x >= sGrid.iNumCols - 1);
+	default:
+		break;
+	}
+	return false;
+}
+
+/**
+ @brief Check if a position is on the top row for a gravity direction
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param i32vec2Index A const glm::i32vec2& variable containing the position to check
+ @param eGravityDirection A const CPhysics2D::GRAVITY_DIRECTION variable containing the gravity direction
+ */
+bool CKinematicSolver2D::IsOnTopRow(const TileGridView2D& sGrid,
+									const glm::i32vec2& i32vec2Index,
+									const CPhysics2D::GRAVITY_DIRECTION eGravityDirection)
+{
+	switch (eGravityDirection)
+	{
+	case CPhysics2D::GRAVITY_DOWN:
+		return (i32vec2Index.y == sGrid.iNumRows - 1);
+	case CPhysics2D::GRAVITY_UP:
+		return (i32vec2Index.y == 0);
+	case CPhysics2D::GRAVITY_LEFT:
+		return (i32vec2Index.x == sGrid.iNumCols - 1);
+	case CPhysics2D::GRAVITY_RIGHT:
+		return (i32vec2Index.x == 0);
+	default:
+		break;
+	}
+	return false;
+}
+
+/**
+ @brief Check if a position is in mid-air for a gravity direction,
+		which is when it is aligned to a tile and the tile below it does not support it.
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param i32vec2Index A const glm::i32vec2& variable containing the position to check
+ @param i32vec2NumMicroSteps A const glm::i32vec2& variable containing the microsteps
+ @param eGravityDirection A const CPhysics2D::GRAVITY_DIRECTION variable containing the gravity direction
+ */
+bool CKinematicSolver2D::IsMidAir(	const TileGridView2D& sGrid,
+									const glm::i32vec2& i32vec2Index,
+									const glm::i32vec2& i32vec2NumMicroSteps,
+									const CPhysics2D::GRAVITY_DIRECTION eGravityDirection)
+{
+	// If the position is at the bottom row, then it is not in mid-air for sure
+	if (IsOnBottomRow(sGrid, i32vec2Index, eGravityDirection))
+		return false;
+
+	// Check if the tile below the current position is empty
+	glm::i32vec2 i32vec2Below = i32vec2Index + GetDirVector(eGravityDirection, CPhysics2D::DOWN);
+	if (((i32vec2NumMicroSteps.x == 0) || (i32vec2NumMicroSteps.y == 0)) &&
+		(sGrid.GetValue(i32vec2Below.x, i32vec2Below.y) <= HIGHEST_NON_SUPPORTING_TILE))
+	{
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ @brief Sweep an AABB through the tiles using a grid traversal (Amanatides and Woo), 
+		and find the first blocking tile and the interactable tiles which are crossed.
+		The tiles are in column and inverted row, the same as the entities' indices, and each tile is 1 unit wide.
+		The tiles which the AABB overlaps at the start are checked for blocking tiles too.
+		Only the tiles which are entered along the way are reported as interactables.
+		When the AABB crosses into a column and a row at the same time, such as on an exact diagonal,
+		the tile which it enters through the corner is checked too.
+		The cost is proportional to the number of tiles crossed.
+ @param sGrid A const TileGridView2D& variable containing the tiles
+ @param vec2Min A const glm::vec2& variable containing the minimum corner of the AABB, in tiles
+ @param vec2Size A const glm::vec2& variable containing the size of the AABB, in tiles
+ @param vec2Displacement A const glm::vec2& variable containing the displacement of the AABB, in tiles
+ @param sResult A SweepResult& variable to store the result in
+ @return true if a blocking tile was hit
+ */
+bool CKinematicSolver2D::SweepAABB(const TileGridView2D& sGrid,
+									const glm::vec2& vec2Min,
+									const glm::vec2& vec2Size,
+									const glm::vec2& vec2Displacement,
+									SweepResult& sResult)
+{
+	// A small value so that an AABB which touches a tile boundary does not overlap the next tile
+	const float fEpsilon = 0.0001f;
+
+	sResult.bHit = false;
+	sResult.fTime = 1.0f;
+	sResult.vec2Position = vec2Min + vec2Displacement;
+	sResult.uiNumInteractables = 0;
+
+	// Check the tiles in [iColStart, iColEnd] x [iRowStart, iRowEnd]. Returns true if a blocking tile is found
+	auto CheckTiles = [&](int iColStart, int iColEnd, int iRowStart, int iRowEnd, bool bReportInteractables) -> bool
+	{
+		for (int iRow = iRowStart; iRow <= iRowEnd; iRow++)
+		{
+			for (int iCol = iColStart; iCol <= iColEnd; iCol++)
+			{
+				unsigned int uiValue = sGrid.GetValue(iCol, iRow);
+				if (uiValue >= BLOCKING_TILE)
+				{
+					sResult.bHit = true;
+					sResult.i32vec2HitTile = glm::i32vec2(iCol, iRow);
+					return true;
+				}
+				if (bReportInteractables &&
+					(uiValue > INTERACTABLES_START) && (uiValue <= INTERACTABLES_END) &&
+					(sResult.uiNumInteractables < MAX_SWEEP_INTERACTABLES))
+				{
+					sResult.i32vec2Interactables[sResult.uiNumInteractables++] = glm::i32vec2(iCol, iRow);
+				}
+			}
+		}
+		return false;
+	};
+
+	// Check the tiles which the AABB overlaps at the start
+	glm::vec2 vec2Max = vec2Min + vec2Size;
+	if (CheckTiles(	(int)floor(vec2Min.x), (int)ceil(vec2Max.x - fEpsilon) - 1,
+					(int)floor(vec2Min.y), (int)ceil(vec2Max.y - fEpsilon) - 1, false))
+	{
+		sResult.fTime = 0.0f;
+		sResult.vec2Position = vec2Min;
+		return true;
+	}
+
+	// Set up the traversal of the leading edges of the AABB
+	int iStepX = (vec2Displacement.x > 0.0f) ? 1 : ((vec2Displacement.x < 0.0f) ? -1 : 0);
+	int iStepY = (vec2Displacement.y > 0.0f) ? 1 : ((vec2Displacement.y < 0.0f) ? -1 : 0);
+
+	// The current tile of the leading edge on each axis
+	int iLeadX = (iStepX > 0) ? (int)ceil(vec2Max.x - fEpsilon) - 1 : (int)floor(vec2Min.x);
+	int iLeadY = (iStepY > 0) ? (int)ceil(vec2Max.y - fEpsilon) - 1 : (int)floor(vec2Min.y);
+
+	// The time at which the leading edge crosses into the next tile, and the time between tiles.
+	// A tile is only entered if the leading edge moves past its boundary before the end of the sweep
+	float fMaxX = 2.0f, fDeltaX = 0.0f, fEndX = 0.0f;
+	float fMaxY = 2.0f, fDeltaY = 0.0f, fEndY = 0.0f;
+	if (iStepX != 0)
+	{
+		fDeltaX = 1.0f / fabs(vec2Displacement.x);
+		fMaxX = (iStepX > 0) ? ((iLeadX + 1) - vec2Max.x) * fDeltaX : (vec2Min.x - iLeadX) * fDeltaX;
+		fEndX = 1.0f - fEpsilon * fDeltaX;
+	}
+	if (iStepY != 0)
+	{
+		fDeltaY = 1.0f / fabs(vec2Displacement.y);
+		fMaxY = (iStepY > 0) ? ((iLeadY + 1) - vec2Max.y) * fDeltaY : (vec2Min.y - iLeadY) * fDeltaY;
+		fEndY = 1.0f - fEpsilon * fDeltaY;
+	}
+
+	while ((fMaxX < fEndX) || (fMaxY < fEndY))
+	{
+		if ((fMaxX < fEndX) && ((fMaxX < fMaxY) || (fMaxY >= fEndY)))
+		{
+			// Enter the next column. Check the rows which the AABB spans at this time
+			float fTime = fMaxX;
+			iLeadX += iStepX;
+			float fMinY = vec2Min.y + vec2Displacement.y * fTime;
+			int iRowStart = (int)floor(fMinY);
+			int iRowEnd = (int)ceil(fMinY + vec2Size.y - fEpsilon) - 1;
+			// If the AABB enters the next row at the same time, then it enters the tile at the corner too
+			if ((fMaxY < fEndY) && (fMaxY - fTime <= fEpsilon * fDeltaY))
+			{
+				if (iStepY > 0)
+					iRowEnd = max(iRowEnd, iLeadY + 1);
+				else
+					iRowStart = min(iRowStart, iLeadY - 1);
+			}
+			if (CheckTiles(iLeadX, iLeadX, iRowStart, iRowEnd, true))
+			{
+				sResult.fTime = fTime;
+				// Snap the AABB against the blocking column
+				sResult.vec2Position.x = (iStepX > 0) ? iLeadX - vec2Size.x : (float)(iLeadX + 1);
+				sResult.vec2Position.y = fMinY;
+				return true;
+			}
+			fMaxX += fDeltaX;
+		}
+		else
+		{
+			// Enter the next row. Check the columns which the AABB spans at this time
+			float fTime = fMaxY;
+			iLeadY += iStepY;
+			float fMinX = vec2Min.x + vec2Displacement.x * fTime;
+			int iColStart = (int)floor(fMinX);
+			int iColEnd = (int)ceil(fMinX + vec2Size.x - fEpsilon) - 1;
+			// If the AABB enters the next column at the same time, then it enters the tile at the corner too
+			if ((fMaxX < fEndX) && (fMaxX - fTime <= fEpsilon * fDeltaX))
+			{
+				if (iStepX > 0)
+					iColEnd = max(iColEnd, iLeadX + 1);
+				else
+					iColStart = min(iColStart, iLeadX - 1);
+			}
+			if (CheckTiles(iColStart, iColEnd, iLeadY, iLeadY, true))
+			{
+				sResult.fTime = fTime;
+				// Snap the AABB against the blocking row
+				sResult.vec2Position.x = fMinX;
+				sResult.vec2Position.y = (iStepY > 0) ? iLeadY - vec2Size.y : (float)(iLeadY + 1);
+				return true;
+			}
+			fMaxY += fDeltaY;
+		}
+	}
+
+	return false;
+}
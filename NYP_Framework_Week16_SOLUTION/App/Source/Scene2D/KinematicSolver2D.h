@@ -0,0 +1,91 @@
+/**
+ CKinematicSolver2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include Physics2D for the gravity and relative directions
+#include "Physics2D.h"
+
+// Include TileGrid2D
+#include "TileGrid2D.h"
+
+// The maximum number of interactable tiles which a sweep will report
+const unsigned int MAX_SWEEP_INTERACTABLES = 32;
+
+// A structure storing the result of a swept AABB traversal of the tile map
+struct SweepResult {
+	// Boolean flag to indicate if a blocking tile was hit
+	bool bHit;
+	// The first blocking tile which was hit, in column and inverted row
+	glm::i32vec2 i32vec2HitTile;
+	// The fraction of the displacement which was moved before the hit, from 0 to 1
+	float fTime;
+	// The minimum corner of the AABB at the end of the sweep
+	glm::vec2 vec2Position;
+	// The interactable tiles which were entered, in the order they were entered
+	glm::i32vec2 i32vec2Interactables[MAX_SWEEP_INTERACTABLES];
+	unsigned int uiNumInteractables;
+};
+
+/**
+ CKinematicSolver2D: Resolves an entity's position against the tile grid.
+					 An entity is an AABB of 1 tile at i32vec2Index, offset by i32vec2NumMicroSteps,
+					 so it overlaps the next column or row when it has microsteps on that axis.
+					 All 4 gravity directions are supported by working with world direction vectors.
+					 This only reads a TileGridView2D, so it does not need OpenGL or a loaded map.
+ */
+class CKinematicSolver2D
+{
+public:
+	// The lowest tile value which blocks movement
+	static const unsigned int BLOCKING_TILE = 100;
+	// The highest tile value which does not support an entity standing on it
+	static const unsigned int HIGHEST_NON_SUPPORTING_TILE = 99;
+	// The interactable tiles have values above INTERACTABLES_START, up to INTERACTABLES_END
+	static const unsigned int INTERACTABLES_START = 49;
+	static const unsigned int INTERACTABLES_END = 99;
+
+	// Get the world direction vector of a direction which is relative to a gravity direction
+	static glm::i32vec2 GetDirVector(	const CPhysics2D::GRAVITY_DIRECTION eGravityDirection,
+										const CPhysics2D::DIRECTION eDirection);
+
+	// Constraint a position within the grid when moving in a direction. Returns true if it was constrained
+	static bool Constraint(	const TileGridView2D& sGrid,
+							glm::i32vec2& i32vec2Index,
+							glm::i32vec2& i32vec2NumMicroSteps,
+							const glm::i32vec2& i32vec2Dir);
+
+	// Check if a position is possible to move into when moving in a direction
+	static bool CheckPosition(	const TileGridView2D& sGrid,
+								const glm::i32vec2& i32vec2Index,
+								glm::i32vec2& i32vec2NumMicroSteps,
+								const glm::i32vec2& i32vec2Dir);
+
+	// Check if a position is on the bottom row for a gravity direction
+	static bool IsOnBottomRow(	const TileGridView2D& sGrid,
+								const glm::i32vec2& i32vec2Index,
+								const CPhysics2D::GRAVITY_DIRECTION eGravityDirection);
+
+	// Check if a position is on the top row for a gravity direction
+	static bool IsOnTopRow(	const TileGridView2D& sGrid,
+							const glm::i32vec2& i32vec2Index,
+							const CPhysics2D::GRAVITY_DIRECTION eGravityDirection);
+
+	// Check if a position is in mid-air for a gravity direction
+	static bool IsMidAir(	const TileGridView2D& sGrid,
+							const glm::i32vec2& i32vec2Index,
+							const glm::i32vec2& i32vec2NumMicroSteps,
+							const CPhysics2D::GRAVITY_DIRECTION eGravityDirection);
+
+	// Sweep an AABB through the tiles, and find the first blocking tile and the interactables crossed
+	static bool SweepAABB(	const TileGridView2D& sGrid,
+							const glm::vec2& vec2Min,
+							const glm::vec2& vec2Size,
+							const glm::vec2& vec2Displacement,
+							SweepResult& sResult);
+};
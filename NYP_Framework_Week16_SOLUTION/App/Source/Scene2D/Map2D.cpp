@@ -7,18 +7,46 @@
 
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include SpriteBatch2D
+#include "RenderControl\SpriteBatch2D.h"
 
 // Include Filesystem
 #include "System\filesystem.h"
-// Include ImageLoader
-#include "System\ImageLoader.h"
-#include "Primitives/MeshBuilder.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
+// Include IdleTaskScheduler
+#include "TimeControl\IdleTaskScheduler.h"
 
 #include <iostream>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <sstream>
+#include <fstream>
 using namespace std;
 
+// The number of rows which are written in each slice of a save in the background
+static const unsigned int SAVE_ROWS_PER_SLICE = 4;
+
+// A save of a tilemap in the background
+struct SaveMapJob
+{
+	// The path of the file
+	string strPath;
+	// The tiles, which are copied when the save starts, indexed by row * uiNumCols + col
+	vector<int> vValues;
+	unsigned int uiNumCols;
+	unsigned int uiNumRows;
+	// The names of the columns
+	vector<string> vColumnNames;
+	// The next row to write
+	unsigned int uiNextRow;
+	// The text of the CSV file
+	ostringstream ossCSV;
+};
+
 // For AStar PathFinding
 using namespace std::placeholders;
 
@@ -27,7 +55,12 @@ using namespace std::placeholders;
  */
 CMap2D::CMap2D(void)
 	: uiCurLevel(0)
+	, bLevelChanged(false)
+	, m_uiNumExpansions(0)
 {
+	// The tiles are not tinted until SetColorOfTile is called
+	for (unsigned int i = 0; i < TILE_COUNT; i++)
+		blockColor[i] = glm::vec4(1.0f);
 }
 
 /**
@@ -49,8 +82,13 @@ CMap2D::~CMap2D(void)
 	}
 	delete[] arrMapInfo;
 
+	// Release the textures of the tiles
+	for (map<int, int>::iterator it = MapOfTextureIDs.begin(); it != MapOfTextureIDs.end(); ++it)
+		CTextureCache::GetInstance()->Release(it->second);
+	MapOfTextureIDs.clear();
+
 	// optional: de-allocate all resources once they've outlived their purpose:
-	glDeleteVertexArrays(1, &VAO);
+	CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
 
@@ -91,12 +129,6 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	cSettings->NUM_TILES_YAXIS = uiNumRows;
 	cSettings->UpdateSpecifications();
 
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	//CS: Create the Quad Mesh using the mesh builder
-	quadMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
-
 	// Load and create textures
 	// Load the ground texture
 	if (LoadTexture("Image/Scene2D_GroundTile.png", COLOUR_BLOCK_UP) == false)
@@ -189,6 +221,10 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	m_cameFromList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS);
 	m_closedList.resize(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS, false);
 
+	// Reserve space for the modified tiles so that SetMapInfo will not allocate during the game
+	vModifiedTiles.reserve(cSettings->NUM_TILES_YAXIS * cSettings->NUM_TILES_XAXIS);
+	bLevelChanged = false;
+
 	//// Clear AStar memory
 	//ClearAStar();
 
@@ -223,41 +259,31 @@ void CMap2D::Update(const double dElapsedTime)
 void CMap2D::PreRender(void)
 {
 	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use(sShaderName);
 }
 
 /**
- @brief Render Render this instance
+ @brief Render Render this instance, by adding the tiles to the sprite batch, which draws all the tiles with
+		the same texture with one draw call. The caller begins the batch before, and submits it after.
  */
 void CMap2D::Render(void)
 {
-	// get matrix's uniform location and set matrix
-	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	// Get the shader which the tiles are drawn with
+	CShader* cShader = CShaderManager::GetInstance()->Get(sShaderName);
 
-	// Render
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
 		for (unsigned int uiCol = 0; uiCol < cSettings->NUM_TILES_XAXIS; uiCol++)
 		{
-			transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-			transform = glm::translate(transform, glm::vec3(cSettings->ConvertIndexToUVSpace(cSettings->x, uiCol, false, 0),
-															cSettings->ConvertIndexToUVSpace(cSettings->y, uiRow, true, 0),
-															0.0f));
-			//transform = glm::rotate(transform, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
-
-			// Update the shaders with the latest transform
-			glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-
 			// Render a tile
-			RenderTile(uiRow, uiCol);
+			RenderTile(cShader, uiRow, uiCol);
 		}
 	}
 }
@@ -267,8 +293,6 @@ void CMap2D::Render(void)
  */
 void CMap2D::PostRender(void)
 {
-	// Disable blending
-	glDisable(GL_BLEND);
 }
 
 // Set the specifications of the map
@@ -339,10 +363,15 @@ void CMap2D::SetNumSteps(const CSettings::AXIS sAxis, const unsigned int uiValue
  */
 void CMap2D::SetMapInfo(const unsigned int uiRow, const unsigned int uiCol, const int iValue, const bool bInvert)
 {
-	if (bInvert)
-		arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiRow - 1][uiCol].value = iValue;
-	else
-		arrMapInfo[uiCurLevel][uiRow][uiCol].value = iValue;
+	// Convert the row to the inverted row used by the entities
+	unsigned int uiInvertedRow = (bInvert ? uiRow : cSettings->NUM_TILES_YAXIS - uiRow - 1);
+	Grid& cGrid = arrMapInfo[uiCurLevel][cSettings->NUM_TILES_YAXIS - uiInvertedRow - 1][uiCol];
+
+	// Record the modified tile so that resting entities can be woken up
+	if (cGrid.value != (unsigned int)iValue)
+		vModifiedTiles.push_back(glm::i32vec2(uiCol, uiInvertedRow));
+
+	cGrid.value = iValue;
 }
 
 /**
@@ -423,6 +452,84 @@ bool CMap2D::SaveMap(string filename, const unsigned int uiCurLevel)
 	return true;
 }
 
+/**
+ @brief Save the tilemap to a text file in slices, in the idle time of the following frames.
+		The tiles are copied now, so the changes in the following frames are not saved.
+		Each slice writes SAVE_ROWS_PER_SLICE rows of the text, and the last slice writes the file.
+ @param filename A string variable containing the name of the text file to save the map to
+ @param uiCurLevel A const unsigned int variable containing the level to save
+ @return true if the save was started
+ */
+bool CMap2D::SaveMapInBackground(string filename, const unsigned int uiCurLevel)
+{
+	if (uiCurLevel >= uiNumLevels)
+	{
+		cout << "CMap2D::SaveMapInBackground: There is no level " << uiCurLevel << endl;
+		return false;
+	}
+
+	shared_ptr<SaveMapJob> pJob = make_shared<SaveMapJob>();
+	pJob->strPath = FileSystem::getPath(filename);
+	pJob->uiNumCols = cSettings->NUM_TILES_XAXIS;
+	pJob->uiNumRows = cSettings->NUM_TILES_YAXIS;
+	pJob->vValues.resize(pJob->uiNumCols * pJob->uiNumRows);
+	for (unsigned int uiRow = 0; uiRow < pJob->uiNumRows; uiRow++)
+	{
+		for (unsigned int uiCol = 0; uiCol < pJob->uiNumCols; uiCol++)
+		{
+			pJob->vValues[uiRow * pJob->uiNumCols + uiCol] = arrMapInfo[uiCurLevel][uiRow][uiCol].value;
+		}
+	}
+	pJob->vColumnNames = doc.GetColumnNames();
+	pJob->uiNextRow = 0;
+
+	CIdleTaskScheduler::HANDLE hTask = CIdleTaskScheduler::GetInstance()->AddTask("SaveMap " + filename, [pJob]()
+	{
+		// Write the names of the columns before the first row
+		if (pJob->uiNextRow == 0)
+		{
+			for (unsigned int i = 0; i < pJob->vColumnNames.size(); i++)
+			{
+				if (i > 0)
+					pJob->ossCSV << ',';
+				pJob->ossCSV << pJob->vColumnNames[i];
+			}
+			pJob->ossCSV << '\n';
+		}
+
+		// Write the next rows
+		if (pJob->uiNextRow < pJob->uiNumRows)
+		{
+			unsigned int uiLastRow = pJob->uiNextRow + SAVE_ROWS_PER_SLICE;
+			if (uiLastRow > pJob->uiNumRows)
+				uiLastRow = pJob->uiNumRows;
+			for (; pJob->uiNextRow < uiLastRow; pJob->uiNextRow++)
+			{
+				for (unsigned int uiCol = 0; uiCol < pJob->uiNumCols; uiCol++)
+				{
+					if (uiCol > 0)
+						pJob->ossCSV << ',';
+					pJob->ossCSV << pJob->vValues[pJob->uiNextRow * pJob->uiNumCols + uiCol];
+				}
+				pJob->ossCSV << '\n';
+			}
+			return false;
+		}
+
+		// Write the file in its own slice, after all the rows
+		ofstream file(pJob->strPath.c_str(), ios::out | ios::trunc);
+		if (!file.is_open())
+		{
+			cout << "CMap2D::SaveMapInBackground: Unable to open " << pJob->strPath << endl;
+			return true;
+		}
+		file << pJob->ossCSV.str();
+		return true;
+	}, CIdleTaskScheduler::PRIORITY_HIGH);
+
+	return (hTask != CIdleTaskScheduler::INVALID_HANDLE);
+}
+
 /**
 @brief Find the indices of a certain value in arrMapInfo
 @param iValue A const int variable containing the row index of the found element
@@ -457,6 +564,8 @@ void CMap2D::SetCurrentLevel(unsigned int uiCurLevel)
 {
 	if (uiCurLevel < uiNumLevels)
 	{
+		if (this->uiCurLevel != uiCurLevel)
+			bLevelChanged = true;
 		this->uiCurLevel = uiCurLevel;
 	}
 }
@@ -468,6 +577,31 @@ unsigned int CMap2D::GetCurrentLevel(void) const
 	return uiCurLevel;
 }
 
+/**
+ @brief Get the tiles which were modified by SetMapInfo since the last ClearModifiedTiles
+ */
+const std::vector<glm::i32vec2>& CMap2D::GetModifiedTiles(void) const
+{
+	return vModifiedTiles;
+}
+
+/**
+ @brief Check if the current level was changed since the last ClearModifiedTiles
+ */
+bool CMap2D::IsLevelChanged(void) const
+{
+	return bLevelChanged;
+}
+
+/**
+ @brief Clear the list of modified tiles
+ */
+void CMap2D::ClearModifiedTiles(void)
+{
+	vModifiedTiles.clear();
+	bLevelChanged = false;
+}
+
 void CMap2D::SetColorOfTile(TILE_ID id, glm::vec4 tileColor)
 {
 	blockColor[id] = tileColor;
@@ -475,74 +609,79 @@ void CMap2D::SetColorOfTile(TILE_ID id, glm::vec4 tileColor)
 
 
 /**
- @brief Load a texture, assign it a code and store it in MapOfTextureIDs.
+ @brief Load a texture from the texture cache, assign it a code and store it in MapOfTextureIDs.
  @param filename A const char* variable which contains the file name of the texture
  @param iTextureCode A const int variable which is the texture code.
  */
 bool CMap2D::LoadTexture(const char* filename, const int iTextureCode)
 {
-	// Variables used in loading the texture
-	int width, height, nrChannels;
-	unsigned int textureID;
-
-	// texture 1
-	// ---------
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	// set the texture wrapping parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// set texture filtering parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-	unsigned char *data = cImageLoader->Load(filename, width, height, nrChannels, true);
-	if (data)
-	{
-		if (nrChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (nrChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-		// Generate mipmaps
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(iTextureCode, textureID));
+	CTextureCache* cTextureCache = CTextureCache::GetInstance();
+	const GLuint textureID = cTextureCache->Acquire(filename, true, GL_REPEAT, GL_LINEAR, true);
+	if (textureID == 0)
+		return false;
+
+	// Store the texture ID into MapOfTextureIDs, releasing the texture which had the code before
+	map<int, int>::iterator it = MapOfTextureIDs.find(iTextureCode);
+	if (it != MapOfTextureIDs.end())
+	{
+		cTextureCache->Release(it->second);
+		it->second = textureID;
 	}
 	else
 	{
-		return false;
+		MapOfTextureIDs.insert(pair<int, int>(iTextureCode, textureID));
 	}
-	// Free up the memory of the file data read in
-	free(data);
 
 	return true;
 }
 
 /**
- @brief Render a tile at a position based on its tile index
+ @brief Render a tile at a position based on its tile index, by adding it to the sprite batch
+ @param cShader A CShader* variable containing the shader which the tile is drawn with
  @param iRow A const int variable containing the row index of the tile
  @param iCol A const int variable containing the column index of the tile
  */
-void CMap2D::RenderTile(const unsigned int uiRow, const unsigned int uiCol)
+void CMap2D::RenderTile(CShader* cShader, const unsigned int uiRow, const unsigned int uiCol)
 {
-	if (arrMapInfo[uiCurLevel][uiRow][uiCol].value > ENTITIES_END)
-	{
-		//if (arrMapInfo[uiCurLevel][uiRow][uiCol].value < 3)
-		unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "runtime_color");
-		glUniform4fv(colorLoc, 1, glm::value_ptr(blockColor[arrMapInfo[uiCurLevel][uiRow][uiCol].value]));
-		glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(arrMapInfo[uiCurLevel][uiRow][uiCol].value));
-
-		glBindVertexArray(VAO);
-		//CS: Render the tile
-		quadMesh->Render();
-		glBindVertexArray(0);
+	const int iValue = arrMapInfo[uiCurLevel][uiRow][uiCol].value;
+	if (iValue > ENTITIES_END)
+	{
+		//CS: Render the tile, tinted by the colour of its block
+		CSpriteBatch2D::GetInstance()->Draw(cShader,
+											MapOfTextureIDs.at(iValue),
+											glm::vec2(cSettings->ConvertIndexToUVSpace(cSettings->x, uiCol, false, 0),
+													  cSettings->ConvertIndexToUVSpace(cSettings->y, uiRow, true, 0)),
+											glm::vec2(cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT),
+											glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+											blockColor[iValue]);
 	}
 }
 
 
+/**
+ @brief Get a read-only view of the current level, with direct access to its rows
+ */
+TileGridView2D CMap2D::GetGridView(void) const
+{
+	return TileGridView2D(arrMapInfo[uiCurLevel], (int)cSettings->NUM_TILES_YAXIS, (int)cSettings->NUM_TILES_XAXIS);
+}
+
+/**
+ @brief Sweep an AABB through the tiles of the current level. See CKinematicSolver2D::SweepAABB
+ @param vec2Min A const glm::vec2& variable containing the minimum corner of the AABB, in tiles
+ @param vec2Size A const glm::vec2& variable containing the size of the AABB, in tiles
+ @param vec2Displacement A const glm::vec2& variable containing the displacement of the AABB, in tiles
+ @param sResult A SweepResult& variable to store the result in
+ @return true if a blocking tile was hit
+ */
+bool CMap2D::SweepAABB(	const glm::vec2& vec2Min,
+						const glm::vec2& vec2Size,
+						const glm::vec2& vec2Displacement,
+						SweepResult& sResult) const
+{
+	return CKinematicSolver2D::SweepAABB(GetGridView(), vec2Min, vec2Size, vec2Displacement, sResult);
+}
+
 /**
  @brief Find a path
  */
@@ -569,6 +708,7 @@ std::vector<glm::i32vec2> CMap2D::PathFind(	const glm::i32vec2& startPos,
 
 	// Reset AStar lists
 	ResetAStarLists();
+	m_uiNumExpansions = 0;
 
 	// Add the start pos to 2 lists
 	m_cameFromList[ConvertTo1D(m_startPos)].parent = m_startPos;
@@ -596,6 +736,7 @@ std::vector<glm::i32vec2> CMap2D::PathFind(	const glm::i32vec2& startPos,
 
 		m_openList.pop();
 		m_closedList[ConvertTo1D(currentPos)] = true;
+		m_uiNumExpansions++;
 
 		// Check the neighbors of the current node
 		for (unsigned int i = 0; i < m_nrOfDirections; ++i)
@@ -673,6 +814,14 @@ std::vector<glm::i32vec2> CMap2D::BuildPath() const
 	return path;
 }
 
+/**
+ @brief Get the number of nodes which were expanded by the last call to PathFind
+ */
+unsigned int CMap2D::GetNumPathFindExpansions(void) const
+{
+	return m_uiNumExpansions;
+}
+
 /**
  @brief Toggle the checks for diagonal movements
  */
@@ -30,36 +30,24 @@
 // Include Entity2D
 #include "Primitives/Entity2D.h"
 
+// Include TileGrid2D
+#include "TileGrid2D.h"
+
+// Include KinematicSolver2D for sweeping through the tiles
+#include "KinematicSolver2D.h"
+
 // Include files for AStar
 #include <queue>
 #include <functional>
 
+class CShader;
+
 // A structure storing information about Map Sizes
 struct MapSize {
 	unsigned int uiRowSize;
 	unsigned int uiColSize;
 };
 
-// A structure storing information about a map grid
-// It includes data to be used for A* Path Finding
-struct Grid {
-	unsigned int value;
-
-	Grid() 
-		: value(0), pos(0, 0), parent(-1, -1), f(0), g(0), h(0) {}
-	Grid(	const glm::i32vec2& pos, unsigned int f) 
-		: value(0), pos(pos), parent(-1, 1), f(f), g(0), h(0) {}
-	Grid(	const glm::i32vec2& pos, const glm::i32vec2& parent, 
-			unsigned int f, unsigned int g, unsigned int h) 
-		: value(0), pos(pos), parent(parent), f(f), g(g), h(h) {}
-
-	glm::i32vec2 pos;
-	glm::i32vec2 parent;
-	unsigned int f;
-	unsigned int g;
-	unsigned int h;
-};
-
 using HeuristicFunction = 
 	std::function<unsigned int(const glm::i32vec2&, const glm::i32vec2&, int)>;
 // Reverse std::priority_queue to get the largest f value on top
@@ -142,6 +130,8 @@ public:
 
 	// Save a tilemap
 	bool SaveMap(string filename, const unsigned int uiLevel = 0);
+	// Save a tilemap in slices, in the idle time of the following frames
+	bool SaveMapInBackground(string filename, const unsigned int uiLevel = 0);
 
 	// Find the indices of a certain value in arrMapInfo
 	bool FindValue(const int iValue, unsigned int& uirRow, unsigned int& uirCol, const bool bInvert = true);
@@ -157,11 +147,29 @@ public:
 	// Get current level
 	unsigned int GetCurrentLevel(void) const;
 
+	// Get the tiles which were modified by SetMapInfo since the last ClearModifiedTiles
+	const std::vector<glm::i32vec2>& GetModifiedTiles(void) const;
+	// Check if the current level was changed since the last ClearModifiedTiles
+	bool IsLevelChanged(void) const;
+	// Clear the list of modified tiles
+	void ClearModifiedTiles(void);
+
+	// Get a read-only view of the current level, with direct access to its rows
+	TileGridView2D GetGridView(void) const;
+
+	// Sweep an AABB through the tile map, and find the first blocking tile and the interactables crossed
+	bool SweepAABB(	const glm::vec2& vec2Min,
+					const glm::vec2& vec2Size,
+					const glm::vec2& vec2Displacement,
+					SweepResult& sResult) const;
+
 	// For AStar PathFinding
 	std::vector<glm::i32vec2> PathFind(	const glm::i32vec2& startPos, 
 										const glm::i32vec2& targetPos, 
 										HeuristicFunction heuristicFunc, 
 										const int weight = 1);
+	// Get the number of nodes which were expanded by the last call to PathFind
+	unsigned int GetNumPathFindExpansions(void) const;
 	// Set if AStar PathFinding will consider diagonal movements
 	void SetDiagonalMovement(const bool bEnable);
 	// Print out details about this class instance in the console window
@@ -180,6 +188,11 @@ protected:
 	// The number of levels
 	unsigned int uiNumLevels;
 
+	// The tile indices, in column and inverted row, which were modified by SetMapInfo
+	std::vector<glm::i32vec2> vModifiedTiles;
+	// Boolean flag to indicate if the current level was changed
+	bool bLevelChanged;
+
 	glm::vec4 blockColor[TILE_COUNT];
 
 	// A 1-D array which stores the map sizes for each level
@@ -188,9 +201,6 @@ protected:
 	// Map containing texture IDs
 	map<int, int> MapOfTextureIDs;
 
-	//CS: The quadMesh for drawing the tiles
-	CMesh* quadMesh;
-
 	// Constructor
 	CMap2D(void);
 
@@ -200,8 +210,8 @@ protected:
 	// Load a texture
 	bool LoadTexture(const char* filename, const int iTextureCode);
 
-	// Render a tile
-	void RenderTile(const unsigned int uiRow, const unsigned int uiCol);
+	// Render a tile, by adding it to the sprite batch
+	void RenderTile(CShader* cShader, const unsigned int uiRow, const unsigned int uiCol);
 
 	// For A-Star PathFinding
 	// Build a path from m_cameFromList after calling PathFind()
@@ -225,6 +235,8 @@ protected:
 	unsigned int m_nrOfDirections;
 	glm::i32vec2 m_startPos;
 	glm::i32vec2 m_targetPos;
+	// The number of nodes which were expanded by the last call to PathFind
+	unsigned int m_uiNumExpansions;
 
 	// The handle for heuristic functions
 	HeuristicFunction m_heuristic;
@@ -0,0 +1,484 @@
+/**
+ CParticleSystem2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "ParticleSystem2D.h"
+
+#include <math.h>
+#include <iostream>
+using namespace std;
+
+// Include rapidcsv to load the emitters
+#include "System/rapidcsv.h"
+#include "System\filesystem.h"
+
+// Include Shader Manager
+#include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include StreamBuffer
+#include "RenderControl\StreamBuffer.h"
+
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
+
+// Include Math
+#include "System/MyMath.h"
+
+// Include Random
+#include "System\Random.h"
+
+// Include GLM
+#include <includes/gtc/type_ptr.hpp>
+
+// Include SSE where it is available
+#if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1)) || defined(__SSE__)
+#include <xmmintrin.h>
+#define PARTICLE_SYSTEM_2D_SSE
+#endif
+
+// An invalid emitter ID
+const int CParticleSystem2D::INVALID_EMITTER;
+// The number of particles which are integrated together with SSE
+const unsigned int CParticleSystem2D::SIMD_WIDTH;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CParticleSystem2D::CParticleSystem2D(void)
+	: VAO(0)
+	, EBO(0)
+	, uiBufferCapacity(0)
+	, fCapacityScale(1.0f)
+	, sShaderName("2DColorShader")
+	, uiNumUpdated(0)
+	, dUpdateTime(0.0)
+	, cSettings(NULL)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CParticleSystem2D::~CParticleSystem2D(void)
+{
+	DestroyEmitters();
+
+	// We won't delete this since it was created elsewhere
+	cSettings = NULL;
+}
+
+/**
+ @brief Init Initialise this instance
+ */
+bool CParticleSystem2D::Init(void)
+{
+	// Get the handler to the CSettings instance
+	cSettings = CSettings::GetInstance();
+
+	cStopWatch.StartTimer();
+	return true;
+}
+
+/**
+ @brief Load the emitters from a CSV file, and create their pools, textures and the shared buffers.
+		All the memory for the particles is allocated here, so emitting and updating them does not allocate.
+ @param filename A const std::string& variable containing the name of the CSV file
+ @return true if the emitters were loaded
+ */
+bool CParticleSystem2D::LoadEmitters(const std::string& filename)
+{
+	DestroyEmitters();
+
+	try
+	{
+		rapidcsv::Document doc(FileSystem::getPath(filename).c_str());
+
+		const unsigned int uiNumRows = (unsigned int)doc.GetRowCount();
+		vEmitters.resize(uiNumRows);
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			Emitter& sEmitter = vEmitters[uiRow];
+			sEmitter.strName = doc.GetCell<std::string>("Name", uiRow);
+			sEmitter.uiTextureID = 0;
+			sEmitter.uiCapacity = doc.GetCell<unsigned int>("Capacity", uiRow);
+			sEmitter.uiCount = doc.GetCell<unsigned int>("Count", uiRow);
+			sEmitter.fLifetime = doc.GetCell<float>("Lifetime", uiRow);
+			sEmitter.fSpeedMin = doc.GetCell<float>("SpeedMin", uiRow);
+			sEmitter.fSpeedMax = doc.GetCell<float>("SpeedMax", uiRow);
+			sEmitter.fDirection = doc.GetCell<float>("Direction", uiRow);
+			sEmitter.fSpread = doc.GetCell<float>("Spread", uiRow);
+			sEmitter.vec2Gravity = glm::vec2(doc.GetCell<float>("GravityX", uiRow), doc.GetCell<float>("GravityY", uiRow));
+			sEmitter.fSize = doc.GetCell<float>("Size", uiRow);
+			sEmitter.vec4Colour = glm::vec4(doc.GetCell<float>("Red", uiRow),
+											doc.GetCell<float>("Green", uiRow),
+											doc.GetCell<float>("Blue", uiRow),
+											doc.GetCell<float>("Alpha", uiRow));
+
+			if ((sEmitter.uiCapacity == 0) || (sEmitter.fLifetime <= 0.0f))
+			{
+				throw runtime_error("Invalid capacity or lifetime in row " + to_string(uiRow));
+			}
+
+			const std::string strTexture = doc.GetCell<std::string>("Texture", uiRow);
+			if (LoadTexture(strTexture.c_str(), sEmitter.uiTextureID) == false)
+			{
+				throw runtime_error("Unable to load texture " + strTexture + " in row " + to_string(uiRow));
+			}
+
+			// Round the pool up to a whole number of SIMD groups
+			const unsigned int uiPoolSize = (sEmitter.uiCapacity + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+			sEmitter.vPositionX.assign(uiPoolSize, 0.0f);
+			sEmitter.vPositionY.assign(uiPoolSize, 0.0f);
+			sEmitter.vVelocityX.assign(uiPoolSize, 0.0f);
+			sEmitter.vVelocityY.assign(uiPoolSize, 0.0f);
+			sEmitter.vLife.assign(uiPoolSize, 0.0f);
+			sEmitter.uiNumAlive = 0;
+
+			if (sEmitter.uiCapacity > uiBufferCapacity)
+				uiBufferCapacity = sEmitter.uiCapacity;
+		}
+	}
+	catch (exception& e)
+	{
+		cout << "CParticleSystem2D::LoadEmitters: Unable to load " << filename << ": " << e.what() << endl;
+		DestroyEmitters();
+		return false;
+	}
+
+	CreateBuffers(uiBufferCapacity);
+	return true;
+}
+
+/**
+ @brief Destroy the emitters and their textures and buffers
+ */
+void CParticleSystem2D::DestroyEmitters(void)
+{
+	for (auto& sEmitter : vEmitters)
+	{
+		if (sEmitter.uiTextureID != 0)
+			CTextureCache::GetInstance()->Release(sEmitter.uiTextureID);
+	}
+	vEmitters.clear();
+
+	if (VAO != 0)
+	{
+		CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &EBO);
+		VAO = EBO = 0;
+	}
+	uiBufferCapacity = 0;
+}
+
+/**
+ @brief Get the ID of an emitter from its name
+ @param strName A const std::string& variable containing the name of the emitter
+ @return The ID of the emitter, or INVALID_EMITTER if there is no emitter with this name
+ */
+int CParticleSystem2D::GetEmitterID(const std::string& strName) const
+{
+	for (unsigned int i = 0; i < vEmitters.size(); i++)
+	{
+		if (vEmitters[i].strName == strName)
+			return (int)i;
+	}
+	return INVALID_EMITTER;
+}
+
+/**
+ @brief Emit particles from an emitter. Particles which do not fit in its pool are dropped
+ @param iEmitterID A const int variable containing the ID of the emitter
+ @param vec2Position A const glm::vec2& variable containing the position in tiles
+ */
+void CParticleSystem2D::Emit(const int iEmitterID, const glm::vec2& vec2Position)
+{
+	if ((iEmitterID < 0) || (iEmitterID >= (int)vEmitters.size()))
+		return;
+
+	Emitter& sEmitter = vEmitters[iEmitterID];
+	CRandom& cRandom = CRandomStreams::GetInstance()->GetStream(CRandomStreams::STREAM_PARTICLES);
+	// The pools keep their full size, so the scale can be raised again without reallocating them
+	const unsigned int uiCapacity = Math::Max(1u, (unsigned int)(sEmitter.uiCapacity * fCapacityScale));
+	const unsigned int uiCount = Math::Max(1u, (unsigned int)(sEmitter.uiCount * fCapacityScale));
+	if (sEmitter.uiNumAlive >= uiCapacity)
+		return;
+	const unsigned int uiNumEmitted = Math::Min(uiCount, uiCapacity - sEmitter.uiNumAlive);
+	for (unsigned int i = 0; i < uiNumEmitted; i++)
+	{
+		const unsigned int uiIndex = sEmitter.uiNumAlive++;
+		const float fAngle = Math::DegreeToRadian(sEmitter.fDirection +
+			cRandom.RandFloatMinMax(-sEmitter.fSpread * 0.5f, sEmitter.fSpread * 0.5f));
+		const float fSpeed = cRandom.RandFloatMinMax(sEmitter.fSpeedMin, sEmitter.fSpeedMax);
+
+		sEmitter.vPositionX[uiIndex] = vec2Position.x;
+		sEmitter.vPositionY[uiIndex] = vec2Position.y;
+		sEmitter.vVelocityX[uiIndex] = cos(fAngle) * fSpeed;
+		sEmitter.vVelocityY[uiIndex] = sin(fAngle) * fSpeed;
+		sEmitter.vLife[uiIndex] = sEmitter.fLifetime;
+	}
+}
+
+/**
+ @brief Update the particles
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CParticleSystem2D::Update(const double dElapsedTime)
+{
+	cStopWatch.GetElapsedTime();
+
+	uiNumUpdated = 0;
+	for (auto& sEmitter : vEmitters)
+	{
+		if (sEmitter.uiNumAlive == 0)
+			continue;
+
+		uiNumUpdated += sEmitter.uiNumAlive;
+		Integrate(sEmitter, (float)dElapsedTime);
+		Compact(sEmitter);
+	}
+
+	dUpdateTime = cStopWatch.GetElapsedTime();
+}
+
+/**
+ @brief Render the particles, with one draw call for each emitter which has particles
+ */
+void CParticleSystem2D::Render(void)
+{
+	if (VAO == 0)
+		return;
+
+	CShaderManager::GetInstance()->Use(sShaderName);
+	CShader* cShader = CShaderManager::GetInstance()->activeShader;
+	cShader->setMat4("transform", glm::mat4(1.0f));
+	cShader->setVec4("runtime_color", glm::vec4(1.0f));
+
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	for (auto& sEmitter : vEmitters)
+	{
+		if (sEmitter.uiNumAlive == 0)
+			continue;
+
+		// The size of a particle in UV space
+		const float fHalfWidth = sEmitter.fSize * cSettings->TILE_WIDTH * 0.5f;
+		const float fHalfHeight = sEmitter.fSize * cSettings->TILE_HEIGHT * 0.5f;
+		const float fInvLifetime = 1.0f / sEmitter.fLifetime;
+
+		// Build the quads of the particles straight into the stream buffer
+		const CStreamBuffer::Allocation sAllocation = cStreamBuffer->Allocate(sEmitter.uiNumAlive * 4 * sizeof(Vertex), sizeof(Vertex));
+		if (sAllocation.pData == NULL)
+			continue;
+		Vertex* pVertices = (Vertex*)sAllocation.pData;
+		for (unsigned int i = 0; i < sEmitter.uiNumAlive; i++)
+		{
+			// Convert the position in tiles to the centre of the particle in UV space
+			const float fX = -1.0f + (sEmitter.vPositionX[i] + 0.5f) * cSettings->TILE_WIDTH;
+			const float fY = -1.0f + (sEmitter.vPositionY[i] + 0.5f) * cSettings->TILE_HEIGHT;
+			glm::vec4 vec4Colour = sEmitter.vec4Colour;
+			vec4Colour.a *= sEmitter.vLife[i] * fInvLifetime;
+
+			Vertex* pVertex = &pVertices[i * 4];
+			pVertex[0].position = glm::vec3(fX - fHalfWidth, fY - fHalfHeight, 0.0f);
+			pVertex[0].texCoord = glm::vec2(0.0f, 0.0f);
+			pVertex[1].position = glm::vec3(fX + fHalfWidth, fY - fHalfHeight, 0.0f);
+			pVertex[1].texCoord = glm::vec2(1.0f, 0.0f);
+			pVertex[2].position = glm::vec3(fX + fHalfWidth, fY + fHalfHeight, 0.0f);
+			pVertex[2].texCoord = glm::vec2(1.0f, 1.0f);
+			pVertex[3].position = glm::vec3(fX - fHalfWidth, fY + fHalfHeight, 0.0f);
+			pVertex[3].texCoord = glm::vec2(0.0f, 1.0f);
+			for (unsigned int j = 0; j < 4; j++)
+				pVertex[j].color = vec4Colour;
+		}
+
+		CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, sEmitter.uiTextureID);
+		cStreamBuffer->Commit(sAllocation);
+		glDrawElementsBaseVertex(GL_TRIANGLES, sEmitter.uiNumAlive * 6, GL_UNSIGNED_INT, 0, (GLint)(sAllocation.iOffset / sizeof(Vertex)));
+	}
+
+	CGLStateCache::GetInstance()->BindVertexArray(0);
+}
+
+/**
+ @brief Set the shader which the particles are rendered with
+ */
+void CParticleSystem2D::SetShader(const std::string& strShaderName)
+{
+	sShaderName = strShaderName;
+}
+
+/**
+ @brief Get the number of particles which are alive
+ */
+unsigned int CParticleSystem2D::GetNumParticles(void) const
+{
+	unsigned int uiNumParticles = 0;
+	for (auto& sEmitter : vEmitters)
+		uiNumParticles += sEmitter.uiNumAlive;
+	return uiNumParticles;
+}
+
+/**
+ @brief Set the scale of the capacity and the count of each emitter. The particles which are alive are kept
+ @param fCapacityScale A const float variable containing the scale, from 0 to 1
+ */
+void CParticleSystem2D::SetCapacityScale(const float fCapacityScale)
+{
+	this->fCapacityScale = Math::Clamp(fCapacityScale, 0.0f, 1.0f);
+}
+
+/**
+ @brief Get the scale of the capacity and the count of each emitter
+ */
+float CParticleSystem2D::GetCapacityScale(void) const
+{
+	return fCapacityScale;
+}
+
+/**
+ @brief Get the number of particles which were updated in each millisecond in the last Update
+ */
+double CParticleSystem2D::GetParticlesPerMillisecond(void) const
+{
+	if (dUpdateTime <= 0.0)
+		return 0.0;
+	return uiNumUpdated / (dUpdateTime * 1000.0);
+}
+
+/**
+ @brief PrintSelf
+ */
+void CParticleSystem2D::PrintSelf(void) const
+{
+	cout << "CParticleSystem2D::PrintSelf()" << endl;
+	for (auto& sEmitter : vEmitters)
+	{
+		cout << sEmitter.strName << ": " << sEmitter.uiNumAlive << " / " << sEmitter.uiCapacity << endl;
+	}
+	cout << "Particles updated per millisecond: " << GetParticlesPerMillisecond() << endl;
+}
+
+/**
+ @brief Integrate the particles of an emitter. The pools are padded to SIMD_WIDTH, so the last group
+		can be integrated with the others; the padding is never rendered or emitted from.
+ @param sEmitter A Emitter& variable containing the emitter
+ @param fElapsedTime A const float variable containing the elapsed time since the last frame
+ */
+void CParticleSystem2D::Integrate(Emitter& sEmitter, const float fElapsedTime)
+{
+	float* pPositionX = sEmitter.vPositionX.data();
+	float* pPositionY = sEmitter.vPositionY.data();
+	float* pVelocityX = sEmitter.vVelocityX.data();
+	float* pVelocityY = sEmitter.vVelocityY.data();
+	float* pLife = sEmitter.vLife.data();
+	const unsigned int uiNumGroups = (sEmitter.uiNumAlive + SIMD_WIDTH - 1) / SIMD_WIDTH;
+
+#ifdef PARTICLE_SYSTEM_2D_SSE
+	const __m128 m128ElapsedTime = _mm_set1_ps(fElapsedTime);
+	const __m128 m128DeltaVelocityX = _mm_set1_ps(sEmitter.vec2Gravity.x * fElapsedTime);
+	const __m128 m128DeltaVelocityY = _mm_set1_ps(sEmitter.vec2Gravity.y * fElapsedTime);
+	for (unsigned int i = 0; i < uiNumGroups * SIMD_WIDTH; i += SIMD_WIDTH)
+	{
+		const __m128 m128VelocityX = _mm_add_ps(_mm_loadu_ps(pVelocityX + i), m128DeltaVelocityX);
+		const __m128 m128VelocityY = _mm_add_ps(_mm_loadu_ps(pVelocityY + i), m128DeltaVelocityY);
+		_mm_storeu_ps(pVelocityX + i, m128VelocityX);
+		_mm_storeu_ps(pVelocityY + i, m128VelocityY);
+		_mm_storeu_ps(pPositionX + i, _mm_add_ps(_mm_loadu_ps(pPositionX + i), _mm_mul_ps(m128VelocityX, m128ElapsedTime)));
+		_mm_storeu_ps(pPositionY + i, _mm_add_ps(_mm_loadu_ps(pPositionY + i), _mm_mul_ps(m128VelocityY, m128ElapsedTime)));
+		_mm_storeu_ps(pLife + i, _mm_sub_ps(_mm_loadu_ps(pLife + i), m128ElapsedTime));
+	}
+#else
+	const float fDeltaVelocityX = sEmitter.vec2Gravity.x * fElapsedTime;
+	const float fDeltaVelocityY = sEmitter.vec2Gravity.y * fElapsedTime;
+	for (unsigned int i = 0; i < uiNumGroups * SIMD_WIDTH; i++)
+	{
+		pVelocityX[i] += fDeltaVelocityX;
+		pVelocityY[i] += fDeltaVelocityY;
+		pPositionX[i] += pVelocityX[i] * fElapsedTime;
+		pPositionY[i] += pVelocityY[i] * fElapsedTime;
+		pLife[i] -= fElapsedTime;
+	}
+#endif
+}
+
+/**
+ @brief Remove the dead particles of an emitter, by moving the last alive particle into each of their places
+ @param sEmitter A Emitter& variable containing the emitter
+ */
+void CParticleSystem2D::Compact(Emitter& sEmitter)
+{
+	unsigned int i = 0;
+	while (i < sEmitter.uiNumAlive)
+	{
+		if (sEmitter.vLife[i] > 0.0f)
+		{
+			i++;
+			continue;
+		}
+
+		const unsigned int uiLast = --sEmitter.uiNumAlive;
+		sEmitter.vPositionX[i] = sEmitter.vPositionX[uiLast];
+		sEmitter.vPositionY[i] = sEmitter.vPositionY[uiLast];
+		sEmitter.vVelocityX[i] = sEmitter.vVelocityX[uiLast];
+		sEmitter.vVelocityY[i] = sEmitter.vVelocityY[uiLast];
+		sEmitter.vLife[i] = sEmitter.vLife[uiLast];
+	}
+}
+
+/**
+ @brief Create the vertex array and index buffer for a number of particles.
+		The indices never change, so only the vertices are written into the stream buffer when rendering.
+ @param uiCapacity A const unsigned int variable containing the number of particles
+ */
+void CParticleSystem2D::CreateBuffers(const unsigned int uiCapacity)
+{
+	if (uiCapacity == 0)
+		return;
+
+	std::vector<GLuint> vIndices(uiCapacity * 6);
+	for (unsigned int i = 0; i < uiCapacity; i++)
+	{
+		vIndices[i * 6 + 0] = i * 4 + 0;
+		vIndices[i * 6 + 1] = i * 4 + 1;
+		vIndices[i * 6 + 2] = i * 4 + 2;
+		vIndices[i * 6 + 3] = i * 4 + 0;
+		vIndices[i * 6 + 4] = i * 4 + 2;
+		vIndices[i * 6 + 5] = i * 4 + 3;
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &EBO);
+
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, CStreamBuffer::GetInstance()->GetBufferID());
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndices.size() * sizeof(GLuint), vIndices.data(), GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(glm::vec3));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec4)));
+	glEnableVertexAttribArray(2);
+
+	CGLStateCache::GetInstance()->BindVertexArray(0);
+}
+
+/**
+@brief Load a texture from the texture cache
+@param filename A const char* variable which contains the file name of the texture
+@param iTextureID A GLuint& variable which is set to the texture ID, or 0 if it cannot be loaded
+*/
+bool CParticleSystem2D::LoadTexture(const char* filename, GLuint& iTextureID)
+{
+	iTextureID = CTextureCache::GetInstance()->Acquire(filename, true, GL_CLAMP_TO_EDGE, GL_LINEAR, true);
+	return iTextureID != 0;
+}
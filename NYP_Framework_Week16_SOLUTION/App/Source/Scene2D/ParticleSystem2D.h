@@ -0,0 +1,174 @@
+/**
+ CParticleSystem2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector and string
+#include <vector>
+#include <string>
+
+// Include Settings
+#include "GameControl\Settings.h"
+
+// Include Mesh for the Vertex
+#include "Primitives/Mesh.h"
+
+// Include StopWatch
+#include "TimeControl\StopWatch.h"
+
+/**
+ CParticleSystem2D: Simulates and renders short lived particles, such as the sparks of an explosion.
+					The emitters are loaded from a CSV file. Each emitter has its own texture and a pool
+					of particles with a fixed capacity, so that emitting a particle never allocates memory.
+					The particles are stored as structure-of-arrays and are integrated 4 at a time with SSE,
+					or one at a time where SSE is not available.
+					All the particles of an emitter are drawn with one draw call.
+
+					Each row of the CSV file is an emitter, with the columns:
+					Name		The name which is used to find the emitter
+					Texture		The texture of the particles
+					Capacity	The highest number of particles which can be alive at the same time
+					Count		The number of particles emitted by each call to Emit
+					Lifetime	The time, in seconds, which a particle lives for
+					SpeedMin	The lowest and highest speed of a particle, in tiles per second
+					SpeedMax
+					Direction	The direction, in degrees, which the particles are emitted towards
+					Spread		The angle, in degrees, around the Direction which the particles are emitted in
+					GravityX	The acceleration of the particles, in tiles per second squared
+					GravityY
+					Size		The width and height of a particle, in tiles
+					Red			The colour of the particles. The alpha fades out over the lifetime
+					Green
+					Blue
+					Alpha
+ */
+class CParticleSystem2D : public CSingletonTemplate<CParticleSystem2D>
+{
+	friend CSingletonTemplate<CParticleSystem2D>;
+public:
+	// An invalid emitter ID
+	static const int INVALID_EMITTER = -1;
+
+	// Init
+	bool Init(void);
+
+	// Load the emitters from a CSV file
+	bool LoadEmitters(const std::string& filename);
+
+	// Destroy the emitters and their textures and buffers
+	void DestroyEmitters(void);
+
+	// Get the ID of an emitter from its name, or INVALID_EMITTER
+	int GetEmitterID(const std::string& strName) const;
+
+	// Emit particles from an emitter at a position in tiles. Particles which do not fit in its pool are dropped
+	void Emit(const int iEmitterID, const glm::vec2& vec2Position);
+
+	// Update the particles
+	void Update(const double dElapsedTime);
+
+	// Render the particles
+	void Render(void);
+
+	// Set the shader which the particles are rendered with
+	void SetShader(const std::string& strShaderName);
+
+	// Set the scale, from 0 to 1, of the capacity and the count of each emitter, to emit fewer particles on slow machines
+	void SetCapacityScale(const float fCapacityScale);
+	// Get the scale of the capacity and the count of each emitter
+	float GetCapacityScale(void) const;
+
+	// Get the number of particles which are alive
+	unsigned int GetNumParticles(void) const;
+
+	// Get the number of particles which were updated in each millisecond in the last Update
+	double GetParticlesPerMillisecond(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The number of particles which are integrated together with SSE
+	static const unsigned int SIMD_WIDTH = 4;
+
+	// An emitter, with its descriptor from the CSV file and its pool of particles
+	struct Emitter
+	{
+		// The descriptor
+		std::string strName;
+		GLuint uiTextureID;
+		unsigned int uiCapacity;
+		unsigned int uiCount;
+		float fLifetime;
+		float fSpeedMin;
+		float fSpeedMax;
+		float fDirection;
+		float fSpread;
+		glm::vec2 vec2Gravity;
+		float fSize;
+		glm::vec4 vec4Colour;
+
+		// The pool of particles. The alive particles are packed at the front, and the sizes
+		// are rounded up to SIMD_WIDTH so that the last group of particles can be integrated together
+		std::vector<float> vPositionX;
+		std::vector<float> vPositionY;
+		std::vector<float> vVelocityX;
+		std::vector<float> vVelocityY;
+		std::vector<float> vLife;
+		unsigned int uiNumAlive;
+	};
+
+	// The emitters
+	std::vector<Emitter> vEmitters;
+
+	// The vertex array and index buffer which are shared by all the emitters. The vertices are in the stream buffer
+	GLuint VAO, EBO;
+	// The highest number of particles which the buffers can hold
+	unsigned int uiBufferCapacity;
+	// The scale of the capacity and the count of each emitter
+	float fCapacityScale;
+
+	// The name of the shader
+	std::string sShaderName;
+
+	// The statistics for the last Update
+	unsigned int uiNumUpdated;
+	double dUpdateTime;
+	// The timer for the statistics
+	CStopWatch cStopWatch;
+
+	// Settings
+	CSettings* cSettings;
+
+	// Constructor
+	CParticleSystem2D(void);
+
+	// Destructor
+	virtual ~CParticleSystem2D(void);
+
+	// Integrate the particles of an emitter
+	void Integrate(Emitter& sEmitter, const float fElapsedTime);
+
+	// Remove the dead particles of an emitter, by moving the last alive particle into each of their places
+	void Compact(Emitter& sEmitter);
+
+	// Create the vertex array and index buffer for a number of particles
+	void CreateBuffers(const unsigned int uiCapacity);
+
+	// Load a texture
+	bool LoadTexture(const char* filename, GLuint& iTextureID);
+};
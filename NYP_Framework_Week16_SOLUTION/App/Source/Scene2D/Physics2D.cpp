@@ -12,15 +12,43 @@ using namespace std;
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CPhysics2D::CPhysics2D(void)
-	: v2InitialVelocity(glm::vec2(0.0f))
-	, v2FinalVelocity(glm::vec2(0.0f))
-	, v2Acceleration(glm::vec2(0.0f))
-	, v2Displacement(glm::vec2(0.0f))
-	, v2PrevDisplacement(glm::vec2(0.0f))
-	, fTime(0.0f)
-	, sCurrentStatus(STATUS::IDLE)
-	, sCurrentGravityDirection(GRAVITY_DIRECTION::GRAVITY_DOWN)
+	: cPhysicsWorld2D(CPhysicsWorld2D::GetInstance())
 {
+	// Create a body in the physics world for this instance
+	hBody = cPhysicsWorld2D->CreateBody();
+}
+
+/**
+ @brief Copy constructor. This creates a new body with a copy of the other body's state
+ */
+CPhysics2D::CPhysics2D(const CPhysics2D& cOther)
+	: cPhysicsWorld2D(CPhysicsWorld2D::GetInstance())
+{
+	hBody = cPhysicsWorld2D->CreateBody();
+	*this = cOther;
+}
+
+/**
+ @brief Assignment operator. This copies the other body's state into this body
+ */
+CPhysics2D& CPhysics2D::operator=(const CPhysics2D& cOther)
+{
+	if (this == &cOther)
+		return *this;
+
+	SetFollowsWorldGravity(cOther.GetFollowsWorldGravity());
+	SetSteppedByWorld(cOther.GetSteppedByWorld());
+	SetGravityDirection(cOther.GetGravityDirection());
+	setGravityMagnitude(cPhysicsWorld2D->GetBodyGravityMagnitude(cOther.hBody));
+	cPhysicsWorld2D->SetBodyStatus(hBody, cOther.GetStatus());
+	SetInitialVelocity(cOther.GetInitialVelocity());
+	SetFinalVelocity(cOther.GetFinalVelocity());
+	SetAcceleration(cOther.GetAcceleration());
+	SetDisplacement(cOther.GetDisplacement());
+	SetTime(cOther.GetTime());
+	cPhysicsWorld2D->fPrevDisplacementX[hBody] = cPhysicsWorld2D->fPrevDisplacementX[cOther.hBody];
+	cPhysicsWorld2D->fPrevDisplacementY[hBody] = cPhysicsWorld2D->fPrevDisplacementY[cOther.hBody];
+	return *this;
 }
 
 /**
@@ -28,6 +56,9 @@ CPhysics2D::CPhysics2D(void)
  */
 CPhysics2D::~CPhysics2D(void)
 {
+	// Return the body to the physics world
+	cPhysicsWorld2D->DestroyBody(hBody);
+	hBody = CPhysicsWorld2D::INVALID_HANDLE;
 }
 
 /**
@@ -35,70 +66,70 @@ CPhysics2D::~CPhysics2D(void)
 */ 
 bool CPhysics2D::Init(void)
 {
-	// Reset these variables
-	v2InitialVelocity = glm::vec2(0.0f);
-	v2FinalVelocity = glm::vec2(0.0f);
-	//v2Acceleration = glm::vec2(0.0f);		// Acceleration does not need to be reset here.
-	v2Displacement = glm::vec2(0.0f);
-	v2PrevDisplacement = glm::vec2(0.0f);
-	fTime = 0.0f;
+	// Reset the velocities, displacements and time.
+	// Acceleration does not need to be reset here.
+	cPhysicsWorld2D->ResetBody(hBody);
 	return true;
 }
 
 void CPhysics2D::setGravityMagnitude(float grav)
 {
-	GRAVITY_MAGNITUDE = grav;
+	cPhysicsWorld2D->SetBodyGravityMagnitude(hBody, grav);
 }
 
 // Set methods
 // Set Initial velocity
 void CPhysics2D::SetInitialVelocity(const glm::vec2 v2InitialVelocity)
 {
-	this->v2InitialVelocity = v2InitialVelocity;	// Initial velocity
+	cPhysicsWorld2D->fInitialVelocityX[hBody] = v2InitialVelocity.x;	// Initial velocity
+	cPhysicsWorld2D->fInitialVelocityY[hBody] = v2InitialVelocity.y;
 }
 
 // Set Final velocity
 void CPhysics2D::SetFinalVelocity(const glm::vec2 v2FinalVelocity)
 {
-	this->v2FinalVelocity = v2FinalVelocity;		// Final velocity
+	cPhysicsWorld2D->fFinalVelocityX[hBody] = v2FinalVelocity.x;		// Final velocity
+	cPhysicsWorld2D->fFinalVelocityY[hBody] = v2FinalVelocity.y;
 }
 
 // Set Acceleration
 void CPhysics2D::SetAcceleration(const glm::vec2 v2Acceleration)
 {
-	this->v2Acceleration = v2Acceleration;		// Acceleration
+	cPhysicsWorld2D->fAccelerationX[hBody] = v2Acceleration.x;		// Acceleration
+	cPhysicsWorld2D->fAccelerationY[hBody] = v2Acceleration.y;
 }
 
 // Set Displacement
 void CPhysics2D::SetDisplacement(const glm::vec2 v2Displacement)
 {
-	this->v2Displacement = v2Displacement;		// Displacement
+	cPhysicsWorld2D->fDisplacementX[hBody] = v2Displacement.x;		// Displacement
+	cPhysicsWorld2D->fDisplacementY[hBody] = v2Displacement.y;
 }
 
 // Set Time
 void CPhysics2D::SetTime(const float fTime)
 {
-	this->fTime = fTime;					// Time
+	cPhysicsWorld2D->fTime[hBody] = fTime;					// Time
 }
 
 // Set Status
 void CPhysics2D::SetStatus(const STATUS sStatus)
 {
 	// If there is a change in status, then reset to default values
-	if (sCurrentStatus != sStatus)
+	if (GetStatus() != sStatus)
 	{
 		// Reset to default values
 		Init();
 
 		// Store the new status
-		sCurrentStatus = sStatus;
+		cPhysicsWorld2D->SetBodyStatus(hBody, (unsigned char)sStatus);
 	}
 }
 
 glm::vec2 CPhysics2D::GetGravityDirVector(void) const
 {
 	glm::vec2 vec = glm::vec2(0, -1.f);
-	switch (sCurrentGravityDirection)
+	switch (GetGravityDirection())
 	{
 	case GRAVITY_UP:
 		vec.y = 1.f;
@@ -118,23 +149,72 @@ glm::vec2 CPhysics2D::GetGravityDirVector(void) const
 glm::vec2 CPhysics2D::GetGravityVector(void) const
 {
 	glm::vec2 vec = GetGravityDirVector();
-	vec *= GRAVITY_MAGNITUDE;
+	vec *= cPhysicsWorld2D->GetBodyGravityMagnitude(hBody);
 	return vec;
 }
 
 CPhysics2D::GRAVITY_DIRECTION CPhysics2D::GetGravityDirection() const
 {
-	return sCurrentGravityDirection;
+	return (GRAVITY_DIRECTION)cPhysicsWorld2D->GetBodyGravityDirection(hBody);
 }
 
+/**
+ @brief Set the gravity direction. If this body follows the world gravity, 
+		then the world gravity is set, and every body which follows it is rotated too.
+ */
 void CPhysics2D::SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION dir)
 {
-	sCurrentGravityDirection = dir;
+	if (GetFollowsWorldGravity())
+		cPhysicsWorld2D->SetGravityDirection((unsigned char)dir);
+	else
+		cPhysicsWorld2D->SetBodyGravityDirection(hBody, (unsigned char)dir);
+}
+
+/**
+ @brief Set if this body follows the world gravity direction
+ */
+void CPhysics2D::SetFollowsWorldGravity(const bool bFollowsWorldGravity)
+{
+	cPhysicsWorld2D->SetFollowsWorldGravity(hBody, bFollowsWorldGravity);
+}
+
+/**
+ @brief Check if this body follows the world gravity direction
+ */
+bool CPhysics2D::GetFollowsWorldGravity(void) const
+{
+	return cPhysicsWorld2D->GetFollowsWorldGravity(hBody);
+}
+
+/**
+ @brief Set if this body is integrated by CPhysicsWorld2D::Step once per frame. 
+		If it is, then its owner should not call AddElapsedTime and Update.
+ */
+void CPhysics2D::SetSteppedByWorld(const bool bSteppedByWorld)
+{
+	cPhysicsWorld2D->SetSteppedByWorld(hBody, bSteppedByWorld);
+}
+
+/**
+ @brief Check if this body is integrated by CPhysicsWorld2D::Step
+ */
+bool CPhysics2D::GetSteppedByWorld(void) const
+{
+	return cPhysicsWorld2D->GetSteppedByWorld(hBody);
+}
+
+/**
+ @brief Get the handle of this body in the physics world
+ */
+CPhysicsWorld2D::HANDLE CPhysics2D::GetBodyHandle(void) const
+{
+	return hBody;
 }
 
 bool CPhysics2D::ReachedPeakOfJump(void) const
 {
-	switch (sCurrentGravityDirection)
+	const glm::vec2 v2InitialVelocity = GetInitialVelocity();
+	switch (GetGravityDirection())
 	{
 	case GRAVITY_DOWN:
 		if (v2InitialVelocity.y <= 0.0f)
@@ -182,7 +262,9 @@ glm::vec2 CPhysics2D::GetRelativeDirVector(DIRECTION relativeDir)
 		moveDirectionInWorld.y = rightVector.y;
 		break;
 	case DOWN:
+		moveDirectionInWorld.x = -fwdVector.x;
 		moveDirectionInWorld.y = -fwdVector.y;
+		break;
 	}
 	return moveDirectionInWorld;
 }
@@ -191,65 +273,57 @@ glm::vec2 CPhysics2D::GetRelativeDirVector(DIRECTION relativeDir)
 // Get Initial velocity
 glm::vec2 CPhysics2D::GetInitialVelocity(void) const
 {
-	return v2InitialVelocity;	// Initial velocity
+	return glm::vec2(cPhysicsWorld2D->fInitialVelocityX[hBody], cPhysicsWorld2D->fInitialVelocityY[hBody]);	// Initial velocity
 }
 
 // Get Final velocity
 glm::vec2 CPhysics2D::GetFinalVelocity(void) const
 {
-	return v2FinalVelocity;		// Final velocity
+	return glm::vec2(cPhysicsWorld2D->fFinalVelocityX[hBody], cPhysicsWorld2D->fFinalVelocityY[hBody]);		// Final velocity
 }
 
 // Get Acceleration
 glm::vec2 CPhysics2D::GetAcceleration(void) const
 {
-	return v2Acceleration;		// Acceleration
+	return glm::vec2(cPhysicsWorld2D->fAccelerationX[hBody], cPhysicsWorld2D->fAccelerationY[hBody]);		// Acceleration
 }
 
 // Get Displacement
 glm::vec2 CPhysics2D::GetDisplacement(void) const
 {
-	return v2Displacement;		// Displacement
+	return glm::vec2(cPhysicsWorld2D->fDisplacementX[hBody], cPhysicsWorld2D->fDisplacementY[hBody]);		// Displacement
 }
 
 // Get Delta Displacement
 glm::vec2 CPhysics2D::GetDeltaDisplacement(void) const
 {
-	return v2Displacement - v2PrevDisplacement;		// Delta Displacement
+	return GetDisplacement() - glm::vec2(cPhysicsWorld2D->fPrevDisplacementX[hBody], cPhysicsWorld2D->fPrevDisplacementY[hBody]);		// Delta Displacement
 }
 
 // Get Time
 float CPhysics2D::GetTime(void) const
 {
-	return fTime;					// Time
+	return cPhysicsWorld2D->fTime[hBody];					// Time
 }
 
 // Get Status
 CPhysics2D::STATUS CPhysics2D::GetStatus(void) const
 {
-	return sCurrentStatus;
+	return (STATUS)cPhysicsWorld2D->GetBodyStatus(hBody);
 }
 
 // Update
 void CPhysics2D::Update(void)
 {
-	// If the player is in IDLE mode, 
-	// then we don't calculate further
-	if (sCurrentStatus == IDLE)
-		return;
-
-	// Calculate the final velocity
-	v2FinalVelocity = v2InitialVelocity + GetGravityVector() * fTime;
-	// Calculate the displacement
-	v2Displacement = v2FinalVelocity * fTime - 0.5f * GetGravityVector() * fTime * fTime;
-	// Update v2InitialVelocity
-	v2InitialVelocity = v2FinalVelocity;
+	// Integrate this body in the physics world. 
+	// If the player is in IDLE mode, then it is not calculated further
+	cPhysicsWorld2D->Integrate(hBody);
 }
 
 // Add elapsed time
 void CPhysics2D::AddElapsedTime(const float fElapseTime)
 {
-	fTime += fElapseTime;
+	cPhysicsWorld2D->fTime[hBody] += fElapseTime;
 }
 
 // Calculate the distance between two vec2 varables
@@ -262,9 +336,9 @@ float CPhysics2D::CalculateDistance(glm::vec2 source, glm::vec2 destination)
 void CPhysics2D::PrintSelf(void)
 {
 	cout << "CPhysics2D::PrintSelf()" << endl;
-	cout << "v2InitialVelocity\t=\t" << v2InitialVelocity.x << ", " << v2InitialVelocity.y << endl;
-	cout << "v2FinalVelocity\t=\t" << v2FinalVelocity.x << ", " << v2FinalVelocity.y << endl;
-	cout << "v2Acceleration\t=\t" << v2Acceleration.x << ", " << v2Acceleration.y << endl;
-	cout << "v2Displacement\t=\t" << v2Displacement.x << ", " << v2Displacement.y << endl;
-	cout << "fTime\t=\t" << fTime << endl;
+	cout << "v2InitialVelocity\t=\t" << GetInitialVelocity().x << ", " << GetInitialVelocity().y << endl;
+	cout << "v2FinalVelocity\t=\t" << GetFinalVelocity().x << ", " << GetFinalVelocity().y << endl;
+	cout << "v2Acceleration\t=\t" << GetAcceleration().x << ", " << GetAcceleration().y << endl;
+	cout << "v2Displacement\t=\t" << GetDisplacement().x << ", " << GetDisplacement().y << endl;
+	cout << "fTime\t=\t" << GetTime() << endl;
 }
@@ -9,9 +9,14 @@
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
+// Include PhysicsWorld2D
+#include "PhysicsWorld2D.h"
+
+/**
+ CPhysics2D: A handle to a body in CPhysicsWorld2D. The body is created and destroyed with this instance.
+ */
 class CPhysics2D
 {
-	float GRAVITY_MAGNITUDE = 1.1;
 public:
 	enum STATUS
 	{
@@ -40,6 +45,12 @@ public:
 	// Constructor
 	CPhysics2D(void);
 
+	// Copy constructor
+	CPhysics2D(const CPhysics2D& cOther);
+
+	// Assignment operator
+	CPhysics2D& operator=(const CPhysics2D& cOther);
+
 	// Destructor
 	virtual ~CPhysics2D(void);
 
@@ -65,6 +76,11 @@ public:
 	glm::vec2 GetDeltaDisplacement(void) const;			// Get Delta Displacement
 	GRAVITY_DIRECTION GetGravityDirection(void) const;	// Get Gravity Direction
 	void setGravityMagnitude(float mag);
+	void SetFollowsWorldGravity(const bool bFollowsWorldGravity);	// Set if this body follows the world gravity direction
+	bool GetFollowsWorldGravity(void) const;						// Check if this body follows the world gravity direction
+	void SetSteppedByWorld(const bool bSteppedByWorld);			// Set if this body is integrated by CPhysicsWorld2D::Step
+	bool GetSteppedByWorld(void) const;							// Check if this body is integrated by CPhysicsWorld2D::Step
+	CPhysicsWorld2D::HANDLE GetBodyHandle(void) const;			// Get the handle of this body in the physics world
 	bool ReachedPeakOfJump(void) const;					// Checks if Peak of Jump has been found relative to Gravity Direction
 
 	glm::vec2 GetGravityDirVector(void) const;			// Get Gravity Direction's Vector
@@ -86,17 +102,9 @@ public:
 	void PrintSelf(void);
 
 protected:
-	// Variables for SUVAT calculations
-	glm::vec2 v2InitialVelocity;	// Initial velocity
-	glm::vec2 v2FinalVelocity;		// Final velocity
-	glm::vec2 v2Acceleration;		// Acceleration
-	glm::vec2 v2Displacement;		// Displacement
-	glm::vec2 v2PrevDisplacement;	// Previous Displacement
-	float fTime;					// Time
-
-	const glm::vec2 v2Gravity = glm::vec2( 0.0f, -1.1f);		// Gravity constant
-	GRAVITY_DIRECTION sCurrentGravityDirection;
-
-	STATUS sCurrentStatus;
+	// The physics world which stores the variables for SUVAT calculations
+	CPhysicsWorld2D* cPhysicsWorld2D;
+	// The handle of this body in the physics world
+	CPhysicsWorld2D::HANDLE hBody;
 };
 
@@ -0,0 +1,329 @@
+/**
+ CPhysicsWorld2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "PhysicsWorld2D.h"
+
+// Include Physics2D for the gravity directions and statuses
+#include "Physics2D.h"
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CPhysicsWorld2D::CPhysicsWorld2D(void)
+	: uiNumBodies(0)
+	, ucWorldGravityDirection(CPhysics2D::GRAVITY_DOWN)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CPhysicsWorld2D::~CPhysicsWorld2D(void)
+{
+}
+
+/**
+ @brief Create a body and return its handle. The handle of a destroyed body is reused if there is one.
+ */
+CPhysicsWorld2D::HANDLE CPhysicsWorld2D::CreateBody(void)
+{
+	HANDLE hBody;
+	if (vFreeBodies.size() > 0)
+	{
+		hBody = vFreeBodies.back();
+		vFreeBodies.pop_back();
+	}
+	else
+	{
+		hBody = (HANDLE)fTime.size();
+		fInitialVelocityX.push_back(0.0f);
+		fInitialVelocityY.push_back(0.0f);
+		fFinalVelocityX.push_back(0.0f);
+		fFinalVelocityY.push_back(0.0f);
+		fAccelerationX.push_back(0.0f);
+		fAccelerationY.push_back(0.0f);
+		fDisplacementX.push_back(0.0f);
+		fDisplacementY.push_back(0.0f);
+		fPrevDisplacementX.push_back(0.0f);
+		fPrevDisplacementY.push_back(0.0f);
+		fTime.push_back(0.0f);
+		fGravityX.push_back(0.0f);
+		fGravityY.push_back(0.0f);
+		fGravityMagnitude.push_back(0.0f);
+		fStepMask.push_back(0.0f);
+		ucGravityDirection.push_back(CPhysics2D::GRAVITY_DOWN);
+		ucStatus.push_back(CPhysics2D::IDLE);
+		bAlive.push_back(false);
+		bFollowsWorldGravity.push_back(false);
+		bSteppedByWorld.push_back(false);
+	}
+
+	// Reset the body to the same defaults as a new CPhysics2D
+	ResetBody(hBody);
+	fAccelerationX[hBody] = 0.0f;
+	fAccelerationY[hBody] = 0.0f;
+	fGravityMagnitude[hBody] = 1.1f;
+	ucGravityDirection[hBody] = CPhysics2D::GRAVITY_DOWN;
+	ucStatus[hBody] = CPhysics2D::IDLE;
+	bAlive[hBody] = true;
+	bFollowsWorldGravity[hBody] = false;
+	bSteppedByWorld[hBody] = false;
+	UpdateGravity(hBody);
+	UpdateStepMask(hBody);
+
+	uiNumBodies++;
+	return hBody;
+}
+
+/**
+ @brief Destroy a body. Its handle may be reused by the next body which is created
+ */
+void CPhysicsWorld2D::DestroyBody(const HANDLE hBody)
+{
+	if ((hBody >= fTime.size()) || (!bAlive[hBody]))
+	{
+		cout << "CPhysicsWorld2D::DestroyBody: Invalid handle " << hBody << endl;
+		return;
+	}
+
+	bAlive[hBody] = false;
+	UpdateStepMask(hBody);
+	vFreeBodies.push_back(hBody);
+	uiNumBodies--;
+}
+
+/**
+ @brief Get the number of bodies which are alive
+ */
+unsigned int CPhysicsWorld2D::GetNumBodies(void) const
+{
+	return uiNumBodies;
+}
+
+/**
+ @brief Set the world gravity direction, and rotate the bodies which follow it
+ */
+void CPhysicsWorld2D::SetGravityDirection(const unsigned char ucGravityDirection)
+{
+	ucWorldGravityDirection = ucGravityDirection;
+	for (HANDLE hBody = 0; hBody < (HANDLE)fTime.size(); hBody++)
+	{
+		if (bAlive[hBody] && bFollowsWorldGravity[hBody])
+		{
+			this->ucGravityDirection[hBody] = ucGravityDirection;
+			UpdateGravity(hBody);
+		}
+	}
+}
+
+/**
+ @brief Get the world gravity direction
+ */
+unsigned char CPhysicsWorld2D::GetGravityDirection(void) const
+{
+	return ucWorldGravityDirection;
+}
+
+/**
+ @brief Integrate the bodies which are stepped by the world, and are not idle, in one loop.
+		The other bodies are masked out instead of skipped, so that the loop has no branches.
+ @param fElapsedTime A const float variable containing the time to add to each body
+ */
+void CPhysicsWorld2D::Step(const float fElapsedTime)
+{
+	const unsigned int uiSize = (unsigned int)fTime.size();
+	float* pfTime = fTime.data();
+	float* pfInitialVelocityX = fInitialVelocityX.data();
+	float* pfInitialVelocityY = fInitialVelocityY.data();
+	float* pfFinalVelocityX = fFinalVelocityX.data();
+	float* pfFinalVelocityY = fFinalVelocityY.data();
+	float* pfDisplacementX = fDisplacementX.data();
+	float* pfDisplacementY = fDisplacementY.data();
+	const float* pfGravityX = fGravityX.data();
+	const float* pfGravityY = fGravityY.data();
+	const float* pfStepMask = fStepMask.data();
+
+	for (unsigned int i = 0; i < uiSize; i++)
+	{
+		const float fMask = pfStepMask[i];
+		const float fKeep = 1.0f - fMask;
+
+		// Add the elapsed time
+		const float t = pfTime[i] + fElapsedTime * fMask;
+		// Calculate the final velocity
+		const float fFinalX = pfInitialVelocityX[i] + pfGravityX[i] * t;
+		const float fFinalY = pfInitialVelocityY[i] + pfGravityY[i] * t;
+		// Calculate the displacement
+		const float fDisplacementX = fFinalX * t - 0.5f * pfGravityX[i] * t * t;
+		const float fDisplacementY = fFinalY * t - 0.5f * pfGravityY[i] * t * t;
+
+		pfTime[i] = t;
+		pfFinalVelocityX[i] = fFinalX * fMask + pfFinalVelocityX[i] * fKeep;
+		pfFinalVelocityY[i] = fFinalY * fMask + pfFinalVelocityY[i] * fKeep;
+		pfDisplacementX[i] = fDisplacementX * fMask + pfDisplacementX[i] * fKeep;
+		pfDisplacementY[i] = fDisplacementY * fMask + pfDisplacementY[i] * fKeep;
+		// Update the initial velocity
+		pfInitialVelocityX[i] = fFinalX * fMask + pfInitialVelocityX[i] * fKeep;
+		pfInitialVelocityY[i] = fFinalY * fMask + pfInitialVelocityY[i] * fKeep;
+	}
+}
+
+/**
+ @brief Integrate one body with its current time. An idle body is not integrated.
+ */
+void CPhysicsWorld2D::Integrate(const HANDLE hBody)
+{
+	if (ucStatus[hBody] == CPhysics2D::IDLE)
+		return;
+
+	const float t = fTime[hBody];
+	// Calculate the final velocity
+	fFinalVelocityX[hBody] = fInitialVelocityX[hBody] + fGravityX[hBody] * t;
+	fFinalVelocityY[hBody] = fInitialVelocityY[hBody] + fGravityY[hBody] * t;
+	// Calculate the displacement
+	fDisplacementX[hBody] = fFinalVelocityX[hBody] * t - 0.5f * fGravityX[hBody] * t * t;
+	fDisplacementY[hBody] = fFinalVelocityY[hBody] * t - 0.5f * fGravityY[hBody] * t * t;
+	// Update the initial velocity
+	fInitialVelocityX[hBody] = fFinalVelocityX[hBody];
+	fInitialVelocityY[hBody] = fFinalVelocityY[hBody];
+}
+
+/**
+ @brief Set if a body follows the world gravity direction
+ */
+void CPhysicsWorld2D::SetFollowsWorldGravity(const HANDLE hBody, const bool bFollowsWorldGravity)
+{
+	this->bFollowsWorldGravity[hBody] = bFollowsWorldGravity;
+	if (bFollowsWorldGravity)
+	{
+		ucGravityDirection[hBody] = ucWorldGravityDirection;
+		UpdateGravity(hBody);
+	}
+}
+
+/**
+ @brief Check if a body follows the world gravity direction
+ */
+bool CPhysicsWorld2D::GetFollowsWorldGravity(const HANDLE hBody) const
+{
+	return (bFollowsWorldGravity[hBody] != 0);
+}
+
+/**
+ @brief Set if a body is stepped by Step, instead of by its owner
+ */
+void CPhysicsWorld2D::SetSteppedByWorld(const HANDLE hBody, const bool bSteppedByWorld)
+{
+	this->bSteppedByWorld[hBody] = bSteppedByWorld;
+	UpdateStepMask(hBody);
+}
+
+/**
+ @brief Check if a body is stepped by Step
+ */
+bool CPhysicsWorld2D::GetSteppedByWorld(const HANDLE hBody) const
+{
+	return (bSteppedByWorld[hBody] != 0);
+}
+
+/**
+ @brief Set the gravity direction of a body. This is ignored if the body follows the world gravity
+ */
+void CPhysicsWorld2D::SetBodyGravityDirection(const HANDLE hBody, const unsigned char ucGravityDirection)
+{
+	if (bFollowsWorldGravity[hBody])
+		return;
+
+	this->ucGravityDirection[hBody] = ucGravityDirection;
+	UpdateGravity(hBody);
+}
+
+/**
+ @brief Get the gravity direction of a body
+ */
+unsigned char CPhysicsWorld2D::GetBodyGravityDirection(const HANDLE hBody) const
+{
+	return ucGravityDirection[hBody];
+}
+
+/**
+ @brief Set the gravity magnitude of a body
+ */
+void CPhysicsWorld2D::SetBodyGravityMagnitude(const HANDLE hBody, const float fGravityMagnitude)
+{
+	this->fGravityMagnitude[hBody] = fGravityMagnitude;
+	UpdateGravity(hBody);
+}
+
+/**
+ @brief Get the gravity magnitude of a body
+ */
+float CPhysicsWorld2D::GetBodyGravityMagnitude(const HANDLE hBody) const
+{
+	return fGravityMagnitude[hBody];
+}
+
+/**
+ @brief Set the status of a body
+ */
+void CPhysicsWorld2D::SetBodyStatus(const HANDLE hBody, const unsigned char ucStatus)
+{
+	this->ucStatus[hBody] = ucStatus;
+	UpdateStepMask(hBody);
+}
+
+/**
+ @brief Get the status of a body
+ */
+unsigned char CPhysicsWorld2D::GetBodyStatus(const HANDLE hBody) const
+{
+	return ucStatus[hBody];
+}
+
+/**
+ @brief Reset the velocities, displacements and time of a body. The acceleration is not reset.
+ */
+void CPhysicsWorld2D::ResetBody(const HANDLE hBody)
+{
+	fInitialVelocityX[hBody] = 0.0f;
+	fInitialVelocityY[hBody] = 0.0f;
+	fFinalVelocityX[hBody] = 0.0f;
+	fFinalVelocityY[hBody] = 0.0f;
+	fDisplacementX[hBody] = 0.0f;
+	fDisplacementY[hBody] = 0.0f;
+	fPrevDisplacementX[hBody] = 0.0f;
+	fPrevDisplacementY[hBody] = 0.0f;
+	fTime[hBody] = 0.0f;
+}
+
+/**
+ @brief Update the gravity vector of a body from its direction and magnitude
+ */
+void CPhysicsWorld2D::UpdateGravity(const HANDLE hBody)
+{
+	// The gravity direction vectors, in the order of CPhysics2D::GRAVITY_DIRECTION
+	static const float arrGravityX[CPhysics2D::GRAVITY_COUNT] = { 0.0f, 0.0f, 1.0f, -1.0f };
+	static const float arrGravityY[CPhysics2D::GRAVITY_COUNT] = { -1.0f, 1.0f, 0.0f, 0.0f };
+
+	const unsigned char ucDirection = ucGravityDirection[hBody];
+	if (ucDirection >= CPhysics2D::GRAVITY_COUNT)
+	{
+		cout << "CPhysicsWorld2D::UpdateGravity: Unknown gravity direction." << endl;
+		return;
+	}
+	fGravityX[hBody] = arrGravityX[ucDirection] * fGravityMagnitude[hBody];
+	fGravityY[hBody] = arrGravityY[ucDirection] * fGravityMagnitude[hBody];
+}
+
+/**
+ @brief Update the step mask of a body from its flags and status
+ */
+void CPhysicsWorld2D::UpdateStepMask(const HANDLE hBody)
+{
+	fStepMask[hBody] = (bAlive[hBody] && bSteppedByWorld[hBody] && (ucStatus[hBody] != CPhysics2D::IDLE)) ? 1.0f : 0.0f;
+}
@@ -0,0 +1,114 @@
+/**
+ CPhysicsWorld2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector
+#include <vector>
+
+/**
+ CPhysicsWorld2D: Owns the state of every physics body in structure-of-arrays form,
+				  with 1 float array per component so that Step can integrate all the bodies in one loop.
+				  CPhysics2D is a handle to a body in this world.
+				  The world has one gravity direction. Bodies which follow the world gravity are rotated
+				  together when it changes, and the other bodies keep their own gravity direction.
+ */
+class CPhysicsWorld2D : public CSingletonTemplate<CPhysicsWorld2D>
+{
+	friend CSingletonTemplate<CPhysicsWorld2D>;
+public:
+	// A handle to a body
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// Create a body and return its handle
+	HANDLE CreateBody(void);
+	// Destroy a body. Its handle may be reused by the next body which is created
+	void DestroyBody(const HANDLE hBody);
+	// Get the number of bodies which are alive
+	unsigned int GetNumBodies(void) const;
+
+	// Set the world gravity direction, using the values of CPhysics2D::GRAVITY_DIRECTION
+	void SetGravityDirection(const unsigned char ucGravityDirection);
+	// Get the world gravity direction
+	unsigned char GetGravityDirection(void) const;
+
+	// Integrate the bodies which are stepped by the world, and are not idle, in one loop
+	void Step(const float fElapsedTime);
+	// Integrate one body with its current time
+	void Integrate(const HANDLE hBody);
+
+	// Set if a body follows the world gravity direction
+	void SetFollowsWorldGravity(const HANDLE hBody, const bool bFollowsWorldGravity);
+	// Check if a body follows the world gravity direction
+	bool GetFollowsWorldGravity(const HANDLE hBody) const;
+	// Set if a body is stepped by Step, instead of by its owner
+	void SetSteppedByWorld(const HANDLE hBody, const bool bSteppedByWorld);
+	// Check if a body is stepped by Step
+	bool GetSteppedByWorld(const HANDLE hBody) const;
+	// Set the gravity direction of a body. This is ignored if the body follows the world gravity
+	void SetBodyGravityDirection(const HANDLE hBody, const unsigned char ucGravityDirection);
+	// Get the gravity direction of a body
+	unsigned char GetBodyGravityDirection(const HANDLE hBody) const;
+	// Set the gravity magnitude of a body
+	void SetBodyGravityMagnitude(const HANDLE hBody, const float fGravityMagnitude);
+	// Get the gravity magnitude of a body
+	float GetBodyGravityMagnitude(const HANDLE hBody) const;
+	// Set the status of a body, using the values of CPhysics2D::STATUS
+	void SetBodyStatus(const HANDLE hBody, const unsigned char ucStatus);
+	// Get the status of a body
+	unsigned char GetBodyStatus(const HANDLE hBody) const;
+	// Reset the velocities, displacements and time of a body
+	void ResetBody(const HANDLE hBody);
+
+	// The state of the bodies. Each array is indexed by the body's handle
+	std::vector<float> fInitialVelocityX, fInitialVelocityY;
+	std::vector<float> fFinalVelocityX, fFinalVelocityY;
+	std::vector<float> fAccelerationX, fAccelerationY;
+	std::vector<float> fDisplacementX, fDisplacementY;
+	std::vector<float> fPrevDisplacementX, fPrevDisplacementY;
+	std::vector<float> fTime;
+
+protected:
+	// The gravity vector of each body, which is its gravity direction multiplied by its gravity magnitude
+	std::vector<float> fGravityX, fGravityY;
+	// The gravity magnitude of each body
+	std::vector<float> fGravityMagnitude;
+	// 1 if a body is integrated by Step, else 0. This is kept as a float so that Step does not branch
+	std::vector<float> fStepMask;
+	// The gravity direction and status of each body
+	std::vector<unsigned char> ucGravityDirection;
+	std::vector<unsigned char> ucStatus;
+	// The flags of each body
+	std::vector<unsigned char> bAlive;
+	std::vector<unsigned char> bFollowsWorldGravity;
+	std::vector<unsigned char> bSteppedByWorld;
+
+	// The handles of destroyed bodies, which can be reused
+	std::vector<HANDLE> vFreeBodies;
+	// The number of bodies which are alive
+	unsigned int uiNumBodies;
+
+	// The world gravity direction
+	unsigned char ucWorldGravityDirection;
+
+	// Constructor
+	CPhysicsWorld2D(void);
+
+	// Destructor
+	virtual ~CPhysicsWorld2D(void);
+
+	// Update the gravity vector of a body from its direction and magnitude
+	void UpdateGravity(const HANDLE hBody);
+	// Update the step mask of a body from its flags and status
+	void UpdateStepMask(const HANDLE hBody);
+};
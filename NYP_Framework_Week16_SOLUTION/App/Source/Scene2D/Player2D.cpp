@@ -7,14 +7,19 @@
 
 #include "System/MyMath.h"
 
+// Include Random
+#include "System\Random.h"
+
 #include <iostream>
 using namespace std;
 
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
@@ -25,17 +30,32 @@ using namespace std;
 
 #include "Bomb2D.h"
 
+// Include ComponentStore2D
+#include "ComponentStore2D.h"
+
+// Include KinematicSolver2D
+#include "KinematicSolver2D.h"
+
+// Include GravityKernel2D
+#include "GravityKernel2D.h"
+
+// Include ParticleSystem2D
+#include "ParticleSystem2D.h"
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
 CPlayer2D::CPlayer2D(void)
 	: cMap2D(NULL)
 	, cKeyboardController(NULL)
-	, cInventoryManager(NULL)
-	, cInventoryItem(NULL)
-	, bombThrowCD(0.0f)
+	, cTimerWheel(NULL)
+	, hBombThrowCooldown(CTimerWheel::INVALID_HANDLE)
+	, hJumpCooldown(CTimerWheel::INVALID_HANDLE)
+	, hSwitchGravityTimer(CTimerWheel::INVALID_HANDLE)
 	, jumpBoostCD(0.0f)
 	, dJumpCount(0)
+	, cInventoryManager(NULL)
+	, cInventoryItem(NULL)
 	, cItemSpawner(NULL)
 	, cSoundController(NULL)
 {
@@ -70,11 +90,14 @@ CPlayer2D::~CPlayer2D(void)
 	// We won't delete this since it was created elsewhere
 	cItemSpawner = NULL;
 
+	// We won't delete this since it was created elsewhere
+	cTimerWheel = NULL;
+
 	// We won't delete this since it was created elsewhere
 	cMap2D = NULL;
 
 	// optional: de-allocate all resources once they've outlived their purpose:
-	glDeleteVertexArrays(1, &VAO);
+	CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
 }
 
 /**
@@ -107,6 +130,9 @@ bool CPlayer2D::Reset()
 	//CS: Init the color to white
 	currentColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
 
+	// Do not render the player moving from its position in the previous level
+	ResetRenderTransform();
+
 	return true;
 }
 
@@ -119,7 +145,13 @@ bool CPlayer2D::Init(void)
 	cKeyboardController = CKeyboardController::GetInstance();
 	// Reset all keys since we are starting a new game
 	cKeyboardController->Reset();
-	nextSwitchCD = Math::RandFloatMinMax(12.5f, 20.f);
+
+	// The timers of a previous game were removed when the CTimerWheel was initialised, so forget their handles
+	cTimerWheel = CTimerWheel::GetInstance();
+	hBombThrowCooldown = CTimerWheel::INVALID_HANDLE;
+	hJumpCooldown = CTimerWheel::INVALID_HANDLE;
+	// Schedule the first switch of the gravity
+	hSwitchGravityTimer = cTimerWheel->Schedule(CRandomStreams::GetInstance()->GetStream(CRandomStreams::STREAM_WORLD).RandFloatMinMax(12.5f, 20.f), [this]() { SwitchGravity(); });
 
 	// Get the handler to the CSettings instance
 	cSettings = CSettings::GetInstance();
@@ -143,7 +175,7 @@ bool CPlayer2D::Init(void)
 	i32vec2NumMicroSteps = glm::i32vec2(0, 0);
 
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 	
 	// Load the player texture
 	if (LoadTexture("Image/scene2d_player.png", iTextureID) == false)
@@ -163,6 +195,8 @@ bool CPlayer2D::Init(void)
 	//CS: Init the color to white
 	currentColor = glm::vec4(1.0, 1.0, 1.0, 1.0);
 
+	// The player's gravity is the world gravity, so switching it is seen by every body which follows it
+	cPhysics2D.SetFollowsWorldGravity(true);
 	// Set the Physics to fall status by default
 	cPhysics2D.Init();
 	cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
@@ -216,73 +250,17 @@ void CPlayer2D::Update(const double dElapsedTime)
 		{
 			if (!cMap2D->FindValue(CMap2D::TILE_ID::BOMB_SMALL, a, b))
 			{
-				autoSpawnBombCD = Math::RandFloatMinMax(2.f, 5.f);
+				autoSpawnBombCD = CRandomStreams::GetInstance()->GetStream(CRandomStreams::STREAM_SPAWNING).RandFloatMinMax(2.f, 5.f);
 				cItemSpawner->SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::BOMB_SMALL, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
 			}
 		}
 		
 	}
 
-	if (bombThrowCD > 0.0)
-	{
-		bombThrowCD -= dElapsedTime;
-	}
-	if (jumpCD > 0.0)
-	{
-		jumpCD -= dElapsedTime;
-	}
-	if (nextSwitchCD > 0.0)
-	{
-		nextSwitchCD -= dElapsedTime;
-		if (nextSwitchCD <= 0)
-		{
-
-			//Play warp sound
-			CSoundController::GetInstance()->PlaySoundByID(SOUND_TYPE::LEVEL_ROTATION);
-
-			cMap2D->ClearInteractables();
-			nextSwitchCD = Math::RandFloatMinMax(5.5f, 18.f);
-			std::vector<int> nums;
-			nums.push_back(0);
-			nums.push_back(1);
-			nums.push_back(2);
-			nums.push_back(3);
-			nums.erase(nums.begin() + (int)cPhysics2D.GetGravityDirection());
-			switch (nums.at(Math::RandIntMinMax(0, 2)))
-			{
-			case 0:
-				cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN);
-				break;
-			case 1:
-				cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP);
-				break;
-			case 2:
-				cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT);
-				break;
-			case 3:
-				cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT);
-				break;
-			}
-			cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-			cMap2D->SetCurrentLevel(cPhysics2D.GetGravityDirection());
-
-			cItemSpawner->SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::BOMB_SMALL, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
-			
-			if (Math::RandIntMinMax(0, 1) == 0)
-			{
-				cItemSpawner->SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::POWERUP_DOUBLEJUMP, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
-			
-			}
-
-			glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP);
-			relativeDir *= 0.1;
-			cPhysics2D.SetInitialVelocity(relativeDir);
-		}
-	}
 	// Get keyboard updates
-	if (cKeyboardController->IsKeyDown(GLFW_KEY_SPACE) && jumpCD <= 0.0)
+	if (cKeyboardController->IsKeyDown(GLFW_KEY_SPACE) && !cTimerWheel->IsPending(hJumpCooldown))
 	{
-		jumpCD = 0.15f;
+		hJumpCooldown = cTimerWheel->Schedule(0.15);
 		if (cPhysics2D.GetStatus() == CPhysics2D::STATUS::IDLE)
 		{
 			cPhysics2D.SetStatus(CPhysics2D::STATUS::JUMP);
@@ -322,15 +300,13 @@ void CPlayer2D::Update(const double dElapsedTime)
 	if (cKeyboardController->IsKeyDown(GLFW_KEY_F))
 	{
 		cInventoryItem = cInventoryManager->GetItem("Bomb");
-		if (cInventoryItem->GetCount() > 0 && bombThrowCD <= 0)
+		// Only use up a bomb if the bomb pool has a free bomb to spawn
+		if (cInventoryItem->GetCount() > 0 && !cTimerWheel->IsPending(hBombThrowCooldown) &&
+			cEntityManager2D->SpawnBomb(cPhysics2D.GetGravityDirection(), i32vec2Index.x, i32vec2Index.y) != NULL)
 		{
-			bombThrowCD = 0.5f;
+			hBombThrowCooldown = cTimerWheel->Schedule(0.5);
 			cPhysics2D.SetInitialVelocity(glm::vec2(0.f, 0.1f));
 			cInventoryItem->Remove(1);
-			CBomb2D* bomb = new CBomb2D();
-			bomb->Init(cPhysics2D.GetGravityDirection(), i32vec2Index.x, i32vec2Index.y);
-			bomb->SetShader("2DColorShader");
-			cEntityManager2D->AddEntity(bomb);
 		}
 		
 	}
@@ -377,6 +353,11 @@ void CPlayer2D::Update(const double dElapsedTime)
 	// Update the UV Coordinates
 	vec2UVCoordinate.x = cSettings->ConvertIndexToUVSpace(cSettings->x, i32vec2Index.x, false, i32vec2NumMicroSteps.x*cSettings->MICRO_STEP_XAXIS);
 	vec2UVCoordinate.y = cSettings->ConvertIndexToUVSpace(cSettings->y, i32vec2Index.y, false, i32vec2NumMicroSteps.y*cSettings->MICRO_STEP_YAXIS);
+
+	// Update the components. The UV coordinates are kept here too, as the player is also updated outside of CEntityManager2D
+	CComponentStore2D* cComponentStore2D = CComponentStore2D::GetInstance();
+	cComponentStore2D->SetPhysics(uiComponentHandle, cPhysics2D.GetFinalVelocity(), (unsigned char)cPhysics2D.GetStatus());
+	cComponentStore2D->SetSprite(uiComponentHandle, iTextureID, currentColor);
 }
 
 void CPlayer2D::SwitchToMap(CPhysics2D::GRAVITY_DIRECTION)
@@ -384,17 +365,71 @@ void CPlayer2D::SwitchToMap(CPhysics2D::GRAVITY_DIRECTION)
 
 }
 
+/**
+ @brief Switch the gravity to a random direction, and schedule the next switch. This is called by the CTimerWheel
+ */
+void CPlayer2D::SwitchGravity(void)
+{
+	CRandomStreams* cRandomStreams = CRandomStreams::GetInstance();
+	CRandom& cWorldRandom = cRandomStreams->GetStream(CRandomStreams::STREAM_WORLD);
+
+	hSwitchGravityTimer = cTimerWheel->Schedule(cWorldRandom.RandFloatMinMax(5.5f, 18.f), [this]() { SwitchGravity(); });
+
+	//Play warp sound
+	CSoundController::GetInstance()->PlaySoundByID(SOUND_TYPE::LEVEL_ROTATION);
+
+	cMap2D->ClearInteractables();
+	std::vector<int> nums;
+	nums.push_back(0);
+	nums.push_back(1);
+	nums.push_back(2);
+	nums.push_back(3);
+	nums.erase(nums.begin() + (int)cPhysics2D.GetGravityDirection());
+	switch (nums.at(cWorldRandom.RandIntMinMax(0, 2)))
+	{
+	case 0:
+		cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN);
+		break;
+	case 1:
+		cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP);
+		break;
+	case 2:
+		cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT);
+		break;
+	case 3:
+		cPhysics2D.SetGravityDirection(CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT);
+		break;
+	}
+	cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
+	cMap2D->SetCurrentLevel(cPhysics2D.GetGravityDirection());
+
+	// Wake up all resting entities since the gravity has changed
+	cEntityManager2D->WakeAllEntities();
+
+	cItemSpawner->SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::BOMB_SMALL, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
+	
+	if (cRandomStreams->GetStream(CRandomStreams::STREAM_SPAWNING).RandIntMinMax(0, 1) == 0)
+	{
+		cItemSpawner->SpawnObjectOnRandomPlatform(CMap2D::TILE_ID::POWERUP_DOUBLEJUMP, cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP));
+	
+	}
+
+	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP);
+	relativeDir *= 0.1;
+	cPhysics2D.SetInitialVelocity(relativeDir);
+}
+
 /**
  @brief Set up the OpenGL display environment before rendering
  */
 void CPlayer2D::PreRender(void)
 {
 	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
 
 	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use(sShaderName);
@@ -405,28 +440,27 @@ void CPlayer2D::PreRender(void)
  */
 void CPlayer2D::Render(void)
 {
-	glBindVertexArray(VAO);
-	// get matrix's uniform location and set matrix
-	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
-	unsigned int colorLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "runtime_color");
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+	// Get the active shader, which keeps the locations of its uniforms
+	CShader* cShader = CShaderManager::GetInstance()->activeShader;
 
 	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	transform = glm::translate(transform, glm::vec3(vec2UVCoordinate.x,
-													vec2UVCoordinate.y,
+	const glm::vec2 vec2RenderUVCoordinate = GetRenderUVCoordinate();
+	transform = glm::translate(transform, glm::vec3(vec2RenderUVCoordinate.x,
+													vec2RenderUVCoordinate.y,
 													0.0f));
 	transform = glm::rotate(transform, 0.8f, glm::vec3(0, 0, 1));
 	// Update the shaders with the latest transform
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
-	glUniform4fv(colorLoc, 1, glm::value_ptr(currentColor));
+	cShader->setMat4(UNIFORM_TRANSFORM, transform);
+	cShader->setVec4(UNIFORM_RUNTIME_COLOR, currentColor);
 
 	// Get the texture to be rendered
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, iTextureID);
 
 	//CS: Render the animated sprite
 	animatedSprites->Render();
 
-	glBindVertexArray(0);
+	CGLStateCache::GetInstance()->BindVertexArray(0);
 
 }
 
@@ -435,50 +469,21 @@ void CPlayer2D::Render(void)
  */
 void CPlayer2D::PostRender(void)
 {
-	// Disable blending
-	glDisable(GL_BLEND);
 }
 
 /**
-@brief Load a texture, assign it a code and store it in MapOfTextureIDs.
+@brief Load a texture from the texture cache, which only loads the file once for all the users of the texture.
 @param filename A const char* variable which contains the file name of the texture
+@param iTextureID A GLuint& variable which is set to the texture ID. The texture which it had before is released
 */
 bool CPlayer2D::LoadTexture(const char* filename, GLuint& iTextureID)
 {
-	// Variables used in loading the texture
-	int width, height, nrChannels;
-	
-	// texture 1
-	// ---------
-	glGenTextures(1, &iTextureID);
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
-	// set the texture wrapping parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// set texture filtering parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-	unsigned char *data = cImageLoader->Load(filename, width, height, nrChannels, true);
-	if (data)
-	{
-		if (nrChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (nrChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	CTextureCache* cTextureCache = CTextureCache::GetInstance();
+	if (iTextureID != 0)
+		cTextureCache->Release(iTextureID);
 
-		// Generate mipmaps
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		return false;
-	}
-	// Free up the memory of the file data read in
-	free(data);
-
-	return true;
+	iTextureID = cTextureCache->Acquire(filename, true, GL_REPEAT, GL_LINEAR, true);
+	return iTextureID != 0;
 }
 
 void CPlayer2D::Move(CPhysics2D::DIRECTION eDirection, const double dElapsedTime)
@@ -640,43 +645,8 @@ void CPlayer2D::Move(CPhysics2D::DIRECTION eDirection, const double dElapsedTime
  */
 void CPlayer2D::Constraint(CPhysics2D::DIRECTION eDirection)
 {
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(eDirection);
-	if (relativeDir.x == -1)
-	{
-		if (i32vec2Index.x <= 0)
-		{
-			i32vec2Index.x = 0;
-			i32vec2NumMicroSteps.x = 0;
-		}
-	}
-	else if (relativeDir.x == 1)
-	{
-		if (i32vec2Index.x >= (int)cSettings->NUM_TILES_XAXIS - 1)
-		{
-			i32vec2Index.x = ((int)cSettings->NUM_TILES_XAXIS) - 1;
-			i32vec2NumMicroSteps.x = 0;
-		}
-	}
-	else if (relativeDir.y == 1)
-	{
-		if (i32vec2Index.y >= (int)cSettings->NUM_TILES_YAXIS - 1)
-		{
-			i32vec2Index.y = ((int)cSettings->NUM_TILES_YAXIS) - 1;
-			i32vec2NumMicroSteps.y = 0;
-		}
-	}
-	else if (relativeDir.y == -1)
-	{
-		if (i32vec2Index.y <= 0)
-		{
-			i32vec2Index.y = 0;
-			i32vec2NumMicroSteps.y = 0;
-		}
-	}
-	else
-	{
-		cout << "CPlayer2D::Constraint: Unknown direction." << endl;
-	}
+	CKinematicSolver2D::Constraint(	cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps,
+									CKinematicSolver2D::GetDirVector(cPhysics2D.GetGravityDirection(), eDirection));
 }
 
 /**
@@ -685,158 +655,40 @@ void CPlayer2D::Constraint(CPhysics2D::DIRECTION eDirection)
  */
 bool CPlayer2D::CheckPosition(CPhysics2D::DIRECTION eDirection)
 {
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(eDirection);
-	if (relativeDir.x == -1)
-	{
-
-		if (i32vec2Index.x < 0)
-		{
-			i32vec2NumMicroSteps.x = 0;
-			return false;
-		}
-
-		// If the new position is between 2 rows, then check both rows as well
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x) >= 100))
-		{
-			return false;
-		}
-		
-	}
-	else if (relativeDir.x == 1)
-	{
-
-		if (i32vec2Index.x >= cSettings->NUM_TILES_XAXIS)
-		{
-			i32vec2NumMicroSteps.x = 0;
-			return false;
-		}
-
-		// If the new position is between 2 rows, then check both rows as well
-		//// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
-		
-
-
-	}
-	else if (relativeDir.y == 1)
-	{
-
-		if (i32vec2Index.y >= cSettings->NUM_TILES_YAXIS)
-		{
-			i32vec2NumMicroSteps.y = 0;
-			return false;
-		}
-
-
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y + (i32vec2NumMicroSteps.y > 0 ? 1 : 0), i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
-		
-	}
-	else if (relativeDir.y == -1)
-	{
-
-		if (i32vec2Index.y < 0)
-		{
-			i32vec2NumMicroSteps.y = 0;
-			return false;
-		}
-
-		//// If the new position is between 2 columns, then check both columns as well
-		// If the 2 grids are not accessible, then return false
-		if ((cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x) >= 100) ||
-			(cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x + (i32vec2NumMicroSteps.x > 0 ? 1 : 0)) >= 100))
-		{
-			return false;
-		}
-		
-	}
-	else
-	{
-		cout << "CPlayer2D::CheckPosition: Unknown direction." << endl;
-	}
-
-	return true;
+	return CKinematicSolver2D::CheckPosition(	cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps,
+												CKinematicSolver2D::GetDirVector(cPhysics2D.GetGravityDirection(), eDirection));
 }
 
-
+/**
+ @brief Check if the player is on the bottom row, based on the gravity direction
+ */
 bool CPlayer2D::PlayerIsOnBottomRow() {
-	switch (cPhysics2D.GetGravityDirection())
-	{
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN:
-		if (i32vec2Index.y <= 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP:
-		if (i32vec2Index.y >= cSettings->NUM_TILES_YAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT:
-		if (i32vec2Index.x <= 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT:
-		if (i32vec2Index.x >= cSettings->NUM_TILES_XAXIS - 1)
-			return true;
-		break;
-	}
-	return false;
+	return CKinematicSolver2D::IsOnBottomRow(cMap2D->GetGridView(), i32vec2Index, cPhysics2D.GetGravityDirection());
 }
 
+/**
+ @brief Check if the player is on the top row, based on the gravity direction
+ */
 bool CPlayer2D::PlayerIsOnTopRow() {
-	switch (cPhysics2D.GetGravityDirection())
-	{
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_DOWN:
-		if (i32vec2Index.y == cSettings->NUM_TILES_YAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_UP:
-		if (i32vec2Index.y == 0)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_LEFT:
-		if (i32vec2Index.x == cSettings->NUM_TILES_XAXIS - 1)
-			return true;
-		break;
-	case CPhysics2D::GRAVITY_DIRECTION::GRAVITY_RIGHT:
-		if (i32vec2Index.x == 0)
-			return true;
-		break;
-	}
-	return false;
+	return CKinematicSolver2D::IsOnTopRow(cMap2D->GetGridView(), i32vec2Index, cPhysics2D.GetGravityDirection());
 }
 
 // Check if the player is in mid-air
 bool CPlayer2D::IsMidAir(void)
 {
-	// if the player is at the bottom row, then he is not in mid-air for sure
-	if (PlayerIsOnBottomRow()) return false;
-
-
-	// Check if the tile below the player's current position is empty
-	glm::vec2 relativeDir = cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::DOWN);
-
-	if ((i32vec2NumMicroSteps.x == 0 || i32vec2NumMicroSteps.y == 0) &&
-		(cMap2D->GetMapInfo(i32vec2Index.y + relativeDir.y, i32vec2Index.x + relativeDir.x) <= CMap2D::TILE_ID::INTERACTABLES_END))
-	{
-		return true;
-	}
-
-	return false;
+	return CKinematicSolver2D::IsMidAir(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, cPhysics2D.GetGravityDirection());
 }
 
-// Update Jump or Fall
-void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
+/**
+ @brief Update Jump or Fall for a gravity direction. 
+		The axis and sign of the movement are constants in each instance of this template.
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+void CPlayer2D::UpdateJumpFallKernel(const double dElapsedTime)
 {
+	typedef CGravityKernel2D<eGravityDirection> KERNEL;
+
 	CPhysics2D::STATUS oldStatus = cPhysics2D.GetStatus();
 	float fallenMag = 0.0;
 	if (cPhysics2D.GetStatus() == CPhysics2D::STATUS::JUMP)
@@ -850,123 +702,30 @@ void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
 		glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
 		std::cout << v2Displacement.x << " " << v2Displacement.y << std::endl;
 
-		if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_DOWN)
-		{
-			// Store the current i32vec2Index.y
-			int iIndex_YAxis_OLD = i32vec2Index.y;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.y / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.y * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
-			if (iDisplacement_MicroSteps != 0)
-			{
-				iDisplacement++;
-			}
+		// Store the current index
+		glm::i32vec2 i32vec2StartIndex = i32vec2Index;
 
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).y;
-			fallenMag = iDisplacement;
-			// Update the indices
-			i32vec2Index.y += iDisplacement;
-			i32vec2NumMicroSteps.y = 0;
+		// Translate the displacement from pixels to indices
+		int iDisplacement = KERNEL::DisplacementToTiles(v2Displacement,
+														cSettings->TILE_HEIGHT,
+														(float)cSettings->iWindowHeight,
+														KERNEL::GetNumStepsPerTile(cSettings->NUM_STEPS_PER_TILE_XAXIS, cSettings->NUM_STEPS_PER_TILE_YAXIS),
+														true);
+		iDisplacement *= KERNEL::UP_SIGN;
+		fallenMag = iDisplacement;
 
-			// Constraint the player's position within the screen boundary
-			Constraint(CPhysics2D::DIRECTION::UP);
+		// Update the indices
+		i32vec2Index[KERNEL::AXIS] += iDisplacement;
+		i32vec2NumMicroSteps[KERNEL::AXIS] = 0;
 
-			// Iterate through all rows until the proposed row
-			// Check if the player will hit a tile; stop jump if so.
-			int iIndex_YAxis_Proposed = i32vec2Index.y;
+		// Constraint the player's position within the screen boundary
+		CKinematicSolver2D::Constraint(cMap2D->GetGridView(), i32vec2Index, i32vec2NumMicroSteps, KERNEL::GetUpVector());
 
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP)
-			{
-				for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::UP) == false)
-					{
-						i32vec2Index.y = i + 1;
-						// Set the Physics to fall status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::UP) == false)
-					{
-						i32vec2Index.y = i - 1;
-						// Set the Physics to fall status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-						break;
-					}
-				}
-			}
-		}
-		else if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_LEFT || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
+		// Check if the player will hit a tile on the way to the proposed index; stop jump if so.
+		if (SweepToIndex(i32vec2StartIndex))
 		{
-			// Store the current i32vec2Index.x
-			int iIndex_YAxis_OLD = i32vec2Index.x;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.x / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.x * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
-			if (iDisplacement_MicroSteps != 0)
-			{
-				iDisplacement++;
-			}
-
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).x;
-
-			// Update the indices
-			i32vec2Index.x += iDisplacement;
-			i32vec2NumMicroSteps.x = 0;
-			fallenMag = iDisplacement;
-			// Constraint the plaxer's position within the screen boundarx
-			Constraint(CPhysics2D::DIRECTION::UP);
-
-			// Iterate through all rows until the proposed row
-			// Check if the plaxer will hit a tile; stop jump if so.
-			int iIndex_YAxis_Proposed = i32vec2Index.x;
-
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
-			{
-				for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::UP) == false)
-					{
-						i32vec2Index.x = i + 1;
-						// Set the Phxsics to fall status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::UP) == false)
-					{
-						i32vec2Index.x = i - 1;
-						// Set the Phxsics to fall status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
-						break;
-					}
-				}
-			}
+			// Set the Physics to fall status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::FALL);
 		}
 
 		// If the player is still jumping and the initial velocity has reached zero or below zero, 
@@ -986,150 +745,36 @@ void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
 		// Get the displacement from the physics engine
 		glm::vec2 v2Displacement = cPhysics2D.GetDisplacement();
 
+		// Store the current index
+		glm::i32vec2 i32vec2StartIndex = i32vec2Index;
 
-		if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_DOWN)
-		{
-			// Store the current i32vec2Index.y
-			int iIndex_YAxis_OLD = i32vec2Index.y;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.y / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.y * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_YAXIS;
-			if (iDisplacement_MicroSteps > 0)
-			{
-				iDisplacement++;
-			}
-
-			// Update the indices
-			i32vec2Index.y += iDisplacement;
-			i32vec2NumMicroSteps.y = 0;
-
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).y;
-			fallenMag = iDisplacement;
-			// Constraint the player's position within the screen boundary
-			Constraint(CPhysics2D::DIRECTION::DOWN);
-			
-			
-			// Iterate through all rows until the proposed row
-			// Check if the player will hit a tile; stop fall if so.
-			int iIndex_YAxis_Proposed = i32vec2Index.y;
-
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_UP)
-			{
-				//if I = 22, I < 24, i++ (WIll fall backwards, towards UP GRAVITY
-				for (int i = iIndex_YAxis_OLD; i <= iIndex_YAxis_Proposed; i++)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						// Revert to the previous position
-						if (i != iIndex_YAxis_OLD)
-							i32vec2Index.y = i - 1;
-						// Set the Physics to idle status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-
-						dJumpCount = 0;
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_YAxis_OLD; i >= iIndex_YAxis_Proposed; i--)
-				{
-					// Change the player's index to the current i value
-					i32vec2Index.y = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						// Revert to the previous position
-						if (i != iIndex_YAxis_OLD)
-							i32vec2Index.y = i + 1;
-						// Set the Physics to idle status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-
-						dJumpCount = 0;
-						break;
-					}
-				}
-			}
-		}
-		else if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_LEFT || cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
-		{
-			// Store the current i32vec2Index.x
-			int iIndex_XAxis_OLD = i32vec2Index.x;
-
-			// Translate the displacement from pixels to indices
-			int iDisplacement = (int)(v2Displacement.x / cSettings->TILE_HEIGHT);
-			int iDisplacement_MicroSteps = (int)((v2Displacement.x * cSettings->iWindowHeight) - iDisplacement) /
-				(int)cSettings->NUM_STEPS_PER_TILE_XAXIS;
-			if (iDisplacement_MicroSteps > 0)
-			{
-				iDisplacement++;
-			}
+		// Translate the displacement from pixels to indices
+		int iDisplacement = KERNEL::DisplacementToTiles(v2Displacement,
+														cSettings->TILE_HEIGHT,
+														(float)cSettings->iWindowHeight,
+														KERNEL::GetNumStepsPerTile(cSettings->NUM_STEPS_PER_TILE_XAXIS, cSettings->NUM_STEPS_PER_TILE_YAXIS),
+														false);
 
-			// Update the indices
-			i32vec2Index.x += iDisplacement;
-			i32vec2NumMicroSteps.x = 0;
+		// Update the indices
+		i32vec2Index[KERNEL::AXIS] += iDisplacement;
+		i32vec2NumMicroSteps[KERNEL::AXIS] = 0;
 
-			iDisplacement *= cPhysics2D.GetRelativeDirVector(CPhysics2D::DIRECTION::UP).x;
-			fallenMag = iDisplacement;
-			// Constraint the plaxer's position within the screen boundarx
-			Constraint(CPhysics2D::DIRECTION::DOWN);
+		fallenMag = iDisplacement * KERNEL::UP_SIGN;
 
+		// Constraint the player's position within the screen boundary
+		const TileGridView2D sGrid = cMap2D->GetGridView();
+		CKinematicSolver2D::Constraint(sGrid, i32vec2Index, i32vec2NumMicroSteps, KERNEL::GetDownVector());
 
-			// Iterate through all rows until the proposed row
-			// Check if the plaxer will hit a tile; stop fall if so.
-			int iIndex_XAxis_Proposed = i32vec2Index.x;
+		// Check if the player will hit a tile on the way to the proposed index; stop fall if so.
+		if (SweepToIndex(i32vec2StartIndex))
+		{
+			// Set the Physics to idle status
+			cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
 
-			if (cPhysics2D.GetGravityDirection() == CPhysics2D::GRAVITY_RIGHT)
-			{
-				//if I = 22, I < 24, i++ (WIll fall backwards, towards UP GRAVITX
-				for (int i = iIndex_XAxis_OLD; i <= iIndex_XAxis_Proposed; i++)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-		
-					
-
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						// Revert to the previous position
-						if (i != iIndex_XAxis_OLD)
-							i32vec2Index.x = i - 1;
-						// Set the Phxsics to idle status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-
-						dJumpCount = 0;
-						break;
-					}
-				}
-			}
-			else {
-				for (int i = iIndex_XAxis_OLD; i >= iIndex_XAxis_Proposed; i--)
-				{
-					// Change the plaxer's index to the current i value
-					i32vec2Index.x = i;
-					// If the new position is not feasible, then revert to old position
-					if (CheckPosition(CPhysics2D::DIRECTION::DOWN) == false)
-					{
-						// Revert to the previous position
-						if (i != iIndex_XAxis_OLD)
-							i32vec2Index.x = i + 1;
-						// Set the Phxsics to idle status
-						cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
-
-						dJumpCount = 0;
-						break;
-					}
-				}
-			}
+			dJumpCount = 0;
 		}
 
-
-		if (PlayerIsOnBottomRow())
+		if (KERNEL::IsOnBottomRow(sGrid, i32vec2Index))
 		{
 			cPhysics2D.SetStatus(CPhysics2D::STATUS::IDLE);
 		}
@@ -1141,21 +786,83 @@ void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
 	}
 }
 
+// Update Jump or Fall
+void CPlayer2D::UpdateJumpFall(const double dElapsedTime)
+{
+	// The jump and fall updates for each gravity direction, in the order of CPhysics2D::GRAVITY_DIRECTION
+	typedef void (CPlayer2D::*JUMPFALL_KERNEL)(const double dElapsedTime);
+	static const JUMPFALL_KERNEL arrJumpFallKernels[CPhysics2D::GRAVITY_COUNT] = {
+		&CPlayer2D::UpdateJumpFallKernel<CPhysics2D::GRAVITY_DOWN>,
+		&CPlayer2D::UpdateJumpFallKernel<CPhysics2D::GRAVITY_UP>,
+		&CPlayer2D::UpdateJumpFallKernel<CPhysics2D::GRAVITY_RIGHT>,
+		&CPlayer2D::UpdateJumpFallKernel<CPhysics2D::GRAVITY_LEFT>
+	};
+
+	(this->*arrJumpFallKernels[cPhysics2D.GetGravityDirection()])(dElapsedTime);
+}
+
+/**
+ @brief Sweep the player from a start index to the proposed index in i32vec2Index, 
+		and stop before the first blocking tile. The interactables which are crossed on the way are collected, 
+		so that a fast jump or fall does not skip over them.
+ @param i32vec2StartIndex A const glm::i32vec2& variable containing the index before the jump or fall
+ @return true if a blocking tile was hit
+ */
+bool CPlayer2D::SweepToIndex(const glm::i32vec2& i32vec2StartIndex)
+{
+	// The player's AABB is 1 tile in size, and is offset by its microsteps
+	glm::vec2 vec2MicroSteps = glm::vec2(
+		(float)i32vec2NumMicroSteps.x / cSettings->NUM_STEPS_PER_TILE_XAXIS,
+		(float)i32vec2NumMicroSteps.y / cSettings->NUM_STEPS_PER_TILE_YAXIS);
+
+	SweepResult sResult;
+	bool bHit = cMap2D->SweepAABB(	glm::vec2(i32vec2StartIndex) + vec2MicroSteps,
+									glm::vec2(1.0f),
+									glm::vec2(i32vec2Index - i32vec2StartIndex),
+									sResult);
+
+	// Move to where the sweep stopped
+	glm::vec2 vec2Index = sResult.vec2Position - vec2MicroSteps;
+	i32vec2Index = glm::i32vec2((int)floor(vec2Index.x + 0.5f), (int)floor(vec2Index.y + 0.5f));
+
+	// Interact with the tiles which were crossed on the player's own row or column.
+	// The tile which the player ends in is handled by InteractWithMap in Update.
+	for (unsigned int i = 0; i < sResult.uiNumInteractables; i++)
+	{
+		const glm::i32vec2& i32vec2Tile = sResult.i32vec2Interactables[i];
+		if (i32vec2Tile == i32vec2Index)
+			continue;
+		if ((i32vec2Tile.x == i32vec2StartIndex.x) || (i32vec2Tile.y == i32vec2StartIndex.y))
+			InteractWithTile(i32vec2Tile);
+	}
+
+	return bHit;
+}
+
 /**
  @brief Let player interact with the map. You can add collectibles such as powerups and health here.
  */
 void CPlayer2D::InteractWithMap(void)
 {
-	switch (cMap2D->GetMapInfo(i32vec2Index.y, i32vec2Index.x))
+	InteractWithTile(i32vec2Index);
+}
+
+/**
+ @brief Let player interact with a tile in the map
+ @param i32vec2Tile A const glm::i32vec2& variable containing the column and row of the tile
+ */
+void CPlayer2D::InteractWithTile(const glm::i32vec2& i32vec2Tile)
+{
+	switch (cMap2D->GetMapInfo(i32vec2Tile.y, i32vec2Tile.x))
 	{
 	case CMap2D::TILE_ID::BOMB_SMALL:
-		cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+		cMap2D->SetMapInfo(i32vec2Tile.y, i32vec2Tile.x, 0);
 		cInventoryItem = cInventoryManager->GetItem("Bomb");
 		cInventoryItem->Add(1);
 		cSoundController->PlaySoundByID(SOUND_TYPE::ITEM_PICKUP);
 		break;
 	case CMap2D::TILE_ID::POWERUP_DOUBLEJUMP:
-		cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+		cMap2D->SetMapInfo(i32vec2Tile.y, i32vec2Tile.x, 0);
 		cInventoryItem = cInventoryManager->GetItem("DoubleJump");
 		cSoundController->PlaySoundByID(SOUND_TYPE::ITEM_PICKUP);
 		cInventoryItem->Add(100);
@@ -1168,6 +875,10 @@ void CPlayer2D::InteractWithMap(void)
 		cInventoryItem = cInventoryManager->GetItem("Health");
 		cInventoryItem->Remove(1);
 
+		// Splash the acid
+		CParticleSystem2D::GetInstance()->Emit(CParticleSystem2D::GetInstance()->GetEmitterID("Acid"),
+											   glm::vec2(i32vec2Tile.x, i32vec2Tile.y));
+
 		if (cInventoryItem->GetCount() <= 0)
 		{
 			//Level Complete
@@ -1177,7 +888,7 @@ void CPlayer2D::InteractWithMap(void)
 		break;
 	//case 2:
 	//	// Erase the tree from this position
-	//	cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+	//	cMap2D->SetMapInfo(i32vec2Tile.y, i32vec2Tile.x, 0);
 	//	// Increase the Tree by 1
 	//	cInventoryItem = cInventoryManager->GetItem("Tree");
 	//	cInventoryItem->Add(1);
@@ -1189,7 +900,7 @@ void CPlayer2D::InteractWithMap(void)
 	//	cInventoryItem = cInventoryManager->GetItem("Lives");
 	//	cInventoryItem->Add(1);
 	//	// Erase the life from this position
-	//	cMap2D->SetMapInfo(i32vec2Index.y, i32vec2Index.x, 0);
+	//	cMap2D->SetMapInfo(i32vec2Tile.y, i32vec2Tile.x, 0);
 	//	break;
 	//case 20:
 	//	// Decrease the health by 1
@@ -45,6 +45,9 @@ class CMap2D;
 // Include SoundController
 #include "..\SoundController\SoundController.h"
 
+// Include TimerWheel
+#include "TimeControl\TimerWheel.h"
+
 class CPlayer2D : public CSingletonTemplate<CPlayer2D>, public CEntity2D
 {
 	friend CSingletonTemplate<CPlayer2D>;
@@ -92,8 +95,14 @@ protected:
 	// Physics
 	CPhysics2D cPhysics2D;
 
-	double bombThrowCD;
-	double nextSwitchCD;
+	// Handler to the CTimerWheel
+	CTimerWheel* cTimerWheel;
+
+	// The cooldowns of throwing a bomb and jumping, which are pending until they expire
+	CTimerWheel::HANDLE hBombThrowCooldown;
+	CTimerWheel::HANDLE hJumpCooldown;
+	// The timer which switches the gravity
+	CTimerWheel::HANDLE hSwitchGravityTimer;
 	double autoSpawnBombCD;
 
 	float jumpBoostCD;
@@ -106,10 +115,11 @@ protected:
 
 	int dJumpCount;
 
-	float jumpCD;
-
 	void SwitchToMap(CPhysics2D::GRAVITY_DIRECTION);
 
+	// Switch the gravity to a random direction, and schedule the next switch
+	void SwitchGravity(void);
+
 	// InventoryManager
 	CInventoryManager* cInventoryManager;
 	// InventoryItem
@@ -156,9 +166,19 @@ protected:
 	// Update Jump or Fall
 	void UpdateJumpFall(const double dElapsedTime = 0.0166666666666667);
 
+	// Update Jump or Fall for a gravity direction
+	template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+	void UpdateJumpFallKernel(const double dElapsedTime);
+
+	// Sweep the player to the proposed index, and stop before the first blocking tile
+	bool SweepToIndex(const glm::i32vec2& i32vec2StartIndex);
+
 	// Let player interact with the map
 	void InteractWithMap(void);
 
+	// Let player interact with a tile in the map
+	void InteractWithTile(const glm::i32vec2& i32vec2Tile);
+
 	// Update the health and lives
 	void UpdateHealthLives(void);
 };
@@ -4,6 +4,13 @@ using namespace std;
 
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
+
+// Include SpriteAnimation for the update rate of the animations
+#include "Primitives\SpriteAnimation.h"
 
 #include "System\filesystem.h"
 
@@ -18,6 +25,18 @@ CScene2D::CScene2D(void)
 	, cGUI_Scene2D(NULL)
 	, cGameManager(NULL)
 	, cSoundController(NULL)
+	, cAIScheduler2D(NULL)
+	, cCrowd2D(NULL)
+	, cParticleSystem2D(NULL)
+	, cAcidSimulation2D(NULL)
+	, cTileLighting2D(NULL)
+	, cTimerWheel(NULL)
+	, cRandomStreams(NULL)
+	, cQualityGovernor(NULL)
+	, cSpriteBatch2D(NULL)
+	, uiEntityList(0)
+	, uiMapList(0)
+	, bSpriteListsSubmitted(false)
 {
 }
 
@@ -26,6 +45,15 @@ CScene2D::CScene2D(void)
  */
 CScene2D::~CScene2D(void)
 {
+	// Remove the knobs before the instances which they change are destroyed. The knobs are set back to
+	// their highest levels, so the animation update interval, which is shared, is not left lowered.
+	// We won't delete the governor since it was created elsewhere
+	if (cQualityGovernor)
+	{
+		cQualityGovernor->ClearKnobs();
+		cQualityGovernor = NULL;
+	}
+
 	if (cSoundController)
 	{
 		cSoundController->Destroy();
@@ -45,6 +73,36 @@ CScene2D::~CScene2D(void)
 
 	cEntityManager2D->Exit();
 
+	if (cParticleSystem2D)
+	{
+		cParticleSystem2D->Destroy();
+		cParticleSystem2D = NULL;
+	}
+
+	if (cAcidSimulation2D)
+	{
+		cAcidSimulation2D->Destroy();
+		cAcidSimulation2D = NULL;
+	}
+
+	if (cTileLighting2D)
+	{
+		cTileLighting2D->Destroy();
+		cTileLighting2D = NULL;
+	}
+
+	if (cTimerWheel)
+	{
+		cTimerWheel->Destroy();
+		cTimerWheel = NULL;
+	}
+
+	if (cRandomStreams)
+	{
+		cRandomStreams->Destroy();
+		cRandomStreams = NULL;
+	}
+
 	// We won't delete this since it was created elsewhere
 	cKeyboardController = NULL;
 
@@ -67,6 +125,16 @@ CScene2D::~CScene2D(void)
 		cMap2D = NULL;
 	}
 
+	if (cSpriteBatch2D)
+	{
+		cSpriteBatch2D->Destroy();
+		cSpriteBatch2D = NULL;
+	}
+
+	// Delete the textures which the scene released, now that no sprite can draw them,
+	// so that the next scene does not start with them taking the budget
+	CTextureCache::GetInstance()->Purge();
+
 	// Clear out all the shaders
 	//CShaderManager::GetInstance()->Destroy();
 }
@@ -76,15 +144,29 @@ CScene2D::~CScene2D(void)
 */ 
 bool CScene2D::Init(void)
 {
+	// Seed the random number streams before anything random happens.
+	// The seed is printed, and a run can be replayed by passing it with -seed on the command line
+	cRandomStreams = CRandomStreams::GetInstance();
+	cRandomStreams->Init(CSettings::GetInstance()->ullRandomSeed);
+
 	// Include Shader Manager
 	CShaderManager::GetInstance()->Add("2DShader", "Shader//Scene2D.vs", "Shader//Scene2D.fs");
 	CShaderManager::GetInstance()->Use("2DShader");
 	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
 
+	// Load the shader which lights the tiles with the light map
+	CShaderManager::GetInstance()->Add("2DLitShader", "Shader//Scene2DLit.vs", "Shader//Scene2DLit.fs");
+	CShaderManager::GetInstance()->Use("2DLitShader");
+	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
+
+	// Create the sprite batch which the map and the entities are drawn with
+	cSpriteBatch2D = CSpriteBatch2D::GetInstance();
+	cSpriteBatch2D->Init();
+
 	// Create and initialise the Map 2D
 	cMap2D = CMap2D::GetInstance();
 	// Set a shader to this class
-	cMap2D->SetShader("2DShader");
+	cMap2D->SetShader("2DLitShader");
 	// Initialise the instance
 	if (cMap2D->Init(5) == false)
 	{
@@ -123,6 +205,10 @@ bool CScene2D::Init(void)
 	cEntityManager2D = CEntityManager2D::GetInstance();
 	cEntityManager2D->Init();
 
+	// Initialise the timers before the player schedules its timers
+	cTimerWheel = CTimerWheel::GetInstance();
+	cTimerWheel->Init();
+
 	// Store the keyboard controller singleton instance here
 	cKeyboardController = CKeyboardController::GetInstance();
 
@@ -137,6 +223,33 @@ bool CScene2D::Init(void)
 		return false;
 	}
 
+	// Load the particle emitters before the entities emit particles
+	cParticleSystem2D = CParticleSystem2D::GetInstance();
+	cParticleSystem2D->Init();
+	cParticleSystem2D->SetShader("2DColorShader");
+	if (cParticleSystem2D->LoadEmitters("Scripts/Particle_Emitters.csv") == false)
+	{
+		cout << "Failed to load the particle emitters" << endl;
+		return false;
+	}
+
+	// Initialise the AI scheduler before the enemies register with it
+	cAIScheduler2D = CAIScheduler2D::GetInstance();
+	cAIScheduler2D->Init();
+
+	// Initialise the crowd before the enemies register with it
+	cCrowd2D = CCrowd2D::GetInstance();
+	cCrowd2D->Init();
+
+	// Load the acid from the map, after the player has been removed from it
+	cAcidSimulation2D = CAcidSimulation2D::GetInstance();
+	cAcidSimulation2D->Init();
+
+	// Light the tiles of the map
+	cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->SetShader("2DLitShader");
+	cTileLighting2D->Init(cMap2D->GetGridView());
+
 	// Create and initialise the cEnemy2D
 	cEnemy2D = new CEnemy2D();
 	// Pass shader to cEnemy2D
@@ -168,6 +281,8 @@ bool CScene2D::Init(void)
 	cItemSpawner2D = CItemSpawner2D::GetInstance();
 	cItemSpawner2D->Init();
 
+	// Let the quality governor lower the settings of this scene when the frames run long
+	RegisterQualityKnobs();
 
 	CSoundController::GetInstance()->PlaySoundByID(SOUND_TYPE::BG_ARCADE);
 
@@ -181,9 +296,25 @@ bool CScene2D::Init(void)
 */
 bool CScene2D::Update(const double dElapsedTime)
 {
+	// Fire the timers which expired, such as the cooldowns and the switch of the gravity
+	cTimerWheel->Update(dElapsedTime);
+
 	// Call the cPlayer2D's update method before Map2D as we want to capture the inputs before map2D update
 	cPlayer2D->Update(dElapsedTime);
 
+	// Find the paths which the enemies requested, within this frame's budget, before the enemies think
+	cAIScheduler2D->Update(cPlayer2D->i32vec2Index);
+
+	// Steer the enemies around each other, from where they were and wanted to go in the last frame
+	cCrowd2D->Update();
+
+	// Flow the acid before the entity manager clears the tiles which were modified in the last frame
+	cAcidSimulation2D->Update(dElapsedTime);
+
+	// Relight the tiles which the acid and the last frame changed, and follow the player with its light
+	cTileLighting2D->SetPlayerLight(cPlayer2D->i32vec2Index, CSettings::GetInstance()->PLAYER_LIGHT_LEVEL);
+	cTileLighting2D->Update(cMap2D->GetGridView(), cMap2D->GetModifiedTiles(), cMap2D->IsLevelChanged(), dElapsedTime);
+
 	//Collider - To be moved into separate class when have time
 	cEntityManager2D->Update(dElapsedTime);
 
@@ -197,13 +328,16 @@ bool CScene2D::Update(const double dElapsedTime)
 	// Call the Map2D's update method
 	cMap2D->Update(dElapsedTime);
 
+	// Update the particles, including those emitted by the entities in this frame
+	cParticleSystem2D->Update(dElapsedTime);
+
 	// Get keyboard updates
-	if (cKeyboardController->IsKeyDown(GLFW_KEY_F6))
+	if (cKeyboardController->IsKeyPressed(GLFW_KEY_F6))
 	{
-		// Save the current game to a save file
-		// Make sure the file is open
+		// Save the current game to a save file, in the idle time of the next frames so that this frame does not stall
+		// Make sure the save was started
 		try {
-			if (cMap2D->SaveMap("Maps/DM2213_Map_Level_01_SAVEGAMEtest.csv") == false)
+			if (cMap2D->SaveMapInBackground("Maps/DM2213_Map_Level_01_SAVEGAMEtest.csv") == false)
 			{
 				throw runtime_error("Unable to save the current game to a file");
 			}
@@ -238,6 +372,14 @@ bool CScene2D::Update(const double dElapsedTime)
 		return false;
 	}
 
+	// Store the transforms at the end of this simulation step, so that rendering can interpolate them.
+	// The player is one of the entities in cEntityManager2D.
+	cEntityManager2D->StoreRenderTransforms();
+	for (int i = 0; i < enemyVector.size(); i++)
+	{
+		enemyVector[i]->StoreRenderTransform();
+	}
+
 	return true;
 }
 
@@ -254,7 +396,7 @@ void CScene2D::PreRender(void)
 	glClear(GL_COLOR_BUFFER_BIT);
 
 	// Enable 2D texture rendering
-	glEnable(GL_TEXTURE_2D);
+	CGLStateCache::GetInstance()->Enable(GL_TEXTURE_2D);
 }
 
 /**
@@ -262,7 +404,18 @@ void CScene2D::PreRender(void)
  */
 void CScene2D::Render(void)
 {
+	// The batched sprites, which are the bombs and the tiles of the map, are drawn in the frame after they are
+	// recorded, at the same place in the draw order, so that the render thread sorts them and builds their
+	// vertices while the next frame is simulated. The other entities are drawn while they are recorded.
+	// The first frame has no lists from the last frame to draw.
+	cSpriteBatch2D->Begin();
 	cEntityManager2D->RenderEntities();
+	const unsigned int uiNextEntityList = cSpriteBatch2D->Submit();
+
+	// Draw the batched entities of the last frame under the enemies and the player
+	if (bSpriteListsSubmitted)
+		cSpriteBatch2D->Execute(uiEntityList);
+	uiEntityList = uiNextEntityList;
 
 	for (int i = 0; i < enemyVector.size(); i++)
 	{
@@ -281,12 +434,26 @@ void CScene2D::Render(void)
 	// Call the CPlayer2D's PostRender()
 	cPlayer2D->PostRender();
 	
+	// Upload and bind the light map for the Map2D
+	cTileLighting2D->PreRender();
 	// Call the Map2D's PreRender()
 	cMap2D->PreRender();
-	// Call the Map2D's Render()
-	cMap2D->Render();
+	// Draw the tiles which the Map2D's Render() recorded in the last frame
+	if (bSpriteListsSubmitted)
+		cSpriteBatch2D->Execute(uiMapList);
 	// Call the Map2D's PostRender()
 	cMap2D->PostRender();
+	// Unbind the light map
+	cTileLighting2D->PostRender();
+
+	// Record the tiles of the map for the next frame
+	cSpriteBatch2D->Begin();
+	cMap2D->Render();
+	uiMapList = cSpriteBatch2D->Submit();
+	bSpriteListsSubmitted = true;
+
+	// Render the particles over the map
+	cParticleSystem2D->Render();
 
 	// Call the cGUI_Scene2D's PreRender()
 	cGUI_Scene2D->PreRender();
@@ -301,4 +468,43 @@ void CScene2D::Render(void)
  */
 void CScene2D::PostRender(void)
 {
-}
\ No newline at end of file
+}
+
+/**
+ @brief Register the settings which the quality governor can lower when the frames run long.
+		The knobs are lowered in the order they are registered when they have the same quality,
+		so the settings which are the least visible are registered first.
+ */
+void CScene2D::RegisterQualityKnobs(void)
+{
+	cQualityGovernor = CQualityGovernor::GetInstance();
+
+	// The animation update rate: 10, 20, and every frame
+	cQualityGovernor->RegisterKnob("Animation update rate", 3, [](const int iLevel)
+	{
+		static const float arrUpdateIntervals[3] = { 0.1f, 0.05f, 0.0f };
+		CSpriteAnimation::SetUpdateInterval(arrUpdateIntervals[iLevel]);
+	});
+
+	// The particle caps: a quarter, half, three quarters and the full capacity of the emitters
+	CParticleSystem2D* cParticleSystem2D = this->cParticleSystem2D;
+	cQualityGovernor->RegisterKnob("Particle caps", 4, [cParticleSystem2D](const int iLevel)
+	{
+		cParticleSystem2D->SetCapacityScale((iLevel + 1) * 0.25f);
+	});
+
+	// The AI tick rate: the agents in the far bands think 4 times, twice and once as often as the slowest rate
+	CAIScheduler2D* cAIScheduler2D = this->cAIScheduler2D;
+	cQualityGovernor->RegisterKnob("AI tick rate", 3, [cAIScheduler2D](const int iLevel)
+	{
+		static const double arrTickIntervalScales[3] = { 4.0, 2.0, 1.0 };
+		cAIScheduler2D->SetTickIntervalScale(arrTickIntervalScales[iLevel]);
+	});
+
+	// The path budget: a quarter, half and the full number of A* expansions in each frame
+	const unsigned int uiFullExpansionBudget = cAIScheduler2D->GetExpansionBudget();
+	cQualityGovernor->RegisterKnob("Path budget", 3, [cAIScheduler2D, uiFullExpansionBudget](const int iLevel)
+	{
+		cAIScheduler2D->SetExpansionBudget(uiFullExpansionBudget >> (2 - iLevel));
+	});
+}
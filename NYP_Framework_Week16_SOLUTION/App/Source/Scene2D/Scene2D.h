@@ -50,6 +50,33 @@
 // Entity Manager
 #include "EntityManager.h"
 
+// Include AIScheduler2D
+#include "AIScheduler2D.h"
+
+// Include Crowd2D
+#include "Crowd2D.h"
+
+// Include ParticleSystem2D
+#include "ParticleSystem2D.h"
+
+// Include AcidSimulation2D
+#include "AcidSimulation2D.h"
+
+// Include TileLighting2D
+#include "TileLighting2D.h"
+
+// Include TimerWheel
+#include "TimeControl\TimerWheel.h"
+
+// Include Random
+#include "System\Random.h"
+
+// Include QualityGovernor
+#include "TimeControl\QualityGovernor.h"
+
+// Include SpriteBatch2D
+#include "RenderControl\SpriteBatch2D.h"
+
 // Include SoundController
 #include "..\SoundController\SoundController.h"
 
@@ -87,6 +114,38 @@ protected:
 	// The handler containing the single instance of EntityManager2D;
 	CEntityManager2D* cEntityManager2D;
 
+	// The handler containing the single instance of AIScheduler2D;
+	CAIScheduler2D* cAIScheduler2D;
+
+	// The handler containing the single instance of Crowd2D;
+	CCrowd2D* cCrowd2D;
+
+	// The handler containing the single instance of ParticleSystem2D;
+	CParticleSystem2D* cParticleSystem2D;
+
+	// The handler containing the single instance of AcidSimulation2D;
+	CAcidSimulation2D* cAcidSimulation2D;
+
+	// The handler containing the single instance of TileLighting2D;
+	CTileLighting2D* cTileLighting2D;
+
+	// The handler containing the single instance of TimerWheel;
+	CTimerWheel* cTimerWheel;
+
+	// The handler containing the single instance of RandomStreams;
+	CRandomStreams* cRandomStreams;
+
+	// The handler containing the single instance of QualityGovernor;
+	CQualityGovernor* cQualityGovernor;
+
+	// The handler containing the single instance of SpriteBatch2D;
+	CSpriteBatch2D* cSpriteBatch2D;
+	// The lists of the batched entities and of the map which were submitted in the last frame
+	unsigned int uiEntityList;
+	unsigned int uiMapList;
+	// Boolean flag to indicate if the lists of the last frame were submitted
+	bool bSpriteListsSubmitted;
+
 	// A vector containing the instance of CEnemy2Ds
 	vector<CEntity2D*> enemyVector;
 
@@ -109,5 +168,8 @@ protected:
 	CScene2D(void);
 	// Destructor
 	virtual ~CScene2D(void);
+
+	// Register the settings which the quality governor can lower when the frames run long
+	void RegisterQualityKnobs(void);
 };
 
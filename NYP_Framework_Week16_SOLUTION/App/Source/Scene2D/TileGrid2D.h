@@ -0,0 +1,56 @@
+/**
+ TileGrid2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include NULL
+#include <cstddef>
+
+// A structure storing information about a map grid
+// It includes data to be used for A* Path Finding
+struct Grid {
+	unsigned int value;
+
+	Grid() 
+		: value(0), pos(0, 0), parent(-1, -1), f(0), g(0), h(0) {}
+	Grid(	const glm::i32vec2& pos, unsigned int f) 
+		: value(0), pos(pos), parent(-1, 1), f(f), g(0), h(0) {}
+	Grid(	const glm::i32vec2& pos, const glm::i32vec2& parent, 
+			unsigned int f, unsigned int g, unsigned int h) 
+		: value(0), pos(pos), parent(parent), f(f), g(g), h(h) {}
+
+	glm::i32vec2 pos;
+	glm::i32vec2 parent;
+	unsigned int f;
+	unsigned int g;
+	unsigned int h;
+};
+
+// A read-only view of one level of the tile map, with direct access to its rows.
+// It does not depend on OpenGL, so code which only reads the tiles can be used without a map being loaded.
+// The rows are stored from top to bottom, while entities use rows from bottom to top.
+struct TileGridView2D {
+	// The rows of the level, from top to bottom
+	const Grid* const* arrRows;
+	// The number of rows and columns
+	int iNumRows;
+	int iNumCols;
+
+	TileGridView2D()
+		: arrRows(NULL), iNumRows(0), iNumCols(0) {}
+	TileGridView2D(const Grid* const* arrRows, const int iNumRows, const int iNumCols)
+		: arrRows(arrRows), iNumRows(iNumRows), iNumCols(iNumCols) {}
+
+	// Get the value of the tile at a column and an inverted row. Tiles outside the level are empty.
+	inline unsigned int GetValue(const int iCol, const int iRow) const
+	{
+		if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+			return 0;
+		return arrRows[iNumRows - iRow - 1][iCol].value;
+	}
+};
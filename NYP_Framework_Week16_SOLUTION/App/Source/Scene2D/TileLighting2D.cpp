@@ -0,0 +1,508 @@
+/**
+ CTileLighting2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TileLighting2D.h"
+
+#include <iostream>
+using namespace std;
+
+// Include the Map2D for the IDs of the tiles
+#include "Map2D.h"
+
+// Include Shader Manager
+#include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include Settings for the size of the tiles
+#include "GameControl\Settings.h"
+
+// The highest light level
+const int CTileLighting2D::MAX_LIGHT;
+// The brightness of an unlit tile
+const float CTileLighting2D::AMBIENT_LIGHT = 0.3f;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CTileLighting2D::CTileLighting2D(void)
+	: iNumCols(0)
+	, iNumRows(0)
+	, i32vec2PlayerPosition(-1, -1)
+	, iPlayerLevel(0)
+	, iDirtyMinRow(0)
+	, iDirtyMaxRow(-1)
+	, uiNumVisitedTiles(0)
+	, uiTextureID(0)
+	, iTextureCols(0)
+	, iTextureRows(0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CTileLighting2D::~CTileLighting2D(void)
+{
+	if (uiTextureID != 0)
+		CGLStateCache::GetInstance()->DeleteTextures(1, &uiTextureID);
+}
+
+/**
+ @brief Init Initialise this instance, and light the tiles of a level
+ @param sGridView A const TileGridView2D& variable containing the view of the level's tiles
+ */
+bool CTileLighting2D::Init(const TileGridView2D& sGridView)
+{
+	i32vec2PlayerPosition = glm::i32vec2(-1, -1);
+	iPlayerLevel = 0;
+	vFlashes.clear();
+
+	LoadFromMap(sGridView);
+	return true;
+}
+
+/**
+ @brief Resize the grid, and clear it to unlit tiles which do not block light
+ @param iNumCols A const int variable containing the number of columns
+ @param iNumRows A const int variable containing the number of rows
+ */
+void CTileLighting2D::Resize(const int iNumCols, const int iNumRows)
+{
+	this->iNumCols = iNumCols;
+	this->iNumRows = iNumRows;
+	vLight.assign(iNumCols * iNumRows, 0);
+	vEmission.assign(iNumCols * iNumRows, 0);
+	vTileEmission.assign(iNumCols * iNumRows, 0);
+	vBlocksLight.assign(iNumCols * iNumRows, 0);
+	vAddQueue.clear();
+	vRemoveQueue.clear();
+
+	iDirtyMinRow = 0;
+	iDirtyMaxRow = iNumRows - 1;
+}
+
+/**
+ @brief Update once per frame, after the acid and before the entities, so that the tiles which were modified
+		in the last frame have not been cleared yet. The flashes which expired are removed.
+ @param sGridView A const TileGridView2D& variable containing the view of the level's tiles
+ @param vModifiedTiles A const std::vector<glm::i32vec2>& variable containing the tiles which were modified
+ @param bLevelChanged A const bool variable which is true if the level changed, so all the tiles are loaded
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CTileLighting2D::Update(const TileGridView2D& sGridView,
+							 const std::vector<glm::i32vec2>& vModifiedTiles,
+							 const bool bLevelChanged,
+							 const double dElapsedTime)
+{
+	if ((bLevelChanged) || (sGridView.iNumCols != iNumCols) || (sGridView.iNumRows != iNumRows))
+	{
+		LoadFromMap(sGridView);
+	}
+	else
+	{
+		for (auto& tile : vModifiedTiles)
+			LoadTile(sGridView, tile.x, tile.y);
+	}
+
+	for (unsigned int i = 0; i < vFlashes.size(); )
+	{
+		vFlashes[i].dTimeLeft -= dElapsedTime;
+		if (vFlashes[i].dTimeLeft > 0.0)
+		{
+			i++;
+			continue;
+		}
+
+		const glm::i32vec2 i32vec2Position = vFlashes[i].i32vec2Position;
+		vFlashes[i] = vFlashes.back();
+		vFlashes.pop_back();
+		UpdateTile(i32vec2Position.y * iNumCols + i32vec2Position.x);
+	}
+}
+
+/**
+ @brief Set the emission of a tile, and if it blocks light
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ @param iEmission A const int variable containing the light level which the tile emits
+ @param bBlocksLight A const bool variable which is true if the light does not spread through the tile
+ */
+void CTileLighting2D::SetTile(const int iCol, const int iRow, const int iEmission, const bool bBlocksLight)
+{
+	if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+		return;
+
+	const int iIndex = iRow * iNumCols + iCol;
+	const unsigned char ucEmission = (unsigned char)glm::clamp(iEmission, 0, MAX_LIGHT);
+	const unsigned char ucBlocksLight = bBlocksLight ? 1 : 0;
+	if ((vTileEmission[iIndex] == ucEmission) && (vBlocksLight[iIndex] == ucBlocksLight))
+		return;
+
+	vTileEmission[iIndex] = ucEmission;
+	vBlocksLight[iIndex] = ucBlocksLight;
+	UpdateTile(iIndex);
+}
+
+/**
+ @brief Set the position and the level of the player's light. Only the tiles it left and entered are updated
+ @param i32vec2Position A const glm::i32vec2& variable containing the tile of the player
+ @param iLevel A const int variable containing the light level of the player
+ */
+void CTileLighting2D::SetPlayerLight(const glm::i32vec2& i32vec2Position, const int iLevel)
+{
+	if ((i32vec2Position == i32vec2PlayerPosition) && (iLevel == iPlayerLevel))
+		return;
+
+	const glm::i32vec2 i32vec2OldPosition = i32vec2PlayerPosition;
+	i32vec2PlayerPosition = i32vec2Position;
+	iPlayerLevel = glm::clamp(iLevel, 0, MAX_LIGHT);
+
+	if ((i32vec2OldPosition.x >= 0) && (i32vec2OldPosition.x < iNumCols) &&
+		(i32vec2OldPosition.y >= 0) && (i32vec2OldPosition.y < iNumRows))
+		UpdateTile(i32vec2OldPosition.y * iNumCols + i32vec2OldPosition.x);
+	if ((i32vec2Position.x >= 0) && (i32vec2Position.x < iNumCols) &&
+		(i32vec2Position.y >= 0) && (i32vec2Position.y < iNumRows) &&
+		(i32vec2Position != i32vec2OldPosition))
+		UpdateTile(i32vec2Position.y * iNumCols + i32vec2Position.x);
+}
+
+/**
+ @brief Add a light which lasts for a time, such as the flash of an explosion
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ @param iLevel A const int variable containing the light level
+ @param dDuration A const double variable containing the time, in seconds, which the light lasts for
+ */
+void CTileLighting2D::AddFlash(const int iCol, const int iRow, const int iLevel, const double dDuration)
+{
+	if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+		return;
+
+	Flash sFlash;
+	sFlash.i32vec2Position = glm::i32vec2(iCol, iRow);
+	sFlash.iLevel = glm::clamp(iLevel, 0, MAX_LIGHT);
+	sFlash.dTimeLeft = dDuration;
+	vFlashes.push_back(sFlash);
+	UpdateTile(iRow * iNumCols + iCol);
+}
+
+/**
+ @brief Get the light level of a tile
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ */
+int CTileLighting2D::GetLight(const int iCol, const int iRow) const
+{
+	if ((iCol < 0) || (iCol >= iNumCols) || (iRow < 0) || (iRow >= iNumRows))
+		return 0;
+
+	return vLight[iRow * iNumCols + iCol];
+}
+
+/**
+ @brief Get the emission of a tile in the map
+ @param uiTileValue A const unsigned int variable containing the value of the tile
+ */
+int CTileLighting2D::GetTileEmission(const unsigned int uiTileValue)
+{
+	if ((uiTileValue >= CMap2D::TILE_ID::ACID_DOWN) && (uiTileValue <= CMap2D::TILE_ID::ACID_LEFT))
+		return 10;
+	if (uiTileValue == CMap2D::TILE_ID::POWERUP_DOUBLEJUMP)
+		return 7;
+	return 0;
+}
+
+/**
+ @brief Upload the rows of the light map which changed, and bind it to texture unit 1
+ */
+void CTileLighting2D::PreRender(void)
+{
+	if ((iNumCols == 0) || (iNumRows == 0))
+		return;
+
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE1);
+
+	// Create the light map, or resize it to the grid
+	if (uiTextureID == 0)
+		glGenTextures(1, &uiTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, uiTextureID);
+	if ((iTextureCols != iNumCols) || (iTextureRows != iNumRows))
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, iNumCols, iNumRows, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		// Blend the light between the tiles
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		iTextureCols = iNumCols;
+		iTextureRows = iNumRows;
+		iDirtyMinRow = 0;
+		iDirtyMaxRow = iNumRows - 1;
+	}
+
+	// Upload the rows which changed. The rows are tightly packed
+	if (iDirtyMinRow <= iDirtyMaxRow)
+	{
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, iDirtyMinRow, iNumCols, iDirtyMaxRow - iDirtyMinRow + 1,
+						GL_RED, GL_UNSIGNED_BYTE, &vLight[iDirtyMinRow * iNumCols]);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		iDirtyMinRow = iNumRows;
+		iDirtyMaxRow = -1;
+	}
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
+
+	// Set the uniforms of the light map
+	CShaderManager::GetInstance()->Use(sShaderName);
+	CShader* cShader = CShaderManager::GetInstance()->activeShader;
+	cShader->setInt("lightMap", 1);
+	cShader->setFloat("lightScale", 255.0f / MAX_LIGHT);
+	cShader->setFloat("ambient", AMBIENT_LIGHT);
+
+	// Map the positions of the tiles to the light map. The map starts at (-1, -1), with the tiles from the bottom left
+	CSettings* cSettings = CSettings::GetInstance();
+	cShader->setVec2("lightMapOrigin", -1.0f, -1.0f);
+	cShader->setVec2("lightMapScale", 1.0f / (iNumCols * cSettings->TILE_WIDTH), 1.0f / (iNumRows * cSettings->TILE_HEIGHT));
+}
+
+/**
+ @brief Unbind the light map
+ */
+void CTileLighting2D::PostRender(void)
+{
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE1);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, 0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
+}
+
+/**
+ @brief Set the shader which samples the light map
+ */
+void CTileLighting2D::SetShader(const std::string& strShaderName)
+{
+	sShaderName = strShaderName;
+}
+
+/**
+ @brief Get the number of tiles which were visited by the flood fills since the last call
+ */
+unsigned int CTileLighting2D::GetNumVisitedTiles(void)
+{
+	const unsigned int uiResult = uiNumVisitedTiles;
+	uiNumVisitedTiles = 0;
+	return uiResult;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CTileLighting2D::PrintSelf(void) const
+{
+	cout << "CTileLighting2D::PrintSelf()" << endl;
+	cout << "Grid: " << iNumCols << "x" << iNumRows
+		<< ", Flashes: " << vFlashes.size()
+		<< ", Visited tiles: " << uiNumVisitedTiles << endl;
+}
+
+/**
+ @brief Load all the tiles of a level, and light them from scratch
+ @param sGridView A const TileGridView2D& variable containing the view of the level's tiles
+ */
+void CTileLighting2D::LoadFromMap(const TileGridView2D& sGridView)
+{
+	if ((sGridView.iNumCols != iNumCols) || (sGridView.iNumRows != iNumRows))
+		Resize(sGridView.iNumCols, sGridView.iNumRows);
+
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			const unsigned int uiValue = sGridView.GetValue(iCol, iRow);
+			vTileEmission[iRow * iNumCols + iCol] = (unsigned char)GetTileEmission(uiValue);
+			vBlocksLight[iRow * iNumCols + iCol] = (uiValue >= CMap2D::TILE_ID::COLOUR_BLOCK_UP) ? 1 : 0;
+		}
+	}
+	Relight();
+}
+
+/**
+ @brief Load a tile of a level, and update its light if it changed
+ @param sGridView A const TileGridView2D& variable containing the view of the level's tiles
+ @param iCol A const int variable containing the column
+ @param iRow A const int variable containing the row, from bottom to top
+ */
+void CTileLighting2D::LoadTile(const TileGridView2D& sGridView, const int iCol, const int iRow)
+{
+	const unsigned int uiValue = sGridView.GetValue(iCol, iRow);
+	SetTile(iCol, iRow, GetTileEmission(uiValue), uiValue >= CMap2D::TILE_ID::COLOUR_BLOCK_UP);
+}
+
+/**
+ @brief Light all the tiles from scratch
+ */
+void CTileLighting2D::Relight(void)
+{
+	vAddQueue.clear();
+	for (int i = 0; i < iNumCols * iNumRows; i++)
+	{
+		vEmission[i] = (unsigned char)ComputeEmission(i);
+		vLight[i] = vEmission[i];
+		if (vEmission[i] > 0)
+			vAddQueue.push_back(i);
+	}
+	iDirtyMinRow = 0;
+	iDirtyMaxRow = iNumRows - 1;
+
+	PropagateAdd();
+}
+
+/**
+ @brief Update the light around a tile after its emission or its blocking changed.
+		The light which spread from the tile is removed, then the tile and its neighbours spread their light again.
+ @param iIndex A const int variable containing the index of the tile
+ */
+void CTileLighting2D::UpdateTile(const int iIndex)
+{
+	vEmission[iIndex] = (unsigned char)ComputeEmission(iIndex);
+
+	// Remove the light of the tile, and the light which spread from it
+	vRemoveQueue.clear();
+	vAddQueue.clear();
+	vRemoveQueue.push_back(glm::i32vec2(iIndex, vLight[iIndex]));
+	SetLight(iIndex, 0);
+	PropagateRemoval();
+
+	// The tile may now let the light of its neighbours through
+	const int iCol = iIndex % iNumCols;
+	const int iRow = iIndex / iNumCols;
+	if ((iCol > 0) && (vLight[iIndex - 1] > 0))
+		vAddQueue.push_back(iIndex - 1);
+	if ((iCol < iNumCols - 1) && (vLight[iIndex + 1] > 0))
+		vAddQueue.push_back(iIndex + 1);
+	if ((iRow > 0) && (vLight[iIndex - iNumCols] > 0))
+		vAddQueue.push_back(iIndex - iNumCols);
+	if ((iRow < iNumRows - 1) && (vLight[iIndex + iNumCols] > 0))
+		vAddQueue.push_back(iIndex + iNumCols);
+
+	PropagateAdd();
+}
+
+/**
+ @brief Get the emission of a tile, from the tile and the dynamic lights on it
+ @param iIndex A const int variable containing the index of the tile
+ */
+int CTileLighting2D::ComputeEmission(const int iIndex) const
+{
+	int iEmission = vTileEmission[iIndex];
+
+	const glm::i32vec2 i32vec2Position(iIndex % iNumCols, iIndex / iNumCols);
+	if (i32vec2Position == i32vec2PlayerPosition)
+		iEmission = glm::max(iEmission, iPlayerLevel);
+	for (auto& flash : vFlashes)
+	{
+		if (flash.i32vec2Position == i32vec2Position)
+			iEmission = glm::max(iEmission, flash.iLevel);
+	}
+	return iEmission;
+}
+
+/**
+ @brief Set the light level of a tile, and mark its row as changed
+ */
+void CTileLighting2D::SetLight(const int iIndex, const int iLevel)
+{
+	vLight[iIndex] = (unsigned char)iLevel;
+
+	const int iRow = iIndex / iNumCols;
+	if (iRow < iDirtyMinRow)
+		iDirtyMinRow = iRow;
+	if (iRow > iDirtyMaxRow)
+		iDirtyMaxRow = iRow;
+}
+
+/**
+ @brief Remove the light which spread from the tiles in the removal queue.
+		A neighbour which is dimmer than a removed tile was lit by it, so its light is removed too.
+		A neighbour which is at least as bright was lit by another source, so it spreads its light back in.
+		A removed tile which emits light is lit again by its own emission.
+ */
+void CTileLighting2D::PropagateRemoval(void)
+{
+	for (unsigned int uiHead = 0; uiHead < vRemoveQueue.size(); uiHead++)
+	{
+		const int iIndex = vRemoveQueue[uiHead].x;
+		const int iLevel = vRemoveQueue[uiHead].y;
+		uiNumVisitedTiles++;
+
+		if (vEmission[iIndex] > 0)
+		{
+			SetLight(iIndex, vEmission[iIndex]);
+			vAddQueue.push_back(iIndex);
+		}
+
+		const int iCol = iIndex % iNumCols;
+		const int iRow = iIndex / iNumCols;
+		const int arrNeighbours[4] = {
+			(iCol > 0) ? iIndex - 1 : -1,
+			(iCol < iNumCols - 1) ? iIndex + 1 : -1,
+			(iRow > 0) ? iIndex - iNumCols : -1,
+			(iRow < iNumRows - 1) ? iIndex + iNumCols : -1
+		};
+		for (int i = 0; i < 4; i++)
+		{
+			const int iNeighbour = arrNeighbours[i];
+			if (iNeighbour < 0)
+				continue;
+
+			const int iNeighbourLevel = vLight[iNeighbour];
+			if ((iNeighbourLevel != 0) && (iNeighbourLevel < iLevel))
+			{
+				SetLight(iNeighbour, 0);
+				vRemoveQueue.push_back(glm::i32vec2(iNeighbour, iNeighbourLevel));
+			}
+			else if (iNeighbourLevel >= iLevel)
+			{
+				vAddQueue.push_back(iNeighbour);
+			}
+		}
+	}
+	vRemoveQueue.clear();
+}
+
+/**
+ @brief Spread the light from the tiles in the add queue, losing 1 level for each tile.
+		A tile which blocks light is lit, but does not spread its light unless it emits light.
+ */
+void CTileLighting2D::PropagateAdd(void)
+{
+	for (unsigned int uiHead = 0; uiHead < vAddQueue.size(); uiHead++)
+	{
+		const int iIndex = vAddQueue[uiHead];
+		const int iLevel = vLight[iIndex] - 1;
+		uiNumVisitedTiles++;
+
+		if ((iLevel <= 0) || ((vBlocksLight[iIndex]) && (vEmission[iIndex] == 0)))
+			continue;
+
+		const int iCol = iIndex % iNumCols;
+		const int iRow = iIndex / iNumCols;
+		const int arrNeighbours[4] = {
+			(iCol > 0) ? iIndex - 1 : -1,
+			(iCol < iNumCols - 1) ? iIndex + 1 : -1,
+			(iRow > 0) ? iIndex - iNumCols : -1,
+			(iRow < iNumRows - 1) ? iIndex + iNumCols : -1
+		};
+		for (int i = 0; i < 4; i++)
+		{
+			const int iNeighbour = arrNeighbours[i];
+			if ((iNeighbour >= 0) && (vLight[iNeighbour] < iLevel))
+			{
+				SetLight(iNeighbour, iLevel);
+				vAddQueue.push_back(iNeighbour);
+			}
+		}
+	}
+	vAddQueue.clear();
+}
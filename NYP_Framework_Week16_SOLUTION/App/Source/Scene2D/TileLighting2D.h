@@ -0,0 +1,171 @@
+/**
+ CTileLighting2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include vector and string
+#include <vector>
+#include <string>
+
+// Include TileGrid2D for the view of the tiles which are lit
+#include "TileGrid2D.h"
+
+/**
+ CTileLighting2D: Lights the tiles from emissive tiles, such as acid and power-ups, and from dynamic lights,
+				  such as the player and the flashes of explosions. The light spreads from each source by a
+				  flood fill, losing 1 level for each tile, through the tiles which do not block it.
+				  A blocking tile is lit on its surface, but the light does not spread through it.
+
+				  The light is updated incrementally. When a tile or a light changes, the light which came from
+				  that tile is removed by a flood fill which only visits the tiles that were lit by it, and then
+				  the light from the sources around the removed area is spread back into it.
+				  The whole map is only lit from scratch when the level changes.
+
+				  The light levels are uploaded to a single channel texture with one texel per tile,
+				  which the tile shader samples. Only the rows which changed are uploaded.
+
+				  The tiles are read from a view of the map's grid, which is passed in, so the lighting does not
+				  depend on the map being loaded. It can also be lit without OpenGL with Resize and SetTile.
+ */
+class CTileLighting2D : public CSingletonTemplate<CTileLighting2D>
+{
+	friend CSingletonTemplate<CTileLighting2D>;
+public:
+	// The highest light level
+	static const int MAX_LIGHT = 15;
+
+	// Init, and light the tiles of a level
+	bool Init(const TileGridView2D& sGridView);
+
+	// Resize the grid, and clear it to unlit tiles which do not block light
+	void Resize(const int iNumCols, const int iNumRows);
+
+	// Update once per frame. The modified tiles are loaded, and the flashes which expired are removed
+	void Update(const TileGridView2D& sGridView,
+				const std::vector<glm::i32vec2>& vModifiedTiles,
+				const bool bLevelChanged,
+				const double dElapsedTime);
+
+	// Set the emission of a tile, and if it blocks light. The row is from bottom to top
+	void SetTile(const int iCol, const int iRow, const int iEmission, const bool bBlocksLight);
+
+	// Set the position and the level of the player's light
+	void SetPlayerLight(const glm::i32vec2& i32vec2Position, const int iLevel);
+
+	// Add a light which lasts for a time, such as the flash of an explosion
+	void AddFlash(const int iCol, const int iRow, const int iLevel, const double dDuration = 0.3);
+
+	// Get the light level of a tile. The row is from bottom to top
+	int GetLight(const int iCol, const int iRow) const;
+
+	// Get the emission of a tile in the map
+	static int GetTileEmission(const unsigned int uiTileValue);
+
+	// Upload the changed light levels, and bind the light map to texture unit 1
+	void PreRender(void);
+
+	// Unbind the light map
+	void PostRender(void);
+
+	// Set the shader which samples the light map
+	void SetShader(const std::string& strShaderName);
+
+	// Get the number of tiles which were visited by the flood fills since the last call
+	unsigned int GetNumVisitedTiles(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The brightness of an unlit tile
+	static const float AMBIENT_LIGHT;
+
+	// A light which lasts for a time
+	struct Flash
+	{
+		glm::i32vec2 i32vec2Position;
+		int iLevel;
+		double dTimeLeft;
+	};
+
+	// The light level of each tile, indexed by row * iNumCols + col, with the rows from bottom to top
+	std::vector<unsigned char> vLight;
+	// The emission of each tile, from the tile and the dynamic lights on it
+	std::vector<unsigned char> vEmission;
+	// The emission of each tile, from the tile only
+	std::vector<unsigned char> vTileEmission;
+	// Boolean flags to indicate if each tile blocks light
+	std::vector<unsigned char> vBlocksLight;
+	int iNumCols;
+	int iNumRows;
+
+	// The queues of the flood fills. The removal queue holds each tile with its light level before it was removed
+	std::vector<int> vAddQueue;
+	std::vector<glm::i32vec2> vRemoveQueue;
+
+	// The player's light
+	glm::i32vec2 i32vec2PlayerPosition;
+	int iPlayerLevel;
+
+	// The flashes
+	std::vector<Flash> vFlashes;
+
+	// The rows which changed since the last upload
+	int iDirtyMinRow;
+	int iDirtyMaxRow;
+
+	// The number of tiles which were visited by the flood fills
+	unsigned int uiNumVisitedTiles;
+
+	// The light map
+	GLuint uiTextureID;
+	int iTextureCols;
+	int iTextureRows;
+
+	// The name of the shader
+	std::string sShaderName;
+
+	// Constructor
+	CTileLighting2D(void);
+
+	// Destructor
+	virtual ~CTileLighting2D(void);
+
+	// Load all the tiles of a level, and light them from scratch
+	void LoadFromMap(const TileGridView2D& sGridView);
+
+	// Load a tile of a level, and update its light if it changed
+	void LoadTile(const TileGridView2D& sGridView, const int iCol, const int iRow);
+
+	// Light all the tiles from scratch
+	void Relight(void);
+
+	// Update the light around a tile after its emission or its blocking changed
+	void UpdateTile(const int iIndex);
+
+	// Get the emission of a tile, from the tile and the dynamic lights on it
+	int ComputeEmission(const int iIndex) const;
+
+	// Set the light level of a tile, and mark its row as changed
+	void SetLight(const int iIndex, const int iLevel);
+
+	// Remove the light which spread from the tiles in the removal queue
+	void PropagateRemoval(void);
+
+	// Spread the light from the tiles in the add queue
+	void PropagateAdd(void);
+};
@@ -4,6 +4,13 @@
  */
 #include "Application.h"
 
+// Include Settings to store the command line options
+#include "GameControl\Settings.h"
+
+// Include the C string functions to read the command line
+#include <cstring>
+#include <cstdlib>
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
@@ -24,10 +31,19 @@ Boolean macro to determine if the program is in 3D or 2D mode
 
 /**
  @brief This function is the main function which is called by the operating system when you run the executables
+ @param argc The number of command line arguments
+ @param argv The command line arguments. "-seed <number>" seeds the random number streams, to replay a run
  @return This function returns the error codes
  */
-int main(void)
+int main(int argc, char* argv[])
 {
+	// Read the command line options into the settings
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-seed") == 0) && (i + 1 < argc))
+			CSettings::GetInstance()->ullRandomSeed = strtoull(argv[++i], NULL, 10);
+	}
+
 	Application* pApp = Application::GetInstance();
 	// if the application is initialised properly, then run it
 	if (pApp->Init() == true)
@@ -50,6 +50,14 @@ public:
 	const unsigned char FPS = 30; // FPS of this game
 	const unsigned int frameTime = 1000 / FPS; // time for each frame
 
+	// Simulation Rate Information, which is independent of FPS
+	const unsigned char SIMULATION_STEPS_PER_SECOND = 30;	// number of simulation steps in each second of real time
+	const double SIMULATION_STEP_TIME = 1.0 / 60.0;			// time which is simulated in each step. The game is tuned for this
+	const unsigned int MAX_SIMULATION_STEPS_PER_FRAME = 5;	// the most steps to catch up in one frame
+
+	// Random Number Information
+	unsigned long long ullRandomSeed = 0;	// seed of the random number streams, or 0 for a seed from the time. Set by -seed <number>
+
 	// Input control
 	//const bool bActivateMouseInput
 
@@ -67,6 +75,9 @@ public:
 	float MICRO_STEP_XAXIS;
 	float MICRO_STEP_YAXIS;
 
+	// The light level of the player's light, which is also how many tiles it reaches. The highest level is 15
+	const int PLAYER_LIGHT_LEVEL = 12;
+
 	// Update the specifications of the map
 	void UpdateSpecifications(void);
 
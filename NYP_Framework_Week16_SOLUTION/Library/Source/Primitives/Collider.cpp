@@ -2,6 +2,8 @@
 
 // Include Shader Manager
 #include "..\RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "..\RenderControl\GLStateCache.h"
 
 #include <GLFW/glfw3.h>
 
@@ -77,7 +79,7 @@ bool CCollider::Init(void)
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -124,7 +126,7 @@ void CCollider::Render(void)
 	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
 
 	// render box
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 	glDrawArrays(GL_LINE_LOOP, 0, 36);
 }
 
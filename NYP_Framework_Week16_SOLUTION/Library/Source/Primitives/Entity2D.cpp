@@ -8,13 +8,18 @@
 
  // Include Shader Manager
 #include "..\RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "..\RenderControl\GLStateCache.h"
 
-// Include ImageLoader
-#include "..\System\ImageLoader.h"
+// Include TextureCache
+#include "..\RenderControl\TextureCache.h"
 
 #include <iostream>
 using namespace std;
 
+// The fraction of a simulation step which has passed since the last step
+float CEntity2D::fRenderAlpha = 1.0f;
+
 /**
  @brief Constructor This constructor has protected access modifier as this class will be a Singleton
  */
@@ -24,6 +29,11 @@ CEntity2D::CEntity2D(void)
 	, EBO(0)
 	, iTextureID(0)
 	, dead(false)
+	, uiComponentHandle(0xFFFFFFFF)
+	, bAsleep(false)
+	, uiRestFrameCount(0)
+	, cOwnerPool(NULL)
+	, bRenderTransformStored(false)
 	, cSettings(NULL)
 	, mesh(NULL)
 {
@@ -37,6 +47,10 @@ CEntity2D::CEntity2D(void)
 
 	// Initialise vec2UVCoordinate
 	vec2UVCoordinate = glm::vec2(0.0f);
+
+	// Initialise the UV coordinates for rendering
+	vec2PrevRenderUVCoordinate = glm::vec2(0.0f);
+	vec2CurrRenderUVCoordinate = glm::vec2(0.0f);
 }
 
 /**
@@ -45,12 +59,16 @@ CEntity2D::CEntity2D(void)
 CEntity2D::~CEntity2D(void)
 {
 	// optional: de-allocate all resources once they've outlived their purpose:
-	//glDeleteVertexArrays(1, &VAO);
+	//CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
 	//glDeleteBuffers(1, &VBO);
 	//glDeleteBuffers(1, &EBO);
 	//CS: Delete the mesh
 	if(mesh)
 		delete mesh;
+
+	// Release the texture
+	if (iTextureID != 0)
+		CTextureCache::GetInstance()->Release(iTextureID);
 }
 
 /**
@@ -74,7 +92,7 @@ bool CEntity2D::Init(void)
 	};*/
 
 	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 	//glGenBuffers(1, &VBO);
 	//glGenBuffers(1, &EBO);
 
@@ -126,17 +144,139 @@ void CEntity2D::CollidedWith(CEntity2D* entity)
 
 }
 
+/**
+ @brief Check if this entity can be updated on a worker thread, in parallel with other entities.
+		Such an entity must only change its own state in Update, and record any other changes
+		into a command buffer. By default, an entity is updated on the main thread.
+ */
+bool CEntity2D::IsParallelSafe(void) const
+{
+	return false;
+}
+
+/**
+ @brief Check if this entity is at rest and can be put to sleep. 
+		By default, an entity is never at rest.
+ */
+bool CEntity2D::IsAtRest(void) const
+{
+	return false;
+}
+
+/**
+ @brief Get the tile index which this entity is resting on. 
+		A change to this tile in the map will wake this entity up.
+ */
+glm::i32vec2 CEntity2D::GetRestingTile(void) const
+{
+	return i32vec2Index;
+}
+
+/**
+ @brief Wake this entity up so that it will be updated again
+ */
+void CEntity2D::Wake(void)
+{
+	bAsleep = false;
+	uiRestFrameCount = 0;
+}
+
+/**
+ @brief Update the sleep state. An entity which is at rest for a number of consecutive frames will fall asleep.
+ @param uiFramesBeforeSleep A const unsigned int variable containing the number of frames at rest before sleeping
+ */
+bool CEntity2D::UpdateSleepState(const unsigned int uiFramesBeforeSleep)
+{
+	if (IsAtRest() == false)
+	{
+		uiRestFrameCount = 0;
+		return false;
+	}
+
+	uiRestFrameCount++;
+	if (uiRestFrameCount >= uiFramesBeforeSleep)
+		bAsleep = true;
+
+	return bAsleep;
+}
+
+/**
+ @brief Check if this entity is asleep
+ */
+bool CEntity2D::IsAsleep(void) const
+{
+	return bAsleep;
+}
+
+/**
+ @brief Set the pool which owns this entity
+ @param cOwnerPool A CEntityPool2DBase* variable which is the pool which owns this entity
+ */
+void CEntity2D::SetOwnerPool(CEntityPool2DBase* cOwnerPool)
+{
+	this->cOwnerPool = cOwnerPool;
+}
+
+/**
+ @brief Get the pool which owns this entity. Returns NULL if this entity is not pooled
+ */
+CEntityPool2DBase* CEntity2D::GetOwnerPool(void) const
+{
+	return cOwnerPool;
+}
+
+/**
+ @brief Store the UV coordinate at the end of a simulation step, for interpolating the rendering.
+		The first time it is stored, there is no previous step, so both UV coordinates are set to it.
+ */
+void CEntity2D::StoreRenderTransform(void)
+{
+	vec2PrevRenderUVCoordinate = bRenderTransformStored ? vec2CurrRenderUVCoordinate : vec2UVCoordinate;
+	vec2CurrRenderUVCoordinate = vec2UVCoordinate;
+	bRenderTransformStored = true;
+}
+
+/**
+ @brief Reset the stored UV coordinates. 
+		Call this when an entity is respawned, so that it is not rendered moving from its old position
+ */
+void CEntity2D::ResetRenderTransform(void)
+{
+	bRenderTransformStored = false;
+}
+
+/**
+ @brief Get the UV coordinate to render at, which is interpolated between the last 2 simulation steps.
+		If no step has been stored yet, then the latest UV coordinate is used.
+ */
+glm::vec2 CEntity2D::GetRenderUVCoordinate(void) const
+{
+	if (bRenderTransformStored == false)
+		return vec2UVCoordinate;
+
+	return vec2PrevRenderUVCoordinate + (vec2CurrRenderUVCoordinate - vec2PrevRenderUVCoordinate) * fRenderAlpha;
+}
+
+/**
+ @brief Set the fraction of a simulation step which has passed since the last step
+ @param fRenderAlpha A const float variable containing the fraction, from 0 to 1
+ */
+void CEntity2D::SetRenderAlpha(const float fRenderAlpha)
+{
+	CEntity2D::fRenderAlpha = fRenderAlpha;
+}
+
 /**
  @brief Set up the OpenGL display environment before rendering
  */
 void CEntity2D::PreRender(void)
 {
 	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
 
 	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use("2DShader");
@@ -147,26 +287,26 @@ void CEntity2D::PreRender(void)
  */
 void CEntity2D::Render(void)
 {
-	// get matrix's uniform location and set matrix
-	unsigned int transformLoc = glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "transform");
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	// Get the active shader, which keeps the locations of its uniforms
+	CShader* cShader = CShaderManager::GetInstance()->activeShader;
 
 	transform = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-	transform = glm::translate(transform, glm::vec3(vec2UVCoordinate.x,
-													vec2UVCoordinate.y,
+	const glm::vec2 vec2RenderUVCoordinate = GetRenderUVCoordinate();
+	transform = glm::translate(transform, glm::vec3(vec2RenderUVCoordinate.x,
+													vec2RenderUVCoordinate.y,
 													0.0f));
 	// Update the shaders with the latest transform
-	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+	cShader->setMat4(UNIFORM_TRANSFORM, transform);
 
 	// Get the texture to be rendered
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, iTextureID);
 
-	glBindVertexArray(VAO);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
 
 	//CS: Use mesh to render
 	mesh->Render();
 
-	glBindVertexArray(0);
+	CGLStateCache::GetInstance()->BindVertexArray(0);
 
 }
 
@@ -175,48 +315,18 @@ void CEntity2D::Render(void)
  */
 void CEntity2D::PostRender(void)
 {
-	// Disable blending
-	glDisable(GL_BLEND);
 }
 
 /**
-@brief Load a texture, assign it a code and store it in MapOfTextureIDs.
+@brief Load a texture from the texture cache, which only loads the file once for all the users of the texture.
 @param filename A const char* variable which contains the file name of the texture
 */
 bool CEntity2D::LoadTexture(const char* filename)
 {
-	// Variables used in loading the texture
-	int width, height, nrChannels;
-	
-	// texture 1
-	// ---------
-	glGenTextures(1, &iTextureID);
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
-	// set the texture wrapping parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	// set texture filtering parameters
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-	unsigned char *data = cImageLoader->Load(filename, width, height, nrChannels, true);
-	if (data)
-	{
-		if (nrChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (nrChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	CTextureCache* cTextureCache = CTextureCache::GetInstance();
+	if (iTextureID != 0)
+		cTextureCache->Release(iTextureID);
 
-		// Generate mipmaps
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		return false;
-	}
-	// Free up the memory of the file data read in
-	free(data);
-
-	return true;
+	iTextureID = cTextureCache->Acquire(filename, true, GL_REPEAT, GL_LINEAR, true);
+	return iTextureID != 0;
 }
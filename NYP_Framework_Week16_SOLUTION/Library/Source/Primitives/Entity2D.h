@@ -24,6 +24,9 @@
 #include "Mesh.h"
 using namespace std;
 
+// The pool which owns an entity, if any
+class CEntityPool2DBase;
+
 class CEntity2D
 {
 public:
@@ -54,6 +57,42 @@ public:
 	// Collision Handler
 	virtual void CollidedWith(CEntity2D*);
 
+	// Check if this entity can be updated on a worker thread, in parallel with other entities
+	virtual bool IsParallelSafe(void) const;
+
+	// Check if this entity is at rest and can be put to sleep
+	virtual bool IsAtRest(void) const;
+
+	// Get the tile index which this entity is resting on
+	virtual glm::i32vec2 GetRestingTile(void) const;
+
+	// Wake this entity up so that it will be updated again
+	virtual void Wake(void);
+
+	// Update the sleep state. Returns true if this entity is asleep
+	bool UpdateSleepState(const unsigned int uiFramesBeforeSleep);
+
+	// Check if this entity is asleep
+	bool IsAsleep(void) const;
+
+	// Set the pool which owns this entity
+	void SetOwnerPool(CEntityPool2DBase* cOwnerPool);
+
+	// Get the pool which owns this entity. Returns NULL if this entity is not pooled
+	CEntityPool2DBase* GetOwnerPool(void) const;
+
+	// Store the UV coordinate at the end of a simulation step, for interpolating the rendering
+	void StoreRenderTransform(void);
+
+	// Reset the stored UV coordinates, so that the next rendering does not interpolate from an old position
+	void ResetRenderTransform(void);
+
+	// Get the UV coordinate to render at, between the last 2 simulation steps
+	glm::vec2 GetRenderUVCoordinate(void) const;
+
+	// Set the fraction of a simulation step which has passed since the last step
+	static void SetRenderAlpha(const float fRenderAlpha);
+
 	// The i32vec2 which stores the indices of an Entity2D in the Map2D
 	glm::i32vec2 i32vec2Index;
 
@@ -68,7 +107,28 @@ public:
 
 	std::string name;
 
+	// The handle to the components of this entity in the component store
+	unsigned int uiComponentHandle;
+
 protected:
+	// Boolean flag to indicate if this entity is asleep
+	bool bAsleep;
+
+	// The number of consecutive frames which this entity has been at rest
+	unsigned int uiRestFrameCount;
+
+	// The pool which owns this entity. Pooled entities are released to it instead of being deleted
+	CEntityPool2DBase* cOwnerPool;
+
+	// The UV coordinates at the end of the previous and the latest simulation steps
+	glm::vec2 vec2PrevRenderUVCoordinate;
+	glm::vec2 vec2CurrRenderUVCoordinate;
+	// Boolean flag to indicate if the UV coordinates above have been stored
+	bool bRenderTransformStored;
+
+	// The fraction of a simulation step which has passed since the last step. This is shared by all entities
+	static float fRenderAlpha;
+
 	// Name of Shader Program instance
 	std::string sShaderName;
 
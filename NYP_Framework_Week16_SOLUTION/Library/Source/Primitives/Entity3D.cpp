@@ -8,6 +8,9 @@
 // Include ImageLoader
 #include "..\System\ImageLoader.h"
 
+// Include GLStateCache
+#include "..\RenderControl\GLStateCache.h"
+
 #include <iostream>
 using namespace std;
 
@@ -318,7 +321,7 @@ int CEntity3D::LoadTexture(const char* filename)
 	// texture 1
 	// ---------
 	glGenTextures(1, &iTextureID);
-	glBindTexture(GL_TEXTURE_2D, iTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, iTextureID);
 	// set the texture wrapping parameters
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
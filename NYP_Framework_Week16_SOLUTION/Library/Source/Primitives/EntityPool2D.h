@@ -0,0 +1,132 @@
+/**
+ CEntityPool2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include CEntity2D
+#include "Entity2D.h"
+
+// Include vector and algorithm
+#include <vector>
+#include <algorithm>
+// Include iostream
+#include <iostream>
+
+/**
+ CEntityPool2DBase: The interface used by CEntity2D to return itself to the pool which owns it
+ */
+class CEntityPool2DBase
+{
+public:
+	// Destructor
+	virtual ~CEntityPool2DBase(void) {}
+
+	// Return an entity to this pool
+	virtual void Release(CEntity2D* cEntity2D) = 0;
+};
+
+/**
+ CEntityPool2D: A fixed size pool of transient entities such as bombs.
+				All the entities are allocated in Init, so Acquire and Release do not allocate any memory.
+				Acquire resets the state which every entity has, such as being dead or asleep,
+				and the type of the entity resets its own state when it is spawned.
+ */
+template <class T>
+class CEntityPool2D : public CEntityPool2DBase
+{
+public:
+	// Constructor
+	CEntityPool2D(void)
+	{
+	}
+
+	// Destructor
+	virtual ~CEntityPool2D(void)
+	{
+		Destroy();
+	}
+
+	// Initialise this pool by allocating uiCapacity entities
+	bool Init(const unsigned int uiCapacity)
+	{
+		Destroy();
+
+		vEntities.reserve(uiCapacity);
+		vFreeEntities.reserve(uiCapacity);
+		for (unsigned int i = 0; i < uiCapacity; i++)
+		{
+			T* cEntity = new T();
+			cEntity->SetOwnerPool(this);
+			vEntities.push_back(cEntity);
+			vFreeEntities.push_back(cEntity);
+		}
+		return true;
+	}
+
+	// Delete all the entities in this pool
+	void Destroy(void)
+	{
+		for (unsigned int i = 0; i < vEntities.size(); i++)
+		{
+			delete vEntities[i];
+		}
+		vEntities.clear();
+		vFreeEntities.clear();
+	}
+
+	// Get a free entity from this pool. Returns NULL if the pool is exhausted
+	T* Acquire(void)
+	{
+		if (vFreeEntities.empty())
+			return NULL;
+
+		T* cEntity = vFreeEntities.back();
+		vFreeEntities.pop_back();
+
+		// The entity may have died or fallen asleep in its previous life,
+		// and it should not be rendered moving from where it was then
+		cEntity->dead = false;
+		cEntity->CEntity2D::Wake();
+		cEntity->ResetRenderTransform();
+		return cEntity;
+	}
+
+	// Return an entity to this pool. An entity which is not in use, or is owned by another pool, is ignored,
+	// so that releasing an entity twice cannot hand it out to 2 owners
+	void Release(CEntity2D* cEntity2D)
+	{
+		if ((cEntity2D == NULL) || (cEntity2D->GetOwnerPool() != this))
+		{
+			std::cout << "CEntityPool2D::Release() : The entity is not owned by this pool" << std::endl;
+			return;
+		}
+		T* cEntity = static_cast<T*>(cEntity2D);
+		if (std::find(vFreeEntities.begin(), vFreeEntities.end(), cEntity) != vFreeEntities.end())
+		{
+			std::cout << "CEntityPool2D::Release() : The entity was already released" << std::endl;
+			return;
+		}
+		vFreeEntities.push_back(cEntity);
+	}
+
+	// Get the number of entities in this pool
+	unsigned int GetCapacity(void) const
+	{
+		return (unsigned int)vEntities.size();
+	}
+
+	// Get the number of entities which are in use
+	unsigned int GetNumActive(void) const
+	{
+		return (unsigned int)(vEntities.size() - vFreeEntities.size());
+	}
+
+protected:
+	// All the entities owned by this pool
+	std::vector<T*> vEntities;
+
+	// The entities which are not in use
+	std::vector<T*> vFreeEntities;
+};
@@ -10,6 +10,9 @@ Sprite Animation
 #include "SpriteAnimation.h"
 #include "GL\glew.h"
 
+//the time between the updates of the frames of all the sprite animations
+float CSpriteAnimation::updateInterval = 0.0f;
+
 /******************************************************************************/
 /*!
 \brief
@@ -21,6 +24,7 @@ CSpriteAnimation::CSpriteAnimation(int row, int col)
 	, row(row)
 	, col(col)
 	, currentTime(0)
+	, pendingTime(0)
 	, currentFrame(0)
 	, playCount(0)
 	, currentAnimation("")
@@ -64,8 +68,12 @@ void CSpriteAnimation::Update(double dt)
 	//Check if the current animation is active
 	if (animationList[currentAnimation]->animActive)
 	{
-		//Add the delta time
-		currentTime += static_cast<float>(dt);
+		//Wait for the update interval, and then add all the delta time which was waited for
+		pendingTime += static_cast<float>(dt);
+		if (pendingTime < updateInterval)
+			return;
+		currentTime += pendingTime;
+		pendingTime = 0.f;
 
 		//Get the number of frame to get the frame per second
 		int numFrame = animationList[currentAnimation]->frames.size();
@@ -285,4 +293,55 @@ void CSpriteAnimation::Reset()
 {
 	currentFrame = animationList[currentAnimation]->frames[0];
 	playCount = 0;
-}
\ No newline at end of file
+}
+/******************************************************************************/
+/*!
+\brief
+Set the time between the updates of the frames of all the sprite animations.
+The frames are still chosen from the full time, so an animation keeps its speed and only skips frames.
+
+param interval - the time in seconds, where 0 updates the frames every frame
+
+\exception None
+\return None
+*/
+/******************************************************************************/
+void CSpriteAnimation::SetUpdateInterval(float interval)
+{
+	updateInterval = (interval > 0.f) ? interval : 0.f;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Get the time between the updates of the frames of all the sprite animations
+
+\exception None
+\return The time in seconds
+*/
+/******************************************************************************/
+float CSpriteAnimation::GetUpdateInterval()
+{
+	return updateInterval;
+}
+
+/******************************************************************************/
+/*!
+\brief
+Get the texture coordinates of the current frame, which are the same as the
+quad of the frame in GenerateSpriteAnimation, for drawing it in a sprite batch
+
+\exception None
+\return The left, bottom, right and top of the texture coordinates
+*/
+/******************************************************************************/
+glm::vec4 CSpriteAnimation::GetFrameUVRect() const
+{
+	float width = 1.f / col;
+	float height = 1.f / row;
+	int i = currentFrame / col;
+	int j = currentFrame % col;
+	float u1 = j * width;
+	float v1 = 1.f - height - i * height;
+	return glm::vec4(u1, v1, u1 + width, v1 + height);
+}
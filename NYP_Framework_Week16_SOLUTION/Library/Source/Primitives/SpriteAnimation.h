@@ -79,7 +79,18 @@ public:
 	void Resume();
 	void Reset();
 
+	//Get the left, bottom, right and top of the texture coordinates of the current frame, for a sprite batch
+	glm::vec4 GetFrameUVRect() const;
+
+	//Set the time between the updates of the frames of all the sprite animations, where 0 updates them every frame
+	static void SetUpdateInterval(float interval);
+	//Get the time between the updates of the frames of all the sprite animations
+	static float GetUpdateInterval();
+
 private:
+	//the time between the updates of the frames of all the sprite animations
+	static float updateInterval;
+
 	//number of rows
 	int row;
 	//number of columns 
@@ -87,6 +98,8 @@ private:
 
 	//the current time of the animation
 	float currentTime;
+	//the time which has not been added to the current time, until the next update of the frames
+	float pendingTime;
 	//the current frame of the animation
 	int currentFrame;
 	//How many time it has play
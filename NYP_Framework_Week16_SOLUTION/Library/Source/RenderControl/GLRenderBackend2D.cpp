@@ -0,0 +1,172 @@
+/**
+ CGLRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "GLRenderBackend2D.h"
+
+// Include ShaderManager
+#include "ShaderManager.h"
+// Include GLStateCache
+#include "GLStateCache.h"
+// Include StreamBuffer
+#include "StreamBuffer.h"
+
+#include <cstring>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CGLRenderBackend2D::CGLRenderBackend2D(void)
+	: VAO(0)
+	, EBO(0)
+	, uiNumItemsDrawn(0)
+	, uiNumDrawCalls(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CGLRenderBackend2D::~CGLRenderBackend2D(void)
+{
+	if (VAO != 0)
+	{
+		CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &EBO);
+	}
+}
+
+/**
+ @brief Init Initialise this instance. The indices never change, so only the vertices are uploaded when drawing
+ */
+bool CGLRenderBackend2D::Init(void)
+{
+	if (VAO != 0)
+		return true;
+
+	if (CStreamBuffer::GetInstance()->GetBufferID() == 0)
+	{
+		cout << "CGLRenderBackend2D::Init: The stream buffer must be initialised first" << endl;
+		return false;
+	}
+
+	const unsigned int uiMaxItems = CRenderCommandList2D::MAX_ITEMS_PER_RUN;
+	std::vector<GLuint> vIndices(uiMaxItems * 6);
+	for (unsigned int i = 0; i < uiMaxItems; i++)
+	{
+		vIndices[i * 6 + 0] = i * 4 + 0;
+		vIndices[i * 6 + 1] = i * 4 + 1;
+		vIndices[i * 6 + 2] = i * 4 + 2;
+		vIndices[i * 6 + 3] = i * 4 + 0;
+		vIndices[i * 6 + 4] = i * 4 + 2;
+		vIndices[i * 6 + 5] = i * 4 + 3;
+	}
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &EBO);
+
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, CStreamBuffer::GetInstance()->GetBufferID());
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndices.size() * sizeof(GLuint), vIndices.data(), GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(glm::vec3));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec4)));
+	glEnableVertexAttribArray(2);
+
+	CGLStateCache::GetInstance()->BindVertexArray(0);
+	return true;
+}
+
+/**
+ @brief Draw the runs of a prepared list. The vertices of each run are copied into the stream buffer,
+		and drawn with one draw call from their base vertex.
+ @param cList A const CRenderCommandList2D& variable containing the prepared list
+ */
+void CGLRenderBackend2D::Execute(const CRenderCommandList2D& cList)
+{
+	const std::vector<CRenderCommandList2D::Run>& vRuns = cList.GetRuns();
+	if ((VAO == 0) || (vRuns.size() == 0))
+		return;
+
+	const std::vector<Vertex>& vVertices = cList.GetVertices();
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+
+	CShader* cCurrentShader = NULL;
+	for (unsigned int i = 0; i < vRuns.size(); i++)
+	{
+		const CRenderCommandList2D::Run& sRun = vRuns[i];
+		if (sRun.cShader != cCurrentShader)
+		{
+			cCurrentShader = sRun.cShader;
+			CShaderManager::GetInstance()->activeShader = cCurrentShader;
+			cCurrentShader->use();
+			cCurrentShader->setMat4(UNIFORM_TRANSFORM, glm::mat4(1.0f));
+			cCurrentShader->setVec4(UNIFORM_RUNTIME_COLOR, glm::vec4(1.0f));
+		}
+		CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, sRun.uiTextureID);
+
+		const GLsizeiptr iSize = sRun.uiNumItems * 4 * sizeof(Vertex);
+		const CStreamBuffer::Allocation sAllocation = cStreamBuffer->Allocate(iSize, sizeof(Vertex));
+		if (sAllocation.pData == NULL)
+			continue;
+		memcpy(sAllocation.pData, &vVertices[sRun.uiFirstVertex], iSize);
+		cStreamBuffer->Commit(sAllocation);
+
+		glDrawElementsBaseVertex(GL_TRIANGLES, sRun.uiNumItems * 6, GL_UNSIGNED_INT, 0, (GLint)(sAllocation.iOffset / sizeof(Vertex)));
+
+		uiNumItemsDrawn += sRun.uiNumItems;
+		uiNumDrawCalls++;
+	}
+
+	CGLStateCache::GetInstance()->BindVertexArray(0);
+}
+
+/**
+ @brief Delete a number of textures
+ @param iNumTextures A const GLsizei variable containing the number of textures
+ @param pTextures A const GLuint* variable containing the textures
+ */
+void CGLRenderBackend2D::DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures)
+{
+	if (iNumTextures > 0)
+		CGLStateCache::GetInstance()->DeleteTextures(iNumTextures, pTextures);
+}
+
+/**
+ @brief Get the number of draw items which were drawn since ResetCounts
+ */
+unsigned int CGLRenderBackend2D::GetNumItemsDrawn(void) const
+{
+	return uiNumItemsDrawn;
+}
+
+/**
+ @brief Get the number of draw calls since ResetCounts
+ */
+unsigned int CGLRenderBackend2D::GetNumDrawCalls(void) const
+{
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Reset the numbers of draw items and draw calls
+ */
+void CGLRenderBackend2D::ResetCounts(void)
+{
+	uiNumItemsDrawn = 0;
+	uiNumDrawCalls = 0;
+}
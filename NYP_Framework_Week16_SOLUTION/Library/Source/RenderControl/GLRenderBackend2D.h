@@ -0,0 +1,50 @@
+/**
+ CGLRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include RenderBackend2D
+#include "RenderBackend2D.h"
+
+/**
+ CGLRenderBackend2D: Draws the runs of a prepared render command list with OpenGL. The vertices of each run are
+					 copied into the stream buffer, and drawn with one draw call from their base vertex.
+					 The transform of the shaders is set to the identity, and their runtime_color to white,
+					 as the positions and the tint are in the vertices.
+					 This must only be used on the thread which owns the OpenGL context, after the stream buffer
+					 is initialised.
+ */
+class CGLRenderBackend2D : public CRenderBackend2D
+{
+public:
+	// Constructor
+	CGLRenderBackend2D(void);
+
+	// Destructor
+	virtual ~CGLRenderBackend2D(void);
+
+	// Init
+	virtual bool Init(void);
+
+	// Draw the runs of a prepared list
+	virtual void Execute(const CRenderCommandList2D& cList);
+
+	// Delete a number of textures
+	virtual void DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures);
+
+	// Get the number of draw items and draw calls since ResetCounts
+	virtual unsigned int GetNumItemsDrawn(void) const;
+	virtual unsigned int GetNumDrawCalls(void) const;
+	// Reset the numbers of draw items and draw calls
+	virtual void ResetCounts(void);
+
+protected:
+	// OpenGL objects. The vertices are in the stream buffer
+	GLuint VAO, EBO;
+
+	// The numbers of draw items and draw calls since ResetCounts
+	unsigned int uiNumItemsDrawn;
+	unsigned int uiNumDrawCalls;
+};
@@ -0,0 +1,289 @@
+/**
+ CGLStateCache
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "GLStateCache.h"
+
+#include <iostream>
+using namespace std;
+
+// The constants which are used by reference
+const unsigned int CGLStateCache::MAX_TEXTURE_UNITS;
+const GLuint CGLStateCache::UNKNOWN;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CGLStateCache::CGLStateCache(void)
+	: uiNumIssuedCalls(0)
+	, uiNumFilteredCalls(0)
+{
+	Invalidate();
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CGLStateCache::~CGLStateCache(void)
+{
+}
+
+/**
+ @brief Use a program
+ @param uiProgram A const GLuint variable containing the program
+ */
+void CGLStateCache::UseProgram(const GLuint uiProgram)
+{
+	if (Change(this->uiProgram, uiProgram))
+		glUseProgram(uiProgram);
+}
+
+/**
+ @brief Bind a vertex array
+ @param uiVertexArray A const GLuint variable containing the vertex array, or 0 to unbind it
+ */
+void CGLStateCache::BindVertexArray(const GLuint uiVertexArray)
+{
+	if (Change(this->uiVertexArray, uiVertexArray))
+		glBindVertexArray(uiVertexArray);
+}
+
+/**
+ @brief Select the active texture unit
+ @param eTextureUnit A const GLenum variable containing GL_TEXTURE0 + the index of the unit
+ */
+void CGLStateCache::ActiveTexture(const GLenum eTextureUnit)
+{
+	if (Change(uiActiveTextureUnit, eTextureUnit - GL_TEXTURE0))
+		glActiveTexture(eTextureUnit);
+}
+
+/**
+ @brief Bind a texture to the active texture unit. Only GL_TEXTURE_2D on the first MAX_TEXTURE_UNITS units is tracked
+ @param eTarget A const GLenum variable containing the target
+ @param uiTexture A const GLuint variable containing the texture, or 0 to unbind it
+ */
+void CGLStateCache::BindTexture(const GLenum eTarget, const GLuint uiTexture)
+{
+	if ((eTarget == GL_TEXTURE_2D) && (uiActiveTextureUnit < MAX_TEXTURE_UNITS))
+	{
+		if (Change(arrTextures[uiActiveTextureUnit], uiTexture))
+			glBindTexture(eTarget, uiTexture);
+		return;
+	}
+
+	uiNumIssuedCalls++;
+	glBindTexture(eTarget, uiTexture);
+}
+
+/**
+ @brief Enable a capability
+ @param eCapability A const GLenum variable containing the capability
+ */
+void CGLStateCache::Enable(const GLenum eCapability)
+{
+	SetCapability(eCapability, true);
+}
+
+/**
+ @brief Disable a capability
+ @param eCapability A const GLenum variable containing the capability
+ */
+void CGLStateCache::Disable(const GLenum eCapability)
+{
+	SetCapability(eCapability, false);
+}
+
+/**
+ @brief Set the blending function
+ @param eSourceFactor A const GLenum variable containing the factor of the source colour
+ @param eDestinationFactor A const GLenum variable containing the factor of the destination colour
+ */
+void CGLStateCache::BlendFunc(const GLenum eSourceFactor, const GLenum eDestinationFactor)
+{
+	if ((eBlendSourceFactor == eSourceFactor) && (eBlendDestinationFactor == eDestinationFactor))
+	{
+		uiNumFilteredCalls++;
+		return;
+	}
+
+	eBlendSourceFactor = eSourceFactor;
+	eBlendDestinationFactor = eDestinationFactor;
+	uiNumIssuedCalls++;
+	glBlendFunc(eSourceFactor, eDestinationFactor);
+}
+
+/**
+ @brief Set the depth function
+ @param eFunction A const GLenum variable containing the function
+ */
+void CGLStateCache::DepthFunc(const GLenum eFunction)
+{
+	if (Change(eDepthFunction, eFunction))
+		glDepthFunc(eFunction);
+}
+
+/**
+ @brief Set the viewport
+ @param iX A const GLint variable containing the left of the viewport
+ @param iY A const GLint variable containing the bottom of the viewport
+ @param iWidth A const GLsizei variable containing the width of the viewport
+ @param iHeight A const GLsizei variable containing the height of the viewport
+ */
+void CGLStateCache::Viewport(const GLint iX, const GLint iY, const GLsizei iWidth, const GLsizei iHeight)
+{
+	if ((bViewportKnown) &&
+		(arrViewport[0] == iX) && (arrViewport[1] == iY) && (arrViewport[2] == iWidth) && (arrViewport[3] == iHeight))
+	{
+		uiNumFilteredCalls++;
+		return;
+	}
+
+	bViewportKnown = true;
+	arrViewport[0] = iX;
+	arrViewport[1] = iY;
+	arrViewport[2] = iWidth;
+	arrViewport[3] = iHeight;
+	uiNumIssuedCalls++;
+	glViewport(iX, iY, iWidth, iHeight);
+}
+
+/**
+ @brief Delete textures. OpenGL unbinds a deleted texture from every unit, so it is unbound from the copy too
+ @param iNumTextures A const GLsizei variable containing the number of textures
+ @param pTextures A const GLuint* variable containing the textures
+ */
+void CGLStateCache::DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures)
+{
+	for (GLsizei i = 0; i < iNumTextures; i++)
+	{
+		for (unsigned int j = 0; j < MAX_TEXTURE_UNITS; j++)
+		{
+			if ((pTextures[i] != 0) && (arrTextures[j] == pTextures[i]))
+				arrTextures[j] = 0;
+		}
+	}
+	glDeleteTextures(iNumTextures, pTextures);
+}
+
+/**
+ @brief Delete vertex arrays. OpenGL unbinds a deleted vertex array, so it is unbound from the copy too
+ @param iNumVertexArrays A const GLsizei variable containing the number of vertex arrays
+ @param pVertexArrays A const GLuint* variable containing the vertex arrays
+ */
+void CGLStateCache::DeleteVertexArrays(const GLsizei iNumVertexArrays, const GLuint* pVertexArrays)
+{
+	for (GLsizei i = 0; i < iNumVertexArrays; i++)
+	{
+		if ((pVertexArrays[i] != 0) && (uiVertexArray == pVertexArrays[i]))
+			uiVertexArray = 0;
+	}
+	glDeleteVertexArrays(iNumVertexArrays, pVertexArrays);
+}
+
+/**
+ @brief Delete a program. A program in use is only deleted when it is no longer used, so the copy is forgotten
+ @param uiProgram A const GLuint variable containing the program
+ */
+void CGLStateCache::DeleteProgram(const GLuint uiProgram)
+{
+	if ((uiProgram != 0) && (this->uiProgram == uiProgram))
+		this->uiProgram = UNKNOWN;
+	glDeleteProgram(uiProgram);
+}
+
+/**
+ @brief Forget the copy, so that the next change of each state is sent to OpenGL
+ */
+void CGLStateCache::Invalidate(void)
+{
+	uiProgram = UNKNOWN;
+	uiVertexArray = UNKNOWN;
+	uiActiveTextureUnit = UNKNOWN;
+	for (unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++)
+		arrTextures[i] = UNKNOWN;
+	uiBlend = UNKNOWN;
+	uiDepthTest = UNKNOWN;
+	eBlendSourceFactor = UNKNOWN;
+	eBlendDestinationFactor = UNKNOWN;
+	eDepthFunction = UNKNOWN;
+	bViewportKnown = false;
+}
+
+/**
+ @brief Get the number of calls which were sent to OpenGL
+ */
+unsigned int CGLStateCache::GetNumIssuedCalls(void) const
+{
+	return uiNumIssuedCalls;
+}
+
+/**
+ @brief Get the number of calls which were filtered, as they did not change the state
+ */
+unsigned int CGLStateCache::GetNumFilteredCalls(void) const
+{
+	return uiNumFilteredCalls;
+}
+
+/**
+ @brief Reset the numbers of calls
+ */
+void CGLStateCache::ResetCallCounts(void)
+{
+	uiNumIssuedCalls = 0;
+	uiNumFilteredCalls = 0;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CGLStateCache::PrintSelf(void) const
+{
+	cout << "CGLStateCache::PrintSelf()" << endl;
+	cout << "Issued calls: " << uiNumIssuedCalls << endl;
+	cout << "Filtered calls: " << uiNumFilteredCalls << endl;
+}
+
+/**
+ @brief Update a tracked value, and return true if the call has to be sent to OpenGL
+ @param uiValue A GLuint& variable containing the tracked value
+ @param uiNewValue A const GLuint variable containing the new value
+ */
+bool CGLStateCache::Change(GLuint& uiValue, const GLuint uiNewValue)
+{
+	if (uiValue == uiNewValue)
+	{
+		uiNumFilteredCalls++;
+		return false;
+	}
+
+	uiValue = uiNewValue;
+	uiNumIssuedCalls++;
+	return true;
+}
+
+/**
+ @brief Set if a capability is enabled. Only GL_BLEND and GL_DEPTH_TEST are tracked, and the others are always sent
+ @param eCapability A const GLenum variable containing the capability
+ @param bEnabled A const bool variable which is true to enable the capability
+ */
+void CGLStateCache::SetCapability(const GLenum eCapability, const bool bEnabled)
+{
+	GLuint* pValue = NULL;
+	if (eCapability == GL_BLEND)
+		pValue = &uiBlend;
+	else if (eCapability == GL_DEPTH_TEST)
+		pValue = &uiDepthTest;
+
+	if ((pValue != NULL) && (Change(*pValue, bEnabled ? GL_TRUE : GL_FALSE) == false))
+		return;
+	if (pValue == NULL)
+		uiNumIssuedCalls++;
+
+	if (bEnabled)
+		glEnable(eCapability);
+	else
+		glDisable(eCapability);
+}
@@ -0,0 +1,118 @@
+/**
+ CGLStateCache
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+/**
+ CGLStateCache: Keeps a copy of the OpenGL state which the engine changes, which is the program, the vertex array,
+				the 2D texture of each texture unit, the active texture unit, blending, depth testing and the viewport.
+				A change to the same value as the copy is not sent to OpenGL. The number of calls which were
+				sent and which were filtered are counted.
+
+				All the engine's changes to this state must go through this class, or the copy will be wrong.
+				A texture, vertex array or program must be deleted through this class too, as OpenGL unbinds it,
+				and its name can be given to a new object. Code which changes the state directly, and does not
+				restore it, must call Invalidate afterwards. The ImGui backend restores the state which it changes.
+ */
+class CGLStateCache : public CSingletonTemplate<CGLStateCache>
+{
+	friend CSingletonTemplate<CGLStateCache>;
+public:
+	// The number of texture units which are tracked
+	static const unsigned int MAX_TEXTURE_UNITS = 8;
+
+	// Use a program
+	void UseProgram(const GLuint uiProgram);
+
+	// Bind a vertex array
+	void BindVertexArray(const GLuint uiVertexArray);
+
+	// Select the active texture unit, as GL_TEXTURE0 + the index of the unit
+	void ActiveTexture(const GLenum eTextureUnit);
+	// Bind a texture to the active texture unit. Only GL_TEXTURE_2D is tracked
+	void BindTexture(const GLenum eTarget, const GLuint uiTexture);
+
+	// Enable and disable a capability. Only GL_BLEND and GL_DEPTH_TEST are tracked
+	void Enable(const GLenum eCapability);
+	void Disable(const GLenum eCapability);
+
+	// Set the blending function
+	void BlendFunc(const GLenum eSourceFactor, const GLenum eDestinationFactor);
+
+	// Set the depth function
+	void DepthFunc(const GLenum eFunction);
+
+	// Set the viewport
+	void Viewport(const GLint iX, const GLint iY, const GLsizei iWidth, const GLsizei iHeight);
+
+	// Delete textures, and unbind them from the copy
+	void DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures);
+	// Delete vertex arrays, and unbind them from the copy
+	void DeleteVertexArrays(const GLsizei iNumVertexArrays, const GLuint* pVertexArrays);
+	// Delete a program, and unbind it from the copy
+	void DeleteProgram(const GLuint uiProgram);
+
+	// Forget the copy, so that the next change of each state is sent to OpenGL
+	void Invalidate(void);
+
+	// Get the number of calls which were sent to OpenGL
+	unsigned int GetNumIssuedCalls(void) const;
+	// Get the number of calls which were filtered, as they did not change the state
+	unsigned int GetNumFilteredCalls(void) const;
+	// Reset the numbers of calls, such as at the start of a frame
+	void ResetCallCounts(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The value of a state which is not known, as it was not set through this class
+	static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+	// The program in use
+	GLuint uiProgram;
+	// The bound vertex array
+	GLuint uiVertexArray;
+	// The index of the active texture unit
+	GLuint uiActiveTextureUnit;
+	// The 2D texture bound to each texture unit
+	GLuint arrTextures[MAX_TEXTURE_UNITS];
+	// The blending and depth testing, as GL_TRUE, GL_FALSE or UNKNOWN
+	GLuint uiBlend;
+	GLuint uiDepthTest;
+	// The blending factors
+	GLenum eBlendSourceFactor;
+	GLenum eBlendDestinationFactor;
+	// The depth function
+	GLenum eDepthFunction;
+	// The viewport, which is only known if bViewportKnown is true
+	bool bViewportKnown;
+	GLint arrViewport[4];
+
+	// The numbers of calls which were sent to OpenGL and which were filtered
+	unsigned int uiNumIssuedCalls;
+	unsigned int uiNumFilteredCalls;
+
+	// Constructor
+	CGLStateCache(void);
+
+	// Destructor
+	virtual ~CGLStateCache(void);
+
+	// Update a tracked value, and return true if the call has to be sent to OpenGL
+	bool Change(GLuint& uiValue, const GLuint uiNewValue);
+
+	// Set if a tracked capability is enabled
+	void SetCapability(const GLenum eCapability, const bool bEnabled);
+};
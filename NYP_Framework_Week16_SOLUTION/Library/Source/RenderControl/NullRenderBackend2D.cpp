@@ -0,0 +1,127 @@
+/**
+ CNullRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "NullRenderBackend2D.h"
+
+// The offset basis of the 64-bit FNV-1a hash
+static const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ull;
+// The prime of the 64-bit FNV-1a hash
+static const unsigned long long FNV_PRIME = 1099511628211ull;
+
+/**
+ @brief Constructor
+ */
+CNullRenderBackend2D::CNullRenderBackend2D(void)
+	: uiNumItemsDrawn(0)
+	, uiNumDrawCalls(0)
+	, uiNumTexturesDeleted(0)
+	, ullChecksum(FNV_OFFSET_BASIS)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CNullRenderBackend2D::~CNullRenderBackend2D(void)
+{
+}
+
+/**
+ @brief Init Initialise this instance. There is nothing to create without OpenGL
+ */
+bool CNullRenderBackend2D::Init(void)
+{
+	return true;
+}
+
+/**
+ @brief Count the runs of a prepared list, and add them to the checksum. The shaders are left out of the checksum,
+		as they are addresses which change between runs of the program.
+ @param cList A const CRenderCommandList2D& variable containing the prepared list
+ */
+void CNullRenderBackend2D::Execute(const CRenderCommandList2D& cList)
+{
+	const std::vector<CRenderCommandList2D::Run>& vRuns = cList.GetRuns();
+	const std::vector<Vertex>& vVertices = cList.GetVertices();
+	for (unsigned int i = 0; i < vRuns.size(); i++)
+	{
+		const CRenderCommandList2D::Run& sRun = vRuns[i];
+		AddToChecksum(&sRun.uiTextureID, sizeof(sRun.uiTextureID));
+		AddToChecksum(&sRun.uiNumItems, sizeof(sRun.uiNumItems));
+		AddToChecksum(&vVertices[sRun.uiFirstVertex], sRun.uiNumItems * 4 * sizeof(Vertex));
+
+		uiNumItemsDrawn += sRun.uiNumItems;
+		uiNumDrawCalls++;
+	}
+}
+
+/**
+ @brief Count the textures, without deleting them
+ @param iNumTextures A const GLsizei variable containing the number of textures
+ @param pTextures A const GLuint* variable containing the textures, which are not needed to count them
+ */
+void CNullRenderBackend2D::DeleteTextures(const GLsizei iNumTextures, const GLuint*)
+{
+	if (iNumTextures > 0)
+		uiNumTexturesDeleted += (unsigned int)iNumTextures;
+}
+
+/**
+ @brief Get the number of draw items which would have been drawn since ResetCounts
+ */
+unsigned int CNullRenderBackend2D::GetNumItemsDrawn(void) const
+{
+	return uiNumItemsDrawn;
+}
+
+/**
+ @brief Get the number of draw calls which would have been made since ResetCounts
+ */
+unsigned int CNullRenderBackend2D::GetNumDrawCalls(void) const
+{
+	return uiNumDrawCalls;
+}
+
+/**
+ @brief Reset the numbers of draw items, draw calls and deleted textures, and the checksum
+ */
+void CNullRenderBackend2D::ResetCounts(void)
+{
+	uiNumItemsDrawn = 0;
+	uiNumDrawCalls = 0;
+	uiNumTexturesDeleted = 0;
+	ullChecksum = FNV_OFFSET_BASIS;
+}
+
+/**
+ @brief Get the number of textures which would have been deleted since ResetCounts
+ */
+unsigned int CNullRenderBackend2D::GetNumTexturesDeleted(void) const
+{
+	return uiNumTexturesDeleted;
+}
+
+/**
+ @brief Get the checksum of the runs and vertices since ResetCounts
+ */
+unsigned long long CNullRenderBackend2D::GetChecksum(void) const
+{
+	return ullChecksum;
+}
+
+/**
+ @brief Add a number of bytes to the checksum
+ @param pData A const void* variable containing the bytes
+ @param uiNumBytes A const size_t variable containing the number of bytes
+ */
+void CNullRenderBackend2D::AddToChecksum(const void* pData, const size_t uiNumBytes)
+{
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	for (size_t i = 0; i < uiNumBytes; i++)
+	{
+		ullChecksum ^= pBytes[i];
+		ullChecksum *= FNV_PRIME;
+	}
+}
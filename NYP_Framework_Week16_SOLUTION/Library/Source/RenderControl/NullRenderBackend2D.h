@@ -0,0 +1,57 @@
+/**
+ CNullRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include RenderBackend2D
+#include "RenderBackend2D.h"
+
+/**
+ CNullRenderBackend2D: A backend which does not call OpenGL. It counts the draw items and the draw calls which
+					   the OpenGL backend would have made, and keeps a checksum of the runs and vertices which it
+					   was given, so that the same frames can be compared between runs without a window.
+ */
+class CNullRenderBackend2D : public CRenderBackend2D
+{
+public:
+	// Constructor
+	CNullRenderBackend2D(void);
+
+	// Destructor
+	virtual ~CNullRenderBackend2D(void);
+
+	// Init
+	virtual bool Init(void);
+
+	// Count the runs of a prepared list, and add them to the checksum
+	virtual void Execute(const CRenderCommandList2D& cList);
+
+	// Count the textures, without deleting them
+	virtual void DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures);
+
+	// Get the number of draw items and draw calls since ResetCounts
+	virtual unsigned int GetNumItemsDrawn(void) const;
+	virtual unsigned int GetNumDrawCalls(void) const;
+	// Reset the numbers of draw items and draw calls, and the checksum
+	virtual void ResetCounts(void);
+
+	// Get the number of textures which would have been deleted since ResetCounts
+	unsigned int GetNumTexturesDeleted(void) const;
+
+	// Get the checksum of the runs and vertices since ResetCounts
+	unsigned long long GetChecksum(void) const;
+
+protected:
+	// The numbers of draw items, draw calls and deleted textures since ResetCounts
+	unsigned int uiNumItemsDrawn;
+	unsigned int uiNumDrawCalls;
+	unsigned int uiNumTexturesDeleted;
+
+	// The FNV-1a checksum of the runs and vertices since ResetCounts
+	unsigned long long ullChecksum;
+
+	// Add a number of bytes to the checksum
+	void AddToChecksum(const void* pData, const size_t uiNumBytes);
+};
@@ -0,0 +1,36 @@
+/**
+ CRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include RenderCommandList2D
+#include "RenderCommandList2D.h"
+
+/**
+ CRenderBackend2D: The interface of what draws a prepared render command list and deletes the resources of the draw items.
+				   CGLRenderBackend2D draws with OpenGL, and CNullRenderBackend2D only counts and checksums
+				   the draw calls, so that the lists can be run without an OpenGL context.
+ */
+class CRenderBackend2D
+{
+public:
+	// Destructor
+	virtual ~CRenderBackend2D(void) {}
+
+	// Init
+	virtual bool Init(void) = 0;
+
+	// Draw the runs of a prepared list
+	virtual void Execute(const CRenderCommandList2D& cList) = 0;
+
+	// Delete a number of textures
+	virtual void DeleteTextures(const GLsizei iNumTextures, const GLuint* pTextures) = 0;
+
+	// Get the number of draw items and draw calls since ResetCounts
+	virtual unsigned int GetNumItemsDrawn(void) const = 0;
+	virtual unsigned int GetNumDrawCalls(void) const = 0;
+	// Reset the numbers of draw items and draw calls
+	virtual void ResetCounts(void) = 0;
+};
@@ -0,0 +1,184 @@
+/**
+ CRenderCommandList2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "RenderCommandList2D.h"
+
+#include <algorithm>
+using namespace std;
+
+// The constants which are used by reference
+const unsigned int CRenderCommandList2D::MAX_ITEMS_PER_RUN;
+
+/**
+ @brief Constructor
+ */
+CRenderCommandList2D::CRenderCommandList2D(void)
+	: bPrepared(false)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CRenderCommandList2D::~CRenderCommandList2D(void)
+{
+}
+
+/**
+ @brief Remove the draw items, runs and vertices, to record a new list.
+		The vectors keep their memory, so a list which is reused every frame does not allocate.
+ */
+void CRenderCommandList2D::Clear(void)
+{
+	vDrawItems.clear();
+	vOrder.clear();
+	vShaders.clear();
+	vRuns.clear();
+	vVertices.clear();
+	bPrepared = false;
+}
+
+/**
+ @brief Add a draw item
+ @param cShader A CShader* variable containing the shader which the draw item is drawn with
+ @param uiTextureID A const GLuint variable containing the texture of the draw item
+ @param vec2Centre A const glm::vec2& variable containing the centre of the draw item in UV space
+ @param vec2Size A const glm::vec2& variable containing the width and height of the draw item in UV space
+ @param vec4UVRect A const glm::vec4& variable containing the left, bottom, right and top of the texture coordinates
+ @param vec4Tint A const glm::vec4& variable containing the colour which the texture is multiplied by
+ @param iLayer A const int variable containing the layer, from -32768 to 32767, where a higher layer is drawn over a lower one
+ */
+void CRenderCommandList2D::AddDrawItem(	CShader* cShader,
+										const GLuint uiTextureID,
+										const glm::vec2& vec2Centre,
+										const glm::vec2& vec2Size,
+										const glm::vec4& vec4UVRect,
+										const glm::vec4& vec4Tint,
+										const int iLayer)
+{
+	if (cShader == NULL)
+		return;
+
+	int iClampedLayer = iLayer;
+	if (iClampedLayer < -32768)
+		iClampedLayer = -32768;
+	else if (iClampedLayer > 32767)
+		iClampedLayer = 32767;
+	const unsigned long long ullLayer = (unsigned long long)(iClampedLayer + 32768);
+
+	DrawItem sDrawItem;
+	sDrawItem.ullMaterialKey = (ullLayer << 48) | ((unsigned long long)GetShaderIndex(cShader) << 32) | uiTextureID;
+	sDrawItem.cShader = cShader;
+	sDrawItem.uiTextureID = uiTextureID;
+	sDrawItem.vec2Centre = vec2Centre;
+	sDrawItem.vec2Size = vec2Size;
+	sDrawItem.vec4UVRect = vec4UVRect;
+	sDrawItem.vec4Tint = vec4Tint;
+	vDrawItems.push_back(sDrawItem);
+	bPrepared = false;
+}
+
+/**
+ @brief Sort the draw items by their material key, keeping the order which they were added in for the same key,
+		and build the runs and the 4 vertices of each draw item. This does not call OpenGL.
+ */
+void CRenderCommandList2D::Prepare(void)
+{
+	vRuns.clear();
+	vVertices.clear();
+
+	vOrder.resize(vDrawItems.size());
+	for (unsigned int i = 0; i < vOrder.size(); i++)
+		vOrder[i] = i;
+	sort(vOrder.begin(), vOrder.end(), [this](const unsigned int uiLHS, const unsigned int uiRHS)
+	{
+		const unsigned long long ullLHS = vDrawItems[uiLHS].ullMaterialKey;
+		const unsigned long long ullRHS = vDrawItems[uiRHS].ullMaterialKey;
+		return (ullLHS < ullRHS) || ((ullLHS == ullRHS) && (uiLHS < uiRHS));
+	});
+
+	vVertices.resize(vOrder.size() * 4);
+	for (unsigned int i = 0; i < vOrder.size(); i++)
+	{
+		const DrawItem& sDrawItem = vDrawItems[vOrder[i]];
+
+		// Start a new run when the shader or the texture changes, or the run is full
+		if ((vRuns.size() == 0) ||
+			(vRuns.back().cShader != sDrawItem.cShader) ||
+			(vRuns.back().uiTextureID != sDrawItem.uiTextureID) ||
+			(vRuns.back().uiNumItems == MAX_ITEMS_PER_RUN))
+		{
+			Run sRun;
+			sRun.cShader = sDrawItem.cShader;
+			sRun.uiTextureID = sDrawItem.uiTextureID;
+			sRun.uiFirstVertex = i * 4;
+			sRun.uiNumItems = 0;
+			vRuns.push_back(sRun);
+		}
+		vRuns.back().uiNumItems++;
+
+		const glm::vec2 vec2HalfSize = sDrawItem.vec2Size * 0.5f;
+		Vertex* pVertex = &vVertices[i * 4];
+		pVertex[0].position = glm::vec3(sDrawItem.vec2Centre.x - vec2HalfSize.x, sDrawItem.vec2Centre.y - vec2HalfSize.y, 0.0f);
+		pVertex[0].texCoord = glm::vec2(sDrawItem.vec4UVRect.x, sDrawItem.vec4UVRect.y);
+		pVertex[1].position = glm::vec3(sDrawItem.vec2Centre.x + vec2HalfSize.x, sDrawItem.vec2Centre.y - vec2HalfSize.y, 0.0f);
+		pVertex[1].texCoord = glm::vec2(sDrawItem.vec4UVRect.z, sDrawItem.vec4UVRect.y);
+		pVertex[2].position = glm::vec3(sDrawItem.vec2Centre.x + vec2HalfSize.x, sDrawItem.vec2Centre.y + vec2HalfSize.y, 0.0f);
+		pVertex[2].texCoord = glm::vec2(sDrawItem.vec4UVRect.z, sDrawItem.vec4UVRect.w);
+		pVertex[3].position = glm::vec3(sDrawItem.vec2Centre.x - vec2HalfSize.x, sDrawItem.vec2Centre.y + vec2HalfSize.y, 0.0f);
+		pVertex[3].texCoord = glm::vec2(sDrawItem.vec4UVRect.x, sDrawItem.vec4UVRect.w);
+		for (unsigned int j = 0; j < 4; j++)
+			pVertex[j].color = sDrawItem.vec4Tint;
+	}
+
+	bPrepared = true;
+}
+
+/**
+ @brief Get if the list was prepared since it was last cleared
+ */
+bool CRenderCommandList2D::IsPrepared(void) const
+{
+	return bPrepared;
+}
+
+/**
+ @brief Get the number of draw items which were recorded
+ */
+unsigned int CRenderCommandList2D::GetNumDrawItems(void) const
+{
+	return (unsigned int)vDrawItems.size();
+}
+
+/**
+ @brief Get the prepared runs
+ */
+const std::vector<CRenderCommandList2D::Run>& CRenderCommandList2D::GetRuns(void) const
+{
+	return vRuns;
+}
+
+/**
+ @brief Get the prepared vertices, which are 4 for each draw item, in the order of the runs
+ */
+const std::vector<Vertex>& CRenderCommandList2D::GetVertices(void) const
+{
+	return vVertices;
+}
+
+/**
+ @brief Get the position of a shader in vShaders, adding it if it is new. There are only a few shaders in a list
+ @param cShader A CShader* variable containing the shader
+ */
+unsigned int CRenderCommandList2D::GetShaderIndex(CShader* cShader)
+{
+	for (unsigned int i = 0; i < vShaders.size(); i++)
+	{
+		if (vShaders[i] == cShader)
+			return i;
+	}
+	vShaders.push_back(cShader);
+	return (unsigned int)(vShaders.size() - 1);
+}
@@ -0,0 +1,114 @@
+/**
+ CRenderCommandList2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include Mesh for the Vertex
+#include "..\Primitives\Mesh.h"
+
+// Include vector
+#include <vector>
+
+class CShader;
+
+/**
+ CRenderCommandList2D: The draw items of a 2D scene which are recorded during a frame.
+
+					   A draw item is a textured quad, with its transform as a centre and a size in UV space,
+					   a rectangle of its texture, a tint, and a material key which is its layer, shader and texture.
+					   Recording does not call OpenGL, and Prepare only sorts the draw items and builds their
+					   vertices, so a list can be recorded on one thread and prepared on another.
+					   A backend then draws the prepared runs, where a run is the draw items which share a shader
+					   and a texture, up to MAX_ITEMS_PER_RUN of them.
+
+					   A list is only used by one thread at a time, and is handed over through the render thread,
+					   so it has no locks of its own.
+ */
+class CRenderCommandList2D
+{
+public:
+	// The largest number of draw items in a run, which is the number of quads drawn by one draw call
+	static const unsigned int MAX_ITEMS_PER_RUN = 4096;
+
+	// A draw item
+	struct DrawItem
+	{
+		// The material key, which is the layer in the top 16 bits, the shader in the next 16 bits, and the texture
+		unsigned long long ullMaterialKey;
+		CShader* cShader;
+		GLuint uiTextureID;
+		glm::vec2 vec2Centre;
+		glm::vec2 vec2Size;
+		glm::vec4 vec4UVRect;
+		glm::vec4 vec4Tint;
+	};
+
+	// A run of prepared draw items which share a shader and a texture
+	struct Run
+	{
+		CShader* cShader;
+		GLuint uiTextureID;
+		// The first vertex of the run in the prepared vertices, and the number of quads in it
+		unsigned int uiFirstVertex;
+		unsigned int uiNumItems;
+	};
+
+	// Constructor
+	CRenderCommandList2D(void);
+
+	// Destructor
+	virtual ~CRenderCommandList2D(void);
+
+	// Remove the draw items, runs and vertices, to record a new list
+	void Clear(void);
+
+	// Add a draw item. The UV rectangle is the left, bottom, right and top of the texture coordinates
+	void AddDrawItem(	CShader* cShader,
+						const GLuint uiTextureID,
+						const glm::vec2& vec2Centre,
+						const glm::vec2& vec2Size,
+						const glm::vec4& vec4UVRect,
+						const glm::vec4& vec4Tint,
+						const int iLayer);
+
+	// Sort the draw items by their material key, and build the runs and their vertices
+	void Prepare(void);
+
+	// Get if the list was prepared since it was last cleared
+	bool IsPrepared(void) const;
+
+	// Get the number of draw items which were recorded
+	unsigned int GetNumDrawItems(void) const;
+
+	// Get the prepared runs and vertices
+	const std::vector<Run>& GetRuns(void) const;
+	const std::vector<Vertex>& GetVertices(void) const;
+
+protected:
+	// The draw items which were recorded since Clear
+	std::vector<DrawItem> vDrawItems;
+	// The positions of the draw items in vDrawItems, sorted by their material keys
+	std::vector<unsigned int> vOrder;
+	// The shaders of the draw items, where the position of a shader is its part of the material keys
+	std::vector<CShader*> vShaders;
+
+	// The prepared runs and their vertices
+	std::vector<Run> vRuns;
+	std::vector<Vertex> vVertices;
+	// Boolean flag to indicate if the list was prepared
+	bool bPrepared;
+
+	// Get the position of a shader in vShaders, adding it if it is new
+	unsigned int GetShaderIndex(CShader* cShader);
+};
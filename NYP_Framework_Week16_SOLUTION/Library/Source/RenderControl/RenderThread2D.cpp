@@ -0,0 +1,206 @@
+/**
+ CRenderThread2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "RenderThread2D.h"
+
+// Include RenderCommandList2D
+#include "RenderCommandList2D.h"
+
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CRenderThread2D::CRenderThread2D(void)
+	: cCurrentList(NULL)
+	, bThreaded(false)
+	, bStop(false)
+	, uiNumListsPrepared(0)
+	, dWaitTime(0.0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CRenderThread2D::~CRenderThread2D(void)
+{
+	Exit();
+}
+
+/**
+ @brief Initialise this instance
+ @param bThreaded A const bool variable which is false to prepare the lists on the thread which submits them
+ */
+bool CRenderThread2D::Init(const bool bThreaded)
+{
+	// Stop the current thread, if any
+	Exit();
+
+	if (bThreaded == false)
+	{
+		cout << "CRenderThread2D: Preparing the render command lists on the calling thread" << endl;
+		return true;
+	}
+
+	bStop = false;
+	this->bThreaded = true;
+	cThread = std::thread(&CRenderThread2D::ThreadLoop, this);
+
+	cout << "CRenderThread2D: Preparing the render command lists on a dedicated thread" << endl;
+
+	return true;
+}
+
+/**
+ @brief Stop and join the thread, after it prepared the lists which were submitted
+ */
+void CRenderThread2D::Exit(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		bStop = true;
+	}
+	cvSubmitted.notify_all();
+
+	if (cThread.joinable())
+		cThread.join();
+	bThreaded = false;
+}
+
+/**
+ @brief Get if the lists are prepared on the dedicated thread
+ */
+bool CRenderThread2D::IsThreaded(void) const
+{
+	return bThreaded;
+}
+
+/**
+ @brief Hand a list to the thread to be prepared. The list must not be changed until Wait returns for it
+ @param cList A CRenderCommandList2D* variable containing the list
+ */
+void CRenderThread2D::Submit(CRenderCommandList2D* cList)
+{
+	if (cList == NULL)
+		return;
+
+	if (bThreaded == false)
+	{
+		cList->Prepare();
+		uiNumListsPrepared++;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		dQueue.push_back(cList);
+	}
+	cvSubmitted.notify_one();
+}
+
+/**
+ @brief Wait until a submitted list is prepared. The lock makes the prepared list visible to the calling thread
+ @param cList A CRenderCommandList2D* variable containing the list
+ */
+void CRenderThread2D::Wait(CRenderCommandList2D* cList)
+{
+	if (bThreaded == false)
+		return;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (IsPending(cList) == false)
+		return;
+
+	const chrono::steady_clock::time_point sStart = chrono::steady_clock::now();
+	cvPrepared.wait(lock, [this, cList] { return IsPending(cList) == false; });
+	dWaitTime += chrono::duration<double>(chrono::steady_clock::now() - sStart).count();
+}
+
+/**
+ @brief Get the number of lists which were prepared since ResetCounts
+ */
+unsigned int CRenderThread2D::GetNumListsPrepared(void) const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return uiNumListsPrepared;
+}
+
+/**
+ @brief Get the time in seconds which the callers of Wait waited since ResetCounts
+ */
+double CRenderThread2D::GetWaitTime(void) const
+{
+	return dWaitTime;
+}
+
+/**
+ @brief Reset the number of lists and the wait time
+ */
+void CRenderThread2D::ResetCounts(void)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	uiNumListsPrepared = 0;
+	dWaitTime = 0.0;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CRenderThread2D::PrintSelf(void) const
+{
+	cout << "CRenderThread2D::PrintSelf()" << endl;
+	cout << "Threaded: " << (bThreaded ? "true" : "false") << endl;
+	cout << "Lists prepared: " << GetNumListsPrepared() << endl;
+	cout << "Wait time: " << dWaitTime * 1000.0 << " ms" << endl;
+}
+
+/**
+ @brief The loop run by the thread. It only stops when there are no lists left to prepare
+ */
+void CRenderThread2D::ThreadLoop(void)
+{
+	while (true)
+	{
+		CRenderCommandList2D* cList = NULL;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			cvSubmitted.wait(lock, [this] { return bStop || (dQueue.size() > 0); });
+			if (dQueue.size() == 0)
+				return;
+			cList = dQueue.front();
+			dQueue.pop_front();
+			cCurrentList = cList;
+		}
+
+		// The list belongs to this thread until it is prepared, so it is not locked
+		cList->Prepare();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			cCurrentList = NULL;
+			uiNumListsPrepared++;
+		}
+		cvPrepared.notify_all();
+	}
+}
+
+/**
+ @brief Get if a list was submitted and is not prepared yet. The mutex must be locked by the caller
+ @param cList A const CRenderCommandList2D* variable containing the list
+ */
+bool CRenderThread2D::IsPending(const CRenderCommandList2D* cList) const
+{
+	if (cCurrentList == cList)
+		return true;
+	for (unsigned int i = 0; i < dQueue.size(); i++)
+	{
+		if (dQueue[i] == cList)
+			return true;
+	}
+	return false;
+}
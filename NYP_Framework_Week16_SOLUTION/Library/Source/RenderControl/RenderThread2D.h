@@ -0,0 +1,91 @@
+/**
+ CRenderThread2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include the threading headers
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+class CRenderCommandList2D;
+
+/**
+ CRenderThread2D: A dedicated thread which prepares the render command lists, by sorting their draw items and
+				  building their vertices, while the main thread carries on. A scene which submits the lists
+				  of a frame at the end of it, and executes them in the next frame, has them prepared while
+				  the next frame is simulated. The lists are prepared in the order which they were submitted.
+
+				  The OpenGL context stays on the main thread, which draws a list after Wait returns, and copies
+				  its vertices into the stream buffer then, as allocating from it may wait for a fence.
+				  A list must not be changed between Submit and Wait, so the owner of the lists double buffers
+				  them, recording into one list while the other one is being prepared.
+				  If the thread is not started, Submit prepares the list on the calling thread.
+ */
+class CRenderThread2D : public CSingletonTemplate<CRenderThread2D>
+{
+	friend CSingletonTemplate<CRenderThread2D>;
+public:
+	// Init. If bThreaded is false, the lists are prepared on the thread which submits them
+	bool Init(const bool bThreaded = true);
+
+	// Stop and join the thread, after it prepared the lists which were submitted
+	void Exit(void);
+
+	// Get if the lists are prepared on the dedicated thread
+	bool IsThreaded(void) const;
+
+	// Hand a list to the thread to be prepared
+	void Submit(CRenderCommandList2D* cList);
+
+	// Wait until a submitted list is prepared
+	void Wait(CRenderCommandList2D* cList);
+
+	// Get the number of lists which were prepared, and the time which the callers waited for them, since ResetCounts
+	unsigned int GetNumListsPrepared(void) const;
+	double GetWaitTime(void) const;
+	// Reset the number of lists and the wait time
+	void ResetCounts(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The thread
+	std::thread cThread;
+
+	// Synchronisation for handing the lists over
+	mutable std::mutex mMutex;
+	std::condition_variable cvSubmitted;
+	std::condition_variable cvPrepared;
+
+	// The lists which were submitted and are not prepared yet, and the list which the thread is preparing
+	std::deque<CRenderCommandList2D*> dQueue;
+	CRenderCommandList2D* cCurrentList;
+	// Boolean flag to indicate if the thread is running
+	bool bThreaded;
+	// Boolean flag to tell the thread to stop
+	bool bStop;
+
+	// The number of lists which were prepared, and the time in seconds which the callers waited, since ResetCounts
+	unsigned int uiNumListsPrepared;
+	double dWaitTime;
+
+	// Constructor
+	CRenderThread2D(void);
+
+	// Destructor
+	virtual ~CRenderThread2D(void);
+
+	// The loop run by the thread
+	void ThreadLoop(void);
+
+	// Get if a list was submitted and is not prepared yet
+	bool IsPending(const CRenderCommandList2D* cList) const;
+};
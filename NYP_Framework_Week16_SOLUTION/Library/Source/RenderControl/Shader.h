@@ -11,11 +11,38 @@
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
+// Include GLStateCache, which skips the glUseProgram of the program in use
+#include "GLStateCache.h"
+
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstring>
+
+// The ID of a uniform, which is the FNV-1a hash of its name. It can be calculated at compile time
+typedef unsigned int UNIFORM_ID;
+constexpr UNIFORM_ID ShaderUniformID(const char* name, const UNIFORM_ID hash = 2166136261u)
+{
+    return (*name == '\0') ? hash : ShaderUniformID(name + 1, (hash ^ (UNIFORM_ID)(unsigned char)*name) * 16777619u);
+}
 
+// The IDs of the uniforms which are set for each entity and tile
+constexpr UNIFORM_ID UNIFORM_TRANSFORM = ShaderUniformID("transform");
+constexpr UNIFORM_ID UNIFORM_RUNTIME_COLOR = ShaderUniformID("runtime_color");
+constexpr UNIFORM_ID UNIFORM_TEXT_COLOUR = ShaderUniformID("textColour");
+
+/**
+ CShader: A shader program. The locations of its uniforms are found once, after it is linked, and kept in a table
+          which is sorted by the IDs of the uniforms. A uniform can be set by its name or by its ID, and the last value
+          which was uploaded to each uniform is kept, so that setting the same value again does not call OpenGL.
+          The program must be in use when a uniform is set, as with glUniform.
+          If the names of 2 uniforms have the same ID, the first one keeps the ID, and the other one is kept apart
+          by its name, so it can only be set by its name.
+ */
 class CShader
 {
 public:
@@ -102,73 +129,266 @@ public:
         if(geometryPath != nullptr)
             glDeleteShader(geometry);
 
+        // 3. find the locations of the uniforms
+        reflectUniforms();
+        numUploads = 0;
+        numSkippedUploads = 0;
     }
     // activate the shader
     // ------------------------------------------------------------------------
     void use() 
     { 
-        glUseProgram(ID); 
+        CGLStateCache::GetInstance()->UseProgram(ID);
     }
     // utility uniform functions
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        setInt(name, (int)value);
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        uploadInt(findUniform(name), value);
+    }
+    void setInt(UNIFORM_ID id, int value) const
+    { 
+        uploadInt(findUniform(id), value);
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        uploadFloat(findUniform(name), value);
+    }
+    void setFloat(UNIFORM_ID id, float value) const
+    { 
+        uploadFloat(findUniform(id), value);
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string &name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        uploadVec2(findUniform(name), value);
+    }
+    void setVec2(UNIFORM_ID id, const glm::vec2 &value) const
+    { 
+        uploadVec2(findUniform(id), value);
     }
     void setVec2(const std::string &name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        uploadVec2(findUniform(name), glm::vec2(x, y));
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string &name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        uploadVec3(findUniform(name), value);
+    }
+    void setVec3(UNIFORM_ID id, const glm::vec3 &value) const
+    { 
+        uploadVec3(findUniform(id), value);
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        uploadVec3(findUniform(name), glm::vec3(x, y, z));
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string &name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        uploadVec4(findUniform(name), value);
+    }
+    void setVec4(UNIFORM_ID id, const glm::vec4 &value) const
+    { 
+        uploadVec4(findUniform(id), value);
     }
     void setVec4(const std::string &name, float x, float y, float z, float w) 
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        uploadVec4(findUniform(name), glm::vec4(x, y, z, w));
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        Uniform* uniform = prepareUpload(findUniform(name), &mat[0][0], sizeof(mat));
+        if (uniform)
+            glUniformMatrix2fv(uniform->location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        Uniform* uniform = prepareUpload(findUniform(name), &mat[0][0], sizeof(mat));
+        if (uniform)
+            glUniformMatrix3fv(uniform->location, 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        uploadMat4(findUniform(name), mat);
+    }
+    void setMat4(UNIFORM_ID id, const glm::mat4 &mat) const
+    {
+        uploadMat4(findUniform(id), mat);
+    }
+    // ------------------------------------------------------------------------
+    // check if the program has a uniform
+    bool hasUniform(UNIFORM_ID id) const
+    {
+        const Uniform* uniform = findUniform(id);
+        return (uniform != nullptr) && (uniform->location >= 0);
+    }
+    // get the number of uniform values which were uploaded, and which were skipped because they did not change
+    unsigned int getNumUploads(void) const
+    {
+        return numUploads;
+    }
+    unsigned int getNumSkippedUploads(void) const
+    {
+        return numSkippedUploads;
+    }
+    void resetUploadCounts(void)
+    {
+        numUploads = 0;
+        numSkippedUploads = 0;
     }
 
 private:
+    // a uniform in the table, with the last value which was uploaded to it
+    struct Uniform
+    {
+        UNIFORM_ID id;
+        std::string name;
+        GLint location;
+        // the size of the last value in bytes, or 0 if no value was uploaded yet
+        unsigned int valueSize;
+        float value[16];
+    };
+
+    // the uniforms, sorted by their IDs. A value is kept when it is uploaded, so the table changes in the const setters
+    mutable std::vector<Uniform> uniforms;
+    // the uniforms whose IDs collide with the ID of a uniform in the table, by their names
+    mutable std::map<std::string, Uniform> collidingUniforms;
+    // the number of uniform values which were uploaded, and which were skipped because they did not change
+    mutable unsigned int numUploads;
+    mutable unsigned int numSkippedUploads;
+
+    // find the locations of the active uniforms of the linked program
+    // ------------------------------------------------------------------------
+    void reflectUniforms(void)
+    {
+        uniforms.clear();
+        collidingUniforms.clear();
+        GLint numUniforms = 0;
+        GLint maxNameLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &numUniforms);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+        std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+        for (GLint i = 0; i < numUniforms; i++)
+        {
+            GLsizei nameLength = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &nameLength, &size, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), nameLength);
+            // an array is listed by its first element, such as "lights[0]", and is set by the name of the array
+            if ((name.size() > 3) && (name.compare(name.size() - 3, 3, "[0]") == 0))
+                name.erase(name.size() - 3);
+            addUniform(ShaderUniformID(name.c_str()), glGetUniformLocation(ID, name.c_str()), name);
+        }
+    }
+    // add a uniform to the table, keeping it sorted by the IDs. A uniform whose ID is already in the table
+    // is kept apart by its name, with its own location and value
+    // ------------------------------------------------------------------------
+    Uniform* addUniform(UNIFORM_ID id, GLint location, const std::string &name) const
+    {
+        Uniform uniform;
+        uniform.id = id;
+        uniform.name = name;
+        uniform.location = location;
+        uniform.valueSize = 0;
+
+        std::vector<Uniform>::iterator it = std::lower_bound(uniforms.begin(), uniforms.end(), id,
+            [](const Uniform &uniform, UNIFORM_ID id) { return uniform.id < id; });
+        if ((it != uniforms.end()) && (it->id == id))
+        {
+            std::cout << "ERROR::SHADER::UNIFORM_ID_COLLISION: " << name << " has the same ID as " << it->name
+                << ", so it can only be set by its name" << std::endl;
+            return &(collidingUniforms[name] = uniform);
+        }
+        return &(*uniforms.insert(it, uniform));
+    }
+    // find a uniform by its ID, or return nullptr if the program does not have it
+    // ------------------------------------------------------------------------
+    Uniform* findUniform(UNIFORM_ID id) const
+    {
+        std::vector<Uniform>::iterator it = std::lower_bound(uniforms.begin(), uniforms.end(), id,
+            [](const Uniform &uniform, UNIFORM_ID id) { return uniform.id < id; });
+        if ((it != uniforms.end()) && (it->id == id))
+            return &(*it);
+        return nullptr;
+    }
+    // find a uniform by its name. A name which was not reflected, such as an element of an array, is looked up once
+    // and added to the table, with a location of -1 if the program does not have it
+    // ------------------------------------------------------------------------
+    Uniform* findUniform(const std::string &name) const
+    {
+        const UNIFORM_ID id = ShaderUniformID(name.c_str());
+        Uniform* uniform = findUniform(id);
+        if ((uniform != nullptr) && (uniform->name != name))
+        {
+            // another uniform has the same ID
+            std::map<std::string, Uniform>::iterator it = collidingUniforms.find(name);
+            uniform = (it != collidingUniforms.end()) ? &it->second : nullptr;
+        }
+        if (uniform == nullptr)
+            uniform = addUniform(id, glGetUniformLocation(ID, name.c_str()), name);
+        return uniform;
+    }
+    // check if a value has to be uploaded to a uniform, and keep the value if it does
+    // ------------------------------------------------------------------------
+    Uniform* prepareUpload(Uniform* uniform, const void* value, unsigned int valueSize) const
+    {
+        if ((uniform == nullptr) || (uniform->location < 0))
+            return nullptr;
+        if ((uniform->valueSize == valueSize) && (memcmp(uniform->value, value, valueSize) == 0))
+        {
+            numSkippedUploads++;
+            return nullptr;
+        }
+        memcpy(uniform->value, value, valueSize);
+        uniform->valueSize = valueSize;
+        numUploads++;
+        return uniform;
+    }
+    // upload a value to a uniform from the table, if it changed
+    // ------------------------------------------------------------------------
+    void uploadInt(Uniform* uniform, int value) const
+    {
+        if (prepareUpload(uniform, &value, sizeof(value)))
+            glUniform1i(uniform->location, value);
+    }
+    void uploadFloat(Uniform* uniform, float value) const
+    {
+        if (prepareUpload(uniform, &value, sizeof(value)))
+            glUniform1f(uniform->location, value);
+    }
+    void uploadVec2(Uniform* uniform, const glm::vec2 &value) const
+    {
+        if (prepareUpload(uniform, &value[0], sizeof(value)))
+            glUniform2fv(uniform->location, 1, &value[0]);
+    }
+    void uploadVec3(Uniform* uniform, const glm::vec3 &value) const
+    {
+        if (prepareUpload(uniform, &value[0], sizeof(value)))
+            glUniform3fv(uniform->location, 1, &value[0]);
+    }
+    void uploadVec4(Uniform* uniform, const glm::vec4 &value) const
+    {
+        if (prepareUpload(uniform, &value[0], sizeof(value)))
+            glUniform4fv(uniform->location, 1, &value[0]);
+    }
+    void uploadMat4(Uniform* uniform, const glm::mat4 &mat) const
+    {
+        if (prepareUpload(uniform, &mat[0][0], sizeof(mat)))
+            glUniformMatrix4fv(uniform->location, 1, GL_FALSE, &mat[0][0]);
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
@@ -140,17 +140,31 @@ void CShaderManager::Remove(const std::string& _name)
 */
 void CShaderManager::Use(const std::string& _name)
 {
-	if (!Check(_name))
+	// Find the Shader once, instead of checking for it and then looking it up again
+	std::map<std::string, CShader*>::iterator it = shaderMap.find(_name);
+	if (it == shaderMap.end())
 	{
 		// Scene does not exist
 		throw std::exception("Shader does not exist");
 	}
 
 	// if Shader exist, set the activeShader pointer to that Shader
-	activeShader = shaderMap[_name];
+	activeShader = it->second;
 	activeShader->use();
 }
 
+/**
+@brief Get a Shader without using it
+@return The Shader, or nullptr if it does not exist
+*/
+CShader* CShaderManager::Get(const std::string& _name)
+{
+	std::map<std::string, CShader*>::iterator it = shaderMap.find(_name);
+	if (it == shaderMap.end())
+		return nullptr;
+	return it->second;
+}
+
 /**
 @brief Check if a Scene exists in this Shader Manager
 */
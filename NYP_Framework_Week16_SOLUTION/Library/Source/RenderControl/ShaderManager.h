@@ -30,6 +30,8 @@ public:
 	void Remove(const std::string& _name);
 	void Use(const std::string& _name);
 	bool Check(const std::string& _name);
+	// Get a Shader without using it, or nullptr if it does not exist
+	CShader* Get(const std::string& _name);
 
 	// The current active shader
 	CShader* activeShader;
@@ -0,0 +1,249 @@
+/**
+ CSpriteBatch2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "SpriteBatch2D.h"
+
+// Include RenderThread2D
+#include "RenderThread2D.h"
+
+#include <iostream>
+using namespace std;
+
+// The constants which are used by reference
+const unsigned int CSpriteBatch2D::NUM_LISTS;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CSpriteBatch2D::CSpriteBatch2D(void)
+	: uiRecordingList(0)
+	, ullNextListNumber(0)
+	, cBackend(&cGLBackend)
+{
+	for (unsigned int i = 0; i < NUM_LISTS; i++)
+	{
+		arrSubmitted[i] = false;
+		arrListNumbers[i] = 0;
+	}
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CSpriteBatch2D::~CSpriteBatch2D(void)
+{
+	// Take the lists back from the render thread before they are destroyed
+	for (unsigned int i = 0; i < NUM_LISTS; i++)
+	{
+		if (arrSubmitted[i])
+			CRenderThread2D::GetInstance()->Wait(&arrLists[i]);
+		arrSubmitted[i] = false;
+		arrLists[i].Clear();
+	}
+	DeleteDeferredTextures();
+}
+
+/**
+ @brief Set the backend which draws the lists. This must be done before Init
+ @param cBackend A CRenderBackend2D* variable containing the backend, or NULL for the OpenGL backend
+ */
+void CSpriteBatch2D::SetBackend(CRenderBackend2D* cBackend)
+{
+	if (cBackend == NULL)
+		this->cBackend = &cGLBackend;
+	else
+		this->cBackend = cBackend;
+}
+
+/**
+ @brief Init Initialise this instance
+ */
+bool CSpriteBatch2D::Init(void)
+{
+	Begin();
+	return cBackend->Init();
+}
+
+/**
+ @brief Start recording the next list. If it was submitted and not executed, it is drawn first, so that no sprites are lost
+ */
+void CSpriteBatch2D::Begin(void)
+{
+	uiRecordingList = (uiRecordingList + 1) % NUM_LISTS;
+	if (arrSubmitted[uiRecordingList])
+	{
+		cout << "CSpriteBatch2D::Begin: List " << uiRecordingList << " was not executed" << endl;
+		Execute(uiRecordingList);
+	}
+	arrLists[uiRecordingList].Clear();
+	arrListNumbers[uiRecordingList] = ullNextListNumber++;
+	DeleteDeferredTextures();
+}
+
+/**
+ @brief Add a sprite to the list which is being recorded
+ @param cShader A CShader* variable containing the shader which the sprite is drawn with
+ @param uiTextureID A const GLuint variable containing the texture of the sprite
+ @param vec2Centre A const glm::vec2& variable containing the centre of the sprite in UV space
+ @param vec2Size A const glm::vec2& variable containing the width and height of the sprite in UV space
+ @param vec4UVRect A const glm::vec4& variable containing the left, bottom, right and top of the texture coordinates
+ @param vec4Tint A const glm::vec4& variable containing the colour which the texture is multiplied by
+ @param iLayer A const int variable containing the layer, from -32768 to 32767, where a higher layer is drawn over a lower one
+ */
+void CSpriteBatch2D::Draw(	CShader* cShader,
+							const GLuint uiTextureID,
+							const glm::vec2& vec2Centre,
+							const glm::vec2& vec2Size,
+							const glm::vec4& vec4UVRect,
+							const glm::vec4& vec4Tint,
+							const int iLayer)
+{
+	// A submitted list belongs to the render thread until it is executed
+	if (arrSubmitted[uiRecordingList])
+		return;
+
+	arrLists[uiRecordingList].AddDrawItem(cShader, uiTextureID, vec2Centre, vec2Size, vec4UVRect, vec4Tint, iLayer);
+}
+
+/**
+ @brief Hand the list which is being recorded to the render thread, which sorts the sprites and builds their vertices
+ @return The index of the list, for Execute
+ */
+unsigned int CSpriteBatch2D::Submit(void)
+{
+	if (arrSubmitted[uiRecordingList] == false)
+	{
+		arrSubmitted[uiRecordingList] = true;
+		CRenderThread2D::GetInstance()->Submit(&arrLists[uiRecordingList]);
+	}
+	return uiRecordingList;
+}
+
+/**
+ @brief Wait for a submitted list to be prepared, and draw each run of sprites which share a shader and
+		a texture with one draw call
+ @param uiList A const unsigned int variable containing the index of the list which was returned by Submit
+ */
+void CSpriteBatch2D::Execute(const unsigned int uiList)
+{
+	if ((uiList >= NUM_LISTS) || (arrSubmitted[uiList] == false))
+		return;
+
+	CRenderThread2D::GetInstance()->Wait(&arrLists[uiList]);
+	cBackend->Execute(arrLists[uiList]);
+
+	arrSubmitted[uiList] = false;
+	arrLists[uiList].Clear();
+	DeleteDeferredTextures();
+}
+
+/**
+ @brief Submit and execute the list which is being recorded
+ */
+void CSpriteBatch2D::End(void)
+{
+	Execute(Submit());
+}
+
+/**
+ @brief Delete a texture once no list which was recorded or submitted can still draw it.
+		This must be used instead of deleting a texture which the sprites may use.
+ @param uiTextureID A const GLuint variable containing the texture
+ */
+void CSpriteBatch2D::DeleteTextureLater(const GLuint uiTextureID)
+{
+	if (uiTextureID == 0)
+		return;
+
+	DeferredTexture sDeferredTexture;
+	sDeferredTexture.uiTextureID = uiTextureID;
+	sDeferredTexture.ullListNumber = ullNextListNumber;
+	vDeferredTextures.push_back(sDeferredTexture);
+	DeleteDeferredTextures();
+}
+
+/**
+ @brief Get the number of sprites which are waiting to be drawn, in the list which is being recorded and the submitted lists
+ */
+unsigned int CSpriteBatch2D::GetNumSprites(void) const
+{
+	unsigned int uiNumSprites = 0;
+	for (unsigned int i = 0; i < NUM_LISTS; i++)
+		uiNumSprites += arrLists[i].GetNumDrawItems();
+	return uiNumSprites;
+}
+
+/**
+ @brief Get the number of sprites which were drawn since ResetCounts
+ */
+unsigned int CSpriteBatch2D::GetNumSpritesDrawn(void) const
+{
+	return cBackend->GetNumItemsDrawn();
+}
+
+/**
+ @brief Get the number of draw calls since ResetCounts
+ */
+unsigned int CSpriteBatch2D::GetNumDrawCalls(void) const
+{
+	return cBackend->GetNumDrawCalls();
+}
+
+/**
+ @brief Reset the numbers of sprites and draw calls
+ */
+void CSpriteBatch2D::ResetCounts(void)
+{
+	cBackend->ResetCounts();
+}
+
+/**
+ @brief PrintSelf
+ */
+void CSpriteBatch2D::PrintSelf(void) const
+{
+	cout << "CSpriteBatch2D::PrintSelf()" << endl;
+	cout << "Sprites drawn: " << GetNumSpritesDrawn() << endl;
+	cout << "Draw calls: " << GetNumDrawCalls() << endl;
+	cout << "Sprites waiting: " << GetNumSprites() << endl;
+	cout << "Textures waiting to be deleted: " << vDeferredTextures.size() << endl;
+}
+
+/**
+ @brief Delete the deferred textures which no list can still draw. A list can draw a texture if it was begun
+		before the texture was deferred, and it is submitted, or it is being recorded and is not empty.
+		The lists which are begun later must not draw the texture, so a scene which always has a list
+		submitted, as it draws each list in the frame after it is recorded, still deletes its textures.
+ */
+void CSpriteBatch2D::DeleteDeferredTextures(void)
+{
+	if (vDeferredTextures.size() == 0)
+		return;
+
+	// The number of the oldest list which can still draw
+	unsigned long long ullOldestList = ullNextListNumber;
+	for (unsigned int i = 0; i < NUM_LISTS; i++)
+	{
+		if ((arrSubmitted[i]) || ((i == uiRecordingList) && (arrLists[i].GetNumDrawItems() > 0)))
+		{
+			if (arrListNumbers[i] < ullOldestList)
+				ullOldestList = arrListNumbers[i];
+		}
+	}
+
+	std::vector<GLuint> vTextures;
+	unsigned int uiNumWaiting = 0;
+	for (unsigned int i = 0; i < vDeferredTextures.size(); i++)
+	{
+		if (vDeferredTextures[i].ullListNumber <= ullOldestList)
+			vTextures.push_back(vDeferredTextures[i].uiTextureID);
+		else
+			vDeferredTextures[uiNumWaiting++] = vDeferredTextures[i];
+	}
+	vDeferredTextures.resize(uiNumWaiting);
+
+	if (vTextures.size() > 0)
+		cBackend->DeleteTextures((GLsizei)vTextures.size(), vTextures.data());
+}
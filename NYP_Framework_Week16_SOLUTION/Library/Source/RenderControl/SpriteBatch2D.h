@@ -0,0 +1,121 @@
+/**
+ CSpriteBatch2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include RenderCommandList2D
+#include "RenderCommandList2D.h"
+// Include GLRenderBackend2D
+#include "GLRenderBackend2D.h"
+
+class CShader;
+
+/**
+ CSpriteBatch2D: Collects the textured quads of a 2D scene, and draws them with a few draw calls
+				 instead of one draw call, and one transform upload, for each quad.
+
+				 Between Begin and Submit, each call to Draw records a sprite into a render command list, which
+				 is a quad with its centre and size in UV space, a rectangle of its texture, a tint and a layer.
+				 Submit hands the list to the render thread, which sorts the sprites by their layer, shader and
+				 texture and builds their vertices, while the caller records the next list or draws something else.
+				 Execute waits for the list, and the backend draws each run of sprites which share a shader and
+				 a texture with one draw call. End submits and executes the list at once.
+
+				 There are NUM_LISTS lists, which are used in turn, so a list must be executed before
+				 NUM_LISTS more lists are begun. This is enough for a scene to submit the lists of a frame
+				 at the end of it, and execute them in the next frame, so that the render thread prepares
+				 them while the next frame is simulated, and records the lists of the next frame after that. The OpenGL backend is used unless another one is set before Init,
+				 such as the null backend, which draws nothing and needs no OpenGL context.
+
+				 A sprite in a higher layer is drawn over a sprite in a lower layer. The sprites in the same
+				 layer, shader and texture are drawn in the order which they were added. The order of the
+				 sprites in the same layer but with different textures is not kept, so the sprites which
+				 overlap each other must be in different layers.
+ */
+class CSpriteBatch2D : public CSingletonTemplate<CSpriteBatch2D>
+{
+	friend CSingletonTemplate<CSpriteBatch2D>;
+public:
+	// The number of render command lists, which are recorded and drawn in turn. This is 2 lists for each of 2 frames
+	static const unsigned int NUM_LISTS = 4;
+
+	// Set the backend which draws the lists, or NULL for the OpenGL backend. This must be done before Init
+	void SetBackend(CRenderBackend2D* cBackend);
+
+	// Init
+	bool Init(void);
+
+	// Start recording a new list
+	void Begin(void);
+
+	// Add a sprite. The UV rectangle is the left, bottom, right and top of the texture coordinates
+	void Draw(	CShader* cShader,
+				const GLuint uiTextureID,
+				const glm::vec2& vec2Centre,
+				const glm::vec2& vec2Size,
+				const glm::vec4& vec4UVRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+				const glm::vec4& vec4Tint = glm::vec4(1.0f),
+				const int iLayer = 0);
+
+	// Hand the list which is being recorded to the render thread, and return its index for Execute
+	unsigned int Submit(void);
+
+	// Wait for a submitted list to be prepared, and draw it
+	void Execute(const unsigned int uiList);
+
+	// Submit and execute the list which is being recorded
+	void End(void);
+
+	// Delete a texture once no list which was recorded or submitted can still draw it
+	void DeleteTextureLater(const GLuint uiTextureID);
+
+	// Get the number of sprites which are waiting to be drawn
+	unsigned int GetNumSprites(void) const;
+
+	// Get the number of sprites and draw calls of the batches since ResetCounts
+	unsigned int GetNumSpritesDrawn(void) const;
+	unsigned int GetNumDrawCalls(void) const;
+	// Reset the numbers of sprites and draw calls, such as at the start of a frame
+	void ResetCounts(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The render command lists
+	CRenderCommandList2D arrLists[NUM_LISTS];
+	// Boolean flags to indicate if a list was submitted and not executed yet
+	bool arrSubmitted[NUM_LISTS];
+	// The list which is being recorded
+	unsigned int uiRecordingList;
+	// The number of each list, which is the order it was begun in, and the number of the next list
+	unsigned long long arrListNumbers[NUM_LISTS];
+	unsigned long long ullNextListNumber;
+
+	// A texture which is waiting to be deleted, until the lists which were begun before it was deferred are drawn
+	struct DeferredTexture
+	{
+		GLuint uiTextureID;
+		unsigned long long ullListNumber;
+	};
+	// The textures which are waiting to be deleted
+	std::vector<DeferredTexture> vDeferredTextures;
+
+	// The OpenGL backend, and the backend which draws the lists
+	CGLRenderBackend2D cGLBackend;
+	CRenderBackend2D* cBackend;
+
+	// Constructor
+	CSpriteBatch2D(void);
+
+	// Destructor
+	virtual ~CSpriteBatch2D(void);
+
+	// Delete the deferred textures if no list can still draw them
+	void DeleteDeferredTextures(void);
+};
@@ -0,0 +1,363 @@
+/**
+ CStreamBuffer
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "StreamBuffer.h"
+
+// Include GLFW, to load glBufferStorage, which is newer than the GLEW in this project
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+// The parts of ARB_buffer_storage which are not in the GLEW in this project
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (GLAPIENTRY * PFN_BUFFER_STORAGE)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+/**
+ @brief Get glBufferStorage if OpenGL 4.4 or ARB_buffer_storage is available, or NULL if it is not
+ */
+static PFN_BUFFER_STORAGE GetBufferStorage(void)
+{
+	GLint iMajorVersion = 0, iMinorVersion = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &iMajorVersion);
+	glGetIntegerv(GL_MINOR_VERSION, &iMinorVersion);
+	const bool bVersion44 = (iMajorVersion > 4) || ((iMajorVersion == 4) && (iMinorVersion >= 4));
+	if ((bVersion44 == false) && (glfwExtensionSupported("GL_ARB_buffer_storage") == GLFW_FALSE))
+		return NULL;
+
+	return (PFN_BUFFER_STORAGE)glfwGetProcAddress("glBufferStorage");
+}
+
+// The constants which are used by reference
+const unsigned int CStreamBuffer::NUM_SEGMENTS;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CStreamBuffer::CStreamBuffer(void)
+	: uiBufferID(0)
+	, iSegmentSize(0)
+	, bPersistent(false)
+	, pMappedData(NULL)
+	, uiCurrentSegment(0)
+	, iHead(0)
+	, uiNumAllocations(0)
+	, ullNumBytesAllocated(0)
+	, uiNumStalls(0)
+	, dStallTime(0.0)
+	, uiNumFailedAllocations(0)
+{
+	for (unsigned int i = 0; i < NUM_SEGMENTS; i++)
+		arrFences[i] = 0;
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CStreamBuffer::~CStreamBuffer(void)
+{
+	Release();
+}
+
+/**
+ @brief Init Initialise this instance. The buffer is mapped persistently if ARB_buffer_storage exists
+ @param iSegmentSize A const GLsizeiptr variable containing the size of each segment in bytes
+ */
+bool CStreamBuffer::Init(const GLsizeiptr iSegmentSize)
+{
+	if (iSegmentSize <= 0)
+	{
+		cout << "CStreamBuffer::Init: The size of a segment must be more than 0" << endl;
+		return false;
+	}
+
+	Release();
+	this->iSegmentSize = iSegmentSize;
+	const GLsizeiptr iBufferSize = iSegmentSize * NUM_SEGMENTS;
+
+	glGenBuffers(1, &uiBufferID);
+	glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+
+	PFN_BUFFER_STORAGE fnBufferStorage = GetBufferStorage();
+	if (fnBufferStorage != NULL)
+	{
+		const GLbitfield uiFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		fnBufferStorage(GL_ARRAY_BUFFER, iBufferSize, NULL, uiFlags);
+		pMappedData = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, iBufferSize, uiFlags);
+		bPersistent = (pMappedData != NULL);
+
+		// The storage of the buffer cannot be changed, so a new buffer is needed for orphaning
+		if (bPersistent == false)
+		{
+			cout << "CStreamBuffer::Init: The buffer could not be mapped persistently, so it is orphaned instead" << endl;
+			glDeleteBuffers(1, &uiBufferID);
+			glGenBuffers(1, &uiBufferID);
+			glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+		}
+	}
+	if (bPersistent == false)
+		glBufferData(GL_ARRAY_BUFFER, iBufferSize, NULL, GL_STREAM_DRAW);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	uiCurrentSegment = 0;
+	iHead = 0;
+	ResetCounts();
+	return true;
+}
+
+/**
+ @brief Get the buffer, which the vertex arrays read from
+ */
+GLuint CStreamBuffer::GetBufferID(void) const
+{
+	return uiBufferID;
+}
+
+/**
+ @brief Get if the buffer is mapped persistently
+ */
+bool CStreamBuffer::IsPersistent(void) const
+{
+	return bPersistent;
+}
+
+/**
+ @brief Allocate a number of bytes from the current segment, or from the next segment if it does not fit
+ @param iSize A const GLsizeiptr variable containing the number of bytes, which must fit in a segment
+ @param iAlignment A const GLsizeiptr variable containing the alignment of the offset, such as the size of a vertex
+ @return The allocation, whose pData is NULL if the allocation failed
+ */
+CStreamBuffer::Allocation CStreamBuffer::Allocate(const GLsizeiptr iSize, const GLsizeiptr iAlignment)
+{
+	Allocation sAllocation;
+	sAllocation.pData = NULL;
+	sAllocation.iOffset = 0;
+	sAllocation.iSize = 0;
+
+	if ((uiBufferID == 0) || (iSize <= 0) || (iSize > iSegmentSize))
+	{
+		uiNumFailedAllocations++;
+		return sAllocation;
+	}
+
+	// The offset is aligned from the start of the buffer, so that it can be divided into a base vertex
+	const GLsizeiptr iAlign = (iAlignment > 0) ? iAlignment : 1;
+	GLintptr iOffset = (iHead + iAlign - 1) / iAlign * iAlign;
+	if (iOffset + iSize > (GLintptr)(uiCurrentSegment + 1) * iSegmentSize)
+	{
+		AdvanceSegment();
+		iOffset = (iHead + iAlign - 1) / iAlign * iAlign;
+		if (iOffset + iSize > (GLintptr)(uiCurrentSegment + 1) * iSegmentSize)
+		{
+			uiNumFailedAllocations++;
+			return sAllocation;
+		}
+	}
+	iHead = iOffset + iSize;
+
+	if (bPersistent)
+	{
+		sAllocation.pData = pMappedData + iOffset;
+	}
+	else
+	{
+		// No draw call which is in flight reads this range of the storage, so there is nothing to wait for
+		glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+		sAllocation.pData = glMapBufferRange(GL_ARRAY_BUFFER, iOffset, iSize,
+											 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (sAllocation.pData == NULL)
+		{
+			uiNumFailedAllocations++;
+			return sAllocation;
+		}
+	}
+	sAllocation.iOffset = iOffset;
+	sAllocation.iSize = iSize;
+
+	uiNumAllocations++;
+	ullNumBytesAllocated += iSize;
+	return sAllocation;
+}
+
+/**
+ @brief Commit an allocation, after its vertices are written and before they are drawn.
+		The persistent mapping is coherent, so only the mapping of an orphaned buffer has to be ended
+ @param sAllocation A const Allocation& variable containing the allocation
+ */
+void CStreamBuffer::Commit(const Allocation& sAllocation)
+{
+	if ((bPersistent) || (sAllocation.pData == NULL))
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+/**
+ @brief End a frame, so that the next frame writes into the next segment. Nothing is done if this frame did not allocate
+ */
+void CStreamBuffer::EndFrame(void)
+{
+	if ((uiBufferID != 0) && (iHead > (GLintptr)uiCurrentSegment * iSegmentSize))
+		AdvanceSegment();
+}
+
+/**
+ @brief Get the number of allocations since ResetCounts
+ */
+unsigned int CStreamBuffer::GetNumAllocations(void) const
+{
+	return uiNumAllocations;
+}
+
+/**
+ @brief Get the number of bytes which were allocated since ResetCounts
+ */
+unsigned long long CStreamBuffer::GetNumBytesAllocated(void) const
+{
+	return ullNumBytesAllocated;
+}
+
+/**
+ @brief Get the number of times which the CPU waited for the GPU to finish reading a segment since ResetCounts
+ */
+unsigned int CStreamBuffer::GetNumStalls(void) const
+{
+	return uiNumStalls;
+}
+
+/**
+ @brief Get the time, in seconds, which the CPU waited for the GPU since ResetCounts
+ */
+double CStreamBuffer::GetStallTime(void) const
+{
+	return dStallTime;
+}
+
+/**
+ @brief Get the number of allocations which failed since ResetCounts, such as for being larger than a segment
+ */
+unsigned int CStreamBuffer::GetNumFailedAllocations(void) const
+{
+	return uiNumFailedAllocations;
+}
+
+/**
+ @brief Reset the statistics
+ */
+void CStreamBuffer::ResetCounts(void)
+{
+	uiNumAllocations = 0;
+	ullNumBytesAllocated = 0;
+	uiNumStalls = 0;
+	dStallTime = 0.0;
+	uiNumFailedAllocations = 0;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CStreamBuffer::PrintSelf(void) const
+{
+	cout << "CStreamBuffer::PrintSelf()" << endl;
+	cout << "Mode: " << (bPersistent ? "persistently mapped" : "orphaned") << endl;
+	cout << "Segments: " << NUM_SEGMENTS << " x " << iSegmentSize << " bytes" << endl;
+	cout << "Allocations: " << uiNumAllocations << ", " << ullNumBytesAllocated << " bytes" << endl;
+	cout << "Stalls: " << uiNumStalls << ", " << dStallTime * 1000.0 << " ms" << endl;
+	cout << "Failed allocations: " << uiNumFailedAllocations << endl;
+}
+
+/**
+ @brief Release the buffer and the fences
+ */
+void CStreamBuffer::Release(void)
+{
+	for (unsigned int i = 0; i < NUM_SEGMENTS; i++)
+	{
+		if (arrFences[i] != 0)
+		{
+			glDeleteSync(arrFences[i]);
+			arrFences[i] = 0;
+		}
+	}
+
+	if (uiBufferID != 0)
+	{
+		if (pMappedData != NULL)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &uiBufferID);
+	}
+
+	uiBufferID = 0;
+	pMappedData = NULL;
+	bPersistent = false;
+}
+
+/**
+ @brief Move to the next segment. When the buffer is mapped persistently, the current segment is fenced,
+		and the fence of the next segment is waited for. Otherwise, the buffer is orphaned when the ring wraps around
+ */
+void CStreamBuffer::AdvanceSegment(void)
+{
+	if (bPersistent)
+	{
+		if (arrFences[uiCurrentSegment] != 0)
+			glDeleteSync(arrFences[uiCurrentSegment]);
+		arrFences[uiCurrentSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	uiCurrentSegment = (uiCurrentSegment + 1) % NUM_SEGMENTS;
+	iHead = (GLintptr)uiCurrentSegment * iSegmentSize;
+
+	if (bPersistent)
+	{
+		WaitForSegment(uiCurrentSegment);
+	}
+	else if (uiCurrentSegment == 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, uiBufferID);
+		glBufferData(GL_ARRAY_BUFFER, iSegmentSize * NUM_SEGMENTS, NULL, GL_STREAM_DRAW);
+	}
+}
+
+/**
+ @brief Wait for the fence of a segment, and count a stall if it had not been signalled
+ @param uiSegment A const unsigned int variable containing the segment
+ */
+void CStreamBuffer::WaitForSegment(const unsigned int uiSegment)
+{
+	GLsync sFence = arrFences[uiSegment];
+	if (sFence == 0)
+		return;
+
+	GLenum eResult = glClientWaitSync(sFence, 0, 0);
+	if (eResult == GL_TIMEOUT_EXPIRED)
+	{
+		uiNumStalls++;
+		const chrono::steady_clock::time_point sStart = chrono::steady_clock::now();
+		do
+		{
+			// Flush the commands, or the fence may never be signalled, and wait for up to 1 second at a time
+			eResult = glClientWaitSync(sFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		} while (eResult == GL_TIMEOUT_EXPIRED);
+		dStallTime += chrono::duration<double>(chrono::steady_clock::now() - sStart).count();
+	}
+	if (eResult == GL_WAIT_FAILED)
+		cout << "CStreamBuffer::WaitForSegment: Failed to wait for segment " << uiSegment << endl;
+
+	glDeleteSync(sFence);
+	arrFences[uiSegment] = 0;
+}
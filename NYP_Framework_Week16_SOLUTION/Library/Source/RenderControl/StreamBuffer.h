@@ -0,0 +1,121 @@
+/**
+ CStreamBuffer
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+/**
+ CStreamBuffer: A vertex buffer for the geometry which is rebuilt every frame, such as the sprite batch and the text.
+				The buffer is a ring of NUM_SEGMENTS segments, so that the CPU writes one segment while the GPU
+				still draws from the segments of the frames before it. The users suballocate their vertices from
+				the current segment, and draw them from the offset of the allocation, such as with the base vertex
+				of glDrawElementsBaseVertex, or the first vertex of glDrawArrays.
+
+				Where ARB_buffer_storage exists, the buffer is mapped once for its whole life, and the vertices are
+				written straight into it. A fence is placed when the CPU leaves a segment, and the CPU waits for it
+				before it writes that segment again. Each wait for a fence which has not been signalled is a stall.
+
+				Elsewhere, the buffer is orphaned each time the ring wraps around, so that the driver gives it new
+				storage instead of waiting for the GPU, and each allocation is mapped without synchronisation,
+				as no draw call which is in flight reads the new storage.
+
+				An allocation must be committed before it is drawn, and its pointer must not be used after that.
+				The vertex arrays which read from this buffer must be set up after Init.
+ */
+class CStreamBuffer : public CSingletonTemplate<CStreamBuffer>
+{
+	friend CSingletonTemplate<CStreamBuffer>;
+public:
+	// The number of segments in the ring, which is the number of frames which can be in flight
+	static const unsigned int NUM_SEGMENTS = 3;
+
+	// An allocation
+	struct Allocation
+	{
+		// The memory which the vertices are written into, or NULL if the allocation failed
+		void* pData;
+		// The offset, in bytes, of the allocation in the buffer
+		GLintptr iOffset;
+		// The size, in bytes, of the allocation
+		GLsizeiptr iSize;
+	};
+
+	// Init, with the size of each segment in bytes
+	bool Init(const GLsizeiptr iSegmentSize = 2 * 1024 * 1024);
+
+	// Get the buffer, which the vertex arrays read from
+	GLuint GetBufferID(void) const;
+
+	// Get if the buffer is mapped persistently
+	bool IsPersistent(void) const;
+
+	// Allocate a number of bytes, with the offset aligned to a number of bytes, such as the size of a vertex
+	Allocation Allocate(const GLsizeiptr iSize, const GLsizeiptr iAlignment);
+
+	// Commit an allocation, after its vertices are written and before they are drawn
+	void Commit(const Allocation& sAllocation);
+
+	// End a frame, so that the next frame writes into the next segment
+	void EndFrame(void);
+
+	// Get the statistics since ResetCounts
+	unsigned int GetNumAllocations(void) const;
+	unsigned long long GetNumBytesAllocated(void) const;
+	unsigned int GetNumStalls(void) const;
+	double GetStallTime(void) const;
+	unsigned int GetNumFailedAllocations(void) const;
+	// Reset the statistics
+	void ResetCounts(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The buffer
+	GLuint uiBufferID;
+	// The size, in bytes, of each segment
+	GLsizeiptr iSegmentSize;
+	// True if the buffer is mapped persistently
+	bool bPersistent;
+	// The persistently mapped memory of the buffer, or NULL if it is not mapped persistently
+	unsigned char* pMappedData;
+
+	// The segment which is being written, and the offset of the next allocation in the buffer
+	unsigned int uiCurrentSegment;
+	GLintptr iHead;
+
+	// The fence of each segment, which is signalled when the GPU finished reading it, or 0 if it has none
+	GLsync arrFences[NUM_SEGMENTS];
+
+	// The statistics since ResetCounts
+	unsigned int uiNumAllocations;
+	unsigned long long ullNumBytesAllocated;
+	unsigned int uiNumStalls;
+	double dStallTime;
+	unsigned int uiNumFailedAllocations;
+
+	// Constructor
+	CStreamBuffer(void);
+
+	// Destructor
+	virtual ~CStreamBuffer(void);
+
+	// Release the buffer and the fences
+	void Release(void);
+
+	// Move to the next segment, fencing the current one and waiting for the fence of the next one
+	void AdvanceSegment(void);
+
+	// Wait for the fence of a segment, and count a stall if it had not been signalled
+	void WaitForSegment(const unsigned int uiSegment);
+};
@@ -7,8 +7,13 @@
 
  // Include Shader Manager
 #include "..\RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "..\RenderControl\GLStateCache.h"
+// Include StreamBuffer
+#include "..\RenderControl\StreamBuffer.h"
 
 #include <iostream>
+#include <cstring>
 using namespace std;
 
 #include "../System/filesystem.h"
@@ -31,8 +36,7 @@ CTextRenderer::~CTextRenderer(void)
 {
 	// optional: de-allocate all resources once they've outlived their purpose:
 	// ------------------------------------------------------------------------
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
+	CGLStateCache::GetInstance()->DeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &EBO);
 }
 
@@ -79,7 +83,7 @@ bool CTextRenderer::Init(void)
 		// Generate texture
 		GLuint texture;
 		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
+		CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, texture);
 		glTexImage2D(
 			GL_TEXTURE_2D,
 			0,
@@ -105,22 +109,20 @@ bool CTextRenderer::Init(void)
 		};
 		Characters.insert(std::pair<GLchar, Character>(c, character));
 	}
-	glBindTexture(GL_TEXTURE_2D, 0);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, 0);
 	// Destroy FreeType once we're finished
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
 
 
-	// Configure VAO/VBO for texture quads
+	// Configure VAO for texture quads, which read from the stream buffer
 	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, CStreamBuffer::GetInstance()->GetBufferID());
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	CGLStateCache::GetInstance()->BindVertexArray(0);
 
 	return true;
 }
@@ -138,11 +140,11 @@ void CTextRenderer::Update(void)
 void CTextRenderer::PreRender(void)
 {
 	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
 
 	// Activate blending mode
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	CGLStateCache::GetInstance()->Enable(GL_BLEND);
+	CGLStateCache::GetInstance()->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Activate the shader
 	CShaderManager::GetInstance()->Use(sShaderName);
@@ -153,11 +155,24 @@ void CTextRenderer::PreRender(void)
  */
 void CTextRenderer::Render(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 colour)
 {
+	if (text.empty())
+		return;
+
 	// Activate corresponding render state	
-	glUniform3f(glGetUniformLocation(CShaderManager::GetInstance()->activeShader->ID, "textColour"), 
-				colour.x, colour.y, colour.z);
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(VAO);
+	CShaderManager::GetInstance()->activeShader->setVec3(UNIFORM_TEXT_COLOUR, colour);
+	CGLStateCache::GetInstance()->ActiveTexture(GL_TEXTURE0);
+	CGLStateCache::GetInstance()->BindVertexArray(VAO);
+
+	// Write the quads of all the characters into the stream buffer at once
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	const CStreamBuffer::Allocation sAllocation = cStreamBuffer->Allocate(sizeof(GLfloat) * 6 * 4 * text.size(), sizeof(GLfloat) * 4);
+	if (sAllocation.pData == NULL)
+	{
+		CGLStateCache::GetInstance()->BindVertexArray(0);
+		return;
+	}
+	GLfloat* pVertices = (GLfloat*)sAllocation.pData;
+	const GLint iFirstVertex = (GLint)(sAllocation.iOffset / (sizeof(GLfloat) * 4));
 
 	// Iterate through all characters
 	std::string::const_iterator c;
@@ -170,7 +185,7 @@ void CTextRenderer::Render(std::string text, GLfloat x, GLfloat y, GLfloat scale
 
 		GLfloat w = ch.Size.x * scale;
 		GLfloat h = ch.Size.y * scale;
-		// Update VBO for each character
+		// The quad of the character
 		GLfloat vertices[6][4] = {
 			{ xpos, ypos + h, 0.0, 0.0 },
 			{ xpos, ypos, 0.0, 1.0 },
@@ -180,20 +195,21 @@ void CTextRenderer::Render(std::string text, GLfloat x, GLfloat y, GLfloat scale
 			{ xpos + w, ypos, 1.0, 1.0 },
 			{ xpos + w, ypos + h, 1.0, 0.0 }
 		};
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // Be sure to use glBufferSubData and not glBufferData
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		// Copy the quad into the stream buffer
+		memcpy(pVertices + (c - text.begin()) * 6 * 4, vertices, sizeof(vertices));
 		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
 		x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
 	}
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	cStreamBuffer->Commit(sAllocation);
+
+	// Render each glyph texture over its quad
+	for (c = text.begin(); c != text.end(); c++)
+	{
+		CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, Characters[*c].TextureID);
+		glDrawArrays(GL_TRIANGLES, iFirstVertex + (GLint)(c - text.begin()) * 6, 6);
+	}
+	CGLStateCache::GetInstance()->BindVertexArray(0);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, 0);
 }
 
 /**
@@ -201,6 +217,4 @@ void CTextRenderer::Render(std::string text, GLfloat x, GLfloat y, GLfloat scale
  */
 void CTextRenderer::PostRender(void)
 {
-	// Disable blending
-	glDisable(GL_BLEND);
 }
@@ -0,0 +1,374 @@
+/**
+ CTextureCache
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TextureCache.h"
+
+// Include ImageLoader
+#include "..\System\ImageLoader.h"
+// Include GLStateCache
+#include "GLStateCache.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CTextureCache::CTextureCache(void)
+	: uiBudget(64 * 1024 * 1024)
+	, uiMemoryUsed(0)
+	, ullUseCounter(0)
+	, uiNumHits(0)
+	, uiNumMisses(0)
+	, uiNumEvictions(0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton.
+		All the textures are deleted, including the ones which are still referenced.
+ */
+CTextureCache::~CTextureCache(void)
+{
+	for (std::map<GLuint, Entry>::iterator it = mapEntries.begin(); it != mapEntries.end(); ++it)
+	{
+		if (it->second.uiNumReferences > 0)
+			cout << "CTextureCache: " << it->second.strKey << " still has " << it->second.uiNumReferences << " references" << endl;
+		CGLStateCache::GetInstance()->DeleteTextures(1, &it->first);
+	}
+	mapEntries.clear();
+	mapKeys.clear();
+	uiMemoryUsed = 0;
+}
+
+/**
+ @brief Init Initialise this instance
+ @param uiBudget A const size_t variable containing the budget in bytes for the textures
+ */
+bool CTextureCache::Init(const size_t uiBudget)
+{
+	SetBudget(uiBudget);
+	ResetCounts();
+	return true;
+}
+
+/**
+ @brief Set the budget in bytes, and delete the least recently used textures with no references which are over it
+ @param uiBudget A const size_t variable containing the budget in bytes for the textures
+ */
+void CTextureCache::SetBudget(const size_t uiBudget)
+{
+	this->uiBudget = uiBudget;
+	Trim();
+}
+
+/**
+ @brief Get the budget in bytes
+ */
+size_t CTextureCache::GetBudget(void) const
+{
+	return uiBudget;
+}
+
+/**
+ @brief Get a texture, loading it if it is not in the cache, and add a reference to it.
+		Each successful Acquire must be matched by a Release.
+ @param filename A const char* variable containing the file name of the texture
+ @param bInvert A const bool variable which is true to flip the image vertically
+ @param iWrap A const GLint variable containing the wrapping mode of both texture coordinates
+ @param iFilter A const GLint variable containing the minifying and magnifying filter
+ @param bMipmaps A const bool variable which is true to generate the mipmaps
+ @return The texture ID, or 0 if the texture cannot be loaded
+ */
+GLuint CTextureCache::Acquire(	const char* filename,
+								const bool bInvert,
+								const GLint iWrap,
+								const GLint iFilter,
+								const bool bMipmaps)
+{
+	if (filename == NULL)
+		return 0;
+
+	const std::string strKey = MakeKey(filename, bInvert, iWrap, iFilter, bMipmaps);
+	std::map<std::string, GLuint>::iterator itKey = mapKeys.find(strKey);
+	if (itKey != mapKeys.end())
+	{
+		Entry& sEntry = mapEntries[itKey->second];
+		sEntry.uiNumReferences++;
+		sEntry.ullLastUsed = ++ullUseCounter;
+		uiNumHits++;
+		return itKey->second;
+	}
+
+	uiNumMisses++;
+	size_t uiSize = 0;
+	const GLuint uiTextureID = LoadTexture(filename, bInvert, iWrap, iFilter, bMipmaps, uiSize);
+	if (uiTextureID == 0)
+		return 0;
+
+	Entry sEntry;
+	sEntry.strKey = strKey;
+	sEntry.uiNumReferences = 1;
+	sEntry.uiSize = uiSize;
+	sEntry.ullLastUsed = ++ullUseCounter;
+	mapEntries[uiTextureID] = sEntry;
+	mapKeys[strKey] = uiTextureID;
+	uiMemoryUsed += uiSize;
+
+	// Make room for the new texture, which is referenced so it is not deleted
+	Trim();
+
+	return uiTextureID;
+}
+
+/**
+ @brief Remove a reference from a texture. The texture stays in the cache until it is evicted
+ @param uiTextureID A const GLuint variable containing the texture
+ */
+void CTextureCache::Release(const GLuint uiTextureID)
+{
+	std::map<GLuint, Entry>::iterator it = mapEntries.find(uiTextureID);
+	if ((it == mapEntries.end()) || (it->second.uiNumReferences == 0))
+	{
+		cout << "CTextureCache::Release: Texture " << uiTextureID << " is not referenced" << endl;
+		return;
+	}
+
+	it->second.uiNumReferences--;
+	it->second.ullLastUsed = ++ullUseCounter;
+}
+
+/**
+ @brief Delete the least recently used textures with no references, until the textures are within the budget
+ */
+void CTextureCache::Trim(void)
+{
+	while ((uiMemoryUsed > uiBudget) && (EvictOne()))
+	{
+	}
+}
+
+/**
+ @brief Delete all the textures with no references, such as when changing to a scene which uses other textures
+ */
+void CTextureCache::Purge(void)
+{
+	while (EvictOne())
+	{
+	}
+}
+
+/**
+ @brief Get the number of references to a texture
+ @param uiTextureID A const GLuint variable containing the texture
+ */
+unsigned int CTextureCache::GetNumReferences(const GLuint uiTextureID) const
+{
+	std::map<GLuint, Entry>::const_iterator it = mapEntries.find(uiTextureID);
+	if (it == mapEntries.end())
+		return 0;
+	return it->second.uiNumReferences;
+}
+
+/**
+ @brief Get the number of textures in the cache
+ */
+unsigned int CTextureCache::GetNumTextures(void) const
+{
+	return (unsigned int)mapEntries.size();
+}
+
+/**
+ @brief Get the bytes which the textures in the cache take
+ */
+size_t CTextureCache::GetMemoryUsed(void) const
+{
+	return uiMemoryUsed;
+}
+
+/**
+ @brief Get the number of times Acquire found the texture in the cache since ResetCounts
+ */
+unsigned int CTextureCache::GetNumHits(void) const
+{
+	return uiNumHits;
+}
+
+/**
+ @brief Get the number of times Acquire had to load the texture since ResetCounts
+ */
+unsigned int CTextureCache::GetNumMisses(void) const
+{
+	return uiNumMisses;
+}
+
+/**
+ @brief Get the number of textures which were evicted since ResetCounts
+ */
+unsigned int CTextureCache::GetNumEvictions(void) const
+{
+	return uiNumEvictions;
+}
+
+/**
+ @brief Reset the statistics
+ */
+void CTextureCache::ResetCounts(void)
+{
+	uiNumHits = 0;
+	uiNumMisses = 0;
+	uiNumEvictions = 0;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CTextureCache::PrintSelf(void) const
+{
+	cout << "CTextureCache::PrintSelf()" << endl;
+	cout << "Textures: " << mapEntries.size() << endl;
+	cout << "Memory: " << uiMemoryUsed / 1024 << " / " << uiBudget / 1024 << " KB" << endl;
+	cout << "Hits: " << uiNumHits << ", Misses: " << uiNumMisses << ", Evictions: " << uiNumEvictions << endl;
+	for (std::map<GLuint, Entry>::const_iterator it = mapEntries.begin(); it != mapEntries.end(); ++it)
+	{
+		cout << "\t" << it->first << ": " << it->second.strKey
+			<< ", " << it->second.uiNumReferences << " references"
+			<< ", " << it->second.uiSize / 1024 << " KB" << endl;
+	}
+}
+
+/**
+ @brief Make the key of a texture from its normalised path and its sampler settings. The path is in lower case,
+		with forward slashes and without repeated slashes or "./", so that the same file has the same key
+ @param filename A const char* variable containing the file name of the texture
+ @param bInvert A const bool variable which is true to flip the image vertically
+ @param iWrap A const GLint variable containing the wrapping mode
+ @param iFilter A const GLint variable containing the filter
+ @param bMipmaps A const bool variable which is true to generate the mipmaps
+ */
+std::string CTextureCache::MakeKey(	const char* filename,
+									const bool bInvert,
+									const GLint iWrap,
+									const GLint iFilter,
+									const bool bMipmaps)
+{
+	std::string strPath;
+	for (const char* pChar = filename; *pChar != '\0'; pChar++)
+	{
+		const char cChar = (*pChar == '\\') ? '/' : (char)tolower((unsigned char)*pChar);
+
+		// Skip repeated slashes
+		if ((cChar == '/') && (strPath.size() > 0) && (strPath[strPath.size() - 1] == '/'))
+			continue;
+		strPath += cChar;
+
+		// Remove a "./" at the start or after a slash
+		if ((cChar == '/') && (strPath.size() >= 2) && (strPath[strPath.size() - 2] == '.') &&
+			((strPath.size() == 2) || (strPath[strPath.size() - 3] == '/')))
+		{
+			strPath.resize(strPath.size() - 2);
+		}
+	}
+
+	return strPath + "|" + (bInvert ? "1" : "0") +
+		"|" + to_string(iWrap) +
+		"|" + to_string(iFilter) +
+		"|" + (bMipmaps ? "1" : "0");
+}
+
+/**
+ @brief Load a texture
+ @param filename A const char* variable containing the file name of the texture
+ @param bInvert A const bool variable which is true to flip the image vertically
+ @param iWrap A const GLint variable containing the wrapping mode of both texture coordinates
+ @param iFilter A const GLint variable containing the minifying and magnifying filter
+ @param bMipmaps A const bool variable which is true to generate the mipmaps
+ @param uiSize A size_t& variable which is set to the bytes which the texture takes, including its mipmaps
+ @return The texture ID, or 0 if the texture cannot be loaded
+ */
+GLuint CTextureCache::LoadTexture(	const char* filename,
+									const bool bInvert,
+									const GLint iWrap,
+									const GLint iFilter,
+									const bool bMipmaps,
+									size_t& uiSize)
+{
+	// Variables used in loading the texture
+	int width = 0, height = 0, nrChannels = 0;
+
+	CImageLoader* cImageLoader = CImageLoader::GetInstance();
+	unsigned char *data = cImageLoader->Load(filename, width, height, nrChannels, bInvert);
+	if (data == NULL)
+	{
+		cout << "CTextureCache: Unable to load " << filename << endl;
+		return 0;
+	}
+	if ((nrChannels != 3) && (nrChannels != 4))
+	{
+		cout << "CTextureCache: " << filename << " has " << nrChannels << " channels instead of 3 or 4" << endl;
+		free(data);
+		return 0;
+	}
+
+	GLuint uiTextureID = 0;
+	glGenTextures(1, &uiTextureID);
+	CGLStateCache::GetInstance()->BindTexture(GL_TEXTURE_2D, uiTextureID);
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, iWrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, iWrap);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, iFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, iFilter);
+
+	// The rows of the image are tightly packed, so a RGB image which is not a multiple of 4 bytes wide is not skewed
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (nrChannels == 3)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	// The drivers store a RGB texel in 4 bytes, like a RGBA one, and the mipmaps take a third more than the base level
+	uiSize = (size_t)width * height * 4;
+	if (bMipmaps)
+	{
+		glGenerateMipmap(GL_TEXTURE_2D);
+		uiSize += uiSize / 3;
+	}
+
+	// Free up the memory of the file data read in
+	free(data);
+
+	return uiTextureID;
+}
+
+/**
+ @brief Delete the least recently used texture with no references
+ @return false if there is no texture without references
+ */
+bool CTextureCache::EvictOne(void)
+{
+	std::map<GLuint, Entry>::iterator itOldest = mapEntries.end();
+	for (std::map<GLuint, Entry>::iterator it = mapEntries.begin(); it != mapEntries.end(); ++it)
+	{
+		if ((it->second.uiNumReferences == 0) &&
+			((itOldest == mapEntries.end()) || (it->second.ullLastUsed < itOldest->second.ullLastUsed)))
+		{
+			itOldest = it;
+		}
+	}
+	if (itOldest == mapEntries.end())
+		return false;
+
+	const GLuint uiTextureID = itOldest->first;
+	CGLStateCache::GetInstance()->DeleteTextures(1, &uiTextureID);
+	uiMemoryUsed -= itOldest->second.uiSize;
+	mapKeys.erase(itOldest->second.strKey);
+	mapEntries.erase(itOldest);
+	uiNumEvictions++;
+	return true;
+}
@@ -0,0 +1,132 @@
+/**
+ CTextureCache
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#ifndef GLEW_STATIC
+#include <GL/glew.h>
+#define GLEW_STATIC
+#endif
+
+// Include map and string
+#include <map>
+#include <string>
+
+/**
+ CTextureCache: Loads each texture once, keyed by its normalised path and its sampler settings, and shares it
+				between the users which acquire it. Each Acquire adds a reference to the texture,
+				and each Release removes one.
+
+				A texture with no references stays resident, so that it is not loaded again if it is
+				acquired later, until the textures take more memory than the budget. Then the textures
+				with no references are deleted, starting from the least recently used one. The textures
+				which are referenced are never deleted, even when they are over the budget.
+
+				The textures are only deleted in Acquire, Trim and Destroy, and not in Release, so a
+				texture which was released in the middle of a frame can still be drawn until the frame ends.
+ */
+class CTextureCache : public CSingletonTemplate<CTextureCache>
+{
+	friend CSingletonTemplate<CTextureCache>;
+public:
+	// Init, with the budget in bytes for the textures
+	bool Init(const size_t uiBudget = 64 * 1024 * 1024);
+
+	// Set the budget in bytes, and delete the least recently used textures with no references which are over it
+	void SetBudget(const size_t uiBudget);
+	size_t GetBudget(void) const;
+
+	// Get a texture, loading it if it is not in the cache, and add a reference to it. 0 is returned if it cannot be loaded
+	GLuint Acquire(	const char* filename,
+					const bool bInvert = true,
+					const GLint iWrap = GL_REPEAT,
+					const GLint iFilter = GL_LINEAR,
+					const bool bMipmaps = true);
+
+	// Remove a reference from a texture
+	void Release(const GLuint uiTextureID);
+
+	// Delete the least recently used textures with no references, until the textures are within the budget
+	void Trim(void);
+
+	// Delete all the textures with no references
+	void Purge(void);
+
+	// Get the number of references to a texture
+	unsigned int GetNumReferences(const GLuint uiTextureID) const;
+
+	// Get the number of textures in the cache, and the bytes which they take
+	unsigned int GetNumTextures(void) const;
+	size_t GetMemoryUsed(void) const;
+
+	// Get the statistics since ResetCounts
+	unsigned int GetNumHits(void) const;
+	unsigned int GetNumMisses(void) const;
+	unsigned int GetNumEvictions(void) const;
+	// Reset the statistics
+	void ResetCounts(void);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// A texture in the cache
+	struct Entry
+	{
+		// The key of the texture in mapEntries
+		std::string strKey;
+		// The number of references to the texture
+		unsigned int uiNumReferences;
+		// The bytes which the texture takes, including its mipmaps
+		size_t uiSize;
+		// The use when the texture was last acquired or released, which orders the textures for eviction
+		unsigned long long ullLastUsed;
+	};
+
+	// The textures, by their key
+	std::map<std::string, GLuint> mapKeys;
+	// The entries of the textures, by their texture ID
+	std::map<GLuint, Entry> mapEntries;
+
+	// The budget in bytes, and the bytes which the textures take
+	size_t uiBudget;
+	size_t uiMemoryUsed;
+
+	// Incremented for every Acquire and Release, so that the least recently used texture has the lowest value
+	unsigned long long ullUseCounter;
+
+	// The statistics since ResetCounts
+	unsigned int uiNumHits;
+	unsigned int uiNumMisses;
+	unsigned int uiNumEvictions;
+
+	// Constructor
+	CTextureCache(void);
+
+	// Destructor
+	virtual ~CTextureCache(void);
+
+	// Make the key of a texture from its normalised path and its sampler settings
+	static std::string MakeKey(	const char* filename,
+								const bool bInvert,
+								const GLint iWrap,
+								const GLint iFilter,
+								const bool bMipmaps);
+
+	// Load a texture, and return its ID and size, or 0 if it cannot be loaded
+	GLuint LoadTexture(	const char* filename,
+						const bool bInvert,
+						const GLint iWrap,
+						const GLint iFilter,
+						const bool bMipmaps,
+						size_t& uiSize);
+
+	// Delete the least recently used texture with no references, and return false if there is none
+	bool EvictOne(void);
+};
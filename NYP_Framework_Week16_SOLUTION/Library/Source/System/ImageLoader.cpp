@@ -11,6 +11,9 @@ using namespace std;
 // Include GLEW
 #include <GL/glew.h>
 
+// Include TextureCache
+#include "..\RenderControl\TextureCache.h"
+
 // STB Image
 #ifndef STB_IMAGE_IMPLEMENTATION
 	#define STB_IMAGE_IMPLEMENTATION
@@ -56,41 +59,14 @@ unsigned char * CImageLoader::Load(const char* filename, int& width, int& height
 	return data;
 }
 
+/**
+@brief Load an image and return as a Texture ID. The texture is shared through the texture cache,
+	   so it must be released with CTextureCache::Release instead of being deleted
+@param filename A const char* variable which contains the file name of the texture
+@param bInvert A const bool variable which is true to flip the image vertically
+*/
 unsigned CImageLoader::LoadTextureGetID(const char* filename,  const bool bInvert)
 {
-	// Load from file
-	int image_width = 0;
-	int image_height = 0;
-	int nrChannels = 0;
-
-	// tell stb_image.h to flip loaded texture's on the y-axis.
-	stbi_set_flip_vertically_on_load(bInvert);
-
-	// load image, create texture and generate mipmaps
-	unsigned char* data = stbi_load(FileSystem::getPath(filename).c_str(),
-		&image_width, &image_height, &nrChannels, 0);
-
-	if (data == NULL)
-		return 0;
-
-	// Create a OpenGL texture identifier
-	GLuint image_texture;
-	glGenTextures(1, &image_texture);
-	glBindTexture(GL_TEXTURE_2D, image_texture);
-
-	// Setup filtering parameters for display
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // This is required on WebGL for non power-of-two textures
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // Same
-
-				  // Upload pixels into texture
-#if defined(GL_UNPACK_ROW_LENGTH) && !defined(__EMSCRIPTEN__)
-	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-#endif
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-	stbi_image_free(data);
-
-	return image_texture;
+	// Clamp to the edge, as required on WebGL for non power-of-two textures, and without mipmaps
+	return CTextureCache::GetInstance()->Acquire(filename, bInvert, GL_CLAMP_TO_EDGE, GL_LINEAR, false);
 }
-
@@ -0,0 +1,172 @@
+/**
+ CRandom
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "Random.h"
+
+#include <iostream>
+using namespace std;
+
+// Include ctime to make a seed from the time
+#include <ctime>
+
+// The constants which are used by reference
+const unsigned long long CRandom::MULTIPLIER;
+
+/**
+ @brief Constructor
+ @param ullSeed A const unsigned long long variable containing the seed
+ @param ullStream A const unsigned long long variable containing the stream
+ */
+CRandom::CRandom(const unsigned long long ullSeed, const unsigned long long ullStream)
+	: ullState(0)
+	, ullIncrement(1)
+{
+	Seed(ullSeed, ullStream);
+}
+
+/**
+ @brief Seed the generator, and select its stream
+ @param ullSeed A const unsigned long long variable containing the seed
+ @param ullStream A const unsigned long long variable containing the stream
+ */
+void CRandom::Seed(const unsigned long long ullSeed, const unsigned long long ullStream)
+{
+	ullState = 0;
+	ullIncrement = (ullStream << 1u) | 1u;
+	NextUInt();
+	ullState += ullSeed;
+	NextUInt();
+}
+
+/**
+ @brief Jump ahead by a number of values, without generating them.
+		The step of the generator is applied ullDelta times by squaring it, one bit of ullDelta at a time.
+ @param ullDelta A const unsigned long long variable containing the number of values to skip
+ */
+void CRandom::Advance(const unsigned long long ullDelta)
+{
+	unsigned long long ullCurrentMultiplier = MULTIPLIER;
+	unsigned long long ullCurrentIncrement = ullIncrement;
+	unsigned long long ullTotalMultiplier = 1u;
+	unsigned long long ullTotalIncrement = 0u;
+	for (unsigned long long ullRemaining = ullDelta; ullRemaining > 0; ullRemaining >>= 1)
+	{
+		if (ullRemaining & 1u)
+		{
+			ullTotalMultiplier *= ullCurrentMultiplier;
+			ullTotalIncrement = ullTotalIncrement * ullCurrentMultiplier + ullCurrentIncrement;
+		}
+		ullCurrentIncrement = (ullCurrentMultiplier + 1u) * ullCurrentIncrement;
+		ullCurrentMultiplier *= ullCurrentMultiplier;
+	}
+	ullState = ullTotalMultiplier * ullState + ullTotalIncrement;
+}
+
+/**
+ @brief Get the state
+ */
+CRandom::STATE CRandom::GetState(void) const
+{
+	STATE sState;
+	sState.ullState = ullState;
+	sState.ullIncrement = ullIncrement;
+	return sState;
+}
+
+/**
+ @brief Set the state
+ */
+void CRandom::SetState(const STATE& sState)
+{
+	ullState = sState.ullState;
+	// The increment must be odd for the generator to reach every state
+	ullIncrement = sState.ullIncrement | 1u;
+}
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CRandomStreams::CRandomStreams(void)
+	: ullSeed(0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CRandomStreams::~CRandomStreams(void)
+{
+}
+
+/**
+ @brief Init Initialise this instance, and seed all the streams
+ @param ullSeed A const unsigned long long variable containing the seed. If it is 0, a seed is made from the time
+ */
+bool CRandomStreams::Init(const unsigned long long ullSeed)
+{
+	this->ullSeed = (ullSeed != 0) ? ullSeed : (unsigned long long)time(0);
+	for (int i = 0; i < NUM_STREAMS; i++)
+		arrStreams[i].Seed(this->ullSeed, (unsigned long long)i);
+
+	cout << "CRandomStreams::Init: The seed is " << this->ullSeed << endl;
+	return true;
+}
+
+/**
+ @brief Get the seed of the streams
+ */
+unsigned long long CRandomStreams::GetSeed(void) const
+{
+	return ullSeed;
+}
+
+/**
+ @brief Get the generator of a stream
+ @param eStream A const STREAM variable containing the stream
+ */
+CRandom& CRandomStreams::GetStream(const STREAM eStream)
+{
+	return arrStreams[eStream];
+}
+
+/**
+ @brief Capture the state of all the streams
+ @param vStates A std::vector<CRandom::STATE>& variable which the states are written to
+ */
+void CRandomStreams::CaptureState(std::vector<CRandom::STATE>& vStates) const
+{
+	vStates.resize(NUM_STREAMS);
+	for (int i = 0; i < NUM_STREAMS; i++)
+		vStates[i] = arrStreams[i].GetState();
+}
+
+/**
+ @brief Restore the state of all the streams
+ @param vStates A const std::vector<CRandom::STATE>& variable containing the states from CaptureState
+ @return true if the states were restored
+ */
+bool CRandomStreams::RestoreState(const std::vector<CRandom::STATE>& vStates)
+{
+	if (vStates.size() != NUM_STREAMS)
+	{
+		cout << "CRandomStreams::RestoreState: Expected " << NUM_STREAMS << " states but got " << vStates.size() << endl;
+		return false;
+	}
+
+	for (int i = 0; i < NUM_STREAMS; i++)
+		arrStreams[i].SetState(vStates[i]);
+	return true;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CRandomStreams::PrintSelf(void) const
+{
+	cout << "CRandomStreams::PrintSelf()" << endl;
+	cout << "Seed: " << ullSeed << endl;
+	for (int i = 0; i < NUM_STREAMS; i++)
+		cout << "Stream " << i << ": " << arrStreams[i].GetState().ullState << endl;
+}
@@ -0,0 +1,149 @@
+/**
+ CRandom
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include vector
+#include <vector>
+
+/**
+ CRandom: A fast random number generator, using PCG32 (the permuted congruential generator with 64 bits of state
+		  and 32 bits of output). Each generator has a seed and a stream, and generators with the same seed and
+		  different streams give independent sequences. The generator can jump ahead by any number of values
+		  without generating them, and its state can be captured and restored to replay a sequence exactly.
+
+		  A generator is not thread safe. To use one stream on several threads, give each thread a copy
+		  which jumps ahead to its own part of the stream, so that it does not repeat the values of the others.
+ */
+class CRandom
+{
+public:
+	// The state of a generator, which can be captured and restored
+	struct STATE
+	{
+		unsigned long long ullState;
+		unsigned long long ullIncrement;
+	};
+
+	// Constructor
+	CRandom(const unsigned long long ullSeed = 0x853c49e6748fea9bULL, const unsigned long long ullStream = 0xda3e39cb94b95bdbULL);
+
+	// Seed the generator, and select its stream
+	void Seed(const unsigned long long ullSeed, const unsigned long long ullStream);
+
+	// Get the next random 32 bit number
+	inline unsigned int NextUInt(void)
+	{
+		const unsigned long long ullOldState = ullState;
+		ullState = ullOldState * MULTIPLIER + ullIncrement;
+		const unsigned int uiXorShifted = (unsigned int)(((ullOldState >> 18u) ^ ullOldState) >> 27u);
+		const unsigned int uiRotation = (unsigned int)(ullOldState >> 59u);
+		return (uiXorShifted >> uiRotation) | (uiXorShifted << ((~uiRotation + 1u) & 31));
+	}
+
+	// Get a random number in [0, uiBound), without the bias of the modulus
+	inline unsigned int NextUInt(const unsigned int uiBound)
+	{
+		if (uiBound <= 1)
+			return 0;
+		// Reject the lowest values which would make some results more likely
+		const unsigned int uiThreshold = (~uiBound + 1u) % uiBound;
+		for (;;)
+		{
+			const unsigned int uiValue = NextUInt();
+			if (uiValue >= uiThreshold)
+				return uiValue % uiBound;
+		}
+	}
+
+	// Get a random float in [0, 1)
+	inline float NextFloat(void)
+	{
+		return (NextUInt() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Get a random integer in [iMin, iMax]
+	inline int RandIntMinMax(const int iMin, const int iMax)
+	{
+		if (iMax <= iMin)
+			return iMin;
+		return iMin + (int)NextUInt((unsigned int)(iMax - iMin) + 1u);
+	}
+
+	// Get a random float in [fMin, fMax)
+	inline float RandFloatMinMax(const float fMin, const float fMax)
+	{
+		return fMin + (fMax - fMin) * NextFloat();
+	}
+
+	// Jump ahead by a number of values, in O(log ullDelta)
+	void Advance(const unsigned long long ullDelta);
+
+	// Get the state
+	STATE GetState(void) const;
+	// Set the state
+	void SetState(const STATE& sState);
+
+protected:
+	// The multiplier of the linear congruential generator
+	static const unsigned long long MULTIPLIER = 6364136223846793005ULL;
+
+	// The state, and the increment which selects the stream. The increment is always odd
+	unsigned long long ullState;
+	unsigned long long ullIncrement;
+};
+
+/**
+ CRandomStreams: The random number generators of the subsystems. Each subsystem has its own stream,
+				 so that the numbers used by one subsystem do not change the numbers of another,
+				 such as more particles being emitted changing where the items spawn.
+				 All the streams are seeded from one seed, which is printed so that a run can be replayed.
+ */
+class CRandomStreams : public CSingletonTemplate<CRandomStreams>
+{
+	friend CSingletonTemplate<CRandomStreams>;
+public:
+	// The subsystems which have their own streams
+	enum STREAM
+	{
+		STREAM_WORLD = 0,	// The switching of the gravity
+		STREAM_SPAWNING,	// The spawning of items
+		STREAM_PARTICLES,	// The emission of particles
+		NUM_STREAMS
+	};
+
+	// Init, and seed all the streams. If ullSeed is 0, a seed is made from the time
+	bool Init(const unsigned long long ullSeed = 0);
+
+	// Get the seed of the streams
+	unsigned long long GetSeed(void) const;
+
+	// Get the generator of a stream
+	CRandom& GetStream(const STREAM eStream);
+
+	// Capture the state of all the streams
+	void CaptureState(std::vector<CRandom::STATE>& vStates) const;
+	// Restore the state of all the streams
+	bool RestoreState(const std::vector<CRandom::STATE>& vStates);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The seed of the streams
+	unsigned long long ullSeed;
+
+	// The generators of the streams
+	CRandom arrStreams[NUM_STREAMS];
+
+	// Constructor
+	CRandomStreams(void);
+
+	// Destructor
+	virtual ~CRandomStreams(void);
+};
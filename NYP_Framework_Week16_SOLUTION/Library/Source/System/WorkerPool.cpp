@@ -0,0 +1,183 @@
+/**
+ CWorkerPool
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "WorkerPool.h"
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CWorkerPool::CWorkerPool(void)
+	: pfnJob(NULL)
+	, uiNumItems(0)
+	, uiItemsPerThread(0)
+	, uiNumActiveThreads(0)
+	, ullJobID(0)
+	, uiNumPending(0)
+	, bStop(false)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CWorkerPool::~CWorkerPool(void)
+{
+	Exit();
+}
+
+/**
+ @brief Initialise this instance
+ @param uiNumThreads A const unsigned int variable containing the number of threads, including the calling thread
+ */
+bool CWorkerPool::Init(const unsigned int uiNumThreads)
+{
+	// Stop the current workers, if any
+	Exit();
+
+	unsigned int uiThreads = uiNumThreads;
+	if (uiThreads == 0)
+		uiThreads = std::thread::hardware_concurrency();
+	if (uiThreads == 0)
+		uiThreads = 1;
+
+	// Reset the job state. The new workers start from job 0, so a job ID left over from
+	// the previous workers would wake them up to run a job which no longer exists
+	pfnJob = NULL;
+	uiNumItems = 0;
+	uiItemsPerThread = 0;
+	uiNumActiveThreads = 0;
+	ullJobID = 0;
+	uiNumPending = 0;
+	bStop = false;
+
+	// The calling thread is thread 0, so only start the other threads
+	for (unsigned int i = 1; i < uiThreads; i++)
+	{
+		vThreads.push_back(std::thread(&CWorkerPool::WorkerLoop, this, i));
+	}
+
+	cout << "CWorkerPool: Using " << uiThreads << " threads" << endl;
+
+	return true;
+}
+
+/**
+ @brief Stop and join all the worker threads
+ */
+void CWorkerPool::Exit(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		bStop = true;
+	}
+	cvJobReady.notify_all();
+
+	for (unsigned int i = 0; i < vThreads.size(); i++)
+	{
+		if (vThreads[i].joinable())
+			vThreads[i].join();
+	}
+	vThreads.clear();
+}
+
+/**
+ @brief Get the number of threads, including the calling thread
+ */
+unsigned int CWorkerPool::GetNumThreads(void) const
+{
+	return (unsigned int)vThreads.size() + 1;
+}
+
+/**
+ @brief Run a job over a number of items, split into one contiguous range per thread, and wait for it to finish.
+ @param uiNumItems A const unsigned int variable containing the number of items
+ @param fnJob A const JOB& variable which is the job to run for each range
+ @param uiMaxThreads A const unsigned int variable containing the maximum number of threads to use. 0 means all threads
+ */
+void CWorkerPool::ParallelFor(const unsigned int uiNumItems, const JOB& fnJob, const unsigned int uiMaxThreads)
+{
+	if (uiNumItems == 0)
+		return;
+
+	unsigned int uiThreads = GetNumThreads();
+	if ((uiMaxThreads > 0) && (uiMaxThreads < uiThreads))
+		uiThreads = uiMaxThreads;
+	if (uiThreads > uiNumItems)
+		uiThreads = uiNumItems;
+
+	// Run the job on this thread if there is nothing to share
+	if (uiThreads == 1)
+	{
+		fnJob(0, uiNumItems, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		pfnJob = &fnJob;
+		this->uiNumItems = uiNumItems;
+		uiItemsPerThread = (uiNumItems + uiThreads - 1) / uiThreads;
+		uiNumActiveThreads = uiThreads;
+		uiNumPending = (unsigned int)vThreads.size();
+		ullJobID++;
+	}
+	cvJobReady.notify_all();
+
+	// Work on the first range on this thread
+	RunJob(0);
+
+	// Wait for the workers to finish
+	std::unique_lock<std::mutex> lock(mMutex);
+	cvJobDone.wait(lock, [this] { return uiNumPending == 0; });
+	pfnJob = NULL;
+}
+
+/**
+ @brief The loop run by each worker thread
+ @param uiThread A const unsigned int variable containing the index of this thread
+ */
+void CWorkerPool::WorkerLoop(const unsigned int uiThread)
+{
+	unsigned long long ullLastJobID = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			cvJobReady.wait(lock, [this, ullLastJobID] { return bStop || ullJobID != ullLastJobID; });
+			if (bStop)
+				return;
+			ullLastJobID = ullJobID;
+		}
+
+		RunJob(uiThread);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			uiNumPending--;
+		}
+		cvJobDone.notify_one();
+	}
+}
+
+/**
+ @brief Run the current job for a thread
+ @param uiThread A const unsigned int variable containing the index of the thread
+ */
+void CWorkerPool::RunJob(const unsigned int uiThread)
+{
+	if (uiThread >= uiNumActiveThreads)
+		return;
+
+	unsigned int uiBegin = uiThread * uiItemsPerThread;
+	unsigned int uiEnd = uiBegin + uiItemsPerThread;
+	if (uiEnd > uiNumItems)
+		uiEnd = uiNumItems;
+
+	if (uiBegin < uiEnd)
+		(*pfnJob)(uiBegin, uiEnd, uiThread);
+}
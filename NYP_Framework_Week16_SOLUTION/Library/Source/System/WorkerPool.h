@@ -0,0 +1,75 @@
+/**
+ CWorkerPool
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "..\DesignPatterns\SingletonTemplate.h"
+
+// Include the threading headers
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+/**
+ CWorkerPool: A fixed set of worker threads which run a job over disjoint ranges of items.
+			  The calling thread works on the first range, so a pool with 1 thread runs the job serially.
+ */
+class CWorkerPool : public CSingletonTemplate<CWorkerPool>
+{
+	friend CSingletonTemplate<CWorkerPool>;
+public:
+	// A job which processes the items in [uiBegin, uiEnd) on the thread with index uiThread
+	typedef std::function<void(const unsigned int uiBegin, const unsigned int uiEnd, const unsigned int uiThread)> JOB;
+
+	// Init. If uiNumThreads is 0, the number of hardware threads is used
+	bool Init(const unsigned int uiNumThreads = 0);
+
+	// Stop and join all the worker threads
+	void Exit(void);
+
+	// Get the number of threads, including the calling thread
+	unsigned int GetNumThreads(void) const;
+
+	// Run a job over uiNumItems items, split into one contiguous range per thread, and wait for it to finish.
+	// The ranges are in ascending order of thread index.
+	void ParallelFor(const unsigned int uiNumItems, const JOB& fnJob, const unsigned int uiMaxThreads = 0);
+
+protected:
+	// The worker threads
+	std::vector<std::thread> vThreads;
+
+	// Synchronisation for handing out jobs
+	std::mutex mMutex;
+	std::condition_variable cvJobReady;
+	std::condition_variable cvJobDone;
+
+	// The current job
+	const JOB* pfnJob;
+	unsigned int uiNumItems;
+	unsigned int uiItemsPerThread;
+	unsigned int uiNumActiveThreads;
+
+	// Incremented for every job, so that the workers can tell a new job from a spurious wake-up
+	unsigned long long ullJobID;
+	// The number of workers which are still running the current job
+	unsigned int uiNumPending;
+	// Boolean flag to tell the workers to stop
+	bool bStop;
+
+	// Constructor
+	CWorkerPool(void);
+
+	// Destructor
+	virtual ~CWorkerPool(void);
+
+	// The loop run by each worker thread
+	void WorkerLoop(const unsigned int uiThread);
+
+	// Run the current job for a thread
+	void RunJob(const unsigned int uiThread);
+};
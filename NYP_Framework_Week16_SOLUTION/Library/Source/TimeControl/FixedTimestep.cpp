@@ -0,0 +1,89 @@
+/**
+ CFixedTimestep
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "FixedTimestep.h"
+
+/**
+ @brief Constructor
+ */
+CFixedTimestep::CFixedTimestep(void)
+	: dStepTime(1.0 / 60.0)
+	, dAccumulator(0.0)
+	, uiMaxStepsPerFrame(5)
+	, uiNumDroppedFrames(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CFixedTimestep::~CFixedTimestep(void)
+{
+}
+
+/**
+ @brief Initialise this class instance
+ @param dStepTime A const double variable containing the time of each step in seconds
+ @param uiMaxStepsPerFrame A const unsigned int variable containing the highest number of steps to simulate in one frame
+ */
+void CFixedTimestep::Init(const double dStepTime, const unsigned int uiMaxStepsPerFrame)
+{
+	this->dStepTime = dStepTime;
+	this->uiMaxStepsPerFrame = uiMaxStepsPerFrame;
+	dAccumulator = 0.0;
+	uiNumDroppedFrames = 0;
+}
+
+/**
+ @brief Add the time of a frame, and return the number of steps to simulate for it.
+		If a slow frame needs more than uiMaxStepsPerFrame steps, then the extra time is dropped,
+		so that the simulation slows down instead of falling further behind on every frame.
+ @param dFrameTime A const double variable containing the time of the frame in seconds
+ */
+unsigned int CFixedTimestep::Advance(const double dFrameTime)
+{
+	if (dFrameTime > 0.0)
+		dAccumulator += dFrameTime;
+
+	unsigned int uiNumSteps = 0;
+	while ((dAccumulator >= dStepTime) && (uiNumSteps < uiMaxStepsPerFrame))
+	{
+		dAccumulator -= dStepTime;
+		uiNumSteps++;
+	}
+
+	// Drop the time which could not be caught up in this frame
+	if (dAccumulator >= dStepTime)
+	{
+		dAccumulator = 0.0;
+		uiNumDroppedFrames++;
+	}
+
+	return uiNumSteps;
+}
+
+/**
+ @brief Get the time of each step in seconds
+ */
+double CFixedTimestep::GetStepTime(void) const
+{
+	return dStepTime;
+}
+
+/**
+ @brief Get the fraction of a step which is left in the accumulator, for interpolating the rendering
+ */
+double CFixedTimestep::GetAlpha(void) const
+{
+	return dAccumulator / dStepTime;
+}
+
+/**
+ @brief Get the number of frames in which steps were dropped to catch up
+ */
+unsigned int CFixedTimestep::GetNumDroppedFrames(void) const
+{
+	return uiNumDroppedFrames;
+}
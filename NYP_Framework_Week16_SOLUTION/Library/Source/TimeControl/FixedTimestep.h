@@ -0,0 +1,47 @@
+/**
+ CFixedTimestep
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+/**
+ CFixedTimestep: Accumulates the real frame time and hands it out in fixed steps,
+				 so that the simulation runs at the same rate whatever the frame rate is.
+				 The time which is left over is returned as an alpha between 0 and 1,
+				 for interpolating between the previous and current states when rendering.
+ */
+class CFixedTimestep
+{
+public:
+	// Constructor
+	CFixedTimestep(void);
+
+	// Destructor
+	~CFixedTimestep(void);
+
+	// Initialise this class instance
+	void Init(const double dStepTime, const unsigned int uiMaxStepsPerFrame);
+
+	// Add the time of a frame, and return the number of steps to simulate for it
+	unsigned int Advance(const double dFrameTime);
+
+	// Get the time of each step in seconds
+	double GetStepTime(void) const;
+
+	// Get the fraction of a step which is left in the accumulator, for interpolating the rendering
+	double GetAlpha(void) const;
+
+	// Get the number of frames in which steps were dropped to catch up
+	unsigned int GetNumDroppedFrames(void) const;
+
+protected:
+	// The time of each step in seconds
+	double dStepTime;
+	// The time which has not been simulated yet
+	double dAccumulator;
+	// The highest number of steps to simulate in one frame
+	unsigned int uiMaxStepsPerFrame;
+	// The number of frames in which steps were dropped
+	unsigned int uiNumDroppedFrames;
+};
@@ -0,0 +1,342 @@
+/**
+ CIdleTaskScheduler
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "IdleTaskScheduler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+// The constants which are used by reference
+const CIdleTaskScheduler::HANDLE CIdleTaskScheduler::INVALID_HANDLE;
+const double CIdleTaskScheduler::SAFETY_MARGIN = 0.002;
+const double CIdleTaskScheduler::ESTIMATE_DECAY = 0.9;
+const double CIdleTaskScheduler::STARVED_ESTIMATE_DECAY = 0.99;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CIdleTaskScheduler::CIdleTaskScheduler(void)
+	: hNextTask(1)
+	, dAvailableTime(0.0)
+	, dUsedTime(0.0)
+	, ullNumSlices(0)
+	, uiNumOverruns(0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CIdleTaskScheduler::~CIdleTaskScheduler(void)
+{
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+		arrTasks[i].clear();
+}
+
+/**
+ @brief Init Initialise this instance. All the tasks are removed and the statistics are reset
+ */
+bool CIdleTaskScheduler::Init(void)
+{
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+		arrTasks[i].clear();
+
+	dAvailableTime = 0.0;
+	dUsedTime = 0.0;
+	ullNumSlices = 0;
+	uiNumOverruns = 0;
+	return true;
+}
+
+/**
+ @brief Add a task, which is run in the idle time of the following frames
+ @param strName A const std::string& variable containing the name of the task
+ @param fnSlice A const SLICE_FUNCTION& variable containing the slice function, which returns true when the task is finished
+ @param ePriority A const PRIORITY variable containing the priority of the task
+ @return The handle of the task, or INVALID_HANDLE if the slice function is empty
+ */
+CIdleTaskScheduler::HANDLE CIdleTaskScheduler::AddTask(const std::string& strName,
+													   const SLICE_FUNCTION& fnSlice,
+													   const PRIORITY ePriority)
+{
+	if ((!fnSlice) || (ePriority < 0) || (ePriority >= NUM_PRIORITIES))
+	{
+		cout << "CIdleTaskScheduler::AddTask: " << strName << " needs a slice function and a valid priority" << endl;
+		return INVALID_HANDLE;
+	}
+
+	Task sTask;
+	sTask.hTask = hNextTask++;
+	// Skip the invalid handle when the handles wrap around
+	if (hNextTask == INVALID_HANDLE)
+		hNextTask++;
+	sTask.strName = strName;
+	sTask.fnSlice = fnSlice;
+	sTask.dEstimatedSliceTime = 0.0;
+	sTask.uiNumSlices = 0;
+	arrTasks[ePriority].push_back(sTask);
+	return sTask.hTask;
+}
+
+/**
+ @brief Cancel a task. A handle to a task which has finished or was cancelled is ignored
+ @param hTask A const HANDLE variable containing the handle of the task
+ */
+void CIdleTaskScheduler::Cancel(const HANDLE hTask)
+{
+	RemoveTask(hTask);
+}
+
+/**
+ @brief Check if a task is still waiting to finish
+ @param hTask A const HANDLE variable containing the handle of the task
+ */
+bool CIdleTaskScheduler::IsPending(const HANDLE hTask) const
+{
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (unsigned int j = 0; j < arrTasks[i].size(); j++)
+		{
+			if (arrTasks[i][j].hTask == hTask)
+				return true;
+		}
+	}
+	return false;
+}
+
+/**
+ @brief Get the number of tasks which are waiting to finish
+ */
+unsigned int CIdleTaskScheduler::GetNumPending(void) const
+{
+	unsigned int uiNumPending = 0;
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+		uiNumPending += (unsigned int)arrTasks[i].size();
+	return uiNumPending;
+}
+
+/**
+ @brief Run the slices of the tasks until there is no time left for another slice before the deadline
+ @param dIdleTime A const double variable containing the time, in seconds, until the deadline
+ @return The time, in seconds, which was used
+ */
+double CIdleTaskScheduler::RunIdle(const double dIdleTime)
+{
+	if (dIdleTime <= 0.0)
+		return 0.0;
+	dAvailableTime += dIdleTime;
+
+	const double dStartTime = GetTime();
+	const double dDeadline = dStartTime + dIdleTime;
+	double dCurrentTime = dStartTime;
+	while (true)
+	{
+		Task* pTask = GetNextTask(dDeadline - dCurrentTime - SAFETY_MARGIN);
+		if (pTask == NULL)
+			break;
+
+		// The slice function may add and cancel tasks, which can move this task, so it is found again by its handle
+		const HANDLE hTask = pTask->hTask;
+		const SLICE_FUNCTION fnSlice = pTask->fnSlice;
+		const bool bFinished = fnSlice();
+		const double dEndTime = GetTime();
+		ullNumSlices++;
+
+		pTask = FindTask(hTask);
+		if (pTask != NULL)
+		{
+			// Follow a slower slice at once, and a faster slice slowly, so the estimate errs on the side of the deadline
+			pTask->dEstimatedSliceTime = max(dEndTime - dCurrentTime, pTask->dEstimatedSliceTime * ESTIMATE_DECAY);
+			pTask->uiNumSlices++;
+			if (bFinished)
+				RemoveTask(hTask);
+		}
+		dCurrentTime = dEndTime;
+	}
+
+	if (dCurrentTime > dDeadline)
+		uiNumOverruns++;
+
+	// A slice which was slow once, such as when the thread was preempted, could make an estimate which never fits
+	// in the idle time, and as only a slice which is run updates its estimate, the task would never run again.
+	// So the estimates which are too long for the whole idle time are decayed slowly, until the task is tried again
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (auto& task : arrTasks[i])
+		{
+			if (task.dEstimatedSliceTime > dIdleTime - SAFETY_MARGIN)
+				task.dEstimatedSliceTime *= STARVED_ESTIMATE_DECAY;
+		}
+	}
+
+	const double dUsedTimeThisFrame = dCurrentTime - dStartTime;
+	dUsedTime += min(dUsedTimeThisFrame, dIdleTime);
+	return dUsedTimeThisFrame;
+}
+
+/**
+ @brief Run all the tasks to the end, such as before the game exits
+ */
+void CIdleTaskScheduler::Flush(void)
+{
+	while (true)
+	{
+		Task* pTask = GetNextTask(DBL_MAX);
+		if (pTask == NULL)
+			break;
+
+		const HANDLE hTask = pTask->hTask;
+		const SLICE_FUNCTION fnSlice = pTask->fnSlice;
+		const bool bFinished = fnSlice();
+		ullNumSlices++;
+		if (bFinished)
+			RemoveTask(hTask);
+	}
+}
+
+/**
+ @brief Set the clock which the slices and the deadlines are timed with, such as a simulated clock in the tests.
+		Init does not change the clock.
+ @param fnClock A const CLOCK_FUNCTION& variable containing the clock, or an empty function for the steady clock
+ */
+void CIdleTaskScheduler::SetClock(const CLOCK_FUNCTION& fnClock)
+{
+	this->fnClock = fnClock;
+}
+
+/**
+ @brief Get the time, in seconds, which was available to the tasks since Init
+ */
+double CIdleTaskScheduler::GetAvailableTime(void) const
+{
+	return dAvailableTime;
+}
+
+/**
+ @brief Get the time, in seconds, which the tasks used since Init
+ */
+double CIdleTaskScheduler::GetUsedTime(void) const
+{
+	return dUsedTime;
+}
+
+/**
+ @brief Get the time, in seconds, which was available but not used since Init, and was slept by the frame rate limiter
+ */
+double CIdleTaskScheduler::GetWastedTime(void) const
+{
+	return dAvailableTime - dUsedTime;
+}
+
+/**
+ @brief Get the number of slices which were run since Init
+ */
+unsigned long long CIdleTaskScheduler::GetNumSlices(void) const
+{
+	return ullNumSlices;
+}
+
+/**
+ @brief Get the number of times which the slices ran past the deadline since Init
+ */
+unsigned int CIdleTaskScheduler::GetNumOverruns(void) const
+{
+	return uiNumOverruns;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CIdleTaskScheduler::PrintSelf(void) const
+{
+	cout << "CIdleTaskScheduler::PrintSelf()" << endl;
+	cout << "Pending tasks: " << GetNumPending() << endl;
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (unsigned int j = 0; j < arrTasks[i].size(); j++)
+		{
+			cout << arrTasks[i][j].strName << ": priority " << i << ", " << arrTasks[i][j].uiNumSlices << " slices, "
+				<< arrTasks[i][j].dEstimatedSliceTime * 1000.0 << " ms per slice" << endl;
+		}
+	}
+	cout << "Idle time available: " << dAvailableTime * 1000.0 << " ms" << endl;
+	cout << "Idle time used: " << dUsedTime * 1000.0 << " ms" << endl;
+	cout << "Idle time wasted: " << GetWastedTime() * 1000.0 << " ms" << endl;
+	cout << "Slices: " << ullNumSlices << ", overruns: " << uiNumOverruns << endl;
+}
+
+/**
+ @brief Get the oldest task with the highest priority whose next slice fits in a time
+ @param dTimeLeft A const double variable containing the time, in seconds, which the slice must fit in
+ @return The task, or NULL if there is none
+ */
+CIdleTaskScheduler::Task* CIdleTaskScheduler::GetNextTask(const double dTimeLeft)
+{
+	if (dTimeLeft <= 0.0)
+		return NULL;
+
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (unsigned int j = 0; j < arrTasks[i].size(); j++)
+		{
+			if (arrTasks[i][j].dEstimatedSliceTime <= dTimeLeft)
+				return &arrTasks[i][j];
+		}
+	}
+	return NULL;
+}
+
+/**
+ @brief Find a task
+ @param hTask A const HANDLE variable containing the handle of the task
+ @return The task, or NULL if it is not pending
+ */
+CIdleTaskScheduler::Task* CIdleTaskScheduler::FindTask(const HANDLE hTask)
+{
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (unsigned int j = 0; j < arrTasks[i].size(); j++)
+		{
+			if (arrTasks[i][j].hTask == hTask)
+				return &arrTasks[i][j];
+		}
+	}
+	return NULL;
+}
+
+/**
+ @brief Remove a task
+ @param hTask A const HANDLE variable containing the handle of the task
+ */
+void CIdleTaskScheduler::RemoveTask(const HANDLE hTask)
+{
+	if (hTask == INVALID_HANDLE)
+		return;
+
+	for (int i = 0; i < NUM_PRIORITIES; i++)
+	{
+		for (std::deque<Task>::iterator it = arrTasks[i].begin(); it != arrTasks[i].end(); ++it)
+		{
+			if (it->hTask == hTask)
+			{
+				arrTasks[i].erase(it);
+				return;
+			}
+		}
+	}
+}
+
+/**
+ @brief Get the time, in seconds, from the clock which was set, or from a steady clock
+ */
+double CIdleTaskScheduler::GetTime(void) const
+{
+	if (fnClock)
+		return fnClock();
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,145 @@
+/**
+ CIdleTaskScheduler
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include deque, string and function
+#include <deque>
+#include <string>
+#include <functional>
+
+/**
+ CIdleTaskScheduler: Runs deferrable work, such as saving the map, in the time which is left in a frame
+					 after it finished its work and before the frame rate limiter would sleep until its deadline.
+
+					 A task is split into slices. Its slice function does a small part of the work each time it is
+					 called, and returns true when the task is finished. A slice is only started if its estimated
+					 time, from the slices of the same task which were run before, fits before the deadline with
+					 SAFETY_MARGIN to spare, so the frames still start on time. Of the tasks whose next slice fits,
+					 the oldest task with the highest priority is run first. The first slice of a task is run as soon
+					 as there is any time to spare. A slice function may add and cancel tasks.
+
+					 The time which was available, the time which was used by the tasks, and the time which was
+					 left to sleep are counted, to see how much of the idle time is put to use.
+ */
+class CIdleTaskScheduler : public CSingletonTemplate<CIdleTaskScheduler>
+{
+	friend CSingletonTemplate<CIdleTaskScheduler>;
+public:
+	// The handle to a task
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0;
+
+	// The slice function of a task, which returns true when the task is finished
+	typedef std::function<bool(void)> SLICE_FUNCTION;
+
+	// A clock which returns the time in seconds
+	typedef std::function<double(void)> CLOCK_FUNCTION;
+
+	// The priorities of the tasks
+	enum PRIORITY
+	{
+		PRIORITY_HIGH = 0,	// Work which the player is waiting for, such as a save
+		PRIORITY_NORMAL,	// Work which should be done soon, such as compacting
+		PRIORITY_LOW,		// Work which only makes things faster later, such as prefetching and warming caches
+		NUM_PRIORITIES
+	};
+
+	// Init. All the tasks are removed and the statistics are reset
+	bool Init(void);
+
+	// Add a task, which is run in the idle time of the following frames
+	HANDLE AddTask(const std::string& strName, const SLICE_FUNCTION& fnSlice, const PRIORITY ePriority = PRIORITY_NORMAL);
+
+	// Cancel a task. A handle to a task which has finished or was cancelled is ignored
+	void Cancel(const HANDLE hTask);
+
+	// Check if a task is still waiting to finish
+	bool IsPending(const HANDLE hTask) const;
+
+	// Get the number of tasks which are waiting to finish
+	unsigned int GetNumPending(void) const;
+
+	// Run the slices of the tasks for up to dIdleTime seconds, and return the time which was used
+	double RunIdle(const double dIdleTime);
+
+	// Run all the tasks to the end, such as before the game exits
+	void Flush(void);
+
+	// Set the clock which the slices and the deadlines are timed with. An empty function restores the steady clock
+	void SetClock(const CLOCK_FUNCTION& fnClock);
+
+	// Get the time, in seconds, which was available to the tasks since Init
+	double GetAvailableTime(void) const;
+	// Get the time, in seconds, which the tasks used since Init
+	double GetUsedTime(void) const;
+	// Get the time, in seconds, which was available but not used since Init
+	double GetWastedTime(void) const;
+	// Get the number of slices which were run since Init
+	unsigned long long GetNumSlices(void) const;
+	// Get the number of times which the slices ran past the deadline since Init
+	unsigned int GetNumOverruns(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The time, in seconds, which is kept free before the deadline, for the frame rate limiter to wake up on time
+	static const double SAFETY_MARGIN;
+	// The ratio which the estimated time of a slice decays by after each slice, when slices get faster
+	static const double ESTIMATE_DECAY;
+	// The ratio which an estimate that is too long for the whole idle time decays by after each frame,
+	// so that a task which was slow once is tried again after a few seconds instead of never
+	static const double STARVED_ESTIMATE_DECAY;
+
+	// A task
+	struct Task
+	{
+		HANDLE hTask;
+		std::string strName;
+		SLICE_FUNCTION fnSlice;
+		// The estimated time, in seconds, of the next slice
+		double dEstimatedSliceTime;
+		// The number of slices which were run
+		unsigned int uiNumSlices;
+	};
+
+	// The tasks of each priority, from the oldest to the newest
+	std::deque<Task> arrTasks[NUM_PRIORITIES];
+
+	// The handle of the next task
+	HANDLE hNextTask;
+
+	// The clock which the slices and the deadlines are timed with, or an empty function for the steady clock
+	CLOCK_FUNCTION fnClock;
+
+	// The statistics since Init
+	double dAvailableTime;
+	double dUsedTime;
+	unsigned long long ullNumSlices;
+	unsigned int uiNumOverruns;
+
+	// Constructor
+	CIdleTaskScheduler(void);
+
+	// Destructor
+	virtual ~CIdleTaskScheduler(void);
+
+	// Get the oldest task with the highest priority whose next slice fits in a time, or NULL if there is none
+	Task* GetNextTask(const double dTimeLeft);
+
+	// Find a task, or NULL if it is not pending
+	Task* FindTask(const HANDLE hTask);
+
+	// Remove a task
+	void RemoveTask(const HANDLE hTask);
+
+	// Get the time, in seconds, from the clock
+	double GetTime(void) const;
+};
@@ -0,0 +1,350 @@
+/**
+ CQualityGovernor
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+using namespace std;
+
+// The constants which are used by reference
+const CQualityGovernor::HANDLE CQualityGovernor::INVALID_HANDLE;
+const unsigned int CQualityGovernor::WINDOW_SIZE;
+const double CQualityGovernor::DOWNGRADE_RATIO = 1.1;
+const double CQualityGovernor::UPGRADE_RATIO = 0.7;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CQualityGovernor::CQualityGovernor(void)
+	: uiNextFrameTime(0)
+	, ullNumFrames(0)
+	, uiFramesSinceEvaluation(0)
+	, uiNumUnderBudget(0)
+	, dTargetFrameTime(1.0 / 30.0)
+	, bEnabled(true)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CQualityGovernor::~CQualityGovernor(void)
+{
+	vKnobs.clear();
+}
+
+/**
+ @brief Init Initialise this instance. The knobs are kept, and the window and the decisions are cleared
+ @param dTargetFrameTime A const double variable containing the time budget of a frame in seconds
+ */
+bool CQualityGovernor::Init(const double dTargetFrameTime)
+{
+	if (dTargetFrameTime <= 0.0)
+	{
+		cout << "CQualityGovernor::Init: The target frame time must be more than 0" << endl;
+		return false;
+	}
+	this->dTargetFrameTime = dTargetFrameTime;
+
+	vFrameTimes.clear();
+	vFrameTimes.reserve(WINDOW_SIZE);
+	vSortedFrameTimes.reserve(WINDOW_SIZE);
+	uiNextFrameTime = 0;
+	ullNumFrames = 0;
+	uiFramesSinceEvaluation = 0;
+	uiNumUnderBudget = 0;
+	vDecisions.clear();
+	return true;
+}
+
+/**
+ @brief Add the time which a frame spent working, and make a decision if it is time for one
+ @param dFrameTime A const double variable containing the time in seconds
+ */
+void CQualityGovernor::AddFrameTime(const double dFrameTime)
+{
+	ullNumFrames++;
+
+	// Add the frame time to the window, replacing the oldest one when it is full
+	if (vFrameTimes.size() < WINDOW_SIZE)
+		vFrameTimes.push_back(dFrameTime);
+	else
+		vFrameTimes[uiNextFrameTime] = dFrameTime;
+	uiNextFrameTime = (uiNextFrameTime + 1) % WINDOW_SIZE;
+
+	uiFramesSinceEvaluation++;
+	if (uiFramesSinceEvaluation < EVALUATION_INTERVAL)
+		return;
+	uiFramesSinceEvaluation = 0;
+
+	if ((bEnabled) && (vFrameTimes.size() >= MIN_SAMPLES))
+		Evaluate();
+}
+
+/**
+ @brief Register a knob, and apply its starting level
+ @param strName A const std::string& variable containing the name of the knob
+ @param iNumLevels A const int variable containing the number of levels, which must be 2 or more
+ @param fnApply A const APPLY_FUNCTION& variable containing the callback which applies a level
+ @param iStartLevel A const int variable containing the starting level. The highest level is used if it is negative
+ @return The handle of the knob, or INVALID_HANDLE if it is invalid
+ */
+CQualityGovernor::HANDLE CQualityGovernor::RegisterKnob(const std::string& strName,
+														const int iNumLevels,
+														const APPLY_FUNCTION& fnApply,
+														const int iStartLevel)
+{
+	if ((iNumLevels < 2) || (!fnApply))
+	{
+		cout << "CQualityGovernor::RegisterKnob: " << strName << " needs 2 or more levels and a callback" << endl;
+		return INVALID_HANDLE;
+	}
+
+	Knob sKnob;
+	sKnob.strName = strName;
+	sKnob.iNumLevels = iNumLevels;
+	sKnob.iLevel = (iStartLevel < 0) ? iNumLevels - 1 : min(iStartLevel, iNumLevels - 1);
+	sKnob.fnApply = fnApply;
+	vKnobs.push_back(sKnob);
+
+	vKnobs.back().fnApply(vKnobs.back().iLevel);
+	return (HANDLE)(vKnobs.size() - 1);
+}
+
+/**
+ @brief Unregister all the knobs. Each knob which was lowered is set back to its highest level first,
+		as its setting may outlive the scene which registered it, such as the update interval of the animations
+ */
+void CQualityGovernor::ClearKnobs(void)
+{
+	for (HANDLE i = 0; i < vKnobs.size(); i++)
+		SetLevel(i, vKnobs[i].iNumLevels - 1);
+	vKnobs.clear();
+	uiNumUnderBudget = 0;
+}
+
+/**
+ @brief Set the level of a knob, and apply it
+ @param hKnob A const HANDLE variable containing the handle of the knob
+ @param iLevel A const int variable containing the level, which is clamped to the levels of the knob
+ */
+void CQualityGovernor::SetLevel(const HANDLE hKnob, const int iLevel)
+{
+	if (hKnob >= vKnobs.size())
+		return;
+
+	Knob& sKnob = vKnobs[hKnob];
+	const int iClampedLevel = max(0, min(iLevel, sKnob.iNumLevels - 1));
+	if (iClampedLevel == sKnob.iLevel)
+		return;
+
+	sKnob.iLevel = iClampedLevel;
+	sKnob.fnApply(sKnob.iLevel);
+}
+
+/**
+ @brief Get the level of a knob, or -1 if the handle is invalid
+ @param hKnob A const HANDLE variable containing the handle of the knob
+ */
+int CQualityGovernor::GetLevel(const HANDLE hKnob) const
+{
+	if (hKnob >= vKnobs.size())
+		return -1;
+	return vKnobs[hKnob].iLevel;
+}
+
+/**
+ @brief Get the name of a knob
+ @param hKnob A const HANDLE variable containing the handle of the knob
+ */
+std::string CQualityGovernor::GetName(const HANDLE hKnob) const
+{
+	if (hKnob >= vKnobs.size())
+		return "";
+	return vKnobs[hKnob].strName;
+}
+
+/**
+ @brief Get the number of knobs
+ */
+unsigned int CQualityGovernor::GetNumKnobs(void) const
+{
+	return (unsigned int)vKnobs.size();
+}
+
+/**
+ @brief Set if the knobs are changed by the governor
+ @param bEnabled A const bool variable which is true if the knobs are changed by the governor
+ */
+void CQualityGovernor::SetEnabled(const bool bEnabled)
+{
+	this->bEnabled = bEnabled;
+	uiNumUnderBudget = 0;
+}
+
+/**
+ @brief Get if the knobs are changed by the governor
+ */
+bool CQualityGovernor::GetEnabled(void) const
+{
+	return bEnabled;
+}
+
+/**
+ @brief Set the time budget of a frame
+ @param dTargetFrameTime A const double variable containing the time in seconds
+ */
+void CQualityGovernor::SetTargetFrameTime(const double dTargetFrameTime)
+{
+	if (dTargetFrameTime > 0.0)
+		this->dTargetFrameTime = dTargetFrameTime;
+}
+
+/**
+ @brief Get the time budget of a frame, in seconds
+ */
+double CQualityGovernor::GetTargetFrameTime(void) const
+{
+	return dTargetFrameTime;
+}
+
+/**
+ @brief Get a percentile of the frame times in the window, by the nearest rank
+ @param dPercentile A const double variable containing the percentile, from 0 to 100
+ @return The frame time in seconds, or 0 if the window is empty
+ */
+double CQualityGovernor::GetPercentile(const double dPercentile) const
+{
+	if (vFrameTimes.size() == 0)
+		return 0.0;
+
+	const double dClampedPercentile = max(0.0, min(dPercentile, 100.0));
+	const size_t uiRank = (size_t)ceil(dClampedPercentile / 100.0 * vFrameTimes.size());
+	const size_t uiIndex = (uiRank > 0) ? uiRank - 1 : 0;
+
+	// Only the element at the rank has to be in its sorted place
+	vSortedFrameTimes.assign(vFrameTimes.begin(), vFrameTimes.end());
+	nth_element(vSortedFrameTimes.begin(), vSortedFrameTimes.begin() + uiIndex, vSortedFrameTimes.end());
+	return vSortedFrameTimes[uiIndex];
+}
+
+/**
+ @brief Get the decisions which were made since Init, from the oldest to the newest
+ */
+const std::vector<CQualityGovernor::Decision>& CQualityGovernor::GetDecisions(void) const
+{
+	return vDecisions;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CQualityGovernor::PrintSelf(void) const
+{
+	cout << "CQualityGovernor::PrintSelf()" << endl;
+	cout << "Target frame time: " << dTargetFrameTime * 1000.0 << " ms" << endl;
+	cout << "50th percentile: " << GetPercentile(50.0) * 1000.0 << " ms" << endl;
+	cout << "95th percentile: " << GetPercentile(95.0) * 1000.0 << " ms" << endl;
+	for (unsigned int i = 0; i < vKnobs.size(); i++)
+	{
+		cout << vKnobs[i].strName << ": " << vKnobs[i].iLevel << " / " << vKnobs[i].iNumLevels - 1 << endl;
+	}
+	cout << "Decisions: " << vDecisions.size() << endl;
+}
+
+/**
+ @brief Evaluate the window, and lower or raise a knob if it is needed
+ */
+void CQualityGovernor::Evaluate(void)
+{
+	if (vKnobs.size() == 0)
+		return;
+
+	const double dPercentile95 = GetPercentile(95.0);
+
+	if (dPercentile95 > dTargetFrameTime * DOWNGRADE_RATIO)
+	{
+		uiNumUnderBudget = 0;
+
+		// Lower the knob with the highest quality, which is the first one registered on a tie
+		HANDLE hKnob = INVALID_HANDLE;
+		for (HANDLE i = 0; i < vKnobs.size(); i++)
+		{
+			if (vKnobs[i].iLevel == 0)
+				continue;
+			if ((hKnob == INVALID_HANDLE) || (GetQuality(i) > GetQuality(hKnob)))
+				hKnob = i;
+		}
+		if (hKnob != INVALID_HANDLE)
+			StepKnob(hKnob, -1, dPercentile95);
+	}
+	else if (dPercentile95 < dTargetFrameTime * UPGRADE_RATIO)
+	{
+		uiNumUnderBudget++;
+		if (uiNumUnderBudget < UPGRADE_EVALUATIONS)
+			return;
+		uiNumUnderBudget = 0;
+
+		// Raise the knob with the lowest quality, which is the last one registered on a tie
+		HANDLE hKnob = INVALID_HANDLE;
+		for (HANDLE i = 0; i < vKnobs.size(); i++)
+		{
+			if (vKnobs[i].iLevel == vKnobs[i].iNumLevels - 1)
+				continue;
+			if ((hKnob == INVALID_HANDLE) || (GetQuality(i) <= GetQuality(hKnob)))
+				hKnob = i;
+		}
+		if (hKnob != INVALID_HANDLE)
+			StepKnob(hKnob, 1, dPercentile95);
+	}
+	else
+	{
+		// Within the band between the ratios, so nothing changes
+		uiNumUnderBudget = 0;
+	}
+}
+
+/**
+ @brief Change a knob by one level, record the decision and clear the window
+ @param hKnob A const HANDLE variable containing the handle of the knob
+ @param iDelta A const int variable containing the change of the level, which is -1 or 1
+ @param dPercentile95 A const double variable containing the 95th percentile which the decision was made from
+ */
+void CQualityGovernor::StepKnob(const HANDLE hKnob, const int iDelta, const double dPercentile95)
+{
+	Knob& sKnob = vKnobs[hKnob];
+
+	Decision sDecision;
+	sDecision.ullFrame = ullNumFrames;
+	sDecision.hKnob = hKnob;
+	sDecision.iOldLevel = sKnob.iLevel;
+	sDecision.iNewLevel = sKnob.iLevel + iDelta;
+	sDecision.dPercentile95 = dPercentile95;
+	if (vDecisions.size() >= MAX_DECISIONS)
+		vDecisions.erase(vDecisions.begin());
+	vDecisions.push_back(sDecision);
+
+	sKnob.iLevel = sDecision.iNewLevel;
+	sKnob.fnApply(sKnob.iLevel);
+
+	cout << "CQualityGovernor: " << sKnob.strName << " " << sDecision.iOldLevel << " -> " << sDecision.iNewLevel
+		<< " (95th percentile " << dPercentile95 * 1000.0 << " ms)" << endl;
+
+	// Only decide again from the frames which run with the new level
+	vFrameTimes.clear();
+	uiNextFrameTime = 0;
+	uiFramesSinceEvaluation = 0;
+}
+
+/**
+ @brief Get the quality of a knob, from 0 to 1, relative to its number of levels
+ @param hKnob A const HANDLE variable containing the handle of the knob
+ */
+float CQualityGovernor::GetQuality(const HANDLE hKnob) const
+{
+	return (float)vKnobs[hKnob].iLevel / (float)(vKnobs[hKnob].iNumLevels - 1);
+}
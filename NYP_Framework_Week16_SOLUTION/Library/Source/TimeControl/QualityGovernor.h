@@ -0,0 +1,170 @@
+/**
+ CQualityGovernor
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include vector, string and function
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ CQualityGovernor: Lowers and raises the quality of the game to keep the frames within their time budget.
+				   The time which each frame spent working, without the time which the frame rate limiter slept,
+				   is kept in a rolling window. Every EVALUATION_INTERVAL frames, the 95th percentile of the window
+				   is compared with the budget:
+				   - If it is over the budget by DOWNGRADE_RATIO, one knob is lowered by one level.
+				   - If it is under the budget by UPGRADE_RATIO for UPGRADE_EVALUATIONS evaluations in a row,
+					 one knob is raised by one level.
+				   After a knob changes, the window is cleared, so the next decision is only made from frames
+				   which ran with the new quality. The gap between the 2 ratios and the wait before raising a knob
+				   stop the governor from switching a knob back and forth.
+
+				   A knob is a setting with a number of levels, from 0 for the lowest quality to the highest level
+				   for the full quality, and a callback which applies a level. The knob with the highest quality,
+				   relative to its number of levels, is lowered first, and the knob with the lowest quality is raised
+				   first. Ties are broken by the order of registration, where the first knob is lowered first
+				   and raised last.
+
+				   The governor does not read the clock, so a sequence of frame times can be replayed without the game.
+ */
+class CQualityGovernor : public CSingletonTemplate<CQualityGovernor>
+{
+	friend CSingletonTemplate<CQualityGovernor>;
+public:
+	// The handle to a knob
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// The callback which applies a level of a knob
+	typedef std::function<void(const int iLevel)> APPLY_FUNCTION;
+
+	// A change of a knob
+	struct Decision
+	{
+		// The frame which the decision was made in
+		unsigned long long ullFrame;
+		// The knob which changed
+		HANDLE hKnob;
+		// The levels before and after the change
+		int iOldLevel;
+		int iNewLevel;
+		// The 95th percentile of the frame times, in seconds, which the decision was made from
+		double dPercentile95;
+	};
+
+	// Init, with the time budget of a frame in seconds. The knobs are kept, and the window and the decisions are cleared
+	bool Init(const double dTargetFrameTime);
+
+	// Add the time, in seconds, which a frame spent working, and make a decision if it is time for one
+	void AddFrameTime(const double dFrameTime);
+
+	// Register a knob, and apply its starting level. The knob starts at its highest level if iStartLevel is negative
+	HANDLE RegisterKnob(const std::string& strName,
+						const int iNumLevels,
+						const APPLY_FUNCTION& fnApply,
+						const int iStartLevel = -1);
+	// Unregister all the knobs, such as when the scene which owns their settings is destroyed.
+	// Each knob is set back to its highest level first, as its setting may outlive the scene
+	void ClearKnobs(void);
+
+	// Set the level of a knob, and apply it
+	void SetLevel(const HANDLE hKnob, const int iLevel);
+	// Get the level of a knob
+	int GetLevel(const HANDLE hKnob) const;
+	// Get the name of a knob
+	std::string GetName(const HANDLE hKnob) const;
+	// Get the number of knobs
+	unsigned int GetNumKnobs(void) const;
+
+	// Set if the knobs are changed by the governor. The knobs keep their levels when it is disabled
+	void SetEnabled(const bool bEnabled);
+	// Get if the knobs are changed by the governor
+	bool GetEnabled(void) const;
+
+	// Set the time budget of a frame, in seconds
+	void SetTargetFrameTime(const double dTargetFrameTime);
+	// Get the time budget of a frame, in seconds
+	double GetTargetFrameTime(void) const;
+
+	// Get a percentile, from 0 to 100, of the frame times in the window, in seconds
+	double GetPercentile(const double dPercentile) const;
+
+	// Get the decisions which were made since Init, from the oldest to the newest
+	const std::vector<Decision>& GetDecisions(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The number of frame times in the window
+	static const unsigned int WINDOW_SIZE = 120;
+	// The number of frame times which must be in the window before a decision is made
+	static const unsigned int MIN_SAMPLES = 60;
+	// The number of frames between the evaluations of the window
+	static const unsigned int EVALUATION_INTERVAL = 30;
+	// The number of evaluations in a row which must be under the budget before a knob is raised
+	static const unsigned int UPGRADE_EVALUATIONS = 4;
+	// The ratios of the budget which the 95th percentile must be over to lower a knob, or under to raise a knob
+	static const double DOWNGRADE_RATIO;
+	static const double UPGRADE_RATIO;
+	// The highest number of decisions which are kept
+	static const unsigned int MAX_DECISIONS = 256;
+
+	// A knob
+	struct Knob
+	{
+		std::string strName;
+		int iNumLevels;
+		int iLevel;
+		APPLY_FUNCTION fnApply;
+	};
+
+	// The knobs, in the order of their registration
+	std::vector<Knob> vKnobs;
+
+	// The frame times in the window, as a ring buffer
+	std::vector<double> vFrameTimes;
+	// The index which the next frame time is written to
+	unsigned int uiNextFrameTime;
+
+	// The number of frames since Init
+	unsigned long long ullNumFrames;
+	// The number of frames since the last evaluation
+	unsigned int uiFramesSinceEvaluation;
+	// The number of evaluations in a row which were under the budget
+	unsigned int uiNumUnderBudget;
+
+	// The time budget of a frame, in seconds
+	double dTargetFrameTime;
+
+	// Boolean flag to indicate if the knobs are changed by the governor
+	bool bEnabled;
+
+	// The decisions which were made since Init
+	std::vector<Decision> vDecisions;
+
+	// Scratch space for the percentiles
+	mutable std::vector<double> vSortedFrameTimes;
+
+	// Constructor
+	CQualityGovernor(void);
+
+	// Destructor
+	virtual ~CQualityGovernor(void);
+
+	// Evaluate the window, and lower or raise a knob if it is needed
+	void Evaluate(void);
+
+	// Change a knob by one level, record the decision and clear the window
+	void StepKnob(const HANDLE hKnob, const int iDelta, const double dPercentile95);
+
+	// Get the quality of a knob, from 0 to 1, relative to its number of levels
+	float GetQuality(const HANDLE hKnob) const;
+};
@@ -0,0 +1,524 @@
+/**
+ CTimerWheel
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TimerWheel.h"
+
+#include <iostream>
+using namespace std;
+
+// Include algorithm for sort, and climits for INT_MAX
+#include <algorithm>
+#include <climits>
+
+// Include rapidcsv to load the timers, and CSVWriter to save them
+#include "System/rapidcsv.h"
+#include "System\CSVWriter.h"
+#include "System\filesystem.h"
+
+// The constants which are used by reference
+const CTimerWheel::HANDLE CTimerWheel::INVALID_HANDLE;
+const int CTimerWheel::NO_SLOT;
+const int CTimerWheel::NO_TIMER;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CTimerWheel::CTimerWheel(void)
+	: dTickLength(0.01)
+	, dAccumulatedTime(0.0)
+	, ullCurrentTick(0)
+	, ullNextSequence(0)
+	, uiNumPending(0)
+	, bPaused(false)
+	, dTimeScale(1.0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CTimerWheel::~CTimerWheel(void)
+{
+}
+
+/**
+ @brief Init Initialise this instance. All the timers are removed
+ @param dTickLength A const double variable containing the length of a tick in seconds
+ */
+bool CTimerWheel::Init(const double dTickLength)
+{
+	if (dTickLength <= 0.0)
+	{
+		cout << "CTimerWheel::Init: The tick length must be more than 0" << endl;
+		return false;
+	}
+
+	this->dTickLength = dTickLength;
+	dAccumulatedTime = 0.0;
+	ullCurrentTick = 0;
+	ullNextSequence = 0;
+	uiNumPending = 0;
+	bPaused = false;
+	dTimeScale = 1.0;
+
+	vTimers.clear();
+	vFreeTimers.clear();
+	vFiringTimers.clear();
+	vSlotHeads.assign(NUM_LEVELS * NUM_SLOTS, NO_TIMER);
+	return true;
+}
+
+/**
+ @brief Advance the time, and fire the timers which expired
+ @param dElapsedTime A const double variable containing the elapsed time since the last frame
+ */
+void CTimerWheel::Update(const double dElapsedTime)
+{
+	if (bPaused)
+		return;
+
+	dAccumulatedTime += dElapsedTime * dTimeScale;
+
+	// Without pending timers there is nothing to fire or cascade, so skip the ticks
+	if (uiNumPending == 0)
+	{
+		const unsigned long long ullNumTicks = (unsigned long long)(dAccumulatedTime / dTickLength);
+		ullCurrentTick += ullNumTicks;
+		dAccumulatedTime -= ullNumTicks * dTickLength;
+		return;
+	}
+
+	while (dAccumulatedTime >= dTickLength)
+	{
+		dAccumulatedTime -= dTickLength;
+		Tick();
+	}
+}
+
+/**
+ @brief Schedule a timer
+ @param dDelay A const double variable containing the time in seconds until the timer fires. It fires on the next tick at the earliest
+ @param fnCallback A const CALLBACK_FUNCTION& variable containing the callback, which may be empty
+ @param dPeriod A const double variable containing the time in seconds between repeats, or 0 to fire once
+ @param uiTag A const unsigned int variable containing the tag which the timer is saved with, or 0 to not save it
+ @return The handle to the timer, or INVALID_HANDLE if there are too many timers
+ */
+CTimerWheel::HANDLE CTimerWheel::Schedule(	const double dDelay,
+											const CALLBACK_FUNCTION& fnCallback,
+											const double dPeriod,
+											const unsigned int uiTag)
+{
+	return ScheduleTicks(ToTicks(dDelay), fnCallback, (dPeriod > 0.0) ? ToTicks(dPeriod) : 0, uiTag);
+}
+
+/**
+ @brief Cancel a timer. A handle to a timer which has fired or was cancelled is ignored
+ @param hTimer A HANDLE& variable containing the handle, which is set to INVALID_HANDLE
+ */
+void CTimerWheel::Cancel(HANDLE& hTimer)
+{
+	const int iTimer = GetTimer(hTimer);
+	if (iTimer != NO_TIMER)
+	{
+		// A timer which is about to fire on this tick is not in a slot
+		if (vTimers[iTimer].iSlot != NO_SLOT)
+			Unlink(iTimer);
+		FreeTimer(iTimer);
+	}
+	hTimer = INVALID_HANDLE;
+}
+
+/**
+ @brief Check if a timer is still waiting to fire
+ */
+bool CTimerWheel::IsPending(const HANDLE hTimer) const
+{
+	return (GetTimer(hTimer) != NO_TIMER);
+}
+
+/**
+ @brief Get the time, in seconds, until a timer fires, or 0 if it is not pending
+ */
+double CTimerWheel::GetRemainingTime(const HANDLE hTimer) const
+{
+	const int iTimer = GetTimer(hTimer);
+	if (iTimer == NO_TIMER)
+		return 0.0;
+
+	const double dRemainingTime = (vTimers[iTimer].ullExpiryTick - ullCurrentTick) * dTickLength - dAccumulatedTime;
+	return (dRemainingTime > 0.0) ? dRemainingTime : 0.0;
+}
+
+/**
+ @brief Set if the time is paused
+ */
+void CTimerWheel::SetPaused(const bool bPaused)
+{
+	this->bPaused = bPaused;
+}
+
+/**
+ @brief Get if the time is paused
+ */
+bool CTimerWheel::GetPaused(void) const
+{
+	return bPaused;
+}
+
+/**
+ @brief Set the scale of the time, which is 1 for real time. Negative scales are clamped to 0
+ */
+void CTimerWheel::SetTimeScale(const double dTimeScale)
+{
+	this->dTimeScale = (dTimeScale > 0.0) ? dTimeScale : 0.0;
+}
+
+/**
+ @brief Get the scale of the time
+ */
+double CTimerWheel::GetTimeScale(void) const
+{
+	return dTimeScale;
+}
+
+/**
+ @brief Get the number of ticks since Init
+ */
+unsigned long long CTimerWheel::GetCurrentTick(void) const
+{
+	return ullCurrentTick;
+}
+
+/**
+ @brief Get the number of pending timers
+ */
+unsigned int CTimerWheel::GetNumPending(void) const
+{
+	return uiNumPending;
+}
+
+/**
+ @brief Register the callback which is given to the loaded timers with a tag
+ @param uiTag A const unsigned int variable containing the tag, which must not be 0
+ @param fnCallback A const CALLBACK_FUNCTION& variable containing the callback
+ */
+void CTimerWheel::RegisterCallback(const unsigned int uiTag, const CALLBACK_FUNCTION& fnCallback)
+{
+	if (uiTag == 0)
+		return;
+
+	if (uiTag >= vTagCallbacks.size())
+		vTagCallbacks.resize(uiTag + 1);
+	vTagCallbacks[uiTag] = fnCallback;
+}
+
+/**
+ @brief Save the pending timers with a non-zero tag to a CSV file, in the order they were scheduled.
+		The times are saved in ticks, relative to the current tick.
+ @param filename A const std::string& variable containing the name of the CSV file
+ @return true if the file was saved
+ */
+bool CTimerWheel::SaveState(const std::string& filename) const
+{
+	std::vector<int> vSavedTimers;
+	for (unsigned int i = 0; i < vTimers.size(); i++)
+	{
+		if ((vTimers[i].bAlive) && (vTimers[i].uiTag != 0))
+			vSavedTimers.push_back(i);
+	}
+	std::sort(vSavedTimers.begin(), vSavedTimers.end(), [this](const int iA, const int iB)
+		{
+			return vTimers[iA].ullSequence < vTimers[iB].ullSequence;
+		});
+
+	vector<pair<string, vector<int>>> vData(3);
+	vData[0].first = "Tag";
+	vData[1].first = "Remaining";
+	vData[2].first = "Period";
+	for (auto& iTimer : vSavedTimers)
+	{
+		const unsigned long long ullRemainingTicks = vTimers[iTimer].ullExpiryTick - ullCurrentTick;
+		vData[0].second.push_back((int)vTimers[iTimer].uiTag);
+		vData[1].second.push_back((int)std::min(ullRemainingTicks, (unsigned long long)INT_MAX));
+		vData[2].second.push_back((int)std::min(vTimers[iTimer].ullPeriodTicks, (unsigned long long)INT_MAX));
+	}
+
+	CCSVWriter cCSVWriter;
+	if (cCSVWriter.write_csv_with_columnname(FileSystem::getPath(filename), vData) == false)
+	{
+		cout << "CTimerWheel::SaveState: Unable to save " << filename << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief Load the timers from a CSV file, in addition to the pending timers.
+		Each timer is given the callback which was registered for its tag.
+ @param filename A const std::string& variable containing the name of the CSV file
+ @return true if the file was loaded
+ */
+bool CTimerWheel::LoadState(const std::string& filename)
+{
+	try
+	{
+		rapidcsv::Document doc(FileSystem::getPath(filename).c_str());
+
+		const unsigned int uiNumRows = (unsigned int)doc.GetRowCount();
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+		{
+			const unsigned int uiTag = doc.GetCell<unsigned int>("Tag", uiRow);
+			const int iRemainingTicks = doc.GetCell<int>("Remaining", uiRow);
+			const int iPeriodTicks = doc.GetCell<int>("Period", uiRow);
+
+			if ((uiTag >= vTagCallbacks.size()) || (!vTagCallbacks[uiTag]))
+			{
+				cout << "CTimerWheel::LoadState: No callback is registered for tag " << uiTag << endl;
+				continue;
+			}
+
+			ScheduleTicks(	(iRemainingTicks > 0) ? iRemainingTicks : 0, vTagCallbacks[uiTag],
+							(iPeriodTicks > 0) ? iPeriodTicks : 0, uiTag);
+		}
+	}
+	catch (exception& e)
+	{
+		cout << "CTimerWheel::LoadState: Unable to load " << filename << ": " << e.what() << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CTimerWheel::PrintSelf(void) const
+{
+	cout << "CTimerWheel::PrintSelf()" << endl;
+	cout << "Tick: " << ullCurrentTick << " (" << dTickLength << "s)"
+		<< ", Pending: " << uiNumPending
+		<< ", Paused: " << bPaused
+		<< ", Time scale: " << dTimeScale << endl;
+}
+
+/**
+ @brief Schedule a timer which fires after a number of ticks
+ @param ullDelayTicks A const unsigned long long variable containing the number of ticks. It is at least 1
+ @param fnCallback A const CALLBACK_FUNCTION& variable containing the callback, which may be empty
+ @param ullPeriodTicks A const unsigned long long variable containing the ticks between repeats, or 0 to fire once
+ @param uiTag A const unsigned int variable containing the tag which the timer is saved with
+ @return The handle to the timer, or INVALID_HANDLE if there are too many timers
+ */
+CTimerWheel::HANDLE CTimerWheel::ScheduleTicks(	const unsigned long long ullDelayTicks,
+												const CALLBACK_FUNCTION& fnCallback,
+												const unsigned long long ullPeriodTicks,
+												const unsigned int uiTag)
+{
+	int iTimer = NO_TIMER;
+	if (vFreeTimers.size() > 0)
+	{
+		iTimer = vFreeTimers.back();
+		vFreeTimers.pop_back();
+	}
+	else if (vTimers.size() < INDEX_MASK)
+	{
+		iTimer = (int)vTimers.size();
+		vTimers.push_back(Timer());
+		vTimers[iTimer].uiGeneration = 0;
+	}
+	else
+	{
+		cout << "CTimerWheel::Schedule: There are too many timers" << endl;
+		return INVALID_HANDLE;
+	}
+
+	Timer& sTimer = vTimers[iTimer];
+	sTimer.fnCallback = fnCallback;
+	sTimer.ullExpiryTick = ullCurrentTick + ((ullDelayTicks > 0) ? ullDelayTicks : 1);
+	sTimer.ullPeriodTicks = ullPeriodTicks;
+	sTimer.ullSequence = ullNextSequence++;
+	sTimer.uiTag = uiTag;
+	sTimer.iSlot = NO_SLOT;
+	sTimer.iPrev = NO_TIMER;
+	sTimer.iNext = NO_TIMER;
+	sTimer.bAlive = true;
+	Insert(iTimer);
+	uiNumPending++;
+
+	return (sTimer.uiGeneration << INDEX_BITS) | (HANDLE)iTimer;
+}
+
+/**
+ @brief Advance by one tick, and fire the timers which expire on it
+ */
+void CTimerWheel::Tick(void)
+{
+	ullCurrentTick++;
+
+	// Move the timers down from each level whose slot starts on this tick, from the highest level
+	for (unsigned int uiLevel = NUM_LEVELS - 1; uiLevel > 0; uiLevel--)
+	{
+		if ((ullCurrentTick & ((1ULL << (uiLevel * LEVEL_BITS)) - 1)) == 0)
+			Cascade(uiLevel);
+	}
+
+	// Take the timers out of the slot for this tick
+	const int iSlot = (int)(ullCurrentTick & (NUM_SLOTS - 1));
+	vFiringTimers.clear();
+	for (int iTimer = vSlotHeads[iSlot]; iTimer != NO_TIMER; iTimer = vTimers[iTimer].iNext)
+	{
+		vTimers[iTimer].iSlot = NO_SLOT;
+		vFiringTimers.push_back((vTimers[iTimer].uiGeneration << INDEX_BITS) | (HANDLE)iTimer);
+	}
+	vSlotHeads[iSlot] = NO_TIMER;
+	if (vFiringTimers.empty())
+		return;
+
+	// Fire them in the order they were scheduled
+	std::sort(vFiringTimers.begin(), vFiringTimers.end(), [this](const HANDLE hA, const HANDLE hB)
+		{
+			return vTimers[hA & INDEX_MASK].ullSequence < vTimers[hB & INDEX_MASK].ullSequence;
+		});
+
+	for (unsigned int i = 0; i < vFiringTimers.size(); i++)
+	{
+		// Skip the timers which were cancelled by an earlier callback
+		const int iTimer = GetTimer(vFiringTimers[i]);
+		if (iTimer == NO_TIMER)
+			continue;
+
+		// Copy the callback, as it may schedule timers and move the timers in memory
+		const CALLBACK_FUNCTION fnCallback = vTimers[iTimer].fnCallback;
+
+		// Reschedule or free the timer before its callback, so that the callback can cancel or check it
+		if (vTimers[iTimer].ullPeriodTicks > 0)
+		{
+			vTimers[iTimer].ullExpiryTick += vTimers[iTimer].ullPeriodTicks;
+			vTimers[iTimer].ullSequence = ullNextSequence++;
+			Insert(iTimer);
+		}
+		else
+		{
+			FreeTimer(iTimer);
+		}
+
+		if (fnCallback)
+			fnCallback();
+	}
+}
+
+/**
+ @brief Link a timer into the slot for its expiry tick, in the lowest level which can hold it
+ @param iTimer A const int variable containing the index of the timer
+ */
+void CTimerWheel::Insert(const int iTimer)
+{
+	Timer& sTimer = vTimers[iTimer];
+
+	// Timers beyond the highest level wait in its last slot, and are moved down when it is reached
+	const unsigned long long ullMaxDelay = (1ULL << (NUM_LEVELS * LEVEL_BITS)) - 1;
+	if (sTimer.ullExpiryTick < ullCurrentTick)
+		sTimer.ullExpiryTick = ullCurrentTick;
+	if (sTimer.ullExpiryTick - ullCurrentTick > ullMaxDelay)
+		sTimer.ullExpiryTick = ullCurrentTick + ullMaxDelay;
+
+	const unsigned long long ullDelay = sTimer.ullExpiryTick - ullCurrentTick;
+	unsigned int uiLevel = 0;
+	while ((uiLevel < NUM_LEVELS - 1) && (ullDelay >= (1ULL << ((uiLevel + 1) * LEVEL_BITS))))
+		uiLevel++;
+
+	const int iSlot = (int)(uiLevel * NUM_SLOTS + ((sTimer.ullExpiryTick >> (uiLevel * LEVEL_BITS)) & (NUM_SLOTS - 1)));
+	sTimer.iSlot = iSlot;
+	sTimer.iPrev = NO_TIMER;
+	sTimer.iNext = vSlotHeads[iSlot];
+	if (sTimer.iNext != NO_TIMER)
+		vTimers[sTimer.iNext].iPrev = iTimer;
+	vSlotHeads[iSlot] = iTimer;
+}
+
+/**
+ @brief Unlink a timer from its slot
+ @param iTimer A const int variable containing the index of the timer
+ */
+void CTimerWheel::Unlink(const int iTimer)
+{
+	Timer& sTimer = vTimers[iTimer];
+	if (sTimer.iPrev != NO_TIMER)
+		vTimers[sTimer.iPrev].iNext = sTimer.iNext;
+	else
+		vSlotHeads[sTimer.iSlot] = sTimer.iNext;
+	if (sTimer.iNext != NO_TIMER)
+		vTimers[sTimer.iNext].iPrev = sTimer.iPrev;
+
+	sTimer.iSlot = NO_SLOT;
+	sTimer.iPrev = NO_TIMER;
+	sTimer.iNext = NO_TIMER;
+}
+
+/**
+ @brief Move the timers in the current slot of a higher level into the lower levels
+ @param uiLevel A const unsigned int variable containing the level
+ */
+void CTimerWheel::Cascade(const unsigned int uiLevel)
+{
+	const int iSlot = (int)(uiLevel * NUM_SLOTS + ((ullCurrentTick >> (uiLevel * LEVEL_BITS)) & (NUM_SLOTS - 1)));
+
+	int iTimer = vSlotHeads[iSlot];
+	vSlotHeads[iSlot] = NO_TIMER;
+	while (iTimer != NO_TIMER)
+	{
+		const int iNext = vTimers[iTimer].iNext;
+		Insert(iTimer);
+		iTimer = iNext;
+	}
+}
+
+/**
+ @brief Free a timer, so that the handles to it become invalid
+ @param iTimer A const int variable containing the index of the timer
+ */
+void CTimerWheel::FreeTimer(const int iTimer)
+{
+	Timer& sTimer = vTimers[iTimer];
+	sTimer.bAlive = false;
+	sTimer.fnCallback = CALLBACK_FUNCTION();
+	// The generation never reaches the bits of INVALID_HANDLE
+	sTimer.uiGeneration = (sTimer.uiGeneration + 1) % ((INVALID_HANDLE >> INDEX_BITS) - 1);
+	vFreeTimers.push_back(iTimer);
+	uiNumPending--;
+}
+
+/**
+ @brief Get the timer of a handle
+ @param hTimer A const HANDLE variable containing the handle
+ @return The index of the timer, or NO_TIMER if the handle is not valid
+ */
+int CTimerWheel::GetTimer(const HANDLE hTimer) const
+{
+	if (hTimer == INVALID_HANDLE)
+		return NO_TIMER;
+
+	const unsigned int uiIndex = hTimer & INDEX_MASK;
+	if ((uiIndex >= vTimers.size()) ||
+		(!vTimers[uiIndex].bAlive) ||
+		(vTimers[uiIndex].uiGeneration != (hTimer >> INDEX_BITS)))
+		return NO_TIMER;
+
+	return (int)uiIndex;
+}
+
+/**
+ @brief Convert a time in seconds into ticks, rounded up
+ */
+unsigned long long CTimerWheel::ToTicks(const double dTime) const
+{
+	if (dTime <= 0.0)
+		return 0;
+
+	// Remove the rounding error of times which are a whole number of ticks
+	const double dTicks = dTime / dTickLength - 1e-6;
+	const unsigned long long ullTicks = (unsigned long long)dTicks;
+	return (dTicks > (double)ullTicks) ? ullTicks + 1 : ullTicks;
+}
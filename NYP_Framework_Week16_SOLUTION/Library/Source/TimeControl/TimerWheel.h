@@ -0,0 +1,177 @@
+/**
+ CTimerWheel
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include vector, string and function
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ CTimerWheel: Schedules callbacks and cooldowns which expire after a delay, with a hierarchical timing wheel.
+			  The time is counted in ticks of a fixed length. There are 4 levels of 256 slots each, where a slot
+			  in level 0 holds the timers which expire on one tick, and a slot in a higher level holds the timers
+			  which expire in a range of 256 times as many ticks. Scheduling and cancelling a timer is O(1),
+			  and a pending timer costs nothing until its slot is reached, when it either fires or is moved
+			  down a level.
+
+			  Timers which expire on the same tick fire in the order they were scheduled.
+			  A callback may schedule and cancel timers, including itself.
+			  The time can be paused and scaled, such as for a pause menu or slow motion.
+
+			  A timer with a non-zero tag can be saved to a CSV file and loaded back, where it is given
+			  the callback which was registered for its tag, since a callback cannot be saved.
+ */
+class CTimerWheel : public CSingletonTemplate<CTimerWheel>
+{
+	friend CSingletonTemplate<CTimerWheel>;
+public:
+	// The handle to a timer
+	typedef unsigned int HANDLE;
+	// An invalid handle
+	static const HANDLE INVALID_HANDLE = 0xFFFFFFFF;
+
+	// The callback of a timer
+	typedef std::function<void(void)> CALLBACK_FUNCTION;
+
+	// Init, with the length of a tick in seconds. All the timers are removed
+	bool Init(const double dTickLength = 0.01);
+
+	// Advance the time, and fire the timers which expired
+	void Update(const double dElapsedTime);
+
+	// Schedule a timer which fires after dDelay seconds, and then every dPeriod seconds if dPeriod is more than 0.
+	// The callback may be empty, for a cooldown which is only checked with IsPending
+	HANDLE Schedule(const double dDelay,
+					const CALLBACK_FUNCTION& fnCallback = CALLBACK_FUNCTION(),
+					const double dPeriod = 0.0,
+					const unsigned int uiTag = 0);
+
+	// Cancel a timer. A handle to a timer which has fired or was cancelled is ignored
+	void Cancel(HANDLE& hTimer);
+
+	// Check if a timer is still waiting to fire
+	bool IsPending(const HANDLE hTimer) const;
+
+	// Get the time, in seconds, until a timer fires, or 0 if it is not pending
+	double GetRemainingTime(const HANDLE hTimer) const;
+
+	// Set if the time is paused
+	void SetPaused(const bool bPaused);
+	// Get if the time is paused
+	bool GetPaused(void) const;
+
+	// Set the scale of the time, which is 1 for real time
+	void SetTimeScale(const double dTimeScale);
+	// Get the scale of the time
+	double GetTimeScale(void) const;
+
+	// Get the number of ticks since Init
+	unsigned long long GetCurrentTick(void) const;
+	// Get the number of pending timers
+	unsigned int GetNumPending(void) const;
+
+	// Register the callback which is given to the loaded timers with a tag
+	void RegisterCallback(const unsigned int uiTag, const CALLBACK_FUNCTION& fnCallback);
+
+	// Save the pending timers with a non-zero tag to a CSV file
+	bool SaveState(const std::string& filename) const;
+	// Load the timers from a CSV file, in addition to the pending timers
+	bool LoadState(const std::string& filename);
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The number of levels, and the number of bits and slots in each level
+	static const unsigned int NUM_LEVELS = 4;
+	static const unsigned int LEVEL_BITS = 8;
+	static const unsigned int NUM_SLOTS = 1 << LEVEL_BITS;
+	// The number of bits in a handle for the index of its timer. The other bits are its generation
+	static const unsigned int INDEX_BITS = 20;
+	static const unsigned int INDEX_MASK = (1 << INDEX_BITS) - 1;
+	// The slot of a timer which is not in a slot
+	static const int NO_SLOT = -1;
+	// The end of a list of timers
+	static const int NO_TIMER = -1;
+
+	// A timer, which is linked into the list of its slot
+	struct Timer
+	{
+		CALLBACK_FUNCTION fnCallback;
+		unsigned long long ullExpiryTick;
+		unsigned long long ullPeriodTicks;
+		// The order which the timer was scheduled in, so that timers on the same tick fire in order
+		unsigned long long ullSequence;
+		unsigned int uiTag;
+		unsigned int uiGeneration;
+		int iSlot;
+		int iPrev;
+		int iNext;
+		bool bAlive;
+	};
+
+	// The timers, and the indices of the free timers
+	std::vector<Timer> vTimers;
+	std::vector<int> vFreeTimers;
+
+	// The first timer in each slot, for NUM_LEVELS * NUM_SLOTS slots
+	std::vector<int> vSlotHeads;
+
+	// The timers which are firing on the current tick
+	std::vector<HANDLE> vFiringTimers;
+
+	// The callbacks for the tags of loaded timers
+	std::vector<CALLBACK_FUNCTION> vTagCallbacks;
+
+	// The length of a tick in seconds, and the time which has not been counted as a tick yet
+	double dTickLength;
+	double dAccumulatedTime;
+	// The number of ticks since Init
+	unsigned long long ullCurrentTick;
+	// The number of timers which were scheduled since Init
+	unsigned long long ullNextSequence;
+	// The number of pending timers
+	unsigned int uiNumPending;
+
+	// Pause and time scale
+	bool bPaused;
+	double dTimeScale;
+
+	// Constructor
+	CTimerWheel(void);
+
+	// Destructor
+	virtual ~CTimerWheel(void);
+
+	// Schedule a timer which fires after a number of ticks
+	HANDLE ScheduleTicks(const unsigned long long ullDelayTicks,
+						 const CALLBACK_FUNCTION& fnCallback,
+						 const unsigned long long ullPeriodTicks,
+						 const unsigned int uiTag);
+
+	// Advance by one tick, and fire the timers which expire on it
+	void Tick(void);
+
+	// Link a timer into the slot for its expiry tick
+	void Insert(const int iTimer);
+	// Unlink a timer from its slot
+	void Unlink(const int iTimer);
+	// Move the timers in a slot of a higher level into the lower levels
+	void Cascade(const unsigned int uiLevel);
+
+	// Free a timer, so that the handles to it become invalid
+	void FreeTimer(const int iTimer);
+
+	// Get the timer of a handle, or NO_TIMER if the handle is not valid
+	int GetTimer(const HANDLE hTimer) const;
+
+	// Convert a time in seconds into ticks, rounded up
+	unsigned long long ToTicks(const double dTime) const;
+};
@@ -0,0 +1,567 @@
+/**
+ CGLStub
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "GLStub.h"
+
+// Include GLFW, whose functions which load the newer OpenGL functions are stubbed
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CGLStub::CGLStub(void)
+	: iMajorVersion(3)
+	, iMinorVersion(3)
+	, ullNumIndicesDrawn(0)
+	, uiFenceTimeouts(0)
+	, iUnpackAlignment(4)
+	, uiNumCalls(0)
+	, uiNextName(1)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CGLStub::~CGLStub(void)
+{
+}
+
+/**
+ @brief Clear the counts of the calls and the state
+ */
+void CGLStub::Reset(void)
+{
+	vActiveUniforms.clear();
+	mapUniformValues.clear();
+	iMajorVersion = 3;
+	iMinorVersion = 3;
+	mapBufferData.clear();
+	mapBoundBuffers.clear();
+	uiFenceTimeouts = 0;
+	mapFences.clear();
+	iUnpackAlignment = 4;
+	vTexImageAlignments.clear();
+	vDeletedTextures.clear();
+	uiNextName = 1;
+	ResetCounts();
+}
+
+/**
+ @brief Clear the counts of the calls and of the indices drawn, and keep the state
+ */
+void CGLStub::ResetCounts(void)
+{
+	ullNumIndicesDrawn = 0;
+	mapNumCalls.clear();
+	uiNumCalls = 0;
+}
+
+/**
+ @brief Count a call of an OpenGL function
+ @param cFunction A const char* variable containing the name of the function
+ */
+void CGLStub::Record(const char* cFunction)
+{
+	mapNumCalls[cFunction]++;
+	uiNumCalls++;
+}
+
+/**
+ @brief Get the number of calls of an OpenGL function since the last reset
+ @param strFunction A const std::string& variable containing the name of the function
+ */
+unsigned int CGLStub::GetNumCalls(const std::string& strFunction) const
+{
+	std::map<std::string, unsigned int>::const_iterator it = mapNumCalls.find(strFunction);
+	return (it == mapNumCalls.end()) ? 0 : it->second;
+}
+
+/**
+ @brief Get the number of calls of all the OpenGL functions since the last reset
+ */
+unsigned int CGLStub::GetNumCalls(void) const
+{
+	return uiNumCalls;
+}
+
+/**
+ @brief Get a name for a new object
+ */
+GLuint CGLStub::GenName(void)
+{
+	return uiNextName++;
+}
+
+/**
+ @brief Get the location of a uniform in vActiveUniforms, or -1 if a linked program does not have it
+ @param strName A const std::string& variable containing the name of the uniform
+ */
+GLint CGLStub::GetUniformLocation(const std::string& strName) const
+{
+	for (unsigned int i = 0; i < vActiveUniforms.size(); i++)
+	{
+		// An array is listed by its first element, and can be found by the name of the array
+		if ((vActiveUniforms[i] == strName) || (vActiveUniforms[i] == strName + "[0]"))
+			return (GLint)i;
+	}
+	return -1;
+}
+
+// Count a call of the OpenGL function which is being stubbed
+#define GL_STUB_RECORD(name) CGLStub::GetInstance()->Record(name)
+
+/**
+ The OpenGL 1.1 functions, which are exported by opengl32
+ */
+extern "C"
+{
+void GLAPIENTRY glBindTexture(GLenum, GLuint)
+{
+	GL_STUB_RECORD("glBindTexture");
+}
+
+void GLAPIENTRY glBlendFunc(GLenum, GLenum)
+{
+	GL_STUB_RECORD("glBlendFunc");
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+	GL_STUB_RECORD("glDeleteTextures");
+	for (GLsizei i = 0; i < n; i++)
+		CGLStub::GetInstance()->vDeletedTextures.push_back(textures[i]);
+}
+
+void GLAPIENTRY glDepthFunc(GLenum)
+{
+	GL_STUB_RECORD("glDepthFunc");
+}
+
+void GLAPIENTRY glDisable(GLenum)
+{
+	GL_STUB_RECORD("glDisable");
+}
+
+void GLAPIENTRY glDrawElements(GLenum, GLsizei count, GLenum, const void*)
+{
+	GL_STUB_RECORD("glDrawElements");
+	CGLStub::GetInstance()->ullNumIndicesDrawn += count;
+}
+
+void GLAPIENTRY glEnable(GLenum)
+{
+	GL_STUB_RECORD("glEnable");
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+	GL_STUB_RECORD("glGetIntegerv");
+	if (pname == GL_MAJOR_VERSION)
+		*params = CGLStub::GetInstance()->iMajorVersion;
+	else if (pname == GL_MINOR_VERSION)
+		*params = CGLStub::GetInstance()->iMinorVersion;
+	else
+		*params = 0;
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+	GL_STUB_RECORD("glGenTextures");
+	for (GLsizei i = 0; i < n; i++)
+		textures[i] = CGLStub::GetInstance()->GenName();
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+	GL_STUB_RECORD("glPixelStorei");
+	if (pname == GL_UNPACK_ALIGNMENT)
+		CGLStub::GetInstance()->iUnpackAlignment = param;
+}
+
+void GLAPIENTRY glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*)
+{
+	GL_STUB_RECORD("glTexImage2D");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->vTexImageAlignments.push_back(cGLStub->iUnpackAlignment);
+}
+
+void GLAPIENTRY glTexParameteri(GLenum, GLenum, GLint)
+{
+	GL_STUB_RECORD("glTexParameteri");
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*)
+{
+	GL_STUB_RECORD("glTexSubImage2D");
+}
+
+void GLAPIENTRY glViewport(GLint, GLint, GLsizei, GLsizei)
+{
+	GL_STUB_RECORD("glViewport");
+}
+}
+
+/**
+ The functions which GLEW loads from the driver. GLEW calls them through its function pointers, which point to these
+ */
+static void GLAPIENTRY StubActiveTexture(GLenum)
+{
+	GL_STUB_RECORD("glActiveTexture");
+}
+
+static void GLAPIENTRY StubAttachShader(GLuint, GLuint)
+{
+	GL_STUB_RECORD("glAttachShader");
+}
+
+static void GLAPIENTRY StubBindBuffer(GLenum target, GLuint buffer)
+{
+	GL_STUB_RECORD("glBindBuffer");
+	CGLStub::GetInstance()->mapBoundBuffers[target] = buffer;
+}
+
+static void GLAPIENTRY StubBindVertexArray(GLuint)
+{
+	GL_STUB_RECORD("glBindVertexArray");
+}
+
+static void GLAPIENTRY StubBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum)
+{
+	GL_STUB_RECORD("glBufferData");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	std::vector<unsigned char>& vBufferData = cGLStub->mapBufferData[cGLStub->mapBoundBuffers[target]];
+	vBufferData.assign((size_t)size, 0);
+	if (data)
+		memcpy(vBufferData.data(), data, (size_t)size);
+}
+
+static void GLAPIENTRY StubBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield)
+{
+	GL_STUB_RECORD("glBufferStorage");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	std::vector<unsigned char>& vBufferData = cGLStub->mapBufferData[cGLStub->mapBoundBuffers[target]];
+	vBufferData.assign((size_t)size, 0);
+	if (data)
+		memcpy(vBufferData.data(), data, (size_t)size);
+}
+
+static GLenum GLAPIENTRY StubClientWaitSync(GLsync sync, GLbitfield, GLuint64)
+{
+	GL_STUB_RECORD("glClientWaitSync");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	std::map<GLsync, unsigned int>::iterator it = cGLStub->mapFences.find(sync);
+	if (it == cGLStub->mapFences.end())
+		return GL_WAIT_FAILED;
+	if (it->second < cGLStub->uiFenceTimeouts)
+	{
+		it->second++;
+		return GL_TIMEOUT_EXPIRED;
+	}
+	return (it->second == 0) ? GL_ALREADY_SIGNALED : GL_CONDITION_SATISFIED;
+}
+
+static void GLAPIENTRY StubCompileShader(GLuint)
+{
+	GL_STUB_RECORD("glCompileShader");
+}
+
+static GLuint GLAPIENTRY StubCreateProgram(void)
+{
+	GL_STUB_RECORD("glCreateProgram");
+	return CGLStub::GetInstance()->GenName();
+}
+
+static GLuint GLAPIENTRY StubCreateShader(GLenum)
+{
+	GL_STUB_RECORD("glCreateShader");
+	return CGLStub::GetInstance()->GenName();
+}
+
+static void GLAPIENTRY StubDeleteBuffers(GLsizei, const GLuint*)
+{
+	GL_STUB_RECORD("glDeleteBuffers");
+}
+
+static void GLAPIENTRY StubDeleteProgram(GLuint)
+{
+	GL_STUB_RECORD("glDeleteProgram");
+}
+
+static void GLAPIENTRY StubDeleteShader(GLuint)
+{
+	GL_STUB_RECORD("glDeleteShader");
+}
+
+static void GLAPIENTRY StubDeleteSync(GLsync sync)
+{
+	GL_STUB_RECORD("glDeleteSync");
+	CGLStub::GetInstance()->mapFences.erase(sync);
+}
+
+static void GLAPIENTRY StubDeleteVertexArrays(GLsizei, const GLuint*)
+{
+	GL_STUB_RECORD("glDeleteVertexArrays");
+}
+
+static void GLAPIENTRY StubDisableVertexAttribArray(GLuint)
+{
+	GL_STUB_RECORD("glDisableVertexAttribArray");
+}
+
+static void GLAPIENTRY StubDrawElementsBaseVertex(GLenum, GLsizei count, GLenum, void*, GLint)
+{
+	GL_STUB_RECORD("glDrawElementsBaseVertex");
+	CGLStub::GetInstance()->ullNumIndicesDrawn += count;
+}
+
+static void GLAPIENTRY StubEnableVertexAttribArray(GLuint)
+{
+	GL_STUB_RECORD("glEnableVertexAttribArray");
+}
+
+static GLsync GLAPIENTRY StubFenceSync(GLenum, GLbitfield)
+{
+	GL_STUB_RECORD("glFenceSync");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	GLsync sync = (GLsync)(size_t)cGLStub->GenName();
+	cGLStub->mapFences[sync] = 0;
+	return sync;
+}
+
+static void GLAPIENTRY StubGenBuffers(GLsizei n, GLuint* buffers)
+{
+	GL_STUB_RECORD("glGenBuffers");
+	for (GLsizei i = 0; i < n; i++)
+		buffers[i] = CGLStub::GetInstance()->GenName();
+}
+
+static void GLAPIENTRY StubGenerateMipmap(GLenum)
+{
+	GL_STUB_RECORD("glGenerateMipmap");
+}
+
+static void GLAPIENTRY StubGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+	GL_STUB_RECORD("glGenVertexArrays");
+	for (GLsizei i = 0; i < n; i++)
+		arrays[i] = CGLStub::GetInstance()->GenName();
+}
+
+static void GLAPIENTRY StubGetActiveUniform(GLuint, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size,
+											GLenum* type, GLchar* name)
+{
+	GL_STUB_RECORD("glGetActiveUniform");
+	const std::string& strName = CGLStub::GetInstance()->vActiveUniforms[index];
+	const GLsizei iLength = ((GLsizei)strName.size() < bufSize) ? (GLsizei)strName.size() : bufSize - 1;
+	memcpy(name, strName.c_str(), iLength);
+	name[iLength] = '\0';
+	if (length)
+		*length = iLength;
+	*size = 1;
+	*type = GL_FLOAT;
+}
+
+static void GLAPIENTRY StubGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	GL_STUB_RECORD("glGetProgramInfoLog");
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+	if (length)
+		*length = 0;
+}
+
+static void GLAPIENTRY StubGetProgramiv(GLuint, GLenum pname, GLint* param)
+{
+	GL_STUB_RECORD("glGetProgramiv");
+	const std::vector<std::string>& vActiveUniforms = CGLStub::GetInstance()->vActiveUniforms;
+	if (pname == GL_ACTIVE_UNIFORMS)
+	{
+		*param = (GLint)vActiveUniforms.size();
+	}
+	else if (pname == GL_ACTIVE_UNIFORM_MAX_LENGTH)
+	{
+		*param = 1;
+		for (auto& name : vActiveUniforms)
+			*param = ((GLint)name.size() + 1 > *param) ? (GLint)name.size() + 1 : *param;
+	}
+	else
+	{
+		*param = GL_TRUE;
+	}
+}
+
+static void GLAPIENTRY StubGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+	GL_STUB_RECORD("glGetShaderInfoLog");
+	if (bufSize > 0)
+		infoLog[0] = '\0';
+	if (length)
+		*length = 0;
+}
+
+static void GLAPIENTRY StubGetShaderiv(GLuint, GLenum, GLint* param)
+{
+	GL_STUB_RECORD("glGetShaderiv");
+	*param = GL_TRUE;
+}
+
+static GLint GLAPIENTRY StubGetUniformLocation(GLuint, const GLchar* name)
+{
+	GL_STUB_RECORD("glGetUniformLocation");
+	return CGLStub::GetInstance()->GetUniformLocation(name);
+}
+
+static void GLAPIENTRY StubLinkProgram(GLuint)
+{
+	GL_STUB_RECORD("glLinkProgram");
+}
+
+static void* GLAPIENTRY StubMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+	GL_STUB_RECORD("glMapBufferRange");
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	std::vector<unsigned char>& vBufferData = cGLStub->mapBufferData[cGLStub->mapBoundBuffers[target]];
+	if ((offset < 0) || (length <= 0) || ((size_t)(offset + length) > vBufferData.size()))
+		return NULL;
+	return vBufferData.data() + offset;
+}
+
+static void GLAPIENTRY StubShaderSource(GLuint, GLsizei, const GLchar**, const GLint*)
+{
+	GL_STUB_RECORD("glShaderSource");
+}
+
+static void GLAPIENTRY StubUniform1f(GLint location, GLfloat v0)
+{
+	GL_STUB_RECORD("glUniform1f");
+	CGLStub::GetInstance()->mapUniformValues[location] = v0;
+}
+
+static void GLAPIENTRY StubUniform1i(GLint location, GLint v0)
+{
+	GL_STUB_RECORD("glUniform1i");
+	CGLStub::GetInstance()->mapUniformValues[location] = (float)v0;
+}
+
+static void GLAPIENTRY StubUniform2fv(GLint location, GLsizei, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniform2fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static void GLAPIENTRY StubUniform3fv(GLint location, GLsizei, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniform3fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static void GLAPIENTRY StubUniform4fv(GLint location, GLsizei, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniform4fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static void GLAPIENTRY StubUniformMatrix2fv(GLint location, GLsizei, GLboolean, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniformMatrix2fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static void GLAPIENTRY StubUniformMatrix3fv(GLint location, GLsizei, GLboolean, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniformMatrix3fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static void GLAPIENTRY StubUniformMatrix4fv(GLint location, GLsizei, GLboolean, const GLfloat* value)
+{
+	GL_STUB_RECORD("glUniformMatrix4fv");
+	CGLStub::GetInstance()->mapUniformValues[location] = value[0];
+}
+
+static GLboolean GLAPIENTRY StubUnmapBuffer(GLenum)
+{
+	GL_STUB_RECORD("glUnmapBuffer");
+	return GL_TRUE;
+}
+
+static void GLAPIENTRY StubUseProgram(GLuint)
+{
+	GL_STUB_RECORD("glUseProgram");
+}
+
+static void GLAPIENTRY StubVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*)
+{
+	GL_STUB_RECORD("glVertexAttribPointer");
+}
+
+extern "C"
+{
+PFNGLACTIVETEXTUREPROC __glewActiveTexture = StubActiveTexture;
+PFNGLATTACHSHADERPROC __glewAttachShader = StubAttachShader;
+PFNGLBINDBUFFERPROC __glewBindBuffer = StubBindBuffer;
+PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = StubBindVertexArray;
+PFNGLBUFFERDATAPROC __glewBufferData = StubBufferData;
+PFNGLCLIENTWAITSYNCPROC __glewClientWaitSync = StubClientWaitSync;
+PFNGLCOMPILESHADERPROC __glewCompileShader = StubCompileShader;
+PFNGLCREATEPROGRAMPROC __glewCreateProgram = StubCreateProgram;
+PFNGLCREATESHADERPROC __glewCreateShader = StubCreateShader;
+PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = StubDeleteBuffers;
+PFNGLDELETEPROGRAMPROC __glewDeleteProgram = StubDeleteProgram;
+PFNGLDELETESHADERPROC __glewDeleteShader = StubDeleteShader;
+PFNGLDELETESYNCPROC __glewDeleteSync = StubDeleteSync;
+PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = StubDeleteVertexArrays;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC __glewDisableVertexAttribArray = StubDisableVertexAttribArray;
+PFNGLDRAWELEMENTSBASEVERTEXPROC __glewDrawElementsBaseVertex = StubDrawElementsBaseVertex;
+PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = StubEnableVertexAttribArray;
+PFNGLFENCESYNCPROC __glewFenceSync = StubFenceSync;
+PFNGLGENBUFFERSPROC __glewGenBuffers = StubGenBuffers;
+PFNGLGENERATEMIPMAPPROC __glewGenerateMipmap = StubGenerateMipmap;
+PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = StubGenVertexArrays;
+PFNGLGETACTIVEUNIFORMPROC __glewGetActiveUniform = StubGetActiveUniform;
+PFNGLGETPROGRAMINFOLOGPROC __glewGetProgramInfoLog = StubGetProgramInfoLog;
+PFNGLGETPROGRAMIVPROC __glewGetProgramiv = StubGetProgramiv;
+PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog = StubGetShaderInfoLog;
+PFNGLGETSHADERIVPROC __glewGetShaderiv = StubGetShaderiv;
+PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation = StubGetUniformLocation;
+PFNGLLINKPROGRAMPROC __glewLinkProgram = StubLinkProgram;
+PFNGLMAPBUFFERRANGEPROC __glewMapBufferRange = StubMapBufferRange;
+PFNGLSHADERSOURCEPROC __glewShaderSource = StubShaderSource;
+PFNGLUNIFORM1FPROC __glewUniform1f = StubUniform1f;
+PFNGLUNIFORM1IPROC __glewUniform1i = StubUniform1i;
+PFNGLUNIFORM2FVPROC __glewUniform2fv = StubUniform2fv;
+PFNGLUNIFORM3FVPROC __glewUniform3fv = StubUniform3fv;
+PFNGLUNIFORM4FVPROC __glewUniform4fv = StubUniform4fv;
+PFNGLUNIFORMMATRIX2FVPROC __glewUniformMatrix2fv = StubUniformMatrix2fv;
+PFNGLUNIFORMMATRIX3FVPROC __glewUniformMatrix3fv = StubUniformMatrix3fv;
+PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv = StubUniformMatrix4fv;
+PFNGLUNMAPBUFFERPROC __glewUnmapBuffer = StubUnmapBuffer;
+PFNGLUSEPROGRAMPROC __glewUseProgram = StubUseProgram;
+PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = StubVertexAttribPointer;
+}
+
+/**
+ The GLFW functions which load the newer OpenGL functions. No extension is supported, and only glBufferStorage,
+ which is newer than the GLEW in this project, is found. It is only looked for if the version of OpenGL has it
+ */
+extern "C"
+{
+int glfwExtensionSupported(const char*)
+{
+	GL_STUB_RECORD("glfwExtensionSupported");
+	return GLFW_FALSE;
+}
+
+GLFWglproc glfwGetProcAddress(const char* procname)
+{
+	GL_STUB_RECORD("glfwGetProcAddress");
+	if (strcmp(procname, "glBufferStorage") == 0)
+		return (GLFWglproc)StubBufferStorage;
+	return NULL;
+}
+}
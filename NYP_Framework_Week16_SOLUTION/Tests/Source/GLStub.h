@@ -0,0 +1,98 @@
+/**
+ CGLStub
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW. The test target defines GLEW_STATIC and includes GLEW in every file, so the stubs replace GLEW
+#include <GL/glew.h>
+
+// Include string, vector and map
+#include <string>
+#include <vector>
+#include <map>
+
+/**
+ CGLStub: Stands in for the OpenGL driver in the console test target, so that the code which calls OpenGL can be
+		  tested without a window or a context. Each OpenGL function which the units under test call is defined
+		  in GLStub.cpp, and it counts its call here. The stubs give new objects the names 1, 2, 3 and so on.
+
+		  Only the state which the tests check is kept. A program which is linked has the uniforms in
+		  vActiveUniforms, and the location of each uniform is its index in it. The first component of
+		  the last value which was uploaded to each location is kept in mapUniformValues.
+		  glGetIntegerv gives iMajorVersion and iMinorVersion as the version of OpenGL, which is 3.3 after
+		  a reset. The storage of each buffer is kept in mapBufferData, which glBufferData resizes and
+		  glMapBufferRange maps for the buffer bound to the target, and the number of indices of the draw
+		  calls is kept in ullNumIndicesDrawn.
+		  The GLFW functions which load the newer OpenGL functions are stubbed too, and only find glBufferStorage.
+		  A fence times out uiFenceTimeouts times before it is signalled, and the fences which were not
+		  deleted yet are kept in mapFences.
+		  The unpack alignment is kept in iUnpackAlignment, which is 4 after a reset, and glTexImage2D keeps
+		  the alignment which each texture was uploaded with in vTexImageAlignments. The textures which
+		  were deleted are kept in vDeletedTextures, in the order which they were deleted.
+ */
+class CGLStub : public CSingletonTemplate<CGLStub>
+{
+	friend CSingletonTemplate<CGLStub>;
+public:
+	// The uniforms which a linked program has
+	std::vector<std::string> vActiveUniforms;
+	// The first component of the last value which was uploaded to each location of a uniform
+	std::map<GLint, float> mapUniformValues;
+	// The version of OpenGL
+	GLint iMajorVersion;
+	GLint iMinorVersion;
+	// The storage of each buffer, and the buffer bound to each target
+	std::map<GLuint, std::vector<unsigned char> > mapBufferData;
+	std::map<GLenum, GLuint> mapBoundBuffers;
+	// The number of indices which were drawn
+	unsigned long long ullNumIndicesDrawn;
+	// The number of times which a wait for a fence times out before the fence is signalled
+	unsigned int uiFenceTimeouts;
+	// The fences which were not deleted, and the number of times which each of them timed out
+	std::map<GLsync, unsigned int> mapFences;
+	// The unpack alignment, and the unpack alignment of each texture which was uploaded
+	GLint iUnpackAlignment;
+	std::vector<GLint> vTexImageAlignments;
+	// The textures which were deleted
+	std::vector<GLuint> vDeletedTextures;
+
+	// Clear the counts of the calls and the state
+	void Reset(void);
+
+	// Clear the counts of the calls and of the indices drawn, and keep the state
+	void ResetCounts(void);
+
+	// Count a call of an OpenGL function
+	void Record(const char* cFunction);
+
+	// Get the number of calls of an OpenGL function since the last reset
+	unsigned int GetNumCalls(const std::string& strFunction) const;
+
+	// Get the number of calls of all the OpenGL functions since the last reset
+	unsigned int GetNumCalls(void) const;
+
+	// Get a name for a new object
+	GLuint GenName(void);
+
+	// Get the location of a uniform in vActiveUniforms, or -1 if a linked program does not have it
+	GLint GetUniformLocation(const std::string& strName) const;
+
+protected:
+	// The number of calls of each OpenGL function, and of all of them
+	std::map<std::string, unsigned int> mapNumCalls;
+	unsigned int uiNumCalls;
+
+	// The name of the next object
+	GLuint uiNextName;
+
+	// Constructor
+	CGLStub(void);
+
+	// Destructor
+	virtual ~CGLStub(void);
+};
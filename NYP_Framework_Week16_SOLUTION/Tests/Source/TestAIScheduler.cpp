@@ -0,0 +1,446 @@
+/**
+ Tests of CAIScheduler2D, on a map of tiles without textures
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include AIScheduler2D
+#include "Scene2D\AIScheduler2D.h"
+// Include Map2D
+#include "Scene2D\Map2D.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+// The values of the tiles in the tests
+static const unsigned int TILE_EMPTY = 0;
+static const unsigned int TILE_BLOCK = 100;
+
+// The frame length of the tests, which is exact in binary
+static const double FRAME_TIME = 1.0 / 64.0;
+
+/**
+ A map with 1 level, which is created without loading its textures, so that paths can be found without OpenGL
+ */
+class CTestMap2D : public CMap2D
+{
+public:
+	CTestMap2D(const unsigned int uiNumCols, const unsigned int uiNumRows)
+	{
+		// The map sizes are stored in cSettings, so keep the previous sizes to restore them
+		cSettings = CSettings::GetInstance();
+		uiPrevNumCols = cSettings->NUM_TILES_XAXIS;
+		uiPrevNumRows = cSettings->NUM_TILES_YAXIS;
+		cSettings->NUM_TILES_XAXIS = uiNumCols;
+		cSettings->NUM_TILES_YAXIS = uiNumRows;
+		cSettings->UpdateSpecifications();
+
+		uiCurLevel = 0;
+		uiNumLevels = 1;
+		arrMapInfo = new Grid**[1];
+		arrMapInfo[0] = new Grid*[uiNumRows];
+		for (unsigned int uiRow = 0; uiRow < uiNumRows; uiRow++)
+			arrMapInfo[0][uiRow] = new Grid[uiNumCols];
+
+		// Initialise the variables for AStar, as Init does
+		m_weight = 1;
+		m_nrOfDirections = 4;
+		m_directions = { { -1, 0 }, { 1, 0 }, { 0, 1 }, { 0, -1 },
+						 { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 } };
+		m_cameFromList.resize(uiNumRows * uiNumCols);
+		m_closedList.resize(uiNumRows * uiNumCols, false);
+	}
+
+	virtual ~CTestMap2D(void)
+	{
+		// Delete the tiles here, before the sizes in cSettings are restored
+		for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
+			delete[] arrMapInfo[0][uiRow];
+		delete[] arrMapInfo[0];
+		delete[] arrMapInfo;
+		uiNumLevels = 0;
+		arrMapInfo = NULL;
+
+		cSettings->NUM_TILES_XAXIS = uiPrevNumCols;
+		cSettings->NUM_TILES_YAXIS = uiPrevNumRows;
+		cSettings->UpdateSpecifications();
+	}
+
+	// Set the value of a tile. The row is from bottom to top, as the entities use
+	void SetTile(const int iCol, const int iRow, const unsigned int uiValue)
+	{
+		arrMapInfo[0][cSettings->NUM_TILES_YAXIS - iRow - 1][iCol].value = uiValue;
+	}
+
+	// Set the value of the tiles in a column, from a row to another row
+	void SetColumn(const int iCol, const int iFromRow, const int iToRow, const unsigned int uiValue)
+	{
+		for (int iRow = iFromRow; iRow <= iToRow; iRow++)
+			SetTile(iCol, iRow, uiValue);
+	}
+
+protected:
+	unsigned int uiPrevNumCols;
+	unsigned int uiPrevNumRows;
+};
+
+/**
+ An AI scheduler which is not the singleton, and finds its paths in a test map
+ */
+class CTestAIScheduler2D : public CAIScheduler2D
+{
+public:
+	CTestAIScheduler2D(CMap2D* cMap2D)
+	{
+		this->cMap2D = cMap2D;
+	}
+
+	virtual ~CTestAIScheduler2D(void)
+	{
+	}
+};
+
+/**
+ @brief Count the number of times an agent thinks, and its total think time, over a number of frames
+ */
+static int CountThinks(CAIScheduler2D& cAIScheduler2D, const CAIScheduler2D::HANDLE hAgent, const glm::i32vec2& i32vec2AgentIndex,
+					   const int iNumFrames, double& dTotalThinkTime)
+{
+	int iNumThinks = 0;
+	dTotalThinkTime = 0.0;
+	for (int iFrame = 0; iFrame < iNumFrames; iFrame++)
+	{
+		double dThinkTime = 0.0;
+		if (cAIScheduler2D.Tick(hAgent, i32vec2AgentIndex, FRAME_TIME, dThinkTime))
+		{
+			iNumThinks++;
+			dTotalThinkTime += dThinkTime;
+		}
+	}
+	return iNumThinks;
+}
+
+/**
+ @brief The band of an agent depends on its distance to the player, and moves up by 1 band if it can see the player
+ */
+static void TestLevelOfDetail(void)
+{
+	CTestMap2D cMap2D(64, 8);
+	CTestAIScheduler2D cAIScheduler2D(&cMap2D);
+	const CAIScheduler2D::HANDLE hAgent = cAIScheduler2D.RegisterAgent();
+	TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == CAIScheduler2D::LOD_FAR);
+
+	const glm::i32vec2 i32vec2Player(2, 2);
+	cAIScheduler2D.Update(i32vec2Player);
+	double dThinkTime = 0.0;
+	const glm::i32vec2 arrPositions[3] = { glm::i32vec2(5, 2), glm::i32vec2(14, 2), glm::i32vec2(40, 2) };
+	const CAIScheduler2D::LOD_BAND arrVisibleBands[3] = { CAIScheduler2D::LOD_NEAR, CAIScheduler2D::LOD_NEAR, CAIScheduler2D::LOD_MID };
+	const CAIScheduler2D::LOD_BAND arrHiddenBands[3] = { CAIScheduler2D::LOD_NEAR, CAIScheduler2D::LOD_MID, CAIScheduler2D::LOD_FAR };
+	for (int i = 0; i < 3; i++)
+	{
+		cAIScheduler2D.Tick(hAgent, arrPositions[i], FRAME_TIME, dThinkTime);
+		TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == arrVisibleBands[i]);
+	}
+
+	// A wall between the player and the agents hides the agents which are not near
+	cMap2D.SetColumn(4, 0, 7, TILE_BLOCK);
+	for (int i = 0; i < 3; i++)
+	{
+		cAIScheduler2D.Tick(hAgent, arrPositions[i], FRAME_TIME, dThinkTime);
+		TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == arrHiddenBands[i]);
+	}
+}
+
+/**
+ @brief An agent thinks at the rate of its band, and its think times add up to the time which has passed
+ */
+static void TestTickRate(void)
+{
+	CTestMap2D cMap2D(64, 8);
+	CTestAIScheduler2D cAIScheduler2D(&cMap2D);
+	cAIScheduler2D.Update(glm::i32vec2(2, 2));
+	CAIScheduler2D::HANDLE hAgent = cAIScheduler2D.RegisterAgent();
+
+	// 10 seconds in each band. An agent which thinks every frame thinks for all of the time
+	const int NUM_FRAMES = 640;
+	double dTotalThinkTime = 0.0;
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(5, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES);
+	TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == CAIScheduler2D::LOD_NEAR);
+	TEST_CHECK(dTotalThinkTime == 10.0);
+
+	// Thinking every 0.1 s takes 7 frames of 1/64 s. The agent is registered again, so that it starts without any time
+	cMap2D.SetColumn(10, 0, 7, TILE_BLOCK);
+	cAIScheduler2D.UnregisterAgent(hAgent);
+	hAgent = cAIScheduler2D.RegisterAgent();
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(14, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES / 7);
+	TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == CAIScheduler2D::LOD_MID);
+	TEST_CHECK(dTotalThinkTime == (NUM_FRAMES / 7) * 7 * FRAME_TIME);
+
+	// Thinking every 0.5 s takes 32 frames
+	cAIScheduler2D.UnregisterAgent(hAgent);
+	hAgent = cAIScheduler2D.RegisterAgent();
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(40, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES / 32);
+	TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == CAIScheduler2D::LOD_FAR);
+	TEST_CHECK(dTotalThinkTime == 10.0);
+
+	// A far agent which can see the player thinks every 0.1 s
+	cMap2D.SetColumn(10, 0, 7, TILE_EMPTY);
+	cAIScheduler2D.UnregisterAgent(hAgent);
+	hAgent = cAIScheduler2D.RegisterAgent();
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(40, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES / 7);
+	TEST_CHECK(cAIScheduler2D.GetBand(hAgent) == CAIScheduler2D::LOD_MID);
+
+	// Doubling the tick interval makes it think every 13 frames, but an agent near the player still thinks every frame
+	cAIScheduler2D.SetTickIntervalScale(2.0);
+	cAIScheduler2D.UnregisterAgent(hAgent);
+	hAgent = cAIScheduler2D.RegisterAgent();
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(40, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES / 13);
+	TEST_CHECK(CountThinks(cAIScheduler2D, hAgent, glm::i32vec2(5, 2), NUM_FRAMES, dTotalThinkTime) == NUM_FRAMES);
+	// A scale which is not positive is ignored
+	cAIScheduler2D.SetTickIntervalScale(0.0);
+	TEST_CHECK(cAIScheduler2D.GetTickIntervalScale() == 2.0);
+
+	// The agents are staggered, so that the agents in the same band do not all think in the same frame
+	std::vector<CAIScheduler2D::HANDLE> vAgents;
+	for (int i = 0; i < 3; i++)
+		vAgents.push_back(cAIScheduler2D.RegisterAgent());
+	cMap2D.SetColumn(10, 0, 7, TILE_BLOCK);
+	cAIScheduler2D.SetTickIntervalScale(1.0);
+	int arrFirstThinks[3] = { -1, -1, -1 };
+	for (int iFrame = 0; iFrame < 32; iFrame++)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			double dThinkTime = 0.0;
+			if ((cAIScheduler2D.Tick(vAgents[i], glm::i32vec2(40, 2), FRAME_TIME, dThinkTime)) && (arrFirstThinks[i] < 0))
+				arrFirstThinks[i] = iFrame;
+		}
+	}
+	TEST_CHECK((arrFirstThinks[0] != arrFirstThinks[1]) && (arrFirstThinks[1] != arrFirstThinks[2]) && (arrFirstThinks[0] != arrFirstThinks[2]));
+}
+
+/**
+ @brief A path is found in the next Update, and is then reused while the agent is on it and the goal has not moved far
+ */
+static void TestPathCache(void)
+{
+	CTestMap2D cMap2D(32, 16);
+	cMap2D.SetColumn(10, 0, 12, TILE_BLOCK);
+	CTestAIScheduler2D cAIScheduler2D(&cMap2D);
+	const CAIScheduler2D::HANDLE hAgent = cAIScheduler2D.RegisterAgent();
+
+	const glm::i32vec2 i32vec2Start(2, 2);
+	const glm::i32vec2 i32vec2Goal(20, 2);
+	std::vector<glm::i32vec2> vPath;
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, i32vec2Start, i32vec2Goal, vPath) == CAIScheduler2D::PATH_PENDING);
+	TEST_CHECK(vPath.empty());
+	cAIScheduler2D.Update(glm::i32vec2(0));
+	TEST_CHECK(cAIScheduler2D.GetNumExpansions() > 0);
+	TEST_CHECK(cAIScheduler2D.GetNumDeferredAgents() == 0);
+
+	// The path is the one which the map finds, around the wall
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, i32vec2Start, i32vec2Goal, vPath) == CAIScheduler2D::PATH_READY);
+	const std::vector<glm::i32vec2> vMapPath = cMap2D.PathFind(i32vec2Start, i32vec2Goal, heuristic::euclidean, 10);
+	TEST_CHECK(vPath == vMapPath);
+	TEST_CHECK((vPath.size() > 18) && (vPath.back() == i32vec2Goal));
+	TEST_CHECK(std::find(vPath.begin(), vPath.end(), glm::i32vec2(0, 0)) == vPath.end());
+	if (vPath.size() <= 18)
+		return;
+
+	// Further along the path, the rest of the path is returned
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, vMapPath[5], i32vec2Goal, vPath) == CAIScheduler2D::PATH_READY);
+	TEST_CHECK(std::equal(vPath.begin(), vPath.end(), vMapPath.begin() + 6) && (vPath.size() == vMapPath.size() - 6));
+	// The goal moved by less than REPATH_DISTANCE, so the cached path is still used
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, vMapPath[5], glm::i32vec2(21, 2), vPath) == CAIScheduler2D::PATH_READY);
+	cAIScheduler2D.Update(glm::i32vec2(0));
+	TEST_CHECK(cAIScheduler2D.GetNumCacheHits() == 3);
+	TEST_CHECK(cAIScheduler2D.GetNumExpansions() == 0);
+
+	// An agent which left its path, or whose goal moved by REPATH_DISTANCE, has to wait for a new path
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, glm::i32vec2(0, 0), i32vec2Goal, vPath) == CAIScheduler2D::PATH_PENDING);
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, vMapPath[5], glm::i32vec2(22, 2), vPath) == CAIScheduler2D::PATH_PENDING);
+	cAIScheduler2D.Update(glm::i32vec2(0));
+	TEST_CHECK(cAIScheduler2D.GetNumCacheHits() == 0);
+	// The queued request was updated to the last start and goal
+	TEST_CHECK(cAIScheduler2D.RequestPath(hAgent, vMapPath[5], glm::i32vec2(22, 2), vPath) == CAIScheduler2D::PATH_READY);
+	TEST_CHECK(vPath == cMap2D.PathFind(vMapPath[5], glm::i32vec2(22, 2), heuristic::euclidean, 10));
+}
+
+/**
+ @brief The queued paths are found in the order they were requested, within the budget of each frame.
+		The deferred agents keep their places, so every agent is served, and those which wait too long are reported
+ */
+static void TestBudget(void)
+{
+	CTestMap2D cMap2D(48, 24);
+	for (int iCol = 8; iCol < 48; iCol += 8)
+		cMap2D.SetColumn(iCol, (iCol % 16 == 0) ? 0 : 4, (iCol % 16 == 0) ? 19 : 23, TILE_BLOCK);
+	CTestAIScheduler2D cAIScheduler2D(&cMap2D);
+	cAIScheduler2D.SetExpansionBudget(300);
+	TEST_CHECK(cAIScheduler2D.GetExpansionBudget() == 300);
+
+	const int NUM_AGENTS = 40;
+	const glm::i32vec2 i32vec2Goal(46, 12);
+	std::vector<CAIScheduler2D::HANDLE> vAgents;
+	std::vector<glm::i32vec2> vStarts;
+	// The most expansions of a path, which is the most that a frame can go over its budget
+	unsigned int uiMaxPathExpansions = 0;
+	unsigned int uiTotalPathExpansions = 0;
+	for (int i = 0; i < NUM_AGENTS; i++)
+	{
+		vAgents.push_back(cAIScheduler2D.RegisterAgent());
+		vStarts.push_back(glm::i32vec2(1 + (i % 6), 1 + (i * 7) % 22));
+		cMap2D.PathFind(vStarts[i], i32vec2Goal, heuristic::euclidean, 10);
+		uiMaxPathExpansions = std::max(uiMaxPathExpansions, cMap2D.GetNumPathFindExpansions());
+		uiTotalPathExpansions += cMap2D.GetNumPathFindExpansions();
+	}
+
+	// An agent which is unregistered while it waits is removed from the queue, and its handle is reused
+	const CAIScheduler2D::HANDLE hLeaving = cAIScheduler2D.RegisterAgent();
+	std::vector<glm::i32vec2> vPath;
+	for (int i = 0; i < NUM_AGENTS; i++)
+	{
+		TEST_CHECK(cAIScheduler2D.RequestPath(vAgents[i], vStarts[i], i32vec2Goal, vPath) == CAIScheduler2D::PATH_PENDING);
+		if (i == NUM_AGENTS / 2)
+			cAIScheduler2D.RequestPath(hLeaving, vStarts[0], i32vec2Goal, vPath);
+	}
+	cAIScheduler2D.UnregisterAgent(hLeaving);
+	TEST_CHECK(cAIScheduler2D.RegisterAgent() == hLeaving);
+
+	int iNumServed = 0;
+	int iNumFrames = 0;
+	bool bInOrder = true;
+	bool bWithinBudget = true;
+	unsigned int uiMaxStarved = 0;
+	unsigned int uiTotalExpansions = 0;
+	while ((iNumServed < NUM_AGENTS) && (iNumFrames < 1000))
+	{
+		cAIScheduler2D.Update(glm::i32vec2(0));
+		iNumFrames++;
+		const unsigned int uiNumExpansions = cAIScheduler2D.GetNumExpansions();
+		bWithinBudget = bWithinBudget && (uiNumExpansions < 300 + uiMaxPathExpansions);
+		uiTotalExpansions += uiNumExpansions;
+		uiMaxStarved = std::max(uiMaxStarved, cAIScheduler2D.GetNumStarvedAgents());
+
+		// The served agents are the first ones which requested, and the rest are deferred
+		int iNumReady = 0;
+		for (int i = 0; i < NUM_AGENTS; i++)
+		{
+			if (cAIScheduler2D.RequestPath(vAgents[i], vStarts[i], i32vec2Goal, vPath) == CAIScheduler2D::PATH_READY)
+			{
+				bInOrder = bInOrder && (iNumReady == i);
+				iNumReady++;
+			}
+		}
+		bInOrder = bInOrder && (iNumReady >= iNumServed);
+		iNumServed = iNumReady;
+		bInOrder = bInOrder && (cAIScheduler2D.GetNumDeferredAgents() == (unsigned int)(NUM_AGENTS - iNumServed));
+	}
+	TEST_CHECK(iNumServed == NUM_AGENTS);
+	TEST_CHECK(bInOrder);
+	TEST_CHECK(bWithinBudget);
+	TEST_CHECK(uiTotalExpansions == uiTotalPathExpansions);
+	// The budget is kept on average, as the expansions over the budget are taken from the next frame
+	TEST_CHECK(uiTotalExpansions <= (unsigned int)iNumFrames * 300 + uiMaxPathExpansions);
+	// The paths took more than STARVATION_FRAMES to find, so the last agents were starved
+	TEST_CHECK(iNumFrames > 31);
+	TEST_CHECK(uiMaxStarved > 0);
+	cAIScheduler2D.Update(glm::i32vec2(0));
+	TEST_CHECK(cAIScheduler2D.GetNumDeferredAgents() == 0);
+	TEST_CHECK(cAIScheduler2D.GetNumStarvedAgents() == 0);
+}
+
+/**
+ @brief Benchmark 1000 enemies which chase the player on a map with walls, with the scheduler,
+		against finding the path of every enemy in every frame
+ */
+static void BenchmarkEnemies(void)
+{
+	const int NUM_AGENTS = 1000;
+	const int NUM_FRAMES = 256;
+	// The default budget is for the enemies of a level. 1000 enemies which all chase the player need more
+	const unsigned int EXPANSION_BUDGET = 20000;
+	CTestMap2D cMap2D(64, 32);
+	for (int iCol = 8; iCol < 64; iCol += 8)
+		cMap2D.SetColumn(iCol, (iCol % 16 == 0) ? 0 : 8, (iCol % 16 == 0) ? 23 : 31, TILE_BLOCK);
+	CTestAIScheduler2D cAIScheduler2D(&cMap2D);
+	cAIScheduler2D.SetExpansionBudget(EXPANSION_BUDGET);
+
+	CRandom cRandom(5u, 0u);
+	std::vector<CAIScheduler2D::HANDLE> vAgents;
+	std::vector<glm::i32vec2> vPositions;
+	for (int i = 0; i < NUM_AGENTS; i++)
+	{
+		glm::i32vec2 i32vec2Position((int)cRandom.NextUInt(64), (int)cRandom.NextUInt(32));
+		while ((i32vec2Position.x % 8) == 0)
+			i32vec2Position.x = (int)cRandom.NextUInt(64);
+		vAgents.push_back(cAIScheduler2D.RegisterAgent());
+		vPositions.push_back(i32vec2Position);
+	}
+
+	// The player walks back and forth along the bottom row, around the walls
+	std::vector<glm::i32vec2> vPath;
+	unsigned int uiMaxExpansions = 0;
+	unsigned int uiMaxDeferred = 0;
+	unsigned int uiMaxStarved = 0;
+	unsigned int uiTotalCacheHits = 0;
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		glm::i32vec2 i32vec2Player(1 + (iFrame / 4) % 62, 28);
+		if ((i32vec2Player.x % 8) == 0)
+			i32vec2Player.x++;
+		cAIScheduler2D.Update(i32vec2Player);
+		uiMaxExpansions = std::max(uiMaxExpansions, cAIScheduler2D.GetNumExpansions());
+		uiMaxDeferred = std::max(uiMaxDeferred, cAIScheduler2D.GetNumDeferredAgents());
+		uiMaxStarved = std::max(uiMaxStarved, cAIScheduler2D.GetNumStarvedAgents());
+		uiTotalCacheHits += cAIScheduler2D.GetNumCacheHits();
+		for (int i = 0; i < NUM_AGENTS; i++)
+		{
+			double dThinkTime = 0.0;
+			if (cAIScheduler2D.Tick(vAgents[i], vPositions[i], FRAME_TIME, dThinkTime))
+				cAIScheduler2D.RequestPath(vAgents[i], vPositions[i], i32vec2Player, vPath);
+		}
+	}
+	const double dScheduledTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	// Without the scheduler, every enemy finds its path in every frame. This is slow, so fewer frames are run
+	const int NUM_UNSCHEDULED_FRAMES = 4;
+	tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_UNSCHEDULED_FRAMES; iFrame++)
+	{
+		const glm::i32vec2 i32vec2Player(1 + iFrame, 28);
+		for (int i = 0; i < NUM_AGENTS; i++)
+			vPath = cMap2D.PathFind(vPositions[i], i32vec2Player, heuristic::euclidean, 10);
+	}
+	const double dUnscheduledTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	// A frame uses its budget, and at most 1 more path, which is the size of the map
+	TEST_CHECK(uiMaxExpansions <= EXPANSION_BUDGET + 64 * 32);
+	TEST_CHECK(uiTotalCacheHits > 0);
+	// With this budget, every path is found before its enemy is starved
+	TEST_CHECK(uiMaxStarved == 0);
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("1000 enemies, scheduled", dScheduledTime * 1000.0 / NUM_FRAMES, "ms/frame");
+	cTestHarness->Report("1000 enemies, path found every frame", dUnscheduledTime * 1000.0 / NUM_UNSCHEDULED_FRAMES, "ms/frame");
+	cTestHarness->Report("1000 enemies, most deferred agents", (double)uiMaxDeferred, "agents");
+	cTestHarness->Report("1000 enemies, most starved agents", (double)uiMaxStarved, "agents");
+}
+
+/**
+ @brief Run the tests of CAIScheduler2D
+ */
+void RunAISchedulerTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("AIScheduler.LevelOfDetail", TestLevelOfDetail);
+	cTestHarness->Run("AIScheduler.TickRate", TestTickRate);
+	cTestHarness->Run("AIScheduler.PathCache", TestPathCache);
+	cTestHarness->Run("AIScheduler.Budget", TestBudget);
+	cTestHarness->Run("AIScheduler.Benchmark", BenchmarkEnemies);
+}
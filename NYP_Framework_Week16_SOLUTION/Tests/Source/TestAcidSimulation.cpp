@@ -0,0 +1,350 @@
+/**
+ Tests of CAcidSimulation2D, which are stepped without a map
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include AcidSimulation2D
+#include "Scene2D\AcidSimulation2D.h"
+// Include Physics2D for the gravity directions
+#include "Scene2D\Physics2D.h"
+// Include WorkerPool
+#include "System\WorkerPool.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+/**
+ An acid simulation which is not the singleton, so that 2 simulations can be compared.
+ It can step every chunk, and step its chunks on the worker threads without loading a map
+ */
+class CTestAcidSimulation2D : public CAcidSimulation2D
+{
+public:
+	CTestAcidSimulation2D(const int iNumCols, const int iNumRows)
+	{
+		Resize(iNumCols, iNumRows);
+	}
+
+	virtual ~CTestAcidSimulation2D(void)
+	{
+	}
+
+	// Step the chunks on the worker threads, or serially in order if bParallelUpdate is false
+	void UseWorkerPool(const bool bParallelUpdate)
+	{
+		cWorkerPool = CWorkerPool::GetInstance();
+		SetParallelUpdate(bParallelUpdate);
+	}
+
+	// Activate every chunk, so that the next step does not skip any chunks
+	void ActivateAllChunks(void)
+	{
+		std::fill(vActiveChunks.begin(), vActiveChunks.end(), 1);
+	}
+
+	// Get the cells, from the bottom row to the top row
+	const std::vector<unsigned char>& GetCells(void) const
+	{
+		return vCurrent;
+	}
+
+	// Draw the cells, from the top row to the bottom row, with '#' for acid and 'X' for solid cells
+	std::string Draw(void) const
+	{
+		std::string strCells;
+		for (int iRow = iNumRows - 1; iRow >= 0; iRow--)
+		{
+			for (int iCol = 0; iCol < iNumCols; iCol++)
+			{
+				const CELL eCell = GetCell(iCol, iRow);
+				strCells += (eCell == CELL_ACID) ? '#' : ((eCell == CELL_SOLID) ? 'X' : '.');
+			}
+			strCells += '\n';
+		}
+		return strCells;
+	}
+
+	// Set the cells from a drawing, from the top row to the bottom row
+	void Load(const char* const* arrRows)
+	{
+		for (int iRow = 0; iRow < iNumRows; iRow++)
+		{
+			for (int iCol = 0; iCol < iNumCols; iCol++)
+			{
+				const char c = arrRows[iNumRows - iRow - 1][iCol];
+				SetCell(iCol, iRow, (c == '#') ? CELL_ACID : ((c == 'X') ? CELL_SOLID : CELL_EMPTY));
+			}
+		}
+	}
+
+	// Count the cells of a type
+	unsigned int Count(const CELL eCell) const
+	{
+		unsigned int uiCount = 0;
+		for (unsigned int i = 0; i < vCurrent.size(); i++)
+		{
+			if (vCurrent[i] == eCell)
+				uiCount++;
+		}
+		return uiCount;
+	}
+};
+
+/**
+ @brief Fill a simulation with random acid and solid cells
+ */
+static void RandomiseCells(CTestAcidSimulation2D& cSimulation, const int iNumCols, const int iNumRows, CRandom& cRandom)
+{
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			const unsigned int uiRandom = cRandom.NextUInt(10);
+			cSimulation.SetCell(iCol, iRow, (uiRandom < 3) ? CAcidSimulation2D::CELL_ACID :
+								((uiRandom == 3) ? CAcidSimulation2D::CELL_SOLID : CAcidSimulation2D::CELL_EMPTY));
+		}
+	}
+}
+
+/**
+ @brief A column of acid falls together, 1 tile per step, because the cells are stepped from the side which
+		the gravity pulls towards. A cell on a solid ledge stays, and the acid ends up resting on something
+ */
+static void TestFall(void)
+{
+	CTestAcidSimulation2D cSimulation(8, 8);
+	const char* arrStart[] = {
+		"...#....",
+		"...#....",
+		"...#....",
+		"......#.",
+		"........",
+		".....XXX",
+		"........",
+		"........" };
+	cSimulation.Load(arrStart);
+
+	cSimulation.Step();
+	const char* arrStep1 =
+		"........\n"
+		"...#....\n"
+		"...#....\n"
+		"...#....\n"
+		"......#.\n"
+		".....XXX\n"
+		"........\n"
+		"........\n";
+	TEST_CHECK(cSimulation.Draw() == arrStep1);
+	// The top and bottom of the column, and the cell which fell onto the ledge
+	TEST_CHECK(cSimulation.GetNumChangedCells() == 4);
+
+	int iNumSteps = 1;
+	bool bOnLedge = true;
+	while ((cSimulation.GetNumActiveChunks() > 0) && (iNumSteps < 100))
+	{
+		cSimulation.Step();
+		iNumSteps++;
+		bOnLedge = bOnLedge && (cSimulation.GetCell(6, 3) == CAcidSimulation2D::CELL_ACID);
+	}
+	TEST_CHECK(iNumSteps < 100);
+	TEST_CHECK(bOnLedge);
+	TEST_CHECK(cSimulation.Count(CAcidSimulation2D::CELL_ACID) == 4);
+	TEST_CHECK(cSimulation.Count(CAcidSimulation2D::CELL_SOLID) == 3);
+
+	// Every acid cell rests on the floor, a solid cell or another acid cell
+	bool bResting = true;
+	for (int iRow = 0; iRow < 8; iRow++)
+	{
+		for (int iCol = 0; iCol < 8; iCol++)
+		{
+			if (cSimulation.GetCell(iCol, iRow) == CAcidSimulation2D::CELL_ACID)
+				bResting = bResting && (cSimulation.GetCell(iCol, iRow - 1) != CAcidSimulation2D::CELL_EMPTY);
+		}
+	}
+	TEST_CHECK(bResting);
+}
+
+/**
+ @brief The acid runs off diagonally and spreads out sideways under more acid, until it settles into a layer,
+		and the simulation stops stepping chunks once the acid has settled
+ */
+static void TestSettle(void)
+{
+	CTestAcidSimulation2D cSimulation(8, 8);
+	const char* arrStart[] = {
+		"..####..",
+		"..####..",
+		"........",
+		"........",
+		"........",
+		"........",
+		"X......X",
+		"XXXXXXXX" };
+	cSimulation.Load(arrStart);
+
+	int iNumSteps = 0;
+	do
+	{
+		cSimulation.Step();
+		iNumSteps++;
+	} while ((cSimulation.GetNumActiveChunks() > 0) && (iNumSteps < 100));
+	TEST_CHECK(iNumSteps < 100);
+	TEST_CHECK(cSimulation.GetNumChangedCells() == 0);
+
+	// The 8 cells fill the 6 cells of the basin, and the other 2 stack on them
+	TEST_CHECK(cSimulation.Count(CAcidSimulation2D::CELL_ACID) == 8);
+	for (int iCol = 1; iCol < 7; iCol++)
+		TEST_CHECK(cSimulation.GetCell(iCol, 1) == CAcidSimulation2D::CELL_ACID);
+	unsigned int uiNumOnTop = 0;
+	for (int iCol = 1; iCol < 7; iCol++)
+		uiNumOnTop += (cSimulation.GetCell(iCol, 2) == CAcidSimulation2D::CELL_ACID) ? 1 : 0;
+	TEST_CHECK(uiNumOnTop == 2);
+
+	// Removing the floor under the acid wakes it up again
+	cSimulation.SetCell(3, 0, CAcidSimulation2D::CELL_EMPTY);
+	cSimulation.Step();
+	TEST_CHECK(cSimulation.GetNumActiveChunks() > 0);
+	TEST_CHECK(cSimulation.GetCell(3, 0) == CAcidSimulation2D::CELL_ACID);
+}
+
+/**
+ @brief The acid flows towards each gravity direction, and the cells outside the grid are solid
+ */
+static void TestGravity(void)
+{
+	const unsigned char arrGravity[] = {
+		CPhysics2D::GRAVITY_DOWN, CPhysics2D::GRAVITY_UP, CPhysics2D::GRAVITY_RIGHT, CPhysics2D::GRAVITY_LEFT };
+	const glm::i32vec2 arrEnd[] = { glm::i32vec2(4, 0), glm::i32vec2(4, 11), glm::i32vec2(9, 6), glm::i32vec2(0, 6) };
+
+	for (int i = 0; i < 4; i++)
+	{
+		CTestAcidSimulation2D cSimulation(10, 12);
+		cSimulation.SetGravityDirection(arrGravity[i]);
+		cSimulation.SetCell(4, 6, CAcidSimulation2D::CELL_ACID);
+		for (int iStep = 0; iStep < 20; iStep++)
+			cSimulation.Step();
+		TEST_CHECK(cSimulation.GetCell(arrEnd[i].x, arrEnd[i].y) == CAcidSimulation2D::CELL_ACID);
+		TEST_CHECK(cSimulation.Count(CAcidSimulation2D::CELL_ACID) == 1);
+	}
+
+	CTestAcidSimulation2D cSimulation(4, 4);
+	TEST_CHECK(cSimulation.GetCell(-1, 0) == CAcidSimulation2D::CELL_SOLID);
+	TEST_CHECK(cSimulation.GetCell(0, 4) == CAcidSimulation2D::CELL_SOLID);
+	TEST_CHECK(cSimulation.GetCell(0, 0) == CAcidSimulation2D::CELL_EMPTY);
+}
+
+/**
+ @brief Skipping the chunks which did not change gives the same cells as stepping every chunk,
+		and the acid and solid cells are never created or destroyed
+ */
+static void TestActiveChunks(void)
+{
+	const int NUM_COLS = 50;
+	const int NUM_ROWS = 37;
+
+	CTestAcidSimulation2D cActive(NUM_COLS, NUM_ROWS);
+	CTestAcidSimulation2D cAll(NUM_COLS, NUM_ROWS);
+	CRandom cRandom(17u, 0u);
+	RandomiseCells(cActive, NUM_COLS, NUM_ROWS, cRandom);
+	CRandom cSameRandom(17u, 0u);
+	RandomiseCells(cAll, NUM_COLS, NUM_ROWS, cSameRandom);
+	const unsigned int uiNumAcid = cActive.Count(CAcidSimulation2D::CELL_ACID);
+	const unsigned int uiNumSolid = cActive.Count(CAcidSimulation2D::CELL_SOLID);
+
+	bool bSame = true;
+	bool bConserved = true;
+	unsigned int uiNumSkippedChunks = 0;
+	for (int iStep = 0; iStep < 200; iStep++)
+	{
+		// Change the gravity, and dig holes, along the way
+		if (iStep == 80)
+		{
+			cActive.SetGravityDirection(CPhysics2D::GRAVITY_LEFT);
+			cAll.SetGravityDirection(CPhysics2D::GRAVITY_LEFT);
+		}
+		if ((iStep % 25) == 10)
+		{
+			const int iCol = cRandom.NextUInt(NUM_COLS);
+			const int iRow = cRandom.NextUInt(NUM_ROWS);
+			if (cActive.GetCell(iCol, iRow) == CAcidSimulation2D::CELL_SOLID)
+			{
+				cActive.SetCell(iCol, iRow, CAcidSimulation2D::CELL_EMPTY);
+				cAll.SetCell(iCol, iRow, CAcidSimulation2D::CELL_EMPTY);
+			}
+		}
+
+		cAll.ActivateAllChunks();
+		cActive.Step();
+		cAll.Step();
+		uiNumSkippedChunks += cAll.GetNumActiveChunks() - cActive.GetNumActiveChunks();
+		bSame = bSame && (cActive.GetCells() == cAll.GetCells());
+		bConserved = bConserved && (cActive.Count(CAcidSimulation2D::CELL_ACID) == uiNumAcid);
+	}
+	TEST_CHECK(bSame);
+	TEST_CHECK(bConserved);
+	TEST_CHECK(cActive.Count(CAcidSimulation2D::CELL_SOLID) <= uiNumSolid);
+	// Once the acid has settled, most of the chunks are skipped
+	TEST_CHECK(uiNumSkippedChunks > 0);
+}
+
+/**
+ @brief Stepping the chunks on the worker threads, in any order, gives the same cells as stepping them serially,
+		and the same cells on every run
+ */
+static void TestParallelOrder(void)
+{
+	const int NUM_COLS = 64;
+	const int NUM_ROWS = 48;
+
+	CWorkerPool::GetInstance()->Init(4);
+	CTestAcidSimulation2D cSerial(NUM_COLS, NUM_ROWS);
+	CTestAcidSimulation2D cParallel(NUM_COLS, NUM_ROWS);
+	CTestAcidSimulation2D cNoPool(NUM_COLS, NUM_ROWS);
+	cSerial.UseWorkerPool(false);
+	cParallel.UseWorkerPool(true);
+	// The same random level in each simulation
+	CTestAcidSimulation2D* arrSimulations[] = { &cSerial, &cParallel, &cNoPool };
+	for (int i = 0; i < 3; i++)
+	{
+		CRandom cRandom(29u, 0u);
+		RandomiseCells(*arrSimulations[i], NUM_COLS, NUM_ROWS, cRandom);
+	}
+
+	bool bSame = true;
+	for (int iStep = 0; iStep < 150; iStep++)
+	{
+		cSerial.Step();
+		cParallel.Step();
+		cNoPool.Step();
+		bSame = bSame && (cSerial.GetCells() == cParallel.GetCells()) && (cSerial.GetCells() == cNoPool.GetCells());
+	}
+	TEST_CHECK(bSame);
+
+	// The cells after the steps match the cells which were recorded when this test was written,
+	// so a change to the order which the cells are stepped in is caught
+	unsigned int uiHash = 2166136261u;
+	const std::vector<unsigned char>& vCells = cParallel.GetCells();
+	for (unsigned int i = 0; i < vCells.size(); i++)
+		uiHash = (uiHash ^ vCells[i]) * 16777619u;
+	TEST_CHECK(uiHash == 3050476754u);
+
+	CWorkerPool::Destroy();
+}
+
+/**
+ @brief Run the tests of CAcidSimulation2D
+ */
+void RunAcidSimulationTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("AcidSimulation.Fall", TestFall);
+	cTestHarness->Run("AcidSimulation.Settle", TestSettle);
+	cTestHarness->Run("AcidSimulation.Gravity", TestGravity);
+	cTestHarness->Run("AcidSimulation.ActiveChunks", TestActiveChunks);
+	cTestHarness->Run("AcidSimulation.ParallelOrder", TestParallelOrder);
+}
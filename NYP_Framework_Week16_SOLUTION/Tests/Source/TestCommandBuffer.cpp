@@ -0,0 +1,258 @@
+/**
+ Tests of CCommandBuffer2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include CommandBuffer2D
+#include "Scene2D\CommandBuffer2D.h"
+// Include WorkerPool
+#include "System\WorkerPool.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+/**
+ The commands which were applied, with a small map which the SET_MAP_INFO commands are applied to
+ */
+struct AppliedCommands
+{
+	static const int NUM_COLS = 16;
+	static const int NUM_ROWS = 16;
+
+	std::vector<CCommandBuffer2D::Command> vCommands;
+	int arrMap[NUM_ROWS][NUM_COLS];
+
+	AppliedCommands(void)
+	{
+		memset(arrMap, 0, sizeof(arrMap));
+	}
+
+	// Get the function which applies a command to these
+	CCommandBuffer2D::APPLY_FUNCTION GetApplyFunction(void)
+	{
+		AppliedCommands* pApplied = this;
+		return [pApplied](const CCommandBuffer2D::Command& sCommand)
+		{
+			pApplied->vCommands.push_back(sCommand);
+			if (sCommand.eType == CCommandBuffer2D::SET_MAP_INFO)
+				pApplied->arrMap[sCommand.iArguments[0]][sCommand.iArguments[1]] = sCommand.iArguments[2];
+		};
+	}
+};
+
+/**
+ @brief Compare 2 commands
+ */
+static bool IsSameCommand(const CCommandBuffer2D::Command& sA, const CCommandBuffer2D::Command& sB)
+{
+	return (sA.eType == sB.eType) &&
+		   (sA.iArguments[0] == sB.iArguments[0]) &&
+		   (sA.iArguments[1] == sB.iArguments[1]) &&
+		   (sA.iArguments[2] == sB.iArguments[2]) &&
+		   (sA.pcName == sB.pcName);
+}
+
+/**
+ @brief Simulate an entity, which records its changes into the command buffer which is bound to its thread.
+		Neighbouring entities write to the same tiles, so the map depends on the order the commands are applied in
+ @param uiEntity A const unsigned int variable containing the slot of the entity
+ */
+static void SimulateEntity(const unsigned int uiEntity)
+{
+	CCommandBuffer2D* cCommandBuffer2D = CCommandBuffer2D::GetCurrent();
+	const unsigned int uiTile = uiEntity / 3;
+	cCommandBuffer2D->SetMapInfo((uiTile / AppliedCommands::NUM_COLS) % AppliedCommands::NUM_ROWS,
+								 uiTile % AppliedCommands::NUM_COLS,
+								 (int)uiEntity);
+	if ((uiEntity % 7) == 0)
+		cCommandBuffer2D->PlaySound((int)uiEntity);
+	if ((uiEntity % 11) == 0)
+		cCommandBuffer2D->SpawnBomb(CPhysics2D::GRAVITY_DOWN, (int)uiEntity, 1);
+	if ((uiEntity % 13) == 0)
+		cCommandBuffer2D->RemoveInventoryItem("Bomb", 1);
+}
+
+/**
+ @brief Update the entities in 2 phases, as CEntityManager2D::UpdateParallelEntities does.
+		The entities are simulated on the worker threads, and the buffers are committed in the order of the threads
+ */
+static void UpdateInTwoPhases(const unsigned int uiNumEntities, const unsigned int uiMaxThreads,
+							  std::vector<CCommandBuffer2D>& vCommandBuffers, AppliedCommands& sApplied)
+{
+	CWorkerPool::GetInstance()->ParallelFor(uiNumEntities,
+		[&vCommandBuffers](const unsigned int uiBegin, const unsigned int uiEnd, const unsigned int uiThread)
+		{
+			CCommandBuffer2D::SetCurrent(&vCommandBuffers[uiThread]);
+			for (unsigned int i = uiBegin; i < uiEnd; i++)
+				SimulateEntity(i);
+			CCommandBuffer2D::SetCurrent(NULL);
+		},
+		uiMaxThreads);
+
+	const CCommandBuffer2D::APPLY_FUNCTION fnApply = sApplied.GetApplyFunction();
+	for (auto& buffer : vCommandBuffers)
+		buffer.Commit(fnApply);
+}
+
+/**
+ @brief The commands are applied in the order that they were recorded, and the buffer is empty after a commit
+ */
+static void TestRecordOrder(void)
+{
+	CCommandBuffer2D cCommandBuffer2D;
+	cCommandBuffer2D.SetMapInfo(3, 4, 5);
+	cCommandBuffer2D.PlaySound(2);
+	cCommandBuffer2D.AddInventoryItem("Lives", 1);
+	cCommandBuffer2D.SpawnBomb(CPhysics2D::GRAVITY_LEFT, 6, 7);
+	cCommandBuffer2D.EmitParticles(1, 8, 9);
+	cCommandBuffer2D.AddLightFlash(10, 11, 12);
+	cCommandBuffer2D.RemoveInventoryItem("Bomb", 1);
+	cCommandBuffer2D.SetMapInfo(3, 4, 0);
+	TEST_CHECK(cCommandBuffer2D.GetNumCommands() == 8);
+
+	AppliedCommands sApplied;
+	cCommandBuffer2D.Commit(sApplied.GetApplyFunction());
+	TEST_CHECK(cCommandBuffer2D.GetNumCommands() == 0);
+	TEST_CHECK(sApplied.vCommands.size() == 8);
+	if (sApplied.vCommands.size() != 8)
+		return;
+
+	const CCommandBuffer2D::COMMAND_TYPE arrTypes[8] = {
+		CCommandBuffer2D::SET_MAP_INFO, CCommandBuffer2D::PLAY_SOUND, CCommandBuffer2D::ADD_INVENTORY_ITEM,
+		CCommandBuffer2D::SPAWN_BOMB, CCommandBuffer2D::EMIT_PARTICLES, CCommandBuffer2D::ADD_LIGHT_FLASH,
+		CCommandBuffer2D::REMOVE_INVENTORY_ITEM, CCommandBuffer2D::SET_MAP_INFO };
+	for (int i = 0; i < 8; i++)
+		TEST_CHECK(sApplied.vCommands[i].eType == arrTypes[i]);
+	TEST_CHECK(sApplied.vCommands[3].iArguments[0] == CPhysics2D::GRAVITY_LEFT);
+	TEST_CHECK((sApplied.vCommands[3].iArguments[1] == 6) && (sApplied.vCommands[3].iArguments[2] == 7));
+	TEST_CHECK(strcmp(sApplied.vCommands[2].pcName, "Lives") == 0);
+	// The later write to the tile is applied last
+	TEST_CHECK(sApplied.arrMap[3][4] == 0);
+
+	// A commit without commands applies nothing, and cleared commands are not applied
+	cCommandBuffer2D.SetMapInfo(1, 1, 1);
+	cCommandBuffer2D.Clear();
+	cCommandBuffer2D.Commit(sApplied.GetApplyFunction());
+	TEST_CHECK(sApplied.vCommands.size() == 8);
+}
+
+/**
+ @brief Each thread has its own bound command buffer
+ */
+static void TestThreadBinding(void)
+{
+	CCommandBuffer2D cMainBuffer;
+	CCommandBuffer2D cOtherBuffer;
+	TEST_CHECK(CCommandBuffer2D::GetCurrent() == NULL);
+	CCommandBuffer2D::SetCurrent(&cMainBuffer);
+
+	CCommandBuffer2D* cSeenByOtherThread = &cMainBuffer;
+	CCommandBuffer2D* cBoundByOtherThread = NULL;
+	std::thread tOther([&]()
+		{
+			cSeenByOtherThread = CCommandBuffer2D::GetCurrent();
+			CCommandBuffer2D::SetCurrent(&cOtherBuffer);
+			cBoundByOtherThread = CCommandBuffer2D::GetCurrent();
+		});
+	tOther.join();
+
+	TEST_CHECK(cSeenByOtherThread == NULL);
+	TEST_CHECK(cBoundByOtherThread == &cOtherBuffer);
+	TEST_CHECK(CCommandBuffer2D::GetCurrent() == &cMainBuffer);
+	CCommandBuffer2D::SetCurrent(NULL);
+	TEST_CHECK(CCommandBuffer2D::GetCurrent() == NULL);
+}
+
+/**
+ @brief Committing the buffers in the order of the threads applies the commands in the order of the entities,
+		so the commands and the map are the same as a serial update, for any number of threads
+ */
+static void TestCommitOrderAcrossThreads(void)
+{
+	const unsigned int NUM_ENTITIES = 1000;
+	CWorkerPool::GetInstance()->Init(4);
+	const unsigned int uiNumThreads = CWorkerPool::GetInstance()->GetNumThreads();
+
+	// The serial update, on this thread
+	AppliedCommands sSerial;
+	CCommandBuffer2D cSerialBuffer;
+	CCommandBuffer2D::SetCurrent(&cSerialBuffer);
+	for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+		SimulateEntity(i);
+	CCommandBuffer2D::SetCurrent(NULL);
+	cSerialBuffer.Commit(sSerial.GetApplyFunction());
+
+	std::vector<CCommandBuffer2D> vCommandBuffers(uiNumThreads);
+	bool bSameCommands = true;
+	bool bSameMap = true;
+	for (int iFrame = 0; iFrame < 20; iFrame++)
+	{
+		for (unsigned int uiMaxThreads = 1; uiMaxThreads <= uiNumThreads; uiMaxThreads++)
+		{
+			AppliedCommands sParallel;
+			UpdateInTwoPhases(NUM_ENTITIES, uiMaxThreads, vCommandBuffers, sParallel);
+
+			bSameCommands = bSameCommands && (sParallel.vCommands.size() == sSerial.vCommands.size());
+			for (unsigned int i = 0; (bSameCommands) && (i < sParallel.vCommands.size()); i++)
+				bSameCommands = IsSameCommand(sParallel.vCommands[i], sSerial.vCommands[i]);
+			bSameMap = bSameMap && (memcmp(sParallel.arrMap, sSerial.arrMap, sizeof(sSerial.arrMap)) == 0);
+		}
+	}
+	TEST_CHECK(uiNumThreads == 4);
+	TEST_CHECK(bSameCommands);
+	TEST_CHECK(bSameMap);
+	for (auto& buffer : vCommandBuffers)
+		TEST_CHECK(buffer.GetNumCommands() == 0);
+
+	CWorkerPool::Destroy();
+}
+
+/**
+ @brief Benchmark recording and committing the commands of 100000 entities, for each number of threads
+ */
+static void BenchmarkTwoPhaseUpdate(void)
+{
+	const unsigned int NUM_ENTITIES = 100000;
+	const int NUM_FRAMES = 20;
+	CWorkerPool::GetInstance()->Init(4);
+	const unsigned int uiNumThreads = CWorkerPool::GetInstance()->GetNumThreads();
+
+	std::vector<CCommandBuffer2D> vCommandBuffers(uiNumThreads);
+	for (auto& buffer : vCommandBuffers)
+		buffer.Reserve(NUM_ENTITIES * 2);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	for (unsigned int uiMaxThreads = 1; uiMaxThreads <= uiNumThreads; uiMaxThreads++)
+	{
+		const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+		{
+			AppliedCommands sApplied;
+			sApplied.vCommands.reserve(NUM_ENTITIES * 2);
+			UpdateInTwoPhases(NUM_ENTITIES, uiMaxThreads, vCommandBuffers, sApplied);
+		}
+		const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+		const std::string strName = "Two-phase update, " + std::to_string(uiMaxThreads) + " threads";
+		cTestHarness->Report(strName.c_str(), (double)NUM_ENTITIES * NUM_FRAMES / dTime, "entities/s");
+	}
+
+	CWorkerPool::Destroy();
+}
+
+/**
+ @brief Run the tests of CCommandBuffer2D
+ */
+void RunCommandBufferTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("CommandBuffer.RecordOrder", TestRecordOrder);
+	cTestHarness->Run("CommandBuffer.ThreadBinding", TestThreadBinding);
+	cTestHarness->Run("CommandBuffer.CommitOrderAcrossThreads", TestCommitOrderAcrossThreads);
+	cTestHarness->Run("CommandBuffer.Benchmark", BenchmarkTwoPhaseUpdate);
+}
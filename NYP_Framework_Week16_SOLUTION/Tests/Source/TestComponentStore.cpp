@@ -0,0 +1,312 @@
+/**
+ Tests of CComponentStore2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include ComponentStore2D
+#include "Scene2D\ComponentStore2D.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <chrono>
+
+/**
+ An entity which can be put to sleep directly, without the frames at rest
+ */
+class CTestEntity2D : public CEntity2D
+{
+public:
+	CTestEntity2D(const int iCol, const int iRow)
+	{
+		i32vec2Index = glm::i32vec2(iCol, iRow);
+	}
+
+	void SetAsleep(const bool bAsleep)
+	{
+		this->bAsleep = bAsleep;
+	}
+};
+
+/**
+ The component store of a test, which is cleared before its entities are deleted
+ */
+struct TestStore
+{
+	CComponentStore2D* cComponentStore2D;
+	std::vector<CTestEntity2D*> vEntities;
+
+	TestStore(void)
+	{
+		cComponentStore2D = CComponentStore2D::GetInstance();
+		cComponentStore2D->Init();
+	}
+
+	~TestStore(void)
+	{
+		cComponentStore2D->Clear();
+		for (unsigned int i = 0; i < vEntities.size(); i++)
+			delete vEntities[i];
+	}
+
+	CTestEntity2D* Create(const int iCol, const int iRow)
+	{
+		CTestEntity2D* cEntity = new CTestEntity2D(iCol, iRow);
+		vEntities.push_back(cEntity);
+		cComponentStore2D->Create(cEntity);
+		return cEntity;
+	}
+
+	// Gather the entities, and find the pairs of colliding entities at their positions
+	std::vector<CComponentStore2D::CollisionPair> DetectCollisions(void)
+	{
+		std::vector<CComponentStore2D::CollisionPair> vCollisionPairs;
+		cComponentStore2D->Gather();
+		cComponentStore2D->UpdateTransforms();
+		cComponentStore2D->DetectCollisions(vCollisionPairs);
+		return vCollisionPairs;
+	}
+
+	// Count the pairs between 2 entities, in either order
+	unsigned int CountPairs(const std::vector<CComponentStore2D::CollisionPair>& vCollisionPairs,
+							const CEntity2D* cFirst, const CEntity2D* cSecond) const
+	{
+		unsigned int uiNumPairs = 0;
+		for (unsigned int i = 0; i < vCollisionPairs.size(); i++)
+		{
+			const CEntity2D* cA = cComponentStore2D->GetOwner(vCollisionPairs[i].uiFirst);
+			const CEntity2D* cB = cComponentStore2D->GetOwner(vCollisionPairs[i].uiSecond);
+			if (((cA == cFirst) && (cB == cSecond)) || ((cA == cSecond) && (cB == cFirst)))
+				uiNumPairs++;
+		}
+		return uiNumPairs;
+	}
+};
+
+/**
+ @brief Every colliding pair of awake entities is reported once, and entities which are apart are not reported
+ */
+static void TestCollisionPairs(void)
+{
+	TestStore sStore;
+
+	// 3 entities on the same tile, 1 touching them, and 1 which is apart
+	CTestEntity2D* cA = sStore.Create(4, 4);
+	CTestEntity2D* cB = sStore.Create(4, 4);
+	CTestEntity2D* cC = sStore.Create(4, 4);
+	CTestEntity2D* cTouching = sStore.Create(5, 4);
+	CTestEntity2D* cApart = sStore.Create(10, 4);
+
+	std::vector<CComponentStore2D::CollisionPair> vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 6);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cA, cB) == 1);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cA, cC) == 1);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cB, cC) == 1);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cA, cTouching) == 1);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cC, cTouching) == 1);
+	for (unsigned int i = 0; i < sStore.vEntities.size() - 1; i++)
+		TEST_CHECK(sStore.CountPairs(vCollisionPairs, cApart, sStore.vEntities[i]) == 0);
+
+	// No entity collides with itself
+	for (unsigned int i = 0; i < vCollisionPairs.size(); i++)
+		TEST_CHECK(vCollisionPairs[i].uiFirst != vCollisionPairs[i].uiSecond);
+
+	// The microsteps move an entity apart
+	cTouching->i32vec2NumMicroSteps.x = 1;
+	vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 3);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cA, cTouching) == 0);
+
+	// A dead entity does not collide
+	cB->dead = true;
+	vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 1);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cA, cC) == 1);
+}
+
+/**
+ @brief A sleeping entity is reported second in its pair with an awake entity, so that it can be woken up,
+		and 2 sleeping entities do not collide
+ */
+static void TestCollisionSleep(void)
+{
+	TestStore sStore;
+
+	// The sleeping entities come first in the pools, so the pairs have to be reordered
+	CTestEntity2D* cAsleep = sStore.Create(2, 2);
+	CTestEntity2D* cOtherAsleep = sStore.Create(2, 2);
+	CTestEntity2D* cAwake = sStore.Create(2, 2);
+	cAsleep->SetAsleep(true);
+	cOtherAsleep->SetAsleep(true);
+
+	std::vector<CComponentStore2D::CollisionPair> vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 2);
+	TEST_CHECK(sStore.CountPairs(vCollisionPairs, cAsleep, cOtherAsleep) == 0);
+	for (unsigned int i = 0; i < vCollisionPairs.size(); i++)
+	{
+		TEST_CHECK(sStore.cComponentStore2D->GetOwner(vCollisionPairs[i].uiFirst) == cAwake);
+		TEST_CHECK(sStore.cComponentStore2D->GetOwner(vCollisionPairs[i].uiSecond)->IsAsleep());
+	}
+
+	// Once the awake entity has moved away, the sleeping entities stay asleep without any collisions
+	cAwake->i32vec2Index.x = 8;
+	vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 0);
+
+	// A woken entity collides with the entity which is still asleep, once
+	cOtherAsleep->Wake();
+	vCollisionPairs = sStore.DetectCollisions();
+	TEST_CHECK(vCollisionPairs.size() == 1);
+	TEST_CHECK(sStore.cComponentStore2D->GetOwner(vCollisionPairs[0].uiFirst) == cOtherAsleep);
+	TEST_CHECK(sStore.cComponentStore2D->GetOwner(vCollisionPairs[0].uiSecond) == cAsleep);
+}
+
+/**
+ @brief Set the UV coordinate of an entity from its tile position, as the entities did before the component store
+ @param cEntity2D A CEntity2D* variable which is the entity to update
+ */
+static void UpdateUVCoordinate(CEntity2D* cEntity2D)
+{
+	CSettings* cSettings = CSettings::GetInstance();
+	cEntity2D->vec2UVCoordinate.x = cSettings->ConvertIndexToUVSpace(cSettings->x, cEntity2D->i32vec2Index.x, false, cEntity2D->i32vec2NumMicroSteps.x*cSettings->MICRO_STEP_XAXIS);
+	cEntity2D->vec2UVCoordinate.y = cSettings->ConvertIndexToUVSpace(cSettings->y, cEntity2D->i32vec2Index.y, false, cEntity2D->i32vec2NumMicroSteps.y*cSettings->MICRO_STEP_YAXIS);
+}
+
+/**
+ @brief Create entities at random tile positions, with their UV coordinates set as the entities did
+ @param sStore A TestStore& variable containing the store to create the entities in
+ @param uiNumEntities A const unsigned int variable containing the number of entities
+ @param cRandom A CRandom& variable containing the random numbers
+ */
+static void CreateRandomEntities(TestStore& sStore, const unsigned int uiNumEntities, CRandom& cRandom)
+{
+	for (unsigned int i = 0; i < uiNumEntities; i++)
+	{
+		CTestEntity2D* cEntity = sStore.Create(cRandom.NextUInt(32), cRandom.NextUInt(24));
+		cEntity->i32vec2NumMicroSteps = glm::i32vec2(cRandom.NextUInt(4), cRandom.NextUInt(4));
+		cEntity->dead = (cRandom.NextUInt(8) == 0);
+		cEntity->SetAsleep(cRandom.NextUInt(4) == 0);
+		UpdateUVCoordinate(cEntity);
+	}
+}
+
+/**
+ @brief Gathering the entities into the pools, updating the transforms and scattering them back
+		leaves the state of the entities unchanged
+ */
+static void TestRoundTrip(void)
+{
+	const unsigned int NUM_ENTITIES = 200;
+
+	TestStore sStore;
+	CRandom cRandom(5u, 0u);
+	CreateRandomEntities(sStore, NUM_ENTITIES, cRandom);
+
+	// Keep a copy of the state of the entities
+	std::vector<CTestEntity2D> vExpected;
+	for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+		vExpected.push_back(*sStore.vEntities[i]);
+
+	for (int iFrame = 0; iFrame < 3; iFrame++)
+	{
+		sStore.cComponentStore2D->Gather();
+		sStore.cComponentStore2D->UpdateTransforms();
+		sStore.cComponentStore2D->Scatter();
+	}
+
+	bool bUnchanged = true;
+	for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+	{
+		const CTestEntity2D* cEntity = sStore.vEntities[i];
+		bUnchanged = bUnchanged &&
+			(cEntity->vec2UVCoordinate == vExpected[i].vec2UVCoordinate) &&
+			(cEntity->i32vec2Index == vExpected[i].i32vec2Index) &&
+			(cEntity->i32vec2NumMicroSteps == vExpected[i].i32vec2NumMicroSteps) &&
+			(cEntity->dead == vExpected[i].dead) &&
+			(cEntity->IsAsleep() == vExpected[i].IsAsleep());
+	}
+	TEST_CHECK(bUnchanged);
+
+	// The pools hold the same state, at the dense index of each entity
+	bool bGathered = true;
+	for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+	{
+		const CTestEntity2D* cEntity = sStore.vEntities[i];
+		const unsigned int uiIndex = sStore.cComponentStore2D->GetDenseIndex(cEntity->uiComponentHandle);
+		bGathered = bGathered &&
+			(sStore.cComponentStore2D->GetOwner(uiIndex) == cEntity) &&
+			(sStore.cComponentStore2D->sTransform.vec2UVCoordinate[uiIndex] == cEntity->vec2UVCoordinate) &&
+			(sStore.cComponentStore2D->sTilePosition.i32vec2Index[uiIndex] == cEntity->i32vec2Index) &&
+			((sStore.cComponentStore2D->sCollider.bDead[uiIndex] != 0) == cEntity->dead) &&
+			((sStore.cComponentStore2D->sCollider.bAsleep[uiIndex] != 0) == cEntity->IsAsleep());
+	}
+	TEST_CHECK(bGathered);
+
+	// Destroying components moves the last components into the gap, and the round trip is still unchanged
+	sStore.cComponentStore2D->Destroy(sStore.vEntities[0]->uiComponentHandle);
+	sStore.cComponentStore2D->Destroy(sStore.vEntities[NUM_ENTITIES / 2]->uiComponentHandle);
+	TEST_CHECK(sStore.vEntities[0]->uiComponentHandle == CComponentStore2D::INVALID_HANDLE);
+	TEST_CHECK(sStore.cComponentStore2D->GetNumComponents() == NUM_ENTITIES - 2);
+	sStore.cComponentStore2D->Gather();
+	sStore.cComponentStore2D->UpdateTransforms();
+	sStore.cComponentStore2D->Scatter();
+	bUnchanged = true;
+	for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+		bUnchanged = bUnchanged && (sStore.vEntities[i]->vec2UVCoordinate == vExpected[i].vec2UVCoordinate);
+	TEST_CHECK(bUnchanged);
+}
+
+/**
+ @brief Benchmark updating the transforms in the pools, against updating the UV coordinate of each entity
+ */
+static void BenchmarkTransforms(void)
+{
+	const unsigned int NUM_ENTITIES = 4096;
+	const int NUM_FRAMES = 500;
+
+	TestStore sStore;
+	CRandom cRandom(7u, 0u);
+	CreateRandomEntities(sStore, NUM_ENTITIES, cRandom);
+
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		for (unsigned int i = 0; i < NUM_ENTITIES; i++)
+			UpdateUVCoordinate(sStore.vEntities[i]);
+	}
+	const double dEntityTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+		sStore.cComponentStore2D->UpdateTransforms();
+	const double dSystemTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		sStore.cComponentStore2D->Gather();
+		sStore.cComponentStore2D->UpdateTransforms();
+		sStore.cComponentStore2D->Scatter();
+	}
+	const double dRoundTripTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	const double dNumUpdates = (double)NUM_FRAMES * NUM_ENTITIES;
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Entity UV updates", dNumUpdates / dEntityTime, "entities/s");
+	cTestHarness->Report("UpdateTransforms", dNumUpdates / dSystemTime, "entities/s");
+	cTestHarness->Report("Gather, UpdateTransforms and Scatter", dNumUpdates / dRoundTripTime, "entities/s");
+}
+
+/**
+ @brief Run the tests of the component store
+ */
+void RunComponentStoreTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("ComponentStore.CollisionPairs", TestCollisionPairs);
+	cTestHarness->Run("ComponentStore.CollisionSleep", TestCollisionSleep);
+	cTestHarness->Run("ComponentStore.RoundTrip", TestRoundTrip);
+	cTestHarness->Run("ComponentStore.Benchmark", BenchmarkTransforms);
+}
@@ -0,0 +1,141 @@
+/**
+ Tests of the sleep and wake states of CEntity2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include Entity2D
+#include "Primitives\Entity2D.h"
+
+/**
+ An entity which is at rest when it is told to be, as a bomb is when it lands
+ */
+class CRestingEntity2D : public CEntity2D
+{
+public:
+	CRestingEntity2D(void)
+		: bAtRest(false)
+		, uiNumWakes(0)
+	{
+	}
+
+	bool IsAtRest(void) const
+	{
+		return (!dead && bAtRest);
+	}
+
+	// Wake up and start falling again, as a bomb does
+	void Wake(void)
+	{
+		CEntity2D::Wake();
+		bAtRest = false;
+		uiNumWakes++;
+	}
+
+	bool bAtRest;
+	unsigned int uiNumWakes;
+};
+
+/**
+ @brief An entity falls asleep after it has been at rest for the number of frames, and stays asleep
+ */
+static void TestFallAsleep(void)
+{
+	CRestingEntity2D cEntity;
+	TEST_CHECK(cEntity.IsAsleep() == false);
+
+	cEntity.bAtRest = true;
+	for (int i = 0; i < 4; i++)
+	{
+		TEST_CHECK(cEntity.UpdateSleepState(5) == false);
+		TEST_CHECK(cEntity.IsAsleep() == false);
+	}
+	TEST_CHECK(cEntity.UpdateSleepState(5) == true);
+	TEST_CHECK(cEntity.IsAsleep());
+	TEST_CHECK(cEntity.UpdateSleepState(5) == true);
+
+	// An entity which must rest for 1 frame, or for no frames, falls asleep on its first frame at rest
+	CRestingEntity2D cQuick;
+	cQuick.bAtRest = true;
+	TEST_CHECK(cQuick.UpdateSleepState(1) == true);
+	CRestingEntity2D cQuickest;
+	cQuickest.bAtRest = true;
+	TEST_CHECK(cQuickest.UpdateSleepState(0) == true);
+}
+
+/**
+ @brief A frame which is not at rest restarts the count, so only consecutive frames at rest put an entity to sleep
+ */
+static void TestRestartCount(void)
+{
+	CRestingEntity2D cEntity;
+	cEntity.bAtRest = true;
+	for (int i = 0; i < 4; i++)
+		cEntity.UpdateSleepState(5);
+
+	cEntity.bAtRest = false;
+	TEST_CHECK(cEntity.UpdateSleepState(5) == false);
+
+	cEntity.bAtRest = true;
+	for (int i = 0; i < 4; i++)
+		TEST_CHECK(cEntity.UpdateSleepState(5) == false);
+	TEST_CHECK(cEntity.UpdateSleepState(5) == true);
+
+	// A dead entity is never at rest, so it does not fall asleep
+	CRestingEntity2D cDead;
+	cDead.bAtRest = true;
+	cDead.dead = true;
+	for (int i = 0; i < 10; i++)
+		cDead.UpdateSleepState(5);
+	TEST_CHECK(cDead.IsAsleep() == false);
+
+	// An entity which does not say when it is at rest is never put to sleep
+	CEntity2D cEntity2D;
+	for (int i = 0; i < 10; i++)
+		cEntity2D.UpdateSleepState(5);
+	TEST_CHECK(cEntity2D.IsAsleep() == false);
+}
+
+/**
+ @brief Waking an entity up, such as when its resting tile is changed, restarts the count,
+		so it is not put back to sleep on the next frame
+ */
+static void TestWake(void)
+{
+	CRestingEntity2D cEntity;
+	cEntity.bAtRest = true;
+	for (int i = 0; i < 5; i++)
+		cEntity.UpdateSleepState(5);
+	TEST_CHECK(cEntity.IsAsleep());
+
+	cEntity.Wake();
+	TEST_CHECK(cEntity.IsAsleep() == false);
+	TEST_CHECK(cEntity.uiNumWakes == 1);
+
+	// It falls, and lands again on the next frame, so it must rest for the full number of frames again
+	TEST_CHECK(cEntity.UpdateSleepState(5) == false);
+	cEntity.bAtRest = true;
+	for (int i = 0; i < 4; i++)
+		TEST_CHECK(cEntity.UpdateSleepState(5) == false);
+	TEST_CHECK(cEntity.UpdateSleepState(5) == true);
+
+	// Waking an entity which was only resting does not let it keep its count either
+	CRestingEntity2D cResting;
+	cResting.bAtRest = true;
+	for (int i = 0; i < 4; i++)
+		cResting.UpdateSleepState(5);
+	cResting.CEntity2D::Wake();
+	TEST_CHECK(cResting.UpdateSleepState(5) == false);
+}
+
+/**
+ @brief Run the tests of CEntity2D
+ */
+void RunEntityTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("Entity.FallAsleep", TestFallAsleep);
+	cTestHarness->Run("Entity.RestartCount", TestRestartCount);
+	cTestHarness->Run("Entity.Wake", TestWake);
+}
@@ -0,0 +1,230 @@
+/**
+ Tests of CEntityPool2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include EntityPool2D
+#include "Primitives\EntityPool2D.h"
+
+#include <vector>
+#include <set>
+#include <chrono>
+
+/**
+ A pooled entity which counts how many instances were constructed, and can be put to sleep directly
+ */
+class CPooledEntity2D : public CEntity2D
+{
+public:
+	static unsigned int uiNumConstructed;
+
+	CPooledEntity2D(void)
+	{
+		uiNumConstructed++;
+	}
+
+	void SetAsleep(const bool bAsleep)
+	{
+		this->bAsleep = bAsleep;
+	}
+};
+unsigned int CPooledEntity2D::uiNumConstructed = 0;
+
+/**
+ A pool which shows how much memory its free list has reserved
+ */
+class CTestEntityPool2D : public CEntityPool2D<CPooledEntity2D>
+{
+public:
+	size_t GetFreeListCapacity(void) const
+	{
+		return vFreeEntities.capacity();
+	}
+};
+
+/**
+ @brief The entities which are released are acquired again, and an exhausted pool returns NULL
+ */
+static void TestReuse(void)
+{
+	CTestEntityPool2D cPool;
+	cPool.Init(4);
+	TEST_CHECK(cPool.GetCapacity() == 4);
+	TEST_CHECK(cPool.GetNumActive() == 0);
+
+	std::set<CPooledEntity2D*> setEntities;
+	for (int i = 0; i < 4; i++)
+	{
+		CPooledEntity2D* cEntity = cPool.Acquire();
+		TEST_CHECK(cEntity != NULL);
+		TEST_CHECK(cEntity->GetOwnerPool() == &cPool);
+		setEntities.insert(cEntity);
+	}
+	TEST_CHECK(setEntities.size() == 4);
+	TEST_CHECK(cPool.GetNumActive() == 4);
+	TEST_CHECK(cPool.Acquire() == NULL);
+
+	// The last entity which was released is the next one to be acquired
+	CPooledEntity2D* cReleased = *setEntities.begin();
+	cPool.Release(cReleased);
+	TEST_CHECK(cPool.GetNumActive() == 3);
+	TEST_CHECK(cPool.Acquire() == cReleased);
+	TEST_CHECK(cPool.Acquire() == NULL);
+
+	// Init allocates a new set of entities
+	cPool.Init(2);
+	TEST_CHECK(cPool.GetCapacity() == 2);
+	TEST_CHECK(cPool.GetNumActive() == 0);
+}
+
+/**
+ @brief Acquiring and releasing entities after Init does not construct any entities or grow the free list
+ */
+static void TestNoAllocation(void)
+{
+	CTestEntityPool2D cPool;
+	cPool.Init(16);
+	const unsigned int uiNumConstructed = CPooledEntity2D::uiNumConstructed;
+	const size_t uiFreeListCapacity = cPool.GetFreeListCapacity();
+
+	// Spawn and despawn entities in waves, as the bombs are
+	std::vector<CPooledEntity2D*> vActive;
+	vActive.reserve(16);
+	for (int iWave = 0; iWave < 1000; iWave++)
+	{
+		const unsigned int uiNumToSpawn = 1 + (iWave * 7) % 16;
+		while (vActive.size() < uiNumToSpawn)
+			vActive.push_back(cPool.Acquire());
+		while (vActive.size() > uiNumToSpawn / 2)
+		{
+			cPool.Release(vActive.back());
+			vActive.pop_back();
+		}
+	}
+	TEST_CHECK(CPooledEntity2D::uiNumConstructed == uiNumConstructed);
+	TEST_CHECK(cPool.GetFreeListCapacity() == uiFreeListCapacity);
+	TEST_CHECK(cPool.GetNumActive() == vActive.size());
+}
+
+/**
+ @brief An entity which died or fell asleep in its previous life is alive, awake and not interpolated when it is acquired again
+ */
+static void TestStateReset(void)
+{
+	CTestEntityPool2D cPool;
+	cPool.Init(1);
+
+	CPooledEntity2D* cEntity = cPool.Acquire();
+	cEntity->vec2UVCoordinate = glm::vec2(0.5f, 0.5f);
+	cEntity->StoreRenderTransform();
+	cEntity->vec2UVCoordinate = glm::vec2(0.75f, 0.5f);
+	cEntity->StoreRenderTransform();
+	cEntity->dead = true;
+	cEntity->SetAsleep(true);
+	cPool.Release(cEntity);
+
+	CEntity2D::SetRenderAlpha(0.0f);
+	TEST_CHECK(cPool.Acquire() == cEntity);
+	TEST_CHECK(cEntity->dead == false);
+	TEST_CHECK(cEntity->IsAsleep() == false);
+	// The entity is spawned somewhere else, and is rendered there instead of moving from its old position
+	cEntity->vec2UVCoordinate = glm::vec2(-0.5f, 0.0f);
+	TEST_CHECK(cEntity->GetRenderUVCoordinate() == glm::vec2(-0.5f, 0.0f));
+	CEntity2D::SetRenderAlpha(1.0f);
+}
+
+/**
+ @brief Releasing an entity twice, or an entity from another pool, does not add it to the free list again
+ */
+static void TestDoubleRelease(void)
+{
+	CTestEntityPool2D cPool;
+	cPool.Init(3);
+	CTestEntityPool2D cOtherPool;
+	cOtherPool.Init(1);
+
+	CPooledEntity2D* cFirst = cPool.Acquire();
+	CPooledEntity2D* cSecond = cPool.Acquire();
+	cPool.Release(cFirst);
+	cPool.Release(cFirst);
+	TEST_CHECK(cPool.GetNumActive() == 1);
+
+	// An entity from another pool, and an entity which is not pooled, are not added
+	CPooledEntity2D* cOther = cOtherPool.Acquire();
+	cPool.Release(cOther);
+	CPooledEntity2D cUnpooled;
+	cPool.Release(&cUnpooled);
+	cPool.Release(NULL);
+	TEST_CHECK(cPool.GetNumActive() == 1);
+
+	// Every entity is handed out once
+	std::set<CPooledEntity2D*> setEntities;
+	setEntities.insert(cSecond);
+	CPooledEntity2D* cEntity;
+	while ((cEntity = cPool.Acquire()) != NULL)
+		setEntities.insert(cEntity);
+	TEST_CHECK(setEntities.size() == 3);
+	TEST_CHECK(cPool.GetNumActive() == 3);
+	TEST_CHECK(setEntities.count(cOther) == 0);
+}
+
+/**
+ @brief Benchmark throwing bombs at a high rate from a pool of 32, as the entity manager does,
+		against allocating and deleting a bomb for each throw
+ */
+static void BenchmarkThrow(void)
+{
+	const unsigned int NUM_BOMBS = 32;
+	const int NUM_THROWS = 200000;
+
+	CTestEntityPool2D cPool;
+	cPool.Init(NUM_BOMBS);
+	const unsigned int uiNumConstructed = CPooledEntity2D::uiNumConstructed;
+
+	// Each bomb lives until the pool is full, and then the oldest one explodes
+	std::vector<CPooledEntity2D*> vLiveBombs(NUM_BOMBS, (CPooledEntity2D*)NULL);
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_THROWS; i++)
+	{
+		CPooledEntity2D*& cOldest = vLiveBombs[i % NUM_BOMBS];
+		if (cOldest)
+			cPool.Release(cOldest);
+		cOldest = cPool.Acquire();
+		cOldest->i32vec2Index = glm::i32vec2(i % 32, 24);
+	}
+	const double dPoolTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+	TEST_CHECK(CPooledEntity2D::uiNumConstructed == uiNumConstructed);
+	TEST_CHECK(cPool.GetNumActive() == NUM_BOMBS);
+
+	std::fill(vLiveBombs.begin(), vLiveBombs.end(), (CPooledEntity2D*)NULL);
+	tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_THROWS; i++)
+	{
+		CPooledEntity2D*& cOldest = vLiveBombs[i % NUM_BOMBS];
+		delete cOldest;
+		cOldest = new CPooledEntity2D();
+		cOldest->i32vec2Index = glm::i32vec2(i % 32, 24);
+	}
+	const double dNewTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+	for (unsigned int i = 0; i < NUM_BOMBS; i++)
+		delete vLiveBombs[i];
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Pooled throws", NUM_THROWS / dPoolTime, "throws/s");
+	cTestHarness->Report("Allocated throws", NUM_THROWS / dNewTime, "throws/s");
+}
+
+/**
+ @brief Run the tests of CEntityPool2D
+ */
+void RunEntityPoolTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("EntityPool.Reuse", TestReuse);
+	cTestHarness->Run("EntityPool.NoAllocation", TestNoAllocation);
+	cTestHarness->Run("EntityPool.StateReset", TestStateReset);
+	cTestHarness->Run("EntityPool.DoubleRelease", TestDoubleRelease);
+	cTestHarness->Run("EntityPool.Benchmark", BenchmarkThrow);
+}
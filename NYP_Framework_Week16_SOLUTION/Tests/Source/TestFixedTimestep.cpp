@@ -0,0 +1,126 @@
+/**
+ Tests of CFixedTimestep
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include FixedTimestep
+#include "TimeControl\FixedTimestep.h"
+// Include Random
+#include "System\Random.h"
+
+// A step time which is exact in binary, so that the alphas can be compared exactly
+static const double STEP_TIME = 1.0 / 64.0;
+
+/**
+ @brief Each Advance returns the number of whole steps in the time which was accumulated
+ */
+static void TestSteps(void)
+{
+	CFixedTimestep cFixedTimestep;
+	cFixedTimestep.Init(STEP_TIME, 5);
+	TEST_CHECK(cFixedTimestep.GetStepTime() == STEP_TIME);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.0);
+
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME) == 1);
+	// Half a step is kept for the next frame
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME / 2.0) == 0);
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME / 2.0) == 1);
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 3.25) == 3);
+
+	// A frame without time, or with a negative time from a clock which went back, does not step
+	TEST_CHECK(cFixedTimestep.Advance(0.0) == 0);
+	TEST_CHECK(cFixedTimestep.Advance(-1.0) == 0);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.25);
+
+	// The steps keep up with the frames over time, whatever the frame rate is
+	cFixedTimestep.Init(1.0 / 60.0, 5);
+	unsigned int uiNumSteps = 0;
+	for (int i = 0; i < 144; i++)
+		uiNumSteps += cFixedTimestep.Advance(1.0 / 144.0);
+	TEST_CHECK((uiNumSteps == 59) || (uiNumSteps == 60));
+	for (int i = 0; i < 30; i++)
+		uiNumSteps += cFixedTimestep.Advance(1.0 / 30.0);
+	TEST_CHECK((uiNumSteps == 119) || (uiNumSteps == 120));
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 0);
+}
+
+/**
+ @brief A slow frame simulates at most the highest number of steps per frame, and the rest of its time is dropped
+ */
+static void TestStepCap(void)
+{
+	CFixedTimestep cFixedTimestep;
+	cFixedTimestep.Init(STEP_TIME, 5);
+
+	// 10 steps of time are capped at 5 steps, and the other 5 are dropped
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 10.0) == 5);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 1);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.0);
+
+	// 5 and a half steps fit in the cap, and the half step is kept
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 5.5) == 5);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 1);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.5);
+
+	// With the half step, there are 6 steps of time, so 1 step is dropped with the fraction after it
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 5.5) == 5);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 2);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.0);
+
+	// A frame which is not slow does not count as dropped
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME) == 1);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 2);
+
+	// A lower cap
+	cFixedTimestep.Init(STEP_TIME, 2);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 0);
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 3.0) == 2);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() == 1);
+
+	// Init resets the time which was accumulated
+	cFixedTimestep.Advance(STEP_TIME * 0.75);
+	cFixedTimestep.Init(STEP_TIME, 5);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.0);
+	TEST_CHECK(cFixedTimestep.Advance(STEP_TIME * 0.75) == 0);
+}
+
+/**
+ @brief The alpha is the fraction of a step which is left over, and it stays between 0 and 1
+ */
+static void TestAlpha(void)
+{
+	CFixedTimestep cFixedTimestep;
+	cFixedTimestep.Init(STEP_TIME, 5);
+
+	cFixedTimestep.Advance(STEP_TIME * 0.25);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.25);
+	cFixedTimestep.Advance(STEP_TIME * 0.5);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.75);
+	cFixedTimestep.Advance(STEP_TIME * 0.5);
+	TEST_CHECK(cFixedTimestep.GetAlpha() == 0.25);
+
+	// Random frame times, including slow frames which are capped
+	CRandom cRandom(3u, 0u);
+	bool bInRange = true;
+	for (int i = 0; i < 10000; i++)
+	{
+		cFixedTimestep.Advance(cRandom.RandFloatMinMax(0.0f, (float)(STEP_TIME * 8.0)));
+		const double dAlpha = cFixedTimestep.GetAlpha();
+		bInRange = bInRange && (dAlpha >= 0.0) && (dAlpha < 1.0);
+	}
+	TEST_CHECK(bInRange);
+	TEST_CHECK(cFixedTimestep.GetNumDroppedFrames() > 0);
+}
+
+/**
+ @brief Run the tests of CFixedTimestep
+ */
+void RunFixedTimestepTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("FixedTimestep.Steps", TestSteps);
+	cTestHarness->Run("FixedTimestep.StepCap", TestStepCap);
+	cTestHarness->Run("FixedTimestep.Alpha", TestAlpha);
+}
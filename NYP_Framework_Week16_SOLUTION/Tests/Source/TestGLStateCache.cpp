@@ -0,0 +1,227 @@
+/**
+ Tests of CGLStateCache
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+
+#include <chrono>
+
+/**
+ @brief The first call of each state is sent, as the state is not known, and a call with the same value is filtered
+ */
+static void TestRedundantCalls(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CGLStateCache* cGLStateCache = CGLStateCache::GetInstance();
+
+	for (int i = 0; i < 3; i++)
+	{
+		cGLStateCache->UseProgram(1);
+		cGLStateCache->BindVertexArray(2);
+		cGLStateCache->ActiveTexture(GL_TEXTURE0);
+		cGLStateCache->BindTexture(GL_TEXTURE_2D, 3);
+		cGLStateCache->Enable(GL_BLEND);
+		cGLStateCache->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		cGLStateCache->Disable(GL_DEPTH_TEST);
+		cGLStateCache->DepthFunc(GL_LESS);
+		cGLStateCache->Viewport(0, 0, 800, 600);
+	}
+	TEST_CHECK(cGLStub->GetNumCalls("glUseProgram") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindVertexArray") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glActiveTexture") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glEnable") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glBlendFunc") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glDisable") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glDepthFunc") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glViewport") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls() == 9);
+	TEST_CHECK(cGLStateCache->GetNumIssuedCalls() == 9);
+	TEST_CHECK(cGLStateCache->GetNumFilteredCalls() == 18);
+
+	// A changed value is sent
+	cGLStateCache->UseProgram(4);
+	cGLStateCache->BlendFunc(GL_ONE, GL_ONE);
+	cGLStateCache->Viewport(0, 0, 1024, 768);
+	cGLStateCache->Enable(GL_DEPTH_TEST);
+	TEST_CHECK(cGLStub->GetNumCalls() == 13);
+	TEST_CHECK(cGLStateCache->GetNumIssuedCalls() == 13);
+
+	cGLStateCache->ResetCallCounts();
+	TEST_CHECK(cGLStateCache->GetNumIssuedCalls() == 0);
+	TEST_CHECK(cGLStateCache->GetNumFilteredCalls() == 0);
+
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief The 2D texture of each texture unit is kept, so switching between units does not bind their textures again
+ */
+static void TestTextureUnits(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CGLStateCache* cGLStateCache = CGLStateCache::GetInstance();
+
+	for (int i = 0; i < 3; i++)
+	{
+		cGLStateCache->ActiveTexture(GL_TEXTURE0);
+		cGLStateCache->BindTexture(GL_TEXTURE_2D, 1);
+		cGLStateCache->ActiveTexture(GL_TEXTURE1);
+		cGLStateCache->BindTexture(GL_TEXTURE_2D, 2);
+	}
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glActiveTexture") == 6);
+
+	// Another target, and a unit beyond the ones which are tracked, are always sent
+	cGLStateCache->BindTexture(GL_TEXTURE_CUBE_MAP, 3);
+	cGLStateCache->BindTexture(GL_TEXTURE_CUBE_MAP, 3);
+	cGLStateCache->ActiveTexture(GL_TEXTURE0 + CGLStateCache::MAX_TEXTURE_UNITS);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, 4);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, 4);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 6);
+
+	// A capability which is not tracked is always sent
+	cGLStateCache->Enable(GL_CULL_FACE);
+	cGLStateCache->Enable(GL_CULL_FACE);
+	TEST_CHECK(cGLStub->GetNumCalls("glEnable") == 2);
+	TEST_CHECK(cGLStateCache->GetNumIssuedCalls() == cGLStub->GetNumCalls());
+
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief A deleted object is unbound from the copy, so a new object which is given its name is bound
+ */
+static void TestDelete(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CGLStateCache* cGLStateCache = CGLStateCache::GetInstance();
+
+	// The texture is bound to 2 units, and both are unbound when it is deleted
+	const GLuint uiTexture = 5;
+	cGLStateCache->ActiveTexture(GL_TEXTURE0);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	cGLStateCache->ActiveTexture(GL_TEXTURE1);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	cGLStateCache->DeleteTextures(1, &uiTexture);
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteTextures") == 1);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	cGLStateCache->ActiveTexture(GL_TEXTURE0);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 4);
+	// OpenGL binds 0 in place of the deleted texture, so binding 0 is filtered
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	cGLStateCache->DeleteTextures(1, &uiTexture);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, 0);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 4);
+
+	const GLuint uiVertexArray = 6;
+	cGLStateCache->BindVertexArray(uiVertexArray);
+	cGLStateCache->DeleteVertexArrays(1, &uiVertexArray);
+	cGLStateCache->BindVertexArray(uiVertexArray);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindVertexArray") == 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteVertexArrays") == 1);
+
+	// A program in use is forgotten when it is deleted
+	cGLStateCache->UseProgram(7);
+	cGLStateCache->DeleteProgram(7);
+	cGLStateCache->UseProgram(7);
+	TEST_CHECK(cGLStub->GetNumCalls("glUseProgram") == 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteProgram") == 1);
+
+	// Deleting an object which is not bound does not change the copy
+	const GLuint uiOtherTexture = 8;
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	cGLStateCache->DeleteTextures(1, &uiOtherTexture);
+	cGLStateCache->BindTexture(GL_TEXTURE_2D, uiTexture);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 5);
+
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief After the copy is invalidated, the next change of each state is sent
+ */
+static void TestInvalidate(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CGLStateCache* cGLStateCache = CGLStateCache::GetInstance();
+
+	cGLStateCache->UseProgram(1);
+	cGLStateCache->Enable(GL_BLEND);
+	cGLStateCache->Viewport(0, 0, 800, 600);
+	cGLStateCache->Invalidate();
+	cGLStateCache->UseProgram(1);
+	cGLStateCache->Enable(GL_BLEND);
+	cGLStateCache->Viewport(0, 0, 800, 600);
+	TEST_CHECK(cGLStub->GetNumCalls() == 6);
+	TEST_CHECK(cGLStateCache->GetNumFilteredCalls() == 0);
+
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Benchmark the calls of a frame of sprites, which share a few programs and textures, as the scene draws them
+ */
+static void BenchmarkFrame(void)
+{
+	const int NUM_SPRITES = 10000;
+	const int NUM_FRAMES = 100;
+
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CGLStateCache* cGLStateCache = CGLStateCache::GetInstance();
+
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		cGLStateCache->ResetCallCounts();
+		cGLStateCache->Viewport(0, 0, 800, 600);
+		for (int i = 0; i < NUM_SPRITES; i++)
+		{
+			// The tiles come first, and share a program, a vertex array and a texture atlas. The entities follow
+			cGLStateCache->UseProgram(i < NUM_SPRITES * 3 / 4 ? 1 : 2);
+			cGLStateCache->BindVertexArray(i < NUM_SPRITES * 3 / 4 ? 1 : 2 + i % 2);
+			cGLStateCache->ActiveTexture(GL_TEXTURE0);
+			cGLStateCache->BindTexture(GL_TEXTURE_2D, i < NUM_SPRITES * 3 / 4 ? 1 : 2 + i % 8);
+			cGLStateCache->Enable(GL_BLEND);
+			cGLStateCache->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			cGLStateCache->BindVertexArray(0);
+		}
+	}
+	const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	const unsigned int uiNumCalls = cGLStateCache->GetNumIssuedCalls() + cGLStateCache->GetNumFilteredCalls();
+	TEST_CHECK(uiNumCalls == 1 + NUM_SPRITES * 7);
+	TEST_CHECK(cGLStateCache->GetNumIssuedCalls() < uiNumCalls / 2);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("State calls per frame", uiNumCalls, "calls");
+	cTestHarness->Report("Calls sent per frame", cGLStateCache->GetNumIssuedCalls(), "calls");
+	cTestHarness->Report("Calls filtered", 100.0 * cGLStateCache->GetNumFilteredCalls() / uiNumCalls, "%");
+	cTestHarness->Report("State calls", (double)uiNumCalls * NUM_FRAMES / dTime / 1.0e6, "million calls/s");
+
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Run the tests of CGLStateCache
+ */
+void RunGLStateCacheTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("GLStateCache.RedundantCalls", TestRedundantCalls);
+	cTestHarness->Run("GLStateCache.TextureUnits", TestTextureUnits);
+	cTestHarness->Run("GLStateCache.Delete", TestDelete);
+	cTestHarness->Run("GLStateCache.Invalidate", TestInvalidate);
+	cTestHarness->Run("GLStateCache.Benchmark", BenchmarkFrame);
+}
@@ -0,0 +1,140 @@
+/**
+ Tests of CGravityKernel2D, against the per-direction code which it replaced
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include GravityKernel2D
+#include "Scene2D\GravityKernel2D.h"
+// Include KinematicSolver2D
+#include "Scene2D\KinematicSolver2D.h"
+// Include Random
+#include "System\Random.h"
+
+// The values of CSettings which the player and the bombs convert their displacements with
+static const float TILE_HEIGHT = 2.0f / 24.0f;
+static const float WINDOW_HEIGHT = 600.0f;
+static const float NUM_STEPS_PER_TILE_XAXIS = 4.0f;
+static const float NUM_STEPS_PER_TILE_YAXIS = 4.0f;
+
+/**
+ @brief Translate a displacement into a number of tiles, as the player and the bombs did for each axis
+		before the kernel. The player rounded up any partial tile, and the bombs only rounded up a positive one
+ */
+static int LegacyDisplacementToTiles(const float fDisplacement, const float fNumStepsPerTile, const bool bRoundAnyPartialTile)
+{
+	int iDisplacement = (int)(fDisplacement / TILE_HEIGHT);
+	int iDisplacement_MicroSteps = (int)((fDisplacement * WINDOW_HEIGHT) - iDisplacement) /
+		(int)fNumStepsPerTile;
+	if (bRoundAnyPartialTile ? (iDisplacement_MicroSteps != 0) : (iDisplacement_MicroSteps > 0))
+	{
+		iDisplacement++;
+	}
+	return iDisplacement;
+}
+
+/**
+ @brief Check one instance of the kernel against the per-direction code
+ @return true if every check passed
+ */
+template<CPhysics2D::GRAVITY_DIRECTION eGravityDirection>
+static bool CheckKernel(void)
+{
+	typedef CGravityKernel2D<eGravityDirection> KERNEL;
+	bool bPassed = true;
+
+	// The UP and DOWN vectors are the ones which the kinematic solver uses for this direction
+	bPassed = bPassed && (KERNEL::GetUpVector() == CKinematicSolver2D::GetDirVector(eGravityDirection, CPhysics2D::UP));
+	bPassed = bPassed && (KERNEL::GetDownVector() == CKinematicSolver2D::GetDirVector(eGravityDirection, CPhysics2D::DOWN));
+	bPassed = bPassed && (KERNEL::GetUpVector()[KERNEL::AXIS] == KERNEL::UP_SIGN);
+	bPassed = bPassed && (KERNEL::GetUpVector()[1 - KERNEL::AXIS] == 0);
+
+	// The displacement along the axis is converted with the number of microsteps of that axis,
+	// and the displacement along the other axis is ignored
+	const float fNumStepsPerTile = KERNEL::GetNumStepsPerTile(NUM_STEPS_PER_TILE_XAXIS, NUM_STEPS_PER_TILE_YAXIS);
+	bPassed = bPassed && (fNumStepsPerTile == ((KERNEL::AXIS == 0) ? NUM_STEPS_PER_TILE_XAXIS : NUM_STEPS_PER_TILE_YAXIS));
+	CRandom cRandom(11u, (unsigned int)eGravityDirection);
+	for (int i = 0; i < 2000; i++)
+	{
+		const float fDisplacement = cRandom.RandFloatMinMax(-0.5f, 0.5f);
+		glm::vec2 v2Displacement(cRandom.RandFloatMinMax(-0.5f, 0.5f), cRandom.RandFloatMinMax(-0.5f, 0.5f));
+		v2Displacement[KERNEL::AXIS] = fDisplacement;
+		for (int iRound = 0; iRound < 2; iRound++)
+		{
+			const bool bRoundAnyPartialTile = (iRound == 1);
+			bPassed = bPassed && (KERNEL::DisplacementToTiles(v2Displacement, TILE_HEIGHT, WINDOW_HEIGHT,
+																fNumStepsPerTile, bRoundAnyPartialTile) ==
+								  LegacyDisplacementToTiles(fDisplacement, fNumStepsPerTile, bRoundAnyPartialTile));
+		}
+	}
+
+	// The bottom row is the one which the kinematic solver finds for this direction, including outside the grid
+	const TileGridView2D sGrid(NULL, 24, 32);
+	for (int iRow = -2; iRow <= sGrid.iNumRows + 1; iRow++)
+	{
+		for (int iCol = -2; iCol <= sGrid.iNumCols + 1; iCol++)
+		{
+			const glm::i32vec2 i32vec2Index(iCol, iRow);
+			bPassed = bPassed && (KERNEL::IsOnBottomRow(sGrid, i32vec2Index) ==
+								  CKinematicSolver2D::IsOnBottomRow(sGrid, i32vec2Index, eGravityDirection));
+		}
+	}
+	return bPassed;
+}
+
+/**
+ @brief The axis and the sign of UP of each gravity direction
+ */
+static void TestTraits(void)
+{
+	TEST_CHECK((CGravityKernel2D<CPhysics2D::GRAVITY_DOWN>::AXIS == 1) && (CGravityKernel2D<CPhysics2D::GRAVITY_DOWN>::UP_SIGN == 1));
+	TEST_CHECK((CGravityKernel2D<CPhysics2D::GRAVITY_UP>::AXIS == 1) && (CGravityKernel2D<CPhysics2D::GRAVITY_UP>::UP_SIGN == -1));
+	TEST_CHECK((CGravityKernel2D<CPhysics2D::GRAVITY_RIGHT>::AXIS == 0) && (CGravityKernel2D<CPhysics2D::GRAVITY_RIGHT>::UP_SIGN == -1));
+	TEST_CHECK((CGravityKernel2D<CPhysics2D::GRAVITY_LEFT>::AXIS == 0) && (CGravityKernel2D<CPhysics2D::GRAVITY_LEFT>::UP_SIGN == 1));
+	TEST_CHECK(CGravityKernel2D<CPhysics2D::GRAVITY_DOWN>::GetDownVector() == glm::i32vec2(0, -1));
+	TEST_CHECK(CGravityKernel2D<CPhysics2D::GRAVITY_LEFT>::GetDownVector() == glm::i32vec2(-1, 0));
+}
+
+/**
+ @brief Some displacements, which end on whole tiles, partial tiles and less than a microstep
+ */
+static void TestDisplacement(void)
+{
+	typedef CGravityKernel2D<CPhysics2D::GRAVITY_DOWN> KERNEL;
+	const float fNumStepsPerTile = NUM_STEPS_PER_TILE_YAXIS;
+
+	// No displacement, and less than a microstep, stay on the tile
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, true) == 0);
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f, 0.005f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, true) == 0);
+	// A partial tile upwards is rounded up
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f, 0.01f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, false) == 1);
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f, 0.2f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, false) == 3);
+	// A partial tile downwards is only rounded when any partial tile is rounded
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f, -0.01f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, false) == 0);
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.0f, -0.01f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, true) == 1);
+	// The displacement along x is ignored when gravity acts along y
+	TEST_CHECK(KERNEL::DisplacementToTiles(glm::vec2(0.2f, 0.0f), TILE_HEIGHT, WINDOW_HEIGHT, fNumStepsPerTile, true) == 0);
+}
+
+/**
+ @brief Every instance of the kernel gives the same vectors, tiles and bottom rows as the per-direction code
+ */
+static void TestAgainstLegacy(void)
+{
+	TEST_CHECK(CheckKernel<CPhysics2D::GRAVITY_DOWN>());
+	TEST_CHECK(CheckKernel<CPhysics2D::GRAVITY_UP>());
+	TEST_CHECK(CheckKernel<CPhysics2D::GRAVITY_RIGHT>());
+	TEST_CHECK(CheckKernel<CPhysics2D::GRAVITY_LEFT>());
+}
+
+/**
+ @brief Run the tests of CGravityKernel2D
+ */
+void RunGravityKernelTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("GravityKernel.Traits", TestTraits);
+	cTestHarness->Run("GravityKernel.Displacement", TestDisplacement);
+	cTestHarness->Run("GravityKernel.AgainstLegacy", TestAgainstLegacy);
+}
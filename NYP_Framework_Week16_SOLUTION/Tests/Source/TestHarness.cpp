@@ -0,0 +1,111 @@
+/**
+ CTestHarness
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor This constructor has protected access modifier as this class will be a Singleton
+ */
+CTestHarness::CTestHarness(void)
+	: uiNumTests(0)
+	, uiNumFailedTests(0)
+	, uiNumChecks(0)
+	, uiNumFailures(0)
+{
+}
+
+/**
+ @brief Destructor This destructor has protected access modifier as this class will be a Singleton
+ */
+CTestHarness::~CTestHarness(void)
+{
+}
+
+/**
+ @brief Set the prefix of the names of the tests to run. An empty prefix runs all the tests
+ @param strFilter A const std::string& variable containing the prefix
+ */
+void CTestHarness::SetFilter(const std::string& strFilter)
+{
+	this->strFilter = strFilter;
+}
+
+/**
+ @brief Run a test if its name starts with the filter
+ @param cName A const char* variable containing the name of the test
+ @param fnTest A TEST variable containing the test
+ */
+void CTestHarness::Run(const char* cName, TEST fnTest)
+{
+	if (std::string(cName).compare(0, strFilter.size(), strFilter) != 0)
+		return;
+
+	const unsigned int uiFailuresBefore = uiNumFailures;
+	cout << "[ RUN  ] " << cName << endl;
+	fnTest();
+	uiNumTests++;
+
+	if (uiNumFailures == uiFailuresBefore)
+	{
+		cout << "[  OK  ] " << cName << endl;
+	}
+	else
+	{
+		cout << "[ FAIL ] " << cName << endl;
+		uiNumFailedTests++;
+	}
+}
+
+/**
+ @brief Check a condition, and print it if it failed
+ @param bCondition A const bool variable containing the result of the condition
+ @param cCondition A const char* variable containing the text of the condition
+ @param cFile A const char* variable containing the file of the check
+ @param iLine A const int variable containing the line of the check
+ @return The result of the condition
+ */
+bool CTestHarness::Check(const bool bCondition, const char* cCondition, const char* cFile, const int iLine)
+{
+	uiNumChecks++;
+	if (bCondition == false)
+	{
+		cout << cFile << "(" << iLine << "): Check failed: " << cCondition << endl;
+		uiNumFailures++;
+	}
+	return bCondition;
+}
+
+/**
+ @brief Report a measurement of a benchmark
+ @param cName A const char* variable containing the name of the measurement
+ @param dValue A const double variable containing the value
+ @param cUnit A const char* variable containing the unit of the value
+ */
+void CTestHarness::Report(const char* cName, const double dValue, const char* cUnit)
+{
+	cout << "         " << cName << ": " << dValue << " " << cUnit << endl;
+}
+
+/**
+ @brief Get the number of checks which failed
+ */
+unsigned int CTestHarness::GetNumFailures(void) const
+{
+	return uiNumFailures;
+}
+
+/**
+ @brief Print out the details about this class instance in the console
+ */
+void CTestHarness::PrintSelf(void) const
+{
+	cout << endl << "CTestHarness::PrintSelf()" << endl;
+	cout << "========================" << endl;
+	cout << "Tests\t=\t" << uiNumTests << " (" << uiNumFailedTests << " failed)" << endl;
+	cout << "Checks\t=\t" << uiNumChecks << " (" << uiNumFailures << " failed)" << endl;
+}
@@ -0,0 +1,65 @@
+/**
+ CTestHarness
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include string
+#include <string>
+
+// Check a condition in a test. A failed check is counted and printed, and the test goes on
+#define TEST_CHECK(condition) CTestHarness::GetInstance()->Check((condition), #condition, __FILE__, __LINE__)
+
+/**
+ CTestHarness: Runs the tests of the console test target, and counts the checks which failed.
+			   A test is a function which checks its results with TEST_CHECK.
+			   A benchmark is a test which also reports its throughput, and does not fail on a slow machine.
+			   The tests do not need a window or an OpenGL context, so they can be run on a build machine.
+ */
+class CTestHarness : public CSingletonTemplate<CTestHarness>
+{
+	friend CSingletonTemplate<CTestHarness>;
+public:
+	// A test
+	typedef void(*TEST)(void);
+
+	// Set the prefix of the names of the tests to run. An empty prefix runs all the tests
+	void SetFilter(const std::string& strFilter);
+
+	// Run a test if its name matches the filter
+	void Run(const char* cName, TEST fnTest);
+
+	// Check a condition, and print it if it failed
+	bool Check(const bool bCondition, const char* cCondition, const char* cFile, const int iLine);
+
+	// Report a measurement of a benchmark
+	void Report(const char* cName, const double dValue, const char* cUnit);
+
+	// Get the number of checks which failed
+	unsigned int GetNumFailures(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// The prefix of the names of the tests to run
+	std::string strFilter;
+
+	// The number of tests which were run, and which failed
+	unsigned int uiNumTests;
+	unsigned int uiNumFailedTests;
+
+	// The number of checks, and the number of checks which failed
+	unsigned int uiNumChecks;
+	unsigned int uiNumFailures;
+
+	// Constructor
+	CTestHarness(void);
+
+	// Destructor
+	virtual ~CTestHarness(void);
+};
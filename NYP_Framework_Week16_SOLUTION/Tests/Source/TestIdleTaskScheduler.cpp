@@ -0,0 +1,382 @@
+/**
+ Tests of CIdleTaskScheduler
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include IdleTaskScheduler
+#include "TimeControl\IdleTaskScheduler.h"
+
+#include <string>
+#include <chrono>
+#include <cmath>
+
+/**
+ @brief Keep the processor busy for a time, like a slice of work
+ @param dTime A const double variable containing the time in seconds
+ */
+static void Spin(const double dTime)
+{
+	const std::chrono::steady_clock::time_point tEnd =
+		std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(dTime));
+	while (std::chrono::steady_clock::now() < tEnd)
+	{
+	}
+}
+
+/**
+ A simulated clock for the scheduler, which only moves when a slice advances it,
+ so that the tests of the deadlines do not depend on the speed or the load of the machine
+ */
+struct SimulatedClock
+{
+	double dTime;
+
+	SimulatedClock(void)
+		: dTime(0.0)
+	{
+		SimulatedClock* pClock = this;
+		CIdleTaskScheduler::GetInstance()->SetClock([pClock]() { return pClock->dTime; });
+	}
+
+	~SimulatedClock(void)
+	{
+		CIdleTaskScheduler::GetInstance()->SetClock(CIdleTaskScheduler::CLOCK_FUNCTION());
+	}
+};
+
+/**
+ @brief The oldest task with the highest priority is run first
+ */
+static void TestPriorityOrder(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	std::string strOrder;
+	std::string* pOrder = &strOrder;
+	cIdleTaskScheduler->AddTask("Low", [pOrder]() { *pOrder += "L"; return true; }, CIdleTaskScheduler::PRIORITY_LOW);
+	cIdleTaskScheduler->AddTask("Normal 1", [pOrder]() { *pOrder += "1"; return true; });
+	cIdleTaskScheduler->AddTask("High", [pOrder]() { *pOrder += "H"; return true; }, CIdleTaskScheduler::PRIORITY_HIGH);
+	cIdleTaskScheduler->AddTask("Normal 2", [pOrder]() { *pOrder += "2"; return true; });
+	TEST_CHECK(cIdleTaskScheduler->GetNumPending() == 4);
+
+	cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(strOrder == "H12L");
+	TEST_CHECK(cIdleTaskScheduler->GetNumPending() == 0);
+	TEST_CHECK(cIdleTaskScheduler->GetNumSlices() == 4);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief A task is run one slice at a time until its slice function returns true
+ */
+static void TestSlices(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	int iNumSlices = 0;
+	int* pNumSlices = &iNumSlices;
+	const CIdleTaskScheduler::HANDLE hTask = cIdleTaskScheduler->AddTask("Five slices", [pNumSlices]()
+	{
+		(*pNumSlices)++;
+		return (*pNumSlices == 5);
+	});
+	TEST_CHECK(hTask != CIdleTaskScheduler::INVALID_HANDLE);
+	TEST_CHECK(cIdleTaskScheduler->IsPending(hTask));
+
+	cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(iNumSlices == 5);
+	TEST_CHECK(cIdleTaskScheduler->IsPending(hTask) == false);
+
+	// A task without a slice function is not added
+	TEST_CHECK(cIdleTaskScheduler->AddTask("Empty", CIdleTaskScheduler::SLICE_FUNCTION()) == CIdleTaskScheduler::INVALID_HANDLE);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief A slice is only started if its estimated time fits before the deadline, with the safety margin to spare
+ */
+static void TestDeadline(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+	SimulatedClock sClock;
+	SimulatedClock* pClock = &sClock;
+
+	// Slices of 3 ms in 10 ms, with 2 ms kept free: the first slice runs, and the second fits in the 5 ms left
+	int iNumSlices = 0;
+	int* pNumSlices = &iNumSlices;
+	cIdleTaskScheduler->AddTask("3 ms slices", [pClock, pNumSlices]()
+	{
+		pClock->dTime += 0.003;
+		(*pNumSlices)++;
+		return false;
+	});
+	const double dUsedTime = cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(iNumSlices == 2);
+	TEST_CHECK(fabs(dUsedTime - 0.006) < 1.0e-9);
+
+	// A slice which does not fit waits for a frame with more idle time
+	cIdleTaskScheduler->RunIdle(0.004);
+	TEST_CHECK(iNumSlices == 2);
+	cIdleTaskScheduler->RunIdle(0.0075);
+	TEST_CHECK(iNumSlices == 3);
+
+	// No time is not enough for any slice, even the first one
+	int iNumOtherSlices = 0;
+	int* pNumOtherSlices = &iNumOtherSlices;
+	cIdleTaskScheduler->AddTask("Other", [pNumOtherSlices]() { (*pNumOtherSlices)++; return true; },
+								CIdleTaskScheduler::PRIORITY_HIGH);
+	cIdleTaskScheduler->RunIdle(0.0);
+	cIdleTaskScheduler->RunIdle(0.001);
+	TEST_CHECK(iNumOtherSlices == 0);
+
+	// Over many frames, the slices stay within the deadlines
+	for (int i = 0; i < 100; i++)
+		cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(iNumOtherSlices == 1);
+	TEST_CHECK(iNumSlices == 203);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 0);
+	TEST_CHECK(cIdleTaskScheduler->GetUsedTime() <= cIdleTaskScheduler->GetAvailableTime());
+
+	// The first slice of a task has no estimate, so a slow first slice runs past the deadline once,
+	// and it is not started again in a frame which it does not fit in
+	int iNumSlowSlices = 0;
+	int* pNumSlowSlices = &iNumSlowSlices;
+	cIdleTaskScheduler->AddTask("12 ms slices", [pClock, pNumSlowSlices]()
+	{
+		pClock->dTime += 0.012;
+		(*pNumSlowSlices)++;
+		return false;
+	}, CIdleTaskScheduler::PRIORITY_HIGH);
+	for (int i = 0; i < 10; i++)
+		cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(iNumSlowSlices == 1);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 1);
+	TEST_CHECK(iNumSlices == 203 + 2 * 9);
+
+	// It runs again in a frame which is long enough
+	cIdleTaskScheduler->RunIdle(0.020);
+	TEST_CHECK(iNumSlowSlices == 2);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 1);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief A slice function may add and cancel tasks
+ */
+static void TestAddAndCancelInSlice(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	std::string strOrder;
+	std::string* pOrder = &strOrder;
+	CIdleTaskScheduler::HANDLE hVictim = CIdleTaskScheduler::INVALID_HANDLE;
+	CIdleTaskScheduler::HANDLE* pVictim = &hVictim;
+	cIdleTaskScheduler->AddTask("Spawner", [cIdleTaskScheduler, pOrder, pVictim]()
+	{
+		*pOrder += "S";
+		cIdleTaskScheduler->Cancel(*pVictim);
+		cIdleTaskScheduler->AddTask("Child", [pOrder]() { *pOrder += "C"; return true; });
+		return true;
+	}, CIdleTaskScheduler::PRIORITY_HIGH);
+	hVictim = cIdleTaskScheduler->AddTask("Victim", [pOrder]() { *pOrder += "V"; return true; });
+
+	// A task which cancels itself is removed
+	CIdleTaskScheduler::HANDLE hSelf = CIdleTaskScheduler::INVALID_HANDLE;
+	CIdleTaskScheduler::HANDLE* pSelf = &hSelf;
+	hSelf = cIdleTaskScheduler->AddTask("Self", [cIdleTaskScheduler, pOrder, pSelf]()
+	{
+		*pOrder += "X";
+		cIdleTaskScheduler->Cancel(*pSelf);
+		return false;
+	}, CIdleTaskScheduler::PRIORITY_LOW);
+
+	cIdleTaskScheduler->RunIdle(0.010);
+	TEST_CHECK(strOrder == "SCX");
+	TEST_CHECK(cIdleTaskScheduler->GetNumPending() == 0);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief Flush runs all the tasks to the end, without a deadline
+ */
+static void TestFlush(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	int iNumSlices = 0;
+	int* pNumSlices = &iNumSlices;
+	cIdleTaskScheduler->AddTask("Save", [pNumSlices]()
+	{
+		(*pNumSlices)++;
+		return (*pNumSlices == 100);
+	}, CIdleTaskScheduler::PRIORITY_LOW);
+	cIdleTaskScheduler->Flush();
+	TEST_CHECK(iNumSlices == 100);
+	TEST_CHECK(cIdleTaskScheduler->GetNumPending() == 0);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief The idle time is split into the time which was used and the time which was wasted
+ */
+static void TestMetrics(void)
+{
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	// No tasks, so all the time is wasted
+	cIdleTaskScheduler->RunIdle(0.005);
+	cIdleTaskScheduler->RunIdle(0.005);
+	TEST_CHECK(cIdleTaskScheduler->GetAvailableTime() == 0.010);
+	TEST_CHECK(cIdleTaskScheduler->GetUsedTime() == 0.0);
+	TEST_CHECK(cIdleTaskScheduler->GetWastedTime() == 0.010);
+
+	cIdleTaskScheduler->AddTask("1 ms", []() { Spin(0.001); return true; });
+	cIdleTaskScheduler->RunIdle(0.005);
+	TEST_CHECK(cIdleTaskScheduler->GetUsedTime() >= 0.001);
+	TEST_CHECK(fabs(cIdleTaskScheduler->GetUsedTime() + cIdleTaskScheduler->GetWastedTime() - 0.015) < 1.0e-12);
+	TEST_CHECK(cIdleTaskScheduler->GetNumSlices() == 1);
+
+	// Init resets the metrics
+	cIdleTaskScheduler->Init();
+	TEST_CHECK(cIdleTaskScheduler->GetAvailableTime() == 0.0);
+	TEST_CHECK(cIdleTaskScheduler->GetNumSlices() == 0);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief Short slices use the idle time up to the safety margin, in every frame, without running past the deadlines
+ */
+static void TestIdleTimeUse(void)
+{
+	const int NUM_FRAMES = 200;
+	const double IDLE_TIME = 0.005;
+	const double SLICE_TIME = 0.00023;
+
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+	SimulatedClock sClock;
+	SimulatedClock* pClock = &sClock;
+
+	// A task which never finishes. The safety margin of 2 ms is kept free, so 13 slices fit in the 3 ms of each frame
+	cIdleTaskScheduler->AddTask("Compaction", [pClock, SLICE_TIME]() { pClock->dTime += SLICE_TIME; return false; },
+								CIdleTaskScheduler::PRIORITY_LOW);
+	for (int i = 0; i < NUM_FRAMES; i++)
+		cIdleTaskScheduler->RunIdle(IDLE_TIME);
+
+	const double dUtilisation = cIdleTaskScheduler->GetUsedTime() / cIdleTaskScheduler->GetAvailableTime();
+	TEST_CHECK(cIdleTaskScheduler->GetNumSlices() == 13 * NUM_FRAMES);
+	TEST_CHECK(fabs(dUtilisation - 13 * SLICE_TIME / IDLE_TIME) < 1.0e-6);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 0);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief A task whose slice was slow once, such as when the thread was preempted, is tried again after a few seconds,
+		instead of waiting forever for an idle time which is long enough for its estimate
+ */
+static void TestSlowSliceRecovery(void)
+{
+	const double IDLE_TIME = 0.005;
+
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+	SimulatedClock sClock;
+	SimulatedClock* pClock = &sClock;
+
+	// The first slice takes 20 ms, and the other 9 slices take 0.1 ms each
+	int iNumSlices = 0;
+	int* pNumSlices = &iNumSlices;
+	CIdleTaskScheduler::HANDLE hTask = cIdleTaskScheduler->AddTask("Save", [pClock, pNumSlices]()
+		{
+			pClock->dTime += (*pNumSlices == 0) ? 0.020 : 0.0001;
+			return (++(*pNumSlices) == 10);
+		});
+	cIdleTaskScheduler->RunIdle(IDLE_TIME);
+	TEST_CHECK(iNumSlices == 1);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 1);
+
+	// The estimate of 20 ms decays by 1% in each frame, and is below the 3 ms which can be used after 189 frames
+	int iNumFrames = 0;
+	while ((cIdleTaskScheduler->IsPending(hTask)) && (iNumFrames < 1000))
+	{
+		cIdleTaskScheduler->RunIdle(IDLE_TIME);
+		iNumFrames++;
+		if (iNumFrames == 150)
+			TEST_CHECK(iNumSlices == 1);
+	}
+	TEST_CHECK(cIdleTaskScheduler->IsPending(hTask) == false);
+	TEST_CHECK(iNumFrames < 200);
+	TEST_CHECK(cIdleTaskScheduler->GetNumOverruns() == 1);
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief Benchmark how much of the idle time is used by short slices, and the cost of running a slice
+ */
+static void BenchmarkIdleTime(void)
+{
+	const int NUM_FRAMES = 200;
+	const double IDLE_TIME = 0.005;
+	const int NUM_EMPTY_SLICES = 1000000;
+
+	CIdleTaskScheduler* cIdleTaskScheduler = CIdleTaskScheduler::GetInstance();
+	cIdleTaskScheduler->Init();
+
+	// A task which never finishes, with slices of 0.2 ms
+	cIdleTaskScheduler->AddTask("Compaction", []() { Spin(0.0002); return false; }, CIdleTaskScheduler::PRIORITY_LOW);
+	for (int i = 0; i < NUM_FRAMES; i++)
+		cIdleTaskScheduler->RunIdle(IDLE_TIME);
+	const double dUtilisation = cIdleTaskScheduler->GetUsedTime() / cIdleTaskScheduler->GetAvailableTime();
+	const unsigned int uiNumOverruns = cIdleTaskScheduler->GetNumOverruns();
+
+	// Empty slices, to measure the cost of the scheduler
+	cIdleTaskScheduler->Init();
+	int iNumSlices = 0;
+	int* pNumSlices = &iNumSlices;
+	cIdleTaskScheduler->AddTask("Empty", [pNumSlices]() { return (++(*pNumSlices) == NUM_EMPTY_SLICES); });
+	const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	while (cIdleTaskScheduler->GetNumPending() > 0)
+		cIdleTaskScheduler->RunIdle(IDLE_TIME);
+	const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+	TEST_CHECK(iNumSlices == NUM_EMPTY_SLICES);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Idle time used by 0.2 ms slices", dUtilisation * 100.0, "%");
+	cTestHarness->Report("Overruns", uiNumOverruns, "frames");
+	cTestHarness->Report("Empty slices", NUM_EMPTY_SLICES / dTime / 1.0e6, "million slices/s");
+
+	CIdleTaskScheduler::Destroy();
+}
+
+/**
+ @brief Run the tests of CIdleTaskScheduler
+ */
+void RunIdleTaskSchedulerTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("IdleTaskScheduler.PriorityOrder", TestPriorityOrder);
+	cTestHarness->Run("IdleTaskScheduler.Slices", TestSlices);
+	cTestHarness->Run("IdleTaskScheduler.Deadline", TestDeadline);
+	cTestHarness->Run("IdleTaskScheduler.AddAndCancelInSlice", TestAddAndCancelInSlice);
+	cTestHarness->Run("IdleTaskScheduler.Flush", TestFlush);
+	cTestHarness->Run("IdleTaskScheduler.Metrics", TestMetrics);
+	cTestHarness->Run("IdleTaskScheduler.IdleTimeUse", TestIdleTimeUse);
+	cTestHarness->Run("IdleTaskScheduler.SlowSliceRecovery", TestSlowSliceRecovery);
+	cTestHarness->Run("IdleTaskScheduler.Benchmark", BenchmarkIdleTime);
+}
@@ -0,0 +1,308 @@
+/**
+ Tests of CKinematicSolver2D, on grids of tiles which are read through a TileGridView2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include KinematicSolver2D
+#include "Scene2D\KinematicSolver2D.h"
+
+#include <vector>
+#include <cmath>
+
+// The values of the tiles in the tests
+static const unsigned int TILE_EMPTY = 0;
+static const unsigned int TILE_INTERACTABLE = 50;
+static const unsigned int TILE_LAST_INTERACTABLE = 99;
+static const unsigned int TILE_BLOCK = 100;
+
+/**
+ A grid of tiles, which is read through its grid view like the map
+ */
+struct TestGrid
+{
+	int iNumCols;
+	int iNumRows;
+	// The tiles, and the rows of the view from top to bottom
+	std::vector<Grid> vTiles;
+	std::vector<const Grid*> vRows;
+
+	TestGrid(const int iNumCols, const int iNumRows)
+		: iNumCols(iNumCols), iNumRows(iNumRows), vTiles(iNumCols * iNumRows), vRows(iNumRows)
+	{
+		for (int iRow = 0; iRow < iNumRows; iRow++)
+			vRows[iRow] = &vTiles[iRow * iNumCols];
+	}
+
+	// Set the value of a tile. The row is from bottom to top, as the entities use
+	void SetValue(const int iCol, const int iRow, const unsigned int uiValue)
+	{
+		vTiles[(iNumRows - iRow - 1) * iNumCols + iCol].value = uiValue;
+	}
+
+	TileGridView2D GetGridView(void) const
+	{
+		return TileGridView2D(vRows.data(), iNumRows, iNumCols);
+	}
+};
+
+/**
+ @brief Sweep an AABB of 1 tile through a grid
+ */
+static SweepResult Sweep(const TestGrid& sGrid, const glm::vec2& vec2Min, const glm::vec2& vec2Displacement)
+{
+	SweepResult sResult;
+	CKinematicSolver2D::SweepAABB(sGrid.GetGridView(), vec2Min, glm::vec2(1.0f), vec2Displacement, sResult);
+	return sResult;
+}
+
+/**
+ @brief The tiles outside the grid are empty, and the rows of the view are from bottom to top
+ */
+static void TestGridView(void)
+{
+	TestGrid sGrid(4, 3);
+	sGrid.SetValue(0, 0, TILE_BLOCK);
+	sGrid.SetValue(3, 2, TILE_INTERACTABLE);
+	const TileGridView2D sView = sGrid.GetGridView();
+
+	TEST_CHECK(sView.GetValue(0, 0) == TILE_BLOCK);
+	TEST_CHECK(sView.GetValue(3, 2) == TILE_INTERACTABLE);
+	TEST_CHECK(sGrid.vTiles[0].value == TILE_EMPTY);
+	TEST_CHECK(sGrid.vTiles[3].value == TILE_INTERACTABLE);
+
+	TEST_CHECK(sView.GetValue(-1, 0) == 0);
+	TEST_CHECK(sView.GetValue(4, 0) == 0);
+	TEST_CHECK(sView.GetValue(0, -1) == 0);
+	TEST_CHECK(sView.GetValue(0, 3) == 0);
+	TEST_CHECK(sView.GetValue(-1000, 1000) == 0);
+
+	// An empty view has no tiles
+	const TileGridView2D sEmptyView;
+	TEST_CHECK(sEmptyView.GetValue(0, 0) == 0);
+}
+
+/**
+ @brief Positions are checked against the blocking tiles on their leading side, and constrained within the grid
+ */
+static void TestCheckPosition(void)
+{
+	TestGrid sGrid(8, 8);
+	sGrid.SetValue(5, 3, TILE_BLOCK);
+	sGrid.SetValue(2, 2, TILE_LAST_INTERACTABLE);
+	const TileGridView2D sView = sGrid.GetGridView();
+	const glm::i32vec2 i32vec2Right(1, 0);
+	const glm::i32vec2 i32vec2Down(0, -1);
+
+	// Moving right into the block, and past it in the row below
+	glm::i32vec2 i32vec2NumMicroSteps(1, 0);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(4, 3), i32vec2NumMicroSteps, i32vec2Right) == false);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(4, 2), i32vec2NumMicroSteps, i32vec2Right) == true);
+	// Between 2 rows, the block in the upper row stops the movement
+	i32vec2NumMicroSteps = glm::i32vec2(1, 2);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(4, 2), i32vec2NumMicroSteps, i32vec2Right) == false);
+
+	// An interactable tile does not block
+	i32vec2NumMicroSteps = glm::i32vec2(0, 0);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(2, 2), i32vec2NumMicroSteps, i32vec2Down) == true);
+
+	// A position outside the grid cannot be moved into, and its microsteps are cleared
+	i32vec2NumMicroSteps = glm::i32vec2(3, 0);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(8, 0), i32vec2NumMicroSteps, i32vec2Right) == false);
+	TEST_CHECK(i32vec2NumMicroSteps.x == 0);
+	i32vec2NumMicroSteps = glm::i32vec2(0, 3);
+	TEST_CHECK(CKinematicSolver2D::CheckPosition(sView, glm::i32vec2(0, -1), i32vec2NumMicroSteps, i32vec2Down) == false);
+	TEST_CHECK(i32vec2NumMicroSteps.y == 0);
+
+	// Constraint clamps a position which moved out of the grid
+	glm::i32vec2 i32vec2Index(9, 4);
+	i32vec2NumMicroSteps = glm::i32vec2(2, 0);
+	TEST_CHECK(CKinematicSolver2D::Constraint(sView, i32vec2Index, i32vec2NumMicroSteps, i32vec2Right) == true);
+	TEST_CHECK(i32vec2Index == glm::i32vec2(7, 4));
+	TEST_CHECK(i32vec2NumMicroSteps.x == 0);
+	i32vec2Index = glm::i32vec2(3, 4);
+	TEST_CHECK(CKinematicSolver2D::Constraint(sView, i32vec2Index, i32vec2NumMicroSteps, i32vec2Right) == false);
+}
+
+/**
+ @brief An entity is in mid-air unless a blocking tile or the bottom row supports it, for every gravity direction
+ */
+static void TestMidAir(void)
+{
+	TestGrid sGrid(8, 8);
+	sGrid.SetValue(3, 2, TILE_BLOCK);
+	sGrid.SetValue(5, 2, TILE_LAST_INTERACTABLE);
+	const TileGridView2D sView = sGrid.GetGridView();
+	const glm::i32vec2 i32vec2NoMicroSteps(0, 0);
+
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(3, 3), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_DOWN) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(5, 3), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_DOWN) == true);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(3, 1), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_UP) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(2, 2), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_RIGHT) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(4, 2), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_LEFT) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(4, 2), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_RIGHT) == true);
+
+	// The bottom row of each gravity direction supports an entity
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(0, 0), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_DOWN) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(0, 7), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_UP) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(7, 4), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_RIGHT) == false);
+	TEST_CHECK(CKinematicSolver2D::IsMidAir(sView, glm::i32vec2(0, 4), i32vec2NoMicroSteps, CPhysics2D::GRAVITY_LEFT) == false);
+
+	// UP is against gravity and DOWN is along it
+	for (int i = 0; i < CPhysics2D::GRAVITY_COUNT; i++)
+	{
+		const CPhysics2D::GRAVITY_DIRECTION eGravity = (CPhysics2D::GRAVITY_DIRECTION)i;
+		TEST_CHECK(CKinematicSolver2D::GetDirVector(eGravity, CPhysics2D::UP) == -CKinematicSolver2D::GetDirVector(eGravity, CPhysics2D::DOWN));
+		TEST_CHECK(CKinematicSolver2D::GetDirVector(eGravity, CPhysics2D::LEFT) == -CKinematicSolver2D::GetDirVector(eGravity, CPhysics2D::RIGHT));
+	}
+}
+
+/**
+ @brief A fast AABB does not tunnel through a wall which is 1 tile thick, however far it moves in a frame
+ */
+static void TestSweepTunnelling(void)
+{
+	TestGrid sGrid(64, 16);
+	for (int iRow = 0; iRow < 16; iRow++)
+		sGrid.SetValue(40, iRow, TILE_BLOCK);
+
+	const float arrDisplacements[] = { 45.0f, 100.0f, 1000.0f, 1.0e6f };
+	for (int i = 0; i < 4; i++)
+	{
+		const SweepResult sResult = Sweep(sGrid, glm::vec2(2.0f, 5.0f), glm::vec2(arrDisplacements[i], 0.0f));
+		TEST_CHECK(sResult.bHit);
+		TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(40, 5));
+		TEST_CHECK(sResult.vec2Position == glm::vec2(39.0f, 5.0f));
+		TEST_CHECK(fabs(sResult.fTime - 37.0f / arrDisplacements[i]) < 1.0e-5f);
+	}
+
+	// Falling fast onto a floor, off the microsteps
+	for (int iCol = 0; iCol < 64; iCol++)
+		sGrid.SetValue(iCol, 0, TILE_BLOCK);
+	SweepResult sResult = Sweep(sGrid, glm::vec2(10.25f, 14.5f), glm::vec2(0.0f, -500.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.vec2Position == glm::vec2(10.25f, 1.0f));
+	TEST_CHECK((sResult.i32vec2HitTile == glm::i32vec2(10, 0)) || (sResult.i32vec2HitTile == glm::i32vec2(11, 0)));
+
+	// Moving up to a wall, and touching it, is not a hit
+	sResult = Sweep(sGrid, glm::vec2(2.0f, 5.0f), glm::vec2(37.0f, 0.0f));
+	TEST_CHECK(sResult.bHit == false);
+	TEST_CHECK(sResult.vec2Position == glm::vec2(39.0f, 5.0f));
+	TEST_CHECK(sResult.fTime == 1.0f);
+
+	// Starting inside a block is a hit at once
+	sResult = Sweep(sGrid, glm::vec2(39.5f, 5.0f), glm::vec2(-5.0f, 0.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.fTime == 0.0f);
+	TEST_CHECK(sResult.vec2Position == glm::vec2(39.5f, 5.0f));
+}
+
+/**
+ @brief A diagonal sweep hits a block which it only reaches through the corner of a tile
+ */
+static void TestSweepCorners(void)
+{
+	TestGrid sGrid(16, 16);
+	sGrid.SetValue(6, 6, TILE_BLOCK);
+
+	// Exactly through the corner: the AABB moves from the tile diagonally below and left of the block into it
+	SweepResult sResult = Sweep(sGrid, glm::vec2(2.0f, 2.0f), glm::vec2(8.0f, 8.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(6, 6));
+	TEST_CHECK(fabs(sResult.fTime - 0.375f) < 1.0e-5f);
+
+	// Almost exactly through the corner, either axis first
+	sResult = Sweep(sGrid, glm::vec2(2.0f, 2.0f), glm::vec2(8.0f, 8.00001f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(6, 6));
+	sResult = Sweep(sGrid, glm::vec2(2.0f, 2.0f), glm::vec2(8.00001f, 8.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(6, 6));
+
+	// From the other 3 diagonals
+	sResult = Sweep(sGrid, glm::vec2(10.0f, 10.0f), glm::vec2(-8.0f, -8.0f));
+	TEST_CHECK(sResult.bHit && (sResult.i32vec2HitTile == glm::i32vec2(6, 6)));
+	sResult = Sweep(sGrid, glm::vec2(10.0f, 2.0f), glm::vec2(-8.0f, 8.0f));
+	TEST_CHECK(sResult.bHit && (sResult.i32vec2HitTile == glm::i32vec2(6, 6)));
+	sResult = Sweep(sGrid, glm::vec2(2.0f, 10.0f), glm::vec2(8.0f, -8.0f));
+	TEST_CHECK(sResult.bHit && (sResult.i32vec2HitTile == glm::i32vec2(6, 6)));
+
+	// Passing the block on a diagonal which only touches its corner is not a hit
+	sResult = Sweep(sGrid, glm::vec2(1.0f, 3.0f), glm::vec2(8.0f, 8.0f));
+	TEST_CHECK(sResult.bHit == false);
+	TEST_CHECK(sResult.vec2Position == glm::vec2(9.0f, 11.0f));
+
+	// Grazing the corner of the block by a fraction of a tile is a hit
+	sResult = Sweep(sGrid, glm::vec2(1.1f, 3.0f), glm::vec2(8.0f, 8.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(6, 6));
+}
+
+/**
+ @brief The interactable tiles, with values in (49, 99], are reported once each in the order they are entered,
+		and the sweep outside the grid finds no tiles
+ */
+static void TestSweepInteractables(void)
+{
+	TestGrid sGrid(32, 8);
+	sGrid.SetValue(4, 2, 49);
+	sGrid.SetValue(6, 2, TILE_INTERACTABLE);
+	sGrid.SetValue(9, 2, TILE_LAST_INTERACTABLE);
+	sGrid.SetValue(12, 2, TILE_INTERACTABLE);
+	sGrid.SetValue(14, 2, TILE_BLOCK);
+	// Below the path of the AABB
+	sGrid.SetValue(8, 1, TILE_INTERACTABLE);
+
+	SweepResult sResult = Sweep(sGrid, glm::vec2(1.0f, 2.0f), glm::vec2(20.0f, 0.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(14, 2));
+	TEST_CHECK(sResult.uiNumInteractables == 3);
+	TEST_CHECK(sResult.i32vec2Interactables[0] == glm::i32vec2(6, 2));
+	TEST_CHECK(sResult.i32vec2Interactables[1] == glm::i32vec2(9, 2));
+	TEST_CHECK(sResult.i32vec2Interactables[2] == glm::i32vec2(12, 2));
+
+	// The tiles which the AABB overlaps at the start are not reported, and the tiles after a hit are not reached
+	sResult = Sweep(sGrid, glm::vec2(6.0f, 2.0f), glm::vec2(4.0f, 0.0f));
+	TEST_CHECK(sResult.bHit == false);
+	TEST_CHECK(sResult.uiNumInteractables == 1);
+	TEST_CHECK(sResult.i32vec2Interactables[0] == glm::i32vec2(9, 2));
+
+	// Between 2 rows, the interactables in both rows are reported
+	sResult = Sweep(sGrid, glm::vec2(5.0f, 1.5f), glm::vec2(5.0f, 0.0f));
+	TEST_CHECK(sResult.uiNumInteractables == 3);
+	TEST_CHECK(sResult.i32vec2Interactables[0] == glm::i32vec2(6, 2));
+	TEST_CHECK(sResult.i32vec2Interactables[1] == glm::i32vec2(8, 1));
+	TEST_CHECK(sResult.i32vec2Interactables[2] == glm::i32vec2(9, 2));
+
+	// The number of interactables which are reported is capped
+	TestGrid sCoins(64, 1);
+	for (int iCol = 1; iCol < 64; iCol++)
+		sCoins.SetValue(iCol, 0, TILE_INTERACTABLE);
+	sResult = Sweep(sCoins, glm::vec2(0.0f, 0.0f), glm::vec2(63.0f, 0.0f));
+	TEST_CHECK(sResult.uiNumInteractables == MAX_SWEEP_INTERACTABLES);
+	TEST_CHECK(sResult.i32vec2Interactables[MAX_SWEEP_INTERACTABLES - 1] == glm::i32vec2(MAX_SWEEP_INTERACTABLES, 0));
+
+	// Outside the grid, all the tiles are empty
+	sResult = Sweep(sGrid, glm::vec2(-10.0f, -10.0f), glm::vec2(-50.0f, 3.0f));
+	TEST_CHECK(sResult.bHit == false);
+	TEST_CHECK(sResult.uiNumInteractables == 0);
+	TEST_CHECK(sResult.vec2Position == glm::vec2(-60.0f, -7.0f));
+	sResult = Sweep(sGrid, glm::vec2(-5.0f, 2.0f), glm::vec2(30.0f, 0.0f));
+	TEST_CHECK(sResult.bHit);
+	TEST_CHECK(sResult.i32vec2HitTile == glm::i32vec2(14, 2));
+}
+
+/**
+ @brief Run the tests of CKinematicSolver2D
+ */
+void RunKinematicSolverTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("KinematicSolver.GridView", TestGridView);
+	cTestHarness->Run("KinematicSolver.CheckPosition", TestCheckPosition);
+	cTestHarness->Run("KinematicSolver.MidAir", TestMidAir);
+	cTestHarness->Run("KinematicSolver.SweepTunnelling", TestSweepTunnelling);
+	cTestHarness->Run("KinematicSolver.SweepCorners", TestSweepCorners);
+	cTestHarness->Run("KinematicSolver.SweepInteractables", TestSweepInteractables);
+}
@@ -0,0 +1,422 @@
+/**
+ Tests of the sprite batch's render command lists, drawn by CNullRenderBackend2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include SpriteBatch2D
+#include "RenderControl\SpriteBatch2D.h"
+// Include NullRenderBackend2D
+#include "RenderControl\NullRenderBackend2D.h"
+// Include RenderThread2D
+#include "RenderControl\RenderThread2D.h"
+// Include ShaderManager
+#include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include Random
+#include "System\Random.h"
+
+#include <chrono>
+
+/**
+ A sprite of a test scene
+ */
+struct TestSprite
+{
+	unsigned int uiShader;
+	GLuint uiTextureID;
+	glm::vec2 vec2Centre;
+	glm::vec4 vec4Tint;
+	int iLayer;
+};
+
+/**
+ The shaders and the sprite batch of a test, which draws through the null backend
+ */
+struct TestNullBatch
+{
+	CShader* arrShaders[2];
+	CNullRenderBackend2D cNullBackend;
+	CSpriteBatch2D* cSpriteBatch2D;
+
+	TestNullBatch(void)
+	{
+		CGLStub* cGLStub = CGLStub::GetInstance();
+		cGLStub->Reset();
+		for (int i = 0; i < 2; i++)
+			arrShaders[i] = new CShader("../App/Shader/Scene2D.vs", "../App/Shader/Scene2D.fs");
+
+		cSpriteBatch2D = CSpriteBatch2D::GetInstance();
+		cSpriteBatch2D->SetBackend(&cNullBackend);
+		cSpriteBatch2D->Init();
+		cGLStub->ResetCounts();
+	}
+
+	~TestNullBatch(void)
+	{
+		CSpriteBatch2D::Destroy();
+		for (int i = 0; i < 2; i++)
+			delete arrShaders[i];
+		CShaderManager::Destroy();
+		CGLStateCache::Destroy();
+	}
+
+	// Record a number of sprites into the batch, in an order
+	void Draw(const std::vector<TestSprite>& vSprites, const std::vector<unsigned int>& vOrder)
+	{
+		for (unsigned int i = 0; i < vOrder.size(); i++)
+		{
+			const TestSprite& sSprite = vSprites[vOrder[i]];
+			cSpriteBatch2D->Draw(arrShaders[sSprite.uiShader], sSprite.uiTextureID, sSprite.vec2Centre, glm::vec2(0.02f),
+								 glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), sSprite.vec4Tint, sSprite.iLayer);
+		}
+	}
+};
+
+/**
+ @brief Create the sprites of a test scene, which are the same for the same seed
+ @param uiNumSprites A const unsigned int variable containing the number of sprites
+ @param ullSeed A const unsigned long long variable containing the seed
+ */
+static std::vector<TestSprite> CreateSprites(const unsigned int uiNumSprites, const unsigned long long ullSeed)
+{
+	CRandom cRandom(ullSeed, 0u);
+	std::vector<TestSprite> vSprites(uiNumSprites);
+	for (unsigned int i = 0; i < uiNumSprites; i++)
+	{
+		vSprites[i].uiShader = cRandom.NextUInt(2);
+		vSprites[i].uiTextureID = 10 + cRandom.NextUInt(8);
+		vSprites[i].vec2Centre = glm::vec2(cRandom.RandFloatMinMax(0.0f, 1.0f), cRandom.RandFloatMinMax(0.0f, 1.0f));
+		vSprites[i].vec4Tint = glm::vec4(cRandom.RandFloatMinMax(0.5f, 1.0f), 1.0f, 1.0f, 1.0f);
+		vSprites[i].iLayer = (int)cRandom.NextUInt(3);
+	}
+	return vSprites;
+}
+
+/**
+ @brief Get the order which the sprites were created in
+ @param uiNumSprites A const unsigned int variable containing the number of sprites
+ */
+static std::vector<unsigned int> GetCreatedOrder(const unsigned int uiNumSprites)
+{
+	std::vector<unsigned int> vOrder(uiNumSprites);
+	for (unsigned int i = 0; i < uiNumSprites; i++)
+		vOrder[i] = i;
+	return vOrder;
+}
+
+/**
+ @brief The same frames give the same draw calls and the same checksum, and the sprites of different textures
+		and layers can be recorded in any order
+ */
+static void TestDeterminism(void)
+{
+	const unsigned int NUM_SPRITES = 5000;
+	const std::vector<TestSprite> vSprites = CreateSprites(NUM_SPRITES, 49u);
+	const std::vector<unsigned int> vCreatedOrder = GetCreatedOrder(NUM_SPRITES);
+
+	unsigned long long arrChecksums[2] = { 0, 0 };
+	unsigned int arrNumDrawCalls[2] = { 0, 0 };
+	for (int iRun = 0; iRun < 2; iRun++)
+	{
+		TestNullBatch sBatch;
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vSprites, vCreatedOrder);
+		sBatch.cSpriteBatch2D->End();
+		arrChecksums[iRun] = sBatch.cNullBackend.GetChecksum();
+		arrNumDrawCalls[iRun] = sBatch.cNullBackend.GetNumDrawCalls();
+		TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == NUM_SPRITES);
+	}
+	TEST_CHECK(arrChecksums[0] == arrChecksums[1]);
+	TEST_CHECK(arrNumDrawCalls[0] == arrNumDrawCalls[1]);
+	// 3 layers, 2 shaders and 8 textures
+	TEST_CHECK(arrNumDrawCalls[0] == 3 * 2 * 8);
+
+	// The sprites of the odd textures first, and then the even ones, keeping their order for each texture
+	std::vector<unsigned int> vTextureOrder;
+	for (unsigned int uiParity = 1; uiParity <= 2; uiParity++)
+	{
+		for (unsigned int i = 0; i < NUM_SPRITES; i++)
+		{
+			if (vSprites[i].uiTextureID % 2 == uiParity % 2)
+				vTextureOrder.push_back(i);
+		}
+	}
+	{
+		TestNullBatch sBatch;
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vSprites, vTextureOrder);
+		sBatch.cSpriteBatch2D->End();
+		TEST_CHECK(sBatch.cNullBackend.GetChecksum() == arrChecksums[0]);
+	}
+
+	// A sprite with another tint changes the checksum
+	std::vector<TestSprite> vChangedSprites = vSprites;
+	vChangedSprites[NUM_SPRITES / 2].vec4Tint.a = 0.5f;
+	{
+		TestNullBatch sBatch;
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vChangedSprites, vCreatedOrder);
+		sBatch.cSpriteBatch2D->End();
+		TEST_CHECK(sBatch.cNullBackend.GetChecksum() != arrChecksums[0]);
+	}
+}
+
+/**
+ @brief The null backend does not call OpenGL, and the 2 lists of a frame are drawn in the order which they are executed
+ */
+static void TestNoOpenGL(void)
+{
+	const std::vector<TestSprite> vSprites = CreateSprites(100, 50u);
+	const std::vector<unsigned int> vCreatedOrder = GetCreatedOrder(100);
+
+	TestNullBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	// The entities and the map of Scene2D are recorded into 2 lists, and the map is drawn later
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.Draw(vSprites, vCreatedOrder);
+	const unsigned int uiFirstList = sBatch.cSpriteBatch2D->Submit();
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 20, glm::vec2(0.5f), glm::vec2(1.0f));
+	const unsigned int uiSecondList = sBatch.cSpriteBatch2D->Submit();
+	TEST_CHECK(uiFirstList != uiSecondList);
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSprites() == 101);
+	sBatch.cSpriteBatch2D->DeleteTextureLater(20);
+
+	sBatch.cSpriteBatch2D->Execute(uiFirstList);
+	TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == 100);
+	TEST_CHECK(sBatch.cNullBackend.GetNumTexturesDeleted() == 0);
+	sBatch.cSpriteBatch2D->Execute(uiSecondList);
+	TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == 101);
+	TEST_CHECK(sBatch.cNullBackend.GetNumTexturesDeleted() == 1);
+
+	// Executing a list again does nothing
+	sBatch.cSpriteBatch2D->Execute(uiSecondList);
+	TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == 101);
+
+	TEST_CHECK(cGLStub->GetNumCalls() == 0);
+
+	sBatch.cSpriteBatch2D->ResetCounts();
+	TEST_CHECK(sBatch.cNullBackend.GetNumDrawCalls() == 0);
+	TEST_CHECK(sBatch.cNullBackend.GetNumTexturesDeleted() == 0);
+}
+
+/**
+ @brief Benchmark recording and preparing frames of 100,000 sprites, without drawing them
+ */
+static void BenchmarkNullBackend(void)
+{
+	const unsigned int NUM_SPRITES = 100000;
+	const int NUM_FRAMES = 20;
+	const std::vector<TestSprite> vSprites = CreateSprites(NUM_SPRITES, 51u);
+	const std::vector<unsigned int> vCreatedOrder = GetCreatedOrder(NUM_SPRITES);
+
+	TestNullBatch sBatch;
+	double dRecordTime = 0.0;
+	double dSubmitTime = 0.0;
+	unsigned long long ullChecksum = 0;
+	bool bSameChecksum = true;
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		sBatch.cSpriteBatch2D->ResetCounts();
+		std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vSprites, vCreatedOrder);
+		std::chrono::steady_clock::time_point tRecorded = std::chrono::steady_clock::now();
+		const unsigned int uiList = sBatch.cSpriteBatch2D->Submit();
+		std::chrono::steady_clock::time_point tSubmitted = std::chrono::steady_clock::now();
+		sBatch.cSpriteBatch2D->Execute(uiList);
+
+		dRecordTime += std::chrono::duration<double>(tRecorded - tStart).count();
+		dSubmitTime += std::chrono::duration<double>(tSubmitted - tRecorded).count();
+		if (iFrame == 0)
+			ullChecksum = sBatch.cNullBackend.GetChecksum();
+		else if (sBatch.cNullBackend.GetChecksum() != ullChecksum)
+			bSameChecksum = false;
+	}
+	TEST_CHECK(bSameChecksum);
+	TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == NUM_SPRITES);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Record time per frame", dRecordTime / NUM_FRAMES * 1000.0, "ms");
+	cTestHarness->Report("Sort and build time per frame", dSubmitTime / NUM_FRAMES * 1000.0, "ms");
+	cTestHarness->Report("Sprites", (double)NUM_SPRITES * NUM_FRAMES / (dRecordTime + dSubmitTime) / 1.0e6, "million sprites/s");
+	cTestHarness->Report("Draw calls per frame", sBatch.cNullBackend.GetNumDrawCalls(), "calls");
+}
+
+/**
+ The frames of a test which draws the lists as Scene2D does. The sprites of the entities and of the map of
+ a frame are recorded into 2 lists, which are submitted, and drawn in the next frame
+ */
+struct TestFrames
+{
+	std::vector<unsigned int> vEntities;
+	std::vector<unsigned int> vMap;
+	unsigned int arrLists[2];
+	bool bSubmitted;
+
+	TestFrames(const unsigned int uiNumSprites)
+		: bSubmitted(false)
+	{
+		for (unsigned int i = 0; i < uiNumSprites; i++)
+		{
+			if (i < uiNumSprites / 2)
+				vEntities.push_back(i);
+			else
+				vMap.push_back(i);
+		}
+		arrLists[0] = 0;
+		arrLists[1] = 0;
+	}
+
+	// Record the lists of this frame, and draw the lists of the last frame
+	void Run(TestNullBatch& sBatch, const std::vector<TestSprite>& vSprites)
+	{
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vSprites, vEntities);
+		const unsigned int uiNextEntityList = sBatch.cSpriteBatch2D->Submit();
+		if (bSubmitted)
+			sBatch.cSpriteBatch2D->Execute(arrLists[0]);
+		arrLists[0] = uiNextEntityList;
+
+		if (bSubmitted)
+			sBatch.cSpriteBatch2D->Execute(arrLists[1]);
+		sBatch.cSpriteBatch2D->Begin();
+		sBatch.Draw(vSprites, vMap);
+		arrLists[1] = sBatch.cSpriteBatch2D->Submit();
+		bSubmitted = true;
+	}
+};
+
+/**
+ @brief The lists which the render thread prepares between the frames are drawn the same as the lists which are
+		prepared when they are submitted, and a deferred texture is deleted although a list is always submitted
+ */
+static void TestRenderThread(void)
+{
+	const unsigned int NUM_SPRITES = 2000;
+	const int NUM_FRAMES = 4;
+	const std::vector<TestSprite> vCreatedSprites = CreateSprites(NUM_SPRITES, 52u);
+
+	// The checksums of the frames, without and with the render thread
+	unsigned long long arrChecksums[2][NUM_FRAMES];
+	for (int iThreaded = 0; iThreaded < 2; iThreaded++)
+	{
+		CRenderThread2D* cRenderThread2D = CRenderThread2D::GetInstance();
+		cRenderThread2D->Init(iThreaded == 1);
+		cRenderThread2D->ResetCounts();
+		TEST_CHECK(cRenderThread2D->IsThreaded() == (iThreaded == 1));
+		std::vector<TestSprite> vSprites = vCreatedSprites;
+		{
+			TestNullBatch sBatch;
+			TestFrames sFrames(NUM_SPRITES);
+			for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+			{
+				// Each frame moves the sprites, so that a list which is drawn in the wrong frame changes the checksum
+				for (unsigned int i = 0; i < NUM_SPRITES; i++)
+					vSprites[i].vec2Centre.x += 0.001f;
+
+				sBatch.cSpriteBatch2D->ResetCounts();
+				sFrames.Run(sBatch, vSprites);
+				arrChecksums[iThreaded][iFrame] = sBatch.cNullBackend.GetChecksum();
+
+				// The first frame has nothing from the last frame to draw
+				TEST_CHECK(sBatch.cNullBackend.GetNumItemsDrawn() == ((iFrame == 0) ? 0 : NUM_SPRITES));
+
+				// The texture is deferred in the second frame, and deleted when its lists are drawn in the third
+				if (iFrame == 1)
+					sBatch.cSpriteBatch2D->DeleteTextureLater(10);
+				TEST_CHECK(sBatch.cNullBackend.GetNumTexturesDeleted() == ((iFrame == 2) ? 1u : 0u));
+			}
+			// The lists of the last frame are still submitted
+			TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSprites() == NUM_SPRITES);
+		}
+		// The batch waits for the lists which were not drawn before it is destroyed
+		TEST_CHECK(cRenderThread2D->GetNumListsPrepared() == 2 * NUM_FRAMES);
+		CRenderThread2D::Destroy();
+	}
+
+	for (int iFrame = 1; iFrame < NUM_FRAMES; iFrame++)
+		TEST_CHECK(arrChecksums[0][iFrame] == arrChecksums[1][iFrame]);
+	TEST_CHECK(arrChecksums[0][1] != arrChecksums[0][2]);
+}
+
+/**
+ @brief Wait for a number of seconds without sleeping, as a stand-in for simulating a frame
+ @param dTime A const double variable containing the time in seconds
+ */
+static void Simulate(const double dTime)
+{
+	const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	while (std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() < dTime)
+	{
+	}
+}
+
+/**
+ @brief Benchmark frames of 100,000 sprites which simulate for as long as the lists take to prepare,
+		without and with the render thread
+ */
+static void BenchmarkRenderThread(void)
+{
+	const unsigned int NUM_SPRITES = 100000;
+	const int NUM_FRAMES = 20;
+	const std::vector<TestSprite> vSprites = CreateSprites(NUM_SPRITES, 53u);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	double dSimulationTime = 0.0;
+	double arrFrameTimes[2] = { 0.0, 0.0 };
+	for (int iThreaded = 0; iThreaded < 2; iThreaded++)
+	{
+		CRenderThread2D* cRenderThread2D = CRenderThread2D::GetInstance();
+		cRenderThread2D->Init(iThreaded == 1);
+		{
+			TestNullBatch sBatch;
+			TestFrames sFrames(NUM_SPRITES);
+
+			// Without the render thread, time a frame which only prepares the lists, to simulate for as long
+			if (iThreaded == 0)
+			{
+				sFrames.Run(sBatch, vSprites);
+				std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+				sFrames.Run(sBatch, vSprites);
+				dSimulationTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+			}
+
+			sFrames.Run(sBatch, vSprites);
+			cRenderThread2D->ResetCounts();
+			std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+			for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+			{
+				Simulate(dSimulationTime);
+				sFrames.Run(sBatch, vSprites);
+			}
+			arrFrameTimes[iThreaded] = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count() / NUM_FRAMES;
+		}
+		if (iThreaded == 1)
+			cTestHarness->Report("Wait for the render thread per frame", cRenderThread2D->GetWaitTime() / NUM_FRAMES * 1000.0, "ms");
+		CRenderThread2D::Destroy();
+	}
+
+	cTestHarness->Report("Simulation time per frame", dSimulationTime * 1000.0, "ms");
+	cTestHarness->Report("Frame time, preparing when submitted", arrFrameTimes[0] * 1000.0, "ms");
+	cTestHarness->Report("Frame time, preparing on the render thread", arrFrameTimes[1] * 1000.0, "ms");
+	cTestHarness->Report("Speed up", arrFrameTimes[0] / arrFrameTimes[1], "x");
+}
+
+/**
+ @brief Run the tests of the render command lists with the null backend
+ */
+void RunNullRenderBackendTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("NullRenderBackend.Determinism", TestDeterminism);
+	cTestHarness->Run("NullRenderBackend.NoOpenGL", TestNoOpenGL);
+	cTestHarness->Run("NullRenderBackend.Benchmark", BenchmarkNullBackend);
+	cTestHarness->Run("NullRenderBackend.RenderThread", TestRenderThread);
+	cTestHarness->Run("NullRenderBackend.RenderThreadBenchmark", BenchmarkRenderThread);
+}
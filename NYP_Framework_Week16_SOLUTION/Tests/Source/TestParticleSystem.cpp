@@ -0,0 +1,371 @@
+/**
+ Tests of CParticleSystem2D, updating its pools of particles and drawing them into the GL stubs
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include ParticleSystem2D
+#include "Scene2D\ParticleSystem2D.h"
+// Include StreamBuffer
+#include "RenderControl\StreamBuffer.h"
+// Include ShaderManager
+#include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+
+/**
+ A particle system which is not the singleton. Its emitters are added without a CSV file or textures
+ */
+class CTestParticleSystem2D : public CParticleSystem2D
+{
+public:
+	using CParticleSystem2D::Emitter;
+
+	CTestParticleSystem2D(void)
+	{
+		Init();
+	}
+
+	virtual ~CTestParticleSystem2D(void)
+	{
+	}
+
+	// Add an emitter, with a pool which is created as LoadEmitters does. Its particles have no texture
+	int AddEmitter(const std::string& strName, const unsigned int uiCapacity, const unsigned int uiCount,
+				   const float fLifetime, const glm::vec2& vec2Gravity)
+	{
+		Emitter sEmitter;
+		sEmitter.strName = strName;
+		sEmitter.uiTextureID = 0;
+		sEmitter.uiCapacity = uiCapacity;
+		sEmitter.uiCount = uiCount;
+		sEmitter.fLifetime = fLifetime;
+		sEmitter.fSpeedMin = 1.0f;
+		sEmitter.fSpeedMax = 4.0f;
+		sEmitter.fDirection = 90.0f;
+		sEmitter.fSpread = 360.0f;
+		sEmitter.vec2Gravity = vec2Gravity;
+		sEmitter.fSize = 0.25f;
+		sEmitter.vec4Colour = glm::vec4(1.0f, 0.5f, 0.25f, 0.8f);
+
+		const unsigned int uiPoolSize = (uiCapacity + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+		sEmitter.vPositionX.assign(uiPoolSize, 0.0f);
+		sEmitter.vPositionY.assign(uiPoolSize, 0.0f);
+		sEmitter.vVelocityX.assign(uiPoolSize, 0.0f);
+		sEmitter.vVelocityY.assign(uiPoolSize, 0.0f);
+		sEmitter.vLife.assign(uiPoolSize, 0.0f);
+		sEmitter.uiNumAlive = 0;
+		vEmitters.push_back(sEmitter);
+		return (int)vEmitters.size() - 1;
+	}
+
+	// Create the buffers for the emitters which were added, as LoadEmitters does
+	void CreateBuffers(void)
+	{
+		for (auto& sEmitter : vEmitters)
+		{
+			if (sEmitter.uiCapacity > uiBufferCapacity)
+				uiBufferCapacity = sEmitter.uiCapacity;
+		}
+		CParticleSystem2D::CreateBuffers(uiBufferCapacity);
+	}
+
+	// Get an emitter
+	const Emitter& GetEmitter(const int iEmitterID) const
+	{
+		return vEmitters[iEmitterID];
+	}
+};
+
+/**
+ The particle system of a test, with the stream buffer and the shader which it draws with
+ */
+struct TestParticles
+{
+	CTestParticleSystem2D* cParticleSystem2D;
+
+	TestParticles(void)
+	{
+		CGLStub* cGLStub = CGLStub::GetInstance();
+		cGLStub->Reset();
+		cGLStub->vActiveUniforms.push_back("transform");
+		cGLStub->vActiveUniforms.push_back("runtime_color");
+		CShaderManager::GetInstance()->Add("2DColorShader", "../App/Shader/Scene2DColor.vs", "../App/Shader/Scene2DColor.fs");
+		CStreamBuffer::GetInstance()->Init();
+		CRandomStreams::GetInstance()->Init(1);
+		cParticleSystem2D = new CTestParticleSystem2D();
+	}
+
+	~TestParticles(void)
+	{
+		delete cParticleSystem2D;
+		CStreamBuffer::Destroy();
+		CShaderManager::Destroy();
+		CGLStateCache::Destroy();
+		CRandomStreams::Destroy();
+	}
+};
+
+/**
+ @brief Check if the alive particles of an emitter are the particles of a copy of it, which were integrated one at a time
+ */
+template <typename EMITTER>
+static bool IsIntegrated(const EMITTER& sEmitter, const EMITTER& sBefore, const float fElapsedTime)
+{
+	if (sEmitter.uiNumAlive != sBefore.uiNumAlive)
+		return false;
+	for (unsigned int i = 0; i < sEmitter.uiNumAlive; i++)
+	{
+		const float fVelocityX = sBefore.vVelocityX[i] + sBefore.vec2Gravity.x * fElapsedTime;
+		const float fVelocityY = sBefore.vVelocityY[i] + sBefore.vec2Gravity.y * fElapsedTime;
+		if ((sEmitter.vVelocityX[i] != fVelocityX) ||
+			(sEmitter.vVelocityY[i] != fVelocityY) ||
+			(sEmitter.vPositionX[i] != sBefore.vPositionX[i] + fVelocityX * fElapsedTime) ||
+			(sEmitter.vPositionY[i] != sBefore.vPositionY[i] + fVelocityY * fElapsedTime) ||
+			(sEmitter.vLife[i] != sBefore.vLife[i] - fElapsedTime))
+			return false;
+	}
+	return true;
+}
+
+/**
+ @brief An emitter emits its count of particles, and drops the particles which do not fit in its pool.
+		The pool is rounded up to the SIMD width, and is not reallocated
+ */
+static void TestPool(void)
+{
+	TestParticles sParticles;
+	CTestParticleSystem2D* cParticleSystem2D = sParticles.cParticleSystem2D;
+	const int iSparks = cParticleSystem2D->AddEmitter("Sparks", 30, 8, 1.0f, glm::vec2(0.0f, -8.0f));
+	const int iSmoke = cParticleSystem2D->AddEmitter("Smoke", 5, 5, 1.0f, glm::vec2(0.0f));
+	cParticleSystem2D->CreateBuffers();
+	TEST_CHECK(cParticleSystem2D->GetEmitterID("Smoke") == iSmoke);
+	TEST_CHECK(cParticleSystem2D->GetEmitterID("Fire") == CParticleSystem2D::INVALID_EMITTER);
+
+	const CTestParticleSystem2D::Emitter& sSparks = cParticleSystem2D->GetEmitter(iSparks);
+	TEST_CHECK(sSparks.vLife.size() == 32);
+	TEST_CHECK(cParticleSystem2D->GetEmitter(iSmoke).vLife.size() == 8);
+	const float* pLife = sSparks.vLife.data();
+
+	// 3 emits fit, and the fourth only has room for 6 of its particles
+	for (int i = 0; i < 3; i++)
+		cParticleSystem2D->Emit(iSparks, glm::vec2(4.0f, 5.0f));
+	TEST_CHECK(sSparks.uiNumAlive == 24);
+	cParticleSystem2D->Emit(iSparks, glm::vec2(4.0f, 5.0f));
+	TEST_CHECK(sSparks.uiNumAlive == 30);
+	cParticleSystem2D->Emit(iSparks, glm::vec2(4.0f, 5.0f));
+	TEST_CHECK(sSparks.uiNumAlive == 30);
+	TEST_CHECK(cParticleSystem2D->GetNumParticles() == 30);
+
+	// The particles start at the position with the full lifetime, and their speeds are within the range
+	bool bEmitted = true;
+	for (unsigned int i = 0; i < sSparks.uiNumAlive; i++)
+	{
+		const float fSpeed = glm::length(glm::vec2(sSparks.vVelocityX[i], sSparks.vVelocityY[i]));
+		bEmitted = bEmitted && (sSparks.vPositionX[i] == 4.0f) && (sSparks.vPositionY[i] == 5.0f) &&
+				   (sSparks.vLife[i] == 1.0f) && (fSpeed > 1.0f - 1.0e-5f) && (fSpeed < 4.0f + 1.0e-5f);
+	}
+	TEST_CHECK(bEmitted);
+
+	// An invalid emitter is ignored
+	cParticleSystem2D->Emit(CParticleSystem2D::INVALID_EMITTER, glm::vec2(0.0f));
+	cParticleSystem2D->Emit(2, glm::vec2(0.0f));
+	TEST_CHECK(cParticleSystem2D->GetNumParticles() == 30);
+
+	// The capacity scale lowers the capacity and the count, but always emits at least 1 particle
+	cParticleSystem2D->SetCapacityScale(0.5f);
+	cParticleSystem2D->Emit(iSparks, glm::vec2(0.0f));
+	TEST_CHECK(sSparks.uiNumAlive == 30);
+	cParticleSystem2D->Emit(iSmoke, glm::vec2(0.0f));
+	TEST_CHECK(cParticleSystem2D->GetEmitter(iSmoke).uiNumAlive == 2);
+	cParticleSystem2D->SetCapacityScale(-1.0f);
+	TEST_CHECK(cParticleSystem2D->GetCapacityScale() == 0.0f);
+	cParticleSystem2D->Emit(iSmoke, glm::vec2(0.0f));
+	TEST_CHECK(cParticleSystem2D->GetEmitter(iSmoke).uiNumAlive == 2);
+	cParticleSystem2D->SetCapacityScale(2.0f);
+	TEST_CHECK(cParticleSystem2D->GetCapacityScale() == 1.0f);
+	cParticleSystem2D->Emit(iSmoke, glm::vec2(0.0f));
+	TEST_CHECK(cParticleSystem2D->GetEmitter(iSmoke).uiNumAlive == 5);
+
+	// Emitting and updating does not reallocate the pool
+	for (int i = 0; i < 100; i++)
+	{
+		cParticleSystem2D->Update(0.1);
+		cParticleSystem2D->Emit(iSparks, glm::vec2(0.0f));
+	}
+	TEST_CHECK(sSparks.vLife.data() == pLife);
+	TEST_CHECK(sSparks.vLife.size() == 32);
+}
+
+/**
+ @brief The particles are integrated 4 at a time with the same results as one at a time, for any number of particles,
+		and the dead particles are removed, with the alive particles packed at the front of the pool
+ */
+static void TestUpdate(void)
+{
+	TestParticles sParticles;
+	CTestParticleSystem2D* cParticleSystem2D = sParticles.cParticleSystem2D;
+	const int iSparks = cParticleSystem2D->AddEmitter("Sparks", 64, 7, 1.0f, glm::vec2(1.5f, -8.0f));
+	cParticleSystem2D->CreateBuffers();
+	const CTestParticleSystem2D::Emitter& sSparks = cParticleSystem2D->GetEmitter(iSparks);
+
+	// Emit 7 particles in each of the first frames, so that they die in different frames
+	bool bIntegrated = true;
+	bool bPacked = true;
+	unsigned int uiMostAlive = 0;
+	for (int iFrame = 0; iFrame < 40; iFrame++)
+	{
+		if (iFrame < 6)
+			cParticleSystem2D->Emit(iSparks, glm::vec2((float)iFrame, 10.0f));
+		uiMostAlive = std::max(uiMostAlive, sSparks.uiNumAlive);
+
+		const CTestParticleSystem2D::Emitter sBefore = sSparks;
+		const float fElapsedTime = 0.125f;
+		cParticleSystem2D->Update(fElapsedTime);
+
+		// Only whole groups of particles die in each frame, so the integration can be checked before they are removed
+		const unsigned int uiNumDead = sBefore.uiNumAlive - sSparks.uiNumAlive;
+		CTestParticleSystem2D::Emitter sAlive = sBefore;
+		sAlive.uiNumAlive = 0;
+		for (unsigned int i = 0; i < sBefore.uiNumAlive; i++)
+		{
+			if (sBefore.vLife[i] - fElapsedTime > 0.0f)
+			{
+				sAlive.vPositionX[sAlive.uiNumAlive] = sBefore.vPositionX[i];
+				sAlive.vPositionY[sAlive.uiNumAlive] = sBefore.vPositionY[i];
+				sAlive.vVelocityX[sAlive.uiNumAlive] = sBefore.vVelocityX[i];
+				sAlive.vVelocityY[sAlive.uiNumAlive] = sBefore.vVelocityY[i];
+				sAlive.vLife[sAlive.uiNumAlive] = sBefore.vLife[i];
+				sAlive.uiNumAlive++;
+			}
+		}
+		bPacked = bPacked && (uiNumDead == sBefore.uiNumAlive - sAlive.uiNumAlive);
+		for (unsigned int i = 0; i < sSparks.uiNumAlive; i++)
+			bPacked = bPacked && (sSparks.vLife[i] > 0.0f);
+
+		// The order of the particles changes as they are removed, so compare each alive particle with the one it was
+		bool bFound = true;
+		for (unsigned int i = 0; (bFound) && (i < sAlive.uiNumAlive); i++)
+		{
+			CTestParticleSystem2D::Emitter sOne = sAlive;
+			sOne.uiNumAlive = 1;
+			sOne.vPositionX[0] = sAlive.vPositionX[i];
+			sOne.vPositionY[0] = sAlive.vPositionY[i];
+			sOne.vVelocityX[0] = sAlive.vVelocityX[i];
+			sOne.vVelocityY[0] = sAlive.vVelocityY[i];
+			sOne.vLife[0] = sAlive.vLife[i];
+			bFound = false;
+			for (unsigned int j = 0; (!bFound) && (j < sSparks.uiNumAlive); j++)
+			{
+				CTestParticleSystem2D::Emitter sAfter = sSparks;
+				sAfter.uiNumAlive = 1;
+				sAfter.vPositionX[0] = sSparks.vPositionX[j];
+				sAfter.vPositionY[0] = sSparks.vPositionY[j];
+				sAfter.vVelocityX[0] = sSparks.vVelocityX[j];
+				sAfter.vVelocityY[0] = sSparks.vVelocityY[j];
+				sAfter.vLife[0] = sSparks.vLife[j];
+				bFound = IsIntegrated(sAfter, sOne, fElapsedTime);
+			}
+		}
+		bIntegrated = bIntegrated && bFound;
+	}
+	TEST_CHECK(uiMostAlive == 42);
+	TEST_CHECK(bIntegrated);
+	TEST_CHECK(bPacked);
+	TEST_CHECK(sSparks.uiNumAlive == 0);
+	TEST_CHECK(cParticleSystem2D->GetNumParticles() == 0);
+}
+
+/**
+ @brief The particles of each emitter are drawn with one draw call, and fade out over their lifetime
+ */
+static void TestRender(void)
+{
+	TestParticles sParticles;
+	CTestParticleSystem2D* cParticleSystem2D = sParticles.cParticleSystem2D;
+	const int iSparks = cParticleSystem2D->AddEmitter("Sparks", 100, 10, 1.0f, glm::vec2(0.0f));
+	const int iSmoke = cParticleSystem2D->AddEmitter("Smoke", 10, 3, 1.0f, glm::vec2(0.0f));
+	cParticleSystem2D->AddEmitter("Unused", 10, 3, 1.0f, glm::vec2(0.0f));
+	cParticleSystem2D->CreateBuffers();
+
+	for (int i = 0; i < 5; i++)
+		cParticleSystem2D->Emit(iSparks, glm::vec2(3.0f, 4.0f));
+	cParticleSystem2D->Emit(iSmoke, glm::vec2(3.0f, 4.0f));
+	cParticleSystem2D->Update(0.25);
+
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->ResetCounts();
+	cParticleSystem2D->Render();
+	TEST_CHECK(cGLStub->GetNumCalls("glDrawElementsBaseVertex") == 2);
+	TEST_CHECK(cGLStub->ullNumIndicesDrawn == (50 + 3) * 6);
+
+	// The first particle of the sparks is the first vertex in the stream buffer, with a quarter of its alpha gone
+	const std::vector<unsigned char>& vBufferData = cGLStub->mapBufferData[CStreamBuffer::GetInstance()->GetBufferID()];
+	TEST_CHECK(vBufferData.size() >= sizeof(Vertex));
+	if (vBufferData.size() < sizeof(Vertex))
+		return;
+	Vertex sVertex;
+	memcpy(&sVertex, vBufferData.data(), sizeof(Vertex));
+	TEST_CHECK(fabs(sVertex.color.a - 0.8f * 0.75f) < 1.0e-6f);
+	TEST_CHECK(sVertex.color.r == 1.0f);
+
+	// Nothing is drawn when there are no particles
+	cParticleSystem2D->Update(1.0);
+	cGLStub->ResetCounts();
+	cParticleSystem2D->Render();
+	TEST_CHECK(cGLStub->GetNumCalls("glDrawElementsBaseVertex") == 0);
+}
+
+/**
+ @brief Benchmark updating 100000 particles, which are emitted and die all the time, without rendering them
+ */
+static void BenchmarkUpdate(void)
+{
+	const unsigned int NUM_PARTICLES = 100000;
+	const int NUM_FRAMES = 200;
+	TestParticles sParticles;
+	CTestParticleSystem2D* cParticleSystem2D = sParticles.cParticleSystem2D;
+	const int iSparks = cParticleSystem2D->AddEmitter("Sparks", NUM_PARTICLES, NUM_PARTICLES / 50, 1.0f, glm::vec2(0.0f, -8.0f));
+	cParticleSystem2D->CreateBuffers();
+
+	unsigned long long ullNumUpdated = 0;
+	unsigned int uiMostParticles = 0;
+	double dBestParticlesPerMillisecond = 0.0;
+	const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		cParticleSystem2D->Emit(iSparks, glm::vec2(16.0f, 12.0f));
+		uiMostParticles = std::max(uiMostParticles, cParticleSystem2D->GetNumParticles());
+		ullNumUpdated += cParticleSystem2D->GetNumParticles();
+		cParticleSystem2D->Update(1.0 / 60.0);
+		dBestParticlesPerMillisecond = std::max(dBestParticlesPerMillisecond, cParticleSystem2D->GetParticlesPerMillisecond());
+	}
+	const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	// The particles live for 60 frames and 2000 are emitted in each frame, so the pool fills up and drops the rest
+	TEST_CHECK(uiMostParticles == NUM_PARTICLES);
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Particles updated", ullNumUpdated / (dTime * 1000.0), "particles/ms");
+	cTestHarness->Report("Particles updated, best frame", dBestParticlesPerMillisecond, "particles/ms");
+}
+
+/**
+ @brief Run the tests of CParticleSystem2D
+ */
+void RunParticleSystemTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("ParticleSystem.Pool", TestPool);
+	cTestHarness->Run("ParticleSystem.Update", TestUpdate);
+	cTestHarness->Run("ParticleSystem.Render", TestRender);
+	cTestHarness->Run("ParticleSystem.Benchmark", BenchmarkUpdate);
+}
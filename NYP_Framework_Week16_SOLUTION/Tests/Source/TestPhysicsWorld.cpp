@@ -0,0 +1,266 @@
+/**
+ Tests of CPhysicsWorld2D, and of CPhysics2D as a handle to its bodies
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include Physics2D
+#include "Scene2D\Physics2D.h"
+// Include PhysicsWorld2D
+#include "Scene2D\PhysicsWorld2D.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <chrono>
+
+/**
+ @brief Check if 2 bodies have the same time, velocities and displacement
+ */
+static bool IsSameBody(const CPhysics2D& cA, const CPhysics2D& cB)
+{
+	return (cA.GetTime() == cB.GetTime()) &&
+		   (cA.GetInitialVelocity() == cB.GetInitialVelocity()) &&
+		   (cA.GetFinalVelocity() == cB.GetFinalVelocity()) &&
+		   (cA.GetDisplacement() == cB.GetDisplacement());
+}
+
+/**
+ @brief Update a body which is not stepped by the world, as its owner does each frame
+ */
+static void UpdateByOwner(CPhysics2D& cPhysics2D, const float fElapsedTime)
+{
+	if (cPhysics2D.GetStatus() == CPhysics2D::IDLE)
+		return;
+	cPhysics2D.AddElapsedTime(fElapsedTime);
+	cPhysics2D.Update();
+}
+
+/**
+ @brief A body which is stepped by the world follows the same trajectory as a body which is updated by its owner,
+		through random frame lengths, jumps, falls, landings and changes of gravity
+ */
+static void TestStepMatchesIntegrate(void)
+{
+	const unsigned int NUM_PAIRS = 64;
+	{
+		// The bodies are in pairs, with 1 body of each pair stepped by the world
+		std::vector<CPhysics2D> vStepped(NUM_PAIRS);
+		std::vector<CPhysics2D> vUpdated(NUM_PAIRS);
+		CRandom cRandom(3u, 0u);
+		for (unsigned int i = 0; i < NUM_PAIRS; i++)
+		{
+			const CPhysics2D::GRAVITY_DIRECTION eGravityDirection = (CPhysics2D::GRAVITY_DIRECTION)cRandom.NextUInt(CPhysics2D::GRAVITY_COUNT);
+			const float fGravityMagnitude = cRandom.RandFloatMinMax(0.5f, 2.0f);
+			vStepped[i].SetSteppedByWorld(true);
+			vStepped[i].SetGravityDirection(eGravityDirection);
+			vUpdated[i].SetGravityDirection(eGravityDirection);
+			vStepped[i].setGravityMagnitude(fGravityMagnitude);
+			vUpdated[i].setGravityMagnitude(fGravityMagnitude);
+		}
+
+		bool bSame = true;
+		bool bMoved = false;
+		for (int iFrame = 0; iFrame < 600; iFrame++)
+		{
+			// Some bodies jump, fall, land or have their gravity changed, as the entities do
+			for (unsigned int i = 0; i < NUM_PAIRS; i++)
+			{
+				const unsigned int uiEvent = cRandom.NextUInt(40);
+				if (uiEvent == 0)
+				{
+					const glm::vec2 v2Velocity(cRandom.RandFloatMinMax(-1.0f, 1.0f), cRandom.RandFloatMinMax(-1.0f, 1.0f));
+					vStepped[i].SetStatus(CPhysics2D::JUMP);
+					vUpdated[i].SetStatus(CPhysics2D::JUMP);
+					vStepped[i].SetInitialVelocity(v2Velocity);
+					vUpdated[i].SetInitialVelocity(v2Velocity);
+				}
+				else if (uiEvent == 1)
+				{
+					vStepped[i].SetStatus(CPhysics2D::FALL);
+					vUpdated[i].SetStatus(CPhysics2D::FALL);
+				}
+				else if (uiEvent == 2)
+				{
+					vStepped[i].SetStatus(CPhysics2D::IDLE);
+					vUpdated[i].SetStatus(CPhysics2D::IDLE);
+				}
+				else if (uiEvent == 3)
+				{
+					const CPhysics2D::GRAVITY_DIRECTION eGravityDirection = (CPhysics2D::GRAVITY_DIRECTION)cRandom.NextUInt(CPhysics2D::GRAVITY_COUNT);
+					vStepped[i].SetGravityDirection(eGravityDirection);
+					vUpdated[i].SetGravityDirection(eGravityDirection);
+				}
+			}
+
+			const float fElapsedTime = cRandom.RandFloatMinMax(0.005f, 0.05f);
+			CPhysicsWorld2D::GetInstance()->Step(fElapsedTime);
+			for (unsigned int i = 0; i < NUM_PAIRS; i++)
+			{
+				UpdateByOwner(vUpdated[i], fElapsedTime);
+				bSame = bSame && IsSameBody(vStepped[i], vUpdated[i]);
+				bMoved = bMoved || (vStepped[i].GetDisplacement() != glm::vec2(0.0f));
+			}
+		}
+		TEST_CHECK(bSame);
+		TEST_CHECK(bMoved);
+	}
+	CPhysicsWorld2D::Destroy();
+}
+
+/**
+ @brief Step does not change the bodies which are idle, are not stepped by the world, or were destroyed
+ */
+static void TestStepMask(void)
+{
+	{
+		CPhysics2D cIdle;
+		cIdle.SetSteppedByWorld(true);
+		cIdle.SetInitialVelocity(glm::vec2(0.5f, 0.25f));
+
+		CPhysics2D cOwned;
+		cOwned.SetStatus(CPhysics2D::FALL);
+		cOwned.SetInitialVelocity(glm::vec2(-0.5f, 0.75f));
+		cOwned.SetTime(0.125f);
+
+		CPhysics2D cFalling;
+		cFalling.SetSteppedByWorld(true);
+		cFalling.SetStatus(CPhysics2D::FALL);
+
+		const CPhysics2D cIdleBefore(cIdle);
+		const CPhysics2D cOwnedBefore(cOwned);
+
+		CPhysicsWorld2D* cPhysicsWorld2D = CPhysicsWorld2D::GetInstance();
+		const CPhysicsWorld2D::HANDLE hDestroyed = cPhysicsWorld2D->CreateBody();
+		cPhysicsWorld2D->SetSteppedByWorld(hDestroyed, true);
+		cPhysicsWorld2D->SetBodyStatus(hDestroyed, CPhysics2D::FALL);
+		cPhysicsWorld2D->DestroyBody(hDestroyed);
+
+		for (int i = 0; i < 10; i++)
+			cPhysicsWorld2D->Step(0.02f);
+		TEST_CHECK(IsSameBody(cIdle, cIdleBefore));
+		TEST_CHECK(IsSameBody(cOwned, cOwnedBefore));
+		TEST_CHECK(cPhysicsWorld2D->fTime[hDestroyed] == 0.0f);
+
+		// The falling body was stepped, and falls down with the default gravity
+		TEST_CHECK(cFalling.GetTime() > 0.19f);
+		TEST_CHECK(cFalling.GetDisplacement().y < 0.0f);
+		TEST_CHECK(cFalling.GetDisplacement().x == 0.0f);
+
+		// A body which lands is not stepped, and one which stops being stepped by the world keeps its state
+		cFalling.SetStatus(CPhysics2D::IDLE);
+		cPhysicsWorld2D->Step(0.02f);
+		TEST_CHECK(cFalling.GetTime() == 0.0f);
+		cFalling.SetStatus(CPhysics2D::FALL);
+		cPhysicsWorld2D->Step(0.02f);
+		cFalling.SetSteppedByWorld(false);
+		const CPhysics2D cFallingBefore(cFalling);
+		cPhysicsWorld2D->Step(0.02f);
+		TEST_CHECK(IsSameBody(cFalling, cFallingBefore));
+		TEST_CHECK(cPhysicsWorld2D->GetNumBodies() == 6);
+	}
+	TEST_CHECK(CPhysicsWorld2D::GetInstance()->GetNumBodies() == 0);
+	CPhysicsWorld2D::Destroy();
+}
+
+/**
+ @brief Changing the world gravity rotates the bodies which follow it, and the other bodies keep their own gravity.
+		The handle of a destroyed body is reused
+ */
+static void TestWorldGravity(void)
+{
+	{
+		CPhysics2D cFollower;
+		cFollower.SetFollowsWorldGravity(true);
+		CPhysics2D cOtherFollower;
+		cOtherFollower.SetFollowsWorldGravity(true);
+		CPhysics2D cOwnGravity;
+		cOwnGravity.SetGravityDirection(CPhysics2D::GRAVITY_LEFT);
+		CPhysicsWorld2D::HANDLE hDestroyed = CPhysicsWorld2D::INVALID_HANDLE;
+
+		// Any follower sets the gravity of the world
+		cFollower.SetGravityDirection(CPhysics2D::GRAVITY_UP);
+		TEST_CHECK(CPhysicsWorld2D::GetInstance()->GetGravityDirection() == CPhysics2D::GRAVITY_UP);
+		TEST_CHECK(cOtherFollower.GetGravityDirection() == CPhysics2D::GRAVITY_UP);
+		TEST_CHECK(cOtherFollower.GetGravityVector() == glm::vec2(0.0f, 1.1f));
+		TEST_CHECK(cOwnGravity.GetGravityDirection() == CPhysics2D::GRAVITY_LEFT);
+
+		// A body which starts to follow the world gravity takes its direction
+		{
+			CPhysics2D cLateFollower;
+			cLateFollower.SetFollowsWorldGravity(true);
+			TEST_CHECK(cLateFollower.GetGravityDirection() == CPhysics2D::GRAVITY_UP);
+			hDestroyed = cLateFollower.GetBodyHandle();
+		}
+
+		// The stepped bodies fall along their own gravity
+		cFollower.SetSteppedByWorld(true);
+		cOwnGravity.SetSteppedByWorld(true);
+		cFollower.SetStatus(CPhysics2D::FALL);
+		cOwnGravity.SetStatus(CPhysics2D::FALL);
+		CPhysicsWorld2D::GetInstance()->Step(0.1f);
+		TEST_CHECK((cFollower.GetDisplacement().x == 0.0f) && (cFollower.GetDisplacement().y > 0.0f));
+		TEST_CHECK((cOwnGravity.GetDisplacement().x < 0.0f) && (cOwnGravity.GetDisplacement().y == 0.0f));
+
+		// A new body takes the handle of the destroyed body, with the defaults of a new body
+		CPhysics2D cNewBody;
+		TEST_CHECK(cNewBody.GetBodyHandle() == hDestroyed);
+		TEST_CHECK(cNewBody.GetFollowsWorldGravity() == false);
+		TEST_CHECK(cNewBody.GetGravityDirection() == CPhysics2D::GRAVITY_DOWN);
+		TEST_CHECK(cNewBody.GetStatus() == CPhysics2D::IDLE);
+		TEST_CHECK(cNewBody.GetTime() == 0.0f);
+	}
+	CPhysicsWorld2D::Destroy();
+}
+
+/**
+ @brief Benchmark integrating 10000 falling bodies with Step, against updating each body by its owner
+ */
+static void BenchmarkStep(void)
+{
+	const unsigned int NUM_BODIES = 10000;
+	const int NUM_FRAMES = 200;
+	{
+		std::vector<CPhysics2D> vStepped(NUM_BODIES);
+		std::vector<CPhysics2D> vUpdated(NUM_BODIES);
+		for (unsigned int i = 0; i < NUM_BODIES; i++)
+		{
+			vStepped[i].SetSteppedByWorld(true);
+			vStepped[i].SetStatus(CPhysics2D::FALL);
+			vUpdated[i].SetStatus(CPhysics2D::FALL);
+		}
+
+		std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+			CPhysicsWorld2D::GetInstance()->Step(1.0f / 60.0f);
+		const double dStepTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+		tStart = std::chrono::steady_clock::now();
+		for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+		{
+			for (unsigned int i = 0; i < NUM_BODIES; i++)
+				UpdateByOwner(vUpdated[i], 1.0f / 60.0f);
+		}
+		const double dUpdateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+		// Step also goes through the bodies which are updated by their owners, and masks them out
+		TEST_CHECK(IsSameBody(vStepped[0], vUpdated[0]));
+		CTestHarness* cTestHarness = CTestHarness::GetInstance();
+		cTestHarness->Report("Physics world step", (double)NUM_BODIES * NUM_FRAMES / dStepTime, "bodies/s");
+		cTestHarness->Report("Per-body update", (double)NUM_BODIES * NUM_FRAMES / dUpdateTime, "bodies/s");
+	}
+	CPhysicsWorld2D::Destroy();
+}
+
+/**
+ @brief Run the tests of CPhysicsWorld2D
+ */
+void RunPhysicsWorldTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("PhysicsWorld.StepMatchesIntegrate", TestStepMatchesIntegrate);
+	cTestHarness->Run("PhysicsWorld.StepMask", TestStepMask);
+	cTestHarness->Run("PhysicsWorld.WorldGravity", TestWorldGravity);
+	cTestHarness->Run("PhysicsWorld.Benchmark", BenchmarkStep);
+}
@@ -0,0 +1,277 @@
+/**
+ Tests of CQualityGovernor
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include QualityGovernor
+#include "TimeControl\QualityGovernor.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+
+// The time budget of a frame in the tests
+static const double TARGET_FRAME_TIME = 1.0 / 30.0;
+
+/**
+ A scene with knobs, whose frame times grow with the quality of its knobs
+ */
+struct TestScene
+{
+	// The number of levels of each knob, and the level which was last applied to it
+	int arrNumLevels[3];
+	int arrLevels[3];
+
+	TestScene(void)
+	{
+		arrNumLevels[0] = 3;
+		arrNumLevels[1] = 4;
+		arrNumLevels[2] = 3;
+
+		CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+		int* pLevels = arrLevels;
+		cQualityGovernor->RegisterKnob("Animation", arrNumLevels[0], [pLevels](const int iLevel) { pLevels[0] = iLevel; });
+		cQualityGovernor->RegisterKnob("Particles", arrNumLevels[1], [pLevels](const int iLevel) { pLevels[1] = iLevel; });
+		cQualityGovernor->RegisterKnob("AI", arrNumLevels[2], [pLevels](const int iLevel) { pLevels[2] = iLevel; });
+	}
+
+	// Get the quality of the knobs, from 0 to 1
+	double GetQuality(void) const
+	{
+		double dQuality = 0.0;
+		for (int i = 0; i < 3; i++)
+			dQuality += (double)arrLevels[i] / (arrNumLevels[i] - 1);
+		return dQuality / 3.0;
+	}
+
+	// Get the time of a frame with a load, which is the time of a frame at the full quality.
+	// Half of the time does not depend on the knobs, and there is up to 5% of noise
+	double GetFrameTime(const double dLoad, CRandom& cRandom) const
+	{
+		return dLoad * (0.5 + 0.5 * GetQuality()) * cRandom.RandFloatMinMax(0.95f, 1.05f);
+	}
+
+	// Check if all the knobs are at their highest levels
+	bool IsFullQuality(void) const
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (arrLevels[i] != arrNumLevels[i] - 1)
+				return false;
+		}
+		return true;
+	}
+};
+
+/**
+ @brief A scene under its budget keeps the full quality
+ */
+static void TestUnderBudget(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+	TEST_CHECK(sScene.IsFullQuality());
+
+	CRandom cRandom(1u, 0u);
+	for (int i = 0; i < 1000; i++)
+		cQualityGovernor->AddFrameTime(sScene.GetFrameTime(0.020, cRandom));
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 0);
+	TEST_CHECK(sScene.IsFullQuality());
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief The frames of a load spike are brought back into the budget, without switching the knobs back and forth,
+		and the full quality is restored when the load drops
+ */
+static void TestLoadCurve(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+	CRandom cRandom(2u, 0u);
+
+	// A light load
+	for (int i = 0; i < 600; i++)
+		cQualityGovernor->AddFrameTime(sScene.GetFrameTime(0.020, cRandom));
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 0);
+
+	// A heavy load, which is 1.5 times the budget at the full quality
+	std::vector<double> vSettledFrameTimes;
+	for (int i = 0; i < 2400; i++)
+	{
+		const double dFrameTime = sScene.GetFrameTime(0.050, cRandom);
+		cQualityGovernor->AddFrameTime(dFrameTime);
+		if (i >= 1800)
+			vSettledFrameTimes.push_back(dFrameTime);
+	}
+	const size_t uiNumHeavyDecisions = cQualityGovernor->GetDecisions().size();
+	TEST_CHECK(uiNumHeavyDecisions > 0);
+	bool bOnlyLowered = true;
+	for (auto& decision : cQualityGovernor->GetDecisions())
+	{
+		if (decision.iNewLevel != decision.iOldLevel - 1)
+			bOnlyLowered = false;
+	}
+	TEST_CHECK(bOnlyLowered);
+	TEST_CHECK(sScene.GetQuality() < 1.0);
+
+	// Once it has settled, the knobs stay where they are, and the frames are within the budget
+	TEST_CHECK(cQualityGovernor->GetDecisions().back().ullFrame < 600 + 1800);
+	unsigned int uiNumOverBudget = 0;
+	for (auto& frameTime : vSettledFrameTimes)
+	{
+		if (frameTime > TARGET_FRAME_TIME * 1.1)
+			uiNumOverBudget++;
+	}
+	TEST_CHECK(uiNumOverBudget < vSettledFrameTimes.size() / 20);
+
+	// The light load again
+	for (int i = 0; i < 3000; i++)
+		cQualityGovernor->AddFrameTime(sScene.GetFrameTime(0.020, cRandom));
+	TEST_CHECK(sScene.IsFullQuality());
+	bool bOnlyRaised = true;
+	for (size_t i = uiNumHeavyDecisions; i < cQualityGovernor->GetDecisions().size(); i++)
+	{
+		const CQualityGovernor::Decision& sDecision = cQualityGovernor->GetDecisions()[i];
+		if (sDecision.iNewLevel != sDecision.iOldLevel + 1)
+			bOnlyRaised = false;
+	}
+	TEST_CHECK(bOnlyRaised);
+	// Each level which was lowered was raised once
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == uiNumHeavyDecisions * 2);
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief The knob with the highest quality is lowered first, and the first knob registered wins a tie
+ */
+static void TestLowerOrder(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+
+	for (int i = 0; i < 2000; i++)
+		cQualityGovernor->AddFrameTime(TARGET_FRAME_TIME * 2.0);
+
+	const std::vector<CQualityGovernor::Decision>& vDecisions = cQualityGovernor->GetDecisions();
+	// The knobs are lowered to 0 in 2 + 3 + 2 steps
+	TEST_CHECK(vDecisions.size() == 7);
+	if (vDecisions.size() >= 3)
+	{
+		// All the knobs are at the full quality, so the first one is lowered first.
+		// The particles have 4 levels, so they have the highest quality after it
+		TEST_CHECK(vDecisions[0].hKnob == 0);
+		TEST_CHECK(vDecisions[1].hKnob == 1);
+		TEST_CHECK(vDecisions[2].hKnob == 2);
+	}
+	TEST_CHECK(sScene.GetQuality() == 0.0);
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief Frames between the 2 ratios of the budget do not change the knobs
+ */
+static void TestHysteresis(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+	cQualityGovernor->SetLevel(1, 1);
+
+	for (int i = 0; i < 2000; i++)
+		cQualityGovernor->AddFrameTime(TARGET_FRAME_TIME * ((i % 2) ? 0.75 : 1.05));
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 0);
+	TEST_CHECK(sScene.arrLevels[1] == 1);
+
+	// A knob is only raised after 4 evaluations in a row under the budget. The window is cleared by Init,
+	// and the first evaluation is made when it has 60 frame times, then one is made every 30 frames
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	for (int i = 0; i < 60 + 30 * 2; i++)
+		cQualityGovernor->AddFrameTime(TARGET_FRAME_TIME * 0.5);
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 0);
+	for (int i = 0; i < 30; i++)
+		cQualityGovernor->AddFrameTime(TARGET_FRAME_TIME * 0.5);
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 1);
+	TEST_CHECK(sScene.arrLevels[1] == 2);
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief A disabled governor keeps the levels of the knobs
+ */
+static void TestDisabled(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+	cQualityGovernor->SetEnabled(false);
+
+	for (int i = 0; i < 1000; i++)
+		cQualityGovernor->AddFrameTime(TARGET_FRAME_TIME * 3.0);
+	TEST_CHECK(cQualityGovernor->GetDecisions().size() == 0);
+	TEST_CHECK(sScene.IsFullQuality());
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief Clearing the knobs applies their highest levels, so a setting which outlives the scene is not left lowered
+ */
+static void TestClearKnobsRestoresLevels(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TestScene sScene;
+	cQualityGovernor->SetLevel(0, 0);
+	cQualityGovernor->SetLevel(1, 2);
+	TEST_CHECK(sScene.IsFullQuality() == false);
+
+	cQualityGovernor->ClearKnobs();
+	TEST_CHECK(sScene.IsFullQuality());
+	TEST_CHECK(cQualityGovernor->GetNumKnobs() == 0);
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief The percentiles are taken by the nearest rank
+ */
+static void TestPercentile(void)
+{
+	CQualityGovernor* cQualityGovernor = CQualityGovernor::GetInstance();
+	cQualityGovernor->Init(TARGET_FRAME_TIME);
+	TEST_CHECK(cQualityGovernor->GetPercentile(95.0) == 0.0);
+
+	for (int i = 100; i >= 1; i--)
+		cQualityGovernor->AddFrameTime(i * 0.001);
+	TEST_CHECK(cQualityGovernor->GetPercentile(95.0) == 0.095);
+	TEST_CHECK(cQualityGovernor->GetPercentile(50.0) == 0.050);
+	TEST_CHECK(cQualityGovernor->GetPercentile(0.0) == 0.001);
+	TEST_CHECK(cQualityGovernor->GetPercentile(100.0) == 0.100);
+
+	CQualityGovernor::Destroy();
+}
+
+/**
+ @brief Run the tests of CQualityGovernor
+ */
+void RunQualityGovernorTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("QualityGovernor.UnderBudget", TestUnderBudget);
+	cTestHarness->Run("QualityGovernor.LoadCurve", TestLoadCurve);
+	cTestHarness->Run("QualityGovernor.LowerOrder", TestLowerOrder);
+	cTestHarness->Run("QualityGovernor.Hysteresis", TestHysteresis);
+	cTestHarness->Run("QualityGovernor.Disabled", TestDisabled);
+	cTestHarness->Run("QualityGovernor.ClearKnobsRestoresLevels", TestClearKnobsRestoresLevels);
+	cTestHarness->Run("QualityGovernor.Percentile", TestPercentile);
+}
@@ -0,0 +1,289 @@
+/**
+ Tests of CRandom and CRandomStreams
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ @brief The generator gives the values of the reference PCG32 for seed 42 and stream 54
+ */
+static void TestReferenceSequence(void)
+{
+	const unsigned int arrExpected[6] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+
+	CRandom cRandom(42u, 54u);
+	for (int i = 0; i < 6; i++)
+		TEST_CHECK(cRandom.NextUInt() == arrExpected[i]);
+}
+
+/**
+ @brief The same seed and stream give the same values, and another stream gives other values
+ */
+static void TestSeedsAndStreams(void)
+{
+	CRandom cFirst(1234u, 0u);
+	CRandom cSecond(1234u, 0u);
+	CRandom cOtherStream(1234u, 1u);
+
+	unsigned int uiNumSame = 0;
+	unsigned int uiNumSameAsOtherStream = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		const unsigned int uiValue = cFirst.NextUInt();
+		if (uiValue == cSecond.NextUInt())
+			uiNumSame++;
+		if (uiValue == cOtherStream.NextUInt())
+			uiNumSameAsOtherStream++;
+	}
+	TEST_CHECK(uiNumSame == 1000);
+	TEST_CHECK(uiNumSameAsOtherStream == 0);
+}
+
+/**
+ @brief Jumping ahead gives the same state as generating the values which were skipped
+ */
+static void TestAdvance(void)
+{
+	const unsigned long long arrDeltas[5] = { 0u, 1u, 7u, 1000u, 123457u };
+	for (int i = 0; i < 5; i++)
+	{
+		CRandom cStepped(99u, 3u);
+		CRandom cJumped(99u, 3u);
+		for (unsigned long long j = 0; j < arrDeltas[i]; j++)
+			cStepped.NextUInt();
+		cJumped.Advance(arrDeltas[i]);
+
+		TEST_CHECK(cStepped.GetState().ullState == cJumped.GetState().ullState);
+		TEST_CHECK(cStepped.NextUInt() == cJumped.NextUInt());
+	}
+
+	// A full period of 2^64 values comes back to the same state
+	CRandom cRandom(5u, 6u);
+	const CRandom::STATE sBefore = cRandom.GetState();
+	cRandom.Advance(1ULL << 63);
+	cRandom.Advance(1ULL << 63);
+	TEST_CHECK(cRandom.GetState().ullState == sBefore.ullState);
+}
+
+/**
+ @brief A captured state replays the same values after it is restored
+ */
+static void TestCaptureAndRestore(void)
+{
+	CRandom cRandom(2020u, 7u);
+	for (int i = 0; i < 100; i++)
+		cRandom.NextUInt();
+
+	const CRandom::STATE sState = cRandom.GetState();
+	std::vector<unsigned int> vValues;
+	for (int i = 0; i < 100; i++)
+		vValues.push_back(cRandom.NextUInt());
+
+	cRandom.SetState(sState);
+	bool bReplayed = true;
+	for (int i = 0; i < 100; i++)
+		bReplayed = bReplayed && (cRandom.NextUInt() == vValues[i]);
+	TEST_CHECK(bReplayed);
+}
+
+/**
+ @brief The values in a bound are uniform, by a chi-squared test over 16 buckets.
+		The critical value for 15 degrees of freedom at p = 0.001 is 37.70.
+		The bound is not a power of 2, so a biased modulus would fail this test.
+ */
+static void TestBoundedUniformity(void)
+{
+	const unsigned int NUM_BUCKETS = 16;
+	const unsigned int NUM_SAMPLES = 1600000;
+	// A bound just over 3/4 of 2^32, so a plain modulus would put twice as many values in the low buckets
+	const unsigned int BOUND = 0xC0000000u + 16u;
+
+	std::vector<unsigned int> vBuckets(NUM_BUCKETS, 0);
+	CRandom cRandom(777u, 1u);
+	bool bInBound = true;
+	for (unsigned int i = 0; i < NUM_SAMPLES; i++)
+	{
+		const unsigned int uiValue = cRandom.NextUInt(BOUND);
+		bInBound = bInBound && (uiValue < BOUND);
+		vBuckets[(unsigned int)(((unsigned long long)uiValue * NUM_BUCKETS) / BOUND)]++;
+	}
+	TEST_CHECK(bInBound);
+
+	const double dExpected = (double)NUM_SAMPLES / NUM_BUCKETS;
+	double dChiSquared = 0.0;
+	for (unsigned int i = 0; i < NUM_BUCKETS; i++)
+		dChiSquared += (vBuckets[i] - dExpected) * (vBuckets[i] - dExpected) / dExpected;
+	TEST_CHECK(dChiSquared < 37.70);
+}
+
+/**
+ @brief Each bit of the values is set in half of the values, and the floats are in [0, 1) with a mean of 0.5
+ */
+static void TestBitsAndFloats(void)
+{
+	const unsigned int NUM_SAMPLES = 1000000;
+
+	CRandom cRandom(31337u, 2u);
+	std::vector<unsigned int> vBitCounts(32, 0);
+	for (unsigned int i = 0; i < NUM_SAMPLES; i++)
+	{
+		const unsigned int uiValue = cRandom.NextUInt();
+		for (unsigned int uiBit = 0; uiBit < 32; uiBit++)
+			vBitCounts[uiBit] += (uiValue >> uiBit) & 1u;
+	}
+	// 5 standard deviations of a fair coin over NUM_SAMPLES flips
+	const double dTolerance = 5.0 * 0.5 * sqrt((double)NUM_SAMPLES);
+	for (unsigned int uiBit = 0; uiBit < 32; uiBit++)
+		TEST_CHECK(fabs(vBitCounts[uiBit] - NUM_SAMPLES * 0.5) < dTolerance);
+
+	double dSum = 0.0;
+	bool bInRange = true;
+	for (unsigned int i = 0; i < NUM_SAMPLES; i++)
+	{
+		const float fValue = cRandom.NextFloat();
+		bInRange = bInRange && (fValue >= 0.0f) && (fValue < 1.0f);
+		dSum += fValue;
+	}
+	TEST_CHECK(bInRange);
+	// The standard deviation of the mean is sqrt(1/12) / sqrt(NUM_SAMPLES)
+	TEST_CHECK(fabs(dSum / NUM_SAMPLES - 0.5) < 5.0 * 0.2887 / sqrt((double)NUM_SAMPLES));
+}
+
+/**
+ @brief Consecutive values of a stream, and the values of 2 streams with the same seed, are not correlated
+ */
+static void TestCorrelation(void)
+{
+	const unsigned int NUM_SAMPLES = 1000000;
+	// 5 standard deviations of the correlation of independent samples
+	const double dTolerance = 5.0 / sqrt((double)NUM_SAMPLES);
+
+	CRandom cFirst(8u, CRandomStreams::STREAM_WORLD);
+	CRandom cSecond(8u, CRandomStreams::STREAM_SPAWNING);
+
+	double dSerialSum = 0.0, dStreamSum = 0.0;
+	float fPrevious = cFirst.NextFloat() - 0.5f;
+	for (unsigned int i = 0; i < NUM_SAMPLES; i++)
+	{
+		const float fValue = cFirst.NextFloat() - 0.5f;
+		dSerialSum += fPrevious * fValue;
+		dStreamSum += fValue * (cSecond.NextFloat() - 0.5f);
+		fPrevious = fValue;
+	}
+	// The variance of a uniform [-0.5, 0.5) value is 1/12
+	TEST_CHECK(fabs(dSerialSum / NUM_SAMPLES * 12.0) < dTolerance);
+	TEST_CHECK(fabs(dStreamSum / NUM_SAMPLES * 12.0) < dTolerance);
+}
+
+/**
+ @brief RandIntMinMax gives both of its limits and nothing outside them
+ */
+static void TestRandIntMinMax(void)
+{
+	CRandom cRandom(10u, 0u);
+	bool bInRange = true, bMin = false, bMax = false;
+	for (int i = 0; i < 10000; i++)
+	{
+		const int iValue = cRandom.RandIntMinMax(-3, 3);
+		bInRange = bInRange && (iValue >= -3) && (iValue <= 3);
+		bMin = bMin || (iValue == -3);
+		bMax = bMax || (iValue == 3);
+	}
+	TEST_CHECK(bInRange);
+	TEST_CHECK(bMin && bMax);
+	TEST_CHECK(cRandom.RandIntMinMax(5, 5) == 5);
+}
+
+/**
+ @brief The streams of the subsystems replay from the same seed, and from a captured state.
+		Using one stream does not change the values of another
+ */
+static void TestRandomStreams(void)
+{
+	CRandomStreams* cRandomStreams = CRandomStreams::GetInstance();
+	cRandomStreams->Init(42u);
+	TEST_CHECK(cRandomStreams->GetSeed() == 42u);
+
+	const unsigned int uiWorld = cRandomStreams->GetStream(CRandomStreams::STREAM_WORLD).NextUInt();
+	const unsigned int uiSpawning = cRandomStreams->GetStream(CRandomStreams::STREAM_SPAWNING).NextUInt();
+	TEST_CHECK(uiWorld != uiSpawning);
+
+	// Emitting particles does not move the spawning stream
+	cRandomStreams->Init(42u);
+	for (int i = 0; i < 1000; i++)
+		cRandomStreams->GetStream(CRandomStreams::STREAM_PARTICLES).NextFloat();
+	TEST_CHECK(cRandomStreams->GetStream(CRandomStreams::STREAM_WORLD).NextUInt() == uiWorld);
+	TEST_CHECK(cRandomStreams->GetStream(CRandomStreams::STREAM_SPAWNING).NextUInt() == uiSpawning);
+
+	// A captured state replays all the streams
+	std::vector<CRandom::STATE> vStates;
+	cRandomStreams->CaptureState(vStates);
+	const unsigned int uiNext = cRandomStreams->GetStream(CRandomStreams::STREAM_SPAWNING).NextUInt();
+	TEST_CHECK(cRandomStreams->RestoreState(vStates));
+	TEST_CHECK(cRandomStreams->GetStream(CRandomStreams::STREAM_SPAWNING).NextUInt() == uiNext);
+
+	vStates.pop_back();
+	TEST_CHECK(cRandomStreams->RestoreState(vStates) == false);
+
+	CRandomStreams::Destroy();
+}
+
+/**
+ @brief Benchmark the throughput of the generator against the C rand(), which it replaces
+ */
+static void BenchmarkRandom(void)
+{
+	const unsigned int NUM_VALUES = 10000000;
+
+	CRandom cRandom(1u, 0u);
+	unsigned int uiSum = 0;
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < NUM_VALUES; i++)
+		uiSum += cRandom.NextUInt();
+	const double dPCGTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	tStart = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < NUM_VALUES; i++)
+		uiSum += cRandom.RandIntMinMax(0, 99);
+	const double dBoundedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	srand(1u);
+	tStart = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < NUM_VALUES; i++)
+		uiSum += (unsigned int)rand();
+	const double dRandTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("CRandom::NextUInt", NUM_VALUES / dPCGTime / 1.0e6, "million values/s");
+	cTestHarness->Report("CRandom::RandIntMinMax", NUM_VALUES / dBoundedTime / 1.0e6, "million values/s");
+	cTestHarness->Report("rand", NUM_VALUES / dRandTime / 1.0e6, "million values/s");
+	// Use the sum, so that the loops are not optimised away
+	TEST_CHECK(uiSum != 0xFFFFFFFFu);
+}
+
+/**
+ @brief Run the tests of CRandom and CRandomStreams
+ */
+void RunRandomTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("Random.ReferenceSequence", TestReferenceSequence);
+	cTestHarness->Run("Random.SeedsAndStreams", TestSeedsAndStreams);
+	cTestHarness->Run("Random.Advance", TestAdvance);
+	cTestHarness->Run("Random.CaptureAndRestore", TestCaptureAndRestore);
+	cTestHarness->Run("Random.BoundedUniformity", TestBoundedUniformity);
+	cTestHarness->Run("Random.BitsAndFloats", TestBitsAndFloats);
+	cTestHarness->Run("Random.Correlation", TestCorrelation);
+	cTestHarness->Run("Random.RandIntMinMax", TestRandIntMinMax);
+	cTestHarness->Run("Random.Streams", TestRandomStreams);
+	cTestHarness->Run("Random.Benchmark", BenchmarkRandom);
+}
@@ -0,0 +1,214 @@
+/**
+ Tests of the uniform cache of CShader
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include Shader
+#include "RenderControl\Shader.h"
+// Include GLStateCache, which the shader uses its program through
+#include "RenderControl\GLStateCache.h"
+
+#include <chrono>
+
+/**
+ @brief Create a shader whose program has some uniforms
+ @param vActiveUniforms A const std::vector<std::string>& variable containing the names of the uniforms
+ */
+static CShader* CreateShader(const std::vector<std::string>& vActiveUniforms)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	cGLStub->vActiveUniforms = vActiveUniforms;
+	CShader* cShader = new CShader("../App/Shader/Scene2D.vs", "../App/Shader/Scene2D.fs");
+	cShader->use();
+	return cShader;
+}
+
+/**
+ @brief The active uniforms of the program are found once, after it is linked
+ */
+static void TestReflection(void)
+{
+	std::vector<std::string> vActiveUniforms;
+	vActiveUniforms.push_back("transform");
+	vActiveUniforms.push_back("runtime_color");
+	vActiveUniforms.push_back("lights[0]");
+	CShader* cShader = CreateShader(vActiveUniforms);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	TEST_CHECK(cGLStub->GetNumCalls("glGetActiveUniform") == 3);
+	TEST_CHECK(cShader->hasUniform(UNIFORM_TRANSFORM));
+	TEST_CHECK(cShader->hasUniform(UNIFORM_RUNTIME_COLOR));
+	TEST_CHECK(cShader->hasUniform(UNIFORM_TEXT_COLOUR) == false);
+	// An array is set by the name of the array
+	TEST_CHECK(cShader->hasUniform(ShaderUniformID("lights")));
+
+	// The reflected uniforms are not looked up again when they are set
+	const unsigned int uiNumLookups = cGLStub->GetNumCalls("glGetUniformLocation");
+	cShader->setMat4("transform", glm::mat4(1.0f));
+	cShader->setVec4(UNIFORM_RUNTIME_COLOR, glm::vec4(1.0f));
+	TEST_CHECK(cGLStub->GetNumCalls("glGetUniformLocation") == uiNumLookups);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniformMatrix4fv") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform4fv") == 1);
+
+	delete cShader;
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Setting the value which a uniform already has does not call OpenGL
+ */
+static void TestRedundantUploads(void)
+{
+	std::vector<std::string> vActiveUniforms;
+	vActiveUniforms.push_back("transform");
+	vActiveUniforms.push_back("runtime_color");
+	CShader* cShader = CreateShader(vActiveUniforms);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	cShader->setVec4("runtime_color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+	cShader->setVec4("runtime_color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+	cShader->setVec4(UNIFORM_RUNTIME_COLOR, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform4fv") == 1);
+	TEST_CHECK(cShader->getNumUploads() == 1);
+	TEST_CHECK(cShader->getNumSkippedUploads() == 2);
+
+	// A changed value is uploaded
+	cShader->setVec4(UNIFORM_RUNTIME_COLOR, glm::vec4(0.5f, 0.0f, 0.0f, 1.0f));
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform4fv") == 2);
+	TEST_CHECK(cGLStub->mapUniformValues[1] == 0.5f);
+
+	// The cache is kept for each uniform
+	cShader->setMat4(UNIFORM_TRANSFORM, glm::mat4(1.0f));
+	cShader->setMat4(UNIFORM_TRANSFORM, glm::mat4(1.0f));
+	TEST_CHECK(cGLStub->GetNumCalls("glUniformMatrix4fv") == 1);
+
+	cShader->resetUploadCounts();
+	TEST_CHECK(cShader->getNumUploads() == 0);
+	TEST_CHECK(cShader->getNumSkippedUploads() == 0);
+
+	delete cShader;
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief A uniform which the program does not have is looked up once, and is never uploaded
+ */
+static void TestMissingUniform(void)
+{
+	std::vector<std::string> vActiveUniforms;
+	vActiveUniforms.push_back("transform");
+	CShader* cShader = CreateShader(vActiveUniforms);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	const unsigned int uiNumLookups = cGLStub->GetNumCalls("glGetUniformLocation");
+	cShader->setFloat("missing", 1.0f);
+	cShader->setFloat("missing", 2.0f);
+	TEST_CHECK(cGLStub->GetNumCalls("glGetUniformLocation") == uiNumLookups + 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform1f") == 0);
+	TEST_CHECK(cShader->getNumUploads() == 0);
+
+	// A uniform which was not reflected is set by its ID without a lookup
+	cShader->setFloat(ShaderUniformID("unknown"), 1.0f);
+	TEST_CHECK(cGLStub->GetNumCalls("glGetUniformLocation") == uiNumLookups + 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform1f") == 0);
+
+	delete cShader;
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief A uniform whose ID collides with another uniform's ID is set at its own location, with its own value
+ */
+static void TestIDCollision(void)
+{
+	// The FNV-1a hashes of these names are the same
+	TEST_CHECK(ShaderUniformID("u31992") == ShaderUniformID("u605430"));
+
+	std::vector<std::string> vActiveUniforms;
+	vActiveUniforms.push_back("u31992");
+	vActiveUniforms.push_back("u605430");
+	CShader* cShader = CreateShader(vActiveUniforms);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	cShader->setFloat("u31992", 1.0f);
+	cShader->setFloat("u605430", 2.0f);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform1f") == 2);
+	TEST_CHECK(cGLStub->mapUniformValues[0] == 1.0f);
+	TEST_CHECK(cGLStub->mapUniformValues[1] == 2.0f);
+
+	// Each keeps its own value, so setting them again with the same values is skipped
+	cShader->setFloat("u31992", 1.0f);
+	cShader->setFloat("u605430", 2.0f);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform1f") == 2);
+
+	// Changing one of them does not change the other
+	cShader->setFloat("u605430", 3.0f);
+	TEST_CHECK(cGLStub->mapUniformValues[0] == 1.0f);
+	TEST_CHECK(cGLStub->mapUniformValues[1] == 3.0f);
+
+	delete cShader;
+
+	// A name which collides with a reflected uniform, but which the program does not have, is not uploaded
+	vActiveUniforms.pop_back();
+	cShader = CreateShader(vActiveUniforms);
+	cShader->setFloat("u605430", 4.0f);
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform1f") == 0);
+	TEST_CHECK(cGLStub->mapUniformValues.count(0) == 0);
+
+	delete cShader;
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Benchmark setting uniforms by their IDs and by their names, with most of the values unchanged
+ */
+static void BenchmarkUniforms(void)
+{
+	const int NUM_SETS = 1000000;
+
+	std::vector<std::string> vActiveUniforms;
+	vActiveUniforms.push_back("transform");
+	vActiveUniforms.push_back("runtime_color");
+	vActiveUniforms.push_back("textColour");
+	CShader* cShader = CreateShader(vActiveUniforms);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	// 1 in 4 of the values changes
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_SETS; i++)
+		cShader->setVec4(UNIFORM_RUNTIME_COLOR, glm::vec4((float)(i / 4), 0.0f, 0.0f, 1.0f));
+	const double dIDTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_SETS; i++)
+		cShader->setVec4("runtime_color", glm::vec4((float)(i / 4), 1.0f, 0.0f, 1.0f));
+	const double dNameTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	TEST_CHECK(cGLStub->GetNumCalls("glUniform4fv") == NUM_SETS / 4 * 2);
+	TEST_CHECK(cShader->getNumSkippedUploads() == NUM_SETS / 4 * 3 * 2);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Set by ID", NUM_SETS / dIDTime / 1.0e6, "million sets/s");
+	cTestHarness->Report("Set by name", NUM_SETS / dNameTime / 1.0e6, "million sets/s");
+	cTestHarness->Report("Uploads skipped", 100.0 * cShader->getNumSkippedUploads() / (NUM_SETS * 2), "%");
+
+	delete cShader;
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Run the tests of CShader
+ */
+void RunShaderTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("Shader.Reflection", TestReflection);
+	cTestHarness->Run("Shader.RedundantUploads", TestRedundantUploads);
+	cTestHarness->Run("Shader.MissingUniform", TestMissingUniform);
+	cTestHarness->Run("Shader.IDCollision", TestIDCollision);
+	cTestHarness->Run("Shader.Benchmark", BenchmarkUniforms);
+}
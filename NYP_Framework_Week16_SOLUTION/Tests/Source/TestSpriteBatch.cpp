@@ -0,0 +1,243 @@
+/**
+ Tests of CSpriteBatch2D, drawing through the OpenGL backend into the GL stubs
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include SpriteBatch2D
+#include "RenderControl\SpriteBatch2D.h"
+// Include StreamBuffer
+#include "RenderControl\StreamBuffer.h"
+// Include ShaderManager
+#include "RenderControl\ShaderManager.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include Random
+#include "System\Random.h"
+
+#include <chrono>
+
+/**
+ The shaders and the sprite batch of a test, which draws through the OpenGL backend into the GL stubs
+ */
+struct TestBatch
+{
+	CShader* arrShaders[2];
+	CSpriteBatch2D* cSpriteBatch2D;
+
+	TestBatch(void)
+	{
+		CGLStub* cGLStub = CGLStub::GetInstance();
+		cGLStub->Reset();
+		cGLStub->vActiveUniforms.push_back("transform");
+		cGLStub->vActiveUniforms.push_back("runtime_color");
+		for (int i = 0; i < 2; i++)
+			arrShaders[i] = new CShader("../App/Shader/Scene2D.vs", "../App/Shader/Scene2D.fs");
+
+		CStreamBuffer::GetInstance()->Init();
+		cSpriteBatch2D = CSpriteBatch2D::GetInstance();
+		cSpriteBatch2D->SetBackend(NULL);
+		cSpriteBatch2D->Init();
+		cSpriteBatch2D->ResetCounts();
+		cGLStub->ResetCounts();
+	}
+
+	~TestBatch(void)
+	{
+		CSpriteBatch2D::Destroy();
+		CStreamBuffer::Destroy();
+		for (int i = 0; i < 2; i++)
+			delete arrShaders[i];
+		CShaderManager::Destroy();
+		CGLStateCache::Destroy();
+	}
+
+	// Check if 2 vectors are the same, within the rounding of the floats
+	template <typename T>
+	static bool IsNear(const T& a, const T& b)
+	{
+		return glm::all(glm::lessThan(glm::abs(a - b), T(1.0e-6f)));
+	}
+
+	// Get the number of sprites which were drawn by the draw calls which reached OpenGL
+	unsigned long long GetNumSpritesDrawn(void) const
+	{
+		return CGLStub::GetInstance()->ullNumIndicesDrawn / 6;
+	}
+};
+
+/**
+ @brief The sprites which share a shader and a texture are drawn with one draw call, however they were interleaved
+ */
+static void TestDrawCounts(void)
+{
+	TestBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	// 2 shaders and 3 textures, interleaved in the same layer
+	sBatch.cSpriteBatch2D->Begin();
+	for (int i = 0; i < 120; i++)
+		sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[i % 2], 10 + i % 3, glm::vec2(0.5f), glm::vec2(0.1f));
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSprites() == 120);
+	TEST_CHECK(cGLStub->GetNumCalls() == 0);
+	sBatch.cSpriteBatch2D->End();
+
+	TEST_CHECK(cGLStub->GetNumCalls("glDrawElementsBaseVertex") == 6);
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumDrawCalls() == 6);
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSpritesDrawn() == 120);
+	TEST_CHECK(sBatch.GetNumSpritesDrawn() == 120);
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSprites() == 0);
+	// Each shader is used once, and each run binds its texture
+	TEST_CHECK(cGLStub->GetNumCalls("glUseProgram") == 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glBindTexture") == 6);
+
+	// A texture in layers 0 and 2, with another texture in layer 1 between them, is drawn with 3 draw calls
+	sBatch.cSpriteBatch2D->ResetCounts();
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f), glm::vec2(0.1f), glm::vec4(0, 0, 1, 1), glm::vec4(1.0f), 0);
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 11, glm::vec2(0.5f), glm::vec2(0.1f), glm::vec4(0, 0, 1, 1), glm::vec4(1.0f), 1);
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f), glm::vec2(0.1f), glm::vec4(0, 0, 1, 1), glm::vec4(1.0f), 2);
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f), glm::vec2(0.1f), glm::vec4(0, 0, 1, 1), glm::vec4(1.0f), 0);
+	sBatch.cSpriteBatch2D->End();
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumDrawCalls() == 3);
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumSpritesDrawn() == 4);
+
+	// An empty batch does not draw
+	sBatch.cSpriteBatch2D->ResetCounts();
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->End();
+	TEST_CHECK(sBatch.cSpriteBatch2D->GetNumDrawCalls() == 0);
+}
+
+/**
+ @brief A run is split when it has MAX_ITEMS_PER_RUN sprites, as the indices are only built for that many
+ */
+static void TestRunSplit(void)
+{
+	TestBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	const unsigned int uiNumSprites = CRenderCommandList2D::MAX_ITEMS_PER_RUN * 2 + 1;
+	sBatch.cSpriteBatch2D->Begin();
+	for (unsigned int i = 0; i < uiNumSprites; i++)
+		sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f), glm::vec2(0.1f));
+	sBatch.cSpriteBatch2D->End();
+
+	TEST_CHECK(cGLStub->GetNumCalls("glDrawElementsBaseVertex") == 3);
+	TEST_CHECK(sBatch.GetNumSpritesDrawn() == uiNumSprites);
+	TEST_CHECK(CStreamBuffer::GetInstance()->GetNumFailedAllocations() == 0);
+}
+
+/**
+ @brief The vertices of a sprite are its corners, with the UV rectangle and the tint, in the order which they were added
+ */
+static void TestVertices(void)
+{
+	TestBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f, 0.5f), glm::vec2(0.2f, 0.4f),
+								glm::vec4(0.25f, 0.5f, 0.75f, 1.0f), glm::vec4(1.0f, 0.0f, 0.0f, 0.5f));
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.1f, 0.1f), glm::vec2(0.1f, 0.1f));
+	sBatch.cSpriteBatch2D->End();
+
+	// The orphaned stream buffer maps the storage of the stub, and the first allocation is at its start
+	const std::vector<unsigned char>& vBufferData = cGLStub->mapBufferData[CStreamBuffer::GetInstance()->GetBufferID()];
+	TEST_CHECK(vBufferData.size() >= 8 * sizeof(Vertex));
+	if (vBufferData.size() < 8 * sizeof(Vertex))
+		return;
+	const Vertex* pVertices = (const Vertex*)vBufferData.data();
+	TEST_CHECK(TestBatch::IsNear(pVertices[0].position, glm::vec3(0.4f, 0.3f, 0.0f)));
+	TEST_CHECK(TestBatch::IsNear(pVertices[2].position, glm::vec3(0.6f, 0.7f, 0.0f)));
+	TEST_CHECK(pVertices[0].texCoord == glm::vec2(0.25f, 0.5f));
+	TEST_CHECK(pVertices[2].texCoord == glm::vec2(0.75f, 1.0f));
+	TEST_CHECK(pVertices[3].color == glm::vec4(1.0f, 0.0f, 0.0f, 0.5f));
+	TEST_CHECK(TestBatch::IsNear(pVertices[4].position, glm::vec3(0.05f, 0.05f, 0.0f)));
+	TEST_CHECK(pVertices[4].color == glm::vec4(1.0f));
+
+	// The positions and the tint are in the vertices, so the shader's transform is the identity
+	TEST_CHECK(cGLStub->mapUniformValues[0] == 1.0f);
+	TEST_CHECK(cGLStub->mapUniformValues[1] == 1.0f);
+}
+
+/**
+ @brief A deferred texture is deleted once no list can draw it
+ */
+static void TestDeleteTextureLater(void)
+{
+	TestBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[0], 10, glm::vec2(0.5f), glm::vec2(0.1f));
+	sBatch.cSpriteBatch2D->DeleteTextureLater(10);
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteTextures") == 0);
+	sBatch.cSpriteBatch2D->End();
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteTextures") == 1);
+
+	// A texture which no list has is deleted at once
+	sBatch.cSpriteBatch2D->Begin();
+	sBatch.cSpriteBatch2D->DeleteTextureLater(11);
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteTextures") == 2);
+	sBatch.cSpriteBatch2D->End();
+}
+
+/**
+ @brief Benchmark a frame of 100,000 sprites, in 4 layers with 16 textures and 2 shaders
+ */
+static void BenchmarkSprites(void)
+{
+	const int NUM_SPRITES = 100000;
+	const int NUM_FRAMES = 20;
+
+	TestBatch sBatch;
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	CRandom cRandom(47u, 0u);
+	std::vector<glm::vec2> vCentres(NUM_SPRITES);
+	for (int i = 0; i < NUM_SPRITES; i++)
+		vCentres[i] = glm::vec2(cRandom.RandFloatMinMax(0.0f, 1.0f), cRandom.RandFloatMinMax(0.0f, 1.0f));
+
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		sBatch.cSpriteBatch2D->Begin();
+		for (int i = 0; i < NUM_SPRITES; i++)
+		{
+			sBatch.cSpriteBatch2D->Draw(sBatch.arrShaders[(i / 16) % 2], 10 + i % 16, vCentres[i], glm::vec2(0.01f),
+										glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), glm::vec4(1.0f), (i / 32) % 4);
+		}
+		sBatch.cSpriteBatch2D->End();
+		CStreamBuffer::GetInstance()->EndFrame();
+	}
+	const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	// Each of the 4 layers has 2 shaders and 16 textures, which is 128 runs of about 780 sprites.
+	// Drawn one at a time, each sprite would be a draw call
+	const unsigned int uiNumDrawCalls = sBatch.cSpriteBatch2D->GetNumDrawCalls() / NUM_FRAMES;
+	TEST_CHECK(sBatch.GetNumSpritesDrawn() == (unsigned long long)NUM_SPRITES * NUM_FRAMES);
+	TEST_CHECK(uiNumDrawCalls == 4 * 2 * 16);
+	TEST_CHECK(cGLStub->GetNumCalls("glDrawElementsBaseVertex") == uiNumDrawCalls * NUM_FRAMES);
+	TEST_CHECK(CStreamBuffer::GetInstance()->GetNumFailedAllocations() == 0);
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Sprites per frame", NUM_SPRITES, "sprites");
+	cTestHarness->Report("Draw calls per frame", uiNumDrawCalls, "calls");
+	cTestHarness->Report("Time per frame", dTime / NUM_FRAMES * 1000.0, "ms");
+	cTestHarness->Report("Sprites", (double)NUM_SPRITES * NUM_FRAMES / dTime / 1.0e6, "million sprites/s");
+}
+
+/**
+ @brief Run the tests of CSpriteBatch2D
+ */
+void RunSpriteBatchTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("SpriteBatch.DrawCounts", TestDrawCounts);
+	cTestHarness->Run("SpriteBatch.RunSplit", TestRunSplit);
+	cTestHarness->Run("SpriteBatch.Vertices", TestVertices);
+	cTestHarness->Run("SpriteBatch.DeleteTextureLater", TestDeleteTextureLater);
+	cTestHarness->Run("SpriteBatch.Benchmark", BenchmarkSprites);
+}
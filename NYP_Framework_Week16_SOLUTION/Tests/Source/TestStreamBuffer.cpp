@@ -0,0 +1,254 @@
+/**
+ Tests of CStreamBuffer, against the GL stubs
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include StreamBuffer
+#include "RenderControl\StreamBuffer.h"
+
+#include <chrono>
+#include <cstring>
+
+// The size of a segment in the tests
+static const GLsizeiptr SEGMENT_SIZE = 1024;
+
+/**
+ @brief Allocate a number of bytes, fill them with a value, and commit them
+ @param iSize A const GLsizeiptr variable containing the number of bytes
+ @param iAlignment A const GLsizeiptr variable containing the alignment of the offset
+ @param ucValue A const unsigned char variable containing the value of the bytes
+ */
+static CStreamBuffer::Allocation AllocateAndFill(const GLsizeiptr iSize, const GLsizeiptr iAlignment, const unsigned char ucValue)
+{
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	CStreamBuffer::Allocation sAllocation = cStreamBuffer->Allocate(iSize, iAlignment);
+	if (sAllocation.pData != NULL)
+	{
+		memset(sAllocation.pData, ucValue, (size_t)iSize);
+		cStreamBuffer->Commit(sAllocation);
+	}
+	return sAllocation;
+}
+
+/**
+ @brief Check if the storage of the stream buffer has a value in a range of bytes
+ @param iOffset A const GLintptr variable containing the offset of the range
+ @param iSize A const GLsizeiptr variable containing the number of bytes
+ @param ucValue A const unsigned char variable containing the value
+ */
+static bool HasValue(const GLintptr iOffset, const GLsizeiptr iSize, const unsigned char ucValue)
+{
+	const std::vector<unsigned char>& vBufferData =
+		CGLStub::GetInstance()->mapBufferData[CStreamBuffer::GetInstance()->GetBufferID()];
+	if ((size_t)(iOffset + iSize) > vBufferData.size())
+		return false;
+	for (GLsizeiptr i = 0; i < iSize; i++)
+	{
+		if (vBufferData[(size_t)(iOffset + i)] != ucValue)
+			return false;
+	}
+	return true;
+}
+
+/**
+ @brief The allocations are aligned from the start of the buffer, and move to the next segment when they do not fit
+ */
+static void TestAllocate(void)
+{
+	CGLStub::GetInstance()->Reset();
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	TEST_CHECK(cStreamBuffer->Init(SEGMENT_SIZE));
+	TEST_CHECK(cStreamBuffer->IsPersistent() == false);
+
+	CStreamBuffer::Allocation sAllocation = AllocateAndFill(100, 36, 1);
+	TEST_CHECK(sAllocation.iOffset == 0);
+	sAllocation = AllocateAndFill(100, 36, 2);
+	TEST_CHECK(sAllocation.iOffset == 108);
+	TEST_CHECK(HasValue(0, 100, 1));
+	TEST_CHECK(HasValue(108, 100, 2));
+
+	// The rest of the segment is too small, so the allocation is made from the start of the next one
+	sAllocation = AllocateAndFill(900, 4, 3);
+	TEST_CHECK(sAllocation.iOffset == SEGMENT_SIZE);
+	TEST_CHECK(HasValue(SEGMENT_SIZE, 900, 3));
+
+	// An allocation larger than a segment fails
+	sAllocation = cStreamBuffer->Allocate(SEGMENT_SIZE + 1, 4);
+	TEST_CHECK(sAllocation.pData == NULL);
+	TEST_CHECK(cStreamBuffer->GetNumFailedAllocations() == 1);
+	TEST_CHECK(cStreamBuffer->GetNumAllocations() == 3);
+	TEST_CHECK(cStreamBuffer->GetNumBytesAllocated() == 1100);
+
+	// The next frame writes into the next segment, and the ring wraps around after the last one
+	cStreamBuffer->EndFrame();
+	sAllocation = AllocateAndFill(4, 4, 4);
+	TEST_CHECK(sAllocation.iOffset == SEGMENT_SIZE * 2);
+	cStreamBuffer->EndFrame();
+	// A frame which did not allocate stays in its segment
+	cStreamBuffer->EndFrame();
+	sAllocation = AllocateAndFill(4, 4, 5);
+	TEST_CHECK(sAllocation.iOffset == 0);
+
+	CStreamBuffer::Destroy();
+}
+
+/**
+ @brief Without ARB_buffer_storage, each allocation is mapped without synchronisation, and the buffer is orphaned
+		each time that the ring wraps around
+ */
+static void TestOrphanWrap(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	cStreamBuffer->Init(SEGMENT_SIZE);
+	TEST_CHECK(cGLStub->GetNumCalls("glBufferData") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glFenceSync") == 0);
+
+	for (unsigned int i = 0; i < CStreamBuffer::NUM_SEGMENTS * 2; i++)
+	{
+		AllocateAndFill(64, 4, 1);
+		cStreamBuffer->EndFrame();
+	}
+	TEST_CHECK(cGLStub->GetNumCalls("glMapBufferRange") == CStreamBuffer::NUM_SEGMENTS * 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glUnmapBuffer") == CStreamBuffer::NUM_SEGMENTS * 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glBufferData") == 1 + 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glFenceSync") == 0);
+	TEST_CHECK(cStreamBuffer->GetNumStalls() == 0);
+
+	// The orphaned storage does not have the vertices of the frames before it
+	AllocateAndFill(64, 4, 2);
+	TEST_CHECK(HasValue(0, 64, 2));
+	TEST_CHECK(HasValue(SEGMENT_SIZE, 64, 0));
+
+	CStreamBuffer::Destroy();
+	TEST_CHECK(cGLStub->GetNumCalls("glDeleteBuffers") == 1);
+}
+
+/**
+ @brief With ARB_buffer_storage, the buffer is mapped once, each segment is fenced when it is left,
+		and its fence is waited for before it is written again
+ */
+static void TestPersistentFences(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	cGLStub->iMajorVersion = 4;
+	cGLStub->iMinorVersion = 4;
+	CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+	cStreamBuffer->Init(SEGMENT_SIZE);
+	TEST_CHECK(cStreamBuffer->IsPersistent());
+	TEST_CHECK(cGLStub->GetNumCalls("glBufferStorage") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glBufferData") == 0);
+	TEST_CHECK(cGLStub->GetNumCalls("glMapBufferRange") == 1);
+
+	// The first time round the ring, no segment has a fence to wait for
+	for (unsigned int i = 0; i < CStreamBuffer::NUM_SEGMENTS - 1; i++)
+	{
+		AllocateAndFill(64, 4, (unsigned char)(i + 1));
+		cStreamBuffer->EndFrame();
+	}
+	TEST_CHECK(cGLStub->GetNumCalls("glFenceSync") == CStreamBuffer::NUM_SEGMENTS - 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glClientWaitSync") == 0);
+
+	// Wrapping around waits for the fence of the first segment, which was signalled
+	AllocateAndFill(64, 4, 3);
+	cStreamBuffer->EndFrame();
+	TEST_CHECK(cGLStub->GetNumCalls("glClientWaitSync") == 1);
+	TEST_CHECK(cStreamBuffer->GetNumStalls() == 0);
+	TEST_CHECK(cGLStub->mapFences.size() == CStreamBuffer::NUM_SEGMENTS - 1);
+	TEST_CHECK(HasValue(0, 64, 1));
+	TEST_CHECK(HasValue(SEGMENT_SIZE, 64, 2));
+	TEST_CHECK(HasValue(SEGMENT_SIZE * 2, 64, 3));
+
+	// A fence which is not signalled yet stalls, and is waited for with the commands flushed until it is
+	cGLStub->uiFenceTimeouts = 2;
+	cGLStub->ResetCounts();
+	for (unsigned int i = 0; i < CStreamBuffer::NUM_SEGMENTS; i++)
+	{
+		AllocateAndFill(64, 4, 4);
+		cStreamBuffer->EndFrame();
+	}
+	TEST_CHECK(cStreamBuffer->GetNumStalls() == CStreamBuffer::NUM_SEGMENTS);
+	TEST_CHECK(cGLStub->GetNumCalls("glClientWaitSync") == CStreamBuffer::NUM_SEGMENTS * 3);
+	TEST_CHECK(cStreamBuffer->GetStallTime() >= 0.0);
+	// The allocations are written straight into the mapped storage
+	TEST_CHECK(cGLStub->GetNumCalls("glMapBufferRange") == 0);
+	TEST_CHECK(cGLStub->GetNumCalls("glUnmapBuffer") == 0);
+	TEST_CHECK(cGLStub->mapFences.size() == CStreamBuffer::NUM_SEGMENTS - 1);
+
+	// An allocation which does not fit moves to the next segment, and waits for its fence too
+	cGLStub->uiFenceTimeouts = 0;
+	cGLStub->ResetCounts();
+	AllocateAndFill(SEGMENT_SIZE - 100, 4, 5);
+	AllocateAndFill(200, 4, 6);
+	TEST_CHECK(cGLStub->GetNumCalls("glFenceSync") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glClientWaitSync") == 1);
+
+	// Init again releases the fences, and Destroy releases the buffer
+	cStreamBuffer->Init(SEGMENT_SIZE);
+	TEST_CHECK(cGLStub->mapFences.size() == 0);
+	AllocateAndFill(64, 4, 7);
+	cStreamBuffer->EndFrame();
+	CStreamBuffer::Destroy();
+	TEST_CHECK(cGLStub->mapFences.size() == 0);
+}
+
+/**
+ @brief Benchmark the allocations of a frame of sprite runs, with the buffer mapped persistently and orphaned
+ */
+static void BenchmarkAllocations(void)
+{
+	const int NUM_FRAMES = 1000;
+	const int NUM_ALLOCATIONS = 200;
+	// A run of 64 sprites, with 4 vertices of 36 bytes each
+	const GLsizeiptr ALLOCATION_SIZE = 64 * 4 * 36;
+
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	for (int iMode = 0; iMode < 2; iMode++)
+	{
+		const bool bPersistent = (iMode == 0);
+		cGLStub->Reset();
+		cGLStub->iMajorVersion = bPersistent ? 4 : 3;
+		cGLStub->iMinorVersion = bPersistent ? 4 : 3;
+		CStreamBuffer* cStreamBuffer = CStreamBuffer::GetInstance();
+		cStreamBuffer->Init();
+		cGLStub->ResetCounts();
+
+		std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+		for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+		{
+			for (int i = 0; i < NUM_ALLOCATIONS; i++)
+				AllocateAndFill(ALLOCATION_SIZE, 36, (unsigned char)i);
+			cStreamBuffer->EndFrame();
+		}
+		const double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+		TEST_CHECK(cStreamBuffer->IsPersistent() == bPersistent);
+		TEST_CHECK(cStreamBuffer->GetNumAllocations() == NUM_FRAMES * NUM_ALLOCATIONS);
+		TEST_CHECK(cStreamBuffer->GetNumFailedAllocations() == 0);
+		TEST_CHECK(cStreamBuffer->GetNumStalls() == 0);
+
+		cTestHarness->Report(bPersistent ? "Persistent allocations" : "Orphaned allocations",
+							 NUM_FRAMES * NUM_ALLOCATIONS / dTime / 1.0e6, "million/s");
+		cTestHarness->Report(bPersistent ? "Persistent GL calls per allocation" : "Orphaned GL calls per allocation",
+							 (double)cGLStub->GetNumCalls() / (NUM_FRAMES * NUM_ALLOCATIONS), "calls");
+		CStreamBuffer::Destroy();
+	}
+}
+
+/**
+ @brief Run the tests of CStreamBuffer
+ */
+void RunStreamBufferTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("StreamBuffer.Allocate", TestAllocate);
+	cTestHarness->Run("StreamBuffer.OrphanWrap", TestOrphanWrap);
+	cTestHarness->Run("StreamBuffer.PersistentFences", TestPersistentFences);
+	cTestHarness->Run("StreamBuffer.Benchmark", BenchmarkAllocations);
+}
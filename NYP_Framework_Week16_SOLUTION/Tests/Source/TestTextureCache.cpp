@@ -0,0 +1,183 @@
+/**
+ Tests of CTextureCache, loading the images of the App into the GL stubs
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include TextureCache
+#include "RenderControl\TextureCache.h"
+// Include GLStateCache
+#include "RenderControl\GLStateCache.h"
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// The images which the tests load. The RGBA images are 25 by 25 texels, and the RGB image is 512 by 512 texels
+static const char* const IMAGE_GROUND = "../App/Image/Scene2D_GroundTile.tga";
+static const char* const IMAGE_EXIT = "../App/Image/Scene2D_Exit.tga";
+static const char* const IMAGE_SPIKES = "../App/Image/Scene2D_Spikes.tga";
+static const char* const IMAGE_SPA = "../App/Image/Scene2D_Spa.tga";
+static const char* const IMAGE_RGB = "../App/Image/Scene3D_Enemy_01.tga";
+static const size_t SMALL_IMAGE_SIZE = 25 * 25 * 4;
+
+/**
+ The texture cache of a test, which loads the textures into the GL stubs
+ */
+struct TestTextureCache
+{
+	CTextureCache* cTextureCache;
+
+	TestTextureCache(const size_t uiBudget)
+	{
+		CGLStub::GetInstance()->Reset();
+		cTextureCache = CTextureCache::GetInstance();
+		cTextureCache->Init(uiBudget);
+	}
+
+	~TestTextureCache(void)
+	{
+		CTextureCache::Destroy();
+		CImageLoader::Destroy();
+		CGLStateCache::Destroy();
+	}
+
+	// Acquire a texture without mipmaps, as the sprites do
+	GLuint Acquire(const char* filename)
+	{
+		return cTextureCache->Acquire(filename, true, GL_CLAMP_TO_EDGE, GL_LINEAR, false);
+	}
+};
+
+/**
+ @brief A texture is loaded once for each path and sampler settings, and stays resident after its last Release
+ */
+static void TestReferences(void)
+{
+	TestTextureCache sCache(64 * 1024 * 1024);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	const GLuint uiGround = sCache.Acquire(IMAGE_GROUND);
+	TEST_CHECK(uiGround != 0);
+	// The same file, written in another way
+	TEST_CHECK(sCache.Acquire("..\\App\\.\\Image\\\\scene2d_groundtile.TGA") == uiGround);
+	TEST_CHECK(sCache.cTextureCache->GetNumReferences(uiGround) == 2);
+	TEST_CHECK(sCache.cTextureCache->GetNumHits() == 1);
+	TEST_CHECK(sCache.cTextureCache->GetNumMisses() == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glTexImage2D") == 1);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == SMALL_IMAGE_SIZE);
+
+	// Other sampler settings are another texture
+	const GLuint uiRepeatedGround = sCache.cTextureCache->Acquire(IMAGE_GROUND, true, GL_REPEAT, GL_LINEAR, false);
+	TEST_CHECK((uiRepeatedGround != 0) && (uiRepeatedGround != uiGround));
+	TEST_CHECK(sCache.cTextureCache->GetNumTextures() == 2);
+	sCache.cTextureCache->Release(uiRepeatedGround);
+
+	// The texture is not deleted when it has no references, and it is not loaded again
+	sCache.cTextureCache->Release(uiGround);
+	sCache.cTextureCache->Release(uiGround);
+	TEST_CHECK(sCache.cTextureCache->GetNumReferences(uiGround) == 0);
+	TEST_CHECK(sCache.cTextureCache->GetNumTextures() == 2);
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 0);
+	TEST_CHECK(sCache.Acquire(IMAGE_GROUND) == uiGround);
+	TEST_CHECK(cGLStub->GetNumCalls("glTexImage2D") == 2);
+	sCache.cTextureCache->Release(uiGround);
+
+	// A texture without references cannot be released again
+	sCache.cTextureCache->Release(uiGround);
+	TEST_CHECK(sCache.cTextureCache->GetNumReferences(uiGround) == 0);
+
+	// A file which cannot be loaded is not cached
+	TEST_CHECK(sCache.Acquire("../App/Image/Missing.tga") == 0);
+	TEST_CHECK(sCache.cTextureCache->GetNumTextures() == 2);
+}
+
+/**
+ @brief A RGB image is uploaded with an unpack alignment of 1, which is restored, and its texels are counted as 4 bytes
+ */
+static void TestUpload(void)
+{
+	TestTextureCache sCache(64 * 1024 * 1024);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	const GLuint uiRGB = sCache.Acquire(IMAGE_RGB);
+	TEST_CHECK(uiRGB != 0);
+	TEST_CHECK(cGLStub->vTexImageAlignments.size() == 1);
+	TEST_CHECK(cGLStub->vTexImageAlignments[0] == 1);
+	TEST_CHECK(cGLStub->iUnpackAlignment == 4);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 512 * 512 * 4);
+	TEST_CHECK(cGLStub->GetNumCalls("glGenerateMipmap") == 0);
+
+	// The mipmaps take a third more
+	const GLuint uiMipmapped = sCache.cTextureCache->Acquire(IMAGE_RGB, true, GL_REPEAT, GL_LINEAR_MIPMAP_LINEAR, true);
+	TEST_CHECK(uiMipmapped != 0);
+	TEST_CHECK(cGLStub->GetNumCalls("glGenerateMipmap") == 1);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 512 * 512 * 4 + 512 * 512 * 4 * 4 / 3);
+
+	sCache.cTextureCache->Release(uiRGB);
+	sCache.cTextureCache->Release(uiMipmapped);
+}
+
+/**
+ @brief The least recently used textures without references are evicted when the textures are over the budget,
+		and the referenced textures are never evicted
+ */
+static void TestEviction(void)
+{
+	TestTextureCache sCache(3 * SMALL_IMAGE_SIZE);
+	CGLStub* cGLStub = CGLStub::GetInstance();
+
+	const GLuint uiGround = sCache.Acquire(IMAGE_GROUND);
+	const GLuint uiExit = sCache.Acquire(IMAGE_EXIT);
+	const GLuint uiSpikes = sCache.Acquire(IMAGE_SPIKES);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 3 * SMALL_IMAGE_SIZE);
+
+	// The exit is released first, so it is the least recently used
+	sCache.cTextureCache->Release(uiExit);
+	sCache.cTextureCache->Release(uiGround);
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 0);
+
+	// A fourth texture is over the budget, so the exit is evicted to make room for it
+	const GLuint uiSpa = sCache.Acquire(IMAGE_SPA);
+	TEST_CHECK(uiSpa != 0);
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 1);
+	TEST_CHECK(cGLStub->vDeletedTextures[0] == uiExit);
+	TEST_CHECK(sCache.cTextureCache->GetNumEvictions() == 1);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 3 * SMALL_IMAGE_SIZE);
+
+	// An evicted texture is loaded again when it is acquired
+	TEST_CHECK(sCache.Acquire(IMAGE_EXIT) != 0);
+	TEST_CHECK(sCache.cTextureCache->GetNumMisses() == 5);
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 2);
+	TEST_CHECK(cGLStub->vDeletedTextures[1] == uiGround);
+
+	// The referenced textures stay over the budget
+	sCache.cTextureCache->SetBudget(0);
+	TEST_CHECK(sCache.cTextureCache->GetNumTextures() == 3);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 3 * SMALL_IMAGE_SIZE);
+
+	// Purge deletes the textures without references, whatever the budget
+	sCache.cTextureCache->SetBudget(64 * 1024 * 1024);
+	sCache.cTextureCache->Release(uiSpikes);
+	sCache.cTextureCache->Purge();
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 3);
+	TEST_CHECK(cGLStub->vDeletedTextures[2] == uiSpikes);
+	TEST_CHECK(sCache.cTextureCache->GetNumTextures() == 2);
+	TEST_CHECK(sCache.cTextureCache->GetNumReferences(uiSpa) == 1);
+	TEST_CHECK(sCache.cTextureCache->GetMemoryUsed() == 2 * SMALL_IMAGE_SIZE);
+
+	// Destroying the cache deletes the textures which are still referenced
+	CTextureCache::Destroy();
+	TEST_CHECK(cGLStub->vDeletedTextures.size() == 5);
+}
+
+/**
+ @brief Run the tests of the texture cache
+ */
+void RunTextureCacheTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("TextureCache.References", TestReferences);
+	cTestHarness->Run("TextureCache.Upload", TestUpload);
+	cTestHarness->Run("TextureCache.Eviction", TestEviction);
+}
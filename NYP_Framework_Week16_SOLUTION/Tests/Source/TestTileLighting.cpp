@@ -0,0 +1,506 @@
+/**
+ Tests of CTileLighting2D
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+#include "GLStub.h"
+
+// Include TileLighting2D
+#include "Scene2D\TileLighting2D.h"
+// Include the Map2D for the IDs of the tiles
+#include "Scene2D\Map2D.h"
+// Include Shader Manager and GLStateCache, which the light map is rendered with
+#include "RenderControl\ShaderManager.h"
+#include "RenderControl\GLStateCache.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+
+/**
+ A level of tiles, which is lit through its grid view like the map
+ */
+struct TestLevel
+{
+	int iNumCols;
+	int iNumRows;
+	// The tiles, and the rows of the view from top to bottom
+	std::vector<Grid> vTiles;
+	std::vector<const Grid*> vRows;
+
+	TestLevel(const int iNumCols, const int iNumRows)
+		: iNumCols(iNumCols), iNumRows(iNumRows), vTiles(iNumCols * iNumRows), vRows(iNumRows)
+	{
+		for (int iRow = 0; iRow < iNumRows; iRow++)
+			vRows[iRow] = &vTiles[iRow * iNumCols];
+	}
+
+	// Set the value of a tile. The row is from bottom to top
+	void SetValue(const int iCol, const int iRow, const unsigned int uiValue)
+	{
+		vTiles[(iNumRows - iRow - 1) * iNumCols + iCol].value = uiValue;
+	}
+
+	TileGridView2D GetGridView(void) const
+	{
+		return TileGridView2D(vRows.data(), iNumRows, iNumCols);
+	}
+};
+
+/**
+ @brief Light a level from scratch by relaxing every tile until nothing changes, as a reference for the flood fills
+ @param sLevel A const TestLevel& variable containing the level
+ @param i32vec2Player A const glm::i32vec2& variable containing the tile of the player's light
+ @param iPlayerLevel A const int variable containing the level of the player's light
+ @return The light level of each tile, indexed by row * iNumCols + col, with the rows from bottom to top
+ */
+static std::vector<int> ReferenceLight(const TestLevel& sLevel,
+									   const glm::i32vec2& i32vec2Player = glm::i32vec2(-1, -1),
+									   const int iPlayerLevel = 0)
+{
+	const TileGridView2D sGridView = sLevel.GetGridView();
+	const int iNumCols = sLevel.iNumCols;
+	const int iNumRows = sLevel.iNumRows;
+
+	std::vector<int> vEmission(iNumCols * iNumRows);
+	std::vector<bool> vSpreads(iNumCols * iNumRows);
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			const unsigned int uiValue = sGridView.GetValue(iCol, iRow);
+			int iEmission = CTileLighting2D::GetTileEmission(uiValue);
+			if (glm::i32vec2(iCol, iRow) == i32vec2Player)
+				iEmission = glm::max(iEmission, iPlayerLevel);
+			vEmission[iRow * iNumCols + iCol] = iEmission;
+			// A tile which blocks light is lit on its surface, but only spreads light if it emits light
+			vSpreads[iRow * iNumCols + iCol] = (uiValue < CMap2D::TILE_ID::COLOUR_BLOCK_UP) || (iEmission > 0);
+		}
+	}
+
+	std::vector<int> vLight = vEmission;
+	bool bChanged = true;
+	while (bChanged)
+	{
+		bChanged = false;
+		for (int i = 0; i < iNumCols * iNumRows; i++)
+		{
+			const int iCol = i % iNumCols;
+			const int iRow = i / iNumCols;
+			const int arrNeighbours[4] = {
+				(iCol > 0) ? i - 1 : -1,
+				(iCol < iNumCols - 1) ? i + 1 : -1,
+				(iRow > 0) ? i - iNumCols : -1,
+				(iRow < iNumRows - 1) ? i + iNumCols : -1
+			};
+			for (int j = 0; j < 4; j++)
+			{
+				const int iNeighbour = arrNeighbours[j];
+				if ((iNeighbour >= 0) && (vSpreads[iNeighbour]) && (vLight[iNeighbour] - 1 > vLight[i]))
+				{
+					vLight[i] = vLight[iNeighbour] - 1;
+					bChanged = true;
+				}
+			}
+		}
+	}
+	return vLight;
+}
+
+/**
+ @brief Check if the light of every tile is the same as the reference
+ */
+static bool MatchesReference(const CTileLighting2D* cTileLighting2D, const std::vector<int>& vReference,
+							 const int iNumCols, const int iNumRows)
+{
+	for (int iRow = 0; iRow < iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < iNumCols; iCol++)
+		{
+			if (cTileLighting2D->GetLight(iCol, iRow) != vReference[iRow * iNumCols + iCol])
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ @brief Fill a level with random walls and light sources
+ */
+static void RandomiseLevel(TestLevel& sLevel, CRandom& cRandom)
+{
+	for (int iRow = 0; iRow < sLevel.iNumRows; iRow++)
+	{
+		for (int iCol = 0; iCol < sLevel.iNumCols; iCol++)
+		{
+			const unsigned int uiRoll = cRandom.NextUInt(100);
+			unsigned int uiValue = 0;
+			if (uiRoll < 30)
+				uiValue = CMap2D::TILE_ID::COLOUR_BLOCK_UP;
+			else if (uiRoll < 32)
+				uiValue = CMap2D::TILE_ID::ACID_DOWN;
+			else if (uiRoll < 33)
+				uiValue = CMap2D::TILE_ID::POWERUP_DOUBLEJUMP;
+			sLevel.SetValue(iCol, iRow, uiValue);
+		}
+	}
+}
+
+/**
+ @brief Get a random tile value for an edit of a level
+ */
+static unsigned int RandomTileValue(CRandom& cRandom)
+{
+	const unsigned int arrValues[4] = { 0, CMap2D::TILE_ID::COLOUR_BLOCK_UP,
+										CMap2D::TILE_ID::ACID_DOWN, CMap2D::TILE_ID::POWERUP_DOUBLEJUMP };
+	return arrValues[cRandom.NextUInt(4)];
+}
+
+/**
+ @brief A single light falls off by 1 level for each tile, and does not reach further than its level
+ */
+static void TestSingleSource(void)
+{
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Resize(11, 11);
+	cTileLighting2D->SetTile(5, 5, 6, false);
+
+	bool bFallsOff = true;
+	for (int iRow = 0; iRow < 11; iRow++)
+	{
+		for (int iCol = 0; iCol < 11; iCol++)
+		{
+			const int iDistance = abs(iCol - 5) + abs(iRow - 5);
+			if (cTileLighting2D->GetLight(iCol, iRow) != glm::max(6 - iDistance, 0))
+				bFallsOff = false;
+		}
+	}
+	TEST_CHECK(bFallsOff);
+	TEST_CHECK(cTileLighting2D->GetLight(-1, 5) == 0);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief A wall is lit on its surface, and the light does not spread through it
+ */
+static void TestBlockingTiles(void)
+{
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Resize(8, 5);
+	for (int iRow = 0; iRow < 5; iRow++)
+		cTileLighting2D->SetTile(4, iRow, 0, true);
+	cTileLighting2D->SetTile(2, 2, 10, false);
+
+	TEST_CHECK(cTileLighting2D->GetLight(3, 2) == 9);
+	TEST_CHECK(cTileLighting2D->GetLight(4, 2) == 8);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 2) == 0);
+
+	// A hole in the wall lets the light through
+	cTileLighting2D->SetTile(4, 2, 0, false);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 2) == 7);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 0) == 5);
+
+	// A wall which emits light spreads its light to both sides
+	cTileLighting2D->SetTile(4, 2, 0, true);
+	cTileLighting2D->SetTile(2, 2, 0, false);
+	cTileLighting2D->SetTile(4, 4, 4, true);
+	TEST_CHECK(cTileLighting2D->GetLight(3, 4) == 3);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 4) == 3);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief Removing a light removes all the light which spread from it, and keeps the light of the other sources
+ */
+static void TestRemoveSource(void)
+{
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Resize(16, 4);
+	cTileLighting2D->SetTile(2, 1, 8, false);
+	cTileLighting2D->SetTile(12, 1, 5, false);
+	TEST_CHECK(cTileLighting2D->GetLight(7, 1) == 3);
+
+	cTileLighting2D->SetTile(2, 1, 0, false);
+	TEST_CHECK(cTileLighting2D->GetLight(2, 1) == 0);
+	TEST_CHECK(cTileLighting2D->GetLight(7, 1) == 0);
+	TEST_CHECK(cTileLighting2D->GetLight(8, 1) == 1);
+	TEST_CHECK(cTileLighting2D->GetLight(12, 1) == 5);
+
+	cTileLighting2D->SetTile(12, 1, 0, false);
+	bool bDark = true;
+	for (int iRow = 0; iRow < 4; iRow++)
+	{
+		for (int iCol = 0; iCol < 16; iCol++)
+		{
+			if (cTileLighting2D->GetLight(iCol, iRow) != 0)
+				bDark = false;
+		}
+	}
+	TEST_CHECK(bDark);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief The tiles are loaded from the grid view, and the modified tiles and a change of level are loaded in Update
+ */
+static void TestLoadFromGrid(void)
+{
+	TestLevel sLevel(8, 6);
+	sLevel.SetValue(1, 1, CMap2D::TILE_ID::ACID_DOWN);
+	for (int iRow = 0; iRow < 6; iRow++)
+		sLevel.SetValue(4, iRow, CMap2D::TILE_ID::COLOUR_BLOCK_UP);
+
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+	TEST_CHECK(cTileLighting2D->GetLight(1, 1) == 10);
+	TEST_CHECK(cTileLighting2D->GetLight(4, 1) == 7);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 1) == 0);
+
+	// Open the wall
+	std::vector<glm::i32vec2> vModifiedTiles;
+	sLevel.SetValue(4, 1, 0);
+	vModifiedTiles.push_back(glm::i32vec2(4, 1));
+	cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 0.0);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 1) == 6);
+	TEST_CHECK(MatchesReference(cTileLighting2D, ReferenceLight(sLevel), 8, 6));
+
+	// Change to an empty level
+	for (int iRow = 0; iRow < 6; iRow++)
+	{
+		for (int iCol = 0; iCol < 8; iCol++)
+			sLevel.SetValue(iCol, iRow, 0);
+	}
+	vModifiedTiles.clear();
+	cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, true, 0.0);
+	TEST_CHECK(cTileLighting2D->GetLight(1, 1) == 0);
+	TEST_CHECK(cTileLighting2D->GetLight(3, 1) == 0);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief The player's light follows the player, and the tiles it left are dark again
+ */
+static void TestPlayerLight(void)
+{
+	TestLevel sLevel(20, 10);
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+
+	cTileLighting2D->SetPlayerLight(glm::i32vec2(3, 5), 6);
+	TEST_CHECK(cTileLighting2D->GetLight(3, 5) == 6);
+	TEST_CHECK(cTileLighting2D->GetLight(6, 5) == 3);
+
+	cTileLighting2D->SetPlayerLight(glm::i32vec2(15, 5), 6);
+	TEST_CHECK(cTileLighting2D->GetLight(3, 5) == 0);
+	TEST_CHECK(cTileLighting2D->GetLight(15, 5) == 6);
+	TEST_CHECK(MatchesReference(cTileLighting2D, ReferenceLight(sLevel, glm::i32vec2(15, 5), 6), 20, 10));
+
+	// A player outside the level has no light in it
+	cTileLighting2D->SetPlayerLight(glm::i32vec2(-1, -1), 6);
+	TEST_CHECK(cTileLighting2D->GetLight(15, 5) == 0);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief A flash lights the tiles until its duration has passed
+ */
+static void TestFlashExpires(void)
+{
+	TestLevel sLevel(10, 10);
+	const std::vector<glm::i32vec2> vModifiedTiles;
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+
+	cTileLighting2D->AddFlash(5, 5, 8, 0.3);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 5) == 8);
+
+	cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 0.2);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 5) == 8);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 8) == 5);
+
+	cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 0.2);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 5) == 0);
+	TEST_CHECK(cTileLighting2D->GetLight(5, 8) == 0);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief After random edits, the incremental flood fills give the same light as lighting the level from scratch
+ */
+static void TestIncrementalMatchesRelight(void)
+{
+	const int NUM_COLS = 40;
+	const int NUM_ROWS = 30;
+
+	CRandom cRandom(7u, 0u);
+	TestLevel sLevel(NUM_COLS, NUM_ROWS);
+	RandomiseLevel(sLevel, cRandom);
+
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+	TEST_CHECK(MatchesReference(cTileLighting2D, ReferenceLight(sLevel), NUM_COLS, NUM_ROWS));
+
+	unsigned int uiNumMismatches = 0;
+	std::vector<glm::i32vec2> vModifiedTiles;
+	glm::i32vec2 i32vec2Player(NUM_COLS / 2, NUM_ROWS / 2);
+	for (int iFrame = 0; iFrame < 300; iFrame++)
+	{
+		vModifiedTiles.clear();
+		const int iNumEdits = cRandom.RandIntMinMax(1, 4);
+		for (int i = 0; i < iNumEdits; i++)
+		{
+			const glm::i32vec2 i32vec2Tile(cRandom.NextUInt(NUM_COLS), cRandom.NextUInt(NUM_ROWS));
+			sLevel.SetValue(i32vec2Tile.x, i32vec2Tile.y, RandomTileValue(cRandom));
+			vModifiedTiles.push_back(i32vec2Tile);
+		}
+		i32vec2Player.x = glm::clamp(i32vec2Player.x + cRandom.RandIntMinMax(-1, 1), 0, NUM_COLS - 1);
+		i32vec2Player.y = glm::clamp(i32vec2Player.y + cRandom.RandIntMinMax(-1, 1), 0, NUM_ROWS - 1);
+
+		cTileLighting2D->SetPlayerLight(i32vec2Player, 12);
+		cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 1.0 / 60.0);
+		if (!MatchesReference(cTileLighting2D, ReferenceLight(sLevel, i32vec2Player, 12), NUM_COLS, NUM_ROWS))
+			uiNumMismatches++;
+	}
+	TEST_CHECK(uiNumMismatches == 0);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief An edit only visits the tiles which its light reaches, and not the whole level
+ */
+static void TestVisitedTilesStayLocal(void)
+{
+	TestLevel sLevel(256, 256);
+	sLevel.SetValue(10, 10, CMap2D::TILE_ID::ACID_DOWN);
+	sLevel.SetValue(200, 200, CMap2D::TILE_ID::ACID_DOWN);
+
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+	cTileLighting2D->GetNumVisitedTiles();
+
+	// The acid lights a diamond of 2 * 9 * 9 + 2 * 9 + 1 = 181 tiles, which are all visited to remove its light
+	std::vector<glm::i32vec2> vModifiedTiles;
+	sLevel.SetValue(10, 10, 0);
+	vModifiedTiles.push_back(glm::i32vec2(10, 10));
+	cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 0.0);
+	const unsigned int uiNumVisitedTiles = cTileLighting2D->GetNumVisitedTiles();
+	TEST_CHECK(uiNumVisitedTiles >= 181);
+	TEST_CHECK(uiNumVisitedTiles < 181 * 8);
+	TEST_CHECK(cTileLighting2D->GetLight(200, 200) == 10);
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief Only the rows of the light map which changed are uploaded, with tightly packed rows
+ */
+static void TestUploadChangedRows(void)
+{
+	CGLStub* cGLStub = CGLStub::GetInstance();
+	cGLStub->Reset();
+	CShaderManager::GetInstance()->Add("2DLitShader", "../App/Shader/Scene2DLit.vs", "../App/Shader/Scene2DLit.fs");
+
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->SetShader("2DLitShader");
+	cTileLighting2D->Resize(32, 24);
+	cTileLighting2D->PreRender();
+	TEST_CHECK(cGLStub->GetNumCalls("glGenTextures") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glTexImage2D") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glTexSubImage2D") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glPixelStorei") == 2);
+
+	// Nothing changed
+	cTileLighting2D->PreRender();
+	TEST_CHECK(cGLStub->GetNumCalls("glTexSubImage2D") == 1);
+
+	// A change uploads the rows which it lit, in one call
+	cTileLighting2D->SetTile(10, 10, 3, false);
+	cTileLighting2D->PreRender();
+	TEST_CHECK(cGLStub->GetNumCalls("glTexSubImage2D") == 2);
+	TEST_CHECK(cGLStub->GetNumCalls("glGenTextures") == 1);
+	TEST_CHECK(cGLStub->GetNumCalls("glTexImage2D") == 1);
+	cTileLighting2D->PostRender();
+
+	CTileLighting2D::Destroy();
+	CShaderManager::Destroy();
+	CGLStateCache::Destroy();
+}
+
+/**
+ @brief Benchmark the edits per frame which the incremental flood fills can light, against lighting from scratch
+ */
+static void BenchmarkEditsPerFrame(void)
+{
+	const int NUM_COLS = 256;
+	const int NUM_ROWS = 192;
+	const int NUM_FRAMES = 2000;
+	const int NUM_EDITS_PER_FRAME = 8;
+	const int NUM_RELIGHTS = 50;
+
+	CRandom cRandom(11u, 0u);
+	TestLevel sLevel(NUM_COLS, NUM_ROWS);
+	RandomiseLevel(sLevel, cRandom);
+
+	CTileLighting2D* cTileLighting2D = CTileLighting2D::GetInstance();
+	cTileLighting2D->Init(sLevel.GetGridView());
+	cTileLighting2D->GetNumVisitedTiles();
+
+	std::vector<glm::i32vec2> vModifiedTiles;
+	std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	for (int iFrame = 0; iFrame < NUM_FRAMES; iFrame++)
+	{
+		vModifiedTiles.clear();
+		for (int i = 0; i < NUM_EDITS_PER_FRAME; i++)
+		{
+			const glm::i32vec2 i32vec2Tile(cRandom.NextUInt(NUM_COLS), cRandom.NextUInt(NUM_ROWS));
+			sLevel.SetValue(i32vec2Tile.x, i32vec2Tile.y, RandomTileValue(cRandom));
+			vModifiedTiles.push_back(i32vec2Tile);
+		}
+		cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, false, 1.0 / 60.0);
+	}
+	const double dEditTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+	const unsigned int uiNumVisitedTiles = cTileLighting2D->GetNumVisitedTiles();
+	TEST_CHECK(MatchesReference(cTileLighting2D, ReferenceLight(sLevel), NUM_COLS, NUM_ROWS));
+
+	vModifiedTiles.clear();
+	tStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_RELIGHTS; i++)
+		cTileLighting2D->Update(sLevel.GetGridView(), vModifiedTiles, true, 1.0 / 60.0);
+	const double dRelightTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+	const double dNumEdits = (double)NUM_FRAMES * NUM_EDITS_PER_FRAME;
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Report("Incremental edits", dNumEdits / dEditTime, "edits/s");
+	cTestHarness->Report("Tiles visited per edit", uiNumVisitedTiles / dNumEdits, "tiles");
+	cTestHarness->Report("Relights from scratch", NUM_RELIGHTS / dRelightTime, "relights/s");
+
+	CTileLighting2D::Destroy();
+}
+
+/**
+ @brief Run the tests of CTileLighting2D
+ */
+void RunTileLightingTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("TileLighting.SingleSource", TestSingleSource);
+	cTestHarness->Run("TileLighting.BlockingTiles", TestBlockingTiles);
+	cTestHarness->Run("TileLighting.RemoveSource", TestRemoveSource);
+	cTestHarness->Run("TileLighting.LoadFromGrid", TestLoadFromGrid);
+	cTestHarness->Run("TileLighting.PlayerLight", TestPlayerLight);
+	cTestHarness->Run("TileLighting.FlashExpires", TestFlashExpires);
+	cTestHarness->Run("TileLighting.IncrementalMatchesRelight", TestIncrementalMatchesRelight);
+	cTestHarness->Run("TileLighting.VisitedTilesStayLocal", TestVisitedTilesStayLocal);
+	cTestHarness->Run("TileLighting.UploadChangedRows", TestUploadChangedRows);
+	cTestHarness->Run("TileLighting.Benchmark", BenchmarkEditsPerFrame);
+}
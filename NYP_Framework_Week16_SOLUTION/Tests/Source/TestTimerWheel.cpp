@@ -0,0 +1,281 @@
+/**
+ Tests of CTimerWheel
+ By: Toh Da Jun
+ Date: Mar 2020
+ */
+#include "TestHarness.h"
+
+// Include TimerWheel
+#include "TimeControl\TimerWheel.h"
+// Include Random
+#include "System\Random.h"
+
+#include <vector>
+#include <algorithm>
+
+// A tick length which is exact in binary, so that the times add up to whole ticks exactly
+static const double TICK_LENGTH = 1.0 / 64.0;
+
+/**
+ A timer wheel which is not the singleton, so that 2 wheels can be compared
+ */
+class CTestTimerWheel : public CTimerWheel
+{
+public:
+	CTestTimerWheel(void)
+	{
+		Init(TICK_LENGTH);
+	}
+
+	virtual ~CTestTimerWheel(void)
+	{
+	}
+
+	// Advance the time by a number of ticks, one tick per update
+	void Advance(const unsigned long long ullNumTicks)
+	{
+		for (unsigned long long i = 0; i < ullNumTicks; i++)
+			Update(TICK_LENGTH);
+	}
+
+	// Get the index of the timer of a handle, without its generation
+	static unsigned int GetIndex(const HANDLE hTimer)
+	{
+		return hTimer & INDEX_MASK;
+	}
+};
+
+/**
+ A timer which fired, with the tick it fired on
+ */
+struct FiredTimer
+{
+	unsigned long long ullTick;
+	int iID;
+
+	bool operator==(const FiredTimer& sOther) const
+	{
+		return (ullTick == sOther.ullTick) && (iID == sOther.iID);
+	}
+};
+
+/**
+ @brief Schedule a timer which records the tick it fires on
+ */
+static CTimerWheel::HANDLE ScheduleRecorded(CTimerWheel& cTimerWheel, const unsigned long long ullDelayTicks, const int iID,
+											std::vector<FiredTimer>& vFired, const unsigned long long ullPeriodTicks = 0)
+{
+	return cTimerWheel.Schedule(ullDelayTicks * TICK_LENGTH, [&cTimerWheel, iID, &vFired]()
+		{
+			FiredTimer sFired = { cTimerWheel.GetCurrentTick(), iID };
+			vFired.push_back(sFired);
+		},
+		ullPeriodTicks * TICK_LENGTH);
+}
+
+/**
+ @brief Each timer fires on the tick it was scheduled for, in every level of the wheel,
+		and the timers on the same tick fire in the order they were scheduled
+ */
+static void TestOrder(void)
+{
+	CTestTimerWheel cTimerWheel;
+	std::vector<FiredTimer> vFired;
+
+	// The delays are at the edges of the levels, and are scheduled out of order
+	const unsigned long long arrDelays[] = { 65536, 1, 256, 255, 70000, 2, 65535, 257, 300, 1, 256 };
+	const int NUM_TIMERS = sizeof(arrDelays) / sizeof(arrDelays[0]);
+	for (int i = 0; i < NUM_TIMERS; i++)
+		ScheduleRecorded(cTimerWheel, arrDelays[i], i, vFired);
+	TEST_CHECK(cTimerWheel.GetNumPending() == NUM_TIMERS);
+
+	cTimerWheel.Advance(70001);
+	TEST_CHECK(cTimerWheel.GetNumPending() == 0);
+
+	const FiredTimer arrExpected[] = {
+		{ 1, 1 }, { 1, 9 }, { 2, 5 }, { 255, 3 }, { 256, 2 }, { 256, 10 },
+		{ 257, 7 }, { 300, 8 }, { 65535, 6 }, { 65536, 0 }, { 70000, 4 } };
+	TEST_CHECK(vFired.size() == NUM_TIMERS);
+	TEST_CHECK(std::equal(vFired.begin(), vFired.end(), arrExpected));
+
+	// The same delays, scheduled half way through the slots of level 1 and 2
+	cTimerWheel.Init(TICK_LENGTH);
+	cTimerWheel.Advance(65536 + 256 * 3 + 77);
+	const unsigned long long ullStartTick = cTimerWheel.GetCurrentTick();
+	vFired.clear();
+	for (int i = 0; i < NUM_TIMERS; i++)
+		ScheduleRecorded(cTimerWheel, arrDelays[i], i, vFired);
+	cTimerWheel.Advance(70001);
+	bool bOnTime = (vFired.size() == NUM_TIMERS);
+	for (unsigned int i = 0; i < vFired.size(); i++)
+		bOnTime = bOnTime && (vFired[i].ullTick == ullStartTick + arrDelays[vFired[i].iID]) && (vFired[i].iID == arrExpected[i].iID);
+	TEST_CHECK(bOnTime);
+}
+
+/**
+ @brief A repeating timer fires every period without drifting, even when it is cancelled or cancels itself,
+		and on a tick which it shares with other timers, it fires in the order it was last repeated in
+ */
+static void TestRepeat(void)
+{
+	CTestTimerWheel cTimerWheel;
+	std::vector<FiredTimer> vFired;
+
+	CTimerWheel::HANDLE hRepeat = ScheduleRecorded(cTimerWheel, 3, 0, vFired, 5);
+	cTimerWheel.Advance(3);
+	// This one-shot timer is due on the same tick as the second repeat, but was scheduled after the first repeat
+	ScheduleRecorded(cTimerWheel, 5, 1, vFired);
+	cTimerWheel.Advance(20);
+	const FiredTimer arrExpected[] = { { 3, 0 }, { 8, 0 }, { 8, 1 }, { 13, 0 }, { 18, 0 }, { 23, 0 } };
+	TEST_CHECK(vFired.size() == 6);
+	TEST_CHECK(std::equal(vFired.begin(), vFired.end(), arrExpected));
+	TEST_CHECK(cTimerWheel.IsPending(hRepeat));
+	TEST_CHECK(cTimerWheel.GetRemainingTime(hRepeat) == 5 * TICK_LENGTH);
+
+	cTimerWheel.Cancel(hRepeat);
+	TEST_CHECK(hRepeat == CTimerWheel::INVALID_HANDLE);
+	cTimerWheel.Advance(20);
+	TEST_CHECK(vFired.size() == 6);
+
+	// A repeating timer which cancels itself on its third call
+	int iNumCalls = 0;
+	CTimerWheel::HANDLE hSelf = CTimerWheel::INVALID_HANDLE;
+	hSelf = cTimerWheel.Schedule(TICK_LENGTH, [&]()
+		{
+			if (++iNumCalls == 3)
+				cTimerWheel.Cancel(hSelf);
+		},
+		TICK_LENGTH);
+	cTimerWheel.Advance(10);
+	TEST_CHECK(iNumCalls == 3);
+	TEST_CHECK(cTimerWheel.GetNumPending() == 0);
+}
+
+/**
+ @brief A timer which is cancelled by an earlier timer on the same tick does not fire,
+		and a handle to a timer which was freed does not refer to the timer which reuses its slot
+ */
+static void TestCancel(void)
+{
+	CTestTimerWheel cTimerWheel;
+	std::vector<FiredTimer> vFired;
+
+	CTimerWheel::HANDLE hSecond = CTimerWheel::INVALID_HANDLE;
+	cTimerWheel.Schedule(2 * TICK_LENGTH, [&]()
+		{
+			cTimerWheel.Cancel(hSecond);
+		});
+	hSecond = ScheduleRecorded(cTimerWheel, 2, 1, vFired);
+	ScheduleRecorded(cTimerWheel, 2, 2, vFired);
+	cTimerWheel.Advance(2);
+	TEST_CHECK(vFired.size() == 1);
+	TEST_CHECK((vFired.size() == 1) && (vFired[0].iID == 2));
+
+	// The timer which fired is reused, but its old handle stays invalid
+	CTimerWheel::HANDLE hOld = ScheduleRecorded(cTimerWheel, 1, 3, vFired);
+	cTimerWheel.Advance(1);
+	CTimerWheel::HANDLE hNew = ScheduleRecorded(cTimerWheel, 4, 4, vFired);
+	TEST_CHECK(CTestTimerWheel::GetIndex(hOld) == CTestTimerWheel::GetIndex(hNew));
+	TEST_CHECK(cTimerWheel.IsPending(hOld) == false);
+	TEST_CHECK(cTimerWheel.IsPending(hNew));
+	cTimerWheel.Cancel(hOld);
+	TEST_CHECK(cTimerWheel.IsPending(hNew));
+	cTimerWheel.Advance(4);
+	TEST_CHECK(vFired.back().iID == 4);
+
+	// A timer which is scheduled by a callback for the current tick fires on the next tick
+	cTimerWheel.Schedule(TICK_LENGTH, [&]()
+		{
+			ScheduleRecorded(cTimerWheel, 0, 5, vFired);
+		});
+	const unsigned long long ullTick = cTimerWheel.GetCurrentTick();
+	cTimerWheel.Advance(2);
+	TEST_CHECK((vFired.back().iID == 5) && (vFired.back().ullTick == ullTick + 2));
+}
+
+/**
+ @brief Random timers fire on their ticks in the order they were scheduled, and give the same results
+		whether the time is advanced one tick at a time or in frames of random lengths
+ */
+static void TestStability(void)
+{
+	CTestTimerWheel cStepped;
+	CTestTimerWheel cFramed;
+	std::vector<FiredTimer> vSteppedFired;
+	std::vector<FiredTimer> vFramedFired;
+	std::vector<unsigned long long> vExpiryTicks;
+
+	const int NUM_TIMERS = 2000;
+	CRandom cRandom(7u, 0u);
+	for (int i = 0; i < NUM_TIMERS; i++)
+	{
+		// Mostly short delays, with some which go through the higher levels
+		const unsigned long long ullDelay = (cRandom.NextUInt(4) == 0) ? cRandom.NextUInt(200000) : cRandom.NextUInt(600);
+		ScheduleRecorded(cStepped, ullDelay, i, vSteppedFired);
+		ScheduleRecorded(cFramed, ullDelay, i, vFramedFired);
+		vExpiryTicks.push_back((ullDelay > 0) ? ullDelay : 1);
+	}
+
+	cStepped.Advance(200001);
+	while (cFramed.GetCurrentTick() < 200001)
+		cFramed.Update(cRandom.NextUInt(40) * TICK_LENGTH);
+
+	TEST_CHECK(vSteppedFired.size() == NUM_TIMERS);
+	TEST_CHECK(vSteppedFired == vFramedFired);
+	bool bInOrder = (vSteppedFired.size() == NUM_TIMERS);
+	for (unsigned int i = 0; i < vSteppedFired.size(); i++)
+	{
+		bInOrder = bInOrder && (vSteppedFired[i].ullTick == vExpiryTicks[vSteppedFired[i].iID]);
+		// The timers on the same tick fire in the order they were scheduled
+		if (i > 0)
+			bInOrder = bInOrder && ((vSteppedFired[i - 1].ullTick < vSteppedFired[i].ullTick) ||
+									(vSteppedFired[i - 1].iID < vSteppedFired[i].iID));
+	}
+	TEST_CHECK(bInOrder);
+}
+
+/**
+ @brief The time does not pass while the wheel is paused, and passes faster or slower with the time scale
+ */
+static void TestPauseAndScale(void)
+{
+	CTestTimerWheel cTimerWheel;
+	std::vector<FiredTimer> vFired;
+
+	ScheduleRecorded(cTimerWheel, 8, 0, vFired);
+	cTimerWheel.SetPaused(true);
+	cTimerWheel.Advance(100);
+	TEST_CHECK(cTimerWheel.GetCurrentTick() == 0);
+	TEST_CHECK(vFired.empty());
+
+	cTimerWheel.SetPaused(false);
+	cTimerWheel.SetTimeScale(2.0);
+	cTimerWheel.Advance(4);
+	TEST_CHECK((vFired.size() == 1) && (vFired[0].ullTick == 8));
+
+	cTimerWheel.SetTimeScale(0.5);
+	ScheduleRecorded(cTimerWheel, 3, 1, vFired);
+	cTimerWheel.Advance(5);
+	TEST_CHECK(vFired.size() == 1);
+	cTimerWheel.Advance(1);
+	TEST_CHECK((vFired.size() == 2) && (vFired[1].ullTick == 11));
+
+	// A negative scale stops the time, instead of going back
+	cTimerWheel.SetTimeScale(-1.0);
+	TEST_CHECK(cTimerWheel.GetTimeScale() == 0.0);
+	cTimerWheel.Advance(10);
+	TEST_CHECK(cTimerWheel.GetCurrentTick() == 11);
+}
+
+/**
+ @brief Run the tests of CTimerWheel
+ */
+void RunTimerWheelTests(void)
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	cTestHarness->Run("TimerWheel.Order", TestOrder);
+	cTestHarness->Run("TimerWheel.Repeat", TestRepeat);
+	cTestHarness->Run("TimerWheel.Cancel", TestCancel);
+	cTestHarness->Run("TimerWheel.Stability", TestStability);
+	cTestHarness->Run("TimerWheel.PauseAndScale", TestPauseAndScale);
+}
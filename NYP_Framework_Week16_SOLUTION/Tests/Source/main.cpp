@@ -0,0 +1,72 @@
+/**
+ main.cpp
+ @brief This file contains the main function of the console test target.
+		The tests run without a window or an OpenGL context, so they can be run on a build machine.
+ */
+#include "TestHarness.h"
+
+// The tests of each part of the framework
+void RunRandomTests(void);
+void RunTileLightingTests(void);
+void RunQualityGovernorTests(void);
+void RunIdleTaskSchedulerTests(void);
+void RunShaderTests(void);
+void RunGLStateCacheTests(void);
+void RunSpriteBatchTests(void);
+void RunStreamBufferTests(void);
+void RunNullRenderBackendTests(void);
+void RunTextureCacheTests(void);
+void RunComponentStoreTests(void);
+void RunCommandBufferTests(void);
+void RunFixedTimestepTests(void);
+void RunEntityTests(void);
+void RunEntityPoolTests(void);
+void RunKinematicSolverTests(void);
+void RunAcidSimulationTests(void);
+void RunTimerWheelTests(void);
+void RunGravityKernelTests(void);
+void RunPhysicsWorldTests(void);
+void RunAISchedulerTests(void);
+void RunParticleSystemTests(void);
+
+/**
+ @brief This function is the main function which is called by the operating system when you run the tests
+ @param argc The number of command line arguments
+ @param argv The command line arguments. The first argument is the prefix of the names of the tests to run
+ @return 0 if all the tests passed, or 1 if a check failed
+ */
+int main(int argc, char* argv[])
+{
+	CTestHarness* cTestHarness = CTestHarness::GetInstance();
+	if (argc > 1)
+		cTestHarness->SetFilter(argv[1]);
+
+	RunRandomTests();
+	RunTileLightingTests();
+	RunQualityGovernorTests();
+	RunIdleTaskSchedulerTests();
+	RunShaderTests();
+	RunGLStateCacheTests();
+	RunSpriteBatchTests();
+	RunStreamBufferTests();
+	RunNullRenderBackendTests();
+	RunTextureCacheTests();
+	RunComponentStoreTests();
+	RunCommandBufferTests();
+	RunFixedTimestepTests();
+	RunEntityTests();
+	RunEntityPoolTests();
+	RunKinematicSolverTests();
+	RunAcidSimulationTests();
+	RunTimerWheelTests();
+	RunGravityKernelTests();
+	RunPhysicsWorldTests();
+	RunAISchedulerTests();
+	RunParticleSystemTests();
+
+	cTestHarness->PrintSelf();
+	const unsigned int uiNumFailures = cTestHarness->GetNumFailures();
+	CTestHarness::Destroy();
+
+	return (uiNumFailures == 0) ? 0 : 1;
+}